@@ -154,6 +154,13 @@ void needtocreategrid_(int* needGrid)
   if(coProcessorData->GetInputDescriptionByName("input")->GetGrid())
     {
     *needGrid = 0;
+    // arrays using the simulation's memory are kept from one time step
+    // to the next and only marked when they change
+    if(coProcessorData->GetInputDescriptionByName("input")->
+       GetNumberOfSimulationArrays())
+      {
+      return;
+      }
     // The grid is either stored as a class derived from vtkDataSet
     // or from a class derived from vtkMultiBlockDataSet
     vtkDataSet* grid = vtkDataSet::SafeDownCast(
@@ -200,3 +207,83 @@ void coprocess_()
   // Reset time data.
   isTimeDataSet = false;
 }
+
+namespace
+{
+  void SetSimulationArray(bool pointData, char* name, int* nameLength,
+                          double* data, int* numberOfTuples,
+                          int* numberOfComponents, int* layout)
+  {
+    if(!coProcessorData)
+      {
+      vtkGenericWarningMacro("Coprocessor is not initialized.");
+      return;
+      }
+    char cName[200];
+    if(!ConvertFortranStringToCString(name, *nameLength, cName, 200))
+      {
+      vtkGenericWarningMacro("Array name is too long.");
+      return;
+      }
+    vtkCPInputDataDescription* input =
+      coProcessorData->GetInputDescriptionByName("input");
+    int cLayout = *layout ? vtkCPInputDataDescription::STRUCTURE_OF_ARRAYS :
+      vtkCPInputDataDescription::ARRAY_OF_STRUCTURES;
+    if(pointData)
+      {
+      input->SetPointArray(cName, VTK_DOUBLE, data, *numberOfTuples,
+                           *numberOfComponents, cLayout, 0);
+      }
+    else
+      {
+      input->SetCellArray(cName, VTK_DOUBLE, data, *numberOfTuples,
+                          *numberOfComponents, cLayout, 0);
+      }
+  }
+}
+
+void setpointarray_(char* name, int* nameLength, double* data,
+                    int* numberOfTuples, int* numberOfComponents, int* layout)
+{
+  SetSimulationArray(true, name, nameLength, data, numberOfTuples,
+                     numberOfComponents, layout);
+}
+
+void setcellarray_(char* name, int* nameLength, double* data,
+                   int* numberOfTuples, int* numberOfComponents, int* layout)
+{
+  SetSimulationArray(false, name, nameLength, data, numberOfTuples,
+                     numberOfComponents, layout);
+}
+
+void setpoints_(double* coordinates, int* numberOfPoints, int* layout)
+{
+  if(!coProcessorData)
+    {
+    vtkGenericWarningMacro("Coprocessor is not initialized.");
+    return;
+    }
+  coProcessorData->GetInputDescriptionByName("input")->SetPoints(
+    VTK_DOUBLE, coordinates, *numberOfPoints,
+    *layout ? vtkCPInputDataDescription::STRUCTURE_OF_ARRAYS :
+    vtkCPInputDataDescription::ARRAY_OF_STRUCTURES, 0);
+}
+
+void markarraychanged_(char* name, int* nameLength)
+{
+  char cName[200];
+  if(!coProcessorData ||
+     !ConvertFortranStringToCString(name, *nameLength, cName, 200))
+    {
+    return;
+    }
+  coProcessorData->GetInputDescriptionByName("input")->MarkArrayChanged(cName);
+}
+
+void markpointschanged_()
+{
+  if(coProcessorData)
+    {
+    coProcessorData->GetInputDescriptionByName("input")->MarkPointsChanged();
+    }
+}
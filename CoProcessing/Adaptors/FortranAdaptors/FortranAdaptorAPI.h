@@ -40,4 +40,25 @@ extern "C" void needtocreategrid_(int* needGrid);
 // has been filled in elsewhere.
 extern "C" void coprocess_();
 
+// the following functions use the simulation's memory for the arrays of
+// the grid instead of copying it every time step.  the memory must stay
+// valid until coprocessorfinalize_ is called or the array is set again.
+// layout is 0 when the components of a tuple are contiguous, e.g. a fortran
+// array(numberOfComponents, numberOfTuples), which is used without a copy,
+// and 1 when the values of a component are contiguous, e.g. a fortran
+// array(numberOfTuples, numberOfComponents), which is copied.
+extern "C" void setpointarray_(char* name, int* nameLength, double* data,
+                               int* numberOfTuples, int* numberOfComponents,
+                               int* layout);
+extern "C" void setcellarray_(char* name, int* nameLength, double* data,
+                              int* numberOfTuples, int* numberOfComponents,
+                              int* layout);
+// the grid must be a vtkPointSet (e.g. a vtkUnstructuredGrid)
+extern "C" void setpoints_(double* coordinates, int* numberOfPoints,
+                           int* layout);
+// tell the coprocessor which arrays the simulation updated since the last
+// call to coprocess_.  only pipelines depending on them re-execute.
+extern "C" void markarraychanged_(char* name, int* nameLength);
+extern "C" void markpointschanged_();
+
 #endif
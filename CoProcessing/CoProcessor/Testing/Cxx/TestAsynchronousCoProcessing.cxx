@@ -0,0 +1,180 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    $RCSfile$
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Run a slow pipeline asynchronously and check that it processes copies of
+// the requested time steps while the simulation overwrites its arrays, and
+// that its failures are reported.
+
+#include "vtkCPDataDescription.h"
+#include "vtkCPInputDataDescription.h"
+#include "vtkCPPipeline.h"
+#include "vtkCPProcessor.h"
+#include "vtkDoubleArray.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkSmartPointer.h"
+#include "vtkUnstructuredGrid.h"
+
+#include <vtksys/SystemTools.hxx>
+#include <iostream>
+#include <vector>
+
+// Wants the pressure of every other time step and records what it got.
+class TestPipeline : public vtkCPPipeline
+{
+public:
+  static TestPipeline* New() { return new TestPipeline; }
+
+  virtual int RequestDataDescription(vtkCPDataDescription* DataDescription)
+    {
+    if(DataDescription->GetTimeStep() % 2)
+      {
+      return 0;
+      }
+    DataDescription->GetInputDescriptionByName("input")->
+      AddPointField("pressure");
+    return 1;
+    }
+
+  virtual int CoProcess(vtkCPDataDescription* DataDescription)
+    {
+    vtkUnstructuredGrid* Grid = vtkUnstructuredGrid::SafeDownCast(
+      DataDescription->GetInputDescriptionByName("input")->GetGrid());
+    vtkDataArray* Pressure = Grid->GetPointData()->GetArray("pressure");
+    if(!Pressure || Grid->GetPointData()->GetArray("velocity") ||
+       Pressure->GetComponent(0, 0) != DataDescription->GetTimeStep())
+      {
+      this->Errors++;
+      }
+    vtksys::SystemTools::Delay(this->Delay);
+    this->TimeSteps.push_back(DataDescription->GetTimeStep());
+    return this->Fail? 0: 1;
+    }
+
+  std::vector<vtkIdType> TimeSteps;
+  unsigned int Delay;
+  int Errors;
+  bool Fail;
+
+protected:
+  TestPipeline() : Delay(0), Errors(0), Fail(false) {}
+};
+
+// Simulate NumberOfTimeSteps time steps and return the number of them the
+// pipeline asked for.
+static int Simulate(vtkCPProcessor* Processor, int NumberOfTimeSteps)
+{
+  vtkSmartPointer<vtkUnstructuredGrid> Grid =
+    vtkSmartPointer<vtkUnstructuredGrid>::New();
+  vtkSmartPointer<vtkPoints> Points = vtkSmartPointer<vtkPoints>::New();
+  Points->InsertNextPoint(0, 0, 0);
+  Grid->SetPoints(Points);
+  vtkSmartPointer<vtkDoubleArray> Pressure =
+    vtkSmartPointer<vtkDoubleArray>::New();
+  Pressure->SetName("pressure");
+  Pressure->InsertNextValue(0);
+  Grid->GetPointData()->AddArray(Pressure);
+  vtkSmartPointer<vtkDoubleArray> Velocity =
+    vtkSmartPointer<vtkDoubleArray>::New();
+  Velocity->SetName("velocity");
+  Velocity->InsertNextValue(0);
+  Grid->GetPointData()->AddArray(Velocity);
+
+  vtkSmartPointer<vtkCPDataDescription> DataDescription =
+    vtkSmartPointer<vtkCPDataDescription>::New();
+  DataDescription->AddInput("input");
+  DataDescription->GetInputDescriptionByName("input")->SetGrid(Grid);
+
+  int Requested = 0;
+  for(int TimeStep=0;TimeStep<NumberOfTimeSteps;TimeStep++)
+    {
+    // The simulation updates its arrays in place.
+    Pressure->SetValue(0, TimeStep);
+    Pressure->Modified();
+    DataDescription->SetTimeData(TimeStep, TimeStep);
+    if(Processor->RequestDataDescription(DataDescription))
+      {
+      Processor->CoProcess(DataDescription);
+      Requested++;
+      }
+    }
+  return Requested;
+}
+
+int main(int, char*[])
+{
+  vtkSmartPointer<TestPipeline> Pipeline =
+    vtkSmartPointer<TestPipeline>::New();
+  vtkSmartPointer<vtkCPProcessor> Processor =
+    vtkSmartPointer<vtkCPProcessor>::New();
+  Processor->Initialize();
+  Processor->AddPipeline(Pipeline);
+  Processor->AsynchronousOn();
+  Processor->SetMaximumQueueLength(2);
+
+  // Blocking: every even time step is processed, in order.
+  Pipeline->Delay = 20;
+  Simulate(Processor, 10);
+  if(!Processor->WaitForCompletion())
+    {
+    std::cerr << "A time step was reported failed.\n";
+    return 1;
+    }
+  if(Pipeline->Errors || Pipeline->TimeSteps.size() != 5)
+    {
+    std::cerr << "Processed " << Pipeline->TimeSteps.size()
+              << " time steps with " << Pipeline->Errors << " errors.\n";
+    return 1;
+    }
+  for(size_t i=0;i<Pipeline->TimeSteps.size();i++)
+    {
+    if(Pipeline->TimeSteps[i] != static_cast<vtkIdType>(2 * i))
+      {
+      std::cerr << "Time step " << Pipeline->TimeSteps[i]
+                << " processed out of order.\n";
+      return 1;
+      }
+    }
+
+  // A failure on the helper thread is reported once.
+  Pipeline->TimeSteps.clear();
+  Pipeline->Fail = true;
+  Simulate(Processor, 1);
+  int Reported = !Processor->WaitForCompletion();
+  Pipeline->Fail = false;
+  if(!Reported || !Processor->WaitForCompletion())
+    {
+    std::cerr << "The failed time step was not reported once.\n";
+    return 1;
+    }
+
+  // Dropping: a slow pipeline loses time steps but never stalls the
+  // simulation for more than the time step being processed.
+  Pipeline->TimeSteps.clear();
+  Pipeline->Delay = 200;
+  Processor->SetQueueFullPolicyToDrop();
+  Processor->SetMaximumQueueLength(1);
+  Simulate(Processor, 10);
+  Processor->Finalize();
+  int Dropped = Processor->GetNumberOfDroppedTimeSteps();
+  if(Pipeline->Errors || Dropped == 0 ||
+     Pipeline->TimeSteps.empty() || Pipeline->TimeSteps[0] != 0)
+    {
+    std::cerr << "Dropped " << Dropped << " time steps, processed "
+              << Pipeline->TimeSteps.size() << " with "
+              << Pipeline->Errors << " errors.\n";
+    return 1;
+    }
+  return 0;
+}
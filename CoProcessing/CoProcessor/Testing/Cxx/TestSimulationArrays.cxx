@@ -0,0 +1,101 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    $RCSfile$
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Hand simulation memory to vtkCPInputDataDescription and check that it is
+// used in place when possible, refreshed when marked as changed and
+// released when the grid goes away.
+
+#include "vtkCPInputDataDescription.h"
+#include "vtkDataArray.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkSmartPointer.h"
+#include "vtkUnstructuredGrid.h"
+
+#include <iostream>
+
+static void CountRelease(void*, void* clientData)
+{
+  ++*static_cast<int*>(clientData);
+}
+
+int main(int, char*[])
+{
+  const int numberOfPoints = 4;
+  double coordinates[3 * numberOfPoints] =
+    { 0, 0, 0,  1, 0, 0,  0, 1, 0,  0, 0, 1 };
+  // velocity is stored as (vx, vy) per point, pressure as all the values of
+  // the first component followed by all the values of the second.
+  double velocity[2 * numberOfPoints] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+  double pressure[2 * numberOfPoints] = { 1, 2, 3, 4, 10, 20, 30, 40 };
+
+  int released = 0;
+  vtkSmartPointer<vtkCPInputDataDescription> input =
+    vtkSmartPointer<vtkCPInputDataDescription>::New();
+  input->SetReleaseCallback(CountRelease, &released);
+  vtkUnstructuredGrid* grid = vtkUnstructuredGrid::New();
+  input->SetGrid(grid);
+  grid->Delete();
+
+  if (!input->SetPoints(VTK_DOUBLE, coordinates, numberOfPoints) ||
+    !input->SetPointArray("velocity", VTK_DOUBLE, velocity,
+      numberOfPoints, 2) ||
+    !input->SetPointArray("pressure", VTK_DOUBLE, pressure, numberOfPoints, 2,
+      vtkCPInputDataDescription::STRUCTURE_OF_ARRAYS, 0))
+    {
+    std::cerr << "Failed to set the simulation arrays.\n";
+    return 1;
+    }
+  if (grid->GetPoints()->GetData()->GetVoidPointer(0) != coordinates ||
+    grid->GetPointData()->GetArray("velocity")->GetVoidPointer(0) != velocity)
+    {
+    std::cerr << "Contiguous simulation arrays were copied.\n";
+    return 1;
+    }
+  vtkDataArray* copy = grid->GetPointData()->GetArray("pressure");
+  if (copy->GetComponent(2, 0) != 3 || copy->GetComponent(2, 1) != 30)
+    {
+    std::cerr << "Structure of arrays layout was not converted.\n";
+    return 1;
+    }
+  if (input->GetNumberOfChangedArrays() != 3 ||
+    input->GetNumberOfSimulationArrays() != 3)
+    {
+    std::cerr << "Simulation arrays are not tracked.\n";
+    return 1;
+    }
+
+  // Only the arrays marked after the pipelines ran are changed.
+  input->ClearChangedArrays();
+  unsigned long gridTime = grid->GetMTime();
+  pressure[6] = 300;
+  input->MarkArrayChanged("pressure");
+  if (grid->GetMTime() <= gridTime || copy->GetComponent(2, 1) != 300 ||
+    !input->GetArrayChanged("pressure") ||
+    input->GetArrayChanged("velocity") || input->GetPointsChanged())
+    {
+    std::cerr << "Changed array was not refreshed.\n";
+    return 1;
+    }
+
+  // The copied array is released with the grid, the arrays used in place
+  // when VTK deletes them.
+  input->SetGrid(0);
+  if (released != 3 || input->GetNumberOfSimulationArrays() != 0)
+    {
+    std::cerr << "Released " << released << " simulation arrays, expected 3.\n";
+    return 1;
+    }
+  return 0;
+}
@@ -62,6 +62,11 @@ public:
   // Provides access to a grid description using the index.
   vtkCPInputDataDescription *GetInputDescription(unsigned int);
 
+  // Description:
+  // Returns the name of the grid of the input description with the given
+  // index, or NULL if the index is out of range.
+  const char* GetInputDescriptionName(unsigned int);
+
   // Description:
   // Provides access to a grid description using the grid name.
   vtkCPInputDataDescription *GetInputDescriptionByName(const char*);
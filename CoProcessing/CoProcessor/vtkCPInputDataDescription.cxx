@@ -15,33 +15,120 @@
 #include "vtkCPInputDataDescription.h"
 
 #include "vtkCellData.h"
+#include "vtkCommand.h"
 #include "vtkCompositeDataIterator.h"
 #include "vtkCompositeDataSet.h"
+#include "vtkDataArray.h"
 #include "vtkDataSet.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPointSet.h"
+#include "vtkSmartPointer.h"
 
+#include <vtkstd/map>
+#include <vtkstd/set>
 #include <vtkstd/vector>
 #include <vtkstd/string>
 #include <vtkstd/algorithm>
 
+namespace
+{
+  // Array associations of the simulation arrays.
+  enum
+    {
+    POINT_ARRAY = 0,
+    CELL_ARRAY = 1,
+    POINT_COORDINATES = 2
+    };
+
+  // Calls the release callback when an array using simulation memory
+  // is deleted.
+  class vtkCPReleaseCommand : public vtkCommand
+  {
+  public:
+    static vtkCPReleaseCommand* New() { return new vtkCPReleaseCommand; }
+    virtual void Execute(vtkObject*, unsigned long, void*)
+      {
+      if (this->Callback)
+        {
+        this->Callback(this->Data, this->ClientData);
+        }
+      }
+    vtkCPInputDataDescription::ReleaseCallbackType Callback;
+    void* Data;
+    void* ClientData;
+  protected:
+    vtkCPReleaseCommand() : Callback(0), Data(0), ClientData(0) {}
+  };
+
+  template <class T>
+  void vtkCPCopyArray(const T* in, T* out, vtkIdType numberOfTuples,
+    int numberOfComponents, vtkIdType tupleStride, vtkIdType componentStride)
+  {
+    for (vtkIdType t = 0; t < numberOfTuples; ++t)
+      {
+      const T* tuple = in + t * tupleStride;
+      for (int c = 0; c < numberOfComponents; ++c)
+        {
+        *out++ = tuple[c * componentStride];
+        }
+      }
+  }
+}
+
 class vtkCPInputDataDescription::vtkInternals
 {
 public:
   typedef vtkstd::vector<vtkstd::string> FieldType;
   FieldType PointFields;
   FieldType CellFields;
+
+  // Association and name of an array.
+  typedef vtkstd::pair<int, vtkstd::string> ArrayKeyType;
+
+  struct SimulationArray
+    {
+    void* Data;
+    int DataType;
+    vtkIdType NumberOfTuples;
+    int NumberOfComponents;
+    vtkIdType TupleStride;
+    vtkIdType ComponentStride;
+    // The array uses Data directly; otherwise it holds a copy.
+    bool InPlace;
+    vtkSmartPointer<vtkDataArray> Array;
+    };
+  typedef vtkstd::map<ArrayKeyType, SimulationArray> SimulationArraysType;
+  SimulationArraysType SimulationArrays;
+
+  vtkstd::set<ArrayKeyType> ChangedArrays;
+
+  // Copy the simulation memory into the array for layouts VTK cannot use
+  // directly.
+  static void CopyArray(SimulationArray& array)
+    {
+    switch (array.DataType)
+      {
+      vtkTemplateMacro(
+        vtkCPCopyArray(static_cast<VTK_TT*>(array.Data),
+          static_cast<VTK_TT*>(array.Array->GetVoidPointer(0)),
+          array.NumberOfTuples, array.NumberOfComponents,
+          array.TupleStride, array.ComponentStride));
+      }
+    }
 };
 
 vtkStandardNewMacro(vtkCPInputDataDescription);
 vtkCxxRevisionMacro(vtkCPInputDataDescription, "$Revision$");
-vtkCxxSetObjectMacro(vtkCPInputDataDescription, Grid, vtkDataObject);
 //----------------------------------------------------------------------------
 vtkCPInputDataDescription::vtkCPInputDataDescription()
 {
   this->Grid = 0;
   this->GenerateMesh = false;
   this->AllFields = false;
+  this->ReleaseCallback = 0;
+  this->ReleaseCallbackData = 0;
   this->Internals = new vtkInternals();
 }
 
@@ -144,12 +231,303 @@ bool vtkCPInputDataDescription::IsFieldPointData(const char* fieldName)
   return false;
 }
 
+//----------------------------------------------------------------------------
+void vtkCPInputDataDescription::SetGrid(vtkDataObject* grid)
+{
+  if (this->Grid == grid)
+    {
+    return;
+    }
+  // The simulation arrays belong to the previous grid.
+  this->ReleaseSimulationArrays();
+  if (this->Grid)
+    {
+    this->Grid->UnRegister(this);
+    }
+  this->Grid = grid;
+  if (this->Grid)
+    {
+    this->Grid->Register(this);
+    }
+  this->Modified();
+}
+
 //----------------------------------------------------------------------------
 vtkDataObject* vtkCPInputDataDescription::GetGrid()
 {
   return this->Grid;
 }
 
+//----------------------------------------------------------------------------
+void vtkCPInputDataDescription::SetReleaseCallback(
+  ReleaseCallbackType callback, void* clientData)
+{
+  this->ReleaseCallback = callback;
+  this->ReleaseCallbackData = clientData;
+}
+
+//----------------------------------------------------------------------------
+bool vtkCPInputDataDescription::SetPointArray(const char* name, int dataType,
+  void* data, vtkIdType numberOfTuples, int numberOfComponents, int layout,
+  vtkIdType stride)
+{
+  return this->SetSimulationArray(POINT_ARRAY, name, dataType, data,
+    numberOfTuples, numberOfComponents, layout, stride);
+}
+
+//----------------------------------------------------------------------------
+bool vtkCPInputDataDescription::SetCellArray(const char* name, int dataType,
+  void* data, vtkIdType numberOfTuples, int numberOfComponents, int layout,
+  vtkIdType stride)
+{
+  return this->SetSimulationArray(CELL_ARRAY, name, dataType, data,
+    numberOfTuples, numberOfComponents, layout, stride);
+}
+
+//----------------------------------------------------------------------------
+bool vtkCPInputDataDescription::SetPoints(int dataType, void* data,
+  vtkIdType numberOfPoints, int layout, vtkIdType stride)
+{
+  if (dataType != VTK_FLOAT && dataType != VTK_DOUBLE)
+    {
+    vtkErrorMacro("Point coordinates must be float or double.");
+    return false;
+    }
+  return this->SetSimulationArray(POINT_COORDINATES, "", dataType, data,
+    numberOfPoints, 3, layout, stride);
+}
+
+//----------------------------------------------------------------------------
+bool vtkCPInputDataDescription::SetSimulationArray(int association,
+  const char* name, int dataType, void* data, vtkIdType numberOfTuples,
+  int numberOfComponents, int layout, vtkIdType stride)
+{
+  vtkDataSet* dataSet = vtkDataSet::SafeDownCast(this->Grid);
+  if (!dataSet || !name || !data || numberOfTuples < 0 ||
+    numberOfComponents < 1)
+    {
+    vtkErrorMacro("Cannot use simulation memory without a vtkDataSet grid, "
+      "a name and valid dimensions.");
+    return false;
+    }
+  vtkPointSet* pointSet = vtkPointSet::SafeDownCast(dataSet);
+  if (association == POINT_COORDINATES && !pointSet)
+    {
+    vtkErrorMacro("Point coordinates can only be set on a vtkPointSet.");
+    return false;
+    }
+
+  vtkInternals::SimulationArray array;
+  array.Data = data;
+  array.DataType = dataType;
+  array.NumberOfTuples = numberOfTuples;
+  array.NumberOfComponents = numberOfComponents;
+  if (layout == STRUCTURE_OF_ARRAYS)
+    {
+    array.TupleStride = 1;
+    array.ComponentStride = stride > 0 ? stride : numberOfTuples;
+    }
+  else
+    {
+    array.TupleStride = stride > 0 ? stride : numberOfComponents;
+    array.ComponentStride = 1;
+    }
+  array.InPlace = (array.TupleStride == numberOfComponents &&
+    (array.ComponentStride == 1 || numberOfComponents == 1));
+
+  vtkInternals::ArrayKeyType key(association, name);
+  vtkInternals::SimulationArraysType::iterator iter =
+    this->Internals->SimulationArrays.find(key);
+  if (iter != this->Internals->SimulationArrays.end())
+    {
+    vtkInternals::SimulationArray& previous = iter->second;
+    if (previous.Data == array.Data && previous.DataType == array.DataType &&
+      previous.NumberOfTuples == array.NumberOfTuples &&
+      previous.NumberOfComponents == array.NumberOfComponents &&
+      previous.TupleStride == array.TupleStride &&
+      previous.ComponentStride == array.ComponentStride)
+      {
+      // Same memory: the array only needs to be refreshed.
+      this->Internals->ChangedArrays.insert(key);
+      if (!previous.InPlace)
+        {
+        vtkInternals::CopyArray(previous);
+        }
+      previous.Array->Modified();
+      if (association == POINT_COORDINATES)
+        {
+        pointSet->GetPoints()->Modified();
+        }
+      return true;
+      }
+    if (!previous.InPlace && this->ReleaseCallback)
+      {
+      this->ReleaseCallback(previous.Data, this->ReleaseCallbackData);
+      }
+    this->Internals->SimulationArrays.erase(iter);
+    }
+
+  array.Array.TakeReference(vtkDataArray::CreateDataArray(dataType));
+  if (!array.Array)
+    {
+    vtkErrorMacro("Unsupported data type " << dataType << ".");
+    return false;
+    }
+  array.Array->SetNumberOfComponents(numberOfComponents);
+  array.Array->SetName(name);
+  if (array.InPlace)
+    {
+    // save=1: the simulation keeps ownership of the memory.
+    array.Array->SetVoidArray(data, numberOfTuples * numberOfComponents, 1);
+    vtkCPReleaseCommand* command = vtkCPReleaseCommand::New();
+    command->Callback = this->ReleaseCallback;
+    command->Data = data;
+    command->ClientData = this->ReleaseCallbackData;
+    array.Array->AddObserver(vtkCommand::DeleteEvent, command);
+    command->Delete();
+    }
+  else
+    {
+    array.Array->SetNumberOfTuples(numberOfTuples);
+    vtkInternals::CopyArray(array);
+    }
+
+  if (association == POINT_COORDINATES)
+    {
+    vtkPoints* points = vtkPoints::New(dataType);
+    points->SetData(array.Array);
+    pointSet->SetPoints(points);
+    points->Delete();
+    }
+  else if (association == POINT_ARRAY)
+    {
+    dataSet->GetPointData()->AddArray(array.Array);
+    }
+  else
+    {
+    dataSet->GetCellData()->AddArray(array.Array);
+    }
+  this->Internals->SimulationArrays[key] = array;
+  this->Internals->ChangedArrays.insert(key);
+  return true;
+}
+
+//----------------------------------------------------------------------------
+void vtkCPInputDataDescription::ReleaseSimulationArrays()
+{
+  vtkInternals::SimulationArraysType::iterator iter;
+  for (iter = this->Internals->SimulationArrays.begin();
+    iter != this->Internals->SimulationArrays.end(); ++iter)
+    {
+    // Arrays used in place are released when VTK deletes them.
+    if (!iter->second.InPlace && this->ReleaseCallback)
+      {
+      this->ReleaseCallback(iter->second.Data, this->ReleaseCallbackData);
+      }
+    }
+  this->Internals->SimulationArrays.clear();
+  this->Internals->ChangedArrays.clear();
+}
+
+//----------------------------------------------------------------------------
+void vtkCPInputDataDescription::MarkArrayChanged(const char* name)
+{
+  vtkDataSet* dataSet = vtkDataSet::SafeDownCast(this->Grid);
+  if (!name || !dataSet)
+    {
+    return;
+    }
+  for (int association = POINT_ARRAY; association <= CELL_ARRAY; ++association)
+    {
+    vtkInternals::ArrayKeyType key(association, name);
+    vtkInternals::SimulationArraysType::iterator iter =
+      this->Internals->SimulationArrays.find(key);
+    vtkDataArray* dataArray = 0;
+    if (iter != this->Internals->SimulationArrays.end())
+      {
+      if (!iter->second.InPlace)
+        {
+        vtkInternals::CopyArray(iter->second);
+        }
+      dataArray = iter->second.Array;
+      }
+    else if (association == POINT_ARRAY)
+      {
+      dataArray = dataSet->GetPointData()->GetArray(name);
+      }
+    else
+      {
+      dataArray = dataSet->GetCellData()->GetArray(name);
+      }
+    if (dataArray)
+      {
+      dataArray->Modified();
+      this->Internals->ChangedArrays.insert(key);
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkCPInputDataDescription::MarkPointsChanged()
+{
+  vtkPointSet* pointSet = vtkPointSet::SafeDownCast(this->Grid);
+  if (!pointSet || !pointSet->GetPoints())
+    {
+    return;
+    }
+  vtkInternals::ArrayKeyType key(POINT_COORDINATES, "");
+  vtkInternals::SimulationArraysType::iterator iter =
+    this->Internals->SimulationArrays.find(key);
+  if (iter != this->Internals->SimulationArrays.end() && !iter->second.InPlace)
+    {
+    vtkInternals::CopyArray(iter->second);
+    }
+  pointSet->GetPoints()->GetData()->Modified();
+  pointSet->GetPoints()->Modified();
+  this->Internals->ChangedArrays.insert(key);
+}
+
+//----------------------------------------------------------------------------
+bool vtkCPInputDataDescription::GetArrayChanged(const char* name)
+{
+  if (!name)
+    {
+    return false;
+    }
+  vtkstd::set<vtkInternals::ArrayKeyType>& changed =
+    this->Internals->ChangedArrays;
+  return (changed.find(vtkInternals::ArrayKeyType(POINT_ARRAY, name)) !=
+    changed.end() ||
+    changed.find(vtkInternals::ArrayKeyType(CELL_ARRAY, name)) !=
+    changed.end());
+}
+
+//----------------------------------------------------------------------------
+bool vtkCPInputDataDescription::GetPointsChanged()
+{
+  return (this->Internals->ChangedArrays.find(
+      vtkInternals::ArrayKeyType(POINT_COORDINATES, "")) !=
+    this->Internals->ChangedArrays.end());
+}
+
+//----------------------------------------------------------------------------
+unsigned int vtkCPInputDataDescription::GetNumberOfChangedArrays()
+{
+  return static_cast<unsigned int>(this->Internals->ChangedArrays.size());
+}
+
+//----------------------------------------------------------------------------
+void vtkCPInputDataDescription::ClearChangedArrays()
+{
+  this->Internals->ChangedArrays.clear();
+}
+
+//----------------------------------------------------------------------------
+unsigned int vtkCPInputDataDescription::GetNumberOfSimulationArrays()
+{
+  return static_cast<unsigned int>(this->Internals->SimulationArrays.size());
+}
+
 //----------------------------------------------------------------------------
 bool vtkCPInputDataDescription::IsInputSufficient()
 {
@@ -233,5 +611,9 @@ void vtkCPInputDataDescription::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "AllFields: " << this->AllFields << "\n";
   os << indent << "GenerateMesh: " << this->GenerateMesh << "\n";
   os << indent << "Grid: " << this->Grid << "\n";
+  os << indent << "NumberOfSimulationArrays: "
+     << this->GetNumberOfSimulationArrays() << "\n";
+  os << indent << "NumberOfChangedArrays: "
+     << this->GetNumberOfChangedArrays() << "\n";
 }
 
@@ -17,10 +17,20 @@
 // .SECTION Description
 // This class provides the data description for each input for the coprocessor
 // pipelines.
+//
+// Instead of building new VTK arrays every time step, a simulation may hand
+// its own memory to SetPointArray(), SetCellArray() and SetPoints(). Arrays
+// laid out as contiguous tuples are used in place. Other layouts are copied
+// into a VTK array, since VTK arrays store their tuples contiguously, and the
+// copy is refreshed whenever the array is marked as changed. After memory is
+// set once, the simulation only calls MarkArrayChanged() (or MarkPointsChanged())
+// for the arrays it updated. Only those arrays are modified, so the pipelines
+// only re-execute when their input actually changed.
 
 #ifndef __vtkCPInputDataDescription_h
 #define __vtkCPInputDataDescription_h
 
+class vtkDataArray;
 class vtkDataObject;
 class vtkDataSet;
 class vtkFieldData;
@@ -90,6 +100,90 @@ public:
   // Returns true if the grid is necessary..
   bool GetIfGridIsNecessary();
 
+  // Description:
+  // Memory layouts of the simulation arrays given to SetPointArray(),
+  // SetCellArray() and SetPoints(). With ARRAY_OF_STRUCTURES component c of
+  // tuple t is at data[t * stride + c], where the stride defaults to the
+  // number of components. With STRUCTURE_OF_ARRAYS it is at
+  // data[c * stride + t], where the stride defaults to the number of tuples.
+  enum
+    {
+    ARRAY_OF_STRUCTURES = 0,
+    STRUCTURE_OF_ARRAYS = 1
+    };
+
+  // Description:
+  // Use simulation owned memory as the point (or cell) array named name of
+  // the grid, which must be a vtkDataSet. dataType is a VTK scalar type such
+  // as VTK_DOUBLE. The memory is used without a copy when it holds
+  // contiguous tuples (ARRAY_OF_STRUCTURES with the default stride, or a
+  // single component with unit stride), and must stay valid until it is
+  // released (see SetReleaseCallback()). The array is marked as changed.
+  // Returns false if the grid cannot hold the array.
+  bool SetPointArray(const char* name, int dataType, void* data,
+    vtkIdType numberOfTuples, int numberOfComponents, int layout,
+    vtkIdType stride);
+  bool SetPointArray(const char* name, int dataType, void* data,
+    vtkIdType numberOfTuples, int numberOfComponents)
+    {
+    return this->SetPointArray(name, dataType, data, numberOfTuples,
+      numberOfComponents, ARRAY_OF_STRUCTURES, 0);
+    }
+  bool SetCellArray(const char* name, int dataType, void* data,
+    vtkIdType numberOfTuples, int numberOfComponents, int layout,
+    vtkIdType stride);
+  bool SetCellArray(const char* name, int dataType, void* data,
+    vtkIdType numberOfTuples, int numberOfComponents)
+    {
+    return this->SetCellArray(name, dataType, data, numberOfTuples,
+      numberOfComponents, ARRAY_OF_STRUCTURES, 0);
+    }
+
+  // Description:
+  // Use simulation owned memory as the point coordinates of the grid, which
+  // must be a vtkPointSet. dataType must be VTK_FLOAT or VTK_DOUBLE. See
+  // SetPointArray().
+  bool SetPoints(int dataType, void* data, vtkIdType numberOfPoints,
+    int layout, vtkIdType stride);
+  bool SetPoints(int dataType, void* data, vtkIdType numberOfPoints)
+    {
+    return this->SetPoints(dataType, data, numberOfPoints,
+      ARRAY_OF_STRUCTURES, 0);
+    }
+
+  // Description:
+  // Tell the coprocessor that the simulation updated the memory of the point
+  // or cell arrays named name (or of the point coordinates). Copied arrays
+  // are refreshed and the arrays are modified so that the pipelines using
+  // them re-execute. Arrays of the grid that were not set through
+  // SetPointArray()/SetCellArray() may be marked as well.
+  void MarkArrayChanged(const char* name);
+  void MarkPointsChanged();
+
+  // Description:
+  // Returns true if the point or cell array named name (or the point
+  // coordinates) was set or marked as changed since the last time the
+  // pipelines were run. vtkCPProcessor::CoProcess() clears the flags.
+  bool GetArrayChanged(const char* name);
+  bool GetPointsChanged();
+  unsigned int GetNumberOfChangedArrays();
+  void ClearChangedArrays();
+
+  // Description:
+  // Returns the number of arrays (including the point coordinates) that
+  // currently use simulation memory.
+  unsigned int GetNumberOfSimulationArrays();
+
+  //BTX
+  // Description:
+  // Called with the memory given to SetPointArray(), SetCellArray() or
+  // SetPoints() once the coprocessor no longer references it, that is when
+  // the VTK array using it is deleted or, for copied layouts, when the
+  // memory is replaced or the grid changes. clientData is passed through.
+  typedef void (*ReleaseCallbackType)(void* data, void* clientData);
+  void SetReleaseCallback(ReleaseCallbackType callback, void* clientData);
+  //ETX
+
 //BTX
 protected:
   vtkCPInputDataDescription();
@@ -105,6 +199,17 @@ protected:
   // Returns true if it does and false otherwise.
   bool DoesGridContainNeededFields(vtkDataSet* DataSet);
 
+  // Description:
+  // Attach the simulation memory to the grid for SetPointArray(),
+  // SetCellArray() and SetPoints().
+  bool SetSimulationArray(int association, const char* name, int dataType,
+    void* data, vtkIdType numberOfTuples, int numberOfComponents, int layout,
+    vtkIdType stride);
+
+  // Description:
+  // Forget all simulation arrays, releasing the copied ones.
+  void ReleaseSimulationArrays();
+
   // Description:
   // On when all fields must be requested for the coprocessing pipeline.
   bool AllFields;
@@ -117,6 +222,9 @@ protected:
   // The grid for coprocessing. The grid is not owned by the object.
   vtkDataObject* Grid;
 
+  ReleaseCallbackType ReleaseCallback;
+  void* ReleaseCallbackData;
+
 private:
   vtkCPInputDataDescription(const vtkCPInputDataDescription&); // Not implemented.
   void operator=(const vtkCPInputDataDescription&); // Not implemented.
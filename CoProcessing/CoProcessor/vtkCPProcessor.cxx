@@ -14,22 +14,290 @@
 =========================================================================*/
 #include "vtkCPProcessor.h"
 
+#include "CPSystemInformation.h"
+#include "vtkCellData.h"
+#include "vtkCompositeDataIterator.h"
+#include "vtkCompositeDataSet.h"
+#include "vtkConditionVariable.h"
 #include "vtkCPDataDescription.h"
+#include "vtkCPInputDataDescription.h"
 #include "vtkCPPipeline.h"
 #include "vtkCPPythonScriptPipeline.h"
 #include "vtkDataObject.h"
+#include "vtkDataSet.h"
 #include "vtkFieldData.h"
+#include "vtkMultiThreader.h"
+#include "vtkMutexLock.h"
 #include "vtkObjectFactory.h"
+#include "vtkPointData.h"
 #include "vtkSmartPointer.h"
 #include "vtkSMProxyManager.h"
 
+#include <vtkstd/deque>
 #include <vtkstd/set>
+#include <vtkstd/string>
+
+#ifdef COPROCESSOR_USE_MPI
+#define MPICH_SKIP_MPICXX
+#include "mpi.h"
+#endif
 
 struct vtkCPProcessorInternals
 {
   typedef vtkstd::set<vtkSmartPointer<vtkCPPipeline> > PipelineSet;
   typedef PipelineSet::iterator PipelineSetIterator;
   PipelineSet Pipelines;
+
+  // Asynchronous processing. A copied time step is queued with whether
+  // the pipelines still have to be asked if they want it.
+  struct QueuedTimeStep
+    {
+    vtkSmartPointer<vtkCPDataDescription> DataDescription;
+    bool RequestPending;
+    };
+  vtkstd::deque<QueuedTimeStep> Queue;
+  vtkMultiThreader* Threader;
+  int ThreadId;
+  bool Busy;
+  bool Stop;
+  int NumberOfDroppedTimeSteps;
+  // A time step failed on the helper thread since the last report.
+  bool Failed;
+  // Protects the queue and the flags above, QueueChanged is signaled
+  // whenever one of them changes.
+  vtkMutexLock* QueueLock;
+  vtkConditionVariable* QueueChanged;
+  // Held while the pipelines run so that they never run concurrently.
+  vtkMutexLock* PipelineLock;
+  // The fields the pipelines requested the last time they wanted a time
+  // step, used while the helper thread is busy.
+  vtkSmartPointer<vtkCPDataDescription> LastRequest;
+  // The current time step was accepted without asking the pipelines.
+  bool RequestPending;
+
+  // The pipelines may use MPI, so they can only run on a helper thread
+  // when MPI supports calls from any thread.
+  static bool CanUseHelperThread()
+    {
+#ifdef COPROCESSOR_USE_MPI
+    int Initialized = 0;
+    MPI_Initialized(&Initialized);
+    if(Initialized)
+      {
+      int Provided = MPI_THREAD_SINGLE;
+      MPI_Query_thread(&Provided);
+      return Provided == MPI_THREAD_MULTIPLE;
+      }
+#endif
+    return true;
+    }
+
+  // Returns whether a time step failed on the helper thread since the last
+  // call.
+  bool TakeFailure()
+    {
+    this->QueueLock->Lock();
+    bool Failure = this->Failed;
+    this->Failed = false;
+    this->QueueLock->Unlock();
+    return Failure;
+    }
+
+  int RequestPipelines(vtkCPDataDescription* DataDescription)
+    {
+    int DoCoProcessing = 0;
+    DataDescription->Reset();
+    for(PipelineSetIterator iter=this->Pipelines.begin();
+        iter!=this->Pipelines.end();iter++)
+      {
+      if(iter->GetPointer()->RequestDataDescription(DataDescription))
+        {
+        DoCoProcessing = 1;
+        }
+      }
+    return DoCoProcessing;
+    }
+
+  int CoProcessPipelines(vtkCPDataDescription* DataDescription)
+    {
+    int Success = 1;
+    DataDescription->Reset();
+    for(PipelineSetIterator iter=this->Pipelines.begin();
+        iter!=this->Pipelines.end();iter++)
+      {
+      if(!iter->GetPointer()->CoProcess(DataDescription))
+        {
+        Success = 0;
+        }
+      }
+    return Success;
+    }
+
+  // Copy the fields and flags requested in From into To.
+  static void CopyRequest(vtkCPDataDescription* From, vtkCPDataDescription* To)
+    {
+    for(unsigned int i=0;i<From->GetNumberOfInputDescriptions();i++)
+      {
+      const char* GridName = From->GetInputDescriptionName(i);
+      vtkCPInputDataDescription* FromInput = From->GetInputDescription(i);
+      To->AddInput(GridName);
+      vtkCPInputDataDescription* ToInput =
+        To->GetInputDescriptionByName(GridName);
+      ToInput->Reset();
+      for(unsigned int j=0;j<FromInput->GetNumberOfFields();j++)
+        {
+        const char* FieldName = FromInput->GetFieldName(j);
+        if(FromInput->IsFieldPointData(FieldName))
+          {
+          ToInput->AddPointField(FieldName);
+          }
+        else
+          {
+          ToInput->AddCellField(FieldName);
+          }
+        }
+      ToInput->SetAllFields(FromInput->GetAllFields());
+      ToInput->SetGenerateMesh(FromInput->GetGenerateMesh());
+      }
+    }
+
+  // Remove the arrays the pipelines did not request.
+  static void RemoveUnneededFields(vtkDataSet* DataSet,
+                                   vtkCPInputDataDescription* Input)
+    {
+    if(Input->GetAllFields())
+      {
+      return;
+      }
+    vtkFieldData* Fields[2] =
+      { DataSet->GetPointData(), DataSet->GetCellData() };
+    for(int i=0;i<2;i++)
+      {
+      for(int j=Fields[i]->GetNumberOfArrays()-1;j>=0;j--)
+        {
+        const char* Name = Fields[i]->GetAbstractArray(j)->GetName();
+        if(Name && !Input->IsFieldNeeded(Name))
+          {
+          Fields[i]->RemoveArray(Name);
+          }
+        }
+      }
+    }
+
+  // Deep copy the requested part of the grids so that the simulation can
+  // go on while the copy is processed.
+  static vtkCPDataDescription* CopyTimeStep(
+    vtkCPDataDescription* DataDescription)
+    {
+    vtkCPDataDescription* Copy = vtkCPDataDescription::New();
+    Copy->SetTimeData(DataDescription->GetTime(),
+                      DataDescription->GetTimeStep());
+    CopyRequest(DataDescription, Copy);
+    for(unsigned int i=0;i<DataDescription->GetNumberOfInputDescriptions();i++)
+      {
+      vtkCPInputDataDescription* Input =
+        DataDescription->GetInputDescription(i);
+      vtkDataObject* Grid = Input->GetGrid();
+      if(!Grid || !Input->GetIfGridIsNecessary())
+        {
+        continue;
+        }
+      vtkDataObject* GridCopy = Grid->NewInstance();
+      vtkDataSet* DataSet = vtkDataSet::SafeDownCast(Grid);
+      if(DataSet)
+        {
+        // Only copy the arrays that were requested.
+        vtkDataSet* Requested = DataSet->NewInstance();
+        Requested->ShallowCopy(DataSet);
+        RemoveUnneededFields(Requested, Input);
+        GridCopy->DeepCopy(Requested);
+        Requested->Delete();
+        }
+      else
+        {
+        GridCopy->DeepCopy(Grid);
+        vtkCompositeDataSet* Composite =
+          vtkCompositeDataSet::SafeDownCast(GridCopy);
+        if(Composite)
+          {
+          vtkCompositeDataIterator* Iter = Composite->NewIterator();
+          Iter->VisitOnlyLeavesOn();
+          Iter->TraverseSubTreeOn();
+          Iter->SkipEmptyNodesOn();
+          for(Iter->GoToFirstItem();!Iter->IsDoneWithTraversal();
+              Iter->GoToNextItem())
+            {
+            DataSet = vtkDataSet::SafeDownCast(Iter->GetCurrentDataObject());
+            if(DataSet)
+              {
+              RemoveUnneededFields(DataSet, Input);
+              }
+            }
+          Iter->Delete();
+          }
+        }
+      Copy->GetInputDescriptionByName(
+        DataDescription->GetInputDescriptionName(i))->SetGrid(GridCopy);
+      GridCopy->Delete();
+      }
+    return Copy;
+    }
+
+  // Process the queued time steps until asked to stop.
+  static VTK_THREAD_RETURN_TYPE ProcessQueue(void* Arg)
+    {
+    vtkMultiThreader::ThreadInfo* Info =
+      static_cast<vtkMultiThreader::ThreadInfo*>(Arg);
+    vtkCPProcessorInternals* Self =
+      static_cast<vtkCPProcessorInternals*>(Info->UserData);
+    Self->QueueLock->Lock();
+    for(;;)
+      {
+      while(Self->Queue.empty() && !Self->Stop)
+        {
+        Self->QueueChanged->Wait(Self->QueueLock);
+        }
+      if(Self->Queue.empty())
+        {
+        break;
+        }
+      QueuedTimeStep TimeStep = Self->Queue.front();
+      Self->Queue.pop_front();
+      Self->Busy = true;
+      Self->QueueChanged->Broadcast();
+      Self->QueueLock->Unlock();
+
+      Self->PipelineLock->Lock();
+      int DoCoProcessing = 1;
+      if(TimeStep.RequestPending)
+        {
+        DoCoProcessing = Self->RequestPipelines(TimeStep.DataDescription);
+        if(DoCoProcessing)
+          {
+          Self->QueueLock->Lock();
+          CopyRequest(TimeStep.DataDescription, Self->LastRequest);
+          Self->QueueLock->Unlock();
+          }
+        }
+      int Success = 1;
+      if(DoCoProcessing)
+        {
+        Success = Self->CoProcessPipelines(TimeStep.DataDescription);
+        }
+      Self->PipelineLock->Unlock();
+      TimeStep.DataDescription = 0;
+
+      Self->QueueLock->Lock();
+      if(!Success)
+        {
+        Self->Failed = true;
+        }
+      Self->Busy = false;
+      Self->QueueChanged->Broadcast();
+      }
+    Self->QueueLock->Unlock();
+    return VTK_THREAD_RETURN_VALUE;
+    }
 };
 
 vtkCxxRevisionMacro(vtkCPProcessor, "$Revision$");
@@ -38,12 +306,32 @@ vtkStandardNewMacro(vtkCPProcessor);
 //----------------------------------------------------------------------------
 vtkCPProcessor::vtkCPProcessor()
 {
+  this->Asynchronous = 0;
+  this->MaximumQueueLength = 1;
+  this->QueueFullPolicy = BLOCK;
   this->Internal = new vtkCPProcessorInternals;
+  this->Internal->Threader = vtkMultiThreader::New();
+  this->Internal->ThreadId = -1;
+  this->Internal->Busy = false;
+  this->Internal->Stop = false;
+  this->Internal->NumberOfDroppedTimeSteps = 0;
+  this->Internal->Failed = false;
+  this->Internal->QueueLock = vtkMutexLock::New();
+  this->Internal->QueueChanged = vtkConditionVariable::New();
+  this->Internal->PipelineLock = vtkMutexLock::New();
+  this->Internal->LastRequest =
+    vtkSmartPointer<vtkCPDataDescription>::New();
+  this->Internal->RequestPending = false;
 }
 
 //----------------------------------------------------------------------------
 vtkCPProcessor::~vtkCPProcessor()
 {
+  this->StopHelperThread();
+  this->Internal->Threader->Delete();
+  this->Internal->QueueLock->Delete();
+  this->Internal->QueueChanged->Delete();
+  this->Internal->PipelineLock->Delete();
   delete this->Internal;
 }
 
@@ -55,7 +343,9 @@ int vtkCPProcessor::AddPipeline(vtkCPPipeline* Pipeline)
     vtkErrorMacro("Pipeline is NULL.");
     return 0;
     }
+  this->Internal->PipelineLock->Lock();
   this->Internal->Pipelines.insert(Pipeline);
+  this->Internal->PipelineLock->Unlock();
   return 1;
 }
 
@@ -74,16 +364,45 @@ int vtkCPProcessor::RequestDataDescription(
     vtkWarningMacro("DataDescription is NULL.");
     return 0;
     }
-  int DoCoProcessing = 0;
-  DataDescription->Reset();
-  for(vtkCPProcessorInternals::PipelineSetIterator iter = 
-        this->Internal->Pipelines.begin();
-      iter!=this->Internal->Pipelines.end();iter++)
+  vtkCPProcessorInternals* Internal = this->Internal;
+  if(this->Asynchronous)
     {
-    if(iter->GetPointer()->RequestDataDescription(DataDescription))
+    Internal->QueueLock->Lock();
+    while(Internal->Busy || !Internal->Queue.empty())
       {
-      DoCoProcessing = 1;
+      if(static_cast<int>(Internal->Queue.size()) < this->MaximumQueueLength)
+        {
+        // The pipelines are busy, they will be asked on the copy.
+        DataDescription->Reset();
+        vtkCPProcessorInternals::CopyRequest(Internal->LastRequest,
+                                             DataDescription);
+        Internal->RequestPending = true;
+        Internal->QueueLock->Unlock();
+        return DataDescription->GetIfAnyGridNecessary()? 1: 0;
+        }
+      if(this->QueueFullPolicy == DROP)
+        {
+        Internal->NumberOfDroppedTimeSteps++;
+        Internal->QueueLock->Unlock();
+        DataDescription->Reset();
+        return 0;
+        }
+      Internal->QueueChanged->Wait(Internal->QueueLock);
       }
+    // Only this thread queues time steps, so the helper thread stays idle.
+    Internal->RequestPending = false;
+    Internal->QueueLock->Unlock();
+    }
+
+  Internal->PipelineLock->Lock();
+  int DoCoProcessing = Internal->RequestPipelines(DataDescription);
+  Internal->PipelineLock->Unlock();
+  if(DoCoProcessing && this->Asynchronous)
+    {
+    Internal->QueueLock->Lock();
+    vtkCPProcessorInternals::CopyRequest(DataDescription,
+                                         Internal->LastRequest);
+    Internal->QueueLock->Unlock();
     }
   return DoCoProcessing;
 }
@@ -97,23 +416,151 @@ int vtkCPProcessor::CoProcess(vtkCPDataDescription* DataDescription)
     return 0;
     }
   int Success = 1;
-  DataDescription->Reset();
-  for(vtkCPProcessorInternals::PipelineSetIterator iter = 
-        this->Internal->Pipelines.begin();
-      iter!=this->Internal->Pipelines.end();iter++)
+  vtkCPProcessorInternals* Internal = this->Internal;
+  if(this->Asynchronous && Internal->ThreadId < 0 &&
+     !vtkCPProcessorInternals::CanUseHelperThread())
     {
-    if(!iter->GetPointer()->CoProcess(DataDescription))
+    // MPI may have been initialized after SetAsynchronous().
+    vtkWarningMacro("MPI was not initialized with MPI_THREAD_MULTIPLE, "
+                    "co-processing synchronously.");
+    this->Asynchronous = 0;
+    }
+  if(Internal->TakeFailure())
+    {
+    vtkErrorMacro("Co-processing failed for an earlier time step.");
+    Success = 0;
+    }
+  if(!this->Asynchronous)
+    {
+    Internal->PipelineLock->Lock();
+    if(!Internal->CoProcessPipelines(DataDescription))
       {
       Success = 0;
       }
+    Internal->PipelineLock->Unlock();
+    }
+  else
+    {
+    Internal->QueueLock->Lock();
+    bool Drop = false;
+    while(static_cast<int>(Internal->Queue.size()) >=
+          this->MaximumQueueLength)
+      {
+      if(this->QueueFullPolicy == DROP)
+        {
+        Internal->NumberOfDroppedTimeSteps++;
+        Drop = true;
+        break;
+        }
+      Internal->QueueChanged->Wait(Internal->QueueLock);
+      }
+    bool RequestPending = Internal->RequestPending;
+    Internal->RequestPending = false;
+    Internal->QueueLock->Unlock();
+
+    if(!Drop)
+      {
+      // Copy outside of the lock, the queue can only get shorter meanwhile.
+      vtkCPProcessorInternals::QueuedTimeStep TimeStep;
+      TimeStep.DataDescription.TakeReference(
+        vtkCPProcessorInternals::CopyTimeStep(DataDescription));
+      TimeStep.RequestPending = RequestPending;
+
+      Internal->QueueLock->Lock();
+      Internal->Queue.push_back(TimeStep);
+      if(Internal->ThreadId < 0)
+        {
+        Internal->Stop = false;
+        Internal->ThreadId = Internal->Threader->SpawnThread(
+          vtkCPProcessorInternals::ProcessQueue, Internal);
+        }
+      Internal->QueueChanged->Broadcast();
+      Internal->QueueLock->Unlock();
+      }
+    }
+  // The pipelines are up to date with the simulation arrays.
+  for(unsigned int i=0;i<DataDescription->GetNumberOfInputDescriptions();i++)
+    {
+    DataDescription->GetInputDescription(i)->ClearChangedArrays();
     }
   return Success;
 }
 
+//----------------------------------------------------------------------------
+void vtkCPProcessor::SetAsynchronous(int Asynchronous)
+{
+  if(this->Asynchronous == Asynchronous)
+    {
+    return;
+    }
+  if(Asynchronous && !vtkCPProcessorInternals::CanUseHelperThread())
+    {
+    vtkWarningMacro("MPI was not initialized with MPI_THREAD_MULTIPLE, "
+                    "co-processing synchronously.");
+    return;
+    }
+  if(!Asynchronous)
+    {
+    this->StopHelperThread();
+    }
+  this->Asynchronous = Asynchronous;
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+int vtkCPProcessor::GetNumberOfDroppedTimeSteps()
+{
+  this->Internal->QueueLock->Lock();
+  int Dropped = this->Internal->NumberOfDroppedTimeSteps;
+  this->Internal->QueueLock->Unlock();
+  return Dropped;
+}
+
+//----------------------------------------------------------------------------
+int vtkCPProcessor::WaitForCompletion()
+{
+  vtkCPProcessorInternals* Internal = this->Internal;
+  Internal->QueueLock->Lock();
+  while(Internal->Busy || !Internal->Queue.empty())
+    {
+    Internal->QueueChanged->Wait(Internal->QueueLock);
+    }
+  Internal->QueueLock->Unlock();
+  if(Internal->TakeFailure())
+    {
+    vtkErrorMacro("Co-processing failed for an earlier time step.");
+    return 0;
+    }
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+void vtkCPProcessor::StopHelperThread()
+{
+  vtkCPProcessorInternals* Internal = this->Internal;
+  if(Internal->ThreadId < 0)
+    {
+    return;
+    }
+  // The helper thread processes the queued time steps before it exits.
+  Internal->QueueLock->Lock();
+  Internal->Stop = true;
+  Internal->QueueChanged->Broadcast();
+  Internal->QueueLock->Unlock();
+  Internal->Threader->TerminateThread(Internal->ThreadId);
+  Internal->ThreadId = -1;
+}
+
 //----------------------------------------------------------------------------
 int vtkCPProcessor::Finalize()
 {
+  this->StopHelperThread();
   this->Internal->Pipelines.clear();
+  if(this->Internal->TakeFailure())
+    {
+    vtkErrorMacro("Co-processing failed for an earlier time step.");
+    return 0;
+    }
   return 1;
 }
 
@@ -121,4 +568,10 @@ int vtkCPProcessor::Finalize()
 void vtkCPProcessor::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os, indent);
+  os << indent << "Asynchronous: " << this->Asynchronous << "\n";
+  os << indent << "MaximumQueueLength: " << this->MaximumQueueLength << "\n";
+  os << indent << "QueueFullPolicy: "
+     << (this->QueueFullPolicy == DROP? "Drop" : "Block") << "\n";
+  os << indent << "NumberOfDroppedTimeSteps: "
+     << this->GetNumberOfDroppedTimeSteps() << "\n";
 }
@@ -42,6 +42,24 @@
 // selected during the Configuration Step than the priovided vtkDataObject
 // may be NULL.
 //
+// Asynchronous processing:
+// When Asynchronous is on, CoProcess() deep copies the grids with the
+// fields the pipelines requested and returns. The pipelines then run on a
+// helper thread so that the simulation does not wait for the analysis.
+// Up to MaximumQueueLength copied time steps wait for the helper thread.
+// When the queue is full, QueueFullPolicy either blocks the simulation
+// until a time step was processed or drops the time step.
+//
+// The pipelines are never run concurrently. While the helper thread is
+// busy, RequestDataDescription() does not consult the pipelines. It
+// requests the fields of the last time step they asked for, and the
+// helper thread consults them on the copy before processing it.
+// Time steps are dropped independently on each process, so pipelines that
+// communicate between processes must use BLOCK. They also need an MPI
+// library initialized with MPI_THREAD_MULTIPLE, without it the processor
+// stays synchronous. A time step that fails on the helper thread is
+// reported by the next call to CoProcess(), WaitForCompletion() or
+// Finalize(), which then return 0.
 
 #ifndef vtkCPProcessor_h
 #define vtkCPProcessor_h
@@ -91,12 +109,63 @@ public:
   // Description:
   // Called after all co-processing is complete giving the Co-Processor 
   // implementation an opportunity to clean up, before it is destroyed.
+  // Waits for the time steps queued for asynchronous processing.
   virtual int Finalize();
 
+  // Description:
+  // Run the pipelines on a helper thread. Off by default. Turning it off
+  // waits for the queued time steps. It cannot be turned on, with a
+  // warning, when MPI does not support MPI_THREAD_MULTIPLE.
+  virtual void SetAsynchronous(int);
+  vtkGetMacro(Asynchronous, int);
+  vtkBooleanMacro(Asynchronous, int);
+
+  // Description:
+  // Maximum number of time steps waiting for the helper thread in
+  // asynchronous mode. Default is 1.
+  vtkSetClampMacro(MaximumQueueLength, int, 1, VTK_INT_MAX);
+  vtkGetMacro(MaximumQueueLength, int);
+
+//BTX
+  enum
+    {
+    BLOCK = 0,
+    DROP = 1
+    };
+//ETX
+
+  // Description:
+  // What happens to a time step when the queue is full in asynchronous
+  // mode: BLOCK waits for the helper thread, DROP skips the time step.
+  // Default is BLOCK.
+  vtkSetClampMacro(QueueFullPolicy, int, BLOCK, DROP);
+  vtkGetMacro(QueueFullPolicy, int);
+  void SetQueueFullPolicyToBlock()
+    { this->SetQueueFullPolicy(BLOCK); }
+  void SetQueueFullPolicyToDrop()
+    { this->SetQueueFullPolicy(DROP); }
+
+  // Description:
+  // Number of time steps dropped because the queue was full.
+  int GetNumberOfDroppedTimeSteps();
+
+  // Description:
+  // Wait until the helper thread processed all queued time steps. Returns 0
+  // if a time step failed since the last report, 1 otherwise.
+  int WaitForCompletion();
+
 protected:
   vtkCPProcessor();
   virtual ~vtkCPProcessor();
 
+  // Description:
+  // Stop the helper thread once the queued time steps are processed.
+  void StopHelperThread();
+
+  int Asynchronous;
+  int MaximumQueueLength;
+  int QueueFullPolicy;
+
 private:
   vtkCPProcessor(const vtkCPProcessor&); // Not implemented
   void operator=(const vtkCPProcessor&); // Not implemented
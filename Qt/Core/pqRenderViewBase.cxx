@@ -185,6 +185,7 @@ void pqRenderViewBase::setDefaultPropertyValues()
 {
   vtkSMProxy* proxy = this->getProxy();
   pqSMAdaptor::setElementProperty(proxy->GetProperty("LODResolution"), 50);
+  pqSMAdaptor::setElementProperty(proxy->GetProperty("LODTriangleBudget"), 250000);
   pqSMAdaptor::setElementProperty(proxy->GetProperty("LODThreshold"), 5);
   pqSMAdaptor::setElementProperty(proxy->GetProperty("RemoteRenderThreshold"), 3);
   pqSMAdaptor::setElementProperty(proxy->GetProperty("TileDisplayCompositeThreshold"), 3);
@@ -358,6 +359,7 @@ static const char* pqRenderViewModuleLightSettings [] = {
 static const char* pqGlobalRenderViewModuleMiscSettings [] = {
   "LODThreshold",
   "LODResolution",
+  "LODTriangleBudget",
   "UseImmediateMode",
   "UseTriangleStrips",
   "RenderInterruptsEnabled",
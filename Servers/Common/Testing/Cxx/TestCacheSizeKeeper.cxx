@@ -0,0 +1,94 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    $RCSfile$
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkCacheSizeKeeper.h"
+#include "vtkSmartPointer.h"
+
+#include <vtkstd/set>
+
+// A cache that only remembers which keys it holds.
+class TestCache : public vtkCacheSizeKeeper::Cache
+{
+public:
+  virtual void EvictCacheEntry(double key) { this->Keys.erase(key); }
+  virtual void PrefetchCacheEntries(int count) { this->Prefetched += count; }
+  TestCache() : Prefetched(0) {}
+
+  bool Add(vtkCacheSizeKeeper* keeper, double key, unsigned long size)
+    {
+    if (keeper->AddCacheEntry(this, key, size))
+      {
+      this->Keys.insert(key);
+      return true;
+      }
+    return false;
+    }
+
+  vtkstd::set<double> Keys;
+  int Prefetched;
+};
+
+#define TEST_ASSERT(cond) \
+  if (!(cond)) \
+    { \
+    cerr << "Failed: " #cond " at line " << __LINE__ << endl; \
+    return 1; \
+    }
+
+int main(int, char*[])
+{
+  vtkSmartPointer<vtkCacheSizeKeeper> keeper =
+    vtkSmartPointer<vtkCacheSizeKeeper>::New();
+  TestCache a;
+  TestCache b;
+  keeper->RegisterCache(&a);
+  keeper->RegisterCache(&b);
+  keeper->SetCacheLimit(300);
+
+  // Fill the budget from two caches, then touch the oldest entry.
+  TEST_ASSERT(a.Add(keeper, 0.0, 100));
+  TEST_ASSERT(b.Add(keeper, 0.0, 100));
+  TEST_ASSERT(a.Add(keeper, 1.0, 100));
+  keeper->RecordCacheHit(&a, 0.0);
+  TEST_ASSERT(keeper->GetCacheSize() == 300);
+
+  // The least recently used entry is in the other cache.
+  TEST_ASSERT(a.Add(keeper, 2.0, 100));
+  TEST_ASSERT(b.Keys.empty());
+  TEST_ASSERT(a.Keys.size() == 3);
+  TEST_ASSERT(keeper->GetCacheEvictions() == 1);
+  TEST_ASSERT(keeper->GetCacheHits() == 1);
+
+  // Entries larger than the budget and prefetches that would evict are
+  // refused.
+  TEST_ASSERT(!b.Add(keeper, 5.0, 400));
+  TEST_ASSERT(!keeper->AddCacheEntry(&b, 6.0, 100, false));
+
+  // Least frequently used evicts the entry with the fewest hits.
+  keeper->SetEvictionPolicyToLeastFrequentlyUsed();
+  keeper->RecordCacheHit(&a, 2.0);
+  TEST_ASSERT(b.Add(keeper, 7.0, 100));
+  TEST_ASSERT(a.Keys.count(1.0) == 0);
+  TEST_ASSERT(a.Keys.count(0.0) == 1 && a.Keys.count(2.0) == 1);
+
+  keeper->Prefetch(4);
+  TEST_ASSERT(a.Prefetched == 4 && b.Prefetched == 4);
+
+  // Unregistering gives the memory back.
+  keeper->UnregisterCache(&a);
+  TEST_ASSERT(keeper->GetCacheSize() == 100);
+  keeper->UnregisterCache(&b);
+  TEST_ASSERT(keeper->GetCacheSize() == 0);
+  return 0;
+}
@@ -14,8 +14,66 @@
 =========================================================================*/
 #include "vtkCacheSizeKeeper.h"
 
+#include "vtkCommunicator.h"
+#include "vtkMultiProcessController.h"
 #include "vtkObjectFactory.h"
 
+#include <vtkstd/algorithm>
+#include <vtkstd/vector>
+
+//-----------------------------------------------------------------------------
+class vtkCacheSizeKeeper::vtkInternals
+{
+public:
+  struct Entry
+    {
+    vtkCacheSizeKeeper::Cache* Owner;
+    double Key;
+    unsigned long Size;
+    unsigned long LastUse;
+    unsigned long Uses;
+    };
+  typedef vtkstd::vector<Entry> EntriesType;
+  EntriesType Entries;
+  vtkstd::vector<vtkCacheSizeKeeper::Cache*> Caches;
+  unsigned long Clock;
+
+  EntriesType::iterator Find(vtkCacheSizeKeeper::Cache* owner, double key)
+    {
+    EntriesType::iterator iter;
+    for (iter = this->Entries.begin(); iter != this->Entries.end(); ++iter)
+      {
+      if (iter->Owner == owner && iter->Key == key)
+        {
+        break;
+        }
+      }
+    return iter;
+    }
+
+  // Returns the entry to evict first under the given policy.
+  EntriesType::iterator FindVictim(int policy)
+    {
+    EntriesType::iterator victim = this->Entries.begin();
+    EntriesType::iterator iter;
+    for (iter = victim; iter != this->Entries.end(); ++iter)
+      {
+      if (policy == vtkCacheSizeKeeper::LEAST_FREQUENTLY_USED &&
+        iter->Uses != victim->Uses)
+        {
+        if (iter->Uses < victim->Uses)
+          {
+          victim = iter;
+          }
+        }
+      else if (iter->LastUse < victim->LastUse)
+        {
+        victim = iter;
+        }
+      }
+    return victim;
+    }
+};
 
 vtkStandardNewMacro(vtkCacheSizeKeeper);
 vtkCxxRevisionMacro(vtkCacheSizeKeeper, "$Revision$");
@@ -24,11 +82,169 @@ vtkCacheSizeKeeper::vtkCacheSizeKeeper()
 {
   this->CacheSize = 0;
   this->CacheFull = 0;
+  this->CacheLimit = 0;
+  this->EvictionPolicy = LEAST_RECENTLY_USED;
+  this->CacheHits = 0;
+  this->CacheMisses = 0;
+  this->CacheEvictions = 0;
+  this->Internals = new vtkInternals;
+  this->Internals->Clock = 0;
 }
 
 //-----------------------------------------------------------------------------
 vtkCacheSizeKeeper::~vtkCacheSizeKeeper()
 {
+  delete this->Internals;
+}
+
+//-----------------------------------------------------------------------------
+void vtkCacheSizeKeeper::ResetStatistics()
+{
+  this->CacheHits = 0;
+  this->CacheMisses = 0;
+  this->CacheEvictions = 0;
+}
+
+//-----------------------------------------------------------------------------
+void vtkCacheSizeKeeper::RegisterCache(Cache* cache)
+{
+  if (vtkstd::find(this->Internals->Caches.begin(),
+      this->Internals->Caches.end(), cache) == this->Internals->Caches.end())
+    {
+    this->Internals->Caches.push_back(cache);
+    }
+}
+
+//-----------------------------------------------------------------------------
+void vtkCacheSizeKeeper::UnregisterCache(Cache* cache)
+{
+  vtkInternals::EntriesType::iterator iter = this->Internals->Entries.begin();
+  while (iter != this->Internals->Entries.end())
+    {
+    if (iter->Owner == cache)
+      {
+      this->FreeCacheSize(iter->Size);
+      iter = this->Internals->Entries.erase(iter);
+      }
+    else
+      {
+      ++iter;
+      }
+    }
+  this->Internals->Caches.erase(
+    vtkstd::remove(this->Internals->Caches.begin(),
+      this->Internals->Caches.end(), cache),
+    this->Internals->Caches.end());
+}
+
+//-----------------------------------------------------------------------------
+bool vtkCacheSizeKeeper::AddCacheEntry(Cache* cache, double key,
+  unsigned long kbytes, bool allowEviction)
+{
+  if (this->CacheLimit == 0)
+    {
+    // No budget, the animation scene decides when the caches are full.
+    if (this->CacheFull)
+      {
+      return false;
+      }
+    }
+  else
+    {
+    // Each process evicts on its own, vtkPVCacheKeeper only uses the cache
+    // for a time step cached on all of them.
+    if (kbytes > this->CacheLimit)
+      {
+      return false;
+      }
+    while (this->CacheSize + kbytes > this->CacheLimit)
+      {
+      if (!allowEviction || this->Internals->Entries.empty())
+        {
+        return false;
+        }
+      vtkInternals::EntriesType::iterator victim =
+        this->Internals->FindVictim(this->EvictionPolicy);
+      Cache* owner = victim->Owner;
+      double victimKey = victim->Key;
+      this->FreeCacheSize(victim->Size);
+      this->Internals->Entries.erase(victim);
+      this->CacheEvictions++;
+      owner->EvictCacheEntry(victimKey);
+      }
+    }
+
+  vtkInternals::Entry entry;
+  entry.Owner = cache;
+  entry.Key = key;
+  entry.Size = kbytes;
+  entry.LastUse = ++this->Internals->Clock;
+  entry.Uses = 1;
+  this->Internals->Entries.push_back(entry);
+  this->CacheSize += kbytes;
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+void vtkCacheSizeKeeper::RemoveCacheEntry(Cache* cache, double key)
+{
+  vtkInternals::EntriesType::iterator iter =
+    this->Internals->Find(cache, key);
+  if (iter != this->Internals->Entries.end())
+    {
+    this->FreeCacheSize(iter->Size);
+    this->Internals->Entries.erase(iter);
+    }
+}
+
+//-----------------------------------------------------------------------------
+void vtkCacheSizeKeeper::RecordCacheHit(Cache* cache, double key)
+{
+  this->CacheHits++;
+  vtkInternals::EntriesType::iterator iter =
+    this->Internals->Find(cache, key);
+  if (iter != this->Internals->Entries.end())
+    {
+    iter->LastUse = ++this->Internals->Clock;
+    iter->Uses++;
+    }
+}
+
+//-----------------------------------------------------------------------------
+void vtkCacheSizeKeeper::RecordCacheMiss()
+{
+  this->CacheMisses++;
+}
+
+//-----------------------------------------------------------------------------
+void vtkCacheSizeKeeper::Prefetch(int count)
+{
+  if (count <= 0)
+    {
+    return;
+    }
+  // Caches may unregister while prefetching, iterate over a copy.
+  vtkstd::vector<Cache*> caches = this->Internals->Caches;
+  vtkstd::vector<Cache*>::iterator iter;
+  for (iter = caches.begin(); iter != caches.end(); ++iter)
+    {
+    (*iter)->PrefetchCacheEntries(count);
+    }
+}
+
+//-----------------------------------------------------------------------------
+unsigned long vtkCacheSizeKeeper::AllReduce(unsigned long value,
+  int operation)
+{
+  vtkMultiProcessController* controller =
+    vtkMultiProcessController::GetGlobalController();
+  if (!controller || controller->GetNumberOfProcesses() <= 1)
+    {
+    return value;
+    }
+  unsigned long result = value;
+  controller->AllReduce(&value, &result, 1, operation);
+  return result;
 }
 
 //-----------------------------------------------------------------------------
@@ -37,4 +253,9 @@ void vtkCacheSizeKeeper::PrintSelf(ostream& os, vtkIndent indent)
   this->Superclass::PrintSelf(os, indent);
   os << indent << "CacheSize: " << this->CacheSize << endl;
   os << indent << "CacheFull: " << this->CacheFull << endl;
+  os << indent << "CacheLimit: " << this->CacheLimit << endl;
+  os << indent << "EvictionPolicy: " << this->EvictionPolicy << endl;
+  os << indent << "CacheHits: " << this->CacheHits << endl;
+  os << indent << "CacheMisses: " << this->CacheMisses << endl;
+  os << indent << "CacheEvictions: " << this->CacheEvictions << endl;
 }
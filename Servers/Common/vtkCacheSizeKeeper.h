@@ -17,6 +17,14 @@
 // .SECTION Description:
 // vtkCacheSizeKeeper keeps track of the amount of memory cached
 // by several vtkPVUpdateSuppressor objects.
+//
+// Caches may also register their entries with the keeper. When CacheLimit
+// is set, adding an entry that does not fit evicts entries of any
+// registered cache on this process, least recently used (or least
+// frequently used) first. Each process evicts on its own, so the caches of
+// a representation may hold different time steps on different processes.
+// The keeper also counts cache hits, misses and evictions, see
+// vtkPVCacheSizeInformation.
 
 #ifndef __vtkCacheSizeKeeper_h
 #define __vtkCacheSizeKeeper_h
@@ -62,16 +70,104 @@ public:
   vtkGetMacro(CacheFull, int);
   vtkSetMacro(CacheFull, int);
 
+  // Description:
+  // Memory budget (in kbytes) for the entries of the registered caches on
+  // this process. When non-zero, entries are evicted to make room for new
+  // ones and CacheFull is ignored. 0 (default) means no budget.
+  vtkSetMacro(CacheLimit, unsigned long);
+  vtkGetMacro(CacheLimit, unsigned long);
+
+  // Description:
+  // Choose which entry is evicted first: the least recently used one
+  // (default) or the least frequently used one.
+  enum EvictionPolicies
+    {
+    LEAST_RECENTLY_USED=0,
+    LEAST_FREQUENTLY_USED=1
+    };
+  vtkSetClampMacro(EvictionPolicy, int, LEAST_RECENTLY_USED,
+    LEAST_FREQUENTLY_USED);
+  vtkGetMacro(EvictionPolicy, int);
+  void SetEvictionPolicyToLeastRecentlyUsed()
+    { this->SetEvictionPolicy(LEAST_RECENTLY_USED); }
+  void SetEvictionPolicyToLeastFrequentlyUsed()
+    { this->SetEvictionPolicy(LEAST_FREQUENTLY_USED); }
+
+  // Description:
+  // Cache statistics since the last ResetStatistics().
+  vtkGetMacro(CacheHits, unsigned long);
+  vtkGetMacro(CacheMisses, unsigned long);
+  vtkGetMacro(CacheEvictions, unsigned long);
+  void ResetStatistics();
+
+  // Description:
+  // Ask every registered cache to fill up to count entries ahead of its
+  // current one, without evicting anything. The caches may update parallel
+  // pipelines, so this must be called on all the processes of the global
+  // controller together.
+  void Prefetch(int count);
+
+//BTX
+  // Description:
+  // Interface of the caches that register their entries with the keeper.
+  class Cache
+    {
+  public:
+    virtual ~Cache() {}
+    // Drop the entry, which the keeper already forgot.
+    virtual void EvictCacheEntry(double key)=0;
+    // Cache up to count entries ahead of the current one.
+    virtual void PrefetchCacheEntries(int count)=0;
+    };
+
+  // Description:
+  // Register/unregister a cache. Unregistering forgets all its entries.
+  void RegisterCache(Cache*);
+  void UnregisterCache(Cache*);
+
+  // Description:
+  // Report a new entry of kbytes for the cache. When the entry does not
+  // fit, other entries are evicted if allowEviction is set. Returns false
+  // if the entry should not be kept.
+  bool AddCacheEntry(Cache*, double key, unsigned long kbytes,
+    bool allowEviction=true);
+
+  // Description:
+  // Report that an entry has been dropped by its cache.
+  void RemoveCacheEntry(Cache*, double key);
+
+  // Description:
+  // Report a lookup in a cache.
+  void RecordCacheHit(Cache*, double key);
+  void RecordCacheMiss();
+//ETX
+
+  // Description:
+  // Combine value over the processes of the global controller with the
+  // given vtkCommunicator operation (e.g. vtkCommunicator::MIN_OP), so that
+  // all processes take the same decision. Returns value on one process.
+  static unsigned long AllReduce(unsigned long value, int operation);
+
 protected:
   vtkCacheSizeKeeper();
   ~vtkCacheSizeKeeper();
 
   unsigned long CacheSize;
   int CacheFull;
+  unsigned long CacheLimit;
+  int EvictionPolicy;
+  unsigned long CacheHits;
+  unsigned long CacheMisses;
+  unsigned long CacheEvictions;
+
 private:
   vtkCacheSizeKeeper(const vtkCacheSizeKeeper&); // Not implemented.
   void operator=(const vtkCacheSizeKeeper&); // Not implemented.
+
+//BTX
+  class vtkInternals;
+  vtkInternals* Internals;
+//ETX
 };
 
 #endif
-
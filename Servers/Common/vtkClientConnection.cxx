@@ -28,8 +28,11 @@
 #include "vtkUndoSet.h"
 #include "vtkUndoStack.h"
 
+#include "vtk_zlib.h"
+
 #include <vtkstd/new>
 #include <vtkstd/string>
+#include <vtkstd/vector>
 
 //-----------------------------------------------------------------------------
 // RMI Callbacks.
@@ -96,6 +99,126 @@ void vtkClientConnectionRootRMI(void *vtkNotUsed(localArg), void *remoteArg,
     }
 }
 
+//-----------------------------------------------------------------------------
+static size_t vtkClientConnectionReadLength(const unsigned char* msg)
+{
+  return static_cast<size_t>(msg[0]) |
+    (static_cast<size_t>(msg[1]) << 8) |
+    (static_cast<size_t>(msg[2]) << 16) |
+    (static_cast<size_t>(msg[3]) << 24);
+}
+
+//-----------------------------------------------------------------------------
+// Processes a batch of streams sent by vtkServerConnection::Flush on the
+// given servers. A batch holds each stream preceded by its length as 4
+// little-endian bytes. A compressed batch is the uncompressed length as 4
+// little-endian bytes followed by the zlib data. Each stream is processed
+// on its own so that an error in one does not drop the streams after it.
+static void vtkClientConnectionProcessBatch(void* remoteArg,
+  int remoteArgLength, bool compressed, vtkTypeUInt32 servers)
+{
+  vtkProcessModule* pm = vtkProcessModule::GetProcessModule();
+  const unsigned char* batch =
+    reinterpret_cast<const unsigned char*>(remoteArg);
+  size_t batchLength = static_cast<size_t>(remoteArgLength);
+  size_t pos = 0;
+  try
+    {
+    vtkstd::vector<unsigned char> inflated;
+    if (compressed)
+      {
+      uLongf length = 0;
+      if (batchLength >= 4)
+        {
+        length = static_cast<uLongf>(vtkClientConnectionReadLength(batch));
+        inflated.resize(length);
+        }
+      if (length == 0 || uncompress(&inflated[0], &length, batch + 4,
+          static_cast<uLong>(batchLength - 4)) != Z_OK)
+        {
+        vtkGenericWarningMacro("Failed to uncompress streams from client.");
+        return;
+        }
+      batch = &inflated[0];
+      batchLength = static_cast<size_t>(length);
+      }
+
+    vtkClientServerStream stream;
+    while (pos + 4 <= batchLength)
+      {
+      size_t length = vtkClientConnectionReadLength(batch + pos);
+      pos += 4;
+      if (length > batchLength - pos)
+        {
+        break;
+        }
+      stream.SetData(batch + pos, length);
+      pos += length;
+      try
+        {
+        pm->SendStream(
+          vtkProcessModuleConnectionManager::GetSelfConnectionID(),
+          servers, stream);
+        }
+      catch (vtkstd::bad_alloc)
+        {
+        pm->ExceptionEvent(vtkProcessModule::EXCEPTION_BAD_ALLOC);
+        }
+      catch (...)
+        {
+        pm->ExceptionEvent(vtkProcessModule::EXCEPTION_UNKNOWN);
+        }
+      }
+    if (pos != batchLength)
+      {
+      vtkGenericWarningMacro("Truncated batch of streams from client.");
+      }
+    }
+  catch (vtkstd::bad_alloc)
+    {
+    pm->ExceptionEvent(vtkProcessModule::EXCEPTION_BAD_ALLOC);
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Called when requesting to process a batch of streams on Server (root and
+// satellites).
+void vtkClientConnectionBatchRMI(void *vtkNotUsed(localArg),
+  void *remoteArg, int remoteArgLength, int vtkNotUsed(remoteProcessId))
+{
+  vtkClientConnectionProcessBatch(remoteArg, remoteArgLength, false,
+    vtkProcessModule::DATA_SERVER);
+}
+
+//-----------------------------------------------------------------------------
+// Called when requesting to process a batch of streams on Root Node only.
+void vtkClientConnectionBatchRootRMI(void *vtkNotUsed(localArg),
+  void *remoteArg, int remoteArgLength, int vtkNotUsed(remoteProcessId))
+{
+  vtkClientConnectionProcessBatch(remoteArg, remoteArgLength, false,
+    vtkProcessModule::DATA_SERVER_ROOT);
+}
+
+//-----------------------------------------------------------------------------
+// Called when requesting to process a compressed batch of streams on Server
+// (root and satellites).
+void vtkClientConnectionCompressedRMI(void *vtkNotUsed(localArg),
+  void *remoteArg, int remoteArgLength, int vtkNotUsed(remoteProcessId))
+{
+  vtkClientConnectionProcessBatch(remoteArg, remoteArgLength, true,
+    vtkProcessModule::DATA_SERVER);
+}
+
+//-----------------------------------------------------------------------------
+// Called when requesting to process a compressed batch of streams on Root
+// Node only.
+void vtkClientConnectionCompressedRootRMI(void *vtkNotUsed(localArg),
+  void *remoteArg, int remoteArgLength, int vtkNotUsed(remoteProcessId))
+{
+  vtkClientConnectionProcessBatch(remoteArg, remoteArgLength, true,
+    vtkProcessModule::DATA_SERVER_ROOT);
+}
+
 //-----------------------------------------------------------------------------
 // Called on client is requesting Information from this server.
 void vtkClientConnectionGatherInformationRMI(void *localArg, 
@@ -337,6 +460,23 @@ void vtkClientConnection::SetupRMIs()
     (void *)(this),
     vtkRemoteConnection::CLIENT_SERVER_ROOT_RMI_TAG);
 
+  // for batches of streams and batches compressed by the client
+  this->Controller->AddRMI(vtkClientConnectionBatchRMI,
+    (void *)(this),
+    vtkRemoteConnection::CLIENT_SERVER_BATCH_RMI_TAG);
+
+  this->Controller->AddRMI(vtkClientConnectionBatchRootRMI,
+    (void *)(this),
+    vtkRemoteConnection::CLIENT_SERVER_BATCH_ROOT_RMI_TAG);
+
+  this->Controller->AddRMI(vtkClientConnectionCompressedRMI,
+    (void *)(this),
+    vtkRemoteConnection::CLIENT_SERVER_COMPRESSED_RMI_TAG);
+
+  this->Controller->AddRMI(vtkClientConnectionCompressedRootRMI,
+    (void *)(this),
+    vtkRemoteConnection::CLIENT_SERVER_COMPRESSED_ROOT_RMI_TAG);
+
   this->Controller->AddRMI(vtkClientConnectionGatherInformationRMI,
     (void*)(this),
     vtkRemoteConnection::CLIENT_SERVER_GATHER_INFORMATION_RMI_TAG);
@@ -25,6 +25,10 @@ vtkCxxRevisionMacro(vtkPVCacheSizeInformation, "$Revision$");
 vtkPVCacheSizeInformation::vtkPVCacheSizeInformation()
 {
   this->CacheSize = 0;
+  this->CacheLimit = 0;
+  this->CacheHits = 0;
+  this->CacheMisses = 0;
+  this->CacheEvictions = 0;
 }
 
 //-----------------------------------------------------------------------------
@@ -48,6 +52,10 @@ void vtkPVCacheSizeInformation::CopyFromObject(vtkObject* obj)
     return;
     }
   this->CacheSize = csk->GetCacheSize();
+  this->CacheLimit = csk->GetCacheLimit();
+  this->CacheHits = csk->GetCacheHits();
+  this->CacheMisses = csk->GetCacheMisses();
+  this->CacheEvictions = csk->GetCacheEvictions();
 }
 
 //-----------------------------------------------------------------------------
@@ -56,6 +64,10 @@ void vtkPVCacheSizeInformation::CopyToStream(vtkClientServerStream* stream)
   stream->Reset();
   *stream << vtkClientServerStream::Reply
     << this->CacheSize
+    << this->CacheLimit
+    << this->CacheHits
+    << this->CacheMisses
+    << this->CacheEvictions
     << vtkClientServerStream::End;
 }
 
@@ -67,6 +79,13 @@ void vtkPVCacheSizeInformation::CopyFromStream(const vtkClientServerStream* stre
     {
     vtkErrorMacro("Error parsing CacheSize.");
     }
+  if (!stream->GetArgument(0,1, &this->CacheLimit) ||
+    !stream->GetArgument(0,2, &this->CacheHits) ||
+    !stream->GetArgument(0,3, &this->CacheMisses) ||
+    !stream->GetArgument(0,4, &this->CacheEvictions))
+    {
+    vtkErrorMacro("Error parsing cache statistics.");
+    }
 }
 
 //-----------------------------------------------------------------------------
@@ -80,6 +99,11 @@ void vtkPVCacheSizeInformation::AddInformation(vtkPVInformation* info)
     }
   this->CacheSize = (cinfo->CacheSize > this->CacheSize)?
     cinfo->CacheSize : this->CacheSize;
+  this->CacheLimit = (cinfo->CacheLimit > this->CacheLimit)?
+    cinfo->CacheLimit : this->CacheLimit;
+  this->CacheHits += cinfo->CacheHits;
+  this->CacheMisses += cinfo->CacheMisses;
+  this->CacheEvictions += cinfo->CacheEvictions;
 }
 
 
@@ -88,4 +112,8 @@ void vtkPVCacheSizeInformation::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os, indent);
   os << indent << "CacheSize: " << this->CacheSize << endl;
+  os << indent << "CacheLimit: " << this->CacheLimit << endl;
+  os << indent << "CacheHits: " << this->CacheHits << endl;
+  os << indent << "CacheMisses: " << this->CacheMisses << endl;
+  os << indent << "CacheEvictions: " << this->CacheEvictions << endl;
 }
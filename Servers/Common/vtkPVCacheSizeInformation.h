@@ -16,6 +16,8 @@
 // collect cache size information from a vtkCacheSizeKeeper.
 // .SECTION Description
 // Gather information about cache size from vtkCacheSizeKeeper.
+// CacheSize and CacheLimit are the largest over the processes, the
+// statistics are summed.
 
 #ifndef __vtkPVCacheSizeInformation_h
 #define __vtkPVCacheSizeInformation_h
@@ -46,11 +48,25 @@ public:
 
   vtkGetMacro(CacheSize, unsigned long);
   vtkSetMacro(CacheSize, unsigned long);
+
+  // Description:
+  // Memory budget of the caches, see vtkCacheSizeKeeper::SetCacheLimit().
+  vtkGetMacro(CacheLimit, unsigned long);
+
+  // Description:
+  // Cache hits, misses and evictions, see vtkCacheSizeKeeper.
+  vtkGetMacro(CacheHits, unsigned long);
+  vtkGetMacro(CacheMisses, unsigned long);
+  vtkGetMacro(CacheEvictions, unsigned long);
 protected:
   vtkPVCacheSizeInformation();
   ~vtkPVCacheSizeInformation();
 
   unsigned long CacheSize;
+  unsigned long CacheLimit;
+  unsigned long CacheHits;
+  unsigned long CacheMisses;
+  unsigned long CacheEvictions;
 private:
   vtkPVCacheSizeInformation(const vtkPVCacheSizeInformation&); // Not implemented.
   void operator=(const vtkPVCacheSizeInformation&); // Not implemented.
@@ -77,6 +77,7 @@ vtkPVOptions::vtkPVOptions()
   this->DisableComposite = 0;
   this->ConnectID = 0;
   this->LogFileName = 0;
+  this->TimerTraceFileName = 0;
   this->StereoType = 0;
   this->SetStereoType("Red-Blue");
 
@@ -105,6 +106,7 @@ vtkPVOptions::~vtkPVOptions()
   this->SetMachinesFileName(0);
   this->SetStateFileName(0);
   this->SetLogFileName(0);
+  this->SetTimerTraceFileName(0);
   this->SetStereoType(0);
 }
 
@@ -115,6 +117,12 @@ void vtkPVOptions::Initialize()
                     "ClientServerStream log file.",
                     vtkPVOptions::ALLPROCESS);
 
+  this->AddArgument("--timer-trace", 0, &this->TimerTraceFileName,
+                    "Gather the timer logs of all server processes on exit "
+                    "and write them to the given file as a Chrome trace.",
+                    vtkPVOptions::PVSERVER | vtkPVOptions::PVDATA_SERVER |
+                    vtkPVOptions::PVRENDER_SERVER | vtkPVOptions::PVBATCH);
+
   this->AddArgument("--data", 0, &this->ParaViewDataName,
                     "Load the specified data. "
                     "To specify file series replace the numeral with a '.' eg. "
@@ -431,5 +439,8 @@ void vtkPVOptions::PrintSelf(ostream& os, vtkIndent indent)
     << (this->StateFileName?this->StateFileName:"(none)") << endl;
   os << indent << "LogFileName: "
     << (this->LogFileName? this->LogFileName : "(none)") << endl; 
+  os << indent << "TimerTraceFileName: "
+    << (this->TimerTraceFileName? this->TimerTraceFileName : "(none)")
+    << endl;
 
 }
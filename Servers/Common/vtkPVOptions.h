@@ -106,6 +106,12 @@ public:
   vtkSetStringMacro(LogFileName);
   vtkGetStringMacro(LogFileName);
 
+  // Description:
+  // File to which the timer logs of all server processes are written as a
+  // Chrome trace when the process module is finalized.
+  vtkSetStringMacro(TimerTraceFileName);
+  vtkGetStringMacro(TimerTraceFileName);
+
   // Description:
   // vtkPVProcessModule needs to set this.
   vtkSetVector2Macro(TileDimensions, int);
@@ -216,6 +222,7 @@ private:
   char* GroupFileName;
 
   char* LogFileName;
+  char* TimerTraceFileName;
   int TellVersion;
 
   vtkSetStringMacro(StereoType);
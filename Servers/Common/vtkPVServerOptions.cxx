@@ -26,6 +26,7 @@ vtkCxxRevisionMacro(vtkPVServerOptions, "$Revision$");
 vtkPVServerOptions::vtkPVServerOptions()
 {
   this->Internals = new vtkPVServerOptionsInternals;
+  this->CacheMemoryLimit = 0;
 }
 
 //----------------------------------------------------------------------------
@@ -38,6 +39,11 @@ vtkPVServerOptions::~vtkPVServerOptions()
 void vtkPVServerOptions::Initialize()
 {
   this->Superclass::Initialize();
+  this->AddArgument("--cache-memory-limit", 0, &this->CacheMemoryLimit,
+    "Memory (in KiB) each server process may use to cache animation time "
+    "steps. Least recently used time steps are evicted beyond this limit.",
+    vtkPVOptions::PVRENDER_SERVER|vtkPVOptions::PVDATA_SERVER|
+    vtkPVOptions::PVSERVER);
 }
 
 //----------------------------------------------------------------------------
@@ -174,6 +180,7 @@ double* vtkPVServerOptions::GetUpperLeft(unsigned int idx)
 void vtkPVServerOptions::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os, indent);
+  os << indent << "CacheMemoryLimit: " << this->CacheMemoryLimit << endl;
   this->Internals->PrintSelf(os, indent);
 }
 
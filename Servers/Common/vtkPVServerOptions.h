@@ -47,6 +47,12 @@ public:
   double* GetLowerRight(unsigned int idx);
   double* GetUpperLeft(unsigned int idx);
 
+  // Description:
+  // Memory budget (in kbytes) of the data caches on each server process,
+  // given with --cache-memory-limit. 0 (default) leaves the limit to the
+  // client's animation cache setting.
+  vtkGetMacro(CacheMemoryLimit, int);
+
 protected: 
   // Description:
   // Add machine information from the xml tag <Machine ....>
@@ -61,6 +67,8 @@ protected:
 
   virtual void Initialize();
 
+  int CacheMemoryLimit;
+
 private:
   vtkPVServerOptions(const vtkPVServerOptions&); // Not implemented
   void operator=(const vtkPVServerOptions&); // Not implemented
@@ -19,6 +19,7 @@
 #include "vtkByteSwap.h"
 #include "vtkTimerLog.h"
 #include "vtkProcessModule.h"
+#include "vtkProcessModuleConnectionManager.h"
 #include "vtkClientServerStream.h"
 #include "vtksys/ios/sstream"
 
@@ -133,15 +134,26 @@ void vtkPVTimerInformation::CopyFromObject(vtkObject* o)
     threshold = pm->GetLogThreshold();
     }
   
+  vtksys_ios::ostringstream fptr;
   length = vtkTimerLog::GetNumberOfEvents() * 40;
   if (length > 0)
     {
-    vtksys_ios::ostringstream fptr;
     //*fptr << "Hello world !!!\n ()";
     vtkTimerLog::DumpLogWithIndents(&fptr, threshold);
+    }
+
+  // On the client, also report the traffic to the server.
+  if (pm && pm->GetClientMode())
+    {
+    pm->DumpCommunicationLog(
+      vtkProcessModuleConnectionManager::GetRootServerConnectionID(), &fptr);
+    }
+
+  if (!fptr.str().empty())
+    {
     fptr << ends;
     this->InsertLog(0, fptr.str().c_str());
-    }  
+    }
 }
 
 //----------------------------------------------------------------------------
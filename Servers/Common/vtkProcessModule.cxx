@@ -242,6 +242,13 @@ vtkProcessModule::~vtkProcessModule()
 void vtkProcessModule::SetOptions(vtkPVOptions* op)
 {
   this->Options = op;
+
+  vtkPVServerOptions* serverOptions = vtkPVServerOptions::SafeDownCast(op);
+  if (serverOptions && serverOptions->GetCacheMemoryLimit() > 0)
+    {
+    this->CacheSizeKeeper->SetCacheLimit(
+      static_cast<unsigned long>(serverOptions->GetCacheMemoryLimit()));
+    }
 }
 
 //-----------------------------------------------------------------------------
@@ -898,6 +905,19 @@ int vtkProcessModule::SendStream(vtkIdType connectionID,
   return ret;
 }
 
+//-----------------------------------------------------------------------------
+void vtkProcessModule::FlushStreams(vtkIdType connectionID)
+{
+  this->ConnectionManager->Flush(connectionID);
+}
+
+//-----------------------------------------------------------------------------
+void vtkProcessModule::DumpCommunicationLog(vtkIdType connectionID,
+  ostream* os)
+{
+  this->ConnectionManager->DumpCommunicationLog(connectionID, os);
+}
+
 //-----------------------------------------------------------------------------
 void vtkProcessModule::Initialize()
 {
@@ -914,6 +934,12 @@ void vtkProcessModule::Finalize()
     // This will clean up the communicators.
     this->ConnectionManager->Finalize();
     }
+  // The satellites have left their RMI loop by now, so the timer logs can
+  // be gathered.
+  if (this->Options && this->Options->GetTimerTraceFileName())
+    {
+    this->DumpTimerTrace(this->Options->GetTimerTraceFileName());
+    }
   this->FinalizeInterpreter();
   this->InvokeEvent(vtkCommand::ExitEvent);
 }
@@ -1633,6 +1659,67 @@ void vtkProcessModule::SetLogThreshold(vtkIdType connectionID,
   this->SendStream(connectionID, servers, stream);
 }
 
+//----------------------------------------------------------------------------
+void vtkProcessModule::DumpTimerTrace(const char* filename)
+{
+  vtkMultiProcessController* controller = this->GetController();
+  int numProcs = controller? controller->GetNumberOfProcesses() : 1;
+  int myId = controller? controller->GetLocalProcessId() : 0;
+
+  vtksys_ios::ostringstream events;
+  vtkTimerLog::DumpTraceEvents(&events, myId);
+  vtkstd::string localEvents = events.str();
+
+  // Gather the events of every process on the root.
+  vtkstd::vector<vtkStdString> allEvents;
+  if (numProcs > 1)
+    {
+    vtkIdType length = static_cast<vtkIdType>(localEvents.size());
+    vtkstd::vector<vtkIdType> lengths(numProcs, 0);
+    vtkstd::vector<vtkIdType> offsets(numProcs, 0);
+    controller->Gather(&length, &lengths[0], 1, 0);
+    vtkIdType total = 0;
+    for (int i = 0; i < numProcs; ++i)
+      {
+      offsets[i] = total;
+      total += lengths[i];
+      }
+    vtkstd::vector<char> buffer(total + 1);
+    controller->GatherV(localEvents.c_str(), &buffer[0], length,
+                        &lengths[0], &offsets[0], 0);
+    if (myId != 0)
+      {
+      return;
+      }
+    for (int i = 0; i < numProcs; ++i)
+      {
+      allEvents.push_back(vtkStdString(&buffer[offsets[i]], lengths[i]));
+      }
+    }
+  else
+    {
+    allEvents.push_back(localEvents);
+    }
+
+  ofstream trace(filename);
+  if (!trace)
+    {
+    vtkErrorMacro("Could not open timer trace file " << filename);
+    return;
+    }
+  trace << "{\"traceEvents\":[\n";
+  const char* separator = "";
+  for (size_t i = 0; i < allEvents.size(); ++i)
+    {
+    if (!allEvents[i].empty())
+      {
+      trace << separator << allEvents[i];
+      separator = ",\n";
+      }
+    }
+  trace << "\n]}\n";
+}
+
 //============================================================================
 // Stuff that is a part of render-process module.
 //-----------------------------------------------------------------------------
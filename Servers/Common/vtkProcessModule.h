@@ -212,6 +212,19 @@ public:
   int SendStream(vtkIdType connectionID, vtkTypeUInt32 server, 
     vtkClientServerStream& stream, int resetStream=1);
 
+  // Description:
+  // Remote server connections may hold back the streams sent to them to
+  // send them in batches. This sends the streams held back by the given
+  // connection, if any. Streams are always sent before the client waits
+  // for a reply from the server, so this is only needed to have the
+  // server start working on them early.
+  void FlushStreams(vtkIdType connectionID);
+
+  // Description:
+  // Print the communication statistics kept by the given connection, if
+  // any.
+  void DumpCommunicationLog(vtkIdType connectionID, ostream* os);
+
   // Description:
   // Get the interpreter used on the local process.
   vtkGetObjectMacro(Interpreter, vtkClientServerInterpreter);
@@ -356,6 +369,13 @@ public:
                        double threshold);
   vtkGetMacro(LogThreshold, double);
 
+  // Description:
+  // Gather the timer logs of all the processes of the controller on the
+  // root and write them to filename as a Chrome trace, one trace process
+  // per partition.  This must be called on all the processes.  Finalize()
+  // calls it when the --timer-trace option is given.
+  void DumpTimerTrace(const char* filename);
+
   // Description:
   // We need to get the data path for the demo on the server.
   const char* GetPath(const char* tag, const char* relativePath, const char* file);
@@ -127,6 +127,18 @@ public:
   // OBSOLETE: Will be deprecated soon.
   virtual vtkPVXMLElement* NewNextRedo(){return 0;}
 
+  // Description:
+  // Send any streams the connection is holding back. Default
+  // implementation does nothing.
+  virtual void Flush() {}
+
+//BTX
+  // Description:
+  // Print statistics about the communication over this connection, if
+  // the connection keeps any. Default implementation does nothing.
+  virtual void DumpCommunicationLog(ostream* vtkNotUsed(os)) {}
+//ETX
+
   // Description:
   // Get the progress handler for this connection.
   vtkGetObjectMacro(ProgressHandler, vtkPVProgressHandler);
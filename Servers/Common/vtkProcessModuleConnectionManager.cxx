@@ -579,6 +579,27 @@ const vtkClientServerStream& vtkProcessModuleConnectionManager::GetLastResult(
   return s;
 }
 
+//-----------------------------------------------------------------------------
+void vtkProcessModuleConnectionManager::Flush(vtkIdType connectionID)
+{
+  vtkProcessModuleConnection* conn = this->GetConnectionFromID(connectionID);
+  if (conn)
+    {
+    conn->Flush();
+    }
+}
+
+//-----------------------------------------------------------------------------
+void vtkProcessModuleConnectionManager::DumpCommunicationLog(
+  vtkIdType connectionID, ostream* os)
+{
+  vtkProcessModuleConnection* conn = this->GetConnectionFromID(connectionID);
+  if (conn)
+    {
+    conn->DumpCommunicationLog(os);
+    }
+}
+
 //-----------------------------------------------------------------------------
 int vtkProcessModuleConnectionManager::LoadModule(vtkIdType connectionID, 
   const char* name, const char* dir)
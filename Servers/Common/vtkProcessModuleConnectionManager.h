@@ -276,6 +276,14 @@ public:
   virtual const vtkClientServerStream& GetLastResult(
     vtkIdType connectionID, vtkTypeUInt32 server);
 
+  // Description:
+  // Send the streams held back by the connection, if any.
+  void Flush(vtkIdType connectionID);
+
+  // Description:
+  // Print the communication statistics kept by the connection, if any.
+  void DumpCommunicationLog(vtkIdType connectionID, ostream* os);
+
   // Description:
   // Called by ProcessModule to load a module.
   int LoadModule(vtkIdType connectionID, const char* name, const char* dir);
@@ -40,6 +40,10 @@ public:
     CLIENT_SERVER_LAST_RESULT_TAG = 838490,
     CLIENT_SERVER_GATHER_INFORMATION_RMI_TAG = 838491,
     CLIENT_SERVER_PUSH_UNDO_XML_TAG = 838494,
+    CLIENT_SERVER_COMPRESSED_RMI_TAG = 938533,
+    CLIENT_SERVER_COMPRESSED_ROOT_RMI_TAG = 938534,
+    CLIENT_SERVER_BATCH_RMI_TAG = 938535,
+    CLIENT_SERVER_BATCH_ROOT_RMI_TAG = 938536,
 
     CLIENT_SERVER_COMMUNICATION_TAG = 8843,
     ROOT_INFORMATION_LENGTH_TAG = 838492,
@@ -30,9 +30,37 @@
 #include "vtkSocketController.h"
 #include "vtkSocketCommunicator.h"
 
+#include "vtk_zlib.h"
+
+#include <vtkstd/vector>
 #include <vtksys/ios/sstream>
 #include <vtksys/SystemTools.hxx>
 
+//-----------------------------------------------------------------------------
+// Streams waiting to be sent with the same RMI on the same controller. Data
+// holds each stream, byte order mark included, preceded by its length as 4
+// little-endian bytes so that the server can process the streams one by one.
+class vtkServerConnection::vtkStreamBatch
+{
+public:
+  vtkStreamBatch() : Controller(0), Tag(0), NumberOfStreams(0) {}
+
+  vtkSocketController* Controller;
+  int Tag;
+  int NumberOfStreams;
+  vtkstd::vector<unsigned char> Data;
+};
+
+//-----------------------------------------------------------------------------
+static void vtkServerConnectionAppendLength(vtkstd::vector<unsigned char>& v,
+  size_t len)
+{
+  v.push_back(static_cast<unsigned char>(len & 0xff));
+  v.push_back(static_cast<unsigned char>((len >> 8) & 0xff));
+  v.push_back(static_cast<unsigned char>((len >> 16) & 0xff));
+  v.push_back(static_cast<unsigned char>((len >> 24) & 0xff));
+}
+
 
 vtkStandardNewMacro(vtkServerConnection);
 vtkCxxRevisionMacro(vtkServerConnection, "$Revision$");
@@ -44,7 +72,13 @@ vtkServerConnection::vtkServerConnection()
   this->MPIMToNSocketConnectionID.ID = 0;
   this->ServerInformation = vtkPVServerInformation::New();
   this->LastResultStream = new vtkClientServerStream;
+  this->Batch = new vtkStreamBatch;
 
+  this->BatchStreams = 1;
+  this->MaximumBatchSize = 1048576;
+  this->CompressionLevel = 0;
+  this->CompressionThreshold = 4096;
+  this->ResetCommunicationStatistics();
 }
 
 //-----------------------------------------------------------------------------
@@ -57,6 +91,7 @@ vtkServerConnection::~vtkServerConnection()
     }
   this->ServerInformation->Delete();
   delete this->LastResultStream;
+  delete this->Batch;
 }
 
 //-----------------------------------------------------------------------------
@@ -81,6 +116,7 @@ void vtkServerConnection::Finalize()
       vtkProcessModule::RENDER_SERVER, stream);
     this->MPIMToNSocketConnectionID.ID = 0;
     }
+  this->Flush();
   
   if (this->RenderServerSocketController)
     {
@@ -182,6 +218,9 @@ int vtkServerConnection::SendStreamToClient(vtkClientServerStream& stream)
   // (i.e. separate Interpreters for each connection). Here, we will use
   // the self connection  for this remote connection.
   // For now, we simply use the common self connection.
+  // The stream may depend on what was sent to the server so far (e.g. a
+  // render), send the pending batch first.
+  this->Flush();
   this->Activate();
   vtkProcessModule* pm = vtkProcessModule::GetProcessModule();
   int ret = pm->SendStream(
@@ -195,24 +234,143 @@ int vtkServerConnection::SendStreamToClient(vtkClientServerStream& stream)
 int vtkServerConnection::SendStreamToServer(vtkSocketController* controller,
   vtkClientServerStream& stream)
 {
-  const unsigned char* data;
-  size_t len;
-  stream.GetData(&data, &len);
-  controller->TriggerRMI(1, (void*)data, static_cast<int>(len), 
-    vtkRemoteConnection::CLIENT_SERVER_RMI_TAG);
+  this->QueueStream(controller, vtkRemoteConnection::CLIENT_SERVER_RMI_TAG,
+    stream);
   return 0;
 }
 
 //-----------------------------------------------------------------------------
 int vtkServerConnection::SendStreamToRoot(vtkSocketController* controller,
   vtkClientServerStream& stream)
+{
+  this->QueueStream(controller,
+    vtkRemoteConnection::CLIENT_SERVER_ROOT_RMI_TAG, stream);
+  return 0;
+}
+
+//-----------------------------------------------------------------------------
+void vtkServerConnection::QueueStream(vtkSocketController* controller,
+  int tag, vtkClientServerStream& stream)
 {
   const unsigned char* data;
   size_t len;
-  stream.GetData(&data, &len);
-  controller->TriggerRMI(1, (void*)data, static_cast<int>(len), 
-    vtkRemoteConnection::CLIENT_SERVER_ROOT_RMI_TAG);
-  return 0;
+  if (!stream.GetData(&data, &len) || len == 0)
+    {
+    return;
+    }
+
+  // Streams are processed in the order they were sent, so a batch can only
+  // grow while the streams go to the same place.
+  if (this->Batch->Controller != controller || this->Batch->Tag != tag)
+    {
+    this->Flush();
+    this->Batch->Controller = controller;
+    this->Batch->Tag = tag;
+    }
+
+  vtkstd::vector<unsigned char>& batch = this->Batch->Data;
+  vtkServerConnectionAppendLength(batch, len);
+  batch.insert(batch.end(), data, data + len);
+  this->Batch->NumberOfStreams++;
+  this->NumberOfStreams++;
+  this->NumberOfBytes += static_cast<vtkTypeInt64>(len);
+
+  if (!this->BatchStreams ||
+    batch.size() >= static_cast<size_t>(this->MaximumBatchSize))
+    {
+    this->Flush();
+    }
+}
+
+//-----------------------------------------------------------------------------
+void vtkServerConnection::Flush()
+{
+  vtkstd::vector<unsigned char>& batch = this->Batch->Data;
+  if (batch.empty())
+    {
+    return;
+    }
+  if (this->AbortConnection || !this->Batch->Controller)
+    {
+    batch.clear();
+    this->Batch->NumberOfStreams = 0;
+    return;
+    }
+
+  const unsigned char* data = &batch[0];
+  size_t len = batch.size();
+  int tag = this->Batch->Tag;
+  bool root = (tag == vtkRemoteConnection::CLIENT_SERVER_ROOT_RMI_TAG);
+  if (this->Batch->NumberOfStreams > 1)
+    {
+    tag = root? vtkRemoteConnection::CLIENT_SERVER_BATCH_ROOT_RMI_TAG :
+      vtkRemoteConnection::CLIENT_SERVER_BATCH_RMI_TAG;
+    }
+  else
+    {
+    // A single stream is sent as is, without its length.
+    data += 4;
+    len -= 4;
+    }
+
+  vtkstd::vector<unsigned char> compressed;
+  if (this->CompressionLevel > 0 &&
+    batch.size() >= static_cast<size_t>(this->CompressionThreshold))
+    {
+    // Compressed messages always hold a batch, even of one stream. Prefix
+    // the zlib data with the uncompressed length, little-endian.
+    uLong batchLength = static_cast<uLong>(batch.size());
+    uLongf compressedLength = compressBound(batchLength);
+    compressed.reserve(4 + compressedLength);
+    vtkServerConnectionAppendLength(compressed, batch.size());
+    compressed.resize(4 + compressedLength);
+    if (compress2(&compressed[4], &compressedLength, &batch[0], batchLength,
+        this->CompressionLevel) == Z_OK &&
+      4 + compressedLength < len)
+      {
+      data = &compressed[0];
+      len = 4 + compressedLength;
+      tag = root? vtkRemoteConnection::CLIENT_SERVER_COMPRESSED_ROOT_RMI_TAG :
+        vtkRemoteConnection::CLIENT_SERVER_COMPRESSED_RMI_TAG;
+      }
+    }
+
+  this->Batch->Controller->TriggerRMI(1, (void*)data, static_cast<int>(len),
+    tag);
+  this->NumberOfMessages++;
+  this->NumberOfBytesSent += static_cast<vtkTypeInt64>(len);
+
+  if (batch.capacity() > static_cast<size_t>(this->MaximumBatchSize))
+    {
+    // Don't hold on to the memory used by an unusually large stream.
+    vtkstd::vector<unsigned char>().swap(batch);
+    }
+  else
+    {
+    batch.clear();
+    }
+  this->Batch->NumberOfStreams = 0;
+}
+
+//-----------------------------------------------------------------------------
+void vtkServerConnection::ResetCommunicationStatistics()
+{
+  this->NumberOfStreams = 0;
+  this->NumberOfBytes = 0;
+  this->NumberOfMessages = 0;
+  this->NumberOfBytesSent = 0;
+  this->NumberOfRoundTrips = 0;
+}
+
+//-----------------------------------------------------------------------------
+void vtkServerConnection::DumpCommunicationLog(ostream* os)
+{
+  *os << "Client/Server Communication" << endl;
+  *os << "    Streams: " << this->NumberOfStreams
+    << " (" << this->NumberOfBytes << " bytes)" << endl;
+  *os << "    Messages: " << this->NumberOfMessages
+    << " (" << this->NumberOfBytesSent << " bytes)" << endl;
+  *os << "    Round Trips: " << this->NumberOfRoundTrips << endl;
 }
 
 //-----------------------------------------------------------------------------
@@ -257,6 +415,8 @@ const vtkClientServerStream& vtkServerConnection::GetLastResultInternal(
     return *this->LastResultStream;
     }
 
+  this->Flush();
+  this->NumberOfRoundTrips++;
   int length =0;
   controller->TriggerRMI(1, "", 
     vtkRemoteConnection::CLIENT_SERVER_LAST_RESULT_TAG);
@@ -327,6 +487,9 @@ void vtkServerConnection::GatherInformation(vtkTypeUInt32 serverFlags,
 void vtkServerConnection::GatherInformationFromController(vtkSocketController* controller,
   vtkPVInformation* info, vtkClientServerID id)
 {
+  this->Flush();
+  this->NumberOfRoundTrips++;
+
   vtkClientServerStream stream;
   stream << vtkClientServerStream::Assign // dummy command.
     << info->GetClassName()
@@ -664,6 +827,7 @@ void vtkServerConnection::PushUndo(const char* label, vtkPVXMLElement* uelem)
     << vtkClientServerStream::End;
 
   // Send the string to server.
+  this->Flush();
   vtkSocketController* controller = this->GetSocketController();
   const unsigned char* data;
   size_t len;
@@ -676,6 +840,8 @@ void vtkServerConnection::PushUndo(const char* label, vtkPVXMLElement* uelem)
 //-----------------------------------------------------------------------------
 vtkPVXMLElement* vtkServerConnection::NewNextUndo()
 {
+  this->Flush();
+  this->NumberOfRoundTrips++;
   vtkSocketController* controller = this->GetSocketController();
   controller->TriggerRMI(1, NULL, 0, vtkRemoteConnection::UNDO_XML_TAG);
   int length;
@@ -720,6 +886,8 @@ vtkPVXMLElement* vtkServerConnection::NewNextUndo()
 //-----------------------------------------------------------------------------
 vtkPVXMLElement* vtkServerConnection::NewNextRedo()
 {
+  this->Flush();
+  this->NumberOfRoundTrips++;
   vtkSocketController* controller = this->GetSocketController();
   controller->TriggerRMI(1, NULL, 0, vtkRemoteConnection::REDO_XML_TAG);
   int length;
@@ -767,6 +935,16 @@ void vtkServerConnection::PrintSelf(ostream& os, vtkIndent indent)
   this->Superclass::PrintSelf(os, indent);
   os << indent << "MPIMToNSocketConnectionID: " 
     << this->MPIMToNSocketConnectionID << endl;
+  os << indent << "BatchStreams: " << this->BatchStreams << endl;
+  os << indent << "MaximumBatchSize: " << this->MaximumBatchSize << endl;
+  os << indent << "CompressionLevel: " << this->CompressionLevel << endl;
+  os << indent << "CompressionThreshold: " << this->CompressionThreshold
+    << endl;
+  os << indent << "NumberOfStreams: " << this->NumberOfStreams << endl;
+  os << indent << "NumberOfBytes: " << this->NumberOfBytes << endl;
+  os << indent << "NumberOfMessages: " << this->NumberOfMessages << endl;
+  os << indent << "NumberOfBytesSent: " << this->NumberOfBytesSent << endl;
+  os << indent << "NumberOfRoundTrips: " << this->NumberOfRoundTrips << endl;
 
   os << indent << "ServerInformation: ";
   if (this->ServerInformation)
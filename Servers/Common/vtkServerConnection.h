@@ -99,6 +99,55 @@ public:
   // \returns NULL on failure, otherwise the XML element is returned.
   virtual vtkPVXMLElement* NewNextRedo();
 
+  // Description:
+  // When BatchStreams is on (the default), streams sent to the servers are
+  // not sent right away. They are appended to a pending batch that is sent
+  // as a single message when the client next needs a reply from the server
+  // (GetLastResult, GatherInformation, undo/redo), before any stream is
+  // processed on the client (e.g. render), when the batch is destined for a
+  // different server or when it grows past MaximumBatchSize bytes. The
+  // server still processes the streams of a batch one by one, in order.
+  vtkSetMacro(BatchStreams, int);
+  vtkGetMacro(BatchStreams, int);
+  vtkBooleanMacro(BatchStreams, int);
+
+  // Description:
+  // Size in bytes above which the pending batch is sent immediately.
+  vtkSetClampMacro(MaximumBatchSize, int, 0, VTK_INT_MAX);
+  vtkGetMacro(MaximumBatchSize, int);
+
+  // Description:
+  // zlib compression level used for batches of at least
+  // CompressionThreshold bytes. 0 (the default) disables compression.
+  // Compression is only worthwhile over slow links.
+  vtkSetClampMacro(CompressionLevel, int, 0, 9);
+  vtkGetMacro(CompressionLevel, int);
+  vtkSetClampMacro(CompressionThreshold, int, 0, VTK_INT_MAX);
+  vtkGetMacro(CompressionThreshold, int);
+
+  // Description:
+  // Send the pending batch of streams, if any.
+  virtual void Flush();
+
+  // Description:
+  // Communication counters. NumberOfStreams is the number of streams sent
+  // to the servers and NumberOfBytes their size. NumberOfMessages is the
+  // number of messages they were sent in and NumberOfBytesSent the size
+  // of those messages after compression. NumberOfRoundTrips counts the
+  // requests for which the client waited for a reply.
+  vtkGetMacro(NumberOfStreams, vtkTypeInt64);
+  vtkGetMacro(NumberOfBytes, vtkTypeInt64);
+  vtkGetMacro(NumberOfMessages, vtkTypeInt64);
+  vtkGetMacro(NumberOfBytesSent, vtkTypeInt64);
+  vtkGetMacro(NumberOfRoundTrips, vtkTypeInt64);
+  void ResetCommunicationStatistics();
+
+//BTX
+  // Description:
+  // Print the communication counters.
+  virtual void DumpCommunicationLog(ostream* os);
+//ETX
+
 protected:
   vtkServerConnection();
   ~vtkServerConnection();
@@ -125,6 +174,12 @@ protected:
   int SendStreamToRoot(vtkSocketController* controller,
   vtkClientServerStream& stream);
 
+  // Description:
+  // Append the stream to the pending batch for the given controller and
+  // RMI tag, sending the batch when needed.
+  void QueueStream(vtkSocketController* controller, int tag,
+    vtkClientServerStream& stream);
+
   // Description:
   // Authenticates with the Server. Returns 1 on success, 0 on failure.
   int AuthenticateWithServer(vtkSocketController*);
@@ -160,10 +215,25 @@ protected:
 
   vtkPVServerInformation* ServerInformation;
   vtkClientServerStream* LastResultStream;
+
+  int BatchStreams;
+  int MaximumBatchSize;
+  int CompressionLevel;
+  int CompressionThreshold;
+
+  vtkTypeInt64 NumberOfStreams;
+  vtkTypeInt64 NumberOfBytes;
+  vtkTypeInt64 NumberOfMessages;
+  vtkTypeInt64 NumberOfBytesSent;
+  vtkTypeInt64 NumberOfRoundTrips;
 private:
   vtkServerConnection(const vtkServerConnection&); // Not implemented.
   void operator=(const vtkServerConnection&); // Not implemented.
 
+//BTX
+  class vtkStreamBatch;
+  vtkStreamBatch* Batch;
+//ETX
 };
 
 
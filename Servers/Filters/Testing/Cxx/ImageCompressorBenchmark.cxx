@@ -0,0 +1,228 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    $RCSfile$
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Measures the throughput and compression ratio of the image compressors
+// used for remote render delivery over a range of thread counts.
+//
+// Usage: ImageCompressorBenchmark [iterations] [framebuffer.png ...]
+//
+// Without files a synthetic 1920x1080 RGBA framebuffer is used. Recorded
+// framebuffers are read with vtkPNGReader and converted to opaque RGBA.
+
+#include "vtkImageData.h"
+#include "vtkMultiThreader.h"
+#include "vtkPNGReader.h"
+#include "vtkPointData.h"
+#include "vtkSmartPointer.h"
+#include "vtkSquirtCompressor.h"
+#include "vtkTimerLog.h"
+#include "vtkUnsignedCharArray.h"
+#include "vtkZlibImageCompressor.h"
+
+#include <vtkstd/vector>
+
+//-----------------------------------------------------------------------------
+// Flat background with a shaded disk, similar to a rendered surface.
+static void FillSyntheticFramebuffer(vtkUnsignedCharArray* image,
+  int width, int height)
+{
+  image->SetNumberOfComponents(4);
+  image->SetNumberOfTuples(width * height);
+  unsigned char* p = image->GetPointer(0);
+  for (int y = 0; y < height; ++y)
+    {
+    for (int x = 0; x < width; ++x, p += 4)
+      {
+      int dx = x - width / 2;
+      int dy = y - height / 2;
+      int r2 = dx * dx + dy * dy;
+      int radius = height / 3;
+      if (r2 < radius * radius)
+        {
+        unsigned char shade =
+          static_cast<unsigned char>(255 - (255 * r2) / (radius * radius));
+        p[0] = shade;
+        p[1] = static_cast<unsigned char>(shade / 2);
+        p[2] = static_cast<unsigned char>(64 + (x & 0x3f));
+        }
+      else
+        {
+        p[0] = 82;
+        p[1] = 87;
+        p[2] = 110;
+        }
+      p[3] = 255;
+      }
+    }
+}
+
+//-----------------------------------------------------------------------------
+static bool ReadFramebuffer(const char* fileName, vtkUnsignedCharArray* image)
+{
+  vtkSmartPointer<vtkPNGReader> reader = vtkSmartPointer<vtkPNGReader>::New();
+  if (!reader->CanReadFile(fileName))
+    {
+    cerr << "Cannot read " << fileName << endl;
+    return false;
+    }
+  reader->SetFileName(fileName);
+  reader->Update();
+  vtkUnsignedCharArray* scalars = vtkUnsignedCharArray::SafeDownCast(
+    reader->GetOutput()->GetPointData()->GetScalars());
+  if (!scalars || scalars->GetNumberOfComponents() < 3)
+    {
+    cerr << fileName << " is not an RGB(A) image." << endl;
+    return false;
+    }
+  vtkIdType numberOfPixels = scalars->GetNumberOfTuples();
+  int numberOfComponents = scalars->GetNumberOfComponents();
+  image->SetNumberOfComponents(4);
+  image->SetNumberOfTuples(numberOfPixels);
+  const unsigned char* in = scalars->GetPointer(0);
+  unsigned char* out = image->GetPointer(0);
+  for (vtkIdType cc = 0; cc < numberOfPixels; ++cc)
+    {
+    out[0] = in[0];
+    out[1] = in[1];
+    out[2] = in[2];
+    // Remote render delivery sends opaque framebuffers.
+    out[3] = 255;
+    in += numberOfComponents;
+    out += 4;
+    }
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+// Returns false when a loss-less round trip does not reproduce the image.
+static bool Benchmark(vtkTiledImageCompressor* compressor,
+  vtkUnsignedCharArray* image, int iterations, bool lossLess)
+{
+  vtkSmartPointer<vtkUnsignedCharArray> compressed =
+    vtkSmartPointer<vtkUnsignedCharArray>::New();
+  vtkSmartPointer<vtkUnsignedCharArray> decompressed =
+    vtkSmartPointer<vtkUnsignedCharArray>::New();
+  decompressed->SetNumberOfComponents(image->GetNumberOfComponents());
+  decompressed->SetNumberOfTuples(image->GetNumberOfTuples());
+
+  vtkSmartPointer<vtkTimerLog> timer = vtkSmartPointer<vtkTimerLog>::New();
+  double compressTime = 0.0;
+  double decompressTime = 0.0;
+  for (int i = 0; i < iterations; ++i)
+    {
+    compressor->SetInput(image);
+    compressor->SetOutput(compressed);
+    timer->StartTimer();
+    compressor->Compress();
+    timer->StopTimer();
+    compressTime += timer->GetElapsedTime();
+
+    compressor->SetInput(compressed);
+    compressor->SetOutput(decompressed);
+    timer->StartTimer();
+    int status = compressor->Decompress();
+    timer->StopTimer();
+    decompressTime += timer->GetElapsedTime();
+    if (status != VTK_OK)
+      {
+      cerr << "Decompression failed." << endl;
+      return false;
+      }
+    }
+  compressor->SetInput(0);
+  compressor->SetOutput(0);
+
+  double megaBytes =
+    iterations * image->GetNumberOfTuples() * 4 / (1024.0 * 1024.0);
+  cout << "  " << compressor->GetClassName()
+       << " threads=" << compressor->GetNumberOfThreads()
+       << " ratio=" << (image->GetNumberOfTuples() * 4.0) /
+          compressed->GetNumberOfTuples()
+       << " compress=" << megaBytes / compressTime << " MB/s"
+       << " decompress=" << megaBytes / decompressTime << " MB/s" << endl;
+
+  if (lossLess &&
+    memcmp(image->GetPointer(0), decompressed->GetPointer(0),
+      image->GetNumberOfTuples() * 4) != 0)
+    {
+    cerr << compressor->GetClassName() << " round trip changed the image."
+         << endl;
+    return false;
+    }
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+int main(int argc, char* argv[])
+{
+  int iterations = argc > 1 ? atoi(argv[1]) : 10;
+  if (iterations < 1)
+    {
+    iterations = 1;
+    }
+
+  vtkstd::vector<vtkSmartPointer<vtkUnsignedCharArray> > images;
+  for (int i = 2; i < argc; ++i)
+    {
+    vtkSmartPointer<vtkUnsignedCharArray> image =
+      vtkSmartPointer<vtkUnsignedCharArray>::New();
+    if (!ReadFramebuffer(argv[i], image))
+      {
+      return 1;
+      }
+    images.push_back(image);
+    }
+  if (images.empty())
+    {
+    vtkSmartPointer<vtkUnsignedCharArray> image =
+      vtkSmartPointer<vtkUnsignedCharArray>::New();
+    FillSyntheticFramebuffer(image, 1920, 1080);
+    images.push_back(image);
+    }
+
+  vtkSmartPointer<vtkSquirtCompressor> squirt =
+    vtkSmartPointer<vtkSquirtCompressor>::New();
+  squirt->SetSquirtLevel(0);
+  vtkSmartPointer<vtkZlibImageCompressor> zlib =
+    vtkSmartPointer<vtkZlibImageCompressor>::New();
+  zlib->SetCompressionLevel(1);
+  zlib->SetLossLessMode(1);
+
+  int maxThreads = vtkMultiThreader::GetGlobalDefaultNumberOfThreads();
+  int status = 0;
+  for (size_t cc = 0; cc < images.size(); ++cc)
+    {
+    cout << "Framebuffer " << cc << ": "
+         << images[cc]->GetNumberOfTuples() << " pixels" << endl;
+    for (int threads = 1; ; threads *= 2)
+      {
+      if (threads > maxThreads)
+        {
+        threads = maxThreads;
+        }
+      squirt->SetNumberOfThreads(threads);
+      zlib->SetNumberOfThreads(threads);
+      if (!Benchmark(squirt, images[cc], iterations, true) ||
+        !Benchmark(zlib, images[cc], iterations, true))
+        {
+        status = 1;
+        }
+      if (threads == maxThreads)
+        {
+        break;
+        }
+      }
+    }
+  return status;
+}
@@ -22,6 +22,7 @@
 #include "vtkClientServerMoveData.h"
 #include "vtkCompleteArrays.h"
 #include "vtkCSVWriter.h"
+#include "vtkDeltaImageCompressor.h"
 #include "vtkExtractHistogram.h"
 #include "vtkExtractScatterPlot.h"
 #include "vtkHierarchicalFractal.h"
@@ -65,6 +66,7 @@
 #include "vtkPVLODActor.h"
 #include "vtkPVLODVolume.h"
 #include "vtkPVMain.h"
+#include "vtkPVQuadricClustering.h"
 #include "vtkPVRenderViewProxy.h"
 #include "vtkPVServerArrayHelper.h"
 #include "vtkPVServerArraySelection.h"
@@ -134,6 +136,7 @@ int main(int , char *[])
   c = vtkClientServerMoveData::New(); c->Print(cout); c->Delete();
   c = vtkCompleteArrays::New(); c->Print(cout); c->Delete();
   c = vtkCSVWriter::New(); c->Print(cout); c->Delete();
+  c = vtkDeltaImageCompressor::New(); c->Print(cout); c->Delete();
   c = vtkExtractHistogram::New(); c->Print(cout); c->Delete();
   c = vtkExtractScatterPlot::New(); c->Print(cout); c->Delete();
   c = vtkHierarchicalFractal::New(); c->Print(cout); c->Delete();
@@ -176,6 +179,7 @@ int main(int , char *[])
   c = vtkPVLODActor::New(); c->Print(cout); c->Delete();
   c = vtkPVLODVolume::New(); c->Print(cout); c->Delete();
   c = vtkPVMain::New(); c->Print(cout); c->Delete();
+  c = vtkPVQuadricClustering::New(); c->Print(cout); c->Delete();
   c = vtkPVRenderViewProxy::New(); c->Print(cout); c->Delete();
   c = vtkPVServerArrayHelper::New(); c->Print(cout); c->Delete();
   c = vtkPVServerArraySelection::New(); c->Print(cout); c->Delete();
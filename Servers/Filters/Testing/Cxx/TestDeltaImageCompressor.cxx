@@ -0,0 +1,147 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    $RCSfile$
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+
+#include "vtkDeltaImageCompressor.h"
+#include "vtkSmartPointer.h"
+#include "vtkUnsignedCharArray.h"
+
+// Draw a small square at the given position over a flat background.
+static void DrawFrame(vtkUnsignedCharArray* image, int width, int height,
+  int position)
+{
+  unsigned char* p = image->GetPointer(0);
+  for (int y = 0; y < height; ++y)
+    {
+    for (int x = 0; x < width; ++x, p += 4)
+      {
+      bool inside = (x >= position && x < position + 16 && y >= 32 && y < 48);
+      p[0] = inside ? 255 : 40;
+      p[1] = inside ? 128 : 40;
+      p[2] = static_cast<unsigned char>(inside ? 0 : 60 + y % 8);
+      p[3] = 255;
+      }
+    }
+}
+
+// Send one frame from the server to the client compressor and check that
+// the client reconstructs it. Returns the compressed size or -1.
+static vtkIdType SendFrame(vtkDeltaImageCompressor* server,
+  vtkDeltaImageCompressor* client, vtkUnsignedCharArray* image,
+  bool deliver)
+{
+  vtkSmartPointer<vtkUnsignedCharArray> compressed =
+    vtkSmartPointer<vtkUnsignedCharArray>::New();
+  server->SetInput(image);
+  server->SetOutput(compressed);
+  if (server->Compress() != VTK_OK)
+    {
+    return -1;
+    }
+  if (!deliver)
+    {
+    return compressed->GetNumberOfTuples();
+    }
+
+  vtkSmartPointer<vtkUnsignedCharArray> received =
+    vtkSmartPointer<vtkUnsignedCharArray>::New();
+  received->SetNumberOfComponents(4);
+  received->SetNumberOfTuples(image->GetNumberOfTuples());
+  client->SetInput(compressed);
+  client->SetOutput(received);
+  if (client->Decompress() != VTK_OK ||
+    memcmp(received->GetPointer(0), image->GetPointer(0),
+      image->GetNumberOfTuples() * 4) != 0)
+    {
+    return -1;
+    }
+  return compressed->GetNumberOfTuples();
+}
+
+int main(int, char*[])
+{
+  const int width = 256;
+  const int height = 256;
+  vtkSmartPointer<vtkUnsignedCharArray> image =
+    vtkSmartPointer<vtkUnsignedCharArray>::New();
+  image->SetNumberOfComponents(4);
+  image->SetNumberOfTuples(width * height);
+
+  vtkSmartPointer<vtkDeltaImageCompressor> server =
+    vtkSmartPointer<vtkDeltaImageCompressor>::New();
+  vtkSmartPointer<vtkDeltaImageCompressor> client =
+    vtkSmartPointer<vtkDeltaImageCompressor>::New();
+  server->RestoreConfiguration("vtkDeltaImageCompressor 0 0 1024 1");
+  client->RestoreConfiguration(server->SaveConfiguration());
+  if (client->GetTileSize() != 1024 || client->GetKeyFrameInterval() != 0)
+    {
+    cerr << "Configuration was not restored." << endl;
+    return 1;
+    }
+
+  DrawFrame(image, width, height, 0);
+  vtkIdType keyFrameSize = SendFrame(server, client, image, true);
+  DrawFrame(image, width, height, 4);
+  vtkIdType deltaSize = SendFrame(server, client, image, true);
+  if (keyFrameSize < 0 || deltaSize < 0)
+    {
+    cerr << "Round trip failed." << endl;
+    return 1;
+    }
+  if (deltaSize >= keyFrameSize)
+    {
+    cerr << "Delta frame (" << deltaSize << " bytes) is not smaller than "
+         << "the key frame (" << keyFrameSize << " bytes)." << endl;
+    return 1;
+    }
+
+  // Lose a frame: the next one cannot be applied and the client asks for a
+  // key frame, which the server sends after the request is forwarded.
+  DrawFrame(image, width, height, 8);
+  SendFrame(server, client, image, false);
+  DrawFrame(image, width, height, 12);
+  if (SendFrame(server, client, image, true) >= 0 ||
+    !client->GetKeyFrameRequested(0))
+    {
+    cerr << "Missing frame was not detected." << endl;
+    return 1;
+    }
+  server->RequestKeyFrame(0);
+  if (SendFrame(server, client, image, true) < 0 ||
+    client->GetKeyFrameRequested(0))
+    {
+    cerr << "Resynchronization failed." << endl;
+    return 1;
+    }
+
+  // Streams are independent.
+  server->SetStreamId(1);
+  client->SetStreamId(1);
+  DrawFrame(image, width, height, 100);
+  if (SendFrame(server, client, image, true) < 0)
+    {
+    cerr << "Second stream failed." << endl;
+    return 1;
+    }
+  server->SetStreamId(0);
+  client->SetStreamId(0);
+  DrawFrame(image, width, height, 16);
+  if (SendFrame(server, client, image, true) < 0)
+    {
+    cerr << "First stream was disturbed by the second." << endl;
+    return 1;
+    }
+
+  return 0;
+}
@@ -0,0 +1,227 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    $RCSfile$
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Extract the surfaces of the blocks of a multiblock dataset with several
+// threads and with the topology cache over two time steps, and check that
+// the surfaces are those extracted with one thread and no cache.
+
+#include "vtkCellArray.h"
+#include "vtkCellData.h"
+#include "vtkDataArray.h"
+#include "vtkDoubleArray.h"
+#include "vtkFloatArray.h"
+#include "vtkIdTypeArray.h"
+#include "vtkImageData.h"
+#include "vtkMultiBlockDataSet.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkPVGeometryFilter.h"
+#include "vtkSmartPointer.h"
+#include "vtkUnstructuredGrid.h"
+
+static const int NumberOfBlocks = 6;
+static const int Size = 12;
+
+// A Size^3 grid of hexahedra, offset along x, with the given connectivity
+// if any.  The values of the attributes depend on the time.
+static vtkSmartPointer<vtkUnstructuredGrid> MakeGrid(int block, double time,
+                                                     vtkCellArray* cells)
+{
+  vtkSmartPointer<vtkUnstructuredGrid> grid =
+    vtkSmartPointer<vtkUnstructuredGrid>::New();
+  const int n = Size + 1;
+  vtkSmartPointer<vtkPoints> points = vtkSmartPointer<vtkPoints>::New();
+  vtkSmartPointer<vtkFloatArray> temperature =
+    vtkSmartPointer<vtkFloatArray>::New();
+  temperature->SetName("Temperature");
+  for (int k = 0; k < n; k++)
+    {
+    for (int j = 0; j < n; j++)
+      {
+      for (int i = 0; i < n; i++)
+        {
+        points->InsertNextPoint(block*Size + i + time*0.1*j, j, k*(1.0+time));
+        temperature->InsertNextValue(static_cast<float>(i*j + time*k));
+        }
+      }
+    }
+  grid->SetPoints(points);
+  grid->GetPointData()->AddArray(temperature);
+
+  vtkSmartPointer<vtkDoubleArray> pressure =
+    vtkSmartPointer<vtkDoubleArray>::New();
+  pressure->SetName("Pressure");
+  if (!cells)
+    {
+    grid->Allocate(Size*Size*Size);
+    }
+  for (int k = 0; k < Size; k++)
+    {
+    for (int j = 0; j < Size; j++)
+      {
+      for (int i = 0; i < Size; i++)
+        {
+        vtkIdType p = i + n*(j + n*k);
+        vtkIdType ids[8] = { p, p+1, p+n+1, p+n,
+                             p+n*n, p+n*n+1, p+n*n+n+1, p+n*n+n };
+        if (!cells)
+          {
+          grid->InsertNextCell(VTK_HEXAHEDRON, 8, ids);
+          }
+        pressure->InsertNextValue(time + i - k);
+        }
+      }
+    }
+  if (cells)
+    {
+    grid->SetCells(VTK_HEXAHEDRON, cells);
+    }
+  grid->GetCellData()->AddArray(pressure);
+  return grid;
+}
+
+// The blocks of the multiblock dataset at time.  The unstructured grids
+// keep the connectivity of previous, copied for the odd blocks.
+static vtkSmartPointer<vtkMultiBlockDataSet> MakeBlocks(
+  double time, vtkMultiBlockDataSet* previous)
+{
+  vtkSmartPointer<vtkMultiBlockDataSet> blocks =
+    vtkSmartPointer<vtkMultiBlockDataSet>::New();
+  blocks->SetNumberOfBlocks(NumberOfBlocks + 1);
+  for (int block = 0; block < NumberOfBlocks; block++)
+    {
+    vtkSmartPointer<vtkCellArray> cells;
+    if (previous)
+      {
+      cells = vtkUnstructuredGrid::SafeDownCast(
+        previous->GetBlock(block))->GetCells();
+      if (block % 2)
+        {
+        vtkSmartPointer<vtkCellArray> copy =
+          vtkSmartPointer<vtkCellArray>::New();
+        copy->DeepCopy(cells);
+        cells = copy;
+        }
+      }
+    blocks->SetBlock(block, MakeGrid(block, time, cells));
+    }
+  vtkSmartPointer<vtkImageData> image = vtkSmartPointer<vtkImageData>::New();
+  image->SetExtent(0, 4, 0, 5, 0, 6);
+  image->SetOrigin(0.0, -10.0, 0.0);
+  blocks->SetBlock(NumberOfBlocks, image);
+  return blocks;
+}
+
+static bool SameArrays(vtkDataArray* a, vtkDataArray* b)
+{
+  if (!a || !b ||
+      a->GetNumberOfTuples() != b->GetNumberOfTuples() ||
+      a->GetNumberOfComponents() != b->GetNumberOfComponents())
+    {
+    return false;
+    }
+  for (vtkIdType i = 0; i < a->GetNumberOfTuples(); i++)
+    {
+    for (int j = 0; j < a->GetNumberOfComponents(); j++)
+      {
+      if (a->GetComponent(i, j) != b->GetComponent(i, j))
+        {
+        return false;
+        }
+      }
+    }
+  return true;
+}
+
+static bool SameFieldData(vtkFieldData* a, vtkFieldData* b)
+{
+  if (a->GetNumberOfArrays() != b->GetNumberOfArrays())
+    {
+    return false;
+    }
+  for (int i = 0; i < a->GetNumberOfArrays(); i++)
+    {
+    vtkDataArray* array = a->GetArray(i);
+    if (!SameArrays(array, b->GetArray(array->GetName())))
+      {
+      cerr << "Array " << array->GetName() << " differs." << endl;
+      return false;
+      }
+    }
+  return true;
+}
+
+static bool SameSurfaces(vtkPolyData* a, vtkPolyData* b)
+{
+  return a->GetNumberOfPolys() > 0 &&
+    SameArrays(a->GetPoints()->GetData(), b->GetPoints()->GetData()) &&
+    SameArrays(a->GetPolys()->GetData(), b->GetPolys()->GetData()) &&
+    SameFieldData(a->GetPointData(), b->GetPointData()) &&
+    SameFieldData(a->GetCellData(), b->GetCellData());
+}
+
+int main(int, char*[])
+{
+  vtkSmartPointer<vtkPVGeometryFilter> serial =
+    vtkSmartPointer<vtkPVGeometryFilter>::New();
+  serial->SetController(0);
+  serial->SetUseOutline(0);
+  serial->PassThroughCellIdsOn();
+  serial->PassThroughPointIdsOn();
+  serial->SetNumberOfThreads(1);
+
+  vtkSmartPointer<vtkPVGeometryFilter> threaded =
+    vtkSmartPointer<vtkPVGeometryFilter>::New();
+  threaded->SetController(0);
+  threaded->SetUseOutline(0);
+  threaded->PassThroughCellIdsOn();
+  threaded->PassThroughPointIdsOn();
+  threaded->SetNumberOfThreads(4);
+  threaded->CacheTopologyOn();
+
+  vtkSmartPointer<vtkMultiBlockDataSet> blocks;
+  for (int step = 0; step < 3; step++)
+    {
+    blocks = MakeBlocks(step, blocks);
+    serial->SetInput(blocks);
+    serial->Update();
+    threaded->SetInput(blocks);
+    threaded->Update();
+    if (!SameSurfaces(serial->GetOutput(), threaded->GetOutput()) ||
+        !threaded->GetOutput()->GetPointData()->GetArray("vtkOriginalPointIds"))
+      {
+      cerr << "The surfaces differ at time step " << step << "." << endl;
+      return 1;
+      }
+    }
+
+  // Without the ids of the points and cells.
+  serial->PassThroughCellIdsOff();
+  serial->PassThroughPointIdsOff();
+  serial->Modified();
+  serial->Update();
+  threaded->PassThroughCellIdsOff();
+  threaded->PassThroughPointIdsOff();
+  threaded->Modified();
+  threaded->Update();
+  if (!SameSurfaces(serial->GetOutput(), threaded->GetOutput()) ||
+      threaded->GetOutput()->GetPointData()->GetArray("vtkOriginalPointIds"))
+    {
+    cerr << "The surfaces differ without the original ids." << endl;
+    return 1;
+    }
+
+  return 0;
+}
@@ -0,0 +1,182 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    $RCSfile$
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Build the levels of detail of a fine sphere and of lines with
+// vtkPVLODActor, and check that level n has about a 4^n-th of the
+// primitives of the input, that the levels are built again only when the
+// input changes, and that a frame picks the finest level expected to
+// render in the allocated time. No window is needed: the levels are
+// built and picked as a render does, from a given time per primitive.
+
+#include "vtkCellArray.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkPolyDataMapper.h"
+#include "vtkPVLODActor.h"
+#include "vtkPVQuadricClustering.h"
+#include "vtkSmartPointer.h"
+#include "vtkSphereSource.h"
+
+#include <math.h>
+
+// Gives access to the level building and picking a render does.
+class vtkTestPVLODActor : public vtkPVLODActor
+{
+public:
+  static vtkTestPVLODActor* New() { return new vtkTestPVLODActor; }
+
+  void Update() { this->UpdateLODLevels(); }
+  int IsBuilding() { return this->LODThreadId != -1; }
+
+  // Picks the level of a frame rendered in allocatedTime, knowing the time
+  // per primitive, and returns its number of primitives.
+  vtkIdType Pick(double allocatedTime, double secondsPerPrimitive)
+    {
+    this->SetAllocatedRenderTime(allocatedTime, 0);
+    this->SecondsPerPrimitive = secondsPerPrimitive;
+    vtkPolyData* level = vtkPolyData::SafeDownCast(
+      this->SelectLODLevelMapper()->GetInput());
+    return level? vtkPVQuadricClustering::GetNumberOfPrimitives(level) : -1;
+    }
+};
+
+// Builds the levels of detail of input and checks there are numLevels of
+// them, level n with at most a 4^n-th of the primitives of the input but
+// not much fewer. Returns their numbers of primitives in counts.
+static bool CheckLevels(vtkTestPVLODActor* actor, vtkPolyData* input,
+                        int numLevels, vtkIdType* counts, const char* name)
+{
+  actor->Update();
+  if (!actor->IsBuilding() || actor->GetNumberOfLODLevels() != 1)
+    {
+    cerr << name << ": the levels are not being built." << endl;
+    return false;
+    }
+  actor->WaitForLODLevels();
+  if (actor->GetNumberOfLODLevels() != numLevels)
+    {
+    cerr << name << ": got " << actor->GetNumberOfLODLevels()
+         << " levels instead of " << numLevels << "." << endl;
+    return false;
+    }
+
+  // The finest level is the input, picked when there is time for it.
+  counts[0] = actor->Pick(1.0, 1e-9);
+  if (actor->GetLODLevel() != 0 ||
+      counts[0] != vtkPVQuadricClustering::GetNumberOfPrimitives(input))
+    {
+    cerr << name << ": level 0 is not the input." << endl;
+    return false;
+    }
+
+  // Every level is picked when there is the time for its budget.
+  vtkIdType budget = counts[0];
+  for (int level = 1; level < numLevels; level++)
+    {
+    budget /= 4;
+    counts[level] = actor->Pick(1e-6*budget, 1e-6);
+    if (actor->GetLODLevel() != level ||
+        counts[level] > budget || counts[level] <= budget/4)
+      {
+      cerr << name << ": picked level " << actor->GetLODLevel() << " of "
+           << counts[level] << " primitives for a budget of " << budget
+           << " at level " << level << "." << endl;
+      return false;
+      }
+    }
+  return true;
+}
+
+int main(int, char*[])
+{
+  vtkSmartPointer<vtkSphereSource> sphere =
+    vtkSmartPointer<vtkSphereSource>::New();
+  sphere->SetThetaResolution(512);
+  sphere->SetPhiResolution(512);
+  sphere->Update();
+
+  vtkSmartPointer<vtkPolyDataMapper> mapper =
+    vtkSmartPointer<vtkPolyDataMapper>::New();
+  mapper->SetInput(sphere->GetOutput());
+  vtkSmartPointer<vtkTestPVLODActor> actor =
+    vtkSmartPointer<vtkTestPVLODActor>::New();
+  actor->SetMapper(mapper);
+  actor->SetLODMapper(mapper);
+
+  vtkIdType counts[4];
+  if (!CheckLevels(actor, sphere->GetOutput(), 4, counts, "sphere"))
+    {
+    return 1;
+    }
+
+  // Too little time for any level gives the coarsest, an unknown time per
+  // primitive the input.
+  if (actor->Pick(1e-9, 1e-6) != counts[3] || actor->GetLODLevel() != 3 ||
+      actor->Pick(1e-9, 0.0) != counts[0] || actor->GetLODLevel() != 0)
+    {
+    cerr << "Wrong level without time or without a time per primitive."
+         << endl;
+    return 1;
+    }
+
+  // The levels are kept while the input does not change.
+  actor->Update();
+  if (actor->IsBuilding() || actor->GetNumberOfLODLevels() != 4)
+    {
+    cerr << "The levels were built again for the same input." << endl;
+    return 1;
+    }
+
+  // A changed input is built again, with the limit on the number of levels.
+  sphere->SetThetaResolution(256);
+  sphere->Update();
+  actor->SetMaximumNumberOfLODLevels(3);
+  if (!CheckLevels(actor, sphere->GetOutput(), 3, counts, "changed sphere"))
+    {
+    return 1;
+    }
+
+  // Lines, as streamlines, get levels too.
+  vtkSmartPointer<vtkPoints> points = vtkSmartPointer<vtkPoints>::New();
+  vtkSmartPointer<vtkCellArray> cells = vtkSmartPointer<vtkCellArray>::New();
+  for (int i = 0; i < 50; i++)
+    {
+    cells->InsertNextCell(4000);
+    for (int j = 0; j < 4000; j++)
+      {
+      double angle = 0.01*j + 0.1*i;
+      cells->InsertCellPoint(points->InsertNextPoint(
+        cos(angle)*(1.0 + 0.02*i), sin(angle)*(1.0 + 0.02*i), 0.0005*j));
+      }
+    }
+  vtkSmartPointer<vtkPolyData> lines = vtkSmartPointer<vtkPolyData>::New();
+  lines->SetPoints(points);
+  lines->SetLines(cells);
+  mapper->SetInput(lines);
+  if (!CheckLevels(actor, lines, 3, counts, "lines"))
+    {
+    return 1;
+    }
+
+  // A single level is the LODMapper.
+  actor->SetMaximumNumberOfLODLevels(1);
+  actor->Update();
+  if (actor->IsBuilding() || actor->GetNumberOfLODLevels() != 1)
+    {
+    cerr << "Levels were built for at most 1." << endl;
+    return 1;
+    }
+
+  return 0;
+}
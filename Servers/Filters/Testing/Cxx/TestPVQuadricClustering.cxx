@@ -0,0 +1,175 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    $RCSfile$
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Cluster a fine sphere, a flat plane, lines and a point cloud to a number
+// of triangles, and check that the outputs have at most that many
+// primitives but not much fewer, that small inputs are passed through and
+// that the number of divisions is used when no number of triangles is set.
+
+#include "vtkCellArray.h"
+#include "vtkPlaneSource.h"
+#include "vtkPointSource.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkPVQuadricClustering.h"
+#include "vtkSmartPointer.h"
+#include "vtkSphereSource.h"
+
+#include <math.h>
+
+// Clusters input to maxTriangles triangles and checks the number of
+// primitives of the output is within (minTriangles, maxTriangles].
+static bool CheckBudget(vtkPolyData* input, int maxTriangles,
+                        vtkIdType minTriangles, const char* name)
+{
+  vtkSmartPointer<vtkPVQuadricClustering> clustering =
+    vtkSmartPointer<vtkPVQuadricClustering>::New();
+  clustering->SetInput(input);
+  clustering->SetMaximumNumberOfTriangles(maxTriangles);
+  clustering->UseInputPointsOn();
+  clustering->CopyCellDataOn();
+  clustering->Update();
+
+  vtkIdType numPrimitives =
+    vtkPVQuadricClustering::GetNumberOfPrimitives(clustering->GetOutput());
+  if (numPrimitives > maxTriangles || numPrimitives <= minTriangles)
+    {
+    cerr << name << ": got " << numPrimitives << " primitives for a budget of "
+         << maxTriangles << "." << endl;
+    return false;
+    }
+  return true;
+}
+
+int main(int, char*[])
+{
+  vtkSmartPointer<vtkSphereSource> sphere =
+    vtkSmartPointer<vtkSphereSource>::New();
+  sphere->SetThetaResolution(512);
+  sphere->SetPhiResolution(512);
+  sphere->Update();
+  vtkPolyData* spherePolys = sphere->GetOutput();
+  vtkIdType sphereTriangles =
+    vtkPVQuadricClustering::GetNumberOfTriangles(spherePolys);
+  if (sphereTriangles != spherePolys->GetNumberOfPolys())
+    {
+    cerr << "Counted " << sphereTriangles << " triangles in "
+         << spherePolys->GetNumberOfPolys() << " triangles." << endl;
+    return 1;
+    }
+
+  if (!CheckBudget(spherePolys, 100000, 25000, "sphere") ||
+      !CheckBudget(spherePolys, 5000, 1250, "coarse sphere"))
+    {
+    return 1;
+    }
+
+  // A flat plane of quads, which take two triangles each.
+  vtkSmartPointer<vtkPlaneSource> plane =
+    vtkSmartPointer<vtkPlaneSource>::New();
+  plane->SetResolution(400, 100);
+  plane->SetPoint1(4.0, 0.0, 0.0);
+  plane->SetPoint2(0.0, 1.0, 0.0);
+  plane->Update();
+  if (vtkPVQuadricClustering::GetNumberOfTriangles(plane->GetOutput()) !=
+      2*plane->GetOutput()->GetNumberOfPolys())
+    {
+    cerr << "Wrong number of triangles for quads." << endl;
+    return 1;
+    }
+  if (!CheckBudget(plane->GetOutput(), 20000, 5000, "plane"))
+    {
+    return 1;
+    }
+
+  // Helices, as streamlines, of 4000 points and 3999 segments each.
+  vtkSmartPointer<vtkPoints> helixPoints = vtkSmartPointer<vtkPoints>::New();
+  vtkSmartPointer<vtkCellArray> helices = vtkSmartPointer<vtkCellArray>::New();
+  for (int i = 0; i < 100; i++)
+    {
+    helices->InsertNextCell(4000);
+    for (int j = 0; j < 4000; j++)
+      {
+      double angle = 0.01*j + 0.1*i;
+      helices->InsertCellPoint(helixPoints->InsertNextPoint(
+        cos(angle)*(1.0 + 0.01*i), sin(angle)*(1.0 + 0.01*i), 0.0005*j));
+      }
+    }
+  vtkSmartPointer<vtkPolyData> lines = vtkSmartPointer<vtkPolyData>::New();
+  lines->SetPoints(helixPoints);
+  lines->SetLines(helices);
+  if (vtkPVQuadricClustering::GetNumberOfTriangles(lines) != 0 ||
+      vtkPVQuadricClustering::GetNumberOfPrimitives(lines) != 100*3999)
+    {
+    cerr << "Wrong number of primitives for lines." << endl;
+    return 1;
+    }
+  if (!CheckBudget(lines, 20000, 5000, "lines"))
+    {
+    return 1;
+    }
+
+  // A point cloud, with a vertex per point.
+  vtkSmartPointer<vtkPointSource> cloud =
+    vtkSmartPointer<vtkPointSource>::New();
+  cloud->SetNumberOfPoints(200000);
+  cloud->SetDistributionToUniform();
+  cloud->Update();
+  if (vtkPVQuadricClustering::GetNumberOfPrimitives(cloud->GetOutput()) !=
+      200000)
+    {
+    cerr << "Wrong number of primitives for verts." << endl;
+    return 1;
+    }
+  if (!CheckBudget(cloud->GetOutput(), 20000, 5000, "point cloud"))
+    {
+    return 1;
+    }
+
+  // An input within the budget is passed through.
+  vtkSmartPointer<vtkPVQuadricClustering> clustering =
+    vtkSmartPointer<vtkPVQuadricClustering>::New();
+  clustering->SetInput(spherePolys);
+  clustering->SetMaximumNumberOfTriangles(
+    static_cast<int>(sphereTriangles));
+  clustering->Update();
+  if (clustering->GetOutput()->GetNumberOfPolys() !=
+      spherePolys->GetNumberOfPolys() ||
+      clustering->GetOutput()->GetPoints() != spherePolys->GetPoints())
+    {
+    cerr << "The input within the budget was not passed through." << endl;
+    return 1;
+    }
+
+  // Without a budget, the number of divisions is used.
+  vtkSmartPointer<vtkQuadricClustering> reference =
+    vtkSmartPointer<vtkQuadricClustering>::New();
+  reference->SetInput(spherePolys);
+  reference->SetNumberOfDivisions(20, 20, 20);
+  reference->Update();
+  clustering->SetMaximumNumberOfTriangles(0);
+  clustering->SetNumberOfDivisions(20, 20, 20);
+  clustering->Update();
+  if (clustering->GetOutput()->GetNumberOfPolys() !=
+      reference->GetOutput()->GetNumberOfPolys())
+    {
+    cerr << "Got " << clustering->GetOutput()->GetNumberOfPolys()
+         << " triangles instead of "
+         << reference->GetOutput()->GetNumberOfPolys()
+         << " without a budget." << endl;
+    return 1;
+    }
+
+  return 0;
+}
@@ -0,0 +1,189 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    $RCSfile$
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Reduce tables and polydata from all the processes along a tree with
+// vtkReductionFilter, and check on the root that the results are those of
+// the gather on the root.
+
+#include <mpi.h>
+
+#include "vtkAppendPolyData.h"
+#include "vtkAttributeDataReductionFilter.h"
+#include "vtkCellArray.h"
+#include "vtkDoubleArray.h"
+#include "vtkMPIController.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkReductionFilter.h"
+#include "vtkSmartPointer.h"
+#include "vtkTable.h"
+
+static const int NumberOfRows = 10;
+
+// A table of the values rank*NumberOfRows + row.
+static vtkSmartPointer<vtkTable> MakeTable(int myId)
+{
+  vtkSmartPointer<vtkDoubleArray> values =
+    vtkSmartPointer<vtkDoubleArray>::New();
+  values->SetName("Values");
+  for (int i = 0; i < NumberOfRows; i++)
+    {
+    values->InsertNextValue(myId*NumberOfRows + i);
+    }
+  vtkSmartPointer<vtkTable> table = vtkSmartPointer<vtkTable>::New();
+  table->AddColumn(values);
+  return table;
+}
+
+// One vertex at (rank, 0, 0).
+static vtkSmartPointer<vtkPolyData> MakePolyData(int myId)
+{
+  vtkSmartPointer<vtkPoints> points = vtkSmartPointer<vtkPoints>::New();
+  points->InsertNextPoint(myId, 0.0, 0.0);
+  vtkSmartPointer<vtkCellArray> verts = vtkSmartPointer<vtkCellArray>::New();
+  verts->InsertNextCell(1);
+  verts->InsertCellPoint(0);
+  vtkSmartPointer<vtkPolyData> polyData = vtkSmartPointer<vtkPolyData>::New();
+  polyData->SetPoints(points);
+  polyData->SetVerts(verts);
+  return polyData;
+}
+
+static vtkSmartPointer<vtkDataObject> Reduce(
+  vtkMultiProcessController* controller, vtkDataObject* input,
+  vtkAlgorithm* helper, int inTree)
+{
+  vtkSmartPointer<vtkReductionFilter> reduction =
+    vtkSmartPointer<vtkReductionFilter>::New();
+  reduction->SetController(controller);
+  reduction->SetPostGatherHelper(helper);
+  reduction->SetReduceInTree(inTree);
+  reduction->SetInput(input);
+  reduction->Update();
+  vtkSmartPointer<vtkDataObject> output;
+  output.TakeReference(reduction->GetOutputDataObject(0)->NewInstance());
+  output->ShallowCopy(reduction->GetOutputDataObject(0));
+  return output;
+}
+
+struct ReductionFilterTreeArgs
+{
+  int* retVal;
+};
+
+// This will be called by all processes
+void MyMain(vtkMultiProcessController *controller, void *arg)
+{
+  ReductionFilterTreeArgs* args =
+    reinterpret_cast<ReductionFilterTreeArgs*>(arg);
+
+  int myId = controller->GetLocalProcessId();
+  int numProcs = controller->GetNumberOfProcesses();
+
+  // The sum of the tables.
+  vtkSmartPointer<vtkTable> table = MakeTable(myId);
+  vtkSmartPointer<vtkAttributeDataReductionFilter> add =
+    vtkSmartPointer<vtkAttributeDataReductionFilter>::New();
+  add->SetAttributeType(vtkAttributeDataReductionFilter::ROW_DATA);
+  add->SetReductionType(vtkAttributeDataReductionFilter::ADD);
+  vtkSmartPointer<vtkTable> sums[2];
+  for (int inTree = 0; inTree < 2; inTree++)
+    {
+    sums[inTree] = vtkTable::SafeDownCast(Reduce(controller, table, add,
+                                                 inTree));
+    }
+
+  // The points of all the processes, in order.
+  vtkSmartPointer<vtkPolyData> polyData = MakePolyData(myId);
+  vtkSmartPointer<vtkAppendPolyData> append =
+    vtkSmartPointer<vtkAppendPolyData>::New();
+  vtkSmartPointer<vtkPolyData> appended[2];
+  for (int inTree = 0; inTree < 2; inTree++)
+    {
+    appended[inTree] = vtkPolyData::SafeDownCast(
+      Reduce(controller, polyData, append, inTree));
+    }
+
+  int failed = 0;
+  if (myId == 0)
+    {
+    for (int inTree = 0; inTree < 2; inTree++)
+      {
+      vtkDataArray* values = sums[inTree] ?
+        vtkDataArray::SafeDownCast(
+          sums[inTree]->GetColumnByName("Values")) : 0;
+      if (!values || values->GetNumberOfTuples() != NumberOfRows)
+        {
+        cerr << "Missing sums." << endl;
+        failed = 1;
+        continue;
+        }
+      for (int i = 0; i < NumberOfRows; i++)
+        {
+        double expected = NumberOfRows*numProcs*(numProcs - 1)/2.0 +
+          numProcs*i;
+        if (values->GetTuple1(i) != expected)
+          {
+          cerr << "Sum " << i << " is " << values->GetTuple1(i)
+               << " instead of " << expected << endl;
+          failed = 1;
+          }
+        }
+
+      vtkPolyData* points = appended[inTree];
+      if (!points || points->GetNumberOfPoints() != numProcs)
+        {
+        cerr << "Expected " << numProcs << " appended points." << endl;
+        failed = 1;
+        continue;
+        }
+      for (int i = 0; i < numProcs; i++)
+        {
+        if (points->GetPoint(i)[0] != i)
+          {
+          cerr << "The appended points are not in the order of the "
+               << "processes." << endl;
+          failed = 1;
+          break;
+          }
+        }
+      }
+    }
+  controller->AllReduce(&failed, args->retVal, 1, vtkCommunicator::MAX_OP);
+}
+
+int main(int argc, char **argv)
+{
+  // This is here to avoid false leak messages from vtkDebugLeaks when
+  // using mpich. It appears that the root process which spawns all the
+  // main processes waits in MPI_Init() and calls exit() when
+  // the others are done, causing apparent memory leaks for any objects
+  // created before MPI_Init().
+  MPI_Init(&argc, &argv);
+
+  vtkMPIController* controller = vtkMPIController::New();
+  controller->Initialize(&argc, &argv, 1);
+
+  int retVal = 1;
+  ReductionFilterTreeArgs args;
+  args.retVal = &retVal;
+
+  controller->SetSingleMethod(MyMain, &args);
+  controller->SingleMethodExecute();
+
+  controller->Finalize();
+  controller->Delete();
+
+  return retVal;
+}
@@ -0,0 +1,475 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    $RCSfile$
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkDeltaImageCompressor.h"
+
+#include "vtkMultiProcessStream.h"
+#include "vtkObjectFactory.h"
+#include "vtkUnsignedCharArray.h"
+#include "vtkZlibImageCompressor.h"
+
+#include <vtkstd/map>
+#include <vtkstd/vector>
+#include <vtksys/ios/sstream>
+
+vtkStandardNewMacro(vtkDeltaImageCompressor);
+vtkCxxRevisionMacro(vtkDeltaImageCompressor, "$Revision$");
+
+//-----------------------------------------------------------------------------
+// The compressed data is laid out as
+//   [frame type] [serial] [base serial] [pixels] [components] [tile size]
+//   [changed tile bitmask] [changed tiles, see vtkZlibImageCompressor]
+// with all header values stored as 32 bit little-endian integers.
+static const int vtkDeltaImageCompressorHeaderSize = 24;
+enum
+{
+  vtkDeltaImageCompressorKeyFrame = 0,
+  vtkDeltaImageCompressorDeltaFrame = 1
+};
+
+//-----------------------------------------------------------------------------
+static void vtkDeltaImageCompressorWriteUInt32(unsigned char* out,
+  vtkIdType value)
+{
+  out[0] = static_cast<unsigned char>(value & 0xff);
+  out[1] = static_cast<unsigned char>((value >> 8) & 0xff);
+  out[2] = static_cast<unsigned char>((value >> 16) & 0xff);
+  out[3] = static_cast<unsigned char>((value >> 24) & 0xff);
+}
+
+//-----------------------------------------------------------------------------
+static vtkIdType vtkDeltaImageCompressorReadUInt32(const unsigned char* in)
+{
+  return static_cast<vtkIdType>(
+    static_cast<vtkTypeUInt32>(in[0]) |
+    (static_cast<vtkTypeUInt32>(in[1]) << 8) |
+    (static_cast<vtkTypeUInt32>(in[2]) << 16) |
+    (static_cast<vtkTypeUInt32>(in[3]) << 24));
+}
+
+//-----------------------------------------------------------------------------
+class vtkDeltaImageCompressor::vtkInternals
+{
+public:
+  // The last image of a stream, as both sides see it.
+  struct Reference
+    {
+    Reference() : Valid(0), Serial(0), FramesSinceKeyFrame(0),
+      KeyFrameRequested(0), NumberOfPixels(0), NumberOfComponents(0),
+      TileSize(0) {}
+    int Valid;
+    vtkTypeUInt32 Serial;
+    int FramesSinceKeyFrame;
+    int KeyFrameRequested;
+    vtkIdType NumberOfPixels;
+    int NumberOfComponents;
+    int TileSize;
+    vtkstd::vector<unsigned char> Pixels;
+    };
+
+  vtkstd::map<int, Reference> References;
+  vtkstd::vector<unsigned char> ChangedTiles;
+};
+
+//-----------------------------------------------------------------------------
+vtkDeltaImageCompressor::vtkDeltaImageCompressor()
+{
+  this->StreamId = 0;
+  this->KeyFrameInterval = 60;
+  this->TileSize = 4096;
+  this->TileCompressor = vtkZlibImageCompressor::New();
+  this->TileCompressor->SetLossLessMode(1);
+  this->TileCompressor->SetCompressionLevel(1);
+  this->Tiles = vtkUnsignedCharArray::New();
+  this->CompressedTiles = vtkUnsignedCharArray::New();
+  this->Internals = new vtkInternals;
+}
+
+//-----------------------------------------------------------------------------
+vtkDeltaImageCompressor::~vtkDeltaImageCompressor()
+{
+  this->TileCompressor->Delete();
+  this->Tiles->Delete();
+  this->CompressedTiles->Delete();
+  delete this->Internals;
+}
+
+//-----------------------------------------------------------------------------
+void vtkDeltaImageCompressor::SetCompressionLevel(int level)
+{
+  if (level != this->TileCompressor->GetCompressionLevel())
+    {
+    this->TileCompressor->SetCompressionLevel(level);
+    this->Modified();
+    }
+}
+
+//-----------------------------------------------------------------------------
+int vtkDeltaImageCompressor::GetCompressionLevel()
+{
+  return this->TileCompressor->GetCompressionLevel();
+}
+
+//-----------------------------------------------------------------------------
+void vtkDeltaImageCompressor::RequestKeyFrame(int streamId)
+{
+  this->Internals->References[streamId].KeyFrameRequested = 1;
+}
+
+//-----------------------------------------------------------------------------
+int vtkDeltaImageCompressor::GetKeyFrameRequested(int streamId)
+{
+  vtkstd::map<int, vtkInternals::Reference>::iterator iter =
+    this->Internals->References.find(streamId);
+  return iter != this->Internals->References.end() &&
+    iter->second.KeyFrameRequested;
+}
+
+//-----------------------------------------------------------------------------
+void vtkDeltaImageCompressor::Reset()
+{
+  this->Internals->References.clear();
+}
+
+//-----------------------------------------------------------------------------
+int vtkDeltaImageCompressor::Compress()
+{
+  if (!(this->Input && this->Output))
+    {
+    vtkWarningMacro("Cannot compress empty input or output detected.");
+    return VTK_ERROR;
+    }
+
+  const unsigned char* in = this->Input->GetPointer(0);
+  vtkIdType numberOfPixels = this->Input->GetNumberOfTuples();
+  int numberOfComponents = this->Input->GetNumberOfComponents();
+  vtkIdType imageSize = numberOfPixels * numberOfComponents;
+  vtkIdType tileBytes =
+    static_cast<vtkIdType>(this->TileSize) * numberOfComponents;
+  vtkIdType numberOfTiles = (numberOfPixels + this->TileSize - 1) /
+    this->TileSize;
+
+  vtkInternals::Reference& ref = this->Internals->References[this->StreamId];
+  int keyFrame = !ref.Valid || ref.KeyFrameRequested ||
+    ref.NumberOfPixels != numberOfPixels ||
+    ref.NumberOfComponents != numberOfComponents ||
+    ref.TileSize != this->TileSize ||
+    (this->KeyFrameInterval > 0 &&
+     ref.FramesSinceKeyFrame + 1 >= this->KeyFrameInterval);
+
+  // Find the tiles that changed since the last frame.
+  vtkstd::vector<unsigned char>& changed = this->Internals->ChangedTiles;
+  changed.assign((numberOfTiles + 7) / 8, keyFrame ? 0xff : 0);
+  vtkIdType numberOfChangedPixels = 0;
+  vtkIdType cc;
+  for (cc = 0; cc < numberOfTiles; ++cc)
+    {
+    vtkIdType start = cc * tileBytes;
+    vtkIdType bytes = imageSize - start < tileBytes ?
+      imageSize - start : tileBytes;
+    if (keyFrame || memcmp(in + start, &ref.Pixels[start], bytes) != 0)
+      {
+      changed[cc / 8] |= static_cast<unsigned char>(1 << (cc % 8));
+      numberOfChangedPixels += bytes / numberOfComponents;
+      }
+    }
+
+  // Gather the changed tiles and make them the new reference.
+  if (keyFrame)
+    {
+    ref.Pixels.resize(imageSize);
+    }
+  this->Tiles->SetNumberOfComponents(numberOfComponents);
+  this->Tiles->SetNumberOfTuples(numberOfChangedPixels);
+  unsigned char* tiles = this->Tiles->GetPointer(0);
+  for (cc = 0; cc < numberOfTiles; ++cc)
+    {
+    if (changed[cc / 8] & (1 << (cc % 8)))
+      {
+      vtkIdType start = cc * tileBytes;
+      vtkIdType bytes = imageSize - start < tileBytes ?
+        imageSize - start : tileBytes;
+      memcpy(tiles, in + start, bytes);
+      memcpy(&ref.Pixels[start], in + start, bytes);
+      tiles += bytes;
+      }
+    }
+
+  vtkIdType compressedSize = 0;
+  if (numberOfChangedPixels > 0)
+    {
+    this->TileCompressor->SetInput(this->Tiles);
+    this->TileCompressor->SetOutput(this->CompressedTiles);
+    int status = this->TileCompressor->Compress();
+    this->TileCompressor->SetInput(0);
+    this->TileCompressor->SetOutput(0);
+    if (status != VTK_OK)
+      {
+      ref.Valid = 0;
+      return VTK_ERROR;
+      }
+    compressedSize = this->CompressedTiles->GetNumberOfTuples();
+    }
+
+  vtkTypeUInt32 base = ref.Serial;
+  ref.Valid = 1;
+  ref.Serial++;
+  ref.FramesSinceKeyFrame = keyFrame ? 0 : ref.FramesSinceKeyFrame + 1;
+  ref.KeyFrameRequested = 0;
+  ref.NumberOfPixels = numberOfPixels;
+  ref.NumberOfComponents = numberOfComponents;
+  ref.TileSize = this->TileSize;
+
+  vtkIdType maskSize = static_cast<vtkIdType>(changed.size());
+  this->Output->SetNumberOfComponents(1);
+  this->Output->SetNumberOfTuples(
+    vtkDeltaImageCompressorHeaderSize + maskSize + compressedSize);
+  unsigned char* out = this->Output->GetPointer(0);
+  vtkDeltaImageCompressorWriteUInt32(out, keyFrame ?
+    vtkDeltaImageCompressorKeyFrame : vtkDeltaImageCompressorDeltaFrame);
+  vtkDeltaImageCompressorWriteUInt32(out + 4, ref.Serial);
+  vtkDeltaImageCompressorWriteUInt32(out + 8, base);
+  vtkDeltaImageCompressorWriteUInt32(out + 12, numberOfPixels);
+  vtkDeltaImageCompressorWriteUInt32(out + 16, numberOfComponents);
+  vtkDeltaImageCompressorWriteUInt32(out + 20, this->TileSize);
+  out += vtkDeltaImageCompressorHeaderSize;
+  if (maskSize > 0)
+    {
+    memcpy(out, &changed[0], maskSize);
+    }
+  if (compressedSize > 0)
+    {
+    memcpy(out + maskSize, this->CompressedTiles->GetPointer(0),
+      compressedSize);
+    }
+  return VTK_OK;
+}
+
+//-----------------------------------------------------------------------------
+int vtkDeltaImageCompressor::Decompress()
+{
+  if (!(this->Input && this->Output))
+    {
+    vtkWarningMacro("Cannot decompress empty input or output detected.");
+    return VTK_ERROR;
+    }
+
+  const unsigned char* in = this->Input->GetPointer(0);
+  vtkIdType inSize = this->Input->GetNumberOfTuples() *
+    this->Input->GetNumberOfComponents();
+  vtkInternals::Reference& ref = this->Internals->References[this->StreamId];
+  if (inSize < vtkDeltaImageCompressorHeaderSize)
+    {
+    vtkErrorMacro("Compressed image is truncated.");
+    ref.KeyFrameRequested = 1;
+    return VTK_ERROR;
+    }
+  int keyFrame = (vtkDeltaImageCompressorReadUInt32(in) ==
+    vtkDeltaImageCompressorKeyFrame);
+  vtkTypeUInt32 serial =
+    static_cast<vtkTypeUInt32>(vtkDeltaImageCompressorReadUInt32(in + 4));
+  vtkTypeUInt32 base =
+    static_cast<vtkTypeUInt32>(vtkDeltaImageCompressorReadUInt32(in + 8));
+  vtkIdType numberOfPixels = vtkDeltaImageCompressorReadUInt32(in + 12);
+  int numberOfComponents =
+    static_cast<int>(vtkDeltaImageCompressorReadUInt32(in + 16));
+  int tileSize = static_cast<int>(vtkDeltaImageCompressorReadUInt32(in + 20));
+
+  // The output is allocated by the caller to the size of the image.
+  if (numberOfPixels != this->Output->GetNumberOfTuples() ||
+    numberOfComponents != this->Output->GetNumberOfComponents() ||
+    tileSize < 1)
+    {
+    vtkErrorMacro("Compressed image does not match the output size.");
+    ref.KeyFrameRequested = 1;
+    return VTK_ERROR;
+    }
+  vtkIdType imageSize = numberOfPixels * numberOfComponents;
+
+  // A delta frame can only be applied on top of the frame it is based on,
+  // otherwise ask for a key frame and show the last frame meanwhile.
+  if (!keyFrame && !(ref.Valid && ref.Serial == base &&
+      ref.NumberOfPixels == numberOfPixels &&
+      ref.NumberOfComponents == numberOfComponents &&
+      ref.TileSize == tileSize))
+    {
+    ref.KeyFrameRequested = 1;
+    if (ref.Valid && ref.NumberOfPixels == numberOfPixels &&
+      ref.NumberOfComponents == numberOfComponents && imageSize > 0)
+      {
+      memcpy(this->Output->GetPointer(0), &ref.Pixels[0], imageSize);
+      }
+    return VTK_ERROR;
+    }
+
+  vtkIdType tileBytes = static_cast<vtkIdType>(tileSize) * numberOfComponents;
+  vtkIdType numberOfTiles = (numberOfPixels + tileSize - 1) / tileSize;
+  vtkIdType maskSize = (numberOfTiles + 7) / 8;
+  if (inSize < vtkDeltaImageCompressorHeaderSize + maskSize)
+    {
+    vtkErrorMacro("Compressed image is truncated.");
+    ref.KeyFrameRequested = 1;
+    return VTK_ERROR;
+    }
+  const unsigned char* changed = in + vtkDeltaImageCompressorHeaderSize;
+  vtkIdType numberOfChangedPixels = 0;
+  vtkIdType cc;
+  for (cc = 0; cc < numberOfTiles; ++cc)
+    {
+    if (changed[cc / 8] & (1 << (cc % 8)))
+      {
+      vtkIdType start = cc * tileBytes;
+      vtkIdType bytes = imageSize - start < tileBytes ?
+        imageSize - start : tileBytes;
+      numberOfChangedPixels += bytes / numberOfComponents;
+      }
+    }
+
+  // Inflate the changed tiles.
+  if (numberOfChangedPixels > 0)
+    {
+    vtkIdType compressedSize =
+      inSize - vtkDeltaImageCompressorHeaderSize - maskSize;
+    this->CompressedTiles->SetArray(
+      const_cast<unsigned char*>(changed + maskSize), compressedSize, 1);
+    this->Tiles->SetNumberOfComponents(numberOfComponents);
+    this->Tiles->SetNumberOfTuples(numberOfChangedPixels);
+    this->TileCompressor->SetInput(this->CompressedTiles);
+    this->TileCompressor->SetOutput(this->Tiles);
+    int status = this->TileCompressor->Decompress();
+    this->TileCompressor->SetInput(0);
+    this->TileCompressor->SetOutput(0);
+    this->CompressedTiles->Initialize();
+    if (status != VTK_OK)
+      {
+      ref.KeyFrameRequested = 1;
+      ref.Valid = 0;
+      return VTK_ERROR;
+      }
+    }
+
+  // Apply them to the last frame.
+  if (keyFrame)
+    {
+    ref.Pixels.resize(imageSize);
+    }
+  const unsigned char* tiles = this->Tiles->GetPointer(0);
+  for (cc = 0; cc < numberOfTiles; ++cc)
+    {
+    if (changed[cc / 8] & (1 << (cc % 8)))
+      {
+      vtkIdType start = cc * tileBytes;
+      vtkIdType bytes = imageSize - start < tileBytes ?
+        imageSize - start : tileBytes;
+      memcpy(&ref.Pixels[start], tiles, bytes);
+      tiles += bytes;
+      }
+    }
+  if (imageSize > 0)
+    {
+    memcpy(this->Output->GetPointer(0), &ref.Pixels[0], imageSize);
+    }
+
+  ref.Valid = 1;
+  ref.Serial = serial;
+  ref.NumberOfPixels = numberOfPixels;
+  ref.NumberOfComponents = numberOfComponents;
+  ref.TileSize = tileSize;
+  if (keyFrame)
+    {
+    ref.KeyFrameRequested = 0;
+    }
+  return VTK_OK;
+}
+
+//-----------------------------------------------------------------------------
+void vtkDeltaImageCompressor::SaveConfiguration(vtkMultiProcessStream *stream)
+{
+  vtkImageCompressor::SaveConfiguration(stream);
+  *stream
+    << this->KeyFrameInterval
+    << this->TileSize
+    << this->GetCompressionLevel();
+}
+
+//-----------------------------------------------------------------------------
+bool vtkDeltaImageCompressor::RestoreConfiguration(
+  vtkMultiProcessStream *stream)
+{
+  if (vtkImageCompressor::RestoreConfiguration(stream))
+    {
+    int keyFrameInterval;
+    int tileSize;
+    int compressionLevel;
+    *stream
+      >> keyFrameInterval
+      >> tileSize
+      >> compressionLevel;
+    this->SetKeyFrameInterval(keyFrameInterval);
+    this->SetTileSize(tileSize);
+    this->SetCompressionLevel(compressionLevel);
+    return true;
+    }
+  return false;
+}
+
+//-----------------------------------------------------------------------------
+const char *vtkDeltaImageCompressor::SaveConfiguration()
+{
+  vtkstd::ostringstream oss;
+  oss
+    << vtkImageCompressor::SaveConfiguration()
+    << " "
+    << this->KeyFrameInterval
+    << " "
+    << this->TileSize
+    << " "
+    << this->GetCompressionLevel();
+
+  this->SetConfiguration(oss.str().c_str());
+
+  return this->Configuration;
+}
+
+//-----------------------------------------------------------------------------
+const char *vtkDeltaImageCompressor::RestoreConfiguration(const char *stream)
+{
+  stream=vtkImageCompressor::RestoreConfiguration(stream);
+  if (stream)
+    {
+    vtkstd::istringstream iss(stream);
+    int keyFrameInterval;
+    int tileSize;
+    int compressionLevel;
+    iss
+      >> keyFrameInterval
+      >> tileSize
+      >> compressionLevel;
+    this->SetKeyFrameInterval(keyFrameInterval);
+    this->SetTileSize(tileSize);
+    this->SetCompressionLevel(compressionLevel);
+    return stream+iss.tellg();
+    }
+  return 0;
+}
+
+//-----------------------------------------------------------------------------
+void vtkDeltaImageCompressor::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "StreamId: " << this->StreamId << endl;
+  os << indent << "KeyFrameInterval: " << this->KeyFrameInterval << endl;
+  os << indent << "TileSize: " << this->TileSize << endl;
+  os << indent << "CompressionLevel: " << this->GetCompressionLevel() << endl;
+}
@@ -0,0 +1,131 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    $RCSfile$
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkDeltaImageCompressor - Sends only the parts of an image that
+// changed since the previous frame.
+//
+// .SECTION Description
+// vtkDeltaImageCompressor keeps the last image compressed (or decompressed)
+// for each stream and splits every new image into tiles of TileSize pixels.
+// Only the tiles that differ from the previous image are deflated and sent,
+// with a bitmask of the changed tiles. During camera interaction most of the
+// background and annotations do not change between frames.
+//
+// Every KeyFrameInterval frames, when the image size changes, or when
+// RequestKeyFrame() is called, the whole image is sent. Each frame records
+// the serial number of the frame it is based on. When the receiving side
+// does not hold that frame, Decompress() fails and GetKeyFrameRequested()
+// is set until a key frame arrives. The render managers forward this flag
+// to the sending side with the window information of the next render.
+//
+// The images are compared and sent exactly, so the compression is loss-less
+// whatever LossLessMode is.
+//
+// The configuration stream is:
+// [ClassName, LossLessMode, KeyFrameInterval, TileSize, CompressionLevel].
+//
+// .SECTION See Also
+// vtkZlibImageCompressor vtkPVClientServerRenderManager
+
+#ifndef __vtkDeltaImageCompressor_h
+#define __vtkDeltaImageCompressor_h
+
+#include "vtkImageCompressor.h"
+
+class vtkZlibImageCompressor;
+
+class VTK_EXPORT vtkDeltaImageCompressor : public vtkImageCompressor
+{
+public:
+  static vtkDeltaImageCompressor* New();
+  vtkTypeRevisionMacro(vtkDeltaImageCompressor, vtkImageCompressor);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  // Description:
+  // Compress/Decompress data array on the objects input with results
+  // in the objects output. See also Set/GetInput/Output.
+  virtual int Compress();
+  virtual int Decompress();
+
+  //BTX
+  // Description:
+  // Serialize/Restore compressor configuration (but not the data) into the stream.
+  virtual void SaveConfiguration(vtkMultiProcessStream *stream);
+  virtual bool RestoreConfiguration(vtkMultiProcessStream* stream);
+  //ETX
+  virtual const char *SaveConfiguration();
+  virtual const char *RestoreConfiguration(const char *stream);
+
+  // Description:
+  // Identifies the sequence of images the next image belongs to, for
+  // example the id of the view. A previous image is kept for each stream.
+  // Default is 0.
+  vtkSetMacro(StreamId, int);
+  vtkGetMacro(StreamId, int);
+
+  // Description:
+  // Send a whole image every KeyFrameInterval frames. 0 disables periodic
+  // key frames. Default is 60.
+  vtkSetClampMacro(KeyFrameInterval, int, 0, VTK_INT_MAX);
+  vtkGetMacro(KeyFrameInterval, int);
+
+  // Description:
+  // Number of pixels in a tile. Default is 4096.
+  vtkSetClampMacro(TileSize, int, 64, VTK_INT_MAX);
+  vtkGetMacro(TileSize, int);
+
+  // Description:
+  // Zlib compression level used for the changed tiles, see
+  // vtkZlibImageCompressor. Default is 1.
+  void SetCompressionLevel(int level);
+  int GetCompressionLevel();
+
+  // Description:
+  // Make the next image compressed for the given stream a key frame.
+  void RequestKeyFrame(int streamId);
+
+  // Description:
+  // Set on the receiving side when an image of the given stream could not
+  // be decompressed because it is based on a frame that was not received.
+  // Cleared when a key frame for that stream is decompressed.
+  int GetKeyFrameRequested(int streamId);
+
+  // Description:
+  // Forget all previous images. The next image of every stream is a key
+  // frame.
+  void Reset();
+
+protected:
+  vtkDeltaImageCompressor();
+  virtual ~vtkDeltaImageCompressor();
+
+  int StreamId;
+  int KeyFrameInterval;
+  int TileSize;
+
+  vtkZlibImageCompressor* TileCompressor;
+  vtkUnsignedCharArray* Tiles;
+  vtkUnsignedCharArray* CompressedTiles;
+
+private:
+  vtkDeltaImageCompressor(const vtkDeltaImageCompressor&); // Not implemented.
+  void operator=(const vtkDeltaImageCompressor&); // Not implemented.
+
+//BTX
+  class vtkInternals;
+  vtkInternals* Internals;
+//ETX
+};
+
+#endif
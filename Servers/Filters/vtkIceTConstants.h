@@ -49,7 +49,8 @@ public:
     VTREE   = 2,
     SPLIT   = 3,
     SERIAL  = 4,
-    DIRECT  = 5
+    DIRECT  = 5,
+    RADIXK  = 6
   };
 
   enum ComposeOperationType {
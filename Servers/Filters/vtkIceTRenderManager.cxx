@@ -597,6 +597,14 @@ void vtkIceTRenderManager::SetStrategy(const char *strategy)
     {
     this->SetStrategy(DIRECT);
     }
+  else if (strcmp(strategy, "RADIXK") == 0)
+    {
+    this->SetStrategy(RADIXK);
+    }
+  else if (strcmp(strategy, "BSWAP") == 0)
+    {
+    this->SetStrategyToBinarySwap();
+    }
   else
     {
     vtkWarningMacro("No such strategy " << strategy);
@@ -605,6 +613,32 @@ void vtkIceTRenderManager::SetStrategy(const char *strategy)
 
 //-----------------------------------------------------------------------------
 
+void vtkIceTRenderManager::SetRadixK(int k)
+{
+  vtkDebugMacro("SetRadixK to " << k);
+
+  if (!this->RenderWindow)
+    {
+    vtkErrorMacro("Must set the render window and its renderers before calling SetRadixK.");
+    return;
+    }
+
+  vtkRendererCollection *renderers = this->RenderWindow->GetRenderers();
+  vtkCollectionSimpleIterator cookie;
+  vtkRenderer *_ren;
+
+  renderers->InitTraversal(cookie);
+  while ((_ren = renderers->GetNextRenderer(cookie)) != NULL)
+    {
+    vtkIceTRenderer *ren = vtkIceTRenderer::SafeDownCast(_ren);
+    if (!ren) continue;
+
+    ren->SetRadixK(k);
+    }
+}
+
+//-----------------------------------------------------------------------------
+
 void vtkIceTRenderManager::SetComposeOperation(int operation)
 {
   vtkDebugMacro("SetComposeOperation to " << operation);
@@ -899,6 +933,7 @@ void vtkIceTRenderManager::CollectRendererInformation(vtkRenderer *_ren,
     }
 
   stream << ren->GetStrategy()
+         << ren->GetRadixK()
          << ren->GetComposeOperation();
 }
 
@@ -917,9 +952,11 @@ bool vtkIceTRenderManager::ProcessRendererInformation(vtkRenderer *_ren,
   if (ren) 
     {
     int strategy;
+    int radix_k;
     int compose_operation;
-    stream >> strategy >> compose_operation;
+    stream >> strategy >> radix_k >> compose_operation;
     ren->SetStrategy(strategy);
+    ren->SetRadixK(radix_k);
     ren->SetComposeOperation(compose_operation);
     }
   return true;
@@ -117,13 +117,15 @@ public:
     VTREE   = vtkIceTConstants::VTREE,
     SPLIT   = vtkIceTConstants::SPLIT,
     SERIAL  = vtkIceTConstants::SERIAL,
-    DIRECT  = vtkIceTConstants::DIRECT
+    DIRECT  = vtkIceTConstants::DIRECT,
+    RADIXK  = vtkIceTConstants::RADIXK
   };
 //ETX
 
   // Description:
   // Methods to set the strategy for all IceT renderers.  The REDUCE strategy,
-  // which is also the default, is a good all-around strategy.
+  // which is also the default, is a good all-around strategy.  The RADIXK
+  // strategy composites a single tile on many processes best.
   virtual void SetStrategy(int strategy);
   virtual void SetStrategy(const char *strategy);
   void SetStrategyToDefault() { this->SetStrategy(DEFAULT); }
@@ -132,6 +134,20 @@ public:
   void SetStrategyToSplit() { this->SetStrategy(SPLIT); }
   void SetStrategyToSerial() { this->SetStrategy(SERIAL); }
   void SetStrategyToDirect() { this->SetStrategy(DIRECT); }
+  void SetStrategyToRadixK() { this->SetStrategy(RADIXK); }
+
+  // Description:
+  // Set the number of processes exchanging image pieces in each round of
+  // the RADIXK strategy for all IceT renderers.  It defaults to 8.
+  virtual void SetRadixK(int k);
+
+  // Description:
+  // Binary swap is the RADIXK strategy with a k of 2.
+  void SetStrategyToBinarySwap()
+    {
+    this->SetStrategy(RADIXK);
+    this->SetRadixK(2);
+    }
 
 //BTX
   enum ComposeOperationType {
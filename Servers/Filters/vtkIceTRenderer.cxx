@@ -59,6 +59,7 @@ vtkIceTRenderer::vtkIceTRenderer()
   this->InIceTRender = 0;
 
   this->Strategy = vtkIceTRenderManager::DEFAULT;
+  this->RadixK = 8;
   this->ComposeOperation = vtkIceTRenderManager::ComposeOperationClosest;
 
   this->SortingKdTree = NULL;
@@ -220,8 +221,10 @@ void vtkIceTRenderer::DeviceRender()
     case vtkIceTRenderManager::SPLIT:  icetStrategy(ICET_STRATEGY_SPLIT); break;
     case vtkIceTRenderManager::SERIAL: icetStrategy(ICET_STRATEGY_SERIAL);break;
     case vtkIceTRenderManager::DIRECT: icetStrategy(ICET_STRATEGY_DIRECT);break;
+    case vtkIceTRenderManager::RADIXK: icetStrategy(ICET_STRATEGY_RADIXK);break;
     default: vtkErrorMacro("Invalid strategy set"); break;
     }
+  icetMagicK(this->RadixK);
   switch (this->ComposeOperation)
     {
     case vtkIceTRenderManager::ComposeOperationClosest:
@@ -675,9 +678,12 @@ void vtkIceTRenderer::PrintSelf(ostream &os, vtkIndent indent)
     case vtkIceTRenderManager::SPLIT:   os << "SPLIT";   break;
     case vtkIceTRenderManager::SERIAL:  os << "SERIAL";  break;
     case vtkIceTRenderManager::DIRECT:  os << "DIRECT";  break;
+    case vtkIceTRenderManager::RADIXK:  os << "RADIXK";  break;
     }
   os << endl;
 
+  os << indent << "RadixK: " << this->RadixK << endl;
+
   os << indent << "Compose Operation: ";
   switch (this->ComposeOperation)
     {
@@ -87,6 +87,15 @@ public:
   void SetStrategyToDirect() {
     this->SetStrategy(vtkIceTRenderManager::DIRECT);
   }
+  void SetStrategyToRadixK() {
+    this->SetStrategy(vtkIceTRenderManager::RADIXK);
+  }
+
+  // Description:
+  // Get/Set the number of processes exchanging image pieces in each round
+  // of the RADIXK strategy.  A k of 2 makes it binary swap.  Defaults to 8.
+  vtkGetMacro(RadixK, int);
+  vtkSetClampMacro(RadixK, int, 2, VTK_LARGE_INTEGER);
 
   // Description:
   // Get/Set to operation to use when composing pixels together.  Note that
@@ -182,6 +191,7 @@ protected:
 
   int CollectDepthBuffer;
   int Strategy;
+  int RadixK;
   int ComposeOperation;
 
   vtkIceTContext *Context;
@@ -31,6 +31,7 @@
 #include "vtkPointData.h"
 #include "vtkPolygon.h"
 #include "vtkProcessModule.h"
+#include "vtkTimerLog.h"
 #include "vtkTriangle.h"
 #include "vtkUnstructuredGrid.h"
 
@@ -426,17 +427,22 @@ int vtkIntegrateAttributes::RequestData(vtkInformation*,
     }
 
   // Here is the trick:  The satellites need a point and vertex to
-  // marshal the attributes.  Node zero needs to receive first...
+  // marshal the attributes.  The results are added along a binary tree of
+  // the processes: each process first receives the sums of its children,
+  // the processes after it whose id differs in one bit below the lowest
+  // set bit of its own, and then sends its sum to its parent.
   int localProcId = 0;
-  // Send results to process 0.
+  int parentProcId = 0;
   if (this->Controller)
     {
     localProcId = this->Controller->GetLocalProcessId();
-    if (localProcId == 0)
+    int numProcs = this->Controller->GetNumberOfProcesses();
+    vtkTimerLog::MarkStartEvent("vtkIntegrateAttributes reduction");
+    int step;
+    for (step = 1; step < numProcs && !(localProcId & step); step *= 2)
       {
-      int numProcs = this->Controller->GetNumberOfProcesses();
-      int id;
-      for (id = 1; id < numProcs; ++id)
+      int id = localProcId + step;
+      if (id < numProcs)
         {
         double msg[5];
         this->Controller->Receive(msg,
@@ -462,6 +468,8 @@ int vtkIntegrateAttributes::RequestData(vtkInformation*,
         tmp = 0;
         }
       }
+    vtkTimerLog::MarkEndEvent("vtkIntegrateAttributes reduction");
+    parentProcId = localProcId - step;
     }
 
   // Generate point and vertex.  Add extra attributes for area too.
@@ -519,8 +527,10 @@ int vtkIntegrateAttributes::RequestData(vtkInformation*,
     msg[2] = this->SumCenter[0];
     msg[3] = this->SumCenter[1];
     msg[4] = this->SumCenter[2];
-    this->Controller->Send(msg, 5, 0, vtkProcessModule::IntegrateAttrInfo);
-    this->Controller->Send(output, 0, vtkProcessModule::IntegrateAttrData);
+    this->Controller->Send(msg, 5, parentProcId,
+                           vtkProcessModule::IntegrateAttrInfo);
+    this->Controller->Send(output, parentProcId,
+                           vtkProcessModule::IntegrateAttrData);
     // Done sending.  Reset output so satellites will have empty data.
     output->Initialize();
     }
@@ -18,6 +18,8 @@
 #include "vtkAppendPolyData.h"
 #include "vtkCellData.h"
 #include "vtkCharArray.h"
+#include "vtkCommunicator.h"
+#include "vtkDataObjectMarshaller.h"
 #include "vtkDataSetReader.h"
 #include "vtkDataSetWriter.h"
 #include "vtkImageAppend.h"
@@ -40,6 +42,7 @@
 #include "vtkUnstructuredGrid.h"
 #include "vtk_zlib.h"
 #include <vtksys/ios/sstream>
+#include <vtkstd/vector>
 #define EXTENT_HEADER_SIZE 360
 
 #ifdef VTK_USE_MPI
@@ -47,6 +50,154 @@
 #include "vtkAllToNRedistributePolyData.h"
 #endif
 
+namespace
+{
+  struct vtkMPIMoveDataSegment
+  {
+    const char* Pointer;
+    vtkIdType Length;
+  };
+
+  // Encodes a data set and collects the memory segments of the message.
+  // Data sets vtkDataObjectMarshaller can handle are not copied; anything
+  // else goes through vtkCommunicator::MarshalDataObject into legacy.
+  vtkIdType vtkMPIMoveDataEncode(vtkDataSet* data,
+    vtkDataObjectMarshaller* marshaller, vtkCharArray* legacy,
+    vtkstd::vector<vtkMPIMoveDataSegment>& segments)
+  {
+    segments.clear();
+    vtkMPIMoveDataSegment segment;
+    if (vtkDataObjectMarshaller::CanMarshal(data) &&
+      marshaller->Marshal(data))
+      {
+      for (int cc=0; cc < marshaller->GetNumberOfSegments(); ++cc)
+        {
+        segment.Pointer = marshaller->GetSegmentPointer(cc);
+        segment.Length = marshaller->GetSegmentLength(cc);
+        segments.push_back(segment);
+        }
+      return marshaller->GetMarshaledLength();
+      }
+
+    vtkCommunicator::MarshalDataObject(data, legacy);
+    segment.Pointer = legacy->GetPointer(0);
+    segment.Length = legacy->GetNumberOfTuples();
+    if (segment.Length > 0)
+      {
+      segments.push_back(segment);
+      }
+    return segment.Length;
+  }
+
+  // Splits the segments of an encoded data set into chunks of at most
+  // chunkSize bytes and compresses them on demand. Uncompressed chunks point
+  // straight into the segments.
+  class vtkMPIMoveDataChunker
+  {
+  public:
+    vtkMPIMoveDataChunker(const vtkstd::vector<vtkMPIMoveDataSegment>& segs,
+                          vtkIdType chunkSize, int level)
+      : Segments(segs), ChunkSize(chunkSize), Level(level),
+        Segment(0), Offset(0)
+      {
+      if (this->Level > 0)
+        {
+        this->Compressed.resize(compressBound(
+            static_cast<uLong>(this->ChunkSize)));
+        }
+      }
+
+    vtkIdType GetNumberOfChunks()
+      {
+      vtkIdType count = 0;
+      for (size_t cc=0; cc < this->Segments.size(); ++cc)
+        {
+        count += (this->Segments[cc].Length + this->ChunkSize - 1) /
+          this->ChunkSize;
+        }
+      return count;
+      }
+
+    // Returns false when all chunks have been produced. The returned data
+    // holds storedLength bytes; storedLength == rawLength means the chunk is
+    // not compressed.
+    bool Next(const char*& data, vtkIdType& storedLength,
+              vtkIdType& rawLength)
+      {
+      while (this->Segment < this->Segments.size() &&
+        this->Offset >= this->Segments[this->Segment].Length)
+        {
+        this->Segment++;
+        this->Offset = 0;
+        }
+      if (this->Segment >= this->Segments.size())
+        {
+        return false;
+        }
+
+      const vtkMPIMoveDataSegment& segment = this->Segments[this->Segment];
+      vtkIdType remaining = segment.Length - this->Offset;
+      rawLength = remaining < this->ChunkSize? remaining : this->ChunkSize;
+      data = segment.Pointer + this->Offset;
+      storedLength = rawLength;
+      this->Offset += rawLength;
+
+      if (this->Level > 0)
+        {
+        uLongf outSize = static_cast<uLongf>(this->Compressed.size());
+        if (compress2(reinterpret_cast<Bytef*>(&this->Compressed[0]), &outSize,
+            reinterpret_cast<const Bytef*>(data),
+            static_cast<uLong>(rawLength), this->Level) == Z_OK &&
+          static_cast<vtkIdType>(outSize) < rawLength)
+          {
+          data = &this->Compressed[0];
+          storedLength = static_cast<vtkIdType>(outSize);
+          }
+        }
+      return true;
+      }
+
+  private:
+    const vtkstd::vector<vtkMPIMoveDataSegment>& Segments;
+    vtkIdType ChunkSize;
+    int Level;
+    size_t Segment;
+    vtkIdType Offset;
+    vtkstd::vector<char> Compressed;
+  };
+
+  // Decodes a complete message produced by vtkMPIMoveDataEncode.
+  int vtkMPIMoveDataDecode(char* message, vtkIdType length, vtkDataSet* data)
+  {
+    if (length == 0)
+      {
+      data->Initialize();
+      return 1;
+      }
+    vtkCharArray* array = vtkCharArray::New();
+    array->SetArray(message, length, 1);
+    int retVal = vtkCommunicator::UnMarshalDataObject(array, data);
+    array->Delete();
+    return retVal;
+  }
+
+  // Copies (or inflates) a chunk to its place in the decoded message.
+  bool vtkMPIMoveDataExpandChunk(const char* stored, vtkIdType storedLength,
+                                 char* dest, vtkIdType rawLength)
+  {
+    if (storedLength == rawLength)
+      {
+      memcpy(dest, stored, rawLength);
+      return true;
+      }
+    uLongf destLen = static_cast<uLongf>(rawLength);
+    return (uncompress(reinterpret_cast<Bytef*>(dest), &destLen,
+        reinterpret_cast<const Bytef*>(stored),
+        static_cast<uLong>(storedLength)) == Z_OK &&
+      static_cast<vtkIdType>(destLen) == rawLength);
+  }
+}
+
 vtkCxxRevisionMacro(vtkMPIMoveData, "$Revision$");
 vtkStandardNewMacro(vtkMPIMoveData);
 
@@ -81,6 +232,10 @@ vtkMPIMoveData::vtkMPIMoveData()
   this->UpdatePiece = 0;
 
   this->DeliverOutlineToClient = 0;
+
+  this->TransportMode = vtkMPIMoveData::STREAMING_TRANSPORT;
+  this->ChunkSize = 4*1024*1024;
+  this->CompressionLevel = 1;
 }
 
 //-----------------------------------------------------------------------------
@@ -642,6 +797,12 @@ void vtkMPIMoveData::DataServerSendToRenderServer(vtkDataSet* output)
     return;
     }
 
+  if (this->TransportMode == vtkMPIMoveData::STREAMING_TRANSPORT)
+    {
+    this->SendDataStream(output, com, 23483);
+    return;
+    }
+
   //int fixme;
   // We might be able to eliminate this marshal.
   this->ClearBuffer();
@@ -664,6 +825,12 @@ void vtkMPIMoveData::RenderServerReceiveFromDataServer(vtkDataSet* output)
     return;
     }
 
+  if (this->TransportMode == vtkMPIMoveData::STREAMING_TRANSPORT)
+    {
+    this->ReceiveDataStream(output, com, 23483);
+    return;
+    }
+
   this->ClearBuffer();
   com->Receive(&(this->NumberOfBuffers), 1, 1, 23480);
   this->BufferLengths = new vtkIdType[this->NumberOfBuffers];
@@ -701,6 +868,12 @@ void vtkMPIMoveData::DataServerZeroSendToRenderServerZero(vtkDataSet* data)
       return;
       }
 
+    if (this->TransportMode == vtkMPIMoveData::STREAMING_TRANSPORT)
+      {
+      this->SendDataStream(data, com, 23483);
+      return;
+      }
+
     //int fixme;
     // We might be able to eliminate this marshal.
     this->ClearBuffer();
@@ -728,6 +901,12 @@ void vtkMPIMoveData::RenderServerZeroReceiveFromDataServerZero(vtkDataSet* data)
       return;
       }
 
+    if (this->TransportMode == vtkMPIMoveData::STREAMING_TRANSPORT)
+      {
+      this->ReceiveDataStream(data, com, 23483);
+      return;
+      }
+
     this->ClearBuffer();
     com->Receive(&(this->NumberOfBuffers), 1, 1, 23480);
     this->BufferLengths = new vtkIdType[this->NumberOfBuffers];
@@ -780,6 +959,14 @@ void vtkMPIMoveData::DataServerSendToClient(vtkDataSet* output)
         }
       }
 
+    if (this->TransportMode == vtkMPIMoveData::STREAMING_TRANSPORT)
+      {
+      this->SendDataStream(tosend,
+        this->ClientDataServerSocketController->GetCommunicator(), 23493);
+      vtkTimerLog::MarkEndEvent("Dataserver sending to client");
+      return;
+      }
+
     this->ClearBuffer();
     this->MarshalDataToBuffer(tosend);
     this->ClientDataServerSocketController->Send(
@@ -804,6 +991,12 @@ void vtkMPIMoveData::ClientReceiveFromDataServer(vtkDataSet* output)
     return;
     }
 
+  if (this->TransportMode == vtkMPIMoveData::STREAMING_TRANSPORT)
+    {
+    this->ReceiveDataStream(output, com, 23493);
+    return;
+    }
+
   this->ClearBuffer();
   com->Receive(&(this->NumberOfBuffers), 1, 1, 23490);
   this->BufferLengths = new vtkIdType[this->NumberOfBuffers];
@@ -911,6 +1104,12 @@ void vtkMPIMoveData::ClearBuffer()
 //-----------------------------------------------------------------------------
 void vtkMPIMoveData::MarshalDataToBuffer(vtkDataSet* data)
 {
+  if (this->TransportMode == vtkMPIMoveData::STREAMING_TRANSPORT)
+    {
+    this->MarshalDataToChunkedBuffer(data);
+    return;
+    }
+
   // Protect from empty data.
   if (data->GetNumberOfPoints() == 0)
     {
@@ -1029,6 +1228,38 @@ void vtkMPIMoveData::ReconstructDataFromBuffer(vtkDataSet* data)
     char* bufferArray = this->Buffers+this->BufferOffsets[idx];
     vtkIdType bufferLength = this->BufferLengths[idx];
 
+    if (this->TransportMode == vtkMPIMoveData::STREAMING_TRANSPORT)
+      {
+      vtkDataSet* piece = data->NewInstance();
+      if (this->ReconstructDataFromChunkedBuffer(bufferArray, bufferLength,
+                                                 piece))
+        {
+        if (appendPd)
+          {
+          appendPd->AddInput(vtkPolyData::SafeDownCast(piece));
+          }
+        else if (appendUg)
+          {
+          appendUg->AddInput(piece);
+          }
+        else if (appendId)
+          {
+          if (piece->GetNumberOfPoints() > 0)
+            {
+            appendId->AddInput(piece);
+            }
+          }
+        else
+          {
+          data->CopyStructure(piece);
+          data->GetPointData()->PassData(piece->GetPointData());
+          data->GetCellData()->PassData(piece->GetCellData());
+          }
+        }
+      piece->Delete();
+      continue;
+      }
+
     vtkIdType zlib_length = bufferLength - 4;
     vtkIdType in_length = 0;
     if (data->IsA("vtkImageData"))
@@ -1142,6 +1373,201 @@ void vtkMPIMoveData::ReconstructDataFromBuffer(vtkDataSet* data)
     }
 }
 
+//-----------------------------------------------------------------------------
+// Chunk stream layout, shared by the socket and buffer variants:
+//   vtkIdType header[2] = { decoded length, number of chunks }
+//   for each chunk:
+//     vtkIdType chunkHeader[2] = { decoded length, stored length }
+//     stored bytes (zlib compressed unless stored == decoded length)
+void vtkMPIMoveData::SendDataStream(vtkDataSet* data, vtkCommunicator* com,
+                                    int tag)
+{
+  if (com == 0)
+    {
+    vtkErrorMacro("Missing communicator.");
+    return;
+    }
+
+  // Protect from empty data: an empty stream is received as empty data.
+  if (data == 0 || data->GetNumberOfPoints() == 0)
+    {
+    vtkIdType emptyHeader[2] = {0, 0};
+    com->Send(emptyHeader, 2, 1, tag);
+    return;
+    }
+
+  vtkTimerLog::MarkStartEvent("Marshal data stream");
+  vtkDataObjectMarshaller* marshaller = vtkDataObjectMarshaller::New();
+  vtkCharArray* legacy = vtkCharArray::New();
+  vtkstd::vector<vtkMPIMoveDataSegment> segments;
+  vtkIdType header[2];
+  header[0] = vtkMPIMoveDataEncode(data, marshaller, legacy, segments);
+  vtkMPIMoveDataChunker chunker(segments, this->ChunkSize,
+                                this->CompressionLevel);
+  header[1] = chunker.GetNumberOfChunks();
+  vtkTimerLog::MarkEndEvent("Marshal data stream");
+
+  com->Send(header, 2, 1, tag);
+
+  const char* chunk;
+  vtkIdType chunkHeader[2];
+  while (chunker.Next(chunk, chunkHeader[1], chunkHeader[0]))
+    {
+    com->Send(chunkHeader, 2, 1, tag);
+    com->Send(chunk, chunkHeader[1], 1, tag);
+    }
+  legacy->Delete();
+  marshaller->Delete();
+}
+
+//-----------------------------------------------------------------------------
+void vtkMPIMoveData::ReceiveDataStream(vtkDataSet* data, vtkCommunicator* com,
+                                       int tag)
+{
+  if (com == 0)
+    {
+    vtkErrorMacro("Missing communicator.");
+    return;
+    }
+
+  vtkIdType header[2] = {0, 0};
+  com->Receive(header, 2, 1, tag);
+
+  vtkstd::vector<char> message(header[0] > 0? header[0] : 1);
+  vtkstd::vector<char> stored;
+  vtkIdType offset = 0;
+  bool valid = true;
+  for (vtkIdType cc=0; cc < header[1]; ++cc)
+    {
+    vtkIdType chunkHeader[2] = {0, 0};
+    com->Receive(chunkHeader, 2, 1, tag);
+    valid = valid && (offset + chunkHeader[0] <= header[0]);
+    if (chunkHeader[1] == chunkHeader[0] && valid)
+      {
+      // Uncompressed chunks are received in place.
+      com->Receive(&message[offset], chunkHeader[1], 1, tag);
+      }
+    else
+      {
+      stored.resize(chunkHeader[1] > 0? chunkHeader[1] : 1);
+      com->Receive(&stored[0], chunkHeader[1], 1, tag);
+      valid = valid && vtkMPIMoveDataExpandChunk(&stored[0], chunkHeader[1],
+                                                 &message[offset],
+                                                 chunkHeader[0]);
+      }
+    offset += chunkHeader[0];
+    }
+
+  if (!valid || offset != header[0])
+    {
+    vtkErrorMacro("Corrupt data stream received.");
+    data->Initialize();
+    return;
+    }
+
+  vtkTimerLog::MarkStartEvent("Unmarshal data stream");
+  vtkMPIMoveDataDecode(&message[0], header[0], data);
+  vtkTimerLog::MarkEndEvent("Unmarshal data stream");
+}
+
+//-----------------------------------------------------------------------------
+void vtkMPIMoveData::MarshalDataToChunkedBuffer(vtkDataSet* data)
+{
+  // Protect from empty data: a buffer with an empty stream is
+  // reconstructed as empty data.
+  if (data->GetNumberOfPoints() == 0)
+    {
+    vtkIdType emptyHeader[2] = {0, 0};
+    char* emptyBuffer = new char[sizeof(emptyHeader)];
+    memcpy(emptyBuffer, emptyHeader, sizeof(emptyHeader));
+    this->NumberOfBuffers = 1;
+    this->BufferLengths = new vtkIdType[1];
+    this->BufferLengths[0] = sizeof(emptyHeader);
+    this->BufferOffsets = new vtkIdType[1];
+    this->BufferOffsets[0] = 0;
+    this->Buffers = emptyBuffer;
+    this->BufferTotalLength = sizeof(emptyHeader);
+    return;
+    }
+
+  vtkDataObjectMarshaller* marshaller = vtkDataObjectMarshaller::New();
+  vtkCharArray* legacy = vtkCharArray::New();
+  vtkstd::vector<vtkMPIMoveDataSegment> segments;
+  vtkIdType header[2];
+  header[0] = vtkMPIMoveDataEncode(data, marshaller, legacy, segments);
+  vtkMPIMoveDataChunker chunker(segments, this->ChunkSize,
+                                this->CompressionLevel);
+  header[1] = chunker.GetNumberOfChunks();
+
+  // Worst case: every chunk is stored uncompressed.
+  vtkIdType maxLength = static_cast<vtkIdType>(sizeof(vtkIdType)) *
+    (2 + 2*header[1]) + header[0];
+  char* buffer = new char[maxLength];
+
+  memcpy(buffer, header, sizeof(header));
+  vtkIdType length = sizeof(header);
+
+  const char* chunk;
+  vtkIdType chunkHeader[2];
+  while (chunker.Next(chunk, chunkHeader[1], chunkHeader[0]))
+    {
+    memcpy(buffer + length, chunkHeader, sizeof(chunkHeader));
+    length += sizeof(chunkHeader);
+    memcpy(buffer + length, chunk, chunkHeader[1]);
+    length += chunkHeader[1];
+    }
+  legacy->Delete();
+  marshaller->Delete();
+
+  this->NumberOfBuffers = 1;
+  this->BufferLengths = new vtkIdType[1];
+  this->BufferLengths[0] = length;
+  this->BufferOffsets = new vtkIdType[1];
+  this->BufferOffsets[0] = 0;
+  this->Buffers = buffer;
+  this->BufferTotalLength = length;
+}
+
+//-----------------------------------------------------------------------------
+int vtkMPIMoveData::ReconstructDataFromChunkedBuffer(const char* buffer,
+                                                     vtkIdType length,
+                                                     vtkDataSet* data)
+{
+  vtkIdType header[2];
+  if (length < static_cast<vtkIdType>(sizeof(header)))
+    {
+    vtkErrorMacro("Corrupt data buffer.");
+    return 0;
+    }
+  memcpy(header, buffer, sizeof(header));
+  vtkIdType pos = sizeof(header);
+
+  vtkstd::vector<char> message(header[0] > 0? header[0] : 1);
+  vtkIdType offset = 0;
+  for (vtkIdType cc=0; cc < header[1]; ++cc)
+    {
+    vtkIdType chunkHeader[2];
+    if (pos + static_cast<vtkIdType>(sizeof(chunkHeader)) > length)
+      {
+      vtkErrorMacro("Corrupt data buffer.");
+      return 0;
+      }
+    memcpy(chunkHeader, buffer + pos, sizeof(chunkHeader));
+    pos += sizeof(chunkHeader);
+    if (pos + chunkHeader[1] > length || offset + chunkHeader[0] > header[0] ||
+      !vtkMPIMoveDataExpandChunk(buffer + pos, chunkHeader[1],
+                                 &message[offset], chunkHeader[0]))
+      {
+      vtkErrorMacro("Corrupt data buffer.");
+      return 0;
+      }
+    pos += chunkHeader[1];
+    offset += chunkHeader[0];
+    }
+
+  return vtkMPIMoveDataDecode(&message[0], header[0], data);
+}
+
 //-----------------------------------------------------------------------------
 void vtkMPIMoveData::PrintSelf(ostream& os, vtkIndent indent)
 {
@@ -1151,6 +1577,9 @@ void vtkMPIMoveData::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "MoveMode: " << this->MoveMode << endl;
   os << indent << "DeliverOutlineToClient : "
     << this->DeliverOutlineToClient << endl;
+  os << indent << "TransportMode: " << this->TransportMode << endl;
+  os << indent << "ChunkSize: " << this->ChunkSize << endl;
+  os << indent << "CompressionLevel: " << this->CompressionLevel << endl;
   os << indent << "OutputDataType: ";
   if (this->OutputDataType == VTK_POLY_DATA)
     {
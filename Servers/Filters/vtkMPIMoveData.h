@@ -23,6 +23,7 @@
 
 #include "vtkDataSetAlgorithm.h"
 
+class vtkCommunicator;
 class vtkMultiProcessController;
 class vtkSocketController;
 class vtkMPIMToNSocketConnection;
@@ -87,7 +88,41 @@ public:
   vtkSetMacro(DeliverOutlineToClient, int);
   vtkGetMacro(DeliverOutlineToClient, int);
 
+  // Description:
+  // Select how data sets are encoded for delivery. LEGACY_TRANSPORT runs
+  // each data set through vtkDataSetWriter/vtkDataSetReader and compresses
+  // the whole string at once. STREAMING_TRANSPORT encodes the array buffers
+  // directly with vtkDataObjectMarshaller and ships them in chunks of
+  // ChunkSize bytes, so point-to-point deliveries (server to client, data
+  // server to render server) never assemble a full copy of the data set
+  // before sending. All processes must use the same mode. The default is
+  // STREAMING_TRANSPORT.
+  vtkSetClampMacro(TransportMode, int, vtkMPIMoveData::LEGACY_TRANSPORT,
+    vtkMPIMoveData::STREAMING_TRANSPORT);
+  vtkGetMacro(TransportMode, int);
+  void SetTransportModeToLegacy()
+    { this->SetTransportMode(vtkMPIMoveData::LEGACY_TRANSPORT); }
+  void SetTransportModeToStreaming()
+    { this->SetTransportMode(vtkMPIMoveData::STREAMING_TRANSPORT); }
+
+  // Description:
+  // Size in bytes of the chunks used by STREAMING_TRANSPORT. Default is 4MB.
+  vtkSetClampMacro(ChunkSize, int, 1024, VTK_LARGE_INTEGER);
+  vtkGetMacro(ChunkSize, int);
+
+  // Description:
+  // zlib compression level (0-9) applied to each chunk by
+  // STREAMING_TRANSPORT. 0 sends the chunks uncompressed. Chunks that do not
+  // shrink are always sent uncompressed. Default is 1.
+  vtkSetClampMacro(CompressionLevel, int, 0, 9);
+  vtkGetMacro(CompressionLevel, int);
+
 //BTX
+  enum TransportModes {
+    LEGACY_TRANSPORT=0,
+    STREAMING_TRANSPORT=1
+  };
+
   enum MoveModes {
     PASS_THROUGH=0,
     COLLECT=1,
@@ -141,6 +176,20 @@ protected:
   void MarshalDataToBuffer(vtkDataSet* data);
   void ReconstructDataFromBuffer(vtkDataSet* data);
 
+  // Description:
+  // Point-to-point delivery used by STREAMING_TRANSPORT. The data set is
+  // sent as a sequence of (optionally compressed) chunks taken directly from
+  // its arrays.
+  void SendDataStream(vtkDataSet* data, vtkCommunicator* com, int tag);
+  void ReceiveDataStream(vtkDataSet* data, vtkCommunicator* com, int tag);
+
+  // Description:
+  // Encode/decode the chunk stream to/from a single buffer. This is used by
+  // the collective (gather, broadcast) paths of STREAMING_TRANSPORT.
+  void MarshalDataToChunkedBuffer(vtkDataSet* data);
+  int ReconstructDataFromChunkedBuffer(const char* buffer, vtkIdType length,
+                                       vtkDataSet* data);
+
   int MoveMode;
   int Server;
 
@@ -154,6 +203,9 @@ protected:
 
   int OutputDataType;
   int DeliverOutlineToClient;
+  int TransportMode;
+  int ChunkSize;
+  int CompressionLevel;
 
 private:
   int UpdateNumberOfPieces;
@@ -204,15 +204,14 @@ int vtkPExtractHistogram::RequestData(vtkInformation *request,
   reduceFilter->SetController(this->Controller);
 
   bool isRoot = (this->Controller->GetLocalProcessId() ==0);
-  if (isRoot)
-    {
-    // PostGatherHelper needs to be set only on the root node.
-    vtkSmartPointer<vtkAttributeDataReductionFilter> rf = 
-      vtkSmartPointer<vtkAttributeDataReductionFilter>::New();
-    rf->SetAttributeType(vtkAttributeDataReductionFilter::ROW_DATA);
-    rf->SetReductionType(vtkAttributeDataReductionFilter::ADD);
-    reduceFilter->SetPostGatherHelper(rf);
-    }
+  // The bins are added, so they can be reduced along a tree of the
+  // processes, which needs the PostGatherHelper on all of them.
+  vtkSmartPointer<vtkAttributeDataReductionFilter> rf = 
+    vtkSmartPointer<vtkAttributeDataReductionFilter>::New();
+  rf->SetAttributeType(vtkAttributeDataReductionFilter::ROW_DATA);
+  rf->SetReductionType(vtkAttributeDataReductionFilter::ADD);
+  reduceFilter->SetPostGatherHelper(rf);
+  reduceFilter->ReduceInTreeOn();
 
   vtkTable* output = vtkTable::GetData(outputVector, 0);
   vtkSmartPointer<vtkTable> copy = vtkSmartPointer<vtkTable>::New();
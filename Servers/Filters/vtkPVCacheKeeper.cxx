@@ -14,7 +14,9 @@
 =========================================================================*/
 #include "vtkPVCacheKeeper.h"
 
+#include "vtkAlgorithmOutput.h"
 #include "vtkCacheSizeKeeper.h"
+#include "vtkCommunicator.h"
 #include "vtkDataObject.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
@@ -22,13 +24,18 @@
 #include "vtkProcessModule.h"
 #include "vtkPVCacheKeeperPipeline.h"
 #include "vtkSmartPointer.h"
+#include "vtkStreamingDemandDrivenPipeline.h"
 
 #include <vtkstd/map>
+#include <vtkstd/vector>
 //----------------------------------------------------------------------------
 class vtkPVCacheKeeper::vtkCacheMap :
-  public vtkstd::map<double, vtkSmartPointer<vtkDataObject> >
+  public vtkstd::map<double, vtkSmartPointer<vtkDataObject> >,
+  public vtkCacheSizeKeeper::Cache
 {
 public:
+  vtkCacheMap(vtkPVCacheKeeper* self) : Self(self) {}
+
   unsigned long GetActualMemorySize() 
     {
     unsigned long actual_size = 0;
@@ -39,17 +46,33 @@ public:
       }
     return actual_size;
     }
+
+  virtual void EvictCacheEntry(double key)
+    {
+    // An entry in use stays in Hit.
+    this->erase(key);
+    }
+
+  virtual void PrefetchCacheEntries(int count)
+    {
+    this->Self->Prefetch(count);
+    }
+
+  vtkPVCacheKeeper* Self;
+
+  // The entry served while UseCache is set.
+  vtkSmartPointer<vtkDataObject> Hit;
 };
 
 vtkStandardNewMacro(vtkPVCacheKeeper);
 vtkCxxRevisionMacro(vtkPVCacheKeeper, "$Revision$");
-vtkCxxSetObjectMacro(vtkPVCacheKeeper, CacheSizeKeeper, vtkCacheSizeKeeper);
 //----------------------------------------------------------------------------
 vtkPVCacheKeeper::vtkPVCacheKeeper()
 {
-  this->Cache = new vtkPVCacheKeeper::vtkCacheMap();
+  this->Cache = new vtkPVCacheKeeper::vtkCacheMap(this);
   this->CacheTime = 0.0;
   this->CachingEnabled = true; 
+  this->UseCache = false;
   this->CacheSizeKeeper = 0;
 
   vtkProcessModule* pm = vtkProcessModule::GetProcessModule();
@@ -73,16 +96,68 @@ vtkPVCacheKeeper::~vtkPVCacheKeeper()
   this->Cache = 0;
 }
 
+//----------------------------------------------------------------------------
+void vtkPVCacheKeeper::SetCacheSizeKeeper(vtkCacheSizeKeeper* keeper)
+{
+  if (this->CacheSizeKeeper == keeper)
+    {
+    return;
+    }
+  if (this->CacheSizeKeeper)
+    {
+    // Forgets the entries registered with the old keeper.
+    this->CacheSizeKeeper->UnregisterCache(this->Cache);
+    this->CacheSizeKeeper->UnRegister(this);
+    }
+  this->CacheSizeKeeper = keeper;
+  if (this->CacheSizeKeeper)
+    {
+    this->CacheSizeKeeper->Register(this);
+    this->CacheSizeKeeper->RegisterCache(this->Cache);
+    }
+  this->Cache->clear();
+  this->Modified();
+}
+
 //----------------------------------------------------------------------------
 void vtkPVCacheKeeper::RemoveAllCaches()
 {
   //cout << "RemoveAllCaches" << endl;
-  unsigned long freed_size = this->Cache->GetActualMemorySize();
+  vtkPVCacheKeeper::vtkCacheMap::iterator iter;
+  for (iter = this->Cache->begin(); iter != this->Cache->end(); ++iter)
+    {
+    if (this->CacheSizeKeeper)
+      {
+      // Tell the cache size keeper about the newly freed memory size.
+      this->CacheSizeKeeper->RemoveCacheEntry(this->Cache, iter->first);
+      }
+    }
   this->Cache->clear();
-  if (freed_size > 0 && this->CacheSizeKeeper)
+  this->Cache->Hit = 0;
+  this->UseCache = false;
+}
+
+//----------------------------------------------------------------------------
+void vtkPVCacheKeeper::SetCacheTime(double cacheTime)
+{
+  if (this->CacheTime != cacheTime)
+    {
+    this->CacheTime = cacheTime;
+    this->UseCache = false;
+    this->Cache->Hit = 0;
+    this->Modified();
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkPVCacheKeeper::SetCachingEnabled(bool enabled)
+{
+  if (this->CachingEnabled != enabled)
     {
-    // Tell the cache size keeper about the newly freed memory size.
-    this->CacheSizeKeeper->FreeCacheSize(freed_size);
+    this->CachingEnabled = enabled;
+    this->UseCache = false;
+    this->Cache->Hit = 0;
+    this->Modified();
     }
 }
 
@@ -94,23 +169,139 @@ bool vtkPVCacheKeeper::IsCached(double cacheTime)
 }
 
 //----------------------------------------------------------------------------
-bool vtkPVCacheKeeper::SaveData(vtkDataObject* output)
+bool vtkPVCacheKeeper::IsCachedOnAllProcesses(double cacheTime)
+{
+  return vtkCacheSizeKeeper::AllReduce(this->IsCached(cacheTime)? 1 : 0,
+    vtkCommunicator::MIN_OP) != 0;
+}
+
+//----------------------------------------------------------------------------
+void vtkPVCacheKeeper::UpdateUseCache()
 {
-  if (!this->CacheSizeKeeper  || !this->CacheSizeKeeper->GetCacheFull())
+  // Processes that use the cache do not update the input, so all processes
+  // must agree or the parallel filters upstream hang. CachingEnabled is the
+  // same on all of them.
+  this->UseCache = this->CachingEnabled &&
+    this->IsCachedOnAllProcesses(this->CacheTime);
+
+  // Other caches may evict the entry before the update uses it.
+  this->Cache->Hit = 0;
+  if (this->UseCache)
     {
-    vtkSmartPointer<vtkDataObject> cache;
-    cache.TakeReference(output->NewInstance());
-    cache->ShallowCopy(output);
-    (*this->Cache)[this->CacheTime] = cache;
+    this->Cache->Hit = (*this->Cache)[this->CacheTime];
+    }
+}
 
+//----------------------------------------------------------------------------
+bool vtkPVCacheKeeper::SaveData(vtkDataObject* output)
+{
+  return this->SaveData(output, this->CacheTime, true);
+}
+
+//----------------------------------------------------------------------------
+bool vtkPVCacheKeeper::SaveData(vtkDataObject* output, double cacheTime,
+  bool allowEviction)
+{
+  vtkSmartPointer<vtkDataObject> cache;
+  cache.TakeReference(output->NewInstance());
+  cache->ShallowCopy(output);
+
+  // The time step may be cached here but not on other processes.
+  if (this->IsCached(cacheTime))
+    {
     if (this->CacheSizeKeeper)
       {
-      // Register used cache size.
-      this->CacheSizeKeeper->AddCacheSize(cache->GetActualMemorySize());
+      this->CacheSizeKeeper->RemoveCacheEntry(this->Cache, cacheTime);
+      }
+    this->Cache->erase(cacheTime);
+    }
+
+  // Register used cache size, the keeper may make room by evicting other
+  // time steps or refuse the data.
+  if (this->CacheSizeKeeper &&
+    !this->CacheSizeKeeper->AddCacheEntry(this->Cache, cacheTime,
+      cache->GetActualMemorySize(), allowEviction))
+    {
+    return false;
+    }
+  (*this->Cache)[cacheTime] = cache;
+  return true;
+}
+
+//----------------------------------------------------------------------------
+void vtkPVCacheKeeper::Prefetch(int count)
+{
+  vtkAlgorithmOutput* port = this->GetNumberOfInputConnections(0) > 0 ?
+    this->GetInputConnection(0, 0) : 0;
+  if (!this->CachingEnabled || !port || count <= 0)
+    {
+    return;
+    }
+  vtkStreamingDemandDrivenPipeline* sddp =
+    vtkStreamingDemandDrivenPipeline::SafeDownCast(
+      port->GetProducer()->GetExecutive());
+  if (!sddp)
+    {
+    return;
+    }
+  int index = port->GetIndex();
+  vtkInformation* info = sddp->GetOutputInformation(index);
+  if (!info->Has(vtkStreamingDemandDrivenPipeline::TIME_STEPS()))
+    {
+    return;
+    }
+
+  // Restore the time requested downstream once done.
+  vtkstd::vector<double> requestedTimeSteps;
+  if (info->Has(vtkStreamingDemandDrivenPipeline::UPDATE_TIME_STEPS()))
+    {
+    double* times =
+      info->Get(vtkStreamingDemandDrivenPipeline::UPDATE_TIME_STEPS());
+    requestedTimeSteps.assign(times, times +
+      info->Length(vtkStreamingDemandDrivenPipeline::UPDATE_TIME_STEPS()));
+    }
+
+  // The input is updated in parallel, so all the processes must take the
+  // same decisions.
+  int numberOfTimeSteps =
+    info->Length(vtkStreamingDemandDrivenPipeline::TIME_STEPS());
+  double* timeSteps = info->Get(vtkStreamingDemandDrivenPipeline::TIME_STEPS());
+  int prefetched = 0;
+  for (int cc = 0; cc < numberOfTimeSteps && prefetched < count; ++cc)
+    {
+    double time = timeSteps[cc];
+    if (time <= this->CacheTime)
+      {
+      continue;
+      }
+    prefetched++;
+    if (this->IsCachedOnAllProcesses(time))
+      {
+      continue;
+      }
+    sddp->SetUpdateTimeStep(index, time);
+    int updated = sddp->Update(index) && sddp->GetOutputData(index);
+    if (!vtkCacheSizeKeeper::AllReduce(updated, vtkCommunicator::MIN_OP))
+      {
+      break;
+      }
+    // Out of budget, prefetching never evicts.
+    int saved = this->SaveData(sddp->GetOutputData(index), time, false);
+    if (!vtkCacheSizeKeeper::AllReduce(saved, vtkCommunicator::MIN_OP))
+      {
+      break;
       }
-    return true;
     }
-  return false;
+
+  if (requestedTimeSteps.empty())
+    {
+    info->Remove(vtkStreamingDemandDrivenPipeline::UPDATE_TIME_STEPS());
+    }
+  else
+    {
+    sddp->SetUpdateTimeSteps(index, &requestedTimeSteps[0],
+      static_cast<int>(requestedTimeSteps.size()));
+    }
 }
 
 //----------------------------------------------------------------------------
@@ -166,14 +357,22 @@ int vtkPVCacheKeeper::RequestData(vtkInformation* vtkNotUsed(reqInfo),
 
   if (this->CachingEnabled)
     {
-    if (this->IsCached(this->CacheTime))
+    if (this->UseCache && this->Cache->Hit)
       {
-      output->ShallowCopy((*this->Cache)[this->CacheTime]);
+      output->ShallowCopy(this->Cache->Hit);
+      if (this->CacheSizeKeeper)
+        {
+        this->CacheSizeKeeper->RecordCacheHit(this->Cache, this->CacheTime);
+        }
       //cout << "using Cache: " << this->CacheTime << endl;
       }
     else
       {
       output->ShallowCopy(input);
+      if (this->CacheSizeKeeper)
+        {
+        this->CacheSizeKeeper->RecordCacheMiss();
+        }
       this->SaveData(output);
       //cout << "Saving cache: " << this->CacheTime << endl;
       }
@@ -190,6 +389,10 @@ int vtkPVCacheKeeper::RequestData(vtkInformation* vtkNotUsed(reqInfo),
 void vtkPVCacheKeeper::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os, indent);
+  os << indent << "CachingEnabled: " << this->CachingEnabled << endl;
+  os << indent << "CacheTime: " << this->CacheTime << endl;
+  os << indent << "UseCache: " << this->UseCache << endl;
+  os << indent << "CacheSizeKeeper: " << this->CacheSizeKeeper << endl;
 }
 
 
@@ -20,6 +20,17 @@
 // then this filter shuts the update request, otherwise propagates the update
 // and then cache the result for later use.  The current time step is set using
 // SetCacheTime().
+//
+// The cached time steps are registered with the vtkCacheSizeKeeper, which
+// may evict them to keep the caches of all representations on the process
+// within its memory budget. vtkCacheSizeKeeper::Prefetch() makes the
+// filter cache the time steps its input provides after CacheTime.
+//
+// On a parallel server, the processes decide together whether an update
+// is served from the cache, as a process that does not update the input
+// would hang the parallel filters upstream. The server manager makes that
+// decision with UpdateUseCache() before the update, the pipeline passes
+// themselves never communicate since they need not run on all processes.
 // .SECTION See Also
 // vtkPVCacheKeeperPipeline
 
@@ -43,8 +54,9 @@ public:
   void RemoveAllCaches();
 
   // Description:
-  // Set/Get the current cache time.
-  vtkSetMacro(CacheTime, double);
+  // Set/Get the current cache time. Setting a new time stops using the
+  // cache until the next UpdateUseCache().
+  void SetCacheTime(double);
   vtkGetMacro(CacheTime, double);
 
   // Description:
@@ -55,8 +67,19 @@ public:
     { return this->IsCached(this->CacheTime); }
 
   // Description:
-  // Get/Set if caching is enabled. Default is true.
-  vtkSetMacro(CachingEnabled, bool);
+  // Decide whether the following updates are served from the cache, which
+  // is the case when caching is enabled and CacheTime is cached on all the
+  // processes. The data cached for CacheTime is then kept until the cache
+  // time changes, even if the cache size keeper evicts it meanwhile. This
+  // must be called on all the processes of the global controller together,
+  // vtkSMRepresentationStrategy does so before updating its pipeline.
+  void UpdateUseCache();
+  vtkGetMacro(UseCache, bool);
+
+  // Description:
+  // Get/Set if caching is enabled. Default is true. Disabling caching
+  // stops using the cache.
+  void SetCachingEnabled(bool);
   vtkGetMacro(CachingEnabled, bool);
   vtkBooleanMacro(CachingEnabled, bool);
 
@@ -81,8 +104,23 @@ protected:
   // Called to save the data in cache. Returns true if data is saved otherwise
   // false.
   bool SaveData(vtkDataObject*);
+  bool SaveData(vtkDataObject*, double cacheTime, bool allowEviction);
+
+  // Description:
+  // Update the input for the count time steps following CacheTime that are
+  // not cached yet, and cache them if they fit without evicting anything.
+  // The update time requested on the input is restored afterwards. Called
+  // through vtkCacheSizeKeeper::Prefetch(), which the server manager
+  // invokes on all processes together.
+  void Prefetch(int count);
+
+  // Description:
+  // Returns if cacheTime is cached on all the processes of the global
+  // controller. Must be called on all of them together.
+  bool IsCachedOnAllProcesses(double cacheTime);
 
   bool CachingEnabled;
+  bool UseCache;
   double CacheTime;
   vtkCacheSizeKeeper* CacheSizeKeeper;
 
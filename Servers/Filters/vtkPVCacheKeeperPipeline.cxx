@@ -34,7 +34,7 @@ int vtkPVCacheKeeperPipeline::ForwardUpstream(
   int i, int j, vtkInformation* request)
 {
   vtkPVCacheKeeper* keeper = vtkPVCacheKeeper::SafeDownCast(this->Algorithm);
-  if (keeper && keeper->GetCachingEnabled() && keeper->IsCached())
+  if (keeper && keeper->GetUseCache())
     {
     // shunt upstream updates when using cache.
     return 1;
@@ -47,7 +47,7 @@ int vtkPVCacheKeeperPipeline::ForwardUpstream(
 int vtkPVCacheKeeperPipeline::ForwardUpstream(vtkInformation* request)
 {
   vtkPVCacheKeeper* keeper = vtkPVCacheKeeper::SafeDownCast(this->Algorithm);
-  if (keeper && keeper->GetCachingEnabled() && keeper->IsCached())
+  if (keeper && keeper->GetUseCache())
     {
     // shunt upstream updates when using cache.
     return 1;
@@ -19,6 +19,7 @@
 #include "vtkWeakPointer.h"
 #include "vtkSocketController.h"
 #include "vtkProcessModule.h"
+#include "vtkDeltaImageCompressor.h"
 #include "vtkImageCompressor.h"
 #include "vtkSquirtCompressor.h"
 #include "vtkZlibImageCompressor.h"
@@ -160,6 +161,11 @@ void vtkPVClientServerRenderManager::ConfigureCompressor(const char *stream)
       comp=vtkZlibImageCompressor::New();
       }
     else
+    if (className=="vtkDeltaImageCompressor")
+      {
+      comp=vtkDeltaImageCompressor::New();
+      }
+    else
     if (className=="NULL")
       {
       this->SetCompressor(0);
@@ -27,6 +27,7 @@
 #include "vtkRendererCollection.h"
 #include "vtkRenderWindow.h"
 
+#include "vtkDeltaImageCompressor.h"
 #include "vtkImageCompressor.h"
 #include "vtkSquirtCompressor.h"
 #include "vtkZlibImageCompressor.h"
@@ -202,6 +203,11 @@ void vtkPVDesktopDeliveryClient::CollectWindowInformation(vtkMultiProcessStream&
 
   winGeoInfo.Id = this->Id;
   winGeoInfo.AnnotationLayer = this->AnnotationLayer;
+
+  // Ask for a whole image when the last one could not be decompressed.
+  vtkDeltaImageCompressor *delta
+    = vtkDeltaImageCompressor::SafeDownCast(this->Compressor);
+  winGeoInfo.KeyFrameRequested = delta && delta->GetKeyFrameRequested(this->Id);
   winGeoInfo.Save(stream);
 }
 
@@ -352,6 +358,12 @@ void vtkPVDesktopDeliveryClient::ReceiveImageFromServer()
           vtkPVDesktopDeliveryServer::IMAGE_TAG);
 
       // Decompress the image.
+      vtkDeltaImageCompressor *delta
+        = vtkDeltaImageCompressor::SafeDownCast(this->Compressor);
+      if (delta)
+        {
+        delta->SetStreamId(this->Id);
+        }
       this->Compressor->SetLossLessMode(this->LossLessCompression);
       this->Compressor->SetInput(this->CompressorBuffer);
       this->Compressor->SetOutput(this->ReducedImage);
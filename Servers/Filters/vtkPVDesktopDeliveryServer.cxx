@@ -29,6 +29,7 @@ PURPOSE.  See the above copyright notice for more information.
 #include "vtkRenderWindow.h"
 #include "vtkSmartPointer.h"
 
+#include "vtkDeltaImageCompressor.h"
 #include "vtkImageCompressor.h"
 #include "vtkSquirtCompressor.h"
 #include "vtkZlibImageCompressor.h"
@@ -293,6 +294,19 @@ bool vtkPVDesktopDeliveryServer::ProcessWindowInformation(
 
   this->UseRendererSet(winGeoInfo.Id);
 
+  // Each view sends its own sequence of images, resynchronized on demand
+  // when the client missed a frame.
+  vtkDeltaImageCompressor *delta
+    = vtkDeltaImageCompressor::SafeDownCast(this->Compressor);
+  if (delta)
+    {
+    delta->SetStreamId(winGeoInfo.Id);
+    if (winGeoInfo.KeyFrameRequested)
+      {
+      delta->RequestKeyFrame(winGeoInfo.Id);
+      }
+    }
+
   return true;
 }
 
@@ -692,7 +706,8 @@ void vtkPVDesktopDeliveryServer::WindowGeometry::Save(vtkMultiProcessStream& str
     << this->GUISize[0] << this->GUISize[1]
     << this->ViewSize[0] << this->ViewSize[1]
     << this->Id
-    << this->AnnotationLayer;
+    << this->AnnotationLayer
+    << this->KeyFrameRequested;
 }
 
 //-----------------------------------------------------------------------------
@@ -708,7 +723,8 @@ bool vtkPVDesktopDeliveryServer::WindowGeometry::Restore(vtkMultiProcessStream&
     >> this->GUISize[0] >> this->GUISize[1]
     >> this->ViewSize[0] >> this->ViewSize[1]
     >> this->Id
-    >> this->AnnotationLayer;
+    >> this->AnnotationLayer
+    >> this->KeyFrameRequested;
   return true;
 }
 
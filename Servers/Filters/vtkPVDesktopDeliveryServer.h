@@ -127,6 +127,7 @@ public:
     int ViewSize[2];
     int Id;
     int AnnotationLayer;
+    int KeyFrameRequested;
     void Save(vtkMultiProcessStream& stream);
     bool Restore(vtkMultiProcessStream& stream);
   };
@@ -24,6 +24,7 @@
 #include "vtkCompositeDataPipeline.h"
 #include "vtkCompositeDataSet.h"
 #include "vtkCompositeDataSet.h"
+#include "vtkCriticalSection.h"
 #include "vtkDataSetSurfaceFilter.h"
 #include "vtkFloatArray.h"
 #include "vtkGarbageCollector.h"
@@ -33,10 +34,12 @@
 #include "vtkHierarchicalBoxDataIterator.h"
 #include "vtkHyperOctree.h"
 #include "vtkHyperOctreeSurfaceFilter.h"
+#include "vtkIdTypeArray.h"
 #include "vtkImageData.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkMultiProcessController.h"
+#include "vtkMultiThreader.h"
 #include "vtkObjectFactory.h"
 #include "vtkOutlineSource.h"
 #include "vtkPointData.h"
@@ -124,6 +127,300 @@ public:
     }
 };
 
+//----------------------------------------------------------------------------
+// The surface extracted from an unstructured grid, with the ids of the
+// points and cells of the grid it comes from and what it was extracted from.
+struct vtkPVGeometryFilterTopology
+{
+  vtkSmartPointer<vtkIdTypeArray> Connectivity;
+  unsigned long ConnectivityMTime;
+  vtkSmartPointer<vtkUnsignedCharArray> CellTypes;
+  unsigned long CellTypesMTime;
+  vtkIdType NumberOfPoints;
+
+  vtkSmartPointer<vtkCellArray> Verts;
+  vtkSmartPointer<vtkCellArray> Lines;
+  vtkSmartPointer<vtkCellArray> Polys;
+  vtkSmartPointer<vtkIdTypeArray> PointIds;
+  vtkSmartPointer<vtkIdTypeArray> CellIds;
+};
+
+//----------------------------------------------------------------------------
+// The topologies kept by the filter, by composite index.  Only the
+// topologies used by an execution are kept for the next one.
+class vtkPVGeometryFilter::vtkTopologyCache
+{
+public:
+  typedef vtkstd::map<unsigned int, vtkPVGeometryFilterTopology> MapType;
+
+  void BeginExecute()
+    {
+    this->Previous.swap(this->Current);
+    this->Current.clear();
+    }
+  void EndExecute()
+    {
+    this->Previous.clear();
+    }
+  vtkPVGeometryFilterTopology* GetTopology(unsigned int index)
+    {
+    MapType::iterator iter = this->Current.find(index);
+    if (iter == this->Current.end())
+      {
+      iter = this->Current.insert(
+        MapType::value_type(index, this->Previous[index])).first;
+      }
+    return &iter->second;
+    }
+
+private:
+  MapType Previous;
+  MapType Current;
+};
+
+//----------------------------------------------------------------------------
+// A block of a composite dataset whose surface is extracted by one of the
+// threads.
+struct vtkPVGeometryFilterBlock
+{
+  vtkDataSet* Input;
+  vtkPolyData* Output;
+  int Extent[6];
+  int WholeExtent[6];
+  vtkPVGeometryFilterTopology* Topology;
+};
+
+//----------------------------------------------------------------------------
+struct vtkPVGeometryFilterThreadStruct
+{
+  vtkPVGeometryFilter* Filter;
+  vtkstd::vector<vtkPVGeometryFilterBlock> Blocks;
+  vtkstd::vector<vtkDataSetSurfaceFilter*> SurfaceFilters;
+  // The next block to extract and the number of blocks extracted, used
+  // by thread 0 to report progress.
+  vtkSimpleCriticalSection Lock;
+  size_t NextBlock;
+  int NumberOfExecutedBlocks;
+  int NumberOfPreviousBlocks;
+  int TotalNumberOfBlocks;
+};
+
+//----------------------------------------------------------------------------
+// Whether array is the array the topology was extracted from.  The same
+// array must not have been modified since, another one must have the same
+// values.
+static int vtkPVGeometryFilterSameArray(vtkDataArray* array,
+                                        vtkDataArray* previous,
+                                        unsigned long previousMTime)
+{
+  if (!array || !previous)
+    {
+    return 0;
+    }
+  if (array == previous)
+    {
+    return array->GetMTime() == previousMTime;
+    }
+  vtkIdType size = array->GetNumberOfTuples()*array->GetNumberOfComponents();
+  return array->GetDataType() == previous->GetDataType() &&
+    size == previous->GetNumberOfTuples()*previous->GetNumberOfComponents() &&
+    memcmp(array->GetVoidPointer(0), previous->GetVoidPointer(0),
+           size*array->GetDataTypeSize()) == 0;
+}
+
+//----------------------------------------------------------------------------
+template <class T>
+void vtkPVGeometryFilterGatherPoints(const T* inPts, T* outPts,
+                                     const vtkIdType* ids, vtkIdType numPts)
+{
+  for (vtkIdType i = 0; i < numPts; i++)
+    {
+    const T* x = inPts + 3*ids[i];
+    outPts[0] = x[0];
+    outPts[1] = x[1];
+    outPts[2] = x[2];
+    outPts += 3;
+    }
+}
+
+//----------------------------------------------------------------------------
+// Build the surface of input from the topology extracted before: the cells
+// are shared with the topology, the points and attributes are gathered
+// from the input.
+static void vtkPVGeometryFilterGatherSurface(
+  vtkUnstructuredGrid* input, vtkPolyData* output,
+  vtkPVGeometryFilterTopology* topology,
+  int passThroughCellIds, int passThroughPointIds)
+{
+  vtkIdType numPts = topology->PointIds->GetNumberOfTuples();
+  vtkIdType numCells = topology->CellIds->GetNumberOfTuples();
+  const vtkIdType* pointIds = topology->PointIds->GetPointer(0);
+  const vtkIdType* cellIds = topology->CellIds->GetPointer(0);
+  vtkIdType i;
+
+  vtkDataArray* inPts = input->GetPoints()->GetData();
+  vtkPoints* newPts = vtkPoints::New();
+  newPts->SetDataType(inPts->GetDataType());
+  newPts->SetNumberOfPoints(numPts);
+  switch (inPts->GetDataType())
+    {
+    vtkTemplateMacro(
+      vtkPVGeometryFilterGatherPoints(
+        static_cast<VTK_TT*>(inPts->GetVoidPointer(0)),
+        static_cast<VTK_TT*>(newPts->GetData()->GetVoidPointer(0)),
+        pointIds, numPts));
+    }
+  output->SetPoints(newPts);
+  newPts->Delete();
+
+  vtkPointData* inputPD = input->GetPointData();
+  vtkPointData* outputPD = output->GetPointData();
+  outputPD->CopyGlobalIdsOn();
+  outputPD->CopyAllocate(inputPD, numPts);
+  for (i = 0; i < numPts; i++)
+    {
+    outputPD->CopyData(inputPD, pointIds[i], i);
+    }
+  vtkCellData* inputCD = input->GetCellData();
+  vtkCellData* outputCD = output->GetCellData();
+  outputCD->CopyGlobalIdsOn();
+  outputCD->CopyAllocate(inputCD, numCells);
+  for (i = 0; i < numCells; i++)
+    {
+    outputCD->CopyData(inputCD, cellIds[i], i);
+    }
+  if (passThroughCellIds)
+    {
+    outputCD->AddArray(topology->CellIds);
+    }
+  if (passThroughPointIds)
+    {
+    outputPD->AddArray(topology->PointIds);
+    }
+
+  output->SetVerts(topology->Verts);
+  output->SetLines(topology->Lines);
+  output->SetPolys(topology->Polys);
+}
+
+//----------------------------------------------------------------------------
+// Extract the surface of input with surfaceFilter.  If topology is not null,
+// the surface is built from it when it was extracted from the same cells,
+// otherwise the topology of the new surface is kept in it.  Only touches
+// input, output, surfaceFilter and topology, so that the surfaces of
+// several grids can be extracted at once with one surface filter each.
+static void vtkPVGeometryFilterUnstructuredGridSurface(
+  vtkUnstructuredGrid* input, vtkPolyData* output,
+  vtkDataSetSurfaceFilter* surfaceFilter,
+  vtkPVGeometryFilterTopology* topology)
+{
+  int passThroughCellIds = surfaceFilter->GetPassThroughCellIds();
+  int passThroughPointIds = surfaceFilter->GetPassThroughPointIds();
+  if (!topology)
+    {
+    surfaceFilter->UnstructuredGridExecute(input, output);
+    return;
+    }
+
+  vtkIdTypeArray* connectivity = input->GetCells()->GetData();
+  vtkUnsignedCharArray* cellTypes = input->GetCellTypesArray();
+  if (topology->Polys &&
+      topology->NumberOfPoints == input->GetNumberOfPoints() &&
+      vtkPVGeometryFilterSameArray(connectivity, topology->Connectivity,
+                                   topology->ConnectivityMTime) &&
+      vtkPVGeometryFilterSameArray(cellTypes, topology->CellTypes,
+                                   topology->CellTypesMTime))
+    {
+    vtkPVGeometryFilterGatherSurface(input, output, topology,
+                                     passThroughCellIds, passThroughPointIds);
+    return;
+    }
+
+  // The ids of the points and cells are needed to gather the surface
+  // later.
+  surfaceFilter->SetPassThroughCellIds(1);
+  surfaceFilter->SetPassThroughPointIds(1);
+  surfaceFilter->UnstructuredGridExecute(input, output);
+  surfaceFilter->SetPassThroughCellIds(passThroughCellIds);
+  surfaceFilter->SetPassThroughPointIds(passThroughPointIds);
+
+  topology->Connectivity = connectivity;
+  topology->ConnectivityMTime = connectivity->GetMTime();
+  topology->CellTypes = cellTypes;
+  topology->CellTypesMTime = cellTypes->GetMTime();
+  topology->NumberOfPoints = input->GetNumberOfPoints();
+  // GetVerts() and GetLines() return an array shared by all polydata when
+  // there are none.
+  topology->Verts = output->GetNumberOfVerts() ? output->GetVerts() : 0;
+  topology->Lines = output->GetNumberOfLines() ? output->GetLines() : 0;
+  topology->Polys = output->GetPolys();
+  topology->PointIds = vtkIdTypeArray::SafeDownCast(
+    output->GetPointData()->GetArray("vtkOriginalPointIds"));
+  topology->CellIds = vtkIdTypeArray::SafeDownCast(
+    output->GetCellData()->GetArray("vtkOriginalCellIds"));
+  if (!passThroughPointIds)
+    {
+    output->GetPointData()->RemoveArray("vtkOriginalPointIds");
+    }
+  if (!passThroughCellIds)
+    {
+    output->GetCellData()->RemoveArray("vtkOriginalCellIds");
+    }
+}
+
+//----------------------------------------------------------------------------
+// Extract the surfaces of the blocks, one block at a time, until there are
+// none left.
+static VTK_THREAD_RETURN_TYPE vtkPVGeometryFilterThreadedExecute(void *arg)
+{
+  vtkMultiThreader::ThreadInfo *info =
+    static_cast<vtkMultiThreader::ThreadInfo *>(arg);
+  vtkPVGeometryFilterThreadStruct *str =
+    static_cast<vtkPVGeometryFilterThreadStruct *>(info->UserData);
+  vtkDataSetSurfaceFilter* surfaceFilter =
+    str->SurfaceFilters[info->ThreadID];
+
+  for (;;)
+    {
+    str->Lock.Lock();
+    size_t blockId = str->NextBlock++;
+    str->Lock.Unlock();
+    if (blockId >= str->Blocks.size())
+      {
+      break;
+      }
+
+    vtkPVGeometryFilterBlock& block = str->Blocks[blockId];
+    if (block.Input->GetNumberOfCells() > 0)
+      {
+      vtkUnstructuredGrid* ugrid =
+        vtkUnstructuredGrid::SafeDownCast(block.Input);
+      if (ugrid)
+        {
+        vtkPVGeometryFilterUnstructuredGridSurface(
+          ugrid, block.Output, surfaceFilter, block.Topology);
+        }
+      else
+        {
+        surfaceFilter->StructuredExecute(block.Input, block.Output,
+                                         block.Extent, block.WholeExtent);
+        }
+      }
+
+    str->Lock.Lock();
+    int numExecuted = ++str->NumberOfExecutedBlocks;
+    str->Lock.Unlock();
+    // Only the thread that called SingleMethodExecute() reports progress.
+    if (info->ThreadID == 0)
+      {
+      str->Filter->UpdateProgress(
+        static_cast<double>(str->NumberOfPreviousBlocks + numExecuted) /
+        str->TotalNumberOfBlocks);
+      }
+    }
+  return VTK_THREAD_RETURN_VALUE;
+}
+
 //----------------------------------------------------------------------------
 vtkPVGeometryFilter::vtkPVGeometryFilter ()
 {
@@ -153,6 +450,12 @@ vtkPVGeometryFilter::vtkPVGeometryFilter ()
   this->ForceUseStrips = 0;
   this->StripModFirstPass = 1;
 
+  this->Threader = vtkMultiThreader::New();
+  this->NumberOfThreads = this->Threader->GetNumberOfThreads();
+
+  this->CacheTopology = 0;
+  this->TopologyCache = new vtkTopologyCache;
+
   this->GetInformation()->Set(vtkAlgorithm::PRESERVES_RANGES(), 1);
   this->GetInformation()->Set(vtkAlgorithm::PRESERVES_BOUNDS(), 1);  
   this->GetInformation()->Set(vtkAlgorithm::PRESERVES_TOPOLOGY(), 1);
@@ -172,6 +475,8 @@ vtkPVGeometryFilter::~vtkPVGeometryFilter ()
   this->OutlineSource->Delete();
   this->InternalProgressObserver->Delete();
   this->SetController(0);
+  this->Threader->Delete();
+  delete this->TopologyCache;
 }
 
 //----------------------------------------------------------------------------
@@ -472,6 +777,8 @@ int vtkPVGeometryFilter::RequestData(vtkInformation* request,
   vtkDataObject* inputDobj = inInfo->Get(vtkDataObject::DATA_OBJECT());
   vtkCompositeDataSet *compInput = 
     vtkCompositeDataSet::SafeDownCast(inputDobj);
+  // Only the topologies used by this execution are kept.
+  this->TopologyCache->BeginExecute();
   if (compInput) 
     {
     vtkGarbageCollector::DeferredCollectionPush();
@@ -482,6 +789,7 @@ int vtkPVGeometryFilter::RequestData(vtkInformation* request,
     vtkTimerLog::MarkEndEvent("vtkPVGeometryFilter::RequestData");
 
     vtkTimerLog::MarkStartEvent("vtkPVGeometryFilter::GarbageCollect");
+    this->TopologyCache->EndExecute();
     vtkGarbageCollector::DeferredCollectionPop();
     vtkTimerLog::MarkEndEvent("vtkPVGeometryFilter::GarbageCollect");
     return 1;
@@ -492,12 +800,18 @@ int vtkPVGeometryFilter::RequestData(vtkInformation* request,
     {
     input = vtkGenericDataSet::SafeDownCast(
       inInfo->Get(vtkDataObject::DATA_OBJECT()));
-    if (!input) {return 0;}
+    if (!input)
+      {
+      this->TopologyCache->EndExecute();
+      return 0;
+      }
     }
 
+  this->CompositeIndex = 0;
   this->ExecuteBlock(input, output, 1);
   this->ExecuteCellNormals(output, 1);
   this->RemoveGhostCells(output);
+  this->TopologyCache->EndExecute();
 
   return 1;
 }
@@ -642,6 +956,14 @@ int vtkPVGeometryFilter::ExecuteCompositeDataSet(
     totNumBlocks++;
     }
 
+  // The surfaces of the unstructured and structured blocks are extracted
+  // by several threads after the other blocks.  The indices are added once
+  // every block has its surface.
+  vtkPVGeometryFilterThreadStruct str;
+  vtkstd::vector<unsigned int> levels;
+  vtkstd::vector<unsigned int> indices;
+  size_t firstOutput = outputs.size();
+
   unsigned int group = 0;
   for (iter->InitTraversal(); !iter->IsDoneWithTraversal(); iter->GoToNextItem(), group++)
     {
@@ -649,29 +971,123 @@ int vtkPVGeometryFilter::ExecuteCompositeDataSet(
     vtkDataObject* block = iter->GetCurrentDataObject();
     
     vtkPolyData* tmpOut = vtkPolyData::New();
-    this->ExecuteBlock(block, tmpOut, 0);
-    //// assert(tmpOut->GetReferenceCount() == 1);
-
     if (hdIter)
       {
-      this->AddHierarchicalIndex(tmpOut, 
-        hdIter->GetCurrentLevel(), hdIter->GetCurrentIndex());
+      levels.push_back(hdIter->GetCurrentLevel());
+      indices.push_back(hdIter->GetCurrentIndex());
       }
     else
       {
-      this->AddCompositeIndex(tmpOut, iter->GetCurrentFlatIndex());
+      indices.push_back(iter->GetCurrentFlatIndex());
       }
-
     outputs.push_back(tmpOut);
 
+    vtkPVGeometryFilterBlock surfaceBlock;
+    if (!this->UseOutline &&
+        this->GetSurfaceBlock(block, surfaceBlock))
+      {
+      surfaceBlock.Output = tmpOut;
+      str.Blocks.push_back(surfaceBlock);
+      continue;
+      }
+
+    this->ExecuteBlock(block, tmpOut, 0);
+    //// assert(tmpOut->GetReferenceCount() == 1);
+
     numInputs++;
     this->UpdateProgress(static_cast<float>(numInputs)/totNumBlocks);
     }
 
+  if (!str.Blocks.empty())
+    {
+    this->OutlineFlag = 0;
+
+    int numThreads = this->NumberOfThreads;
+    if (static_cast<size_t>(numThreads) > str.Blocks.size())
+      {
+      numThreads = static_cast<int>(str.Blocks.size());
+      }
+    str.Filter = this;
+    str.SurfaceFilters.push_back(this->DataSetSurfaceFilter);
+    for (int i = 1; i < numThreads; i++)
+      {
+      vtkDataSetSurfaceFilter* surfaceFilter = vtkDataSetSurfaceFilter::New();
+      surfaceFilter->SetUseStrips(this->DataSetSurfaceFilter->GetUseStrips());
+      surfaceFilter->SetPassThroughCellIds(
+        this->DataSetSurfaceFilter->GetPassThroughCellIds());
+      surfaceFilter->SetPassThroughPointIds(
+        this->DataSetSurfaceFilter->GetPassThroughPointIds());
+      str.SurfaceFilters.push_back(surfaceFilter);
+      }
+    str.NextBlock = 0;
+    str.NumberOfExecutedBlocks = 0;
+    str.NumberOfPreviousBlocks = numInputs;
+    str.TotalNumberOfBlocks = static_cast<int>(totNumBlocks);
+
+    vtkTimerLog::MarkStartEvent("vtkPVGeometryFilter::ThreadedExecute");
+    this->Threader->SetNumberOfThreads(numThreads);
+    this->Threader->SetSingleMethod(vtkPVGeometryFilterThreadedExecute, &str);
+    this->Threader->SingleMethodExecute();
+    vtkTimerLog::MarkEndEvent("vtkPVGeometryFilter::ThreadedExecute");
+
+    for (int i = 1; i < numThreads; i++)
+      {
+      str.SurfaceFilters[i]->Delete();
+      }
+    numInputs += static_cast<int>(str.Blocks.size());
+    }
+
+  for (size_t i = 0; i < indices.size(); i++)
+    {
+    if (hdIter)
+      {
+      this->AddHierarchicalIndex(outputs[firstOutput+i], levels[i], indices[i]);
+      }
+    else
+      {
+      this->AddCompositeIndex(outputs[firstOutput+i], indices[i]);
+      }
+    }
+
   vtkTimerLog::MarkEndEvent("vtkPVGeometryFilter::ExecuteCompositeDataSet");
   return 1;
 }
 
+//----------------------------------------------------------------------------
+int vtkPVGeometryFilter::GetSurfaceBlock(vtkDataObject* input,
+                                         vtkPVGeometryFilterBlock& block)
+{
+  block.Input = vtkDataSet::SafeDownCast(input);
+  block.Topology = 0;
+  if (vtkImageData* image = vtkImageData::SafeDownCast(input))
+    {
+    image->GetExtent(block.Extent);
+    image->GetExtent(block.WholeExtent);
+    return 1;
+    }
+  if (vtkStructuredGrid* sgrid = vtkStructuredGrid::SafeDownCast(input))
+    {
+    sgrid->GetExtent(block.Extent);
+    memcpy(block.WholeExtent, sgrid->GetWholeExtent(), 6*sizeof(int));
+    return 1;
+    }
+  if (vtkRectilinearGrid* rgrid = vtkRectilinearGrid::SafeDownCast(input))
+    {
+    rgrid->GetExtent(block.Extent);
+    memcpy(block.WholeExtent, rgrid->GetWholeExtent(), 6*sizeof(int));
+    return 1;
+    }
+  if (vtkUnstructuredGrid::SafeDownCast(input))
+    {
+    if (this->CacheTopology)
+      {
+      block.Topology = this->TopologyCache->GetTopology(this->CompositeIndex);
+      }
+    return 1;
+    }
+  return 0;
+}
+
 //----------------------------------------------------------------------------
 // We need to change the mapper.  Now it always flat shades when cell normals
 // are available.
@@ -1036,7 +1452,10 @@ void vtkPVGeometryFilter::UnstructuredGridExecute(
     this->OutlineFlag = 0;
     if (input->GetNumberOfCells() > 0)
       {
-      this->DataSetSurfaceFilter->UnstructuredGridExecute(input, output);
+      vtkPVGeometryFilterUnstructuredGridSurface(
+        input, output, this->DataSetSurfaceFilter,
+        this->CacheTopology ?
+        this->TopologyCache->GetTopology(this->CompositeIndex) : 0);
       }
     return;
     }
@@ -1186,6 +1605,9 @@ void vtkPVGeometryFilter::PrintSelf(ostream& os, vtkIndent indent)
      << (this->PassThroughCellIds ? "On\n" : "Off\n");
   os << indent << "PassThroughPointIds: " 
      << (this->PassThroughPointIds ? "On\n" : "Off\n");
+  os << indent << "NumberOfThreads: " << this->NumberOfThreads << endl;
+  os << indent << "CacheTopology: " 
+     << (this->CacheTopology ? "On\n" : "Off\n");
 }
 
 //----------------------------------------------------------------------------
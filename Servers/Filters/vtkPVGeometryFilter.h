@@ -33,10 +33,12 @@ class vtkImageData;
 class vtkInformationVector;
 class vtkCompositeDataSet;
 class vtkMultiProcessController;
+class vtkMultiThreader;
 class vtkOutlineSource;
 class vtkRectilinearGrid;
 class vtkStructuredGrid;
 class vtkUnstructuredGrid;
+struct vtkPVGeometryFilterBlock;
 
 class VTK_EXPORT vtkPVGeometryFilter : public vtkPolyDataAlgorithm
 {
@@ -109,12 +111,36 @@ public:
   vtkGetMacro(MakeOutlineOfInput,int);
   vtkBooleanMacro(MakeOutlineOfInput,int);
 
+  // Description:
+  // Set/Get the number of threads used to extract the surfaces of the
+  // blocks of composite datasets.  The unstructured and structured blocks
+  // are shared among the threads, each thread extracting whole blocks with
+  // its own surface filter.  Defaults to the number of threads of
+  // vtkMultiThreader.
+  vtkSetClampMacro(NumberOfThreads,int,1,VTK_MAX_THREADS);
+  vtkGetMacro(NumberOfThreads,int);
+
+  // Description:
+  // If on, the surfaces extracted from unstructured grids are kept with the
+  // ids of the points and cells they come from.  When the connectivity and
+  // the number of points of a grid (or of the block with the same index
+  // in a composite dataset) are the same at the next execution, as when
+  // only the point coordinates or the attributes change from one time step
+  // to the next, the kept surface is reused and only its points and
+  // attributes are gathered from the input.  A reference to the
+  // connectivity of the grids is kept to compare it with.  The default is
+  // off to conserve memory.
+  vtkSetMacro(CacheTopology,int);
+  vtkGetMacro(CacheTopology,int);
+  vtkBooleanMacro(CacheTopology,int);
+
 //BTX
 protected:
   vtkPVGeometryFilter();
   ~vtkPVGeometryFilter();
 
   class vtkPolyDataVector;
+  class vtkTopologyCache;
 
   virtual int RequestInformation(vtkInformation* request,
                                  vtkInformationVector** inputVector,
@@ -153,6 +179,11 @@ protected:
                               vtkPolyDataVector &outputs,
                               int& numInputs);
 
+  // Description:
+  // Fill block with what the threads need to extract the surface of input
+  // if it is an unstructured or structured dataset.  Returns 0 otherwise.
+  int GetSurfaceBlock(vtkDataObject* input, vtkPVGeometryFilterBlock& block);
+
   void ChangeUseStripsInternal(int val, int force);
 
   int OutlineFlag;
@@ -190,6 +221,12 @@ protected:
   int StripModFirstPass;
   int MakeOutlineOfInput;
 
+  vtkMultiThreader* Threader;
+  int NumberOfThreads;
+
+  int CacheTopology;
+  vtkTopologyCache* TopologyCache;
+
 private:
   vtkPVGeometryFilter(const vtkPVGeometryFilter&); // Not implemented
   void operator=(const vtkPVGeometryFilter&); // Not implemented
@@ -17,16 +17,81 @@
 #include "vtkMapper.h"
 #include "vtkMath.h"
 #include "vtkMatrix4x4.h"
+#include "vtkMultiThreader.h"
+#include "vtkMutexLock.h"
 #include "vtkObjectFactory.h"
+#include "vtkPolyData.h"
+#include "vtkPolyDataMapper.h"
 #include "vtkProperty.h"
+#include "vtkPVQuadricClustering.h"
 #include "vtkRenderWindow.h"
 #include "vtkRenderer.h"
 #include "vtkTexture.h"
 #include "vtkTimerLog.h"
 #include "vtkTransform.h"
 
+#include "vtkSmartPointer.h"
+
+#include <vtkstd/vector>
+
 #include <math.h>
 
+// No coarser level of detail is built with fewer primitives than this.
+#define VTK_PV_LOD_ACTOR_MINIMUM_PRIMITIVES 1000
+
+//-----------------------------------------------------------------------------
+class vtkPVLODActorInternals
+{
+public:
+  // Mappers of the levels of detail, the first one being unused as level 0
+  // is the LODMapper, and their numbers of triangles, line segments and
+  // vertices.
+  vtkstd::vector<vtkSmartPointer<vtkPolyDataMapper> > Mappers;
+  vtkstd::vector<vtkIdType> NumberOfPrimitives;
+
+  // Input of the LODMapper the levels are built from, its modification
+  // time then, and the largest number of levels then.
+  vtkPolyData* Input;
+  unsigned long InputMTime;
+  int MaximumNumberOfLevels;
+
+  // Filters building the levels of detail from a copy of the input, each
+  // taking the output of the previous one, and whether the thread is done
+  // updating them.
+  vtkstd::vector<vtkSmartPointer<vtkPVQuadricClustering> > Filters;
+  vtkSmartPointer<vtkMutexLock> Lock;
+  int Done;
+
+  vtkPVLODActorInternals()
+    {
+    this->Input = 0;
+    this->InputMTime = 0;
+    this->MaximumNumberOfLevels = 0;
+    this->Lock = vtkSmartPointer<vtkMutexLock>::New();
+    this->Done = 0;
+    }
+
+  void ClearLevels()
+    {
+    this->Mappers.clear();
+    this->NumberOfPrimitives.clear();
+    }
+};
+
+//-----------------------------------------------------------------------------
+static VTK_THREAD_RETURN_TYPE vtkPVLODActorBuildLODLevels(void* arg)
+{
+  vtkPVLODActorInternals* internals = static_cast<vtkPVLODActorInternals*>(
+    static_cast<vtkMultiThreader::ThreadInfo*>(arg)->UserData);
+
+  internals->Filters.back()->Update();
+
+  internals->Lock->Lock();
+  internals->Done = 1;
+  internals->Lock->Unlock();
+  return VTK_THREAD_RETURN_VALUE;
+}
+
 //-----------------------------------------------------------------------------
 vtkStandardNewMacro(vtkPVLODActor);
 vtkCxxRevisionMacro(vtkPVLODActor, "$Revision$");
@@ -46,11 +111,21 @@ vtkPVLODActor::vtkPVLODActor()
   this->LODMapper = NULL;
 
   this->EnableLOD = 0;
+
+  this->MaximumNumberOfLODLevels = 4;
+  this->LODLevel = 0;
+  this->SecondsPerPrimitive = 0.0;
+  this->Threader = vtkMultiThreader::New();
+  this->LODThreadId = -1;
+  this->Internals = new vtkPVLODActorInternals;
 }
 
 //----------------------------------------------------------------------------
 vtkPVLODActor::~vtkPVLODActor()
 {
+  this->WaitForLODLevels();
+  delete this->Internals;
+  this->Threader->Delete();
   this->SetLODMapper(NULL);
   this->Device->Delete();
   this->Device = NULL;
@@ -78,6 +153,153 @@ vtkMapper *vtkPVLODActor::SelectMapper()
   return this->Mapper;
 }
 
+//----------------------------------------------------------------------------
+int vtkPVLODActor::GetNumberOfLODLevels()
+{
+  return this->Internals->Mappers.empty()? 1 :
+    static_cast<int>(this->Internals->Mappers.size());
+}
+
+//----------------------------------------------------------------------------
+void vtkPVLODActor::WaitForLODLevels()
+{
+  if (this->LODThreadId == -1)
+    {
+    return;
+    }
+
+  // TerminateThread() joins the thread.
+  vtkPVLODActorInternals* internals = this->Internals;
+  this->Threader->TerminateThread(this->LODThreadId);
+  this->LODThreadId = -1;
+  for (size_t i = 0; i < internals->Filters.size(); i++)
+    {
+    vtkSmartPointer<vtkPolyData> level = vtkSmartPointer<vtkPolyData>::New();
+    level->ShallowCopy(internals->Filters[i]->GetOutput());
+    vtkSmartPointer<vtkPolyDataMapper> mapper =
+      vtkSmartPointer<vtkPolyDataMapper>::New();
+    mapper->SetInput(level);
+    internals->Mappers.push_back(mapper);
+    internals->NumberOfPrimitives.push_back(
+      vtkPVQuadricClustering::GetNumberOfPrimitives(level));
+    }
+  internals->Filters.clear();
+}
+
+//----------------------------------------------------------------------------
+void vtkPVLODActor::UpdateLODLevels()
+{
+  vtkPVLODActorInternals* internals = this->Internals;
+
+  if (this->LODThreadId != -1)
+    {
+    internals->Lock->Lock();
+    int done = internals->Done;
+    internals->Lock->Unlock();
+    if (!done)
+      {
+      return;
+      }
+    this->WaitForLODLevels();
+    }
+
+  vtkPolyData* input = this->LODMapper?
+    vtkPolyData::SafeDownCast(this->LODMapper->GetInput()) : 0;
+  if (input == internals->Input &&
+      (!input || input->GetMTime() == internals->InputMTime) &&
+      this->MaximumNumberOfLODLevels == internals->MaximumNumberOfLevels)
+    {
+    return;
+    }
+
+  // The levels no longer match the geometry.
+  internals->ClearLevels();
+  internals->Input = input;
+  internals->InputMTime = input? input->GetMTime() : 0;
+  internals->MaximumNumberOfLevels = this->MaximumNumberOfLODLevels;
+  this->LODLevel = 0;
+  if (!input || this->MaximumNumberOfLODLevels < 2)
+    {
+    return;
+    }
+
+  vtkIdType numPrimitives =
+    vtkPVQuadricClustering::GetNumberOfPrimitives(input);
+  for (int level = 1; level < this->MaximumNumberOfLODLevels &&
+       numPrimitives/4 >= VTK_PV_LOD_ACTOR_MINIMUM_PRIMITIVES; level++)
+    {
+    numPrimitives /= 4;
+    vtkSmartPointer<vtkPVQuadricClustering> filter =
+      vtkSmartPointer<vtkPVQuadricClustering>::New();
+    filter->SetMaximumNumberOfTriangles(static_cast<int>(numPrimitives));
+    filter->UseInputPointsOn();
+    filter->CopyCellDataOn();
+    if (internals->Filters.empty())
+      {
+      // The thread works on a copy, as the input may be updated by the
+      // pipeline in the meantime.
+      vtkSmartPointer<vtkPolyData> copy = vtkSmartPointer<vtkPolyData>::New();
+      copy->DeepCopy(input);
+      filter->SetInput(copy);
+      }
+    else
+      {
+      filter->SetInputConnection(internals->Filters.back()->GetOutputPort());
+      }
+    internals->Filters.push_back(filter);
+    }
+  if (internals->Filters.empty())
+    {
+    return;
+    }
+
+  internals->Mappers.push_back(0);
+  internals->NumberOfPrimitives.push_back(
+    vtkPVQuadricClustering::GetNumberOfPrimitives(input));
+  internals->Done = 0;
+  this->LODThreadId = this->Threader->SpawnThread(
+    vtkPVLODActorBuildLODLevels, internals);
+}
+
+//----------------------------------------------------------------------------
+vtkMapper *vtkPVLODActor::SelectLODLevelMapper()
+{
+  this->UpdateLODLevels();
+
+  // Use the finest level expected to render in the allocated time, or the
+  // coarsest one.
+  vtkPVLODActorInternals* internals = this->Internals;
+  int numLevels = static_cast<int>(internals->Mappers.size());
+  this->LODLevel = 0;
+  if (numLevels < 2 || this->SecondsPerPrimitive <= 0.0)
+    {
+    return this->LODMapper;
+    }
+  while (this->LODLevel < numLevels - 1 &&
+         internals->NumberOfPrimitives[this->LODLevel]*this->SecondsPerPrimitive >
+         this->AllocatedRenderTime)
+    {
+    this->LODLevel++;
+    }
+  if (this->LODLevel == 0)
+    {
+    return this->LODMapper;
+    }
+
+  // Color the level as the LODMapper, without changing its input.
+  vtkPolyDataMapper* mapper = internals->Mappers[this->LODLevel];
+  mapper->vtkMapper::ShallowCopy(this->LODMapper);
+  vtkPolyDataMapper* lodMapper =
+    vtkPolyDataMapper::SafeDownCast(this->LODMapper);
+  if (lodMapper)
+    {
+    mapper->SetPiece(lodMapper->GetPiece());
+    mapper->SetNumberOfPieces(lodMapper->GetNumberOfPieces());
+    mapper->SetGhostLevel(lodMapper->GetGhostLevel());
+    }
+  return mapper;
+}
+
 //----------------------------------------------------------------------------
 void vtkPVLODActor::Render(vtkRenderer *ren, vtkMapper *vtkNotUsed(m))
 {
@@ -96,6 +318,12 @@ void vtkPVLODActor::Render(vtkRenderer *ren, vtkMapper *vtkNotUsed(m))
     {
     return;
     }
+
+  int lod = (mapper == this->LODMapper);
+  if (lod)
+    {
+    mapper = this->SelectLODLevelMapper();
+    }
     
   /* render the property */
   if (!this->Property)
@@ -131,6 +359,16 @@ void vtkPVLODActor::Render(vtkRenderer *ren, vtkMapper *vtkNotUsed(m))
   this->Property->PostRender(this, ren);
   this->EstimatedRenderTime = mapper->GetTimeToDraw();
 
+  if (lod)
+    {
+    // Measure the time per primitive for the next frame, and build the
+    // levels of detail of the input just updated by the LODMapper.
+    vtkIdType numPrimitives = this->Internals->Mappers.empty()?
+      0 : this->Internals->NumberOfPrimitives[this->LODLevel];
+    this->SecondsPerPrimitive = numPrimitives > 0?
+      this->EstimatedRenderTime/numPrimitives : 0.0;
+    this->UpdateLODLevels();
+    }
 }
 
 int vtkPVLODActor::RenderOpaqueGeometry(vtkViewport *vp)
@@ -184,6 +422,13 @@ void vtkPVLODActor::ReleaseGraphicsResources(vtkWindow *renWin)
     {
     this->LODMapper->ReleaseGraphicsResources(renWin);
     }
+  for (size_t i = 1; i < this->Internals->Mappers.size(); i++)
+    {
+    if (this->Internals->Mappers[i])
+      {
+      this->Internals->Mappers[i]->ReleaseGraphicsResources(renWin);
+      }
+    }
 }
 
 
@@ -291,6 +536,7 @@ void vtkPVLODActor::ShallowCopy(vtkProp *prop)
   if ( a != NULL )
     {
     this->SetLODMapper(a->GetLODMapper());
+    this->SetMaximumNumberOfLODLevels(a->GetMaximumNumberOfLODLevels());
     }
 
   // Now do superclass
@@ -308,4 +554,7 @@ void vtkPVLODActor::PrintSelf(ostream& os, vtkIndent indent)
     }
 
   os << indent << "EnableLOD: " << this->EnableLOD << endl;
+  os << indent << "MaximumNumberOfLODLevels: "
+     << this->MaximumNumberOfLODLevels << endl;
+  os << indent << "LODLevel: " << this->LODLevel << endl;
 }
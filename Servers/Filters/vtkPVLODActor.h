@@ -18,6 +18,15 @@
 // vtkLODActor and vtkLODProp3D can get confused, and substitute
 // LOD mappers when they are not needed.  This just has two mappers:
 // full res and LOD, and this actor knows which is which.
+//
+// When the input of the LODMapper is polydata with many triangles, line
+// segments or vertices, coarser levels of detail are built from it with
+// vtkPVQuadricClustering, every level with a quarter of the primitives of
+// the previous one. They are built on a separate thread once per change of
+// that input, and are used once they are all built. Every frame rendered
+// with the LODMapper picks the finest level expected to render in the
+// AllocatedRenderTime of the actor, from the time per primitive measured on
+// the previous one.
 
 // .SECTION see also
 // vtkActor vtkRenderer vtkLODProp3D vtkLODActor
@@ -28,6 +37,8 @@
 #include "vtkActor.h"
 
 class vtkMapper;
+class vtkMultiThreader;
+class vtkPVLODActorInternals;
 
 class VTK_EXPORT vtkPVLODActor : public vtkActor
 {
@@ -81,6 +92,25 @@ public:
   vtkSetMacro(EnableLOD, int);
   vtkGetMacro(EnableLOD, int);
 
+  // Description:
+  // Set/Get the largest number of levels of detail, counting the LODMapper.
+  // Set to 1 to only use the LODMapper. The default is 4.
+  vtkSetClampMacro(MaximumNumberOfLODLevels, int, 1, VTK_LARGE_INTEGER);
+  vtkGetMacro(MaximumNumberOfLODLevels, int);
+
+  // Description:
+  // Returns the number of levels of detail built, counting the LODMapper,
+  // and the one used by the last frame rendered with the LODMapper, 0 being
+  // the LODMapper.
+  int GetNumberOfLODLevels();
+  vtkGetMacro(LODLevel, int);
+
+  // Description:
+  // Waits until the levels of detail being built are done, and takes them.
+  // They are otherwise taken by the first frame rendered with the LODMapper
+  // after they are done.
+  void WaitForLODLevels();
+
 protected:
   vtkPVLODActor();
   ~vtkPVLODActor();
@@ -89,9 +119,32 @@ protected:
 
   vtkMapper *SelectMapper();
 
+  // Description:
+  // Returns the mapper of the level of detail to render instead of the
+  // LODMapper.
+  vtkMapper *SelectLODLevelMapper();
+
+  // Description:
+  // Takes the levels of detail once built, and starts building them again
+  // when the input of the LODMapper changed.
+  void UpdateLODLevels();
+
   int EnableLOD;
 
+  int MaximumNumberOfLODLevels;
+  int LODLevel;
+
+  // Time taken to render a triangle, line segment or vertex by the last
+  // frame rendered with the LODMapper, or 0 when not known.
+  double SecondsPerPrimitive;
+
+  // Builds the levels of detail, on thread LODThreadId when it is not -1.
+  vtkMultiThreader *Threader;
+  int LODThreadId;
+
 private:
+  vtkPVLODActorInternals *Internals;
+
   vtkPVLODActor(const vtkPVLODActor&); // Not implemented.
   void operator=(const vtkPVLODActor&); // Not implemented.
 };
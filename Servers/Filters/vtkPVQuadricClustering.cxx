@@ -0,0 +1,364 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    $RCSfile$
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkPVQuadricClustering.h"
+
+#include "vtkCellArray.h"
+#include "vtkInformation.h"
+#include "vtkInformationVector.h"
+#include "vtkObjectFactory.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkSmartPointer.h"
+#include "vtkStreamingDemandDrivenPipeline.h"
+
+#include <vtkstd/algorithm>
+#include <vtkstd/vector>
+
+#include <math.h>
+
+// Number of input points binned to estimate the number of divisions.
+#define VTK_PV_QUADRIC_CLUSTERING_SAMPLES 262144
+
+// Resolution, along the longest side of the bounds, of the finer of the two
+// binnings of the sample.
+#define VTK_PV_QUADRIC_CLUSTERING_PROBE 64
+
+// Number of times an output with too many primitives is clustered again.
+#define VTK_PV_QUADRIC_CLUSTERING_RETRIES 3
+
+vtkStandardNewMacro(vtkPVQuadricClustering);
+vtkCxxRevisionMacro(vtkPVQuadricClustering, "$Revision$");
+
+//----------------------------------------------------------------------------
+// Divisions of the bounds into cubes, resolution of them along the longest
+// side.
+static void vtkPVQuadricClusteringCubicDivisions(const double length[3],
+  double resolution, int divisions[3])
+{
+  double maxLength = vtkstd::max(length[0], vtkstd::max(length[1], length[2]));
+  for (int i = 0; i < 3; i++)
+    {
+    double div = maxLength > 0.0? resolution*length[i]/maxLength : 1.0;
+    divisions[i] = div < 1.0? 1 : (div > VTK_LARGE_INTEGER? VTK_LARGE_INTEGER :
+      static_cast<int>(div + 0.5));
+    }
+}
+
+//----------------------------------------------------------------------------
+// Number of bins occupied by the sampled points.
+static vtkIdType vtkPVQuadricClusteringCountBins(
+  const vtkstd::vector<double>& samples, const double bounds[6],
+  const int divisions[3])
+{
+  double step[3];
+  for (int i = 0; i < 3; i++)
+    {
+    double length = bounds[2*i+1] - bounds[2*i];
+    step[i] = length > 0.0? divisions[i]/length : 0.0;
+    }
+
+  vtkstd::vector<vtkIdType> bins;
+  bins.reserve(samples.size()/3);
+  for (size_t cc = 0; cc < samples.size(); cc += 3)
+    {
+    vtkIdType binId = 0;
+    for (int i = 2; i >= 0; i--)
+      {
+      int index = static_cast<int>((samples[cc+i] - bounds[2*i])*step[i]);
+      index = index < 0? 0 : (index >= divisions[i]? divisions[i]-1 : index);
+      binId = binId*divisions[i] + index;
+      }
+    bins.push_back(binId);
+    }
+  vtkstd::sort(bins.begin(), bins.end());
+  return static_cast<vtkIdType>(
+    vtkstd::unique(bins.begin(), bins.end()) - bins.begin());
+}
+
+//----------------------------------------------------------------------------
+vtkPVQuadricClustering::vtkPVQuadricClustering()
+{
+  this->MaximumNumberOfTriangles = 0;
+  this->MaximumNumberOfBins = 160*160*160;
+}
+
+//----------------------------------------------------------------------------
+vtkPVQuadricClustering::~vtkPVQuadricClustering()
+{
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkPVQuadricClustering::GetNumberOfTriangles(vtkPolyData* input)
+{
+  // A polygon or strip of n points makes n-2 triangles, and takes n+1
+  // entries in its cell array.
+  vtkIdType numTriangles = 0;
+  vtkCellArray* cells[2] = { input->GetPolys(), input->GetStrips() };
+  for (int i = 0; i < 2; i++)
+    {
+    if (cells[i])
+      {
+      numTriangles += cells[i]->GetNumberOfConnectivityEntries()
+        - 3*cells[i]->GetNumberOfCells();
+      }
+    }
+  return numTriangles;
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkPVQuadricClustering::GetNumberOfPrimitives(vtkPolyData* input)
+{
+  // A line of n points makes n-1 segments and a vertex cell of n points n
+  // vertices, out of n+1 entries in their cell arrays.
+  vtkIdType numPrimitives = vtkPVQuadricClustering::GetNumberOfTriangles(input);
+  vtkCellArray* lines = input->GetLines();
+  if (lines)
+    {
+    numPrimitives += lines->GetNumberOfConnectivityEntries()
+      - 2*lines->GetNumberOfCells();
+    }
+  vtkCellArray* verts = input->GetVerts();
+  if (verts)
+    {
+    numPrimitives += verts->GetNumberOfConnectivityEntries()
+      - verts->GetNumberOfCells();
+    }
+  return numPrimitives;
+}
+
+//----------------------------------------------------------------------------
+double vtkPVQuadricClustering::EstimateNumberOfDivisions(vtkPolyData* input,
+  vtkIdType numPrimitives, int divisions[3])
+{
+  double bounds[6], length[3];
+  input->GetBounds(bounds);
+  for (int i = 0; i < 3; i++)
+    {
+    length[i] = bounds[2*i+1] - bounds[2*i];
+    }
+
+  // Sample the points evenly through the point list.
+  vtkPoints* points = input->GetPoints();
+  vtkIdType numPts = points->GetNumberOfPoints();
+  vtkIdType stride = numPts/VTK_PV_QUADRIC_CLUSTERING_SAMPLES + 1;
+  vtkstd::vector<double> samples;
+  samples.reserve(3*(numPts/stride + 1));
+  double x[3];
+  for (vtkIdType cc = 0; cc < numPts; cc += stride)
+    {
+    points->GetPoint(cc, x);
+    samples.insert(samples.end(), x, x + 3);
+    }
+
+  // Count the occupied bins at two resolutions to find how their number
+  // grows: as the square of the resolution for a surface, linearly for
+  // lines.
+  int coarse[3], fine[3];
+  vtkPVQuadricClusteringCubicDivisions(length,
+    VTK_PV_QUADRIC_CLUSTERING_PROBE/2, coarse);
+  vtkPVQuadricClusteringCubicDivisions(length,
+    VTK_PV_QUADRIC_CLUSTERING_PROBE, fine);
+  double coarseBins = static_cast<double>(
+    vtkPVQuadricClusteringCountBins(samples, bounds, coarse));
+  double fineBins = static_cast<double>(
+    vtkPVQuadricClusteringCountBins(samples, bounds, fine));
+
+  double dimension = 2.0;
+  if (coarseBins > 0.0 && fineBins > coarseBins)
+    {
+    dimension = log(fineBins/coarseBins)/log(2.0);
+    dimension = dimension < 1.0? 1.0 : (dimension > 3.0? 3.0 : dimension);
+    }
+
+  // The output has a point per occupied bin. A surface has about twice as
+  // many triangles as points, lines and verts about as many segments and
+  // vertices as points.
+  double numTriangles = static_cast<double>(
+    vtkPVQuadricClustering::GetNumberOfTriangles(input));
+  double inputPrimitives = static_cast<double>(
+    vtkPVQuadricClustering::GetNumberOfPrimitives(input));
+  double targetBins = static_cast<double>(numPrimitives)*
+    inputPrimitives/(inputPrimitives + numTriangles);
+  double resolution = VTK_PV_QUADRIC_CLUSTERING_PROBE;
+  if (fineBins > 0.0)
+    {
+    resolution *= pow(targetBins/fineBins, 1.0/dimension);
+    }
+  vtkPVQuadricClusteringCubicDivisions(length, resolution, divisions);
+
+  // Keep the bins in memory.
+  double numBins = static_cast<double>(divisions[0])*divisions[1]*divisions[2];
+  while (numBins > this->MaximumNumberOfBins && resolution > 1.0)
+    {
+    resolution *= 0.95*pow(this->MaximumNumberOfBins/numBins, 1.0/3.0);
+    vtkPVQuadricClusteringCubicDivisions(length, resolution, divisions);
+    numBins = static_cast<double>(divisions[0])*divisions[1]*divisions[2];
+    }
+
+  vtkDebugMacro("Estimated dimension " << dimension << ", "
+    << divisions[0] << "x" << divisions[1] << "x" << divisions[2]
+    << " divisions for " << numPrimitives << " primitives.");
+  return dimension;
+}
+
+//----------------------------------------------------------------------------
+void vtkPVQuadricClustering::Cluster(vtkPolyData* input, int divisions[3],
+  vtkPolyData* output)
+{
+  // Cluster a shallow copy, so that the pipeline of the input is not
+  // updated by the clustering.
+  vtkSmartPointer<vtkPolyData> inputCopy = vtkSmartPointer<vtkPolyData>::New();
+  inputCopy->ShallowCopy(input);
+
+  vtkSmartPointer<vtkQuadricClustering> clustering =
+    vtkSmartPointer<vtkQuadricClustering>::New();
+  clustering->SetInput(inputCopy);
+  clustering->SetNumberOfDivisions(divisions);
+  clustering->SetAutoAdjustNumberOfDivisions(
+    this->AutoAdjustNumberOfDivisions);
+  clustering->SetUseInputPoints(this->UseInputPoints);
+  clustering->SetUseFeatureEdges(this->UseFeatureEdges);
+  clustering->SetUseFeaturePoints(this->UseFeaturePoints);
+  clustering->SetFeaturePointsAngle(this->FeaturePointsAngle);
+  clustering->SetUseInternalTriangles(this->UseInternalTriangles);
+  clustering->SetCopyCellData(this->CopyCellData);
+  clustering->SetPreventDuplicateCells(this->PreventDuplicateCells);
+  clustering->Update();
+
+  output->ShallowCopy(clustering->GetOutput());
+}
+
+//----------------------------------------------------------------------------
+int vtkPVQuadricClustering::RequestData(vtkInformation* request,
+  vtkInformationVector** inputVector, vtkInformationVector* outputVector)
+{
+  if (this->MaximumNumberOfTriangles <= 0)
+    {
+    return this->Superclass::RequestData(request, inputVector, outputVector);
+    }
+
+  vtkInformation* inInfo = inputVector[0]->GetInformationObject(0);
+  vtkInformation* outInfo = outputVector->GetInformationObject(0);
+  vtkPolyData* input = 0;
+  if (inInfo)
+    {
+    input = vtkPolyData::SafeDownCast(
+      inInfo->Get(vtkDataObject::DATA_OBJECT()));
+    }
+  vtkPolyData* output = vtkPolyData::SafeDownCast(
+    outInfo->Get(vtkDataObject::DATA_OBJECT()));
+  if (!input || input->GetNumberOfPoints() == 0)
+    {
+    return 1;
+    }
+
+  // Every piece gets its share of the primitives.
+  vtkIdType maxPrimitives = this->MaximumNumberOfTriangles;
+  int numPieces = outInfo->Get(
+    vtkStreamingDemandDrivenPipeline::UPDATE_NUMBER_OF_PIECES());
+  if (numPieces > 1)
+    {
+    maxPrimitives = vtkstd::max<vtkIdType>(maxPrimitives/numPieces, 1);
+    }
+
+  vtkIdType numPrimitives =
+    vtkPVQuadricClustering::GetNumberOfPrimitives(input);
+  if (numPrimitives <= maxPrimitives)
+    {
+    vtkDebugMacro("Passing " << numPrimitives << " primitives through.");
+    output->ShallowCopy(input);
+    return 1;
+    }
+
+  int divisions[3];
+  double dimension =
+    this->EstimateNumberOfDivisions(input, maxPrimitives, divisions);
+  this->Cluster(input, divisions, output);
+  numPrimitives = vtkPVQuadricClustering::GetNumberOfPrimitives(output);
+
+  // The estimate may be off for data that is not a closed surface. Cluster
+  // the input again, scaling the divisions by the error, when the output
+  // has too many primitives or less than half of them. Clustering the
+  // output instead would be cheaper, but its bins do not line up with the
+  // new ones and it loses far more primitives than asked for. The number of
+  // primitives grows as the number of occupied bins at first, and then as
+  // measured between the last two clusterings: many lines through the same
+  // bins make more segments per bin at coarser resolutions.
+  vtkSmartPointer<vtkPolyData> result = vtkSmartPointer<vtkPolyData>::New();
+  for (int retry = 0; retry < VTK_PV_QUADRIC_CLUSTERING_RETRIES &&
+       (numPrimitives > maxPrimitives || 2*numPrimitives < maxPrimitives);
+       retry++)
+    {
+    this->UpdateProgress(static_cast<double>(retry + 1)/
+                         (VTK_PV_QUADRIC_CLUSTERING_RETRIES + 1));
+    if (numPrimitives <= maxPrimitives)
+      {
+      result->ShallowCopy(output);
+      }
+    double factor = 0.95*pow(static_cast<double>(maxPrimitives)/
+      vtkstd::max<vtkIdType>(numPrimitives, 1), 1.0/dimension);
+    int newDivisions[3];
+    double numBins = 1.0;
+    int longest = 0;
+    for (int i = 0; i < 3; i++)
+      {
+      newDivisions[i] = vtkstd::max(static_cast<int>(divisions[i]*factor), 1);
+      numBins *= newDivisions[i];
+      longest = divisions[i] > divisions[longest]? i : longest;
+      }
+    if (numBins > this->MaximumNumberOfBins ||
+        (newDivisions[0] == divisions[0] && newDivisions[1] == divisions[1] &&
+         newDivisions[2] == divisions[2]))
+      {
+      break;
+      }
+    vtkDebugMacro("Got " << numPrimitives << " primitives, clustering again with "
+      << newDivisions[0] << "x" << newDivisions[1] << "x" << newDivisions[2]
+      << " divisions.");
+    double scale = static_cast<double>(newDivisions[longest])/
+      divisions[longest];
+    vtkIdType previousPrimitives = numPrimitives;
+    for (int i = 0; i < 3; i++)
+      {
+      divisions[i] = newDivisions[i];
+      }
+    this->Cluster(input, divisions, output);
+    numPrimitives = vtkPVQuadricClustering::GetNumberOfPrimitives(output);
+    if (numPrimitives > 0 && numPrimitives != previousPrimitives &&
+        scale != 1.0)
+      {
+      dimension = log(static_cast<double>(numPrimitives)/previousPrimitives)/
+        log(scale);
+      dimension = dimension < 0.5? 0.5 : (dimension > 3.0? 3.0 : dimension);
+      }
+    }
+
+  // Going back to a finer output may have exceeded the budget.
+  if (numPrimitives > maxPrimitives && result->GetNumberOfPoints() > 0)
+    {
+    output->ShallowCopy(result);
+    }
+
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+void vtkPVQuadricClustering::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "MaximumNumberOfTriangles: "
+     << this->MaximumNumberOfTriangles << endl;
+  os << indent << "MaximumNumberOfBins: " << this->MaximumNumberOfBins << endl;
+}
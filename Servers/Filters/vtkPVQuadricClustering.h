@@ -0,0 +1,103 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    $RCSfile$
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkPVQuadricClustering - quadric clustering to a number of triangles
+// .SECTION Description
+// vtkPVQuadricClustering is the vtkQuadricClustering ParaView uses to
+// make LOD geometry. When MaximumNumberOfTriangles is set, the number of
+// divisions is not fixed but chosen for the output to have at most about
+// that many triangles, line segments and vertices together:
+// \li an input that already has no more of them is passed through;
+// \li the bins are cubes, so flat or long data gets more bins along its
+// long sides;
+// \li the number of divisions is estimated by binning a sample of the input
+// points at two resolutions, which tells how many bins are occupied and how
+// that number grows with the resolution (as its square for a surface);
+// \li an output that still has too many of them is clustered again with
+// fewer divisions.
+// When the output is requested in pieces, every piece gets its share of
+// them. MaximumNumberOfBins bounds the memory used by the bins.
+// When MaximumNumberOfTriangles is 0, NumberOfDivisions is used as in
+// vtkQuadricClustering.
+// .SECTION See Also
+// vtkQuadricClustering vtkPVLODActor
+
+#ifndef __vtkPVQuadricClustering_h
+#define __vtkPVQuadricClustering_h
+
+#include "vtkQuadricClustering.h"
+
+class VTK_EXPORT vtkPVQuadricClustering : public vtkQuadricClustering
+{
+public:
+  static vtkPVQuadricClustering* New();
+  vtkTypeRevisionMacro(vtkPVQuadricClustering, vtkQuadricClustering);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  // Description:
+  // Set/Get the number of triangles the output should not exceed. Line
+  // segments and vertices count as triangles, so that lines and point
+  // clouds are decimated too. The number of divisions is computed from it
+  // unless it is 0, which is the default.
+  vtkSetClampMacro(MaximumNumberOfTriangles, int, 0, VTK_LARGE_INTEGER);
+  vtkGetMacro(MaximumNumberOfTriangles, int);
+
+  // Description:
+  // Set/Get the largest number of bins used when the number of divisions is
+  // computed from MaximumNumberOfTriangles. Every bin takes about 80 bytes.
+  // The default is 160^3, the finest resolution the LOD settings allow.
+  vtkSetClampMacro(MaximumNumberOfBins, int, 1, VTK_LARGE_INTEGER);
+  vtkGetMacro(MaximumNumberOfBins, int);
+
+  // Description:
+  // Returns the number of triangles the polygons and triangle strips of
+  // the given polydata are made of.
+  static vtkIdType GetNumberOfTriangles(vtkPolyData* input);
+
+  // Description:
+  // Returns the number of triangles, line segments and vertices of the
+  // given polydata, which MaximumNumberOfTriangles bounds.
+  static vtkIdType GetNumberOfPrimitives(vtkPolyData* input);
+
+//BTX
+protected:
+  vtkPVQuadricClustering();
+  ~vtkPVQuadricClustering();
+
+  virtual int RequestData(vtkInformation* request,
+                          vtkInformationVector** inputVector,
+                          vtkInformationVector* outputVector);
+
+  // Description:
+  // Estimates the number of divisions for clustering input into about
+  // numPrimitives primitives. Returns the estimated dimension of the input,
+  // the power of the resolution the number of occupied bins grows with.
+  double EstimateNumberOfDivisions(vtkPolyData* input,
+                                   vtkIdType numPrimitives, int divisions[3]);
+
+  // Description:
+  // Clusters input with the given number of divisions into output, with the
+  // other settings of this filter.
+  void Cluster(vtkPolyData* input, int divisions[3], vtkPolyData* output);
+
+  int MaximumNumberOfTriangles;
+  int MaximumNumberOfBins;
+
+private:
+  vtkPVQuadricClustering(const vtkPVQuadricClustering&); // Not implemented
+  void operator=(const vtkPVQuadricClustering&); // Not implemented
+//ETX
+};
+
+#endif
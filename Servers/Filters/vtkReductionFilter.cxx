@@ -35,6 +35,7 @@
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkStructuredGrid.h"
 #include "vtkTable.h"
+#include "vtkTimerLog.h"
 #include "vtkToolkits.h"
 #include "vtkSelection.h"
 #include "vtkSelectionSerializer.h"
@@ -56,6 +57,7 @@ vtkReductionFilter::vtkReductionFilter()
   this->PostGatherHelper = 0;
   this->PassThrough = -1;
   this->GenerateProcessIds = 0;
+  this->ReduceInTree = 0;
 }
 
 //-----------------------------------------------------------------------------
@@ -336,6 +338,12 @@ void vtkReductionFilter::Reduce(vtkDataObject* input, vtkDataObject* output)
     this->PassThrough = -1;
     }
 
+  if (this->ReduceInTree && this->PassThrough < 0)
+    {
+    this->TreeReduce(preOutput, output);
+    return;
+    }
+
   vtkstd::vector<vtkSmartPointer<vtkDataObject> > data_sets;
   if (myId == 0)
     {
@@ -380,6 +388,70 @@ void vtkReductionFilter::Reduce(vtkDataObject* input, vtkDataObject* output)
     static_cast<unsigned int>(data_sets.size()));
 }
 
+//-----------------------------------------------------------------------------
+void vtkReductionFilter::TreeReduce(vtkDataObject* preOutput,
+                                    vtkDataObject* output)
+{
+  vtkMultiProcessController* controller = this->Controller;
+  int myId = controller->GetLocalProcessId();
+  int numProcs = controller->GetNumberOfProcesses();
+
+  // At level l, the processes whose id is an odd multiple of 2^l send their
+  // result to the process 2^l before them, so each process reduces the
+  // results of the processes after it in its subtree, in the order of their
+  // ids.
+  vtkSmartPointer<vtkDataObject> partial = preOutput;
+  bool reduced = false;
+  int level = 0;
+  for (int step = 1; step < numProcs; step *= 2, level++)
+    {
+    if (myId % (2*step))
+      {
+      this->Send(myId - step, partial);
+      break;
+      }
+    if (myId + step >= numProcs)
+      {
+      continue;
+      }
+
+    vtksys_ios::ostringstream event;
+    event << "vtkReductionFilter level " << level;
+    vtkTimerLog::MarkStartEvent(event.str().c_str());
+    vtkSmartPointer<vtkDataObject> received;
+    received.TakeReference(
+      this->Receive(myId + step, output->GetDataObjectType()));
+    if (!partial)
+      {
+      partial = received;
+      }
+    else if (received)
+      {
+      vtkSmartPointer<vtkDataObject> inputs[2] = { partial, received };
+      partial.TakeReference(output->NewInstance());
+      this->PostProcess(partial, inputs, 2);
+      reduced = true;
+      }
+    vtkTimerLog::MarkEndEvent(event.str().c_str());
+    }
+
+  // As when gathering, the satellites keep their own result.
+  if (myId != 0)
+    {
+    partial = preOutput;
+    reduced = false;
+    }
+  if (reduced)
+    {
+    output->ShallowCopy(partial);
+    }
+  else if (partial)
+    {
+    vtkSmartPointer<vtkDataObject> inputs[1] = { partial };
+    this->PostProcess(output, inputs, 1);
+    }
+}
+
 //-----------------------------------------------------------------------------
 void vtkReductionFilter::Send(int receiver, vtkDataObject* data)
 {
@@ -436,4 +508,5 @@ void vtkReductionFilter::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "Controller: " << this->Controller << endl;
   os << indent << "PassThrough: " << this->PassThrough << endl;
   os << indent << "GenerateProcessIds: " << this->GenerateProcessIds << endl;
+  os << indent << "ReduceInTree: " << this->ReduceInTree << endl;
 }
@@ -26,6 +26,14 @@
 // In addition to doing reduction the PassThrough variable lets you choose
 // to pass through the results of any one node instead of aggregating all of
 // them together.
+//
+// When ReduceInTree is on, the results are instead reduced along a binary
+// tree of the processes: at each level of the tree, half of the remaining
+// processes send their partial result to a neighbour, which runs the
+// PostGatherHelper on its own and the received result.  The root then only
+// receives log2(N) results instead of N-1.  The PostGatherHelper must be
+// associative and set on all the processes for this.  The cost of each
+// level is logged with vtkTimerLog events.
 
 #ifndef __vtkReductionFilter_h
 #define __vtkReductionFilter_h
@@ -75,6 +83,17 @@ public:
   vtkSetMacro(GenerateProcessIds, int);
   vtkGetMacro(GenerateProcessIds, int);
 
+  // Description:
+  // When set, the results of the processes are reduced along a binary tree
+  // instead of all being gathered on the root.  The PostGatherHelper must
+  // then be associative, i.e. reducing the results of processes 0 to 3 must
+  // be the same as reducing the reduced results of processes 0 and 1 and of
+  // processes 2 and 3, and it must be set on every process.  Ignored when
+  // PassThrough is set.  Off by default.
+  vtkSetMacro(ReduceInTree, int);
+  vtkGetMacro(ReduceInTree, int);
+  vtkBooleanMacro(ReduceInTree, int);
+
 //BTX
   enum Tags {
     TRANSMIT_DATA_OBJECT = 23484
@@ -96,6 +115,11 @@ protected:
                           vtkInformationVector* outputVector);
 
   void Reduce(vtkDataObject* input, vtkDataObject* output);
+
+  // Description:
+  // Reduce the result of this process with those of the other processes
+  // along a binary tree of the processes, into output on the root.
+  void TreeReduce(vtkDataObject* preOutput, vtkDataObject* output);
   vtkDataObject* PreProcess(vtkDataObject* input);
   void PostProcess(vtkDataObject* output,
     vtkSmartPointer<vtkDataObject> inputs[],
@@ -109,6 +133,7 @@ protected:
   vtkMultiProcessController* Controller;
   int PassThrough;
   int GenerateProcessIds;
+  int ReduceInTree;
 
 private:
   vtkReductionFilter(const vtkReductionFilter&); // Not implemented.
@@ -3,6 +3,7 @@
 #include "vtkDataArraySelection.h"
 #include "vtkObjectFactory.h"
 #include "vtkDataArray.h"
+#include "vtkDataArrayCache.h"
 #include "vtkSpyPlotIStream.h"
 #include "vtkFloatArray.h"
 #include "vtkIntArray.h"
@@ -703,20 +704,8 @@ int vtkSpyPlotUniReader::MakeCurrent()
         vtkSpyPlotUniReader::Variable *cv = dp->Variables + var;
         if ( cv->DataBlocks )
           {
-          int ca;
-          for ( ca = 0; ca < dp->ActualNumberOfBlocks; ++ ca )
-            {
-            if ( cv->DataBlocks[ca] )
-              {
-              cv->DataBlocks[ca]->Delete();
-              cv->DataBlocks[ca] = 0;
-              }
-            }
           vtkDebugMacro( "* Delete Data blocks for variable: " << cv->Name );
-          delete [] cv->DataBlocks;
-          cv->DataBlocks = 0;
-          delete [] cv->GhostCellsFixed;
-          cv->GhostCellsFixed = 0;
+          this->ReleaseDataBlocks(dump, cv);
           }
         }
       }
@@ -748,17 +737,7 @@ int vtkSpyPlotUniReader::MakeCurrent()
         {
         vtkDebugMacro( " ** Variable " << var->Name 
                        << " was unselected, so remove" );
-        int dataBlock;
-        for ( dataBlock = 0; 
-              dataBlock < dp->ActualNumberOfBlocks; ++ dataBlock )
-          {
-          var->DataBlocks[dataBlock]->Delete();
-          var->DataBlocks[dataBlock] = 0;
-          }
-        delete [] var->DataBlocks;
-        var->DataBlocks = 0;
-        delete [] var->GhostCellsFixed;
-        var->GhostCellsFixed = 0;
+        this->ReleaseDataBlocks(dump, var);
         vtkDebugMacro( "* Delete Data blocks for variable: " << var->Name );
         }
       vtkDebugMacro( " *** Ignore variable: " << var->Name );
@@ -789,6 +768,13 @@ int vtkSpyPlotUniReader::MakeCurrent()
       continue;
       }
 
+    if ( this->FindCachedDataBlocks(dump, var) )
+      {
+      vtkDebugMacro( << var << " Found variable in the array cache: " 
+                     << var->Name << " / " << this->FileName );
+      continue;
+      }
+
     //vtkDebugMacro( "  Field: " << fieldCnt << " / " << dp->NumVars 
     // << " [" << var->Name << "]" );
     //vtkDebugMacro( "    Jump to: " << dp->SavedVariableOffsets[fieldCnt] );
@@ -1341,6 +1327,100 @@ const char* vtkSpyPlotUniReader::GetCellFieldName(int field)
   return var->Name;
 }
 
+//-----------------------------------------------------------------------------
+// The ids of the cache keys of the data blocks are the dump, the block, the
+// type of the array and whether its ghost cells were fixed.
+void vtkSpyPlotUniReader::GetArrayCacheKey(vtkDataArrayCacheKey& key,
+                                           int dump, Variable* var)
+{
+  key.SetSourceToFile(this->FileName);
+  key.Time = this->DumpTime[dump];
+  key.Name = var->Name;
+  key.Ids.clear();
+  key.AddId(dump).AddId(0).AddId(0).AddId(0);
+}
+
+//-----------------------------------------------------------------------------
+void vtkSpyPlotUniReader::ReleaseDataBlocks(int dump, Variable* var)
+{
+  vtkSpyPlotUniReader::DataDump* dp = this->DataDumps+dump;
+  vtkDataArrayCache* cache = vtkDataArrayCache::GetInstance();
+  vtkDataArrayCacheKey key;
+  this->GetArrayCacheKey(key, dump, var);
+  int block;
+  for ( block = 0; block < dp->ActualNumberOfBlocks; ++ block )
+    {
+    vtkDataArray* array = var->DataBlocks[block];
+    if ( array )
+      {
+      // Keep the block in the array cache in case it is needed again.
+      key.Ids[1] = block;
+      key.Ids[2] = array->GetDataType();
+      key.Ids[3] = var->GhostCellsFixed[block];
+      cache->Insert(key, array);
+      array->Delete();
+      var->DataBlocks[block] = 0;
+      }
+    }
+  delete [] var->DataBlocks;
+  var->DataBlocks = 0;
+  delete [] var->GhostCellsFixed;
+  var->GhostCellsFixed = 0;
+}
+
+//-----------------------------------------------------------------------------
+int vtkSpyPlotUniReader::FindCachedDataBlocks(int dump, Variable* var)
+{
+  vtkSpyPlotUniReader::DataDump* dp = this->DataDumps+dump;
+  vtkDataArrayCache* cache = vtkDataArrayCache::GetInstance();
+  if ( cache->GetNumberOfEntries() == 0 )
+    {
+    return 0;
+    }
+  vtkDataArrayCacheKey key;
+  this->GetArrayCacheKey(key, dump, var);
+  key.Ids[2] = 
+    (this->DownConvertVolumeFraction && this->IsVolumeFraction(var))?
+    VTK_UNSIGNED_CHAR : VTK_FLOAT;
+
+  // Use the cached blocks only if all of them are there, the blocks of a
+  // variable are read together.
+  vtkstd::vector<vtkSmartPointer<vtkDataArray> >
+    arrays(dp->ActualNumberOfBlocks);
+  vtkstd::vector<int> fixed(dp->ActualNumberOfBlocks);
+  int block;
+  for ( block = 0; block < dp->ActualNumberOfBlocks; ++ block )
+    {
+    key.Ids[1] = block;
+    for ( fixed[block] = 1; fixed[block] >= 0; -- fixed[block] )
+      {
+      key.Ids[3] = fixed[block];
+      arrays[block] = cache->Find(key);
+      if ( arrays[block] )
+        {
+        break;
+        }
+      }
+    if ( !arrays[block] )
+      {
+      return 0;
+      }
+    }
+
+  // Take the blocks out of the cache, their ghost cells may be fixed in
+  // place.
+  for ( block = 0; block < dp->ActualNumberOfBlocks; ++ block )
+    {
+    arrays[block]->Register(this);
+    key.Ids[1] = block;
+    key.Ids[3] = fixed[block];
+    cache->Invalidate(key);
+    var->DataBlocks[block] = arrays[block];
+    var->GhostCellsFixed[block] = fixed[block];
+    }
+  return 1;
+}
+
 //-----------------------------------------------------------------------------
 vtkDataArray* vtkSpyPlotUniReader::GetCellFieldData(int block, int field, int* fixed)
 {
@@ -34,6 +34,7 @@ PURPOSE.  See the above copyright notice for more information.
 class vtkSpyPlotBlock;
 class vtkDataArraySelection;
 class vtkDataArray;
+class vtkDataArrayCacheKey;
 class vtkFloatArray;
 class vtkIntArray;
 class vtkUnsignedCharArray;
@@ -238,6 +239,13 @@ private:
   Variable* GetCellField(int field);
   int IsVolumeFraction(Variable* var);
 
+  // Move the data blocks of a variable of a dump to the array cache, or
+  // take them from the cache.  FindCachedDataBlocks returns 0 if some
+  // blocks are not in the cache.
+  void GetArrayCacheKey(vtkDataArrayCacheKey& key, int dump, Variable* var);
+  void ReleaseDataBlocks(int dump, Variable* var);
+  int FindCachedDataBlocks(int dump, Variable* var);
+
 private:
   vtkSpyPlotUniReader(const vtkSpyPlotUniReader&); // Not implemented
   void operator=(const vtkSpyPlotUniReader&); // Not implemented
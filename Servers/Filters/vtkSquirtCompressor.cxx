@@ -39,27 +39,38 @@ vtkSquirtCompressor::~vtkSquirtCompressor()
 //-----------------------------------------------------------------------------
 int vtkSquirtCompressor::Compress()
 {
-  if (!(this->Input && this->Output))
+  if (this->Input && this->Input->GetNumberOfComponents() != 4 &&
+    this->Input->GetNumberOfComponents() != 3)
     {
-    vtkWarningMacro("Cannot compress empty input or output detected.");
+    vtkErrorMacro("Squirt only works with RGBA or RGB");
     return VTK_ERROR;
     }
 
-  vtkUnsignedCharArray* input =  this->GetInput();
-
-  if (input->GetNumberOfComponents() != 4 && input->GetNumberOfComponents() != 3)
+  // Reported once here rather than by every tile; the tiles then use level 1.
+  int compress_level = this->LossLessMode?0:this->SquirtLevel;
+  if (compress_level < 0 || compress_level > 5)
     {
-    vtkErrorMacro("Squirt only works with RGBA or RGB");
-    return VTK_ERROR;
+    vtkErrorMacro("Squirt compression level (" << compress_level 
+      << ") is out of range [0,5].");
     }
+  return this->Superclass::Compress();
+}
+
+//-----------------------------------------------------------------------------
+vtkIdType vtkSquirtCompressor::GetMaximumTileSize(vtkIdType numberOfPixels,
+  int vtkNotUsed(numberOfComponents))
+{
+  // At worst every pixel starts a new run.
+  return 4*numberOfPixels;
+}
 
-  int count=0;
-  int index=0;
-  int comp_index=0;
-  int end_index;
+//-----------------------------------------------------------------------------
+vtkIdType vtkSquirtCompressor::CompressTile(const unsigned char* in,
+  vtkIdType numberOfPixels, int numberOfComponents, unsigned char* out)
+{
   int compress_level = this->LossLessMode?0:this->SquirtLevel;
-  unsigned int current_color;
-  unsigned char compress_masks[6][4] = {  {0xFF, 0xFF, 0xFF, 0xFF},
+  static const unsigned char compress_masks[6][4] = {
+      {0xFF, 0xFF, 0xFF, 0xFF},
       {0xFE, 0xFF, 0xFE, 0xFF},
       {0xFC, 0xFE, 0xFC, 0xFF},
       {0xF8, 0xFC, 0xF8, 0xFF},
@@ -68,8 +79,6 @@ int vtkSquirtCompressor::Compress()
 
   if (compress_level < 0 || compress_level > 5)
     {
-    vtkErrorMacro("Squirt compression level (" << compress_level 
-      << ") is out of range [0,5].");
     compress_level = 1;
     }
 
@@ -78,143 +87,142 @@ int vtkSquirtCompressor::Compress()
   // I shifted the level by one so that 0 means no compression.
   memcpy(&compress_mask, &compress_masks[compress_level], 4);
 
-  // Access raw arrays directly
-  if (input->GetNumberOfComponents() == 4)
+  // The runs are computed on whole pixels: each pixel is loaded as one
+  // 32 bit word and compared to the run color under the mask.
+  unsigned int* _rawCompressedBuffer = reinterpret_cast<unsigned int*>(out);
+  vtkIdType index = 0;
+  vtkIdType comp_index = 0;
+  if (numberOfComponents == 4)
     {
-    unsigned int* _rawColorBuffer;
-    unsigned int* _rawCompressedBuffer;
-    int numPixels = input->GetNumberOfTuples();
-    _rawColorBuffer = (unsigned int*)input->GetPointer(0);
-    _rawCompressedBuffer = (unsigned int*)this->Output->WritePointer(0,numPixels*4);
-    end_index = numPixels;
+    const unsigned int* _rawColorBuffer =
+      reinterpret_cast<const unsigned int*>(in);
 
     // Go through color buffer and put RLE format into compressed buffer
-    while((index < end_index) && (comp_index < end_index)) 
+    while (index < numberOfPixels)
       {
-
       // Record color
-      current_color = _rawCompressedBuffer[comp_index] =_rawColorBuffer[index];
-      index++;
-
-      // Compute Run
-      while((index<end_index) && (count<255) && 
-        ((current_color&compress_mask) == (_rawColorBuffer[index]&compress_mask)))
-        { 
-        index++; count++;   
+      unsigned int current_color = _rawColorBuffer[index];
+      unsigned int masked_color = current_color & compress_mask;
+      _rawCompressedBuffer[comp_index] = current_color;
+
+      // Compute Run, up to 255 more pixels.
+      vtkIdType run_start = index++;
+      vtkIdType run_end = run_start + 256;
+      if (run_end > numberOfPixels)
+        {
+        run_end = numberOfPixels;
+        }
+      while (index < run_end &&
+        (_rawColorBuffer[index] & compress_mask) == masked_color)
+        {
+        index++;
         }
 
       // Record Run length
-      *((unsigned char*)_rawCompressedBuffer+comp_index*4+3) =(unsigned char)count;
+      out[comp_index*4+3] = static_cast<unsigned char>(index - run_start - 1);
       comp_index++;
-
-      count = 0;
-
       }
     }
-  else if (input->GetNumberOfComponents() == 3)
+  else if (numberOfComponents == 3)
     {
-    unsigned char* _rawColorBuffer;
-    unsigned int* _rawCompressedBuffer;
-    int numPixels = input->GetNumberOfTuples();
-    _rawColorBuffer = (unsigned char*)input->GetPointer(0);
-    _rawCompressedBuffer = (unsigned int*)this->Output->WritePointer(0,numPixels*4);
-    end_index = numPixels;
-
     // Go through color buffer and put RLE format into compressed buffer
-    while((index < 3*numPixels) && (comp_index < end_index)) 
+    while (index < numberOfPixels)
       {
-
-      int next_color = 0;
       // Record color
-      unsigned char* p = (unsigned char*)&current_color;
-      *p++ = _rawColorBuffer[index];
-      *p++ = _rawColorBuffer[index+1];
-      *p++ = _rawColorBuffer[index+2];
-      *p = 0x0;
-      
+      unsigned int current_color = 0;
+      unsigned char* p = reinterpret_cast<unsigned char*>(&current_color);
+      p[0] = in[3*index];
+      p[1] = in[3*index+1];
+      p[2] = in[3*index+2];
+      unsigned int masked_color = current_color & compress_mask;
       _rawCompressedBuffer[comp_index] = current_color;
-      index+=3;
-      
-      p = (unsigned char*)&next_color;
-      *p++ = _rawColorBuffer[index];
-      *p++ = _rawColorBuffer[index+1];
-      *p++ = _rawColorBuffer[index+2];
-      *p = 0x0;
-    
-      // Compute Run
-      while(((current_color&compress_mask) == (next_color&compress_mask)) &&
-        (index < 3*numPixels) && (count<255))
-        { 
-        index+=3; count++;   
-        if (index < 3*numPixels)
+
+      // Compute Run, up to 255 more pixels.
+      vtkIdType run_start = index++;
+      vtkIdType run_end = run_start + 256;
+      if (run_end > numberOfPixels)
+        {
+        run_end = numberOfPixels;
+        }
+      while (index < run_end)
+        {
+        unsigned int next_color = 0;
+        p = reinterpret_cast<unsigned char*>(&next_color);
+        p[0] = in[3*index];
+        p[1] = in[3*index+1];
+        p[2] = in[3*index+2];
+        if ((next_color & compress_mask) != masked_color)
           {
-          p = (unsigned char*)&next_color;
-          *p++ = _rawColorBuffer[index];
-          *p++ = _rawColorBuffer[index+1];
-          *p++ = _rawColorBuffer[index+2];
-          *p = 0x0;
+          break;
           }
+        index++;
         }
 
       // Record Run length
-      *((unsigned char*)_rawCompressedBuffer+comp_index*4+3) =(unsigned char)count;
+      out[comp_index*4+3] = static_cast<unsigned char>(index - run_start - 1);
       comp_index++;
-
-      count = 0;
       }
     }
+  else
+    {
+    return -1;
+    }
 
-  // Back to vtk arrays :)
-  this->Output->SetNumberOfComponents(1);
-  this->Output->SetNumberOfTuples(4*comp_index);
-
-  return VTK_OK;
+  return 4*comp_index;
 }
 
 //-----------------------------------------------------------------------------
-int vtkSquirtCompressor::Decompress()
+int vtkSquirtCompressor::DecompressTile(const unsigned char* in,
+  vtkIdType size, unsigned char* out, vtkIdType numberOfPixels,
+  int numberOfComponents)
 {
-  if (!(this->Input && this->Output))
+  if (numberOfComponents != 4 && numberOfComponents != 3)
     {
-    vtkWarningMacro("Cannot decompress empty input or output detected.");
-    return VTK_ERROR;
+    return 0;
     }
 
-  vtkUnsignedCharArray* in = this->GetInput();
-  vtkUnsignedCharArray* out = this->GetOutput();
-  int count=0;
-  int index=0;
-  unsigned int current_color;
-  unsigned int* _rawColorBuffer;
-  unsigned int* _rawCompressedBuffer;
-
-  // Get compressed buffer size
-  int CompSize = in->GetNumberOfTuples()/4; /// NOTE 1->4
-
-  // Access raw arrays directly
-  _rawColorBuffer = (unsigned int*)out->GetPointer(0);
-  _rawCompressedBuffer = (unsigned int*)in->GetPointer(0);
+  const unsigned int* _rawCompressedBuffer =
+    reinterpret_cast<const unsigned int*>(in);
+  unsigned int* _rawColorBuffer = reinterpret_cast<unsigned int*>(out);
+  vtkIdType compSize = size/4;
+  vtkIdType index = 0;
 
   // Go through compress buffer and extract RLE format into color buffer
-  for(int i=0; i<CompSize; i++)
+  for (vtkIdType i = 0; i < compSize; i++)
     {
     // Get color and count
-    current_color = _rawCompressedBuffer[i];
+    unsigned int current_color = _rawCompressedBuffer[i];
 
     // Get run length count;
-    count = *((unsigned char*)&current_color+3);
+    unsigned char* p = reinterpret_cast<unsigned char*>(&current_color);
+    int count = p[3];
+    if (index + count + 1 > numberOfPixels)
+      {
+      return 0;
+      }
 
     // Fixed Alpha
-    *((unsigned char*)&current_color+3) = 0xFF;
-
-    // Set color
-    _rawColorBuffer[index++] = current_color;
+    p[3] = 0xFF;
 
     // Blast color into color buffer
-    for(int j=0; j< count; j++)
-      _rawColorBuffer[index++] = current_color;
+    if (numberOfComponents == 4)
+      {
+      for (int j = 0; j <= count; j++)
+        {
+        _rawColorBuffer[index++] = current_color;
+        }
+      }
+    else
+      {
+      for (int j = 0; j <= count; j++, index++)
+        {
+        out[3*index] = p[0];
+        out[3*index+1] = p[1];
+        out[3*index+2] = p[2];
+        }
+      }
     }
-  return VTK_OK;
+  return index == numberOfPixels;
 }
 
 //-----------------------------------------------------------------------------
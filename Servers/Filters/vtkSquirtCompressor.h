@@ -31,6 +31,9 @@
 // also work with RGB images. There is no performance hit when applying
 // the lossy comrpession levels.
 //
+// The image is split into tiles that are compressed and decompressed on
+// several threads, see vtkTiledImageCompressor.
+//
 // Levels 1 through 5 apply a color reducing mask to the run computation,
 // not to the pixel directly. This is clever in that no new colors are
 // introduced to the image, and as a result one doesn't see drastic changes
@@ -45,15 +48,15 @@
 #ifndef __vtkSquirtCompressor_h
 #define __vtkSquirtCompressor_h
 
-#include "vtkImageCompressor.h"
+#include "vtkTiledImageCompressor.h"
 
 class vtkMultiProcessStream;
 
-class VTK_EXPORT vtkSquirtCompressor : public vtkImageCompressor
+class VTK_EXPORT vtkSquirtCompressor : public vtkTiledImageCompressor
 {
 public:
   static vtkSquirtCompressor* New();
-  vtkTypeRevisionMacro(vtkSquirtCompressor, vtkImageCompressor);
+  vtkTypeRevisionMacro(vtkSquirtCompressor, vtkTiledImageCompressor);
   void PrintSelf(ostream& os, vtkIndent indent);
 
   // Description:
@@ -64,10 +67,9 @@ public:
   vtkGetMacro(SquirtLevel, int);
 
   // Description:
-  // Compress/Decompress data array on the objects input with results
-  // in the objects output. See also Set/GetInput/Output.
+  // Compress data array on the objects input with results in the objects
+  // output. Input must be RGBA or RGB.
   virtual int Compress();
-  virtual int Decompress();
 
   //BTX
   // Description:
@@ -82,6 +84,15 @@ protected:
   vtkSquirtCompressor();
   virtual ~vtkSquirtCompressor();
 
+  // Description:
+  // Run-length encode/decode one tile.
+  virtual vtkIdType GetMaximumTileSize(vtkIdType numberOfPixels,
+    int numberOfComponents);
+  virtual vtkIdType CompressTile(const unsigned char* in,
+    vtkIdType numberOfPixels, int numberOfComponents, unsigned char* out);
+  virtual int DecompressTile(const unsigned char* in, vtkIdType size,
+    unsigned char* out, vtkIdType numberOfPixels, int numberOfComponents);
+
   int SquirtLevel;
 
 private:
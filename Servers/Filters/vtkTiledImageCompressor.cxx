@@ -0,0 +1,294 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    $RCSfile$
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkTiledImageCompressor.h"
+
+#include "vtkMultiThreader.h"
+#include "vtkObjectFactory.h"
+#include "vtkUnsignedCharArray.h"
+
+#include <vtkstd/vector>
+
+vtkCxxRevisionMacro(vtkTiledImageCompressor, "$Revision$");
+
+//-----------------------------------------------------------------------------
+// The compressed data is laid out as
+//   [number of tiles] ([pixels in tile] [bytes in tile])* [tile data]*
+// with all counts stored as 32 bit little-endian integers.
+static void vtkTiledImageCompressorWriteUInt32(unsigned char* out,
+  vtkIdType value)
+{
+  out[0] = static_cast<unsigned char>(value & 0xff);
+  out[1] = static_cast<unsigned char>((value >> 8) & 0xff);
+  out[2] = static_cast<unsigned char>((value >> 16) & 0xff);
+  out[3] = static_cast<unsigned char>((value >> 24) & 0xff);
+}
+
+//-----------------------------------------------------------------------------
+static vtkIdType vtkTiledImageCompressorReadUInt32(const unsigned char* in)
+{
+  return static_cast<vtkIdType>(
+    static_cast<vtkTypeUInt32>(in[0]) |
+    (static_cast<vtkTypeUInt32>(in[1]) << 8) |
+    (static_cast<vtkTypeUInt32>(in[2]) << 16) |
+    (static_cast<vtkTypeUInt32>(in[3]) << 24));
+}
+
+//-----------------------------------------------------------------------------
+class vtkTiledImageCompressor::vtkInternals
+{
+public:
+  struct Tile
+    {
+    // Uncompressed side.
+    unsigned char* Pixels;
+    vtkIdType NumberOfPixels;
+    // Compressed side.
+    const unsigned char* Data;
+    vtkIdType Size;
+    // Scratch space the tile is compressed into.
+    vtkstd::vector<unsigned char> Buffer;
+    int Status;
+    };
+
+  vtkTiledImageCompressor* Self;
+  int NumberOfComponents;
+  vtkstd::vector<Tile> Tiles;
+
+  // Split numberOfPixels pixels into tiles, at least MinimumTileSize
+  // pixels each, a few per thread so that uneven tiles balance out.
+  void SplitPixels(unsigned char* pixels, vtkIdType numberOfPixels)
+    {
+    vtkIdType maxTiles = numberOfPixels / this->Self->MinimumTileSize;
+    vtkIdType numberOfTiles = 4 * this->Self->NumberOfThreads;
+    if (numberOfTiles > maxTiles)
+      {
+      numberOfTiles = maxTiles;
+      }
+    if (numberOfTiles < 1)
+      {
+      numberOfTiles = 1;
+      }
+    this->Tiles.resize(numberOfTiles);
+    vtkIdType start = 0;
+    for (vtkIdType cc = 0; cc < numberOfTiles; ++cc)
+      {
+      vtkIdType end = (numberOfPixels * (cc + 1)) / numberOfTiles;
+      this->Tiles[cc].Pixels = pixels + start * this->NumberOfComponents;
+      this->Tiles[cc].NumberOfPixels = end - start;
+      this->Tiles[cc].Data = 0;
+      this->Tiles[cc].Size = 0;
+      this->Tiles[cc].Status = 0;
+      start = end;
+      }
+    }
+
+  void Execute(vtkThreadFunctionType method)
+    {
+    int numberOfThreads = this->Self->NumberOfThreads;
+    if (numberOfThreads > static_cast<int>(this->Tiles.size()))
+      {
+      numberOfThreads = static_cast<int>(this->Tiles.size());
+      }
+    this->Self->Threader->SetNumberOfThreads(numberOfThreads);
+    this->Self->Threader->SetSingleMethod(method, this);
+    this->Self->Threader->SingleMethodExecute();
+    }
+
+  static VTK_THREAD_RETURN_TYPE CompressTiles(void* arg)
+    {
+    vtkMultiThreader::ThreadInfo* info =
+      static_cast<vtkMultiThreader::ThreadInfo*>(arg);
+    vtkInternals* self = static_cast<vtkInternals*>(info->UserData);
+    size_t numberOfTiles = self->Tiles.size();
+    for (size_t cc = info->ThreadID; cc < numberOfTiles;
+      cc += info->NumberOfThreads)
+      {
+      Tile& tile = self->Tiles[cc];
+      if (tile.NumberOfPixels == 0)
+        {
+        tile.Size = 0;
+        tile.Status = 1;
+        continue;
+        }
+      tile.Buffer.resize(self->Self->GetMaximumTileSize(
+          tile.NumberOfPixels, self->NumberOfComponents));
+      tile.Size = self->Self->CompressTile(tile.Pixels, tile.NumberOfPixels,
+        self->NumberOfComponents, &tile.Buffer[0]);
+      tile.Status = (tile.Size >= 0);
+      }
+    return VTK_THREAD_RETURN_VALUE;
+    }
+
+  static VTK_THREAD_RETURN_TYPE DecompressTiles(void* arg)
+    {
+    vtkMultiThreader::ThreadInfo* info =
+      static_cast<vtkMultiThreader::ThreadInfo*>(arg);
+    vtkInternals* self = static_cast<vtkInternals*>(info->UserData);
+    size_t numberOfTiles = self->Tiles.size();
+    for (size_t cc = info->ThreadID; cc < numberOfTiles;
+      cc += info->NumberOfThreads)
+      {
+      Tile& tile = self->Tiles[cc];
+      if (tile.NumberOfPixels == 0)
+        {
+        tile.Status = 1;
+        continue;
+        }
+      tile.Status = self->Self->DecompressTile(tile.Data, tile.Size,
+        tile.Pixels, tile.NumberOfPixels, self->NumberOfComponents);
+      }
+    return VTK_THREAD_RETURN_VALUE;
+    }
+};
+
+//-----------------------------------------------------------------------------
+vtkTiledImageCompressor::vtkTiledImageCompressor()
+{
+  this->Threader = vtkMultiThreader::New();
+  this->NumberOfThreads = vtkMultiThreader::GetGlobalDefaultNumberOfThreads();
+  this->MinimumTileSize = 65536;
+  this->Internals = new vtkInternals;
+  this->Internals->Self = this;
+  this->Internals->NumberOfComponents = 0;
+}
+
+//-----------------------------------------------------------------------------
+vtkTiledImageCompressor::~vtkTiledImageCompressor()
+{
+  this->Threader->Delete();
+  delete this->Internals;
+}
+
+//-----------------------------------------------------------------------------
+int vtkTiledImageCompressor::Compress()
+{
+  if (!(this->Input && this->Output))
+    {
+    vtkWarningMacro("Cannot compress empty input or output detected.");
+    return VTK_ERROR;
+    }
+
+  vtkUnsignedCharArray* input = this->Input;
+  vtkInternals* internals = this->Internals;
+  internals->NumberOfComponents = input->GetNumberOfComponents();
+  internals->SplitPixels(input->GetPointer(0), input->GetNumberOfTuples());
+  internals->Execute(vtkInternals::CompressTiles);
+
+  size_t numberOfTiles = internals->Tiles.size();
+  vtkIdType outputSize = 4 + 8 * static_cast<vtkIdType>(numberOfTiles);
+  size_t cc;
+  for (cc = 0; cc < numberOfTiles; ++cc)
+    {
+    if (!internals->Tiles[cc].Status)
+      {
+      vtkErrorMacro("Failed to compress tile " << cc << ".");
+      return VTK_ERROR;
+      }
+    outputSize += internals->Tiles[cc].Size;
+    }
+
+  // Gather the tiles behind the table of tile sizes.
+  this->Output->SetNumberOfComponents(1);
+  this->Output->SetNumberOfTuples(outputSize);
+  unsigned char* out = this->Output->GetPointer(0);
+  unsigned char* data = out + 4 + 8 * numberOfTiles;
+  vtkTiledImageCompressorWriteUInt32(out, static_cast<vtkIdType>(numberOfTiles));
+  out += 4;
+  for (cc = 0; cc < numberOfTiles; ++cc)
+    {
+    vtkInternals::Tile& tile = internals->Tiles[cc];
+    vtkTiledImageCompressorWriteUInt32(out, tile.NumberOfPixels);
+    vtkTiledImageCompressorWriteUInt32(out + 4, tile.Size);
+    out += 8;
+    if (tile.Size > 0)
+      {
+      memcpy(data, &tile.Buffer[0], tile.Size);
+      data += tile.Size;
+      }
+    }
+  return VTK_OK;
+}
+
+//-----------------------------------------------------------------------------
+int vtkTiledImageCompressor::Decompress()
+{
+  if (!(this->Input && this->Output))
+    {
+    vtkWarningMacro("Cannot decompress empty input or output detected.");
+    return VTK_ERROR;
+    }
+
+  const unsigned char* in = this->Input->GetPointer(0);
+  vtkIdType inSize = this->Input->GetNumberOfTuples() *
+    this->Input->GetNumberOfComponents();
+  if (inSize < 4)
+    {
+    vtkErrorMacro("Compressed image is truncated.");
+    return VTK_ERROR;
+    }
+  vtkIdType numberOfTiles = vtkTiledImageCompressorReadUInt32(in);
+  if (numberOfTiles < 1 || inSize < 4 + 8 * numberOfTiles)
+    {
+    vtkErrorMacro("Compressed image is truncated.");
+    return VTK_ERROR;
+    }
+
+  // The output is allocated by the caller to the size of the image.
+  vtkInternals* internals = this->Internals;
+  internals->NumberOfComponents = this->Output->GetNumberOfComponents();
+  internals->Tiles.resize(numberOfTiles);
+  unsigned char* pixels = this->Output->GetPointer(0);
+  vtkIdType numberOfPixels = this->Output->GetNumberOfTuples();
+  const unsigned char* table = in + 4;
+  const unsigned char* data = table + 8 * numberOfTiles;
+  const unsigned char* end = in + inSize;
+  vtkIdType pixelCount = 0;
+  for (vtkIdType cc = 0; cc < numberOfTiles; ++cc, table += 8)
+    {
+    vtkInternals::Tile& tile = internals->Tiles[cc];
+    tile.NumberOfPixels = vtkTiledImageCompressorReadUInt32(table);
+    tile.Size = vtkTiledImageCompressorReadUInt32(table + 4);
+    tile.Pixels = pixels + pixelCount * internals->NumberOfComponents;
+    tile.Data = data;
+    tile.Status = 0;
+    pixelCount += tile.NumberOfPixels;
+    data += tile.Size;
+    if (pixelCount > numberOfPixels || data > end)
+      {
+      vtkErrorMacro("Compressed image does not match the output size.");
+      return VTK_ERROR;
+      }
+    }
+
+  internals->Execute(vtkInternals::DecompressTiles);
+
+  for (vtkIdType cc = 0; cc < numberOfTiles; ++cc)
+    {
+    if (!internals->Tiles[cc].Status)
+      {
+      vtkErrorMacro("Failed to decompress tile " << cc << ".");
+      return VTK_ERROR;
+      }
+    }
+  return VTK_OK;
+}
+
+//-----------------------------------------------------------------------------
+void vtkTiledImageCompressor::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "NumberOfThreads: " << this->NumberOfThreads << endl;
+  os << indent << "MinimumTileSize: " << this->MinimumTileSize << endl;
+}
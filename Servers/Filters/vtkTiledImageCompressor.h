@@ -0,0 +1,106 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    $RCSfile$
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkTiledImageCompressor - Superclass for image compressors that
+// work on independent tiles of the image in parallel.
+//
+// .SECTION Description
+// vtkTiledImageCompressor splits the input pixels into tiles (contiguous
+// ranges of pixels) and compresses each tile on its own with CompressTile(),
+// using several threads. The compressed tiles are stored one after another
+// in the output, behind a table giving the number of pixels and the size
+// of each tile. Decompress() reads the table and decompresses the tiles in
+// parallel with DecompressTile(). Since the tiling is recorded in the
+// compressed data the two ends may use different numbers of threads.
+//
+// Tiles are independent, so runs and matches cannot cross tile boundaries.
+// MinimumTileSize bounds the resulting loss of compression ratio.
+//
+// .SECTION See Also
+// vtkSquirtCompressor vtkZlibImageCompressor
+
+#ifndef __vtkTiledImageCompressor_h
+#define __vtkTiledImageCompressor_h
+
+#include "vtkImageCompressor.h"
+
+class vtkMultiThreader;
+
+class VTK_EXPORT vtkTiledImageCompressor : public vtkImageCompressor
+{
+public:
+  vtkTypeRevisionMacro(vtkTiledImageCompressor, vtkImageCompressor);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  // Description:
+  // Number of threads used to compress and decompress tiles. Initialized
+  // to vtkMultiThreader::GetGlobalDefaultNumberOfThreads().
+  vtkSetClampMacro(NumberOfThreads, int, 1, VTK_MAX_THREADS);
+  vtkGetMacro(NumberOfThreads, int);
+
+  // Description:
+  // Smallest number of pixels in a tile. The image is not split into more
+  // tiles than this allows. Default is 65536.
+  vtkSetClampMacro(MinimumTileSize, int, 1, VTK_INT_MAX);
+  vtkGetMacro(MinimumTileSize, int);
+
+  // Description:
+  // Compress/Decompress data array on the objects input with results
+  // in the objects output. See also Set/GetInput/Output.
+  virtual int Compress();
+  virtual int Decompress();
+
+protected:
+  vtkTiledImageCompressor();
+  virtual ~vtkTiledImageCompressor();
+
+  // Description:
+  // Upper bound of the size in bytes of a compressed tile of the given
+  // number of pixels.
+  virtual vtkIdType GetMaximumTileSize(vtkIdType numberOfPixels,
+    int numberOfComponents)=0;
+
+  // Description:
+  // Compress numberOfPixels pixels of numberOfComponents components each
+  // from in into out, which holds GetMaximumTileSize() bytes. Returns the
+  // number of bytes written, or -1 on error. Called concurrently for
+  // different tiles.
+  virtual vtkIdType CompressTile(const unsigned char* in,
+    vtkIdType numberOfPixels, int numberOfComponents, unsigned char* out)=0;
+
+  // Description:
+  // Decompress the size bytes of a tile from in into out, which holds
+  // numberOfPixels pixels of numberOfComponents components each (those of
+  // the output array). Returns 1 on success. Called concurrently for
+  // different tiles.
+  virtual int DecompressTile(const unsigned char* in, vtkIdType size,
+    unsigned char* out, vtkIdType numberOfPixels, int numberOfComponents)=0;
+
+  int NumberOfThreads;
+  int MinimumTileSize;
+
+  vtkMultiThreader* Threader;
+
+private:
+  vtkTiledImageCompressor(const vtkTiledImageCompressor&); // Not implemented.
+  void operator=(const vtkTiledImageCompressor&); // Not implemented.
+
+//BTX
+  class vtkInternals;
+  vtkInternals* Internals;
+  friend class vtkInternals;
+//ETX
+};
+
+#endif
@@ -46,23 +46,29 @@ public:
   void SetStripAlpha(int status){ this->StripAlpha=status; }
   int GetStripAlpha(){ return this->StripAlpha; }
   // Description:
-  // Pre-process the provided image, pre-processed data is return
+  // Pre-process the provided pixels, pre-processed data is return
   // via the "out" paramter. A flag is returned through the "freeOut"
   // parameter indicating weather or not the caller needs to call free
-  // on the returned array. 
+  // on the returned array. Safe to call concurrently on different
+  // pixels.
   void PreProcess(
-      vtkUnsignedCharArray *in,
+      const unsigned char *in,
+      const vtkIdType nTupsIn,
+      const int nCompsIn,
       unsigned char *&out,
       int &nCompsOut,
       vtkIdType &outSize,
       int &freeOut);
   // Description:
-  // Post-process will restore the apha.
-  void PostProcess(
+  // Post-process will restore the apha, writing to "out" which holds
+  // outComps components per pixel. Returns 0 if the pre-processing
+  // cannot be undone into that many components.
+  int PostProcess(
       const unsigned char *in,
       unsigned char const *inEnd,
       const int inComps,
-      vtkUnsignedCharArray *out);
+      unsigned char *out,
+      const int outComps);
   // Description:
   // Print object state to the given stream.
   void PrintSelf(ostream &os, vtkIndent indent);
@@ -231,15 +237,14 @@ void vtkZlibCompressorImageConditioner::CopyRGBRestoreA(
 
 //-----------------------------------------------------------------------------
 void vtkZlibCompressorImageConditioner::PreProcess(
-      vtkUnsignedCharArray *input,
+      const unsigned char *in,
+      const vtkIdType nTupsIn,
+      const int nCompsIn,
       unsigned char *&out,
       int &nCompsOut,
       vtkIdType &outSize,
       int &freeOut)
 {
-  const unsigned char *in=input->GetPointer(0);
-  const int nCompsIn=input->GetNumberOfComponents();
-  const vtkIdType nTupsIn=input->GetNumberOfTuples();
   const vtkIdType inSize=nCompsIn*nTupsIn;
   const unsigned char *inEnd=in+inSize;
 
@@ -297,22 +302,26 @@ void vtkZlibCompressorImageConditioner::PreProcess(
 }
 
 //-----------------------------------------------------------------------------
-void vtkZlibCompressorImageConditioner::PostProcess(
+int vtkZlibCompressorImageConditioner::PostProcess(
       const unsigned char *in,
       unsigned char const *inEnd,
       const int inComps,
-      vtkUnsignedCharArray *output)
+      unsigned char *out,
+      const int outComps)
 {
   // restore alpha
-  const int outComps=output->GetNumberOfComponents();
   const int restoreAlpha=(inComps==3 && outComps==4);
   if (restoreAlpha)
     {
-    vtkIdType outSize=output->GetNumberOfTuples()*outComps;
-    unsigned char *out=(unsigned char *)malloc(outSize);
     this->CopyRGBRestoreA(in,inEnd,out);
-    output->SetArray(out,outSize,0);
+    return 1;
     }
+  if (inComps==outComps)
+    {
+    memcpy(out,in,inEnd-in);
+    return 1;
+    }
+  return 0;
 }
 
 //-----------------------------------------------------------------------------
@@ -406,77 +415,94 @@ void vtkZlibImageCompressor::SetStripAlpha(int status)
 }
 
 //-----------------------------------------------------------------------------
-int vtkZlibImageCompressor::Compress()
+vtkIdType vtkZlibImageCompressor::GetMaximumTileSize(
+  vtkIdType numberOfPixels,
+  int numberOfComponents)
 {
-  if (!(this->Input && this->Output))
-    {
-    vtkWarningMacro("Cannot compress empty input or output detected.");
-    return VTK_ERROR;
-    }
+  // 1 byte for the number of components.
+  return
+    static_cast<vtkIdType>(
+      compressBound(static_cast<uLong>(numberOfPixels*numberOfComponents)))+1;
+}
 
+//-----------------------------------------------------------------------------
+vtkIdType vtkZlibImageCompressor::CompressTile(
+  const unsigned char *in,
+  vtkIdType numberOfPixels,
+  int numberOfComponents,
+  unsigned char *out)
+{
   // Reduce color space and strip alpha if requested.
   unsigned char *inImage;
   int freeInImage;
   vtkIdType inImageSize;
   int inImageComps;
-  this->Conditioner->PreProcess(this->Input,inImage,inImageComps,inImageSize,freeInImage);
+  this->Conditioner->PreProcess(
+    in,numberOfPixels,numberOfComponents,
+    inImage,inImageComps,inImageSize,freeInImage);
 
   // Compress
-  uLongf outImageSize= static_cast<uLongf>(1.001*inImageSize+17);
-    // zlib requires 100.1% + 16, 1 byte for strip alpha
-  unsigned char *outImage=static_cast<unsigned char *>(malloc(outImageSize));
-  outImage[0]=inImageComps;
-  compress2(
-    (Bytef*)(outImage+1),
+  uLongf outImageSize=
+    static_cast<uLongf>(
+      this->GetMaximumTileSize(numberOfPixels,numberOfComponents)-1);
+  out[0]=inImageComps;
+  int ok=compress2(
+    (Bytef*)(out+1),
     &outImageSize,
     (const Bytef*)inImage,
     inImageSize,
     this->CompressionLevel);
 
-  // Package compressed data in a vtk object.
-  this->Output->SetArray(outImage,outImageSize+1,0);
-  this->Output->SetNumberOfComponents(1);
-  this->Output->SetNumberOfTuples(outImageSize+1);
-
   // Clean up after pre-proccesosor.
   if (freeInImage)
     {
     free(inImage);
     }
 
-  return VTK_OK;
+  return ok==Z_OK?static_cast<vtkIdType>(outImageSize)+1:-1;
 }
 
 //-----------------------------------------------------------------------------
-int vtkZlibImageCompressor::Decompress()
+int vtkZlibImageCompressor::DecompressTile(
+  const unsigned char *in,
+  vtkIdType size,
+  unsigned char *out,
+  vtkIdType numberOfPixels,
+  int numberOfComponents)
 {
-  if (!(this->Input && this->Output))
+  if (size<1)
     {
-    vtkWarningMacro("Cannot decompress empty input or output detected.");
-    return VTK_ERROR;
+    return 0;
     }
-
-  // size input.
-  unsigned char *compIm=this->Input->GetPointer(1);
-  const vtkIdType compImSize=this->Input->GetNumberOfTuples()-1;
-
-  // decompress.
-  uLongf decompImSize =
-    static_cast<uLongf>(
-      this->Output->GetNumberOfComponents()*this->Output->GetNumberOfTuples());
-  unsigned char *decompIm=this->Output->GetPointer(0);
-  uncompress(
-    (Bytef*)decompIm,
-    &decompImSize,
-    (const Bytef*)compIm,
-    compImSize);
+  const int decompImComps=in[0];
+  const unsigned char *compIm=in+1;
+  const vtkIdType compImSize=size-1;
+
+  // decompress, in place when no alpha needs to be restored.
+  uLongf decompImSize=static_cast<uLongf>(numberOfPixels*decompImComps);
+  unsigned char *decompIm=out;
+  if (decompImComps!=numberOfComponents)
+    {
+    decompIm=static_cast<unsigned char *>(malloc(decompImSize));
+    }
+  int ok=
+    (uncompress(
+      (Bytef*)decompIm,
+      &decompImSize,
+      (const Bytef*)compIm,
+      compImSize)==Z_OK)
+    && (decompImSize==static_cast<uLongf>(numberOfPixels*decompImComps));
 
   // undo pre-proccssing.
-  const int decompImComps=(this->GetStripAlpha()?3:4);
-  unsigned char const *decompImEnd=decompIm+decompImSize;
-  this->Conditioner->PostProcess(decompIm,decompImEnd,decompImComps,this->Output);
+  if (decompIm!=out)
+    {
+    unsigned char const *decompImEnd=decompIm+decompImSize;
+    ok=ok&&this->Conditioner->PostProcess(
+      decompIm,decompImEnd,decompImComps,out,numberOfComponents);
+    free(decompIm);
+    }
 
-  return VTK_OK;
+  return ok;
 }
 
 //-----------------------------------------------------------------------------
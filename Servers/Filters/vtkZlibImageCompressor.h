@@ -19,31 +19,26 @@
 // varies between 1 and 9, 1 being the fastest at the cost of the
 // compression ratio, 9 producing the highest compression ratio at the
 // cost of speed. Optionally color depth may be reduced and alpha 
-// stripped/restored.
+// stripped/restored. The image is split into tiles that are deflated
+// independently on several threads, see vtkTiledImageCompressor.
 // .SECTION Thanks
 // SciberQuest Inc. contributed this class.
 
 #ifndef __vtkZlibImageCompressor_h
 #define __vtkZlibImageCompressor_h
 
-#include "vtkImageCompressor.h"
+#include "vtkTiledImageCompressor.h"
 
 class vtkZlibCompressorImageConditioner;
 class vtkMultiProcessStream;
 
-class VTK_EXPORT vtkZlibImageCompressor : public vtkImageCompressor
+class VTK_EXPORT vtkZlibImageCompressor : public vtkTiledImageCompressor
 {
 public:
   static vtkZlibImageCompressor* New();
-  vtkTypeRevisionMacro(vtkZlibImageCompressor, vtkImageCompressor);
+  vtkTypeRevisionMacro(vtkZlibImageCompressor, vtkTiledImageCompressor);
   void PrintSelf(ostream& os, vtkIndent indent);
 
-  // Description:
-  // Compress/Decompress data array on the objects input with results
-  // in the objects output. See also Set/GetInput/Output.
-  virtual int Compress();
-  virtual int Decompress();
-
   //BTX
   // Description:
   // Serialize/Restore compressor configuration (but not the data) into the stream.
@@ -87,6 +82,15 @@ protected:
   vtkZlibImageCompressor();
   virtual ~vtkZlibImageCompressor();
 
+  // Description:
+  // Deflate/inflate one tile. A compressed tile is the number of
+  // components after pre-processing (1 byte) followed by the zlib data.
+  virtual vtkIdType GetMaximumTileSize(vtkIdType numberOfPixels,
+    int numberOfComponents);
+  virtual vtkIdType CompressTile(const unsigned char* in,
+    vtkIdType numberOfPixels, int numberOfComponents, unsigned char* out);
+  virtual int DecompressTile(const unsigned char* in, vtkIdType size,
+    unsigned char* out, vtkIdType numberOfPixels, int numberOfComponents);
 
 private:
   vtkZlibCompressorImageConditioner *Conditioner; // manages color space reduction and strip alpha
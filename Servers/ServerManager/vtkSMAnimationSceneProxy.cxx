@@ -126,6 +126,7 @@ vtkSMAnimationSceneProxy::vtkSMAnimationSceneProxy()
   this->OverrideStillRender = 0;
   this->Internals = new vtkInternals();
   this->CacheLimit = 100*1024; // 100 MBs.
+  this->PrefetchTimeSteps = 0;
   this->Caching = 0;
   this->AnimationPlayer = 0;
   this->PlayerObserver = vtkPlayerObserver::New();
@@ -364,6 +365,7 @@ void vtkSMAnimationSceneProxy::TickInternal(void* info)
     // Render All Views.
     this->Internals->StillRenderAllViews();
     }
+  this->PrefetchCache();
 
   this->Superclass::TickInternal(info);
   this->InTick = false;
@@ -445,6 +447,32 @@ void vtkSMAnimationSceneProxy::CacheUpdate(void* info)
   this->Internals->PassCacheTime(cachetime);
 }
 
+//----------------------------------------------------------------------------
+void vtkSMAnimationSceneProxy::PrefetchCache()
+{
+  if (!this->GetCaching() || this->PrefetchTimeSteps <= 0)
+    {
+    return;
+    }
+
+  // The frame is on screen, use the time until the next tick to fill the
+  // caches ahead of the current time. As for the cache use decided in
+  // vtkSMRepresentationStrategy::UpdatePipeline(), the stream reaches all the
+  // data server processes, which agree there on the time steps to update.
+  vtkProcessModule* pm = vtkProcessModule::GetProcessModule();
+  vtkClientServerStream stream; 
+  stream  << vtkClientServerStream::Invoke
+          << pm->GetProcessModuleID()
+          << "GetCacheSizeKeeper"
+          << vtkClientServerStream::End;
+  stream  << vtkClientServerStream::Invoke
+          << vtkClientServerStream::LastResult
+          << "Prefetch"
+          << this->PrefetchTimeSteps
+          << vtkClientServerStream::End;
+  pm->SendStream(this->ConnectionID, vtkProcessModule::DATA_SERVER, stream);
+}
+
 //----------------------------------------------------------------------------
 void vtkSMAnimationSceneProxy::SetAnimationTime(double time)
 {
@@ -481,5 +509,6 @@ void vtkSMAnimationSceneProxy::PrintSelf(ostream& os, vtkIndent indent)
   this->Superclass::PrintSelf(os, indent);
   os << indent << "OverrideStillRender: " << this->OverrideStillRender << endl;
   os << indent << "CacheLimit: " << this->CacheLimit << endl;
+  os << indent << "PrefetchTimeSteps: " << this->PrefetchTimeSteps << endl;
   os << indent << "Caching: " << this->Caching << endl;
 }
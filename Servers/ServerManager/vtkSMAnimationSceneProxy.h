@@ -67,6 +67,13 @@ public:
   vtkGetMacro(CacheLimit, int);
   vtkSetMacro(CacheLimit, int);
 
+  // Description:
+  // When caching, number of time steps after the current one that the
+  // servers cache once a frame has been rendered, within their cache
+  // memory budget. Default is 0 (no prefetching).
+  vtkGetMacro(PrefetchTimeSteps, int);
+  vtkSetMacro(PrefetchTimeSteps, int);
+
   // Description:
   // Set if caching is enabled.
   // This method synchronizes the cahcing flag on every cue.
@@ -137,6 +144,10 @@ protected:
   vtkSetMacro(OverrideStillRender, int);
 
   int CacheLimit; // in KiloBytes.
+  int PrefetchTimeSteps;
+
+  // Ask the servers to cache the next PrefetchTimeSteps time steps.
+  void PrefetchCache();
 
   vtkSMProxy* AnimationPlayer;
   vtkSMTimeKeeperProxy* TimeKeeper;
@@ -1166,6 +1166,10 @@ void vtkSMProxyManager::LoadState(vtkPVXMLElement* rootElement, vtkIdType id,
     info.ProxyLocator = spLoader->GetProxyLocator();
     this->InvokeEvent(vtkCommand::LoadStateEvent, &info);
     }
+
+  // Let the server start working on whatever loading the state left in
+  // the connection's pending batch.
+  vtkProcessModule::GetProcessModule()->FlushStreams(id);
 }
 
 //---------------------------------------------------------------------------
@@ -98,6 +98,7 @@ vtkCxxRevisionMacro(vtkSMRenderViewProxy, "$Revision$");
 vtkStandardNewMacro(vtkSMRenderViewProxy);
 
 vtkInformationKeyMacro(vtkSMRenderViewProxy, LOD_RESOLUTION, Integer);
+vtkInformationKeyMacro(vtkSMRenderViewProxy, LOD_TRIANGLE_BUDGET, Integer);
 vtkInformationKeyMacro(vtkSMRenderViewProxy, USE_COMPOSITING, Integer);
 vtkInformationKeyMacro(vtkSMRenderViewProxy, USE_LOD, Integer);
 vtkInformationKeyMacro(vtkSMRenderViewProxy, USE_ORDERED_COMPOSITING, Integer);
@@ -139,6 +140,7 @@ vtkSMRenderViewProxy::vtkSMRenderViewProxy()
 
   this->SetUseLOD(false);
   this->SetLODResolution(50);
+  this->SetLODTriangleBudget(250000);
   this->Information->Set(USE_ORDERED_COMPOSITING(), 0);
   this->Information->Set(USE_COMPOSITING(), 0);
 
@@ -512,6 +514,18 @@ int vtkSMRenderViewProxy::GetLODResolution()
   return this->Information->Get(LOD_RESOLUTION());
 }
 
+//-----------------------------------------------------------------------------
+void vtkSMRenderViewProxy::SetLODTriangleBudget(int budget)
+{
+  this->Information->Set(LOD_TRIANGLE_BUDGET(), budget);
+}
+
+//-----------------------------------------------------------------------------
+int vtkSMRenderViewProxy::GetLODTriangleBudget()
+{
+  return this->Information->Get(LOD_TRIANGLE_BUDGET());
+}
+
 //-----------------------------------------------------------------------------
 void vtkSMRenderViewProxy::SetUseLOD(bool use_lod)
 {
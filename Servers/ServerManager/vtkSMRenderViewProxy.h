@@ -51,6 +51,7 @@ public:
   // Keys used to specify view rendering requirements.
   static vtkInformationIntegerKey* USE_LOD();
   static vtkInformationIntegerKey* LOD_RESOLUTION();
+  static vtkInformationIntegerKey* LOD_TRIANGLE_BUDGET();
   static vtkInformationIntegerKey* USE_COMPOSITING();
   static vtkInformationIntegerKey* USE_ORDERED_COMPOSITING();
   
@@ -67,6 +68,13 @@ public:
   // Get/Set the LOD Resolution.
   void SetLODResolution(int);
   int GetLODResolution();
+
+  // Description:
+  // Get/Set the number of triangles LOD geometry is decimated to at a LOD
+  // Resolution of 50, scaled by the square of the resolution over 50. When
+  // 0, the LOD Resolution is used as the number of divisions instead.
+  void SetLODTriangleBudget(int);
+  int GetLODTriangleBudget();
    
   // Description:
   // Access to the rendering-related objects for the GUI.
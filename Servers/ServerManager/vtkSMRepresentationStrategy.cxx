@@ -43,6 +43,7 @@ vtkSMRepresentationStrategy::vtkSMRepresentationStrategy()
   this->LODDataValid = false;
   this->LODDataSize = 0;
   this->LODResolution = 50;
+  this->LODTriangleBudget = 0;
   this->LODInformationValid =false;
 
   this->DataValid = false;
@@ -282,6 +283,9 @@ void vtkSMRepresentationStrategy::UpdatePipeline()
     cachingEnabled? 1 : 0);
   vtkSMPropertyHelper(this->CacheKeeper, "CacheTime").Set(this->CacheTime);
   this->CacheKeeper->UpdateVTKObjects();
+  // The data server processes agree on using the cache here, where they all
+  // receive the call, rather than in the pipeline passes.
+  this->CacheKeeper->InvokeCommand("UpdateUseCache");
   if (cachingEnabled)
     {
     this->SomethingCached = true;
@@ -384,6 +388,12 @@ void vtkSMRepresentationStrategy::ProcessViewInformation()
     this->SetLODResolution(
       this->ViewInformation->Get(vtkSMRenderViewProxy::LOD_RESOLUTION()));
     }
+
+  if (this->ViewInformation->Has(vtkSMRenderViewProxy::LOD_TRIANGLE_BUDGET()))
+    {
+    this->SetLODTriangleBudget(
+      this->ViewInformation->Get(vtkSMRenderViewProxy::LOD_TRIANGLE_BUDGET()));
+    }
 }
 
 //----------------------------------------------------------------------------
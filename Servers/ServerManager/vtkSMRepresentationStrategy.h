@@ -272,6 +272,19 @@ protected:
       }
     }
 
+  // Description:
+  // Called when the ViewInformation is modified to set the number of
+  // triangles of the LOD geometry. This invalidates the LOD pipeline if the
+  // budget has indeed changed.
+  virtual void SetLODTriangleBudget(int budget)
+    {
+    if (this->LODTriangleBudget != budget)
+      {
+      this->LODTriangleBudget = budget;
+      this->InvalidateLODPipeline();
+      }
+    }
+
   // Description:
   // Returns true is data is valid.
   virtual bool GetDataValid()
@@ -294,6 +307,7 @@ protected:
   bool LODInformationValid;
 
   int LODResolution;
+  int LODTriangleBudget;
 
   // When set to true, LODPipeline is always udpated with the full-res pipeline
   // (unless EnableLOD is false).
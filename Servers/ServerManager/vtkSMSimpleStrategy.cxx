@@ -22,6 +22,8 @@
 #include "vtkSMIntVectorProperty.h"
 #include "vtkSMSourceProxy.h"
 
+#include <vtkstd/algorithm>
+
 vtkStandardNewMacro(vtkSMSimpleStrategy);
 vtkCxxRevisionMacro(vtkSMSimpleStrategy, "$Revision$");
 //----------------------------------------------------------------------------
@@ -158,6 +160,42 @@ void vtkSMSimpleStrategy::SetLODResolution(int resolution)
       this->LODDecimator->UpdateVTKObjects();
       }
     }
+  this->UpdateLODDecimatorBudget();
+}
+
+//----------------------------------------------------------------------------
+void vtkSMSimpleStrategy::SetLODTriangleBudget(int budget)
+{
+  this->Superclass::SetLODTriangleBudget(budget);
+  this->UpdateLODDecimatorBudget();
+}
+
+//----------------------------------------------------------------------------
+void vtkSMSimpleStrategy::UpdateLODDecimatorBudget()
+{
+  if (!this->LODDecimator)
+    {
+    return;
+    }
+  vtkSMIntVectorProperty* ivp = vtkSMIntVectorProperty::SafeDownCast(
+    this->LODDecimator->GetProperty("MaximumNumberOfTriangles"));
+  if (!ivp)
+    {
+    return;
+    }
+
+  // The budget is for the default resolution of 50. Clustering a surface
+  // into r^3 bins makes a number of triangles that grows as r^2, so the
+  // budget is scaled likewise.
+  double budget = this->LODTriangleBudget;
+  if (budget > 0.0)
+    {
+    double scale = vtkstd::max(this->LODResolution, 1)/50.0;
+    budget = vtkstd::min(vtkstd::max(budget*scale*scale, 1.0),
+                         static_cast<double>(VTK_LARGE_INTEGER));
+    }
+  ivp->SetElement(0, static_cast<int>(budget));
+  this->LODDecimator->UpdateVTKObjects();
 }
 
 //----------------------------------------------------------------------------
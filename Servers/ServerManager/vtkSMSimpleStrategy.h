@@ -90,6 +90,18 @@ protected:
   // has indeed changed.
   virtual void SetLODResolution(int resolution);
 
+  // Description:
+  // Called when the ViewHelperProxy is modified to set the number of
+  // triangles of the LOD geometry. Pushed to the LODDecimator when it
+  // supports it, in which case the LOD resolution scales the budget, and
+  // sets the number of divisions when the budget is 0.
+  virtual void SetLODTriangleBudget(int budget);
+
+  // Description:
+  // Pushes the triangle budget, scaled by the square of the LOD resolution
+  // over 50, to the LODDecimator when it supports it.
+  void UpdateLODDecimatorBudget();
+
   vtkSMSourceProxy* UpdateSuppressor;
   vtkSMSourceProxy* UpdateSuppressorLOD;
   vtkSMSourceProxy* LODDecimator;
@@ -29,6 +29,11 @@
  *		buffer.
  *
  * The following macros are optional:
+ *	COUNT_INACTIVE(max) - gives the number of inactive pixels, up to max,
+ *		starting at the current pixel.  If defined, INCREMENT_PIXELS
+ *		must be defined too and are used to skip inactive pixels in
+ *		bulk rather than testing them one at a time with ACTIVE().
+ *	INCREMENT_PIXELS(count) - Increments count pixels.
  *	PADDING - If defined, enables inactive pixels to be placed
  *		around the file.  If defined, then SPACE_BOTTOM, SPACE_TOP,
  *		SPACE_LEFT, SPACE_RIGHT, FULL_WIDTH, and FULL_HEIGHT must
@@ -63,6 +68,9 @@
     GLuint _pixels = PIXEL_COUNT;
     GLuint _p;
     GLuint _count;
+#ifdef COUNT_INACTIVE
+    GLuint _skip;
+#endif
 #ifdef DEBUG
     GLuint _totalcount = 0;
 #endif
@@ -90,11 +98,18 @@
 	    _count += SPACE_LEFT;
 	    while (ICET_TRUE) {
 		GLuint *_runlengths;
+#ifdef COUNT_INACTIVE
+		_skip = COUNT_INACTIVE((GLuint)(_lastx - _x));
+		_x += (int)_skip;
+		_count += _skip;
+		INCREMENT_PIXELS(_skip);
+#else
 		while ((_x < _lastx) && (!ACTIVE())) {
 		    _x++;
 		    _count++;
 		    INCREMENT_PIXEL();
 		}
+#endif
 		if (_x >= _lastx) break;
 		_runlengths = _dest++;
 		while (_count > 0xFFFF) {
@@ -134,11 +149,18 @@
 	while (_p < _pixels) {
 	    GLuint *_runlengths = _dest++;
 	  /* Count background pixels. */
+#ifdef COUNT_INACTIVE
+	    _skip = COUNT_INACTIVE(_pixels - _p);
+	    _p += _skip;
+	    _count += _skip;
+	    INCREMENT_PIXELS(_skip);
+#else
 	    while ((_p < _pixels) && (!ACTIVE())) {
 		_p++;
 		_count++;
 		INCREMENT_PIXEL();
 	    }
+#endif
 	    while (_count > 0xFFFF) {
 		INACTIVE_RUN_LENGTH(*_runlengths) = 0xFFFF;
 		ACTIVE_RUN_LENGTH(*_runlengths) = 0;
@@ -220,6 +242,11 @@
 #undef INCREMENT_PIXEL
 #undef COMPRESSED_SIZE
 
+#ifdef COUNT_INACTIVE
+#undef COUNT_INACTIVE
+#undef INCREMENT_PIXELS
+#endif
+
 #ifdef PADDING
 #undef PADDING
 #undef SPACE_BOTTOM
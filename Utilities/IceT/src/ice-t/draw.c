@@ -143,6 +143,24 @@ void icetDataReplicationGroupColor(GLint color)
     icetDataReplicationGroup(size, mygroup);
 }
 
+void icetMagicK(GLint magic_k)
+{
+    if (magic_k < 2) {
+        icetRaiseError("Magic k must be at least 2.", ICET_INVALID_VALUE);
+        return;
+    }
+    icetStateSetInteger(ICET_MAGIC_K, magic_k);
+}
+
+void icetCompositeThreads(GLint num_threads)
+{
+    if (num_threads < 1) {
+        icetRaiseError("Need at least 1 composite thread.", ICET_INVALID_VALUE);
+        return;
+    }
+    icetStateSetInteger(ICET_COMPOSITE_THREADS, num_threads);
+}
+
 GLubyte *icetGetColorBuffer(void)
 {
     GLint color_buffer_valid;
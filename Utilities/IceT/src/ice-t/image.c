@@ -18,6 +18,21 @@
 #include <stdlib.h>
 #include <string.h>
 
+#ifdef ICET_USE_PTHREADS
+#include <pthread.h>
+#endif
+
+#if defined(WIN32) || defined(ICET_USE_PTHREADS)
+#define ICET_USE_THREADS
+#endif
+
+/* The pixel kernels use SSE2 when the compiler targets it. */
+#if    defined(__SSE2__) || defined(_M_X64)                        \
+    || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define ICET_USE_SSE2
+#include <emmintrin.h>
+#endif
+
 #define GET_MAGIC_NUM(buf)      (((GLuint *)(buf))[0])
 #define GET_PIXEL_COUNT(buf)    (((GLuint *)(buf))[1])
 #define GET_DATA_START(buf)     (((GLuint *)(buf)) + 2)
@@ -39,6 +54,28 @@
 #pragma warning(disable:4055)
 #endif
 
+/* Composites of images smaller than MIN_PIXELS_PER_THREAD pixels per
+ * thread are not worth splitting over threads. */
+#define MIN_PIXELS_PER_THREAD   0x10000
+#define MAX_COMPOSITE_THREADS   64
+
+/* The part of a composite done by one thread.  Full images give srcColor
+ * and srcDepth, sparse images give the run lengths of the first run of the
+ * part, runs, and their type.  The destination buffers point to the first
+ * pixel of the part. */
+typedef struct _IceTCompositeJob {
+    void (*func)(struct _IceTCompositeJob *);
+    GLuint *destColor;
+    GLuint *destDepth;
+    const GLuint *srcColor;
+    const GLuint *srcDepth;
+    const GLuint *runs;
+    GLuint type;
+    GLuint pixels;
+    int srcOnTop;
+    int corrupt;
+} IceTCompositeJob;
+
 /* Renders the geometry for a tile.  The geometry may not be projected
  * exactly into the tile.  screen_viewport gives the offset and dimensions
  * of the image in the OpenGL framebuffer.  tile_viewport gives the offset
@@ -69,6 +106,43 @@ static void readSubImage(GLint fb_x, GLint fb_y,
  * to make sure the first entry is not less than ICET_FAR_DEPTH.  If so,
  * the parameter is corrected. */
 static GLuint getFarDepth(const GLuint *depthBuffer);
+/* Composites count pixels by depth.  Where srcDepth is closer than
+ * destDepth, the source depth and color replace the destination ones.
+ * srcColor and destColor are NULL for depth only images. */
+static void compositeDepthSpan(GLuint *destColor, GLuint *destDepth,
+                               const GLuint *srcColor, const GLuint *srcDepth,
+                               GLuint count);
+/* Like compositeDepthSpan, except that the source colors and depths are
+ * interleaved in src as in the active runs of sparse images. */
+static void compositeInterleavedDepthSpan(GLuint *destColor,
+                                          GLuint *destDepth,
+                                          const GLuint *src, GLuint count);
+/* Blends count pixels of src over (srcOnTop) or under dest.  The result is
+ * exactly that of ICET_OVER and ICET_UNDER. */
+static void blendSpan(GLuint *dest, const GLuint *src, GLuint count,
+                      int srcOnTop);
+/* Returns the number of pixels, up to max, from the start of the buffer
+ * that are at far_depth or fully transparent. */
+static GLuint countFarDepth(const GLuint *depth, GLuint far_depth,
+                            GLuint max);
+static GLuint countTransparent(const GLuint *color, GLuint max);
+/* Callbacks of runCompositeJobs for full and sparse images. */
+static void compositeFullJob(IceTCompositeJob *job);
+static void compositeSparseJob(IceTCompositeJob *job);
+/* Returns the number of threads to composite an image with the given
+ * number of pixels.  It is 1 unless ICET_COMPOSITE_THREADS allows more and
+ * the image is large enough. */
+static int getNumCompositeJobs(GLuint pixels);
+/* Splits the runs of a sparse image into num_jobs parts of about the same
+ * number of pixels.  Sets the runs, pixels and destination offsets of the
+ * jobs, which are offsets into the destination buffers given in the first
+ * job.  Returns the number of jobs or 0 if the image is corrupt. */
+static int splitSparseImage(const IceTSparseImage srcBuffer, int num_jobs,
+                            IceTCompositeJob *jobs);
+/* Calls func on each job, all but the first one on their own thread if
+ * threads are available. */
+static void runCompositeJobs(void (*func)(IceTCompositeJob *),
+                             IceTCompositeJob *jobs, int num_jobs);
 /* Gets a static image buffer that is shared amongst all contexts (and
  * therefore not thread safe.  The buffer is resized as necessary. */
 static void getBuffers(GLuint type, GLuint pixels, IceTImage *bufferp);
@@ -252,8 +326,10 @@ GLuint icetGetCompressedTileImage(GLint tile, IceTSparseImage buffer)
 #define COMPRESSED_BUFFER       buffer
 #define PIXEL_COUNT             width*height
 #define ACTIVE()                (*depth != far_depth)
+#define COUNT_INACTIVE(max)     countFarDepth(depth, far_depth, max)
 #define WRITE_PIXEL(dest)       *(dest++) = *color;  *(dest++) = *depth;
 #define INCREMENT_PIXEL()       color++;  depth++;
+#define INCREMENT_PIXELS(count) color += count;  depth += count;
 #define COMPRESSED_SIZE         compressedSize
 #define PADDING
 #define SPACE_BOTTOM    space_bottom
@@ -268,8 +344,10 @@ GLuint icetGetCompressedTileImage(GLint tile, IceTSparseImage buffer)
 #define COMPRESSED_BUFFER       buffer
 #define PIXEL_COUNT             width*height
 #define ACTIVE()                (*depth != far_depth)
+#define COUNT_INACTIVE(max)     countFarDepth(depth, far_depth, max)
 #define WRITE_PIXEL(dest)       *(dest++) = *depth;
 #define INCREMENT_PIXEL()       depth++;
+#define INCREMENT_PIXELS(count) depth += count;
 #define COMPRESSED_SIZE         compressedSize
 #define PADDING
 #define SPACE_BOTTOM    space_bottom
@@ -286,8 +364,10 @@ GLuint icetGetCompressedTileImage(GLint tile, IceTSparseImage buffer)
 #define COMPRESSED_BUFFER       buffer
 #define PIXEL_COUNT             width*height
 #define ACTIVE()                (((GLubyte*)color)[3] != 0x00)
+#define COUNT_INACTIVE(max)     countTransparent(color, max)
 #define WRITE_PIXEL(dest)       *(dest++) = *color;
 #define INCREMENT_PIXEL()       color++;
+#define INCREMENT_PIXELS(count) color += count;
 #define COMPRESSED_SIZE         compressedSize
 #define PADDING
 #define SPACE_BOTTOM    space_bottom
@@ -329,8 +409,10 @@ GLuint icetCompressSubImage(const IceTImage imageBuffer,
 #define COMPRESSED_BUFFER       compressedBuffer
 #define PIXEL_COUNT             pixels
 #define ACTIVE()                (*depth != far_depth)
+#define COUNT_INACTIVE(max)     countFarDepth(depth, far_depth, max)
 #define WRITE_PIXEL(dest)       *(dest++) = *color;  *(dest++) = *depth;
 #define INCREMENT_PIXEL()       color++;  depth++;
+#define INCREMENT_PIXELS(count) color += count;  depth += count;
 #define COMPRESSED_SIZE         compressedSize
 #include "compress_func_body.h"
         } else {
@@ -338,8 +420,10 @@ GLuint icetCompressSubImage(const IceTImage imageBuffer,
 #define COMPRESSED_BUFFER       compressedBuffer
 #define PIXEL_COUNT             pixels
 #define ACTIVE()                (*depth != far_depth)
+#define COUNT_INACTIVE(max)     countFarDepth(depth, far_depth, max)
 #define WRITE_PIXEL(dest)       *(dest++) = *depth;
 #define INCREMENT_PIXEL()       depth++;
+#define INCREMENT_PIXELS(count) depth += count;
 #define COMPRESSED_SIZE         compressedSize
 #include "compress_func_body.h"
         }
@@ -349,8 +433,10 @@ GLuint icetCompressSubImage(const IceTImage imageBuffer,
 #define COMPRESSED_BUFFER       compressedBuffer
 #define PIXEL_COUNT             pixels
 #define ACTIVE()                (((GLubyte*)color)[3] != 0x00)
+#define COUNT_INACTIVE(max)     countTransparent(color, max)
 #define WRITE_PIXEL(dest)       *(dest++) = *color;
 #define INCREMENT_PIXEL()       color++;
+#define INCREMENT_PIXELS(count) color += count;
 #define COMPRESSED_SIZE         compressedSize
 #include "compress_func_body.h"
     }
@@ -435,7 +521,9 @@ void icetComposite(IceTImage destBuffer, const IceTImage srcBuffer,
     const GLuint *srcColorBuffer;
     const GLuint *srcDepthBuffer;
     GLuint pixels;
-    GLuint i;
+    IceTCompositeJob jobs[MAX_COMPOSITE_THREADS];
+    int num_jobs;
+    int i;
     GLdouble timer;
     GLdouble *compare_time;
 
@@ -460,36 +548,19 @@ void icetComposite(IceTImage destBuffer, const IceTImage srcBuffer,
     compare_time = icetUnsafeStateGet(ICET_COMPARE_TIME);
     timer = icetWallTime();
 
-    if (srcDepthBuffer) {
-        if (srcColorBuffer) {
-            for (i = 0; i < pixels; i++) {
-                if (srcDepthBuffer[i] < destDepthBuffer[i]) {
-                    destDepthBuffer[i] = srcDepthBuffer[i];
-                    destColorBuffer[i] = srcColorBuffer[i];
-                }
-            }
-        } else {
-            for (i = 0; i < pixels; i++) {
-                if (srcDepthBuffer[i] < destDepthBuffer[i]) {
-                    destDepthBuffer[i] = srcDepthBuffer[i];
-                }
-            }
-        }
-    } else {
-        if (srcOnTop) {
-            for (i = 0; i < pixels; i++) {
-              /* The blending should probably be more flexible. */
-                ICET_OVER((GLubyte *)(&srcColorBuffer[i]),
-                          (GLubyte *)(&destColorBuffer[i]));
-            }
-        } else {
-            for (i = 0; i < pixels; i++) {
-              /* The blending should probably be more flexible. */
-                ICET_UNDER((GLubyte *)(&srcColorBuffer[i]),
-                           (GLubyte *)(&destColorBuffer[i]));
-            }
-        }
+  /* Give each thread an even part of the pixels. */
+    num_jobs = getNumCompositeJobs(pixels);
+    for (i = 0; i < num_jobs; i++) {
+        GLuint first = (pixels/num_jobs)*i;
+        GLuint last = (i < num_jobs-1) ? (pixels/num_jobs)*(i+1) : pixels;
+        jobs[i].destColor = destColorBuffer ? destColorBuffer + first : NULL;
+        jobs[i].destDepth = destDepthBuffer ? destDepthBuffer + first : NULL;
+        jobs[i].srcColor = srcColorBuffer ? srcColorBuffer + first : NULL;
+        jobs[i].srcDepth = srcDepthBuffer ? srcDepthBuffer + first : NULL;
+        jobs[i].pixels = last - first;
+        jobs[i].srcOnTop = srcOnTop;
     }
+    runCompositeJobs(compositeFullJob, jobs, num_jobs);
 
     *compare_time += icetWallTime() - timer;
 }
@@ -508,6 +579,9 @@ void icetCompressedSubComposite(IceTImage destBuffer,
 {
     GLuint *destColor;
     GLuint *destDepth;
+    IceTCompositeJob jobs[MAX_COMPOSITE_THREADS];
+    int num_jobs;
+    int i;
     GLdouble timer;
     GLdouble *compare_time;
 
@@ -526,59 +600,36 @@ void icetCompressedSubComposite(IceTImage destBuffer,
         return;
     }
 
-    destColor = (GLuint *)icetGetImageColorBuffer(destBuffer) + offset;
-    destDepth = icetGetImageDepthBuffer(destBuffer) + offset;
+    destColor = (GLuint *)icetGetImageColorBuffer(destBuffer);
+    destDepth = icetGetImageDepthBuffer(destBuffer);
+
+    jobs[0].destColor = destColor ? destColor + offset : NULL;
+    jobs[0].destDepth = destDepth ? destDepth + offset : NULL;
+    jobs[0].runs = GET_DATA_START(srcBuffer);
+    jobs[0].pixels = pixels;
+    num_jobs = getNumCompositeJobs(pixels);
+    if (num_jobs > 1) {
+        num_jobs = splitSparseImage(srcBuffer, num_jobs, jobs);
+        if (num_jobs == 0) {
+            icetRaiseError("Corrupt compressed image.", ICET_INVALID_VALUE);
+            return;
+        }
+    }
+    for (i = 0; i < num_jobs; i++) {
+        jobs[i].type = GET_MAGIC_NUM(srcBuffer);
+        jobs[i].srcOnTop = srcOnTop;
+        jobs[i].corrupt = 0;
+    }
+    runCompositeJobs(compositeSparseJob, jobs, num_jobs);
 
-    switch (GET_MAGIC_NUM(srcBuffer)) {
-      case SPARSE_IMAGE_CD_MAGIC_NUM:
-#define COMPRESSED_BUFFER       srcBuffer
-#define READ_PIXEL(src)                                 \
-    if (src[1] < *destDepth) {                          \
-        *destColor = src[0];                            \
-        *destDepth = src[1];                            \
-    }                                                   \
-    src += 2;
-#define INCREMENT_PIXEL()       destColor++;  destDepth++;
-#define INCREMENT_INACTIVE_PIXELS(count) destColor += count; destDepth += count;
-#include "decompress_func_body.h"
-          break;
-      case SPARSE_IMAGE_D_MAGIC_NUM:
-#define COMPRESSED_BUFFER       srcBuffer
-#define READ_PIXEL(src)                                 \
-    if (src[0] < *destDepth) {                          \
-        *destDepth = src[0];                            \
-    }                                                   \
-    src += 1;
-#define INCREMENT_PIXEL()       destDepth++;
-#define INCREMENT_INACTIVE_PIXELS(count) destDepth += count;
-#include "decompress_func_body.h"
-          break;
-      case SPARSE_IMAGE_C_MAGIC_NUM:
-          if (srcOnTop) {
-#define COMPRESSED_BUFFER       srcBuffer
-#define READ_PIXEL(srcColor)                                            \
-    {                                                                   \
-      /* The blending should probably be more flexible. */              \
-        ICET_OVER((GLubyte *)(srcColor), (GLubyte *)(destColor));       \
-    }                                                                   \
-    srcColor += 1;
-#define INCREMENT_PIXEL()       destColor++;
-#define INCREMENT_INACTIVE_PIXELS(count) destColor += count;
-#include "decompress_func_body.h"
-          } else {
-#define COMPRESSED_BUFFER       srcBuffer
-#define READ_PIXEL(srcColor)                                            \
-    {                                                                   \
-      /* The blending should probably be more flexible. */              \
-        ICET_UNDER((GLubyte *)(srcColor), (GLubyte *)(destColor));      \
-    }                                                                   \
-    srcColor += 1;
-#define INCREMENT_PIXEL()       destColor++;
-#define INCREMENT_INACTIVE_PIXELS(count) destColor += count;
-#include "decompress_func_body.h"
-          }
-          break;
+    for (i = 0; i < num_jobs; i++) {
+        if (jobs[i].corrupt) {
+            icetRaiseError("Corrupt compressed image.", ICET_INVALID_VALUE);
+            break;
+        }
     }
+
+    *compare_time += icetWallTime() - timer;
 }
 
 /* Makes sure that all the information for the current tile is rendered and
@@ -934,6 +985,355 @@ static GLuint getFarDepth(const GLuint *depthBuffer)
     return far_depth;
 }
 
+#ifdef ICET_USE_SSE2
+/* Selects a where mask is set and b elsewhere. */
+#define SELECT_SSE2(mask, a, b)                                         \
+    _mm_or_si128(_mm_and_si128((mask), (a)), _mm_andnot_si128((mask), (b)))
+
+/* Returns the mask of the lanes where the unsigned depth a is less than b.
+ * SSE2 only compares signed integers, so the sign bits are flipped. */
+static __m128i closerDepthSSE2(__m128i a, __m128i b)
+{
+    const __m128i sign = _mm_set1_epi32((int)0x80000000);
+    return _mm_cmplt_epi32(_mm_xor_si128(a, sign), _mm_xor_si128(b, sign));
+}
+
+/* Blends bottom under top for two pixels with 16 bit channels:
+ * top + (bottom*(255 - top alpha))/255, truncated to 8 bits. */
+static __m128i blendHalfSSE2(__m128i top, __m128i bottom)
+{
+    const __m128i one = _mm_set1_epi16(1);
+    const __m128i max = _mm_set1_epi16(0xFF);
+    __m128i factor;
+    __m128i x;
+
+    factor = _mm_shufflelo_epi16(top, _MM_SHUFFLE(3, 3, 3, 3));
+    factor = _mm_shufflehi_epi16(factor, _MM_SHUFFLE(3, 3, 3, 3));
+    factor = _mm_sub_epi16(max, factor);
+    x = _mm_mullo_epi16(bottom, factor);
+  /* x/255 == (x + 1 + x/256)/256 for all x <= 255*255. */
+    x = _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(x, one),
+                                     _mm_srli_epi16(x, 8)), 8);
+    return _mm_and_si128(_mm_add_epi16(top, x), max);
+}
+
+/* Blends four pixels of bottom under top. */
+static __m128i blendSSE2(__m128i top, __m128i bottom)
+{
+    const __m128i zero = _mm_setzero_si128();
+    __m128i lo, hi;
+
+    lo = blendHalfSSE2(_mm_unpacklo_epi8(top, zero),
+                       _mm_unpacklo_epi8(bottom, zero));
+    hi = blendHalfSSE2(_mm_unpackhi_epi8(top, zero),
+                       _mm_unpackhi_epi8(bottom, zero));
+    return _mm_packus_epi16(lo, hi);
+}
+#endif /* ICET_USE_SSE2 */
+
+static void compositeDepthSpan(GLuint *destColor, GLuint *destDepth,
+                               const GLuint *srcColor, const GLuint *srcDepth,
+                               GLuint count)
+{
+    GLuint i = 0;
+
+#ifdef ICET_USE_SSE2
+    for ( ; i + 4 <= count; i += 4) {
+        __m128i sd = _mm_loadu_si128((const __m128i *)(srcDepth + i));
+        __m128i dd = _mm_loadu_si128((const __m128i *)(destDepth + i));
+        __m128i closer = closerDepthSSE2(sd, dd);
+        if (_mm_movemask_epi8(closer) == 0) continue;
+        _mm_storeu_si128((__m128i *)(destDepth + i),
+                         SELECT_SSE2(closer, sd, dd));
+        if (srcColor) {
+            __m128i sc = _mm_loadu_si128((const __m128i *)(srcColor + i));
+            __m128i dc = _mm_loadu_si128((const __m128i *)(destColor + i));
+            _mm_storeu_si128((__m128i *)(destColor + i),
+                             SELECT_SSE2(closer, sc, dc));
+        }
+    }
+#endif
+
+    if (srcColor) {
+        for ( ; i < count; i++) {
+            if (srcDepth[i] < destDepth[i]) {
+                destDepth[i] = srcDepth[i];
+                destColor[i] = srcColor[i];
+            }
+        }
+    } else {
+        for ( ; i < count; i++) {
+            if (srcDepth[i] < destDepth[i]) {
+                destDepth[i] = srcDepth[i];
+            }
+        }
+    }
+}
+
+static void compositeInterleavedDepthSpan(GLuint *destColor,
+                                          GLuint *destDepth,
+                                          const GLuint *src, GLuint count)
+{
+    GLuint i = 0;
+
+#ifdef ICET_USE_SSE2
+    for ( ; i + 4 <= count; i += 4) {
+      /* Each load gets the color and depth of two pixels. */
+        __m128i s0 = _mm_loadu_si128((const __m128i *)(src + 2*i));
+        __m128i s1 = _mm_loadu_si128((const __m128i *)(src + 2*i + 4));
+        __m128i sc, sd, dc, dd, closer;
+        s0 = _mm_shuffle_epi32(s0, _MM_SHUFFLE(3, 1, 2, 0));
+        s1 = _mm_shuffle_epi32(s1, _MM_SHUFFLE(3, 1, 2, 0));
+        sd = _mm_unpackhi_epi64(s0, s1);
+        dd = _mm_loadu_si128((const __m128i *)(destDepth + i));
+        closer = closerDepthSSE2(sd, dd);
+        if (_mm_movemask_epi8(closer) == 0) continue;
+        sc = _mm_unpacklo_epi64(s0, s1);
+        dc = _mm_loadu_si128((const __m128i *)(destColor + i));
+        _mm_storeu_si128((__m128i *)(destDepth + i),
+                         SELECT_SSE2(closer, sd, dd));
+        _mm_storeu_si128((__m128i *)(destColor + i),
+                         SELECT_SSE2(closer, sc, dc));
+    }
+#endif
+
+    for ( ; i < count; i++) {
+        if (src[2*i+1] < destDepth[i]) {
+            destColor[i] = src[2*i];
+            destDepth[i] = src[2*i+1];
+        }
+    }
+}
+
+static void blendSpan(GLuint *dest, const GLuint *src, GLuint count,
+                      int srcOnTop)
+{
+    GLuint i = 0;
+
+#ifdef ICET_USE_SSE2
+    for ( ; i + 4 <= count; i += 4) {
+        __m128i s = _mm_loadu_si128((const __m128i *)(src + i));
+        __m128i d = _mm_loadu_si128((const __m128i *)(dest + i));
+        _mm_storeu_si128((__m128i *)(dest + i),
+                         srcOnTop ? blendSSE2(s, d) : blendSSE2(d, s));
+    }
+#endif
+
+    if (srcOnTop) {
+        for ( ; i < count; i++) {
+          /* The blending should probably be more flexible. */
+            ICET_OVER((GLubyte *)(&src[i]), (GLubyte *)(&dest[i]));
+        }
+    } else {
+        for ( ; i < count; i++) {
+          /* The blending should probably be more flexible. */
+            ICET_UNDER((GLubyte *)(&src[i]), (GLubyte *)(&dest[i]));
+        }
+    }
+}
+
+static GLuint countFarDepth(const GLuint *depth, GLuint far_depth,
+                            GLuint max)
+{
+    GLuint i = 0;
+
+#ifdef ICET_USE_SSE2
+    const __m128i far4 = _mm_set1_epi32((int)far_depth);
+    for ( ; i + 4 <= max; i += 4) {
+        __m128i d = _mm_loadu_si128((const __m128i *)(depth + i));
+        if (_mm_movemask_epi8(_mm_cmpeq_epi32(d, far4)) != 0xFFFF) break;
+    }
+#else
+    for ( ; i + 4 <= max; i += 4) {
+        if (  (depth[i] ^ far_depth) | (depth[i+1] ^ far_depth)
+            | (depth[i+2] ^ far_depth) | (depth[i+3] ^ far_depth) ) break;
+    }
+#endif
+    while ((i < max) && (depth[i] == far_depth)) i++;
+
+    return i;
+}
+
+static GLuint countTransparent(const GLuint *color, GLuint max)
+{
+    const GLubyte *bytes = (const GLubyte *)color;
+    GLuint i = 0;
+
+#ifdef ICET_USE_SSE2
+  /* SSE2 machines are little endian, so alpha is the high byte. */
+    const __m128i alpha = _mm_set1_epi32((int)0xFF000000);
+    const __m128i zero = _mm_setzero_si128();
+    for ( ; i + 4 <= max; i += 4) {
+        __m128i c = _mm_loadu_si128((const __m128i *)(color + i));
+        c = _mm_cmpeq_epi32(_mm_and_si128(c, alpha), zero);
+        if (_mm_movemask_epi8(c) != 0xFFFF) break;
+    }
+#else
+    for ( ; i + 4 <= max; i += 4) {
+        if (  bytes[4*i+3] | bytes[4*i+7]
+            | bytes[4*i+11] | bytes[4*i+15] ) break;
+    }
+#endif
+    while ((i < max) && (bytes[4*i+3] == 0x00)) i++;
+
+    return i;
+}
+
+static void compositeFullJob(IceTCompositeJob *job)
+{
+    if (job->srcDepth) {
+        compositeDepthSpan(job->destColor, job->destDepth,
+                           job->srcColor, job->srcDepth, job->pixels);
+    } else {
+        blendSpan(job->destColor, job->srcColor, job->pixels, job->srcOnTop);
+    }
+}
+
+static void compositeSparseJob(IceTCompositeJob *job)
+{
+    const GLuint *src = job->runs;
+    GLuint p = 0;
+
+    while (p < job->pixels) {
+        const GLuint *runlengths = src++;
+        GLuint rl;
+
+      /* Skip background pixels. */
+        p += INACTIVE_RUN_LENGTH(*runlengths);
+        rl = ACTIVE_RUN_LENGTH(*runlengths);
+        if (p + rl > job->pixels) {
+            job->corrupt = 1;
+            return;
+        }
+
+      /* Composite active pixels. */
+        switch (job->type) {
+          case SPARSE_IMAGE_CD_MAGIC_NUM:
+              compositeInterleavedDepthSpan(job->destColor + p,
+                                            job->destDepth + p, src, rl);
+              src += 2*rl;
+              break;
+          case SPARSE_IMAGE_D_MAGIC_NUM:
+              compositeDepthSpan(NULL, job->destDepth + p, NULL, src, rl);
+              src += rl;
+              break;
+          case SPARSE_IMAGE_C_MAGIC_NUM:
+              blendSpan(job->destColor + p, src, rl, job->srcOnTop);
+              src += rl;
+              break;
+        }
+        p += rl;
+    }
+}
+
+static int getNumCompositeJobs(GLuint pixels)
+{
+#ifdef ICET_USE_THREADS
+    GLint num_threads;
+
+    icetGetIntegerv(ICET_COMPOSITE_THREADS, &num_threads);
+    num_threads = MIN(num_threads, (GLint)(pixels/MIN_PIXELS_PER_THREAD));
+    num_threads = MIN(num_threads, MAX_COMPOSITE_THREADS);
+    return MAX(num_threads, 1);
+#else
+    (void)pixels;
+    return 1;
+#endif
+}
+
+static int splitSparseImage(const IceTSparseImage srcBuffer, int num_jobs,
+                            IceTCompositeJob *jobs)
+{
+    GLuint pixels = GET_PIXEL_COUNT(srcBuffer);
+    GLuint pixel_size;
+    const GLuint *runs = GET_DATA_START(srcBuffer);
+    GLuint first = 0;
+    GLuint p = 0;
+    int job = 0;
+
+    pixel_size = (GET_MAGIC_NUM(srcBuffer) == SPARSE_IMAGE_CD_MAGIC_NUM) ? 2:1;
+
+  /* Only the run lengths are read, so this is cheap next to compositing.
+     Parts start on runs, which are at most 0xFFFF pixels long. */
+    while (p < pixels) {
+        if ((job < num_jobs-1) && (p >= (pixels/num_jobs)*(job+1))) {
+            jobs[job].pixels = p - first;
+            job++;
+            jobs[job].destColor = jobs[0].destColor ? jobs[0].destColor + p
+                                                    : NULL;
+            jobs[job].destDepth = jobs[0].destDepth ? jobs[0].destDepth + p
+                                                    : NULL;
+            jobs[job].runs = runs;
+            first = p;
+        }
+        p += INACTIVE_RUN_LENGTH(*runs) + ACTIVE_RUN_LENGTH(*runs);
+        if (p > pixels) return 0;
+        runs += 1 + pixel_size*ACTIVE_RUN_LENGTH(*runs);
+    }
+    jobs[job].pixels = p - first;
+
+    return job+1;
+}
+
+#ifdef ICET_USE_THREADS
+#ifdef WIN32
+static DWORD WINAPI compositeThread(LPVOID arg)
+#else
+static void *compositeThread(void *arg)
+#endif
+{
+    IceTCompositeJob *job = (IceTCompositeJob *)arg;
+    job->func(job);
+    return 0;
+}
+#endif /* ICET_USE_THREADS */
+
+static void runCompositeJobs(void (*func)(IceTCompositeJob *),
+                             IceTCompositeJob *jobs, int num_jobs)
+{
+#ifdef ICET_USE_THREADS
+#ifdef WIN32
+    HANDLE threads[MAX_COMPOSITE_THREADS];
+#else
+    pthread_t threads[MAX_COMPOSITE_THREADS];
+#endif
+    int started[MAX_COMPOSITE_THREADS];
+    int i;
+
+    for (i = 1; i < num_jobs; i++) {
+        jobs[i].func = func;
+#ifdef WIN32
+        threads[i] = CreateThread(NULL, 0, compositeThread, &jobs[i], 0, NULL);
+        started[i] = (threads[i] != NULL);
+#else
+        started[i] = (pthread_create(&threads[i], NULL, compositeThread,
+                                     &jobs[i]) == 0);
+#endif
+    }
+
+    func(&jobs[0]);
+
+    for (i = 1; i < num_jobs; i++) {
+        if (!started[i]) {
+          /* Could not start a thread, do the job here. */
+            func(&jobs[i]);
+            continue;
+        }
+#ifdef WIN32
+        WaitForSingleObject(threads[i], INFINITE);
+        CloseHandle(threads[i]);
+#else
+        pthread_join(threads[i], NULL);
+#endif
+    }
+#else /* ICET_USE_THREADS */
+    int i;
+    for (i = 0; i < num_jobs; i++) {
+        func(&jobs[i]);
+    }
+#endif /* ICET_USE_THREADS */
+}
+
 /* Currently not thread safe. */
 static void getBuffers(GLuint type, GLuint pixels, IceTImage *bufferp)
 {
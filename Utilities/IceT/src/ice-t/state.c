@@ -116,6 +116,8 @@ void icetStateSetDefaults(void)
 
     icetStateSetInteger(ICET_DATA_REPLICATION_GROUP, ICET_COMM_RANK());
     icetStateSetInteger(ICET_DATA_REPLICATION_GROUP_SIZE, 1);
+    icetStateSetInteger(ICET_MAGIC_K, 8);
+    icetStateSetInteger(ICET_COMPOSITE_THREADS, 1);
 
     icetStateSetPointer(ICET_DRAW_FUNCTION, NULL);
     icetStateSetInteger(ICET_READ_BUFFER, GL_BACK);
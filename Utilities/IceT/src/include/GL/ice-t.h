@@ -128,6 +128,7 @@ ICET_STRATEGY_EXPORT extern IceTStrategy ICET_STRATEGY_SERIAL;
 ICET_STRATEGY_EXPORT extern IceTStrategy ICET_STRATEGY_SPLIT;
 ICET_STRATEGY_EXPORT extern IceTStrategy ICET_STRATEGY_REDUCE;
 ICET_STRATEGY_EXPORT extern IceTStrategy ICET_STRATEGY_VTREE;
+ICET_STRATEGY_EXPORT extern IceTStrategy ICET_STRATEGY_RADIXK;
 
 ICET_EXPORT void icetStrategy(IceTStrategy strategy);
 
@@ -142,6 +143,10 @@ ICET_EXPORT void icetCompositeOrder(const GLint *process_ranks);
 ICET_EXPORT void icetDataReplicationGroup(GLint size, const GLint *processes);
 ICET_EXPORT void icetDataReplicationGroupColor(GLint color);
 
+ICET_EXPORT void icetMagicK(GLint magic_k);
+
+ICET_EXPORT void icetCompositeThreads(GLint num_threads);
+
 #define ICET_DIAG_OFF           (GLenum)0x0000
 #define ICET_DIAG_ERRORS        (GLenum)0x0001
 #define ICET_DIAG_WARNINGS      (GLenum)0x0003
@@ -182,6 +187,8 @@ ICET_EXPORT void icetDiagnostics(GLbitfield mask);
 #define ICET_STRATEGY_SUPPORTS_ORDERING (ICET_STATE_ENGINE_START | (GLenum)0x002A)
 #define ICET_DATA_REPLICATION_GROUP (ICET_STATE_ENGINE_START | (GLenum)0x002B)
 #define ICET_DATA_REPLICATION_GROUP_SIZE (ICET_STATE_ENGINE_START | (GLenum)0x002C)
+#define ICET_MAGIC_K            (ICET_STATE_ENGINE_START | (GLenum)0x002D)
+#define ICET_COMPOSITE_THREADS  (ICET_STATE_ENGINE_START | (GLenum)0x002E)
 
 #define ICET_DRAW_FUNCTION      (ICET_STATE_ENGINE_START | (GLenum)0x0060)
 #define ICET_READ_BUFFER        (ICET_STATE_ENGINE_START | (GLenum)0x0061)
@@ -23,6 +23,9 @@
 #define SWAP_IMAGE_DATA 21
 #define SWAP_DEPTH_DATA 22
 #define TREE_IMAGE_DATA 23
+#define RADIXK_IMAGE_DATA 24
+#define RADIXK_FINAL_IMAGE_DATA 25
+#define RADIXK_FINAL_DEPTH_DATA 26
 
 #define LARGE_MESSAGE 23
 
@@ -570,6 +573,303 @@ void icetBswapCompose(GLint *compose_group, GLint group_size, GLint image_dest,
     }
 }
 
+/* A radix-k composition has at most this many rounds because each round
+ * divides the group size by at least 2. */
+#define RADIXK_MAX_ROUNDS 32
+
+/* Factors group_size into the sizes of the rounds.  Each round takes the
+ * largest factor of what is left that is not bigger than magic_k or, if
+ * there is none, the smallest factor of what is left.  Returns the number
+ * of rounds. */
+static GLint RadixkFactor(GLint group_size, GLint magic_k, GLint *factors)
+{
+    GLint num_rounds = 0;
+    GLint remaining = group_size;
+
+    while (remaining > 1) {
+        GLint k;
+        for (k = (magic_k < remaining) ? magic_k : remaining; k > 1; k--) {
+            if (remaining%k == 0) break;
+        }
+        if (k == 1) {
+          /* All the factors left are bigger than magic_k. */
+            for (k = magic_k + 1; remaining%k != 0; k++);
+        }
+        factors[num_rounds++] = k;
+        remaining /= k;
+    }
+    return num_rounds;
+}
+
+/* Splits the pixels starting at offset in num_pieces pieces whose sizes
+ * differ by at most one pixel and returns the offset and size of the given
+ * piece. */
+static void RadixkPiece(GLint offset, GLint pixels,
+                        GLint num_pieces, GLint piece,
+                        GLint *piece_offset, GLint *piece_pixels)
+{
+    GLint base = pixels/num_pieces;
+    GLint remainder = pixels%num_pieces;
+
+    *piece_offset = offset + piece*base
+        + ((piece < remainder) ? piece : remainder);
+    *piece_pixels = base + ((piece < remainder) ? 1 : 0);
+}
+
+/* Returns the offset and size of the piece of the image that ends up in
+ * group_rank once all the rounds are done. */
+static void RadixkFinalPiece(const GLint *factors, GLint num_rounds,
+                             GLint pixels, GLint group_rank,
+                             GLint *offset, GLint *piece_pixels)
+{
+    GLint stride = 1;
+    GLint round;
+
+    *offset = 0;
+    *piece_pixels = pixels;
+    for (round = 0; round < num_rounds; round++) {
+        GLint k = factors[round];
+        RadixkPiece(*offset, *piece_pixels, k, (group_rank/stride)%k,
+                    offset, piece_pixels);
+        stride *= k;
+    }
+}
+
+/* Returns the size in bytes of the requests and buffers of a round of k
+ * processes sharing the given number of pixels.  Each piece gets a receive
+ * and a send buffer. */
+static GLint RadixkRoundBufferSize(GLint k, GLint pixels, GLint *buffer_size,
+                                   GLint *buffer_words)
+{
+    *buffer_size = icetSparseImageSize(pixels/k + 1);
+    *buffer_words = (*buffer_size + sizeof(GLuint) - 1)/sizeof(GLuint);
+    return 2*k*(sizeof(IceTCommRequest) + *buffer_words*sizeof(GLuint));
+}
+
+GLint icetRadixkBufferSize(GLint group_size, GLint magic_k, GLint pixels)
+{
+    GLint factors[RADIXK_MAX_ROUNDS];
+    GLint num_rounds;
+    GLint size = 0;
+    GLint round;
+
+    if (magic_k < 2) magic_k = 2;
+    num_rounds = RadixkFactor(group_size, magic_k, factors);
+    for (round = 0; round < num_rounds; round++) {
+        GLint k = factors[round];
+        GLint buffer_size, buffer_words;
+        GLint round_size = RadixkRoundBufferSize(k, pixels,
+                                                 &buffer_size, &buffer_words);
+        if (round_size > size) size = round_size;
+      /* The largest piece of the next round. */
+        pixels = (pixels + k - 1)/k;
+    }
+  /* The requests of the final collection reuse the buffer. */
+    if (2*group_size*(GLint)sizeof(IceTCommRequest) > size) {
+        size = 2*group_size*sizeof(IceTCommRequest);
+    }
+    return size;
+}
+
+/* Does one round of radix-k.  The k processes of the round group are
+ * stride apart in the group and share the pixels starting at *offsetp.
+ * Each one sends the pieces it does not keep to the other ones and
+ * composites the pieces it receives, in visibility order, with the one it
+ * keeps.  On return, *offsetp and *pixelsp are those of that piece. */
+static void RadixkRound(GLint *compose_group, GLint group_rank,
+                        GLint k, GLint stride, IceTImage imageBuffer,
+                        void *commBuffer, GLint *offsetp, GLint *pixelsp)
+{
+    GLint piece_num;
+    GLint first;
+    GLint buffer_size;
+    GLint buffer_words;
+    IceTCommRequest *radixkRequests;
+    GLuint *radixkBuffers;
+    GLint offset, pixels;
+    GLint i;
+
+    piece_num = (group_rank/stride)%k;
+    first = group_rank - piece_num*stride;
+
+    RadixkRoundBufferSize(k, *pixelsp, &buffer_size, &buffer_words);
+    radixkRequests = commBuffer;
+    radixkBuffers = (GLuint *)(radixkRequests + 2*k);
+
+    for (i = 0; i < k; i++) {
+        if (i == piece_num) {
+            radixkRequests[i] = ICET_COMM_REQUEST_NULL;
+            continue;
+        }
+        radixkRequests[i] =
+            ICET_COMM_IRECV(radixkBuffers + i*buffer_words, buffer_size,
+                            ICET_BYTE, compose_group[first + i*stride],
+                            RADIXK_IMAGE_DATA);
+    }
+    for (i = 0; i < k; i++) {
+        IceTSparseImage outImage = radixkBuffers + (k + i)*buffer_words;
+        GLint compressedSize;
+
+        if (i == piece_num) {
+            radixkRequests[k + i] = ICET_COMM_REQUEST_NULL;
+            continue;
+        }
+        RadixkPiece(*offsetp, *pixelsp, k, i, &offset, &pixels);
+        icetRaiseDebug2("Sending piece %d to %d", (int)i,
+                        (int)compose_group[first + i*stride]);
+        compressedSize = icetCompressSubImage(imageBuffer, offset, pixels,
+                                              outImage);
+        icetAddSentBytes(compressedSize);
+        radixkRequests[k + i] =
+            ICET_COMM_ISEND(outImage, compressedSize, ICET_BYTE,
+                            compose_group[first + i*stride],
+                            RADIXK_IMAGE_DATA);
+    }
+
+  /* The processes before this one in the round group are in front of it,
+   * the ones after behind it.  Blend from this image outward so that the
+   * order is respected even when the operation is not commutative. */
+    RadixkPiece(*offsetp, *pixelsp, k, piece_num, &offset, &pixels);
+    for (i = piece_num - 1; i >= 0; i--) {
+        ICET_COMM_WAIT(radixkRequests + i);
+        icetCompressedSubComposite(imageBuffer, offset, pixels,
+                                   radixkBuffers + i*buffer_words, 1);
+    }
+    for (i = piece_num + 1; i < k; i++) {
+        ICET_COMM_WAIT(radixkRequests + i);
+        icetCompressedSubComposite(imageBuffer, offset, pixels,
+                                   radixkBuffers + i*buffer_words, 0);
+    }
+    for (i = 0; i < k; i++) {
+        ICET_COMM_WAIT(radixkRequests + k + i);
+    }
+
+    *offsetp = offset;
+    *pixelsp = pixels;
+}
+
+static void RadixkCollectFinalImages(GLint *compose_group, GLint group_size,
+                                     GLint group_rank, const GLint *factors,
+                                     GLint num_rounds, IceTImage imageBuffer,
+                                     void *commBuffer)
+{
+    GLenum output_buffers;
+    GLubyte *colorBuffer = NULL;
+    GLuint *depthBuffer = NULL;
+    IceTCommRequest *requests;
+    GLint pixels;
+    GLint i;
+
+    icetGetIntegerv(ICET_OUTPUT_BUFFERS, (GLint *)&output_buffers);
+    if ((output_buffers & ICET_COLOR_BUFFER_BIT) != 0) {
+        colorBuffer = icetGetImageColorBuffer(imageBuffer);
+    }
+    if ((output_buffers & ICET_DEPTH_BUFFER_BIT) != 0) {
+        depthBuffer = icetGetImageDepthBuffer(imageBuffer);
+    }
+    pixels = icetGetImagePixelCount(imageBuffer);
+    requests = commBuffer;
+
+    icetRaiseDebug("Collecting image data.");
+    for (i = 0; i < group_size; i++) {
+        GLint offset, piece_pixels;
+
+        requests[2*i] = ICET_COMM_REQUEST_NULL;
+        requests[2*i + 1] = ICET_COMM_REQUEST_NULL;
+        RadixkFinalPiece(factors, num_rounds, pixels, i,
+                         &offset, &piece_pixels);
+        if ((i == group_rank) || (piece_pixels == 0)) continue;
+        if (colorBuffer) {
+            requests[2*i] =
+                ICET_COMM_IRECV(colorBuffer + 4*offset, 4*piece_pixels,
+                                ICET_BYTE, compose_group[i],
+                                RADIXK_FINAL_IMAGE_DATA);
+        }
+        if (depthBuffer) {
+            requests[2*i + 1] =
+                ICET_COMM_IRECV(depthBuffer + offset, piece_pixels,
+                                ICET_INT, compose_group[i],
+                                RADIXK_FINAL_DEPTH_DATA);
+        }
+    }
+    for (i = 0; i < 2*group_size; i++) {
+        ICET_COMM_WAIT(requests + i);
+    }
+}
+
+static void RadixkSendFinalImage(GLint *compose_group, GLint image_dest,
+                                 IceTImage imageBuffer,
+                                 GLint offset, GLint pixels)
+{
+    GLenum output_buffers;
+
+    if (pixels == 0) return;
+
+    icetGetIntegerv(ICET_OUTPUT_BUFFERS, (GLint *)&output_buffers);
+    if ((output_buffers & ICET_COLOR_BUFFER_BIT) != 0) {
+        GLubyte *colorBuffer = icetGetImageColorBuffer(imageBuffer);
+        icetRaiseDebug("Sending image data.");
+        icetAddSentBytes(4*pixels);
+        ICET_COMM_SEND(colorBuffer + 4*offset, 4*pixels, ICET_BYTE,
+                       compose_group[image_dest], RADIXK_FINAL_IMAGE_DATA);
+    }
+    if ((output_buffers & ICET_DEPTH_BUFFER_BIT) != 0) {
+        GLuint *depthBuffer = icetGetImageDepthBuffer(imageBuffer);
+        icetRaiseDebug("Sending depth data.");
+        icetAddSentBytes(4*pixels);
+        ICET_COMM_SEND(depthBuffer + offset, pixels, ICET_INT,
+                       compose_group[image_dest], RADIXK_FINAL_DEPTH_DATA);
+    }
+}
+
+void icetRadixkCompose(GLint *compose_group, GLint group_size,
+                       GLint image_dest, GLint magic_k,
+                       IceTImage imageBuffer, void *commBuffer)
+{
+    GLint factors[RADIXK_MAX_ROUNDS];
+    GLint num_rounds;
+    GLint group_rank;
+    GLint rank;
+    GLint stride;
+    GLint offset, pixels;
+    GLint round;
+
+    icetRaiseDebug("In icetRadixkCompose");
+
+    if (magic_k < 2) {
+        icetRaiseError("Radix-k needs a magic k of at least 2.",
+                       ICET_INVALID_VALUE);
+        magic_k = 2;
+    }
+
+    icetGetIntegerv(ICET_RANK, &rank);
+    for (group_rank = 0; compose_group[group_rank] != rank; group_rank++);
+
+    num_rounds = RadixkFactor(group_size, magic_k, factors);
+
+    offset = 0;
+    pixels = icetGetImagePixelCount(imageBuffer);
+    stride = 1;
+    for (round = 0; round < num_rounds; round++) {
+        icetRaiseDebug2("Round %d with %d processes",
+                        (int)round, (int)factors[round]);
+        RadixkRound(compose_group, group_rank, factors[round], stride,
+                    imageBuffer, commBuffer, &offset, &pixels);
+        stride *= factors[round];
+    }
+
+    if (group_rank == image_dest) {
+      /* Collect image if I'm the destination. */
+        RadixkCollectFinalImages(compose_group, group_size, group_rank,
+                                 factors, num_rounds, imageBuffer,
+                                 commBuffer);
+    } else {
+      /* Send image to destination. */
+        RadixkSendFinalImage(compose_group, image_dest, imageBuffer,
+                             offset, pixels);
+    }
+}
+
 static void RecursiveTreeCompose(GLint *compose_group, GLint group_size,
                                  GLint group_rank, GLint image_dest,
                                  IceTImage imageBuffer,
@@ -114,6 +114,49 @@ void icetBswapCompose(GLint *compose_group, GLint group_size, GLint image_dest,
                       IceTImage imageBuffer,
                       IceTSparseImage inImage, IceTSparseImage outImage);
 
+/* icetRadixkCompose
+
+   Performs a radix-k composition amongst a subset of processors in the
+   current communicator (see context.h).  The group size is factored into
+   rounds of about magic_k processes.  In each round, the processes of a
+   round group split the part of the image they share in as many pieces as
+   there are processes in the round group, exchange the pieces all to all
+   and composite the piece they keep.  Unlike icetBswapCompose, any group
+   size is handled without idling processes or leaving pixels out.  With a
+   magic_k of 2 and a power of 2 group size, this is binary swap.
+
+   compose_group - A mapping of processors from the MPI ranks to the "group"
+        ranks.  The composed image ends up in the processor with rank
+        compose_group[image_dest].
+   group_size - The number of processors in the group.  The compose_group
+        array should have group_size entries.
+   image_dest - The location of where the final composed image should be
+        placed.  It is an index into compose_group, not the actual rank
+        of the process.
+   magic_k - The number of processes exchanging image pieces in each round
+        (when the group size can be factored that way).  Must be at
+        least 2.
+   imageBuffer - The input image colors and/or depth to be used.  If this
+        processor has rank compose_group[image_dest], any output data will
+        be put in this buffer.  If the color or depth value is not to be
+        computed or this processor is not rank compose_group[image_dest],
+        the buffer has undefined partial results when the function returns.
+   commBuffer - A buffer for the requests and the sparse image pieces
+        exchanged in the rounds, and for the requests collecting the final
+        image.  It must have at least the size returned by
+        icetRadixkBufferSize.
+*/
+void icetRadixkCompose(GLint *compose_group, GLint group_size,
+                       GLint image_dest, GLint magic_k,
+                       IceTImage imageBuffer, void *commBuffer);
+
+/* icetRadixkBufferSize
+
+   Returns the size in bytes of the commBuffer given to icetRadixkCompose
+   for the given group size, magic_k and number of pixels of the images.
+*/
+GLint icetRadixkBufferSize(GLint group_size, GLint magic_k, GLint pixels);
+
 /* icetTreeCompose
 
    Performs a binary tree composition amongst a subset of processors in the
@@ -0,0 +1,176 @@
+/* -*- c -*- *****************************************************************
+** $Id$
+**
+** Copyright (C) 2003 Sandia Corporation
+** Under the terms of Contract DE-AC04-94AL85000, there is a non-exclusive
+** license for use of this work by or on behalf of the U.S. Government.
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that this Notice and any statement
+** of authorship are reproduced on all copies.
+**
+** Measures the time to draw and composite a single tile with the strategies
+** suited to sort-last rendering on 1, 2, 4, ... and all the processes.
+** Each group of processes gets its own MPI communicator and ICE-T context.
+** Process 0 prints a table of the average frame and composite times, which
+** is the slowest process of each frame.  Give -frames <n> to change the
+** number of frames drawn for each measure.
+*****************************************************************************/
+
+#include <GL/ice-t.h>
+#include <GL/ice-t_mpi.h>
+#include "test_codes.h"
+#include "test-util.h"
+#include "glwin.h"
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+static GLint group_rank;
+static GLint group_size;
+
+static void draw(void)
+{
+  /* Each process draws a quad covering the whole tile, tilted so that the
+   * depths of the processes cross each other. */
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    glColor3f((float)(group_rank%2), (float)((group_rank/2)%2),
+              (float)((group_rank/4)%2));
+    glBegin(GL_QUADS);
+      glVertex3f(-1.0, -1.0, -0.5f + (float)group_rank/group_size);
+      glVertex3f(1.0, -1.0, 0.5f - (float)group_rank/group_size);
+      glVertex3f(1.0, 1.0, 0.5f - (float)group_rank/group_size);
+      glVertex3f(-1.0, 1.0, -0.5f + (float)group_rank/group_size);
+    glEnd();
+}
+
+#define NUM_MEASURES 5
+
+static void RunMeasures(MPI_Comm group_comm, int num_frames)
+{
+    const char *names[NUM_MEASURES] = {
+        "reduce", "serial", "radix-k 2", "radix-k 4", "radix-k 8"
+    };
+    IceTStrategy strategies[NUM_MEASURES];
+    GLint magic_k[NUM_MEASURES] = { 0, 0, 2, 4, 8 };
+    int m;
+
+    strategies[0] = ICET_STRATEGY_REDUCE;
+    strategies[1] = ICET_STRATEGY_SERIAL;
+    strategies[2] = ICET_STRATEGY_RADIXK;
+    strategies[3] = ICET_STRATEGY_RADIXK;
+    strategies[4] = ICET_STRATEGY_RADIXK;
+
+    icetGetIntegerv(ICET_RANK, &group_rank);
+    icetGetIntegerv(ICET_NUM_PROCESSES, &group_size);
+
+    icetResetTiles();
+    icetAddTile(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT, 0);
+    icetDrawFunc(draw);
+    icetBoundingBoxf(-1.0, 1.0, -1.0, 1.0, -1.0, 1.0);
+    icetInputOutputBuffers(ICET_COLOR_BUFFER_BIT | ICET_DEPTH_BUFFER_BIT,
+                           ICET_COLOR_BUFFER_BIT);
+
+    glMatrixMode(GL_PROJECTION);
+    glLoadIdentity();
+    glOrtho(-1.0, 1.0, -1.0, 1.0, -1.0, 1.0);
+    glMatrixMode(GL_MODELVIEW);
+    glLoadIdentity();
+    glDisable(GL_LIGHTING);
+    glEnable(GL_DEPTH_TEST);
+
+    for (m = 0; m < NUM_MEASURES; m++) {
+        GLdouble times[2], max_times[2];
+        int frame;
+
+        icetStrategy(strategies[m]);
+        if (magic_k[m] > 0) {
+            icetMagicK(magic_k[m]);
+        }
+
+      /* Draw a frame first so that the buffers are allocated. */
+        icetDrawFrame();
+
+        times[0] = times[1] = 0.0;
+        for (frame = 0; frame < num_frames; frame++) {
+            GLdouble draw_time, composite_time;
+            icetDrawFrame();
+            icetGetDoublev(ICET_TOTAL_DRAW_TIME, &draw_time);
+            icetGetDoublev(ICET_COMPOSITE_TIME, &composite_time);
+            times[0] += draw_time;
+            times[1] += composite_time;
+        }
+
+      /* The frame is as slow as the slowest process. */
+        MPI_Reduce(times, max_times, 2, MPI_DOUBLE, MPI_MAX, 0, group_comm);
+        if (group_rank == 0) {
+            printf("BENCHMARK %5d %-10s %12.6f %12.6f\n", (int)group_size,
+                   names[m], max_times[0]/num_frames,
+                   max_times[1]/num_frames);
+        }
+    }
+}
+
+int CompositeBenchmark(int argc, char *argv[])
+{
+    IceTContext original_context;
+    int num_frames = 10;
+    int world_rank, world_size;
+    int num_proc;
+    int done;
+    int i;
+
+    for (i = 1; i < argc; i++) {
+        if ((strcmp(argv[i], "-frames") == 0) && (i+1 < argc)) {
+            num_frames = atoi(argv[++i]);
+        }
+    }
+    if (num_frames < 1) num_frames = 1;
+
+    MPI_Comm_rank(MPI_COMM_WORLD, &world_rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &world_size);
+
+    original_context = icetGetContext();
+
+    if (world_rank == 0) {
+        printf("BENCHMARK %5s %-10s %12s %12s\n",
+               "procs", "strategy", "frame (s)", "composite (s)");
+    }
+
+    num_proc = 1;
+    done = 0;
+    while (!done) {
+        MPI_Comm group_comm;
+
+        MPI_Comm_split(MPI_COMM_WORLD,
+                       (world_rank < num_proc) ? 0 : MPI_UNDEFINED,
+                       world_rank, &group_comm);
+        if (group_comm != MPI_COMM_NULL) {
+            IceTCommunicator icet_comm;
+            IceTContext context;
+
+            icet_comm = icetCreateMPICommunicator(group_comm);
+            context = icetCreateContext(icet_comm);
+            icetDiagnostics(ICET_DIAG_ERRORS | ICET_DIAG_ALL_NODES);
+
+            RunMeasures(group_comm, num_frames);
+
+            icetDestroyContext(context);
+            icetDestroyMPICommunicator(icet_comm);
+            MPI_Comm_free(&group_comm);
+        }
+        MPI_Barrier(MPI_COMM_WORLD);
+
+        if (num_proc == world_size) {
+            done = 1;
+        } else {
+            num_proc *= 2;
+            if (num_proc > world_size) num_proc = world_size;
+        }
+    }
+
+    icetSetContext(original_context);
+
+    finalize_test(TEST_PASSED);
+    return TEST_PASSED;
+}
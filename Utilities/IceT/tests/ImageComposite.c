@@ -0,0 +1,188 @@
+/* -*- c -*- *****************************************************************
+** $Id$
+**
+** Copyright (C) 2003 Sandia Corporation
+** Under the terms of Contract DE-AC04-94AL85000, there is a non-exclusive
+** license for use of this work by or on behalf of the U.S. Government.
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that this Notice and any statement
+** of authorship are reproduced on all copies.
+**
+** This test checks that compositing full and compressed images gives
+** exactly the same pixels as a plain pixel by pixel depth test or blend,
+** with one thread and with the images split over several threads.
+*****************************************************************************/
+
+#include <GL/ice-t.h>
+#include "test_codes.h"
+#include "test-util.h"
+
+#include <image.h>
+#include <state.h>
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+/* Big enough to be split over 4 threads, and not a multiple of 4. */
+#define PIXELS 300007
+
+static unsigned long random_state = 1;
+static GLuint RandomWord(void)
+{
+    random_state = (random_state*1103515245 + 12345) & 0xFFFFFFFF;
+    return (GLuint)(random_state >> 8) ^ (GLuint)(random_state << 20);
+}
+
+/* Fills an image with runs of active and inactive pixels.  Inactive pixels
+ * are at the far depth or have colors of 0, so that skipping them when
+ * compositing a compressed image is the same as compositing them. */
+static void FillImage(IceTImage image, GLuint far_depth)
+{
+    GLuint *color = (GLuint *)icetGetImageColorBuffer(image);
+    GLuint *depth = icetGetImageDepthBuffer(image);
+    GLuint i = 0;
+
+    while (i < PIXELS) {
+        GLuint run = RandomWord()%((RandomWord()%4 == 0) ? 70000 : 40);
+        int active = RandomWord()%2;
+        for ( ; (run > 0) && (i < PIXELS); run--, i++) {
+            if (color) {
+                color[i] = active ? RandomWord() : 0;
+              /* Active pixels are not transparent. */
+                if (active) ((GLubyte *)(&color[i]))[3] |= 0x01;
+            }
+            if (depth) {
+              /* Use few depths at times to get ties. */
+                if (!active) {
+                    depth[i] = far_depth;
+                } else if (RandomWord()%3 == 0) {
+                    depth[i] = 0x7FFFFFF0 + RandomWord()%32;
+                } else {
+                    depth[i] = RandomWord()%far_depth;
+                }
+            }
+        }
+    }
+}
+
+/* Composites src into dest one pixel at a time. */
+static void ReferenceComposite(IceTImage dest, const IceTImage src,
+                               int srcOnTop)
+{
+    GLuint *destColor = (GLuint *)icetGetImageColorBuffer(dest);
+    GLuint *destDepth = icetGetImageDepthBuffer(dest);
+    GLuint *srcColor = (GLuint *)icetGetImageColorBuffer((IceTImage)src);
+    GLuint *srcDepth = icetGetImageDepthBuffer((IceTImage)src);
+    GLuint i;
+
+    for (i = 0; i < PIXELS; i++) {
+        if (srcDepth) {
+            if (srcDepth[i] < destDepth[i]) {
+                destDepth[i] = srcDepth[i];
+                if (srcColor) destColor[i] = srcColor[i];
+            }
+        } else if (srcOnTop) {
+            ICET_OVER((GLubyte *)(&srcColor[i]), (GLubyte *)(&destColor[i]));
+        } else {
+            ICET_UNDER((GLubyte *)(&srcColor[i]), (GLubyte *)(&destColor[i]));
+        }
+    }
+}
+
+static int DoCompositeTest(int num_threads)
+{
+    IceTImage imageA, imageB, expected, result;
+    IceTSparseImage compressed;
+    GLuint size;
+    GLuint far_depth = 0xFFFFFFFF;
+    int srcOnTop;
+    int passed = TEST_PASSED;
+
+  /* No frame is drawn, so set the far depth by hand. */
+    icetStateSetInteger(ICET_ABSOLUTE_FAR_DEPTH, far_depth);
+    icetCompositeThreads(num_threads);
+
+    size = icetFullImageSize(PIXELS);
+    imageA = malloc(size);
+    imageB = malloc(size);
+    expected = malloc(size);
+    result = malloc(size);
+    compressed = malloc(icetSparseImageSize(PIXELS));
+    icetInitializeImage(imageA, PIXELS);
+    icetInitializeImage(imageB, PIXELS);
+    FillImage(imageA, far_depth);
+    FillImage(imageB, far_depth);
+
+    for (srcOnTop = 0; srcOnTop < 2; srcOnTop++) {
+        memcpy(expected, imageA, size);
+        ReferenceComposite(expected, imageB, srcOnTop);
+
+        printf("Composite full images, srcOnTop = %d.\n", srcOnTop);
+        memcpy(result, imageA, size);
+        icetComposite(result, imageB, srcOnTop);
+        if (memcmp(result, expected, size) != 0) {
+            printf("Full composite differs from expected image!\n");
+            passed = TEST_FAILED;
+        }
+
+        printf("Composite compressed image, srcOnTop = %d.\n", srcOnTop);
+        icetCompressImage(imageB, compressed);
+        memcpy(result, imageA, size);
+        icetCompressedComposite(result, compressed, srcOnTop);
+        if (memcmp(result, expected, size) != 0) {
+            printf("Compressed composite differs from expected image!\n");
+            passed = TEST_FAILED;
+        }
+    }
+
+    if (icetGetError() != ICET_NO_ERROR) {
+        printf("Got an IceT error!\n");
+        passed = TEST_FAILED;
+    }
+
+    free(imageA);
+    free(imageB);
+    free(expected);
+    free(result);
+    free(compressed);
+    icetCompositeThreads(1);
+    return passed;
+}
+
+static int DoCompositeTests(void)
+{
+    int result = DoCompositeTest(1);
+    printf("\nSplit images over 4 threads.\n");
+    if (DoCompositeTest(4) != TEST_PASSED) {
+        result = TEST_FAILED;
+    }
+    return result;
+}
+
+int ImageComposite(int argc, char *argv[])
+{
+    int result;
+
+    /* To remove warning */
+    (void)argc;
+    (void)argv;
+
+    printf("Composite depth only.\n");
+    icetInputOutputBuffers(ICET_DEPTH_BUFFER_BIT, ICET_DEPTH_BUFFER_BIT);
+    result = DoCompositeTests();
+    printf("\n\nComposite color only.\n");
+    icetInputOutputBuffers(ICET_COLOR_BUFFER_BIT, ICET_COLOR_BUFFER_BIT);
+    if (DoCompositeTests() != TEST_PASSED) {
+        result = TEST_FAILED;
+    }
+    printf("\n\nComposite color and depth.\n");
+    icetInputOutputBuffers(ICET_COLOR_BUFFER_BIT | ICET_DEPTH_BUFFER_BIT,
+                           ICET_COLOR_BUFFER_BIT);
+    if (DoCompositeTests() != TEST_PASSED) {
+        result = TEST_FAILED;
+    }
+
+    finalize_test(result);
+    return result;
+}
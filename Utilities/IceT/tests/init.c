@@ -32,8 +32,8 @@
 #define dup2(fildes, fildes2)   _dup2(fildes, fildes2)
 #endif
 
-IceTStrategy strategy_list[5];
-int STRATEGY_LIST_SIZE = 5;
+IceTStrategy strategy_list[6];
+int STRATEGY_LIST_SIZE = 6;
 /* int STRATEGY_LIST_SIZE = 1; */
 
 int SCREEN_WIDTH;
@@ -220,6 +220,7 @@ void initialize_test(int *argcp, char ***argvp, IceTCommunicator comm)
     strategy_list[2] = ICET_STRATEGY_SPLIT;
     strategy_list[3] = ICET_STRATEGY_REDUCE;
     strategy_list[4] = ICET_STRATEGY_VTREE;
+    strategy_list[5] = ICET_STRATEGY_RADIXK;
 }
 
 extern void finalize_communication(void);
@@ -0,0 +1,170 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    $RCSfile$
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Replays a stream through vtkClientServerInterpreter and reports the
+// number of invokes processed per second.
+//
+// Usage: vtkClientServerInvokeBenchmark [iterations] [stream file]
+//
+// The stream file holds the binary form of a vtkClientServerStream as
+// returned by vtkClientServerStream::GetData, e.g. recorded while loading a
+// state. Without a file a synthetic state load is replayed: a set of
+// sources and filters is created and their properties are pushed, most of
+// them through methods wrapped by a superclass several levels up.
+
+#include "vtkClientServerInterpreter.h"
+#include "vtkClientServerStream.h"
+#include "vtkTimerLog.h"
+
+#include <vtkstd/vector>
+#include <stdlib.h>
+
+// ClientServer wrapper initialization functions.
+extern "C" void vtkCommonCS_Initialize(vtkClientServerInterpreter*);
+extern "C" void vtkFilteringCS_Initialize(vtkClientServerInterpreter*);
+extern "C" void vtkImagingCS_Initialize(vtkClientServerInterpreter*);
+extern "C" void vtkGraphicsCS_Initialize(vtkClientServerInterpreter*);
+
+static void BuildStateLoadStream(vtkClientServerStream& css, int numObjects)
+{
+  vtkClientServerStream::Commands cnew = vtkClientServerStream::New;
+  vtkClientServerStream::Commands invoke = vtkClientServerStream::Invoke;
+  vtkClientServerStream::Commands cdelete = vtkClientServerStream::Delete;
+  vtkClientServerStream::Types end = vtkClientServerStream::End;
+
+  vtkClientServerID id(100);
+  for (int i = 0; i < numObjects; i++)
+    {
+    vtkClientServerID sphere = id; ++id.ID;
+    vtkClientServerID elevation = id; ++id.ID;
+    vtkClientServerID shrink = id; ++id.ID;
+    css << cnew << "vtkSphereSource" << sphere << end;
+    css << cnew << "vtkElevationFilter" << elevation << end;
+    css << cnew << "vtkShrinkPolyData" << shrink << end;
+
+    // Properties of the most derived classes.
+    css << invoke << sphere << "SetThetaResolution" << 8 + i % 8 << end;
+    css << invoke << sphere << "SetPhiResolution" << 8 + i % 8 << end;
+    css << invoke << sphere << "SetCenter" << 0.0 << 1.0 << 2.0 << end;
+    css << invoke << sphere << "SetRadius" << 0.5 << end;
+    css << invoke << elevation << "SetLowPoint" << 0.0 << 0.0 << 0.0 << end;
+    css << invoke << elevation << "SetHighPoint" << 0.0 << 0.0 << 1.0 << end;
+    css << invoke << elevation << "SetScalarRange" << 0.0 << 1.0 << end;
+    css << invoke << shrink << "SetShrinkFactor" << 0.75 << end;
+
+    // Methods wrapped by the superclasses.
+    css << invoke << sphere << "GetOutputPort" << 0 << end;
+    css << invoke << elevation << "SetInputConnection"
+        << 0 << vtkClientServerStream::LastResult << end;
+    css << invoke << elevation << "GetOutputPort" << 0 << end;
+    css << invoke << shrink << "SetInputConnection"
+        << 0 << vtkClientServerStream::LastResult << end;
+    css << invoke << sphere << "SetDebug" << 0 << end;
+    css << invoke << elevation << "SetDebug" << 0 << end;
+    css << invoke << shrink << "SetDebug" << 0 << end;
+    css << invoke << sphere << "GetMTime" << end;
+    css << invoke << elevation << "GetMTime" << end;
+    css << invoke << shrink << "GetClassName" << end;
+    css << invoke << shrink << "GetReferenceCount" << end;
+
+    css << cdelete << shrink << end;
+    css << cdelete << elevation << end;
+    css << cdelete << sphere << end;
+    }
+}
+
+static int ReadStreamFile(const char* fname, vtkClientServerStream& css)
+{
+  ifstream fin(fname, ios::in | ios::binary);
+  if (!fin)
+    {
+    cerr << "Cannot open " << fname << endl;
+    return 0;
+    }
+  vtkstd::vector<unsigned char> data;
+  char buffer[4096];
+  while (fin.read(buffer, sizeof(buffer)) || fin.gcount() > 0)
+    {
+    data.insert(data.end(), buffer, buffer + fin.gcount());
+    }
+  if (data.empty() || !css.SetData(&data[0], data.size()))
+    {
+    cerr << fname << " does not hold a valid stream." << endl;
+    return 0;
+    }
+  return 1;
+}
+
+int main(int argc, char* argv[])
+{
+  int iterations = argc > 1 ? atoi(argv[1]) : 20;
+  if (iterations < 1)
+    {
+    iterations = 1;
+    }
+
+  vtkClientServerStream css;
+  if (argc > 2)
+    {
+    if (!ReadStreamFile(argv[2], css))
+      {
+      return 1;
+      }
+    }
+  else
+    {
+    BuildStateLoadStream(css, 100);
+    }
+
+  int numInvokes = 0;
+  for (int i = 0; i < css.GetNumberOfMessages(); i++)
+    {
+    if (css.GetCommand(i) == vtkClientServerStream::Invoke)
+      {
+      ++numInvokes;
+      }
+    }
+
+  vtkClientServerInterpreter* interp = vtkClientServerInterpreter::New();
+  vtkCommonCS_Initialize(interp);
+  vtkFilteringCS_Initialize(interp);
+  vtkImagingCS_Initialize(interp);
+  vtkGraphicsCS_Initialize(interp);
+
+  int retVal = 0;
+  vtkTimerLog* timer = vtkTimerLog::New();
+  timer->StartTimer();
+  for (int i = 0; i < iterations; i++)
+    {
+    if (!interp->ProcessStream(css))
+      {
+      cerr << "Failed to process the stream:" << endl;
+      interp->GetLastResult().Print(cerr);
+      retVal = 1;
+      break;
+      }
+    }
+  timer->StopTimer();
+
+  double elapsed = timer->GetElapsedTime();
+  double total = static_cast<double>(numInvokes) * iterations;
+  cout << "Invokes per iteration: " << numInvokes << endl;
+  cout << "Iterations: " << iterations << endl;
+  cout << "Elapsed time: " << elapsed << " s" << endl;
+  cout << "Invokes/second: " << (elapsed > 0 ? total / elapsed : 0.0) << endl;
+
+  timer->Delete();
+  interp->Delete();
+  return retVal;
+}
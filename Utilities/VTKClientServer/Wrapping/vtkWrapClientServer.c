@@ -1284,54 +1284,116 @@ void getClassInfo(FileInfo *data, ClassInfo* classData)
 
 //--------------------------------------------------------------------------nix
 /*
- * This function outputs the *MethodMap function.
- * 
+ * methodNameCmp is used to sort the function names of the method table.
+ *
+ * @param name1 pointer to the first function name
+ * @param name2 pointer to the second function name
+ *
+ * @return values returned by strcmp
+ */
+static int methodNameCmp(const void *name1, const void *name2)
+{
+  return strcmp(*(char* const*)name1, *(char* const*)name2);
+}
+
+//--------------------------------------------------------------------------nix
+/*
+ * This function outputs the *MethodTable array and the *MethodLookup
+ * function. The table is sorted by name at wrapping time so that the
+ * lookup is a binary search over static data: it allocates nothing and
+ * does not grow when asked for a method the class does not have.
+ *
  * @param fp file to write into
  * @param data data which will be used to write into file
  */
-void outputMethodMapFunction(FILE *fp, ClassInfo *data)
+void outputMethodTableFunction(FILE *fp, ClassInfo *data)
 {
   int i;
+  char **names = 0;
+  if(data->NumberOfFunctions > 0)
+    {
+    names = (char**)malloc(sizeof(char*)*data->NumberOfFunctions);
+    for(i=0; i < data->NumberOfFunctions; i++)
+      {
+      names[i] = data->Functions[i].Name;
+      }
+    qsort(names, data->NumberOfFunctions, sizeof(char*), methodNameCmp);
+    }
+
   fprintf(fp,
           "\n"
           "#ifndef VTK_METHOD_MAP\n"
-          "#include <vtkstd/map>\n"
           "typedef int (*funPtr)(const vtkClientServerStream& msg, %s *op, vtkClientServerStream& resultStream);\n"
-          "typedef vtkstd::map <vtkstd::string , funPtr> vtkMethodMap;\n"
           "#endif\n"
           "\n"
+          "struct %sMethodTableEntry\n"
+          "{\n"
+          "  const char* Name;\n"
+          "  funPtr Function;\n"
+          "};\n"
+          "\n"
           "//-------------------------------------------------------------------------auto\n"
           "/*\n"
-          " * %sMethodMap function creates a map with key as the name of the function\n"
-          " * and value as the funptr which can be directly called.\n"
-          " *\n"
-          " * @return the map which returns the funptr given the name\n"
+          " * %sMethodTable lists the wrapped methods sorted by name.\n"
           " */\n"
-          "vtkMethodMap& %sMethodMap()\n"
-          "{\n"
-          "  static bool once = 1;\n"
-          "  static vtkMethodMap map;\n"
-          "  if(once)\n"
-          "    {\n"
-          "    once = 0;\n",
+          "static const %sMethodTableEntry %sMethodTable[] =\n"
+          "{\n",
+          data->ClassName,
+          data->ClassName,
           data->ClassName,
           data->ClassName,
           data->ClassName
           );
-  for(i=0; i < data->NumberOfFunctions;i++)
+  for(i=0; i < data->NumberOfFunctions; i++)
     {
     fprintf(fp,
-            "    map[\"%s\"]=%s_%s;\n",
-            data->Functions[i].Name,
+            "  {\"%s\", %s_%s},\n",
+            names[i],
             data->ClassName,
-            data->Functions[i].Name
+            names[i]
             );
     }
   fprintf(fp,
+          "  {0, 0}\n"
+          "};\n"
+          "\n"
+          "//-------------------------------------------------------------------------auto\n"
+          "/*\n"
+          " * %sMethodLookup searches %sMethodTable for the given name.\n"
+          " *\n"
+          " * @return the funptr of the method or 0 if the class has no such method\n"
+          " */\n"
+          "static funPtr %sMethodLookup(const char* method)\n"
+          "{\n"
+          "  int low = 0;\n"
+          "  int high = %d;\n"
+          "  while(low <= high)\n"
+          "    {\n"
+          "    int mid = (low + high) / 2;\n"
+          "    int cmp = strcmp(method, %sMethodTable[mid].Name);\n"
+          "    if(cmp == 0)\n"
+          "      {\n"
+          "      return %sMethodTable[mid].Function;\n"
+          "      }\n"
+          "    if(cmp < 0)\n"
+          "      {\n"
+          "      high = mid - 1;\n"
+          "      }\n"
+          "    else\n"
+          "      {\n"
+          "      low = mid + 1;\n"
+          "      }\n"
           "    }\n"
-          "  return map;\n"
-          "}\n\n"
+          "  return 0;\n"
+          "}\n\n",
+          data->ClassName,
+          data->ClassName,
+          data->ClassName,
+          data->NumberOfFunctions - 1,
+          data->ClassName,
+          data->ClassName
           );
+  free(names);
 }
 
 //--------------------------------------------------------------------------nix
@@ -1525,7 +1587,7 @@ void vtkParseOutput(FILE *fp, FileInfo *data)
 
     getClassInfo(data,classData);
     outputMappableFunctions(fp,classData);
-    outputMethodMapFunction(fp,classData);
+    outputMethodTableFunction(fp,classData);
     //outputMetaInfoExtractFunction(fp,classData);
 //    output_InitFunction(fp,classData);
     
@@ -1596,9 +1658,16 @@ void vtkParseOutput(FILE *fp, FileInfo *data)
     //-------------------------------------------------------------nix
     fprintf(fp,
             "\n"
-            "  if(funPtr f = %sMethodMap()[method])\n"
-            "  if(f(msg,op,resultStream))\n"
-            "    return 1;\n\n",
+            "  funPtr f = %sMethodLookup(method);\n"
+            "  if(f && f(msg,op,resultStream))\n"
+            "    {\n"
+            "    if(arlu)\n"
+            "      {\n"
+            "      arlu->SetResolvedCommandFunction(%sCommand);\n"
+            "      }\n"
+            "    return 1;\n"
+            "    }\n",
+            classData->ClassName,
             classData->ClassName
             );
 
@@ -1616,7 +1685,17 @@ void vtkParseOutput(FILE *fp, FileInfo *data)
       {
       fprintf(fp,"\n  if (%sCommand(arlu, op,method,msg,resultStream))\n",
               data->SuperClasses[i]);
-      fprintf(fp,"    {\n    return 1;\n    }\n");
+      /* This level wraps the method too, so the overload of a superclass
+         may only be used after the ones of this level were tried. */
+      fprintf(fp,
+              "    {\n"
+              "    if(f && arlu)\n"
+              "      {\n"
+              "      arlu->SetResolvedCommandFunction(%sCommand);\n"
+              "      }\n"
+              "    return 1;\n"
+              "    }\n",
+              data->ClassName);
       }
     /* Add the Print method to vtkObjectBase. */
     if (!strcmp("vtkObjectBase",data->ClassName))
@@ -36,10 +36,15 @@ public:
   typedef vtkstd::map<vtkstd::string, vtkClientServerNewInstanceFunction> NewInstanceFunctionsType;
   typedef vtkstd::map<vtkstd::string, vtkClientServerCommandFunction> ClassToFunctionMapType;
   typedef vtkstd::map<vtkTypeUInt32, vtkClientServerStream*> IDToMessageMapType;
+  typedef vtkstd::map<vtkstd::string, vtkClientServerCommandFunction> MethodToFunctionMapType;
+  typedef vtkstd::map<vtkClientServerCommandFunction, MethodToFunctionMapType> ResolvedFunctionMapType;
   //typedef vtkstd::map<vtkstd::string, vtkMetaObjectInfoFunction> MetaObjectInfoMapType;
   NewInstanceFunctionsType NewInstanceFunctions;
   ClassToFunctionMapType ClassToFunctionMap;
   IDToMessageMapType IDToMessageMap;
+  // For the command function of a class, the command function of the
+  // most derived level wrapping each method invoked so far.
+  ResolvedFunctionMapType ResolvedFunctionMap;
   //MetaObjectInfoMapType MetaObjectInfoMap;
 };
 
@@ -48,6 +53,7 @@ vtkClientServerInterpreter::vtkClientServerInterpreter()
 {
   this->Internal = new vtkClientServerInterpreterInternals;
   this->LastResultMessage = new vtkClientServerStream(this);
+  this->ResolvedCommandFunction = 0;
   this->LogStream = 0;
   this->LogFileStream = 0;
 }
@@ -389,10 +395,44 @@ vtkClientServerInterpreter
     // Find the command function for this object's type.
     if(vtkClientServerCommandFunction func = this->GetCommandFunction(obj))
       {
+      // Start at the most derived level known to wrap this method.  The
+      // levels skipped do not wrap the method at all, so this is what
+      // the full dispatch would do.  If it fails, fall back to the full
+      // dispatch, which also produces the proper error message.
+      vtkClientServerCommandFunction cached = 0;
+      vtkClientServerInterpreterInternals::ResolvedFunctionMapType::iterator
+        ci = this->Internal->ResolvedFunctionMap.find(func);
+      if(ci != this->Internal->ResolvedFunctionMap.end())
+        {
+        vtkClientServerInterpreterInternals::MethodToFunctionMapType::iterator
+          mi = ci->second.find(method);
+        if(mi != ci->second.end())
+          {
+          cached = mi->second;
+          }
+        }
+      if(cached && cached != func)
+        {
+        if(cached(this, obj, method, msg, *this->LastResultMessage))
+          {
+          return 1;
+          }
+        this->LastResultMessage->Reset();
+        }
+
       // Try to invoke the method.  If it fails, LastResultMessage
       // will have the error message.
+      this->ResolvedCommandFunction = 0;
       if(func(this, obj, method, msg, *this->LastResultMessage))
         {
+        // The map is looked up again since the invoked method may have
+        // loaded modules and cleared it.
+        if(this->ResolvedCommandFunction &&
+           this->ResolvedCommandFunction != cached)
+          {
+          this->Internal->ResolvedFunctionMap[func][method] =
+            this->ResolvedCommandFunction;
+          }
         return 1;
         }
       }
@@ -722,6 +762,8 @@ vtkClientServerInterpreter
 ::AddCommandFunction(const char* cname, vtkClientServerCommandFunction func)
 {
   this->Internal->ClassToFunctionMap[cname] = func;
+  // A new function may change how methods of a class are resolved.
+  this->Internal->ResolvedFunctionMap.clear();
 }
 
 //-------------------------------------------------------------------------nix
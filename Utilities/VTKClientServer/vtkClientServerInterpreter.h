@@ -142,6 +142,15 @@ public:
   // Get the command function for an object's class.
   vtkClientServerCommandFunction GetCommandFunction(vtkObjectBase* obj);
 
+  // Description:
+  // Called by generated code to report the command function of the most
+  // derived class level that wraps the method being invoked.  The
+  // interpreter caches it so the next invocation of the same method on the
+  // same class skips the levels that do not wrap the method.  Do not call
+  // directly.
+  void SetResolvedCommandFunction(vtkClientServerCommandFunction func)
+    { this->ResolvedCommandFunction = func; }
+
   // Description:
   // Add a function used to create new objects.
   //void AddNewInstanceFunction(vtkClientServerNewInstanceFunction f);
@@ -208,6 +217,9 @@ private:
   // Message containing the result of the last command.
   vtkClientServerStream* LastResultMessage;
 
+  // Command function of the class level that handled the last invoke.
+  vtkClientServerCommandFunction ResolvedCommandFunction;
+
   // Internal implementation details.
   vtkClientServerInterpreterInternals* Internal;
 
@@ -0,0 +1,147 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    $RCSfile$
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME
+// .SECTION Description
+// Evaluate functions over blocks of tuples and check that the results
+// match those of evaluating the function once per tuple.
+
+#include "vtkFunctionParser.h"
+#include "vtkMath.h"
+
+#include <vtkstd/vector>
+
+static const int NumberOfTuples = 1000;
+
+static const char *Functions[] = {
+  "a*b - 2.5/(b+3) + -a",
+  "sqrt(a) + ln(b) + log10(a) + asin(a) + acos(b)",
+  "abs(a)^2 + exp(b/10) + ceil(a) + floor(b) + min(a,b) + max(a,b)",
+  "sin(a) + cos(b) + tan(a) + atan(b) + sinh(a) + cosh(b) + tanh(a)",
+  "if(a < b, a, b) + if(a > b | a = b & b < 0, 1, 0)",
+  "v.w + mag(v) + mag(norm(w))",
+  "a*v + w*b - -v + iHat + jHat*2 + kHat*3",
+  "cross(v, w)",
+  "if(a > 0, v, w)",
+  0
+};
+
+// Evaluate the function of parser for tuple i of the variables.
+static int EvaluateTuple(vtkFunctionParser *parser, int i,
+                         const vtkstd::vector<double>& a,
+                         const vtkstd::vector<double>& b,
+                         const vtkstd::vector<double>& v,
+                         const vtkstd::vector<double>& w, double result[3])
+{
+  parser->SetScalarVariableValue("a", a[i]);
+  parser->SetScalarVariableValue("b", b[i]);
+  parser->SetVectorVariableValue("v", &v[3*i]);
+  parser->SetVectorVariableValue("w", &w[3*i]);
+  if (parser->IsScalarResult())
+    {
+    result[0] = parser->GetScalarResult();
+    return 1;
+    }
+  parser->GetVectorResult(result);
+  return 3;
+}
+
+int TestFunctionParserBlock(int, char *[])
+{
+  vtkstd::vector<double> a(NumberOfTuples), b(NumberOfTuples);
+  vtkstd::vector<double> v(3*NumberOfTuples), w(3*NumberOfTuples);
+  int i, j;
+  vtkMath::RandomSeed(8775070);
+  for (i = 0; i < NumberOfTuples; i++)
+    {
+    a[i] = vtkMath::Random(-1.5, 1.5);
+    b[i] = (i % 7 == 0) ? a[i] : vtkMath::Random(-1.5, 1.5);
+    for (j = 0; j < 3; j++)
+      {
+      v[3*i+j] = vtkMath::Random(-1.0, 1.0);
+      w[3*i+j] = (i % 5 == 0) ? 0.0 : vtkMath::Random(-1.0, 1.0);
+      }
+    }
+  const double *scalars[] = { &a[0], &b[0] };
+  const double *vectors[] = { &v[0], &w[0] };
+
+  vtkFunctionParser *parser = vtkFunctionParser::New();
+  parser->ReplaceInvalidValuesOn();
+  parser->SetReplacementValue(-7.0);
+  vtkstd::vector<double> block(3*NumberOfTuples);
+  for (int f = 0; Functions[f]; f++)
+    {
+    parser->RemoveAllVariables();
+    parser->SetFunction(Functions[f]);
+    double expected[3];
+    int numberOfComponents = EvaluateTuple(parser, 0, a, b, v, w, expected);
+    if (!parser->EvaluateBlock(NumberOfTuples, scalars, vectors, &block[0]))
+      {
+      cerr << "Could not evaluate " << Functions[f] << endl;
+      parser->Delete();
+      return 1;
+      }
+    for (i = 0; i < NumberOfTuples; i++)
+      {
+      EvaluateTuple(parser, i, a, b, v, w, expected);
+      for (j = 0; j < numberOfComponents; j++)
+        {
+        double value = block[numberOfComponents*i+j];
+        if (fabs(value - expected[j]) > 1e-12 * (1.0 + fabs(expected[j])))
+          {
+          cerr << Functions[f] << " is " << value << " for tuple " << i
+               << " instead of " << expected[j] << endl;
+          parser->Delete();
+          return 1;
+          }
+        }
+      }
+    }
+
+  // Without replacement, only the invalid tuples are flagged.
+  parser->ReplaceInvalidValuesOff();
+  parser->RemoveAllVariables();
+  parser->SetFunction("sqrt(a) + b*0");
+  parser->SetScalarVariableValue("a", 1.0);
+  parser->SetScalarVariableValue("b", 0.0);
+  if (!parser->IsScalarResult() ||
+      parser->EvaluateBlock(NumberOfTuples, scalars, vectors, &block[0]))
+    {
+    cerr << "Square roots of negative values were not reported." << endl;
+    parser->Delete();
+    return 1;
+    }
+  for (i = 0; i < NumberOfTuples; i++)
+    {
+    if ((a[i] < 0) != (block[i] == VTK_PARSER_ERROR_RESULT))
+      {
+      cerr << "Tuple " << i << " is " << block[i] << " for a = " << a[i]
+           << endl;
+      parser->Delete();
+      return 1;
+      }
+    }
+
+  // The function must be parsed first.
+  parser->SetFunction("a + 1");
+  if (parser->EvaluateBlock(NumberOfTuples, scalars, vectors, &block[0]))
+    {
+    cerr << "Evaluated a function that was not parsed." << endl;
+    parser->Delete();
+    return 1;
+    }
+
+  parser->Delete();
+  return 0;
+}
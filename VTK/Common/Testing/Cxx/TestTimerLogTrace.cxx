@@ -0,0 +1,162 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    $RCSfile$
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME
+// .SECTION Description
+// Mark nested events from several threads and check that they are nested
+// per thread and written as balanced Chrome trace events.
+
+#include "vtkMultiThreader.h"
+#include "vtkTimerLog.h"
+
+#include <vtksys/ios/sstream>
+#include <vtkstd/string>
+
+static const int NumberOfThreads = 4;
+static const int NumberOfRegions = 10;
+
+static void MarkInnerRegion()
+{
+  vtkTimerLogScope inner("Inner \"region\"");
+  vtkTimerLog::MarkEvent("Point");
+}
+
+static VTK_THREAD_RETURN_TYPE MarkNestedEvents(void *)
+{
+  for (int i = 0; i < NumberOfRegions; ++i)
+    {
+    vtkTimerLogScope outer("An outer region with a name longer than forty "
+                           "characters");
+    MarkInnerRegion();
+    }
+  return VTK_THREAD_RETURN_VALUE;
+}
+
+static void MarkTwoRegions()
+{
+  vtkTimerLogScope outer("Outer");
+  vtkTimerLogScope inner("Inner");
+}
+
+// Count the occurrences of pattern in str.
+static int CountOccurrences(const vtkstd::string& str, const char *pattern)
+{
+  int count = 0;
+  vtkstd::string::size_type pos = str.find(pattern);
+  while (pos != vtkstd::string::npos)
+    {
+    ++count;
+    pos = str.find(pattern, pos + 1);
+    }
+  return count;
+}
+
+int TestTimerLogTrace(int, char *[])
+{
+  vtkTimerLog::SetMaxEntries(1000);
+  vtkTimerLog::ResetLog();
+
+  vtkMultiThreader *threader = vtkMultiThreader::New();
+  threader->SetNumberOfThreads(NumberOfThreads);
+  threader->SetSingleMethod(MarkNestedEvents, 0);
+  threader->SingleMethodExecute();
+  threader->Delete();
+
+  int num = vtkTimerLog::GetNumberOfEvents();
+  if (num != NumberOfThreads * NumberOfRegions * 5)
+    {
+    cerr << "Recorded " << num << " events." << endl;
+    return 1;
+    }
+
+  // Events are nested per thread: starts are at the depth of their region,
+  // points and ends one deeper.
+  int i;
+  for (i = 0; i < num; ++i)
+    {
+    vtkstd::string event = vtkTimerLog::GetEventString(i);
+    int indent = vtkTimerLog::GetEventIndent(i);
+    int type = vtkTimerLog::GetEventType(i);
+    int expected;
+    if (event == "Point")
+      {
+      expected = 2;
+      }
+    else if (event == "Inner \"region\"")
+      {
+      expected = (type == vtkTimerLogEntry::START) ? 1 : 2;
+      }
+    else if (event == "An outer region with a name longer than forty "
+             "characters")
+      {
+      expected = (type == vtkTimerLogEntry::START) ? 0 : 1;
+      }
+    else
+      {
+      cerr << "Unexpected event \"" << event << "\"." << endl;
+      return 1;
+      }
+    if (indent != expected)
+      {
+      cerr << "Event " << i << " \"" << event << "\" of thread "
+           << vtkTimerLog::GetEventThread(i) << " has indent " << indent
+           << ", expected " << expected << "." << endl;
+      return 1;
+      }
+    }
+
+  vtksys_ios::ostringstream trace;
+  vtkTimerLog::DumpTraceEvents(&trace, 3);
+  vtkstd::string events = trace.str();
+  int numberOfRegions = NumberOfThreads * NumberOfRegions * 2;
+  if (CountOccurrences(events, "\"ph\":\"B\"") != numberOfRegions ||
+      CountOccurrences(events, "\"ph\":\"E\"") != numberOfRegions ||
+      CountOccurrences(events, "\"pid\":3") != num ||
+      CountOccurrences(events, "Inner \\\"region\\\"") != numberOfRegions)
+    {
+    cerr << "Bad trace events:\n" << events << endl;
+    return 1;
+    }
+
+  // A region without a name is recorded with an empty one.
+  vtkTimerLog::ResetLog();
+  {
+  vtkTimerLogScope unnamed(0);
+  vtkTimerLog::MarkEvent(0);
+  }
+  if (vtkTimerLog::GetNumberOfEvents() != 3 ||
+      vtkTimerLog::GetEventString(0)[0] != '\0' ||
+      vtkTimerLog::GetEventString(2)[0] != '\0')
+    {
+    cerr << "Unnamed events were not recorded." << endl;
+    return 1;
+    }
+
+  // End events whose start was overwritten are not written.
+  vtkTimerLog::SetMaxEntries(3);
+  vtkTimerLog::ResetLog();
+  MarkTwoRegions();
+  vtksys_ios::ostringstream wrapped;
+  vtkTimerLog::DumpTraceEvents(&wrapped, 0);
+  events = wrapped.str();
+  if (CountOccurrences(events, "\"ph\":\"B\"") != 1 ||
+      CountOccurrences(events, "\"ph\":\"E\"") != 1)
+    {
+    cerr << "Bad trace events after wrapping:\n" << events << endl;
+    return 1;
+    }
+
+  vtkTimerLog::CleanupLog();
+  return 0;
+}
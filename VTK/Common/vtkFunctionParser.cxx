@@ -16,6 +16,7 @@
 #include "vtkObjectFactory.h"
 
 #include <ctype.h>
+#include <vtkstd/vector>
 
 vtkCxxRevisionMacro(vtkFunctionParser, "$Revision$");
 vtkStandardNewMacro(vtkFunctionParser);
@@ -952,6 +953,560 @@ bool vtkFunctionParser::Evaluate()
   return true;
 }
 
+// Number of tuples EvaluateBlock pushes through each operation at a time.
+// Each stack entry holds this many values.
+#define VTK_PARSER_BLOCK_SIZE 256
+
+// Replace an invalid value or mark its tuple as failed.
+static inline void vtkParserInvalidValue(double& value, unsigned char& failed,
+                                         int replace, double replacement)
+{
+  if (replace)
+    {
+    value = replacement;
+    }
+  else
+    {
+    failed = 1;
+    }
+}
+
+int vtkFunctionParser::EvaluateBlock(vtkIdType numberOfTuples,
+                                     const double* const* scalarValues,
+                                     const double* const* vectorValues,
+                                     double* result)
+{
+  if (this->FunctionMTime.GetMTime() > this->ParseMTime.GetMTime() ||
+      this->StackSize == 0)
+    {
+    return 0;
+    }
+
+  const vtkIdType blockSize = VTK_PARSER_BLOCK_SIZE;
+  const int replace = this->ReplaceInvalidValues;
+  const double replacement = this->ReplacementValue;
+  vtkstd::vector<double> stackBuffer(this->StackSize * blockSize);
+  double *stack = &stackBuffer[0];
+  unsigned char failed[VTK_PARSER_BLOCK_SIZE];
+  int success = 1;
+
+  // The values of the ith stack entry for the tuples of the block.
+  #define Entry(i) (stack + (i)*blockSize)
+
+  for (vtkIdType begin = 0; begin < numberOfTuples; begin += blockSize)
+    {
+    const vtkIdType n = (numberOfTuples - begin < blockSize) ?
+      (numberOfTuples - begin) : blockSize;
+    int numImmediatesProcessed = 0;
+    int stackPosition = -1;
+    double *x, *y, *z, *u, *v, *w;
+    vtkIdType t;
+
+    memset(failed, 0, n);
+    for (int numBytesProcessed = 0; numBytesProcessed < this->ByteCodeSize;
+         numBytesProcessed++)
+      {
+      switch (this->ByteCode[numBytesProcessed])
+        {
+        case VTK_PARSER_IMMEDIATE:
+          {
+          x = Entry(++stackPosition);
+          const double value = this->Immediates[numImmediatesProcessed++];
+          for (t = 0; t < n; t++)
+            {
+            x[t] = value;
+            }
+          break;
+          }
+        case VTK_PARSER_UNARY_MINUS:
+          x = Entry(stackPosition);
+          for (t = 0; t < n; t++)
+            {
+            x[t] = -x[t];
+            }
+          break;
+        case VTK_PARSER_ADD:
+          x = Entry(stackPosition-1);
+          y = Entry(stackPosition--);
+          for (t = 0; t < n; t++)
+            {
+            x[t] += y[t];
+            }
+          break;
+        case VTK_PARSER_SUBTRACT:
+          x = Entry(stackPosition-1);
+          y = Entry(stackPosition--);
+          for (t = 0; t < n; t++)
+            {
+            x[t] -= y[t];
+            }
+          break;
+        case VTK_PARSER_MULTIPLY:
+          x = Entry(stackPosition-1);
+          y = Entry(stackPosition--);
+          for (t = 0; t < n; t++)
+            {
+            x[t] *= y[t];
+            }
+          break;
+        case VTK_PARSER_DIVIDE:
+          x = Entry(stackPosition-1);
+          y = Entry(stackPosition--);
+          for (t = 0; t < n; t++)
+            {
+            if (y[t] == 0)
+              {
+              vtkParserInvalidValue(x[t], failed[t], replace, replacement);
+              }
+            else
+              {
+              x[t] /= y[t];
+              }
+            }
+          break;
+        case VTK_PARSER_POWER:
+          x = Entry(stackPosition-1);
+          y = Entry(stackPosition--);
+          for (t = 0; t < n; t++)
+            {
+            x[t] = pow(x[t], y[t]);
+            }
+          break;
+        case VTK_PARSER_ABSOLUTE_VALUE:
+          x = Entry(stackPosition);
+          for (t = 0; t < n; t++)
+            {
+            x[t] = fabs(x[t]);
+            }
+          break;
+        case VTK_PARSER_EXPONENT:
+          x = Entry(stackPosition);
+          for (t = 0; t < n; t++)
+            {
+            x[t] = exp(x[t]);
+            }
+          break;
+        case VTK_PARSER_CEILING:
+          x = Entry(stackPosition);
+          for (t = 0; t < n; t++)
+            {
+            x[t] = ceil(x[t]);
+            }
+          break;
+        case VTK_PARSER_FLOOR:
+          x = Entry(stackPosition);
+          for (t = 0; t < n; t++)
+            {
+            x[t] = floor(x[t]);
+            }
+          break;
+        case VTK_PARSER_LOGARITHM:
+        case VTK_PARSER_LOGARITHME:
+          x = Entry(stackPosition);
+          for (t = 0; t < n; t++)
+            {
+            if (x[t] <= 0)
+              {
+              vtkParserInvalidValue(x[t], failed[t], replace, replacement);
+              }
+            else
+              {
+              x[t] = log(x[t]);
+              }
+            }
+          break;
+        case VTK_PARSER_LOGARITHM10:
+          x = Entry(stackPosition);
+          for (t = 0; t < n; t++)
+            {
+            if (x[t] <= 0)
+              {
+              vtkParserInvalidValue(x[t], failed[t], replace, replacement);
+              }
+            else
+              {
+              x[t] = log(x[t])/log(static_cast<double>(10));
+              }
+            }
+          break;
+        case VTK_PARSER_SQUARE_ROOT:
+          x = Entry(stackPosition);
+          for (t = 0; t < n; t++)
+            {
+            if (x[t] < 0)
+              {
+              vtkParserInvalidValue(x[t], failed[t], replace, replacement);
+              }
+            else
+              {
+              x[t] = sqrt(x[t]);
+              }
+            }
+          break;
+        case VTK_PARSER_SINE:
+          x = Entry(stackPosition);
+          for (t = 0; t < n; t++)
+            {
+            x[t] = sin(x[t]);
+            }
+          break;
+        case VTK_PARSER_COSINE:
+          x = Entry(stackPosition);
+          for (t = 0; t < n; t++)
+            {
+            x[t] = cos(x[t]);
+            }
+          break;
+        case VTK_PARSER_TANGENT:
+          x = Entry(stackPosition);
+          for (t = 0; t < n; t++)
+            {
+            x[t] = tan(x[t]);
+            }
+          break;
+        case VTK_PARSER_ARCSINE:
+          x = Entry(stackPosition);
+          for (t = 0; t < n; t++)
+            {
+            if (x[t] < -1 || x[t] > 1)
+              {
+              vtkParserInvalidValue(x[t], failed[t], replace, replacement);
+              }
+            else
+              {
+              x[t] = asin(x[t]);
+              }
+            }
+          break;
+        case VTK_PARSER_ARCCOSINE:
+          x = Entry(stackPosition);
+          for (t = 0; t < n; t++)
+            {
+            if (x[t] < -1 || x[t] > 1)
+              {
+              vtkParserInvalidValue(x[t], failed[t], replace, replacement);
+              }
+            else
+              {
+              x[t] = acos(x[t]);
+              }
+            }
+          break;
+        case VTK_PARSER_ARCTANGENT:
+          x = Entry(stackPosition);
+          for (t = 0; t < n; t++)
+            {
+            x[t] = atan(x[t]);
+            }
+          break;
+        case VTK_PARSER_HYPERBOLIC_SINE:
+          x = Entry(stackPosition);
+          for (t = 0; t < n; t++)
+            {
+            x[t] = sinh(x[t]);
+            }
+          break;
+        case VTK_PARSER_HYPERBOLIC_COSINE:
+          x = Entry(stackPosition);
+          for (t = 0; t < n; t++)
+            {
+            x[t] = cosh(x[t]);
+            }
+          break;
+        case VTK_PARSER_HYPERBOLIC_TANGENT:
+          x = Entry(stackPosition);
+          for (t = 0; t < n; t++)
+            {
+            x[t] = tanh(x[t]);
+            }
+          break;
+        case VTK_PARSER_MIN:
+          x = Entry(stackPosition-1);
+          y = Entry(stackPosition--);
+          for (t = 0; t < n; t++)
+            {
+            x[t] = (y[t] < x[t]) ? y[t] : x[t];
+            }
+          break;
+        case VTK_PARSER_MAX:
+          x = Entry(stackPosition-1);
+          y = Entry(stackPosition--);
+          for (t = 0; t < n; t++)
+            {
+            x[t] = (y[t] > x[t]) ? y[t] : x[t];
+            }
+          break;
+        case VTK_PARSER_CROSS:
+          x = Entry(stackPosition-5);
+          y = Entry(stackPosition-4);
+          z = Entry(stackPosition-3);
+          u = Entry(stackPosition-2);
+          v = Entry(stackPosition-1);
+          w = Entry(stackPosition);
+          for (t = 0; t < n; t++)
+            {
+            const double cx = y[t]*w[t] - z[t]*v[t];
+            const double cy = z[t]*u[t] - x[t]*w[t];
+            const double cz = x[t]*v[t] - y[t]*u[t];
+            x[t] = cx;
+            y[t] = cy;
+            z[t] = cz;
+            }
+          stackPosition -= 3;
+          break;
+        case VTK_PARSER_SIGN:
+          x = Entry(stackPosition);
+          for (t = 0; t < n; t++)
+            {
+            x[t] = (x[t] < 0) ? -1 : ((x[t] == 0) ? 0 : 1);
+            }
+          break;
+        case VTK_PARSER_VECTOR_UNARY_MINUS:
+          for (int i = 0; i < 3; i++)
+            {
+            x = Entry(stackPosition-i);
+            for (t = 0; t < n; t++)
+              {
+              x[t] = -x[t];
+              }
+            }
+          break;
+        case VTK_PARSER_DOT_PRODUCT:
+          x = Entry(stackPosition-5);
+          y = Entry(stackPosition-4);
+          z = Entry(stackPosition-3);
+          u = Entry(stackPosition-2);
+          v = Entry(stackPosition-1);
+          w = Entry(stackPosition);
+          for (t = 0; t < n; t++)
+            {
+            x[t] = x[t]*u[t] + y[t]*v[t] + z[t]*w[t];
+            }
+          stackPosition -= 5;
+          break;
+        case VTK_PARSER_VECTOR_ADD:
+          for (int i = 0; i < 3; i++)
+            {
+            x = Entry(stackPosition-5+i);
+            u = Entry(stackPosition-2+i);
+            for (t = 0; t < n; t++)
+              {
+              x[t] += u[t];
+              }
+            }
+          stackPosition -= 3;
+          break;
+        case VTK_PARSER_VECTOR_SUBTRACT:
+          for (int i = 0; i < 3; i++)
+            {
+            x = Entry(stackPosition-5+i);
+            u = Entry(stackPosition-2+i);
+            for (t = 0; t < n; t++)
+              {
+              x[t] -= u[t];
+              }
+            }
+          stackPosition -= 3;
+          break;
+        case VTK_PARSER_SCALAR_TIMES_VECTOR:
+          // The scalar is below the vector; the product moves down one
+          // entry.
+          x = Entry(stackPosition-3);
+          y = Entry(stackPosition-2);
+          z = Entry(stackPosition-1);
+          w = Entry(stackPosition);
+          for (t = 0; t < n; t++)
+            {
+            const double s = x[t];
+            x[t] = y[t]*s;
+            y[t] = z[t]*s;
+            z[t] = w[t]*s;
+            }
+          stackPosition--;
+          break;
+        case VTK_PARSER_VECTOR_TIMES_SCALAR:
+          x = Entry(stackPosition-3);
+          y = Entry(stackPosition-2);
+          z = Entry(stackPosition-1);
+          w = Entry(stackPosition);
+          for (t = 0; t < n; t++)
+            {
+            x[t] *= w[t];
+            y[t] *= w[t];
+            z[t] *= w[t];
+            }
+          stackPosition--;
+          break;
+        case VTK_PARSER_MAGNITUDE:
+          x = Entry(stackPosition-2);
+          y = Entry(stackPosition-1);
+          z = Entry(stackPosition);
+          for (t = 0; t < n; t++)
+            {
+            x[t] = sqrt(x[t]*x[t] + y[t]*y[t] + z[t]*z[t]);
+            }
+          stackPosition -= 2;
+          break;
+        case VTK_PARSER_NORMALIZE:
+          x = Entry(stackPosition-2);
+          y = Entry(stackPosition-1);
+          z = Entry(stackPosition);
+          for (t = 0; t < n; t++)
+            {
+            const double magnitude = sqrt(x[t]*x[t] + y[t]*y[t] + z[t]*z[t]);
+            if (magnitude != 0)
+              {
+              x[t] /= magnitude;
+              y[t] /= magnitude;
+              z[t] /= magnitude;
+              }
+            }
+          break;
+        case VTK_PARSER_IHAT:
+        case VTK_PARSER_JHAT:
+        case VTK_PARSER_KHAT:
+          {
+          const int axis = this->ByteCode[numBytesProcessed] - VTK_PARSER_IHAT;
+          for (int i = 0; i < 3; i++)
+            {
+            x = Entry(++stackPosition);
+            const double value = (i == axis) ? 1 : 0;
+            for (t = 0; t < n; t++)
+              {
+              x[t] = value;
+              }
+            }
+          break;
+          }
+        case VTK_PARSER_LESS_THAN:
+          x = Entry(stackPosition-1);
+          y = Entry(stackPosition--);
+          for (t = 0; t < n; t++)
+            {
+            x[t] = (x[t] < y[t]);
+            }
+          break;
+        case VTK_PARSER_GREATER_THAN:
+          x = Entry(stackPosition-1);
+          y = Entry(stackPosition--);
+          for (t = 0; t < n; t++)
+            {
+            x[t] = (x[t] > y[t]);
+            }
+          break;
+        case VTK_PARSER_EQUAL_TO:
+          x = Entry(stackPosition-1);
+          y = Entry(stackPosition--);
+          for (t = 0; t < n; t++)
+            {
+            x[t] = (x[t] == y[t]);
+            }
+          break;
+        case VTK_PARSER_AND:
+          x = Entry(stackPosition-1);
+          y = Entry(stackPosition--);
+          for (t = 0; t < n; t++)
+            {
+            x[t] = (x[t] && y[t]);
+            }
+          break;
+        case VTK_PARSER_OR:
+          x = Entry(stackPosition-1);
+          y = Entry(stackPosition--);
+          for (t = 0; t < n; t++)
+            {
+            x[t] = (x[t] || y[t]);
+            }
+          break;
+        case VTK_PARSER_IF:
+          // Same layout as in Evaluate(): the false value, the true value
+          // and the test from the bottom up.
+          x = Entry(stackPosition-2);
+          y = Entry(stackPosition-1);
+          w = Entry(stackPosition);
+          for (t = 0; t < n; t++)
+            {
+            x[t] = w[t] ? y[t] : x[t];
+            }
+          stackPosition -= 2;
+          break;
+        case VTK_PARSER_VECTOR_IF:
+          w = Entry(stackPosition);
+          for (int i = 0; i < 3; i++)
+            {
+            x = Entry(stackPosition-6+i);
+            y = Entry(stackPosition-3+i);
+            for (t = 0; t < n; t++)
+              {
+              x[t] = w[t] ? y[t] : x[t];
+              }
+            }
+          stackPosition -= 4;
+          break;
+        default:
+          {
+          const int variable =
+            this->ByteCode[numBytesProcessed] - VTK_PARSER_BEGIN_VARIABLES;
+          if (variable < this->NumberOfScalarVariables)
+            {
+            x = Entry(++stackPosition);
+            memcpy(x, scalarValues[variable] + begin, n*sizeof(double));
+            }
+          else
+            {
+            const double *values =
+              vectorValues[variable - this->NumberOfScalarVariables] +
+              3*begin;
+            x = Entry(++stackPosition);
+            y = Entry(++stackPosition);
+            z = Entry(++stackPosition);
+            for (t = 0; t < n; t++)
+              {
+              x[t] = values[3*t];
+              y[t] = values[3*t+1];
+              z[t] = values[3*t+2];
+              }
+            }
+          }
+        }
+      }
+
+    if (stackPosition == 0)
+      {
+      x = Entry(0);
+      double *r = result + begin;
+      for (t = 0; t < n; t++)
+        {
+        r[t] = failed[t] ? VTK_PARSER_ERROR_RESULT : x[t];
+        }
+      }
+    else if (stackPosition == 2)
+      {
+      x = Entry(0);
+      y = Entry(1);
+      z = Entry(2);
+      double *r = result + 3*begin;
+      for (t = 0; t < n; t++)
+        {
+        r[3*t] = failed[t] ? VTK_PARSER_ERROR_RESULT : x[t];
+        r[3*t+1] = failed[t] ? VTK_PARSER_ERROR_RESULT : y[t];
+        r[3*t+2] = failed[t] ? VTK_PARSER_ERROR_RESULT : z[t];
+        }
+      }
+    else
+      {
+      return 0;
+      }
+    for (t = 0; t < n && success; t++)
+      {
+      success = !failed[t];
+      }
+    }
+
+  #undef Entry
+  return success;
+}
+
 int vtkFunctionParser::IsScalarResult()
 {
   if (this->VariableMTime.GetMTime() > this->EvaluateMTime.GetMTime() || 
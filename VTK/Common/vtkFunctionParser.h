@@ -222,7 +222,24 @@ public:
   vtkBooleanMacro(ReplaceInvalidValues,int);
   vtkSetMacro(ReplacementValue,double);
   vtkGetMacro(ReplacementValue,double);
-  
+
+  // Description:
+  // Evaluate the function for numberOfTuples sets of variable values at
+  // once.  scalarValues[i] points to the numberOfTuples values of the ith
+  // scalar variable and vectorValues[i] to the 3*numberOfTuples interleaved
+  // components of the ith vector variable.  result receives one value per
+  // tuple for a scalar function and three for a vector function.  The
+  // function is run over blocks of tuples, one operation at a time, instead
+  // of once per tuple.  It must have been parsed by calling IsScalarResult()
+  // or IsVectorResult() first; EvaluateBlock() does not change the parser
+  // and may be called from several threads at once.  Tuples that cannot be
+  // evaluated are set to VTK_PARSER_ERROR_RESULT unless
+  // ReplaceInvalidValues is on.  Returns 0 if the function has not been
+  // parsed or if any tuple failed, 1 otherwise.
+  int EvaluateBlock(vtkIdType numberOfTuples,
+                    const double* const* scalarValues,
+                    const double* const* vectorValues, double* result);
+
 protected:
   vtkFunctionParser();
   ~vtkFunctionParser();
@@ -36,11 +36,70 @@
 #include <sys/types.h>
 #include <time.h>
 #endif
+#include "vtkCriticalSection.h"
+#include "vtkMultiThreader.h"
 #include "vtkObjectFactory.h"
 
+#include <vtkstd/vector>
+
 vtkCxxRevisionMacro(vtkTimerLog, "$Revision$");
 vtkStandardNewMacro(vtkTimerLog);
 
+// Each thread that marks events gets an index in this table, which also
+// keeps how deeply its start/end events are nested.  The table and the
+// timing table are guarded by vtkTimerLogLock.  Both are declared before
+// the cleanup singleton so that they outlive it.
+struct vtkTimerLogThread
+{
+  vtkMultiThreaderIDType Id;
+  int Indent;
+};
+static vtkSimpleCriticalSection vtkTimerLogLock;
+static vtkstd::vector<vtkTimerLogThread> vtkTimerLogThreads;
+
+// Return the index of the calling thread, adding it if needed.  Must be
+// called with vtkTimerLogLock held.
+static int vtkTimerLogGetThread()
+{
+  vtkMultiThreaderIDType id = vtkMultiThreader::GetCurrentThreadID();
+  int num = static_cast<int>(vtkTimerLogThreads.size());
+  for (int i = 0; i < num; ++i)
+    {
+    if (vtkMultiThreader::ThreadsEqual(vtkTimerLogThreads[i].Id, id))
+      {
+      return i;
+      }
+    }
+  vtkTimerLogThread thread;
+  thread.Id = id;
+  thread.Indent = 0;
+  vtkTimerLogThreads.push_back(thread);
+  return num;
+}
+
+// Write str as the contents of a JSON string.
+static void vtkTimerLogWriteJSONString(ostream& os, const char* str)
+{
+  for (; *str; ++str)
+    {
+    unsigned char c = static_cast<unsigned char>(*str);
+    if (c == '"' || c == '\\')
+      {
+      os << '\\' << *str;
+      }
+    else if (c < 0x20)
+      {
+      char code[8];
+      sprintf(code, "\\u%04x", c);
+      os << code;
+      }
+    else
+      {
+      os << *str;
+      }
+    }
+}
+
 // Create a singleton to cleanup the table.  No other singletons
 // should be using the timer log, so it is safe to do this without the
 // full ClassInitialize/ClassFinalize idiom.
@@ -56,7 +115,6 @@ static vtkTimerLogCleanup vtkTimerLogCleanupInstance;
 
 // initialze the class variables
 int vtkTimerLog::Logging = 1;
-int vtkTimerLog::Indent = 0;
 int vtkTimerLog::MaxEntries = 100;
 int vtkTimerLog::NextEntry = 0;
 int vtkTimerLog::WrapFlag = 0;
@@ -92,23 +150,26 @@ tms     vtkTimerLog::CurrentCpuTicks;
 // Allocate timing table with MaxEntries elements.
 void vtkTimerLog::AllocateLog()
 {
+  vtkTimerLogLock.Lock();
   if (vtkTimerLog::TimerLog != NULL)
     {
     delete [] vtkTimerLog::TimerLog;
     }
   vtkTimerLog::TimerLog = new vtkTimerLogEntry[vtkTimerLog::MaxEntries];
+  vtkTimerLogLock.Unlock();
 }
 
 //----------------------------------------------------------------------------
 // Remove timer log.
 void vtkTimerLog::CleanupLog()
 {
-  if ( !vtkTimerLog::TimerLog )
+  vtkTimerLogLock.Lock();
+  if ( vtkTimerLog::TimerLog )
     {
-    return;
+    delete [] vtkTimerLog::TimerLog;
+    vtkTimerLog::TimerLog = 0;
     }
-  delete [] vtkTimerLog::TimerLog;
-  vtkTimerLog::TimerLog = 0;
+  vtkTimerLogLock.Unlock();
 }
 
 //----------------------------------------------------------------------------
@@ -116,8 +177,10 @@ void vtkTimerLog::CleanupLog()
 // to zero when the first new event is recorded.
 void vtkTimerLog::ResetLog()
 {
+  vtkTimerLogLock.Lock();
   vtkTimerLog::WrapFlag = 0;
   vtkTimerLog::NextEntry = 0;
+  vtkTimerLogLock.Unlock();
   // may want to free TimerLog to force realloc so
   // that user can resize the table by changing MaxEntries.
 }
@@ -133,7 +196,7 @@ void vtkTimerLog::FormatAndMarkEvent(const char *format, ...)
     return;
     }
 
-  static  char event[4096];
+  char event[4096];
   va_list var_args;
   va_start(var_args, format);
   vsprintf(event, format, var_args);
@@ -146,18 +209,50 @@ void vtkTimerLog::FormatAndMarkEvent(const char *format, ...)
 //----------------------------------------------------------------------------
 // Record a timing event and capture walltime and cputicks.
 void vtkTimerLog::MarkEvent(const char *event)
+{
+  vtkTimerLog::MarkEventInternal(event, vtkTimerLogEntry::STANDALONE);
+}
+
+//----------------------------------------------------------------------------
+// Record a timing event and capture walltime and cputicks.
+// Increments indent after mark.
+void vtkTimerLog::MarkStartEvent(const char *event)
+{
+  vtkTimerLog::MarkEventInternal(event, vtkTimerLogEntry::START);
+}
+
+//----------------------------------------------------------------------------
+// Record a timing event and capture walltime and cputicks.
+// Decrements indent after mark.
+void vtkTimerLog::MarkEndEvent(const char *event)
+{
+  vtkTimerLog::MarkEventInternal(event, vtkTimerLogEntry::END);
+}
+
+//----------------------------------------------------------------------------
+// Record a timing event of the given type for the calling thread.
+void vtkTimerLog::MarkEventInternal(const char *event, unsigned char type)
 {
   if (! vtkTimerLog::Logging)
-    {
+    { // Maybe we should still change the Indent ...
     return;
     }
 
-  int strsize;
   double time_diff;
   int ticks_diff;
+  vtkTimerLogEntry *entry;
 
-  strsize = (strlen(event)) > VTK_LOG_EVENT_LENGTH - 1
-    ? VTK_LOG_EVENT_LENGTH-1 : static_cast<int>(strlen(event));
+  vtkTimerLogLock.Lock();
+  int thread = vtkTimerLogGetThread();
+  int indent = vtkTimerLogThreads[thread].Indent;
+  if (type == vtkTimerLogEntry::START)
+    {
+    ++vtkTimerLogThreads[thread].Indent;
+    }
+  else if (type == vtkTimerLogEntry::END)
+    {
+    --vtkTimerLogThreads[thread].Indent;
+    }
 
   // If this the first event we're recording, allocate the
   // internal timing table and initialize WallTime and CpuTicks
@@ -166,7 +261,7 @@ void vtkTimerLog::MarkEvent(const char *event)
     {
     if (vtkTimerLog::TimerLog == NULL)
       {
-      vtkTimerLog::AllocateLog();
+      vtkTimerLog::TimerLog = new vtkTimerLogEntry[vtkTimerLog::MaxEntries];
       }
     
 #ifdef _WIN32
@@ -181,16 +276,11 @@ void vtkTimerLog::MarkEvent(const char *event)
     gettimeofday( &(vtkTimerLog::FirstWallTime), NULL );
     times(&FirstCpuTicks);
 #endif
-    
-    vtkTimerLog::TimerLog[0].Indent = vtkTimerLog::Indent;
-    vtkTimerLog::TimerLog[0].WallTime = 0.0;
-    vtkTimerLog::TimerLog[0].CpuTicks = 0;
-    strncpy(vtkTimerLog::TimerLog[0].Event, event, strsize);
-    vtkTimerLog::TimerLog[0].Event[strsize] = '\0';
-    vtkTimerLog::NextEntry = 1;
-    return;
+    time_diff = 0.0;
+    ticks_diff = 0;
     }
-  
+  else
+    {
 #ifdef _WIN32
 #ifdef _WIN32_WCE
     SYSTEMTIME st;
@@ -202,35 +292,39 @@ void vtkTimerLog::MarkEvent(const char *event)
     time_diff = time_diff + ((vtkTimerLog::CurrentWallTime.dwLowDateTime - 
       vtkTimerLog::FirstWallTime.dwLowDateTime) / 10000000.0);
 #else
-  static double scale = 1.0/1000.0;
-  ::ftime( &(vtkTimerLog::CurrentWallTime) );
-  time_diff = 
-    vtkTimerLog::CurrentWallTime.time - vtkTimerLog::FirstWallTime.time;
-  time_diff += 
-    (vtkTimerLog::CurrentWallTime.millitm
-     - vtkTimerLog::FirstWallTime.millitm) * scale;
+    static double scale = 1.0/1000.0;
+    ::ftime( &(vtkTimerLog::CurrentWallTime) );
+    time_diff = 
+      vtkTimerLog::CurrentWallTime.time - vtkTimerLog::FirstWallTime.time;
+    time_diff += 
+      (vtkTimerLog::CurrentWallTime.millitm
+       - vtkTimerLog::FirstWallTime.millitm) * scale;
 #endif
-  ticks_diff = 0;
+    ticks_diff = 0;
 #else
-  static double scale = 1.0/1000000.0;
-  gettimeofday( &(vtkTimerLog::CurrentWallTime), NULL );
-  time_diff  =  vtkTimerLog::CurrentWallTime.tv_sec
-    - vtkTimerLog::FirstWallTime.tv_sec;
-  time_diff += 
-    (vtkTimerLog::CurrentWallTime.tv_usec
-     - vtkTimerLog::FirstWallTime.tv_usec) * scale;
-
-  times(&CurrentCpuTicks);
-  ticks_diff = (CurrentCpuTicks.tms_utime + CurrentCpuTicks.tms_stime) -
-                (FirstCpuTicks.tms_utime + FirstCpuTicks.tms_stime);
+    static double scale = 1.0/1000000.0;
+    gettimeofday( &(vtkTimerLog::CurrentWallTime), NULL );
+    time_diff  =  vtkTimerLog::CurrentWallTime.tv_sec
+      - vtkTimerLog::FirstWallTime.tv_sec;
+    time_diff += 
+      (vtkTimerLog::CurrentWallTime.tv_usec
+       - vtkTimerLog::FirstWallTime.tv_usec) * scale;
+
+    times(&CurrentCpuTicks);
+    ticks_diff = (CurrentCpuTicks.tms_utime + CurrentCpuTicks.tms_stime) -
+                  (FirstCpuTicks.tms_utime + FirstCpuTicks.tms_stime);
 #endif
+    }
 
-  vtkTimerLog::TimerLog[vtkTimerLog::NextEntry].Indent = vtkTimerLog::Indent;
-  vtkTimerLog::TimerLog[vtkTimerLog::NextEntry].WallTime =
-    static_cast<double>(time_diff);
-  vtkTimerLog::TimerLog[vtkTimerLog::NextEntry].CpuTicks = ticks_diff;
-  strncpy(vtkTimerLog::TimerLog[vtkTimerLog::NextEntry].Event, event, strsize);
-  vtkTimerLog::TimerLog[vtkTimerLog::NextEntry].Event[strsize] = '\0';
+  // Entries are reused when the table wraps around, so assigning the
+  // event string rarely needs to allocate.
+  entry = vtkTimerLog::TimerLog + vtkTimerLog::NextEntry;
+  entry->Indent = static_cast<unsigned char>(indent);
+  entry->WallTime = time_diff;
+  entry->CpuTicks = ticks_diff;
+  entry->Event = event ? event : "";
+  entry->Type = type;
+  entry->Thread = thread;
 
   vtkTimerLog::NextEntry++;
   if (vtkTimerLog::NextEntry == vtkTimerLog::MaxEntries)
@@ -238,35 +332,7 @@ void vtkTimerLog::MarkEvent(const char *event)
     vtkTimerLog::NextEntry = 0;
     vtkTimerLog::WrapFlag = 1;
     }
-}
-
-
-//----------------------------------------------------------------------------
-// Record a timing event and capture walltime and cputicks.
-// Increments indent after mark.
-void vtkTimerLog::MarkStartEvent(const char *event)
-{
-  if (! vtkTimerLog::Logging)
-    { // Maybe we should still change the Indent ...
-    return;
-    }
-
-  vtkTimerLog::MarkEvent(event);
-  ++vtkTimerLog::Indent;
-}
-
-//----------------------------------------------------------------------------
-// Record a timing event and capture walltime and cputicks.
-// Decrements indent after mark.
-void vtkTimerLog::MarkEndEvent(const char *event)
-{
-  if (! vtkTimerLog::Logging)
-    { // Maybe we should still change the Indent ...
-    return;
-    }
-
-  vtkTimerLog::MarkEvent(event);
-  --vtkTimerLog::Indent;
+  vtkTimerLogLock.Unlock();
 }
 
 //----------------------------------------------------------------------------
@@ -342,7 +408,7 @@ const char* vtkTimerLog::GetEventString(int idx)
 
   if (tmp) 
     {
-    return tmp->Event;
+    return tmp->Event.c_str();
     }
   else
     {
@@ -350,6 +416,36 @@ const char* vtkTimerLog::GetEventString(int idx)
     }
 }
 
+//----------------------------------------------------------------------------
+int vtkTimerLog::GetEventType(int idx)
+{
+  vtkTimerLogEntry *tmp = vtkTimerLog::GetEvent(idx);
+
+  if (tmp) 
+    {
+    return tmp->Type;
+    }
+  else
+    {
+    return vtkTimerLogEntry::STANDALONE;
+    }
+}
+
+//----------------------------------------------------------------------------
+int vtkTimerLog::GetEventThread(int idx)
+{
+  vtkTimerLogEntry *tmp = vtkTimerLog::GetEvent(idx);
+
+  if (tmp) 
+    {
+    return tmp->Thread;
+    }
+  else
+    {
+    return 0;
+    }
+}
+
 
 //----------------------------------------------------------------------------
 // Write the timing table out to a file.  Calculate some helpful
@@ -360,34 +456,39 @@ void vtkTimerLog::DumpLogWithIndents(ostream *os, double threshold)
   int num;
   int i1, i2, j;
   int indent1;
+  int thread1;
   int nextIndent;
   double dtime;
+  vtkTimerLogEntry *entry;
   
+  vtkTimerLogLock.Lock();
   num = vtkTimerLog::GetNumberOfEvents();
 
   for (i1=0; i1 < num; i1++)
     {
     indent1 = vtkTimerLog::GetEventIndent(i1);
+    thread1 = vtkTimerLog::GetEventThread(i1);
 
-    // Search for an end event.
-    i2 = i1 + 1;
-    while (i2 < num && vtkTimerLog::GetEventIndent(i2) > indent1)
-      { // This was a start event.
-      ++i2;
-      }
+    // Search for an end event among the events of the same thread.
     // If the next indent is smaller, then the event should be an end event.
-    if (i2 == num)
-      {
-      nextIndent = vtkTimerLog::Indent;
-      }
-    else
+    i2 = i1;
+    nextIndent = vtkTimerLogThreads[thread1].Indent;
+    for (j = i1 + 1; j < num; ++j)
       {
-      nextIndent = vtkTimerLog::GetEventIndent(i2);
+      entry = vtkTimerLog::GetEvent(j);
+      if (entry->Thread != thread1)
+        {
+        continue;
+        }
+      if (entry->Indent <= indent1)
+        {
+        nextIndent = entry->Indent;
+        break;
+        }
+      // This was a start event.
+      i2 = j;
       }
 
-    // Backup one to get the end event.
-    --i2;
-
     // Simple events and end events will have dtime of 0.
     dtime = vtkTimerLog::GetEventWallTime(i2) - vtkTimerLog::GetEventWallTime(i1);
     if (nextIndent == indent1)
@@ -400,6 +501,10 @@ void vtkTimerLog::DumpLogWithIndents(ostream *os, double threshold)
           {
           *os << "    ";
           }
+        if (thread1 > 0)
+          {
+          *os << "[thread " << thread1 << "] ";
+          }
         *os << vtkTimerLog::GetEventString(i1);
         if (i2 > i1)
           { // Start event.
@@ -412,10 +517,101 @@ void vtkTimerLog::DumpLogWithIndents(ostream *os, double threshold)
         }
       }
     }
+  vtkTimerLogLock.Unlock();
   
 #endif
 }
 
+//----------------------------------------------------------------------------
+// Write the timing table as a Chrome trace file.
+void vtkTimerLog::DumpTrace(const char *filename)
+{
+#ifndef _WIN32_WCE
+  ofstream os_with_warning_C4701(filename);
+  os_with_warning_C4701 << "{\"traceEvents\":[\n";
+  vtkTimerLog::DumpTraceEvents(&os_with_warning_C4701, 0);
+  os_with_warning_C4701 << "\n]}\n";
+  os_with_warning_C4701.close();
+#endif
+}
+
+//----------------------------------------------------------------------------
+// Write the events of the timing table as Chrome trace events.  Start
+// events become "B" (begin) events, end events "E" events and singleton
+// events thread scoped "i" (instant) events.
+void vtkTimerLog::DumpTraceEvents(ostream *os, int processId)
+{
+  vtkTimerLogEntry *entry;
+  const char *phase;
+  char timeStamp[64];
+  int num, i;
+  int first = 1;
+
+  vtkTimerLogLock.Lock();
+  double origin = vtkTimerLog::GetFirstWallTime();
+  // Number of start events written and not ended yet, per thread.
+  vtkstd::vector<int> open(vtkTimerLogThreads.size(), 0);
+  num = vtkTimerLog::GetNumberOfEvents();
+  for (i = 0; i < num; ++i)
+    {
+    entry = vtkTimerLog::GetEvent(i);
+    switch (entry->Type)
+      {
+      case vtkTimerLogEntry::START:
+        ++open[entry->Thread];
+        phase = "B";
+        break;
+      case vtkTimerLogEntry::END:
+        if (open[entry->Thread] == 0)
+          {
+          continue;
+          }
+        --open[entry->Thread];
+        phase = "E";
+        break;
+      default:
+        phase = "i";
+        break;
+      }
+    sprintf(timeStamp, "%.0f", (origin + entry->WallTime) * 1.0e6);
+    if (!first)
+      {
+      *os << ",\n";
+      }
+    first = 0;
+    *os << "{\"name\":\"";
+    vtkTimerLogWriteJSONString(*os, entry->Event.c_str());
+    *os << "\",\"cat\":\"vtk\",\"ph\":\"" << phase
+        << "\",\"ts\":" << timeStamp
+        << ",\"pid\":" << processId << ",\"tid\":" << entry->Thread;
+    if (entry->Type == vtkTimerLogEntry::STANDALONE)
+      {
+      *os << ",\"s\":\"t\"";
+      }
+    *os << "}";
+    }
+  vtkTimerLogLock.Unlock();
+}
+
+//----------------------------------------------------------------------------
+// Returns the time of the first event in seconds since January 1, 1970.
+double vtkTimerLog::GetFirstWallTime()
+{
+#ifdef _WIN32
+#ifdef _WIN32_WCE
+  double firstTime = vtkTimerLog::FirstWallTime.dwHighDateTime;
+  firstTime *= 429.4967296;
+  return firstTime + vtkTimerLog::FirstWallTime.dwLowDateTime / 10000000.0;
+#else
+  return vtkTimerLog::FirstWallTime.time +
+    vtkTimerLog::FirstWallTime.millitm / 1000.0;
+#endif
+#else
+  return vtkTimerLog::FirstWallTime.tv_sec +
+    vtkTimerLog::FirstWallTime.tv_usec / 1000000.0;
+#endif
+}
+
 //----------------------------------------------------------------------------
 // Write the timing table out to a file.  Calculate some helpful
 // statistics (deltas and  percentages) in the process.
@@ -425,12 +621,13 @@ void vtkTimerLog::DumpLog(const char *filename)
   ofstream os_with_warning_C4701(filename);
   int i;
     
+  vtkTimerLogLock.Lock();
   if ( vtkTimerLog::WrapFlag )
     {
     vtkTimerLog::DumpEntry(os_with_warning_C4701, 0,
                     vtkTimerLog::TimerLog[vtkTimerLog::NextEntry].WallTime, 0,
                     vtkTimerLog::TimerLog[vtkTimerLog::NextEntry].CpuTicks, 0,
-                    vtkTimerLog::TimerLog[vtkTimerLog::NextEntry].Event);
+                    vtkTimerLog::TimerLog[vtkTimerLog::NextEntry].Event.c_str());
     for (i=vtkTimerLog::NextEntry+1; i<vtkTimerLog::MaxEntries; i++)
       {
       vtkTimerLog::DumpEntry(os_with_warning_C4701,
@@ -440,7 +637,7 @@ void vtkTimerLog::DumpLog(const char *filename)
                 vtkTimerLog::TimerLog[i].CpuTicks,
                 vtkTimerLog::TimerLog[i].CpuTicks
                  - vtkTimerLog::TimerLog[i-1].CpuTicks,
-                vtkTimerLog::TimerLog[i].Event);
+                vtkTimerLog::TimerLog[i].Event.c_str());
       }
     vtkTimerLog::DumpEntry(os_with_warning_C4701, vtkTimerLog::MaxEntries-vtkTimerLog::NextEntry,
                     vtkTimerLog::TimerLog[0].WallTime,
@@ -449,7 +646,7 @@ void vtkTimerLog::DumpLog(const char *filename)
                     vtkTimerLog::TimerLog[0].CpuTicks,
                     vtkTimerLog::TimerLog[0].CpuTicks
                     -vtkTimerLog::TimerLog[vtkTimerLog::MaxEntries-1].CpuTicks,
-                    vtkTimerLog::TimerLog[0].Event);
+                    vtkTimerLog::TimerLog[0].Event.c_str());
     for (i=1; i<vtkTimerLog::NextEntry; i++)
       {
       vtkTimerLog::DumpEntry(os_with_warning_C4701, vtkTimerLog::MaxEntries-vtkTimerLog::NextEntry+i,
@@ -459,14 +656,14 @@ void vtkTimerLog::DumpLog(const char *filename)
                       vtkTimerLog::TimerLog[i].CpuTicks,
                       vtkTimerLog::TimerLog[i].CpuTicks
                       - vtkTimerLog::TimerLog[i-1].CpuTicks,
-                      vtkTimerLog::TimerLog[i].Event);
+                      vtkTimerLog::TimerLog[i].Event.c_str());
       }
     }
   else
     {
     vtkTimerLog::DumpEntry(os_with_warning_C4701, 0, vtkTimerLog::TimerLog[0].WallTime, 0,
                     vtkTimerLog::TimerLog[0].CpuTicks, 0,
-                    vtkTimerLog::TimerLog[0].Event);
+                    vtkTimerLog::TimerLog[0].Event.c_str());
     for (i=1; i<vtkTimerLog::NextEntry; i++)
       {
       vtkTimerLog::DumpEntry(os_with_warning_C4701, i, vtkTimerLog::TimerLog[i].WallTime,
@@ -475,9 +672,10 @@ void vtkTimerLog::DumpLog(const char *filename)
                       vtkTimerLog::TimerLog[i].CpuTicks,
                       vtkTimerLog::TimerLog[i].CpuTicks
                       - vtkTimerLog::TimerLog[i-1].CpuTicks,
-                      vtkTimerLog::TimerLog[i].Event);
+                      vtkTimerLog::TimerLog[i].Event.c_str());
       }
     }
+  vtkTimerLogLock.Unlock();
   
   os_with_warning_C4701.close();
 #endif
@@ -616,8 +814,10 @@ void vtkTimerLog::SetMaxEntries(int a)
   int num, i, offset;
   vtkTimerLogEntry *newLog, *tmp;
 
+  vtkTimerLogLock.Lock();
   if (vtkTimerLog::MaxEntries == a)
     {
+    vtkTimerLogLock.Unlock();
     return;
     }
 
@@ -626,6 +826,7 @@ void vtkTimerLog::SetMaxEntries(int a)
     {
     vtkTimerLog::MaxEntries = a;
     vtkTimerLog::TimerLog = newLog;
+    vtkTimerLogLock.Unlock();
     return;
     }
 
@@ -649,6 +850,12 @@ void vtkTimerLog::SetMaxEntries(int a)
   vtkTimerLog::TimerLog = newLog;
   vtkTimerLog::WrapFlag = 0;
   vtkTimerLog::NextEntry = num;
+  if (num == a)
+    {
+    vtkTimerLog::WrapFlag = 1;
+    vtkTimerLog::NextEntry = 0;
+    }
+  vtkTimerLogLock.Unlock();
 }
   
 
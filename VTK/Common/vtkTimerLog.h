@@ -21,6 +21,15 @@
 // In addition, vtkTimerLog allows the user to simply get the current
 // time, and to start/stop a simple timer separate from the timing
 // table logging.
+//
+// The timing table may be written to from several threads.  Start and end
+// events are nested per thread, and each entry records the thread that
+// marked it.  vtkTimerLogScope marks a start event on construction and the
+// matching end event on destruction so that nested regions stay balanced
+// on early returns.  Besides the text dumps, the table can be written in
+// the Chrome trace event format (load it in chrome://tracing) with
+// DumpTrace() or, when merging the logs of several processes,
+// DumpTraceEvents().
 
 #ifndef __vtkTimerLog_h
 #define __vtkTimerLog_h
@@ -59,16 +68,27 @@
 #endif
 
 
-#define VTK_LOG_EVENT_LENGTH 40
+//BTX
+#include <vtkstd/string> // STL Header
+//ETX
 
 //BTX
-typedef struct
+struct vtkTimerLogEntry
 {
+  enum LogEntryType
+    {
+    STANDALONE,
+    START,
+    END
+    };
+
   double WallTime;
   int CpuTicks;
-  char Event[VTK_LOG_EVENT_LENGTH];
+  vtkstd::string Event;
+  unsigned char Type;
   unsigned char Indent;
-} vtkTimerLogEntry;
+  int Thread;
+};
 //ETX
 
 class VTK_COMMON_EXPORT vtkTimerLog : public vtkObject 
@@ -107,7 +127,8 @@ public:
   // Description:
   // I want to time events, so I am creating this interface to
   // mark events that have a start and an end.  These events can be,
-  // nested. The standard Dumplog ignores the indents.
+  // nested. The standard Dumplog ignores the indents.  Events are nested
+  // separately for each thread.
   static void MarkStartEvent(const char *EventString);
   static void MarkEndEvent(const char *EventString);
 //BTX
@@ -115,11 +136,28 @@ public:
 //ETX
 
   // Description:
-  // Programatic access to events.  Indexed from 0 to num-1.
+  // Write the timing table as a Chrome trace file.  Time stamps are in
+  // microseconds since January 1, 1970 so that traces written by
+  // different processes line up.
+  static void DumpTrace(const char *filename);
+//BTX
+  // Description:
+  // Write the events of the timing table as a comma separated list of
+  // Chrome trace events attributed to the process processId, without the
+  // enclosing array.  Use this to merge the logs of several processes into
+  // one trace.  End events whose start has been overwritten are skipped.
+  static void DumpTraceEvents(ostream *os, int processId);
+//ETX
+
+  // Description:
+  // Programatic access to events.  Indexed from 0 to num-1.  The returned
+  // string is only valid until the entry is overwritten.
   static int GetNumberOfEvents();
   static int GetEventIndent(int i);
   static double GetEventWallTime(int i);
   static const char* GetEventString(int i);
+  static int GetEventType(int i);
+  static int GetEventThread(int i);
 
   // Description:
   // Record a timing event and capture wall time and cpu ticks.
@@ -181,9 +219,11 @@ protected:
   virtual ~vtkTimerLog() { };
 
   static vtkTimerLogEntry* GetEvent(int i);
+  static double GetFirstWallTime();
+
+  static void MarkEventInternal(const char *EventString, unsigned char type);
 
   static int               Logging;
-  static int               Indent;
   static int               MaxEntries;
   static int               NextEntry;
   static int               WrapFlag;
@@ -221,6 +261,34 @@ private:
 };
 
 
+//BTX
+// Marks a start event on construction and the matching end event when it
+// goes out of scope.
+class VTK_COMMON_EXPORT vtkTimerLogScope
+{
+public:
+  vtkTimerLogScope(const char *eventString)
+    {
+    if (eventString)
+      {
+      this->EventString = eventString;
+      }
+    vtkTimerLog::MarkStartEvent(this->EventString.c_str());
+    }
+  ~vtkTimerLogScope()
+    {
+    vtkTimerLog::MarkEndEvent(this->EventString.c_str());
+    }
+
+protected:
+  vtkstd::string EventString;
+
+private:
+  vtkTimerLogScope(const vtkTimerLogScope&);  // Not implemented.
+  void operator=(const vtkTimerLogScope&);  // Not implemented.
+};
+//ETX
+
 //
 // Set built-in type.  Creates member Set"name"() (e.g., SetVisibility());
 //
@@ -0,0 +1,117 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    $RCSfile$
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Merge the points of a triangle soup with vtkMergePoints and with
+// vtkThreadedMergePoints, check that they find the same points and report
+// the time both take.
+
+#include "vtkMath.h"
+#include "vtkMergePoints.h"
+#include "vtkPoints.h"
+#include "vtkSmartPointer.h"
+#include "vtkThreadedMergePoints.h"
+#include "vtkTimerLog.h"
+
+#include <vtkstd/vector>
+
+// Two triangles per square of a size x size grid, each with its own
+// points.  Some of the points at x = 0 have a -0.0 z coordinate.
+static vtkSmartPointer<vtkPoints> TriangleSoup(int size)
+{
+  static const int corners[6][2] =
+    { {0, 0}, {1, 0}, {1, 1}, {0, 0}, {1, 1}, {0, 1} };
+  vtkSmartPointer<vtkPoints> points = vtkSmartPointer<vtkPoints>::New();
+  points->SetNumberOfPoints(6*size*size);
+  vtkIdType id = 0;
+  for (int j = 0; j < size; j++)
+    {
+    for (int i = 0; i < size; i++)
+      {
+      for (int k = 0; k < 6; k++)
+        {
+        double x = 0.1*(i + corners[k][0]);
+        double y = 0.1*(j + corners[k][1]);
+        points->SetPoint(id++, x, y, (x == 0.0 && k == 3) ? -0.0 : 0.0);
+        }
+      }
+    }
+  return points;
+}
+
+int TestThreadedMergePoints(int, char *[])
+{
+  const int size = 300;
+  vtkSmartPointer<vtkPoints> points = TriangleSoup(size);
+  vtkIdType numPts = points->GetNumberOfPoints();
+  double bounds[6];
+  points->GetBounds(bounds);
+
+  vtkSmartPointer<vtkTimerLog> timer = vtkSmartPointer<vtkTimerLog>::New();
+  vtkSmartPointer<vtkMergePoints> serial =
+    vtkSmartPointer<vtkMergePoints>::New();
+  vtkSmartPointer<vtkPoints> merged = vtkSmartPointer<vtkPoints>::New();
+  vtkstd::vector<vtkIdType> serialIds(numPts);
+  timer->StartTimer();
+  serial->InitPointInsertion(merged, bounds, numPts);
+  double x[3];
+  vtkIdType i;
+  for (i = 0; i < numPts; i++)
+    {
+    points->GetPoint(i, x);
+    serial->InsertUniquePoint(x, serialIds[i]);
+    }
+  timer->StopTimer();
+  cout << "vtkMergePoints: " << timer->GetElapsedTime() << "s" << endl;
+
+  vtkSmartPointer<vtkThreadedMergePoints> threaded =
+    vtkSmartPointer<vtkThreadedMergePoints>::New();
+  vtkstd::vector<vtkIdType> mergeMap(numPts);
+  for (int threads = 1; threads <= 8; threads *= 2)
+    {
+    threaded->SetNumberOfThreads(threads);
+    timer->StartTimer();
+    vtkIdType numMerged = threaded->MergePoints(points, &mergeMap[0]);
+    timer->StopTimer();
+    cout << "vtkThreadedMergePoints with " << threads << " threads: "
+         << timer->GetElapsedTime() << "s" << endl;
+
+    if (numMerged != merged->GetNumberOfPoints())
+      {
+      cerr << "Merged into " << numMerged << " points instead of "
+           << merged->GetNumberOfPoints() << endl;
+      return 1;
+      }
+    for (i = 0; i < numPts; i++)
+      {
+      if (mergeMap[i] > i || mergeMap[mergeMap[i]] != mergeMap[i] ||
+          serialIds[i] != serialIds[mergeMap[i]])
+        {
+        cerr << "Point " << i << " is merged with " << mergeMap[i] << endl;
+        return 1;
+        }
+      }
+    }
+
+  // Points with NaN coordinates are never merged.
+  points->SetPoint(7, vtkMath::Nan(), 0.0, 0.0);
+  points->SetPoint(8, vtkMath::Nan(), 0.0, 0.0);
+  threaded->MergePoints(points, &mergeMap[0]);
+  if (mergeMap[7] != 7 || mergeMap[8] != 8)
+    {
+    cerr << "Points with NaN coordinates were merged." << endl;
+    return 1;
+    }
+
+  return 0;
+}
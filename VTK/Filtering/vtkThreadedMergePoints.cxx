@@ -0,0 +1,253 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    $RCSfile$
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkThreadedMergePoints.h"
+
+#include "vtkDataArray.h"
+#include "vtkMultiThreader.h"
+#include "vtkObjectFactory.h"
+#include "vtkPoints.h"
+
+#include <vtkstd/algorithm>
+#include <vtkstd/vector>
+
+vtkCxxRevisionMacro(vtkThreadedMergePoints, "$Revision$");
+vtkStandardNewMacro(vtkThreadedMergePoints);
+
+// Smallest number of points worth sorting in a thread of its own.
+#define VTK_THREADED_MERGE_POINTS_MIN_RANGE 4096
+
+//----------------------------------------------------------------------------
+// A point id with a hash of the coordinates of the point.  Coincident points
+// have the same key; the keys are sorted instead of the coordinates.
+struct vtkThreadedMergePointsKey
+{
+  vtkTypeUInt64 Hash;
+  vtkIdType Id;
+
+  bool operator<(const vtkThreadedMergePointsKey& other) const
+    {
+    return this->Hash < other.Hash ||
+      (this->Hash == other.Hash && this->Id < other.Id);
+    }
+};
+
+//----------------------------------------------------------------------------
+struct vtkThreadedMergePointsThreadStruct
+{
+  vtkDataArray *Data;
+  vtkThreadedMergePointsKey *Keys;
+  // The keys are sorted in ranges [Bounds[i], Bounds[i+1]).
+  vtkstd::vector<vtkIdType> Bounds;
+  // Number of sorted ranges on each side of a merge.
+  int Width;
+};
+
+//----------------------------------------------------------------------------
+static inline vtkTypeUInt64 vtkThreadedMergePointsHashValue(double value)
+{
+  // -0.0 and 0.0 coincide.
+  if (value == 0.0)
+    {
+    value = 0.0;
+    }
+  vtkTypeUInt64 bits;
+  memcpy(&bits, &value, sizeof(bits));
+  return bits;
+}
+
+//----------------------------------------------------------------------------
+template <class T>
+void vtkThreadedMergePointsHash(const T *x, vtkThreadedMergePointsKey *keys,
+                                vtkIdType begin, vtkIdType end)
+{
+  const vtkTypeUInt64 multiplier =
+    (static_cast<vtkTypeUInt64>(0x9E3779B9) << 32) | 0x7F4A7C15;
+  for (vtkIdType i = begin; i < end; i++)
+    {
+    const T *p = x + 3*i;
+    vtkTypeUInt64 h =
+      vtkThreadedMergePointsHashValue(static_cast<double>(p[0]));
+    h = h*multiplier ^
+      vtkThreadedMergePointsHashValue(static_cast<double>(p[1]));
+    h = h*multiplier ^
+      vtkThreadedMergePointsHashValue(static_cast<double>(p[2]));
+    h ^= h >> 29;
+    keys[i].Hash = h;
+    keys[i].Id = i;
+    }
+}
+
+//----------------------------------------------------------------------------
+// Hash and sort the points of one range.
+static VTK_THREAD_RETURN_TYPE vtkThreadedMergePointsSortRange(void *arg)
+{
+  vtkMultiThreader::ThreadInfo *info =
+    static_cast<vtkMultiThreader::ThreadInfo *>(arg);
+  vtkThreadedMergePointsThreadStruct *str =
+    static_cast<vtkThreadedMergePointsThreadStruct *>(info->UserData);
+  int range = info->ThreadID;
+  vtkIdType begin = str->Bounds[range];
+  vtkIdType end = str->Bounds[range+1];
+  switch (str->Data->GetDataType())
+    {
+    vtkTemplateMacro(
+      vtkThreadedMergePointsHash(
+        static_cast<VTK_TT *>(str->Data->GetVoidPointer(0)), str->Keys,
+        begin, end));
+    }
+  vtkstd::sort(str->Keys + begin, str->Keys + end);
+  return VTK_THREAD_RETURN_VALUE;
+}
+
+//----------------------------------------------------------------------------
+// Merge two neighbouring groups of sorted ranges.
+static VTK_THREAD_RETURN_TYPE vtkThreadedMergePointsMergeRanges(void *arg)
+{
+  vtkMultiThreader::ThreadInfo *info =
+    static_cast<vtkMultiThreader::ThreadInfo *>(arg);
+  vtkThreadedMergePointsThreadStruct *str =
+    static_cast<vtkThreadedMergePointsThreadStruct *>(info->UserData);
+  int numRanges = static_cast<int>(str->Bounds.size()) - 1;
+  int first = 2 * info->ThreadID * str->Width;
+  int middle = first + str->Width;
+  int last = middle + str->Width;
+  if (middle >= numRanges)
+    {
+    return VTK_THREAD_RETURN_VALUE;
+    }
+  if (last > numRanges)
+    {
+    last = numRanges;
+    }
+  vtkstd::inplace_merge(str->Keys + str->Bounds[first],
+                        str->Keys + str->Bounds[middle],
+                        str->Keys + str->Bounds[last]);
+  return VTK_THREAD_RETURN_VALUE;
+}
+
+//----------------------------------------------------------------------------
+// Map every point to the first point it coincides with.  Coincident points
+// are in the same run of equal hashes, ordered by id.
+template <class T>
+vtkIdType vtkThreadedMergePointsMap(const T *x,
+                                    const vtkThreadedMergePointsKey *keys,
+                                    vtkIdType numPts, vtkIdType *mergeMap)
+{
+  vtkIdType numMerged = 0;
+  vtkIdType runBegin = 0;
+  for (vtkIdType i = 0; i < numPts; i++)
+    {
+    if (keys[i].Hash != keys[runBegin].Hash)
+      {
+      runBegin = i;
+      }
+    vtkIdType id = keys[i].Id;
+    const T *p = x + 3*id;
+    mergeMap[id] = id;
+    // Points with NaN coordinates do not coincide with any point.
+    vtkIdType j = (p[0] == p[0] && p[1] == p[1] && p[2] == p[2]) ?
+      runBegin : i;
+    for (; j < i; j++)
+      {
+      vtkIdType other = keys[j].Id;
+      const T *q = x + 3*other;
+      if (mergeMap[other] == other &&
+          p[0] == q[0] && p[1] == q[1] && p[2] == q[2])
+        {
+        mergeMap[id] = other;
+        break;
+        }
+      }
+    if (mergeMap[id] == id)
+      {
+      numMerged++;
+      }
+    }
+  return numMerged;
+}
+
+//----------------------------------------------------------------------------
+vtkThreadedMergePoints::vtkThreadedMergePoints()
+{
+  this->Threader = vtkMultiThreader::New();
+  this->NumberOfThreads = this->Threader->GetNumberOfThreads();
+}
+
+//----------------------------------------------------------------------------
+vtkThreadedMergePoints::~vtkThreadedMergePoints()
+{
+  this->Threader->Delete();
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkThreadedMergePoints::MergePoints(vtkPoints *points,
+                                              vtkIdType *mergeMap)
+{
+  vtkIdType numPts = points ? points->GetNumberOfPoints() : 0;
+  if (numPts < 1)
+    {
+    return 0;
+    }
+
+  // Hash and sort contiguous ranges of points, one per thread.
+  vtkstd::vector<vtkThreadedMergePointsKey> keys(numPts);
+  vtkThreadedMergePointsThreadStruct str;
+  str.Data = points->GetData();
+  str.Keys = &keys[0];
+  vtkIdType maxRanges = numPts / VTK_THREADED_MERGE_POINTS_MIN_RANGE + 1;
+  int numRanges = this->NumberOfThreads;
+  if (maxRanges < numRanges)
+    {
+    numRanges = static_cast<int>(maxRanges);
+    }
+  for (int range = 0; range <= numRanges; range++)
+    {
+    str.Bounds.push_back(numPts / numRanges * range +
+                         (range < numPts % numRanges ? range :
+                          numPts % numRanges));
+    }
+  this->Threader->SetNumberOfThreads(numRanges);
+  this->Threader->SetSingleMethod(vtkThreadedMergePointsSortRange, &str);
+  this->Threader->SingleMethodExecute();
+
+  // Merge neighbouring sorted ranges pairwise until one is left.
+  for (str.Width = 1; str.Width < numRanges; str.Width *= 2)
+    {
+    int numMerges = (numRanges + 2*str.Width - 1) / (2*str.Width);
+    this->Threader->SetNumberOfThreads(numMerges);
+    this->Threader->SetSingleMethod(vtkThreadedMergePointsMergeRanges, &str);
+    this->Threader->SingleMethodExecute();
+    }
+
+  vtkIdType numMerged = 0;
+  switch (str.Data->GetDataType())
+    {
+    vtkTemplateMacro(
+      numMerged = vtkThreadedMergePointsMap(
+        static_cast<VTK_TT *>(str.Data->GetVoidPointer(0)), &keys[0],
+        numPts, mergeMap));
+    default:
+      vtkErrorMacro("Unsupported point type " << str.Data->GetDataType());
+    }
+  return numMerged;
+}
+
+//----------------------------------------------------------------------------
+void vtkThreadedMergePoints::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os,indent);
+
+  os << indent << "Number Of Threads: " << this->NumberOfThreads << "\n";
+}
@@ -0,0 +1,69 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    $RCSfile$
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkThreadedMergePoints - merge exactly coincident points with several threads
+// .SECTION Description
+// vtkThreadedMergePoints is a vtkMergePoints that can also merge a whole
+// set of points at once.  MergePoints() sorts the point ids by coordinates,
+// each of NumberOfThreads threads sorting a contiguous range of ids before
+// the sorted ranges are merged pairwise, and maps every point to the first
+// of the points it coincides with.  Filters that know all the points to
+// merge up front, such as vtkCleanPolyData, use it instead of inserting
+// the points one at a time.  Point insertion is inherited from
+// vtkMergePoints, so vtkThreadedMergePoints can be given to any filter
+// taking a vtkIncrementalPointLocator.
+// .SECTION See Also
+// vtkMergePoints vtkCleanPolyData
+
+#ifndef __vtkThreadedMergePoints_h
+#define __vtkThreadedMergePoints_h
+
+#include "vtkMergePoints.h"
+
+class vtkMultiThreader;
+
+class VTK_FILTERING_EXPORT vtkThreadedMergePoints : public vtkMergePoints
+{
+public:
+  static vtkThreadedMergePoints *New();
+  vtkTypeRevisionMacro(vtkThreadedMergePoints,vtkMergePoints);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  // Description:
+  // Find the exactly coincident points of points.  mergeMap[i] is set to
+  // the smallest id of the points coinciding with point i, i.e. to i for
+  // the first of them.  Points with NaN coordinates are never merged.
+  // Returns the number of distinct points.  The point insertion process is
+  // neither used nor modified.
+  vtkIdType MergePoints(vtkPoints *points, vtkIdType *mergeMap);
+
+  // Description:
+  // Get/Set the number of threads used by MergePoints().  Defaults to the
+  // number of threads of vtkMultiThreader.
+  vtkSetClampMacro(NumberOfThreads,int,1,VTK_MAX_THREADS);
+  vtkGetMacro(NumberOfThreads,int);
+
+protected:
+  vtkThreadedMergePoints();
+  ~vtkThreadedMergePoints();
+
+  vtkMultiThreader *Threader;
+  int NumberOfThreads;
+
+private:
+  vtkThreadedMergePoints(const vtkThreadedMergePoints&);  // Not implemented.
+  void operator=(const vtkThreadedMergePoints&);  // Not implemented.
+};
+
+#endif
@@ -0,0 +1,297 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    $RCSfile$
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Probe an unstructured grid with a cell locator and one or several
+// threads, before and after the grid is moved, and a surface with points
+// off its plane, alone and overlapped by a parallel copy, and check that
+// the result is that of vtkDataSet::FindCell().
+
+#include "vtkAppendPolyData.h"
+#include "vtkCellData.h"
+#include "vtkDataArray.h"
+#include "vtkDoubleArray.h"
+#include "vtkIdTypeArray.h"
+#include "vtkMath.h"
+#include "vtkModifiedBSPTree.h"
+#include "vtkPlaneSource.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkProbeFilter.h"
+#include "vtkSmartPointer.h"
+#include "vtkUnstructuredGrid.h"
+
+static const int Size = 10;
+
+// A Size^3 grid of unit hexahedra with a linear point field and a cell
+// field.
+static vtkSmartPointer<vtkUnstructuredGrid> MakeGrid()
+{
+  vtkSmartPointer<vtkUnstructuredGrid> grid =
+    vtkSmartPointer<vtkUnstructuredGrid>::New();
+  const int n = Size + 1;
+  vtkSmartPointer<vtkPoints> points = vtkSmartPointer<vtkPoints>::New();
+  vtkSmartPointer<vtkDoubleArray> linear =
+    vtkSmartPointer<vtkDoubleArray>::New();
+  linear->SetName("Linear");
+  for (int k = 0; k < n; k++)
+    {
+    for (int j = 0; j < n; j++)
+      {
+      for (int i = 0; i < n; i++)
+        {
+        points->InsertNextPoint(i, j, k);
+        linear->InsertNextValue(i + 2.0*j + 3.0*k);
+        }
+      }
+    }
+  grid->SetPoints(points);
+  grid->GetPointData()->AddArray(linear);
+
+  vtkSmartPointer<vtkDoubleArray> cellIds =
+    vtkSmartPointer<vtkDoubleArray>::New();
+  cellIds->SetName("CellIds");
+  grid->Allocate(Size*Size*Size);
+  for (int k = 0; k < Size; k++)
+    {
+    for (int j = 0; j < Size; j++)
+      {
+      for (int i = 0; i < Size; i++)
+        {
+        vtkIdType p = i + n*(j + n*k);
+        vtkIdType ids[8] = { p, p+1, p+n+1, p+n,
+                             p+n*n, p+n*n+1, p+n*n+n+1, p+n*n+n };
+        cellIds->InsertNextValue(
+          grid->InsertNextCell(VTK_HEXAHEDRON, 8, ids));
+        }
+      }
+    }
+  grid->GetCellData()->AddArray(cellIds);
+  return grid;
+}
+
+// Points inside the cells, away from their faces, and points outside the
+// grid.
+static vtkSmartPointer<vtkPolyData> MakeProbe()
+{
+  vtkSmartPointer<vtkPoints> points = vtkSmartPointer<vtkPoints>::New();
+  vtkMath::RandomSeed(4321);
+  for (int i = 0; i < 20000; i++)
+    {
+    double x[3];
+    for (int j = 0; j < 3; j++)
+      {
+      x[j] = static_cast<int>(vtkMath::Random(-2.0, Size + 2.0)) +
+        vtkMath::Random(0.1, 0.9);
+      }
+    points->InsertNextPoint(x);
+    }
+  vtkSmartPointer<vtkPolyData> probe = vtkSmartPointer<vtkPolyData>::New();
+  probe->SetPoints(points);
+  return probe;
+}
+
+static bool SameArrays(vtkDataArray* a, vtkDataArray* b)
+{
+  if (!a || !b ||
+      a->GetNumberOfTuples() != b->GetNumberOfTuples() ||
+      a->GetNumberOfComponents() != b->GetNumberOfComponents())
+    {
+    return false;
+    }
+  for (vtkIdType i = 0; i < a->GetNumberOfTuples(); i++)
+    {
+    for (int j = 0; j < a->GetNumberOfComponents(); j++)
+      {
+      if (fabs(a->GetComponent(i, j) - b->GetComponent(i, j)) > 1e-9)
+        {
+        return false;
+        }
+      }
+    }
+  return true;
+}
+
+// Points above and below a unit square tilted about the x axis to the normal
+// (0, 1, 1), so that the bounds of its quads are not flat. Half of the points
+// are within the probe tolerance of the square, the others are farther from
+// it but mostly inside the bounds of a quad. The points are moved by offset
+// along the normal.
+static vtkSmartPointer<vtkPolyData> MakeSurfaceProbe(double offset)
+{
+  double s = sqrt(0.5);
+  vtkSmartPointer<vtkPoints> points = vtkSmartPointer<vtkPoints>::New();
+  for (int i = 0; i < 2000; i++)
+    {
+    double u = vtkMath::Random(-0.5, 0.5);
+    double v = vtkMath::Random(-0.5, 0.5);
+    double w = (i % 2 ? vtkMath::Random(0.002, 0.01) :
+                vtkMath::Random(0.0, 1e-5)) * (i % 4 < 2 ? 1.0 : -1.0);
+    w += offset;
+    points->InsertNextPoint(u, s*(v + w), s*(w - v));
+    }
+  vtkSmartPointer<vtkPolyData> probe = vtkSmartPointer<vtkPolyData>::New();
+  probe->SetPoints(points);
+  return probe;
+}
+
+static bool SameProbes(vtkProbeFilter* a, vtkProbeFilter* b,
+                       const char* arrayName = "CellIds")
+{
+  vtkPointData* pa = a->GetOutput()->GetPointData();
+  vtkPointData* pb = b->GetOutput()->GetPointData();
+  vtkDataArray* mask = pa->GetArray("vtkValidPointMask");
+  if (!mask || mask->GetRange()[1] != 1.0 || mask->GetRange()[0] != 0.0)
+    {
+    cerr << "Expected points inside and outside the grid." << endl;
+    return false;
+    }
+  const char* names[2] = { "vtkValidPointMask", arrayName };
+  for (int i = 0; i < 2; i++)
+    {
+    if (!SameArrays(pa->GetArray(names[i]), pb->GetArray(names[i])))
+      {
+      cerr << "Array " << names[i] << " differs." << endl;
+      return false;
+      }
+    }
+  return SameArrays(a->GetValidPoints(), b->GetValidPoints());
+}
+
+int TestProbeFilterLocator(int, char *[])
+{
+  vtkSmartPointer<vtkUnstructuredGrid> grid = MakeGrid();
+  vtkSmartPointer<vtkPolyData> probe = MakeProbe();
+
+  vtkSmartPointer<vtkProbeFilter> reference =
+    vtkSmartPointer<vtkProbeFilter>::New();
+  reference->SetInput(probe);
+  reference->SetSource(grid);
+
+  vtkSmartPointer<vtkModifiedBSPTree> locator =
+    vtkSmartPointer<vtkModifiedBSPTree>::New();
+  const int numberOfThreads[2] = { 1, 4 };
+  vtkSmartPointer<vtkProbeFilter> probes[2];
+  for (int i = 0; i < 2; i++)
+    {
+    probes[i] = vtkSmartPointer<vtkProbeFilter>::New();
+    probes[i]->SetInput(probe);
+    probes[i]->SetSource(grid);
+    probes[i]->SetCellLocatorPrototype(locator);
+    probes[i]->SetNumberOfThreads(numberOfThreads[i]);
+    }
+
+  // The second time, the locators are rebuilt for the moved grid.
+  for (int step = 0; step < 2; step++)
+    {
+    if (step)
+      {
+      vtkPoints* points = grid->GetPoints();
+      for (vtkIdType i = 0; i < points->GetNumberOfPoints(); i++)
+        {
+        double x[3];
+        points->GetPoint(i, x);
+        points->SetPoint(i, x[0] + 1.0, x[1], x[2]);
+        }
+      points->Modified();
+      }
+    reference->Update();
+    for (int i = 0; i < 2; i++)
+      {
+      probes[i]->Update();
+      if (!SameProbes(reference, probes[i]) ||
+          !SameArrays(reference->GetOutput()->GetPointData()->
+                      GetArray("Linear"),
+                      probes[i]->GetOutput()->GetPointData()->
+                      GetArray("Linear")))
+        {
+        cerr << "Probing with " << numberOfThreads[i]
+             << " threads differs at step " << step << "." << endl;
+        return 1;
+        }
+      }
+    }
+
+  // The points far from the plane of the quads are not probed.
+  vtkSmartPointer<vtkPlaneSource> plane =
+    vtkSmartPointer<vtkPlaneSource>::New();
+  plane->SetResolution(20, 20);
+  plane->SetNormal(0.0, 1.0, 1.0);
+  plane->Update();
+  // A linear field, as the quads sharing an edge may both be found for the
+  // points on it.
+  vtkSmartPointer<vtkDoubleArray> planeLinear =
+    vtkSmartPointer<vtkDoubleArray>::New();
+  planeLinear->SetName("PlaneLinear");
+  for (vtkIdType i = 0; i < plane->GetOutput()->GetNumberOfPoints(); i++)
+    {
+    double x[3];
+    plane->GetOutput()->GetPoint(i, x);
+    planeLinear->InsertNextValue(x[0] + 2.0*x[1] + 3.0*x[2]);
+    }
+  plane->GetOutput()->GetPointData()->AddArray(planeLinear);
+  vtkSmartPointer<vtkPolyData> surfaceProbe = MakeSurfaceProbe(0.0);
+  reference->SetInput(surfaceProbe);
+  reference->SetSource(plane->GetOutput());
+  reference->Update();
+  probes[1]->SetInput(surfaceProbe);
+  probes[1]->SetSource(plane->GetOutput());
+  probes[1]->Update();
+  if (!SameProbes(reference, probes[1], "PlaneLinear"))
+    {
+    cerr << "Probing a surface with a locator differs." << endl;
+    return 1;
+    }
+
+  // With a copy of the plane moved along its normal, but still within the
+  // bounds of its quads, the locator finds quads of the first plane for
+  // points close to the second one. No point is close to the first plane.
+  double offset = 0.015;
+  double s = offset*sqrt(0.5);
+  vtkSmartPointer<vtkPlaneSource> plane2 =
+    vtkSmartPointer<vtkPlaneSource>::New();
+  plane2->SetResolution(20, 20);
+  plane2->SetNormal(0.0, 1.0, 1.0);
+  plane2->SetCenter(0.0, s, s);
+  plane2->Update();
+  vtkSmartPointer<vtkDoubleArray> plane2Linear =
+    vtkSmartPointer<vtkDoubleArray>::New();
+  plane2Linear->SetName("PlaneLinear");
+  for (vtkIdType i = 0; i < plane2->GetOutput()->GetNumberOfPoints(); i++)
+    {
+    double x[3];
+    plane2->GetOutput()->GetPoint(i, x);
+    plane2Linear->InsertNextValue(x[0] + 2.0*x[1] + 3.0*x[2]);
+    }
+  plane2->GetOutput()->GetPointData()->AddArray(plane2Linear);
+  vtkSmartPointer<vtkAppendPolyData> planes =
+    vtkSmartPointer<vtkAppendPolyData>::New();
+  planes->AddInput(plane->GetOutput());
+  planes->AddInput(plane2->GetOutput());
+  planes->Update();
+  surfaceProbe = MakeSurfaceProbe(offset);
+  reference->SetInput(surfaceProbe);
+  reference->SetSource(planes->GetOutput());
+  reference->Update();
+  probes[1]->SetInput(surfaceProbe);
+  probes[1]->SetSource(planes->GetOutput());
+  probes[1]->Update();
+  if (!SameProbes(reference, probes[1], "PlaneLinear"))
+    {
+    cerr << "Probing overlapping surfaces with a locator differs." << endl;
+    return 1;
+    }
+
+  return 0;
+}
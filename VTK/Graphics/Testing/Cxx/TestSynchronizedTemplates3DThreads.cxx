@@ -0,0 +1,116 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    $RCSfile$
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Contour a volume with several threads and check that the points shared
+// by the slabs are merged, including contour values that hit grid points
+// on the seams.
+
+#include "vtkCellData.h"
+#include "vtkFloatArray.h"
+#include "vtkImageData.h"
+#include "vtkPointData.h"
+#include "vtkPolyData.h"
+#include "vtkShortArray.h"
+#include "vtkSmartPointer.h"
+#include "vtkSynchronizedTemplates3D.h"
+
+static vtkSmartPointer<vtkPolyData> Contour(vtkImageData *image,
+                                            int numberOfThreads)
+{
+  vtkSmartPointer<vtkSynchronizedTemplates3D> contour =
+    vtkSmartPointer<vtkSynchronizedTemplates3D>::New();
+  contour->SetInput(image);
+  contour->SetNumberOfThreads(numberOfThreads);
+  contour->SetValue(0, 50.0);
+  contour->SetValue(1, 100.0);
+  contour->SetValue(2, 137.5);
+  contour->ComputeGradientsOn();
+  contour->Update();
+  return contour->GetOutput();
+}
+
+int TestSynchronizedTemplates3DThreads(int, char *[])
+{
+  // Squared distance to the center of the volume: many contour values hit
+  // grid points exactly.
+  const int dim = 25;
+  vtkSmartPointer<vtkImageData> image = vtkSmartPointer<vtkImageData>::New();
+  image->SetDimensions(dim, dim, dim);
+  vtkSmartPointer<vtkShortArray> distance =
+    vtkSmartPointer<vtkShortArray>::New();
+  distance->SetName("Distance");
+  vtkSmartPointer<vtkFloatArray> height =
+    vtkSmartPointer<vtkFloatArray>::New();
+  height->SetName("Height");
+  for (int k = 0; k < dim; ++k)
+    {
+    for (int j = 0; j < dim; ++j)
+      {
+      for (int i = 0; i < dim; ++i)
+        {
+        int x = i - dim/2, y = j - dim/2, z = k - dim/2;
+        distance->InsertNextValue(static_cast<short>(x*x + y*y + z*z));
+        height->InsertNextValue(static_cast<float>(k));
+        }
+      }
+    }
+  image->GetPointData()->SetScalars(distance);
+  image->GetPointData()->AddArray(height);
+
+  vtkSmartPointer<vtkPolyData> serial = Contour(image, 1);
+  if (serial->GetNumberOfPolys() == 0)
+    {
+    cerr << "Empty contour." << endl;
+    return 1;
+    }
+
+  for (int threads = 2; threads <= 7; ++threads)
+    {
+    vtkSmartPointer<vtkPolyData> threaded = Contour(image, threads);
+    if (threaded->GetNumberOfPoints() != serial->GetNumberOfPoints() ||
+        threaded->GetNumberOfPolys() != serial->GetNumberOfPolys())
+      {
+      cerr << threads << " threads generated "
+           << threaded->GetNumberOfPoints() << " points and "
+           << threaded->GetNumberOfPolys() << " triangles instead of "
+           << serial->GetNumberOfPoints() << " and "
+           << serial->GetNumberOfPolys() << "." << endl;
+      return 1;
+      }
+
+    double serialBounds[6], threadedBounds[6];
+    serial->GetBounds(serialBounds);
+    threaded->GetBounds(threadedBounds);
+    for (int i = 0; i < 6; ++i)
+      {
+      if (serialBounds[i] != threadedBounds[i])
+        {
+        cerr << "Bounds differ with " << threads << " threads." << endl;
+        return 1;
+        }
+      }
+
+    vtkPointData *pd = threaded->GetPointData();
+    if (!pd->GetScalars() || !pd->GetNormals() || !pd->GetVectors() ||
+        !pd->GetArray("Height") ||
+        pd->GetScalars()->GetNumberOfTuples() != threaded->GetNumberOfPoints())
+      {
+      cerr << "Point data was not merged with " << threads << " threads."
+           << endl;
+      return 1;
+      }
+    }
+
+  return 0;
+}
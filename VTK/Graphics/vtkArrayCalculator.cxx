@@ -22,12 +22,15 @@
 #include "vtkGraph.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
+#include "vtkMultiThreader.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
 #include "vtkPointSet.h"
 #include "vtkPolyData.h"
 #include "vtkUnstructuredGrid.h"
 
+#include <vtkstd/vector>
+
 vtkCxxRevisionMacro(vtkArrayCalculator, "$Revision$");
 vtkStandardNewMacro(vtkArrayCalculator);
 
@@ -59,6 +62,9 @@ vtkArrayCalculator::vtkArrayCalculator()
   this->ReplacementValue = 0.0;
 
   this->ResultArrayType=VTK_DOUBLE;
+
+  this->Threader = vtkMultiThreader::New();
+  this->NumberOfThreads = this->Threader->GetNumberOfThreads();
 }
 
 vtkArrayCalculator::~vtkArrayCalculator()
@@ -67,6 +73,7 @@ vtkArrayCalculator::~vtkArrayCalculator()
   
   this->FunctionParser->Delete();
   this->FunctionParser = NULL;
+  this->Threader->Delete();
   
   if (this->Function)
     {
@@ -202,6 +209,191 @@ void vtkArrayCalculator::SetResultArrayName(const char* name)
   strcpy(this->ResultArrayName, name);
 }
 
+// Number of tuples each thread evaluates at a time.
+#define VTK_ARRAY_CALCULATOR_BLOCK_SIZE 1024
+
+// Where the values of a variable component come from: a component of an
+// array, a coordinate of the points (Array is NULL) or a constant
+// (Array is NULL and Component is negative).
+struct vtkArrayCalculatorSource
+{
+  vtkDataArray *Array;
+  int Component;
+  double Value;
+};
+
+struct vtkArrayCalculatorThreadStruct
+{
+  vtkFunctionParser *Parser;
+  vtkDataSet *DataSet;
+  vtkGraph *Graph;
+  vtkIdType NumberOfTuples;
+  vtkIdType TuplesPerThread;
+  // One source per scalar variable and three per vector variable.
+  vtkstd::vector<vtkArrayCalculatorSource> Scalars;
+  vtkstd::vector<vtkArrayCalculatorSource> Vectors;
+  vtkDataArray *Result;
+  int Failed[VTK_MAX_THREADS];
+};
+
+// Returns 1 if the values of the array can be read and written directly.
+static int vtkArrayCalculatorHasValues(vtkDataArray *array)
+{
+  switch (array->GetDataType())
+    {
+    vtkTemplateMacro(return 1);
+    }
+  return 0;
+}
+
+template <class T>
+void vtkArrayCalculatorReadComponent(T *data, int numComps, int comp,
+                                     vtkIdType begin, vtkIdType n,
+                                     double *values, int stride)
+{
+  data += begin*numComps + comp;
+  for (vtkIdType t = 0; t < n; t++)
+    {
+    values[t*stride] = static_cast<double>(data[t*numComps]);
+    }
+}
+
+template <class T>
+void vtkArrayCalculatorWriteTuples(T *data, int numComps, vtkIdType begin,
+                                   vtkIdType n, const double *values)
+{
+  data += begin*numComps;
+  vtkIdType size = n*numComps;
+  for (vtkIdType i = 0; i < size; i++)
+    {
+    data[i] = static_cast<T>(values[i]);
+    }
+}
+
+// Read n values of a variable component starting at tuple begin.
+static void vtkArrayCalculatorReadSource(vtkArrayCalculatorThreadStruct *str,
+                                         const vtkArrayCalculatorSource& src,
+                                         vtkIdType begin, vtkIdType n,
+                                         double *values, int stride)
+{
+  vtkIdType t;
+  if (src.Array)
+    {
+    vtkDataArray *array = src.Array;
+    switch (array->GetDataType())
+      {
+      vtkTemplateMacro(
+        vtkArrayCalculatorReadComponent(
+          static_cast<VTK_TT *>(array->GetVoidPointer(0)),
+          array->GetNumberOfComponents(), src.Component, begin, n, values,
+          stride));
+      default:
+        for (t = 0; t < n; t++)
+          {
+          values[t*stride] = array->GetComponent(begin + t, src.Component);
+          }
+      }
+    }
+  else if (src.Component >= 0)
+    {
+    double x[3];
+    for (t = 0; t < n; t++)
+      {
+      if (str->DataSet)
+        {
+        str->DataSet->GetPoint(begin + t, x);
+        }
+      else
+        {
+        str->Graph->GetPoint(begin + t, x);
+        }
+      values[t*stride] = x[src.Component];
+      }
+    }
+  else
+    {
+    for (t = 0; t < n; t++)
+      {
+      values[t*stride] = src.Value;
+      }
+    }
+}
+
+// Evaluate the function for the tuples of one thread, a block at a time.
+static VTK_THREAD_RETURN_TYPE vtkArrayCalculatorThreadedExecute(void *arg)
+{
+  vtkMultiThreader::ThreadInfo *info =
+    static_cast<vtkMultiThreader::ThreadInfo *>(arg);
+  vtkArrayCalculatorThreadStruct *str =
+    static_cast<vtkArrayCalculatorThreadStruct *>(info->UserData);
+  int thread = info->ThreadID;
+  vtkIdType begin = thread * str->TuplesPerThread;
+  vtkIdType end = begin + str->TuplesPerThread;
+  if (end > str->NumberOfTuples)
+    {
+    end = str->NumberOfTuples;
+    }
+
+  const vtkIdType blockSize = VTK_ARRAY_CALCULATOR_BLOCK_SIZE;
+  int numScalars = static_cast<int>(str->Scalars.size());
+  int numVectors = static_cast<int>(str->Vectors.size()) / 3;
+  vtkDataArray *result = str->Result;
+  int numComps = result->GetNumberOfComponents();
+  vtkstd::vector<double> buffer((numScalars + 3*numVectors + 3)*blockSize);
+  vtkstd::vector<const double *> scalars(numScalars + 1);
+  vtkstd::vector<const double *> vectors(numVectors + 1);
+  int i, j;
+  for (i = 0; i < numScalars; i++)
+    {
+    scalars[i] = &buffer[i*blockSize];
+    }
+  for (i = 0; i < numVectors; i++)
+    {
+    vectors[i] = &buffer[(numScalars + 3*i)*blockSize];
+    }
+  double *values = &buffer[(numScalars + 3*numVectors)*blockSize];
+
+  for (vtkIdType blockBegin = begin; blockBegin < end; blockBegin += blockSize)
+    {
+    vtkIdType n = (end - blockBegin < blockSize) ? (end - blockBegin) :
+      blockSize;
+    for (i = 0; i < numScalars; i++)
+      {
+      vtkArrayCalculatorReadSource(str, str->Scalars[i], blockBegin, n,
+                                   &buffer[i*blockSize], 1);
+      }
+    for (i = 0; i < numVectors; i++)
+      {
+      for (j = 0; j < 3; j++)
+        {
+        vtkArrayCalculatorReadSource(
+          str, str->Vectors[3*i+j], blockBegin, n,
+          &buffer[(numScalars + 3*i)*blockSize + j], 3);
+        }
+      }
+
+    if (!str->Parser->EvaluateBlock(n, &scalars[0], &vectors[0], values))
+      {
+      str->Failed[thread] = 1;
+      }
+
+    switch (result->GetDataType())
+      {
+      vtkTemplateMacro(
+        vtkArrayCalculatorWriteTuples(
+          static_cast<VTK_TT *>(result->GetVoidPointer(0)), numComps,
+          blockBegin, n, values));
+      default:
+        for (vtkIdType t = 0; t < n; t++)
+          {
+          result->SetTuple(blockBegin + t, values + t*numComps);
+          }
+      }
+    }
+
+  return VTK_THREAD_RETURN_VALUE;
+}
+
 int vtkArrayCalculator::RequestData(
   vtkInformation *vtkNotUsed(request),
   vtkInformationVector **inputVector,
@@ -224,7 +416,6 @@ int vtkArrayCalculator::RequestData(
   vtkDataSetAttributes* outFD = 0;
   vtkDataArray* currentArray;
   vtkIdType numTuples = 0;
-  double scalarResult[1];
   vtkDataArray* resultArray = 0;
   vtkPoints* resultPoints = 0;
 
@@ -433,74 +624,104 @@ int vtkArrayCalculator::RequestData(
     {
     resultArray->SetNumberOfComponents(1);
     resultArray->SetNumberOfTuples(numTuples);
-    scalarResult[0] = this->FunctionParser->GetScalarResult();
-    resultArray->SetTuple(0, scalarResult);
     }
   else
     {
     resultArray->Allocate(numTuples * 3);
     resultArray->SetNumberOfComponents(3);
     resultArray->SetNumberOfTuples(numTuples);
-    resultArray->SetTuple(0, this->FunctionParser->GetVectorResult());
     }
-  
-  for (i = 1; i < numTuples; i++)
-    {
-    for (j = 0; j < this->NumberOfScalarArrays; j++)
+
+  // Describe where the values of every variable of the parser come from.
+  // Variables without an array or coordinate keep their current value.
+  vtkArrayCalculatorThreadStruct str;
+  str.Parser = this->FunctionParser;
+  str.DataSet = dsInput;
+  str.Graph = graphInput;
+  str.NumberOfTuples = numTuples;
+  str.Result = resultArray;
+  int threadSafe = vtkArrayCalculatorHasValues(resultArray);
+  vtkArrayCalculatorSource source;
+  int numScalars = this->FunctionParser->GetNumberOfScalarVariables();
+  for (j = 0; j < numScalars; j++)
+    {
+    source.Array = 0;
+    source.Component = -1;
+    source.Value = this->FunctionParser->GetScalarVariableValue(j);
+    if (j < this->NumberOfScalarArrays)
       {
-      currentArray = inFD->GetArray(this->ScalarArrayNames[j]);
-      this->FunctionParser->
-        SetScalarVariableValue(
-          j, currentArray->GetComponent(i, this->SelectedScalarComponents[j]));
+      source.Array = inFD->GetArray(this->ScalarArrayNames[j]);
+      source.Component = this->SelectedScalarComponents[j];
+      threadSafe = threadSafe && vtkArrayCalculatorHasValues(source.Array);
       }
-    for (j = 0; j < this->NumberOfVectorArrays; j++)
+    else if (attributeDataType == 0 &&
+             j < this->NumberOfScalarArrays +
+             this->NumberOfCoordinateScalarArrays)
       {
-      currentArray = inFD->GetArray(this->VectorArrayNames[j]);
-      this->FunctionParser->
-        SetVectorVariableValue(
-          j, currentArray->GetComponent(i, this->SelectedVectorComponents[j][0]),
-          currentArray->GetComponent(
-            i, this->SelectedVectorComponents[j][1]),
-          currentArray->GetComponent(i, this->SelectedVectorComponents[j][2]));
+      source.Component = this->SelectedCoordinateScalarComponents[
+        j - this->NumberOfScalarArrays];
       }
-    if(attributeDataType == 0)
+    str.Scalars.push_back(source);
+    }
+  int numVectors = this->FunctionParser->GetNumberOfVectorVariables();
+  for (j = 0; j < numVectors; j++)
+    {
+    double *value = this->FunctionParser->GetVectorVariableValue(j);
+    for (int k = 0; k < 3; k++)
       {
-      double* pt = 0;
-      if (dsInput)
-        {
-        pt = dsInput->GetPoint(i);
-        }
-      else
-        {
-        pt = graphInput->GetPoint(i);
-        }
-      for (j = 0; j < this->NumberOfCoordinateScalarArrays; j++)
+      source.Array = 0;
+      source.Component = -1;
+      source.Value = value[k];
+      if (j < this->NumberOfVectorArrays)
         {
-        this->FunctionParser->
-          SetScalarVariableValue(
-            j+this->NumberOfScalarArrays, pt[this->SelectedCoordinateScalarComponents[j]]);
+        source.Array = inFD->GetArray(this->VectorArrayNames[j]);
+        source.Component = this->SelectedVectorComponents[j][k];
+        threadSafe = threadSafe && vtkArrayCalculatorHasValues(source.Array);
         }
-      for (j = 0; j < this->NumberOfCoordinateVectorArrays; j++)
+      else if (attributeDataType == 0 &&
+               j < this->NumberOfVectorArrays +
+               this->NumberOfCoordinateVectorArrays)
         {
-        this->FunctionParser->
-          SetVectorVariableValue(
-            j+this->NumberOfVectorArrays,
-            pt[this->SelectedCoordinateVectorComponents[j][0]],
-            pt[this->SelectedCoordinateVectorComponents[j][1]],
-            pt[this->SelectedCoordinateVectorComponents[j][2]]);
+        source.Component = this->SelectedCoordinateVectorComponents[
+          j - this->NumberOfVectorArrays][k];
         }
+      str.Vectors.push_back(source);
       }
-    if (resultType == 0)
-      {
-      scalarResult[0] = this->FunctionParser->GetScalarResult();
-      resultArray->SetTuple(i, scalarResult);
-      }
-    else
+    }
+
+  // Give every thread a contiguous range of at least one block of tuples.
+  vtkIdType numBlocks = (numTuples + VTK_ARRAY_CALCULATOR_BLOCK_SIZE - 1) /
+    VTK_ARRAY_CALCULATOR_BLOCK_SIZE;
+  int numThreads = this->NumberOfThreads;
+  if (!threadSafe)
+    {
+    numThreads = 1;
+    }
+  else if (numBlocks < numThreads)
+    {
+    numThreads = static_cast<int>(numBlocks);
+    }
+  str.TuplesPerThread = (numBlocks + numThreads - 1) / numThreads *
+    VTK_ARRAY_CALCULATOR_BLOCK_SIZE;
+  for (j = 0; j < numThreads; j++)
+    {
+    str.Failed[j] = 0;
+    }
+  this->Threader->SetNumberOfThreads(numThreads);
+  this->Threader->SetSingleMethod(vtkArrayCalculatorThreadedExecute, &str);
+  this->Threader->SingleMethodExecute();
+
+  for (j = 0; j < numThreads; j++)
+    {
+    if (str.Failed[j])
       {
-      resultArray->SetTuple(i, this->FunctionParser->GetVectorResult());
+      vtkErrorMacro("The function could not be evaluated for some of the "
+                    "tuples; they were set to " << VTK_PARSER_ERROR_RESULT
+                    << ".");
+      break;
       }
     }
-  
+
   if(resultPoints)
     {
     if(psInput)
@@ -1220,4 +1441,5 @@ void vtkArrayCalculator::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "Replace Invalid Values: " 
      << (this->ReplaceInvalidValues ? "On" : "Off") << endl;
   os << indent << "Replacement Value: " << this->ReplacementValue << endl;
+  os << indent << "Number Of Threads: " << this->NumberOfThreads << endl;
 }
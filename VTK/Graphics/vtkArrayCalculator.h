@@ -52,6 +52,10 @@
 // tuple-wise (i.e., tuple-by-tuple). The user must specify which arrays to use as
 // vectors and/or scalars, and the name of the output data array.
 //
+// The function is parsed once and then evaluated over blocks of tuples by
+// NumberOfThreads threads, each thread handling a contiguous range of
+// tuples.
+//
 // .SECTION See Also
 // vtkFunctionParser
 
@@ -61,6 +65,7 @@
 #include "vtkDataSetAlgorithm.h"
 
 class vtkFunctionParser;
+class vtkMultiThreader;
 
 #define VTK_ATTRIBUTE_MODE_DEFAULT 0
 #define VTK_ATTRIBUTE_MODE_USE_POINT_DATA 1
@@ -200,6 +205,13 @@ public:
   vtkSetMacro(ReplacementValue,double);
   vtkGetMacro(ReplacementValue,double);
 
+  // Description:
+  // Get/Set the number of threads to evaluate the function with.  Defaults
+  // to the number of threads of vtkMultiThreader.  A single thread is used
+  // when one of the arrays is not stored as a contiguous array of values.
+  vtkSetClampMacro(NumberOfThreads,int,1,VTK_MAX_THREADS);
+  vtkGetMacro(NumberOfThreads,int);
+
 protected:
   vtkArrayCalculator();
   ~vtkArrayCalculator();
@@ -232,6 +244,9 @@ protected:
 
   int ResultArrayType;
 
+  vtkMultiThreader *Threader;
+  int NumberOfThreads;
+
 private:
   vtkArrayCalculator(const vtkArrayCalculator&);  // Not implemented.
   void operator=(const vtkArrayCalculator&);  // Not implemented.
@@ -24,6 +24,7 @@
 #include "vtkPolyData.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkIncrementalPointLocator.h"
+#include "vtkThreadedMergePoints.h"
 
 vtkCxxRevisionMacro(vtkCleanPolyData, "$Revision$");
 vtkStandardNewMacro(vtkCleanPolyData);
@@ -177,7 +178,9 @@ int vtkCleanPolyData::RequestData(
   vtkIdType *pts = 0;
   double x[3];
   double newx[3];
-  vtkIdType *pointMap=0; //used if no merging
+  vtkIdType *pointMap=0; //used if no merging or merging all points at once
+  vtkIdType *mergeMap=0; //used if merging all points at once
+  vtkPoints *mergePts=0;
 
   vtkCellArray *inVerts  = input->GetVerts(),  *newVerts  = NULL;
   vtkCellArray *inLines  = input->GetLines(),  *newLines  = NULL;
@@ -200,12 +203,33 @@ int vtkCleanPolyData::RequestData(
       {
       this->Locator->SetTolerance(this->Tolerance*input->GetLength());
       }
-    double originalbounds[6], mappedbounds[6];
-    input->GetBounds(originalbounds);
-    this->OperateOnBounds(originalbounds,mappedbounds);
-    this->Locator->InitPointInsertion(newPts, mappedbounds);
+    vtkThreadedMergePoints *threadedLocator =
+      vtkThreadedMergePoints::SafeDownCast(this->Locator);
+    if ( threadedLocator )
+      {
+      // Merge all the operated points at once; they are then numbered in
+      // the order the cells use them, as they would be when inserted.
+      mergePts = newPts->NewInstance();
+      mergePts->SetDataType(newPts->GetDataType());
+      mergePts->SetNumberOfPoints(numPts);
+      for (i=0; i < numPts; i++)
+        {
+        inPts->GetPoint(i,x);
+        this->OperateOnPoint(x, newx);
+        mergePts->SetPoint(i,newx);
+        }
+      mergeMap = new vtkIdType [numPts];
+      threadedLocator->MergePoints(mergePts, mergeMap);
+      }
+    else
+      {
+      double originalbounds[6], mappedbounds[6];
+      input->GetBounds(originalbounds);
+      this->OperateOnBounds(originalbounds,mappedbounds);
+      this->Locator->InitPointInsertion(newPts, mappedbounds);
+      }
     }
-  else
+  if ( !this->PointMerging || mergeMap )
     {
     pointMap = new vtkIdType [numPts];
     for (i=0; i < numPts; i++)
@@ -246,20 +270,33 @@ int vtkCleanPolyData::RequestData(
       {
       for ( numNewPts=0, i=0; i < npts; i++ ) 
         {
-        inPts->GetPoint(pts[i],x);
-        this->OperateOnPoint(x, newx);
-        if ( ! this->PointMerging )
+        if ( mergeMap )
           {
-          if ( (ptId=pointMap[pts[i]]) == -1 )
+          if ( (ptId=pointMap[mergeMap[pts[i]]]) == -1 )
             {
-            pointMap[pts[i]] = ptId = numUsedPts++;
+            pointMap[mergeMap[pts[i]]] = ptId = numUsedPts++;
+            mergePts->GetPoint(pts[i],newx);
             newPts->SetPoint(ptId,newx);
             outputPD->CopyData(inputPD,pts[i],ptId);
             }
           }
-        else if ( this->Locator->InsertUniquePoint(newx, ptId) ) 
+        else
           {
-          outputPD->CopyData(inputPD,pts[i],ptId);
+          inPts->GetPoint(pts[i],x);
+          this->OperateOnPoint(x, newx);
+          if ( ! this->PointMerging )
+            {
+            if ( (ptId=pointMap[pts[i]]) == -1 )
+              {
+              pointMap[pts[i]] = ptId = numUsedPts++;
+              newPts->SetPoint(ptId,newx);
+              outputPD->CopyData(inputPD,pts[i],ptId);
+              }
+            }
+          else if ( this->Locator->InsertUniquePoint(newx, ptId) ) 
+            {
+            outputPD->CopyData(inputPD,pts[i],ptId);
+            }
           }
         updatedPts[numNewPts++] = ptId;
         }//for all points of vertex cell
@@ -291,20 +328,33 @@ int vtkCleanPolyData::RequestData(
       {
       for ( numNewPts=0, i=0; i<npts; i++ ) 
         {
-        inPts->GetPoint(pts[i],x);
-        this->OperateOnPoint(x, newx);
-        if ( ! this->PointMerging )
+        if ( mergeMap )
           {
-          if ( (ptId=pointMap[pts[i]]) == -1 )
+          if ( (ptId=pointMap[mergeMap[pts[i]]]) == -1 )
             {
-            pointMap[pts[i]] = ptId = numUsedPts++;
+            pointMap[mergeMap[pts[i]]] = ptId = numUsedPts++;
+            mergePts->GetPoint(pts[i],newx);
             newPts->SetPoint(ptId,newx);
             outputPD->CopyData(inputPD,pts[i],ptId);
             }
           }
-        else if ( this->Locator->InsertUniquePoint(newx, ptId) ) 
+        else
           {
-          outputPD->CopyData(inputPD,pts[i],ptId);
+          inPts->GetPoint(pts[i],x);
+          this->OperateOnPoint(x, newx);
+          if ( ! this->PointMerging )
+            {
+            if ( (ptId=pointMap[pts[i]]) == -1 )
+              {
+              pointMap[pts[i]] = ptId = numUsedPts++;
+              newPts->SetPoint(ptId,newx);
+              outputPD->CopyData(inputPD,pts[i],ptId);
+              }
+            }
+          else if ( this->Locator->InsertUniquePoint(newx, ptId) ) 
+            {
+            outputPD->CopyData(inputPD,pts[i],ptId);
+            }
           }
         if ( i == 0 || ptId != updatedPts[numNewPts-1] ) 
           {
@@ -357,20 +407,33 @@ int vtkCleanPolyData::RequestData(
       {
       for ( numNewPts=0, i=0; i<npts; i++ ) 
         {
-        inPts->GetPoint(pts[i],x);
-        this->OperateOnPoint(x, newx);
-        if ( ! this->PointMerging )
+        if ( mergeMap )
           {
-          if ( (ptId=pointMap[pts[i]]) == -1 )
+          if ( (ptId=pointMap[mergeMap[pts[i]]]) == -1 )
             {
-            pointMap[pts[i]] = ptId = numUsedPts++;
+            pointMap[mergeMap[pts[i]]] = ptId = numUsedPts++;
+            mergePts->GetPoint(pts[i],newx);
             newPts->SetPoint(ptId,newx);
             outputPD->CopyData(inputPD,pts[i],ptId);
             }
           }
-        else if ( this->Locator->InsertUniquePoint(newx, ptId) ) 
+        else
           {
-          outputPD->CopyData(inputPD,pts[i],ptId);
+          inPts->GetPoint(pts[i],x);
+          this->OperateOnPoint(x, newx);
+          if ( ! this->PointMerging )
+            {
+            if ( (ptId=pointMap[pts[i]]) == -1 )
+              {
+              pointMap[pts[i]] = ptId = numUsedPts++;
+              newPts->SetPoint(ptId,newx);
+              outputPD->CopyData(inputPD,pts[i],ptId);
+              }
+            }
+          else if ( this->Locator->InsertUniquePoint(newx, ptId) ) 
+            {
+            outputPD->CopyData(inputPD,pts[i],ptId);
+            }
           }
         if ( i == 0 || ptId != updatedPts[numNewPts-1] ) 
           {
@@ -443,20 +506,33 @@ int vtkCleanPolyData::RequestData(
       {
       for ( numNewPts=0, i=0; i < npts; i++ ) 
         {
-        inPts->GetPoint(pts[i],x);
-        this->OperateOnPoint(x, newx);
-        if ( ! this->PointMerging )
+        if ( mergeMap )
           {
-          if ( (ptId=pointMap[pts[i]]) == -1 )
+          if ( (ptId=pointMap[mergeMap[pts[i]]]) == -1 )
             {
-            pointMap[pts[i]] = ptId = numUsedPts++;
+            pointMap[mergeMap[pts[i]]] = ptId = numUsedPts++;
+            mergePts->GetPoint(pts[i],newx);
             newPts->SetPoint(ptId,newx);
             outputPD->CopyData(inputPD,pts[i],ptId);
             }
           }
-        else if ( this->Locator->InsertUniquePoint(newx, ptId) ) 
+        else
           {
-          outputPD->CopyData(inputPD,pts[i],ptId);
+          inPts->GetPoint(pts[i],x);
+          this->OperateOnPoint(x, newx);
+          if ( ! this->PointMerging )
+            {
+            if ( (ptId=pointMap[pts[i]]) == -1 )
+              {
+              pointMap[pts[i]] = ptId = numUsedPts++;
+              newPts->SetPoint(ptId,newx);
+              outputPD->CopyData(inputPD,pts[i],ptId);
+              }
+            }
+          else if ( this->Locator->InsertUniquePoint(newx, ptId) ) 
+            {
+            outputPD->CopyData(inputPD,pts[i],ptId);
+            }
           }
         if ( i == 0 || ptId != updatedPts[numNewPts-1] ) 
           {
@@ -534,7 +610,7 @@ int vtkCleanPolyData::RequestData(
   // Update ourselves and release memory
   //
   delete [] updatedPts;
-  if ( this->PointMerging )
+  if ( this->PointMerging && !mergeMap )
     {
     this->Locator->Initialize(); //release memory.
     }
@@ -542,6 +618,11 @@ int vtkCleanPolyData::RequestData(
     {
     newPts->SetNumberOfPoints(numUsedPts);
     delete [] pointMap;
+    delete [] mergeMap;
+    if ( mergePts )
+      {
+      mergePts->Delete();
+      }
     }
 
   // Now transfer all CellData from Lines/Polys/Strips into final
@@ -629,7 +710,7 @@ void vtkCleanPolyData::CreateDefaultLocator(vtkPolyData *input)
     {
     if (tol==0.0)
       {
-      this->Locator = vtkMergePoints::New();
+      this->Locator = vtkThreadedMergePoints::New();
       this->Locator->Register(this);
       this->Locator->Delete();
       }
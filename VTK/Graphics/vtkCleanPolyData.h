@@ -34,11 +34,13 @@
 //   && ConvertLinesToPoints)
 //
 // If tolerance is specified precisely=0.0, then vtkCleanPolyData will use
-// the vtkMergePoints object to merge points (which is faster). Otherwise the
+// the vtkThreadedMergePoints object to merge points (which is faster). Otherwise the
 // slower vtkIncrementalPointLocator is used.  Before inserting points into the point
 // locator, this class calls a function OperateOnPoint which can be used (in
 // subclasses) to further refine the cleaning process. See
-// vtkQuantizePolyDataPoints.
+// vtkQuantizePolyDataPoints.  A vtkThreadedMergePoints locator merges all the
+// operated points at once with several threads instead of inserting them
+// one at a time.
 //
 // Note that merging of points can be disabled. In this case, a point locator
 // will not be used, and points that are not used by any cells will be
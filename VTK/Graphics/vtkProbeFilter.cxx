@@ -14,27 +14,143 @@
 =========================================================================*/
 #include "vtkProbeFilter.h"
 
+#include "vtkAbstractCellLocator.h"
 #include "vtkCellData.h"
 #include "vtkCell.h"
 #include "vtkCharArray.h"
+#include "vtkGenericCell.h"
+#include "vtkIdList.h"
 #include "vtkIdTypeArray.h"
 #include "vtkImageData.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
+#include "vtkMultiThreader.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
+#include "vtkSmartPointer.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 
 #include <vtkstd/vector>
 
 vtkCxxRevisionMacro(vtkProbeFilter, "$Revision$");
 vtkStandardNewMacro(vtkProbeFilter);
+vtkCxxSetObjectMacro(vtkProbeFilter, CellLocatorPrototype,
+                     vtkAbstractCellLocator);
+
+// Number of points probed by each thread at a time with a cell locator.
+#define VTK_PROBE_FILTER_BATCH_SIZE 4096
 
 class vtkProbeFilter::vtkVectorOfArrays : 
   public vtkstd::vector<vtkDataArray*>
 {
 };
 
+class vtkProbeFilter::vtkVectorOfLocators :
+  public vtkstd::vector<vtkSmartPointer<vtkAbstractCellLocator> >
+{
+};
+
+//----------------------------------------------------------------------------
+// The cells found for a batch of points by the threads.
+struct vtkProbeFilterThreadStruct
+{
+  vtkAbstractCellLocator *Locator;
+  vtkGenericCell **Cells;
+  int MaxCellSize;
+  // Largest squared distance of a point to the cell found, as in
+  // vtkDataSet::FindCell().
+  double Tolerance2;
+  vtkIdType NumberOfPoints;
+  const double *Points;
+  const char *Mask;
+  // -1 for the points outside the source or already probed, -2 for those
+  // too far from the cell found by the locator.
+  vtkIdType *CellIds;
+  int *NumberOfCellPoints;
+  // MaxCellSize point ids and weights per point.
+  vtkIdType *CellPointIds;
+  double *Weights;
+};
+
+//----------------------------------------------------------------------------
+// Find the cells containing one range of the points of the batch.
+static VTK_THREAD_RETURN_TYPE vtkProbeFilterFindCells(void *arg)
+{
+  vtkMultiThreader::ThreadInfo *info =
+    static_cast<vtkMultiThreader::ThreadInfo *>(arg);
+  vtkProbeFilterThreadStruct *str =
+    static_cast<vtkProbeFilterThreadStruct *>(info->UserData);
+  vtkIdType begin = str->NumberOfPoints * info->ThreadID /
+    info->NumberOfThreads;
+  vtkIdType end = str->NumberOfPoints * (info->ThreadID + 1) /
+    info->NumberOfThreads;
+  vtkGenericCell *cell = str->Cells[info->ThreadID];
+  double x[3], pcoords[3], closest[3], dist2;
+  int subId;
+  for (vtkIdType i = begin; i < end; i++)
+    {
+    str->CellIds[i] = -1;
+    if (str->Mask[i] == static_cast<char>(1))
+      {
+      continue;
+      }
+    x[0] = str->Points[3*i];
+    x[1] = str->Points[3*i+1];
+    x[2] = str->Points[3*i+2];
+    double *weights = str->Weights + i*str->MaxCellSize;
+    vtkIdType cellId = str->Locator->FindCell(x, str->Tolerance2, cell,
+                                              pcoords, weights);
+    // The locators accept the points anywhere above a 2D cell, keep only
+    // those close to it. Another cell may still contain the point.
+    if (cellId >= 0 &&
+        (cell->EvaluatePosition(x, closest, subId, pcoords, dist2,
+                                weights) != 1 || dist2 > str->Tolerance2))
+      {
+      str->CellIds[i] = -2;
+      continue;
+      }
+    if (cellId >= 0)
+      {
+      vtkIdType *ptIds = str->CellPointIds + i*str->MaxCellSize;
+      int numCellPts = cell->GetNumberOfPoints();
+      for (int j = 0; j < numCellPts; j++)
+        {
+        ptIds[j] = cell->GetPointId(j);
+        }
+      str->NumberOfCellPoints[i] = numCellPts;
+      str->CellIds[i] = cellId;
+      }
+    }
+  return VTK_THREAD_RETURN_VALUE;
+}
+
+//----------------------------------------------------------------------------
+// Squared tolerance for locating numPts points in the cells of source.
+static double vtkProbeFilterTolerance2(vtkDataSet *source, vtkIdType numPts)
+{
+  // Use tolerance as a function of size of source data
+  //
+  double tol2 = source->GetLength();
+  tol2 = tol2 ? tol2*tol2 / 1000.0 : 0.001;
+
+  // the actual sampling rate needs to be considered for a
+  // more appropriate / accurate selection of the tolerance.
+  // Otherwise the tolerance simply determined above might be
+  // so large as to cause incorrect cell location
+  double bounds[6];
+  source->GetBounds(bounds);
+  double minRes = 10000000000.0;
+  double axisRes[3];
+  for ( int  i = 0;  i < 3;  i ++ )
+    {
+    axisRes[i] = ( bounds[i * 2 + 1] - bounds[i * 2] ) / numPts;
+    if ( (axisRes[i] > 0.0) && (axisRes[i] < minRes) )
+      minRes = axisRes[i];
+    }
+  double minRes2 = minRes * minRes;
+  return tol2 > minRes2 ? minRes2 : tol2;
+}
+
 //----------------------------------------------------------------------------
 vtkProbeFilter::vtkProbeFilter()
 {
@@ -52,6 +168,11 @@ vtkProbeFilter::vtkProbeFilter()
   this->CellList = 0;
 
   this->UseNullPoint = true;
+
+  this->CellLocatorPrototype = 0;
+  this->CellLocators = new vtkVectorOfLocators();
+  this->Threader = vtkMultiThreader::New();
+  this->NumberOfThreads = 1;
 }
 
 //----------------------------------------------------------------------------
@@ -66,6 +187,10 @@ vtkProbeFilter::~vtkProbeFilter()
 
   delete this->PointList;
   delete this->CellList;
+
+  this->SetCellLocatorPrototype(0);
+  delete this->CellLocators;
+  this->Threader->Delete();
 }
 
 //----------------------------------------------------------------------------
@@ -228,6 +353,14 @@ void vtkProbeFilter::ProbeEmptyPoints(vtkDataSet *input,
 
   vtkDebugMacro(<<"Probing data");
 
+  // Image data and rectilinear grids find their cells directly.
+  if (this->CellLocatorPrototype && !source->IsA("vtkImageData") &&
+      !source->IsA("vtkRectilinearGrid"))
+    {
+    this->ProbeEmptyPointsWithLocator(input, srcIdx, source, output);
+    return;
+    }
+
   pd = source->GetPointData();
   cd = source->GetCellData();
 
@@ -247,27 +380,7 @@ void vtkProbeFilter::ProbeEmptyPoints(vtkDataSet *input,
 
   char* maskArray = this->MaskPoints->GetPointer(0);
 
-  // Use tolerance as a function of size of source data
-  //
-  tol2 = source->GetLength();
-  tol2 = tol2 ? tol2*tol2 / 1000.0 : 0.001;
-
-  // the actual sampling rate needs to be considered for a
-  // more appropriate / accurate selection of the tolerance.
-  // Otherwise the tolerance simply determined above might be
-  // so large as to cause incorrect cell location
-  double bounds[6];
-  source->GetBounds(bounds);
-  double minRes = 10000000000.0;
-  double axisRes[3];
-  for ( int  i = 0;  i < 3;  i ++ )
-    {
-    axisRes[i] = ( bounds[i * 2 + 1] - bounds[i * 2] ) / numPts;
-    if ( (axisRes[i] > 0.0) && (axisRes[i] < minRes) )
-      minRes = axisRes[i];
-    }
-  double minRes2 = minRes * minRes;
-  tol2 = tol2 > minRes2 ? minRes2 : tol2;
+  tol2 = vtkProbeFilterTolerance2(source, numPts);
 
   // Loop over all input points, interpolating source data
   //
@@ -335,6 +448,175 @@ void vtkProbeFilter::ProbeEmptyPoints(vtkDataSet *input,
     }
 }
 
+//----------------------------------------------------------------------------
+void vtkProbeFilter::ProbeEmptyPointsWithLocator(vtkDataSet *input,
+  int srcIdx, vtkDataSet *source, vtkDataSet *output)
+{
+  vtkPointData *pd = source->GetPointData();
+  vtkCellData *cd = source->GetCellData();
+  vtkPointData *outPD = output->GetPointData();
+  vtkIdType numPts = input->GetNumberOfPoints();
+  char* maskArray = this->MaskPoints->GetPointer(0);
+  int mcs = source->GetMaxCellSize();
+  if (numPts < 1 || mcs < 1)
+    {
+    if (this->UseNullPoint)
+      {
+      for (vtkIdType ptId = 0; ptId < numPts; ptId++)
+        {
+        if (maskArray[ptId] != static_cast<char>(1))
+          {
+          outPD->NullPoint(ptId);
+          }
+        }
+      }
+    return;
+    }
+
+  // Keep the locator of the source of the previous execution with the same
+  // index, it is only rebuilt if the source or the prototype changed.
+  if (static_cast<int>(this->CellLocators->size()) <= srcIdx)
+    {
+    this->CellLocators->resize(srcIdx + 1);
+    }
+  vtkSmartPointer<vtkAbstractCellLocator>& locator =
+    (*this->CellLocators)[srcIdx];
+  if (!locator ||
+      strcmp(locator->GetClassName(),
+             this->CellLocatorPrototype->GetClassName()))
+    {
+    locator.TakeReference(this->CellLocatorPrototype->NewInstance());
+    }
+  vtkAbstractCellLocator *prototype = this->CellLocatorPrototype;
+  locator->SetNumberOfCellsPerNode(prototype->GetNumberOfCellsPerNode());
+  locator->SetCacheCellBounds(prototype->GetCacheCellBounds());
+  locator->SetMaxLevel(prototype->GetMaxLevel());
+  locator->SetAutomatic(prototype->GetAutomatic());
+  locator->SetTolerance(prototype->GetTolerance());
+  // The threads must not build the locator.
+  locator->LazyEvaluationOff();
+  locator->SetDataSet(source);
+  locator->Update();
+
+  // Get a cell once before starting the threads, for the datasets building
+  // their cells on demand.
+  vtkGenericCell *cell = vtkGenericCell::New();
+  source->GetCell(0, cell);
+  cell->Delete();
+
+  int numThreads = this->NumberOfThreads;
+  vtkIdType batchSize =
+    static_cast<vtkIdType>(VTK_PROBE_FILTER_BATCH_SIZE) * numThreads;
+  if (batchSize > numPts)
+    {
+    batchSize = numPts;
+    }
+  vtkstd::vector<double> points(3*batchSize);
+  vtkstd::vector<vtkIdType> cellIds(batchSize);
+  vtkstd::vector<int> numCellPts(batchSize);
+  vtkstd::vector<vtkIdType> cellPtIds(batchSize*mcs);
+  vtkstd::vector<double> weights(batchSize*mcs);
+  vtkstd::vector<vtkGenericCell*> cells(numThreads);
+  for (int i = 0; i < numThreads; i++)
+    {
+    cells[i] = vtkGenericCell::New();
+    }
+  vtkIdList *ptIds = vtkIdList::New();
+  int subId;
+  double pcoords[3];
+
+  vtkProbeFilterThreadStruct str;
+  str.Locator = locator;
+  str.Cells = &cells[0];
+  str.MaxCellSize = mcs;
+  str.Tolerance2 = vtkProbeFilterTolerance2(source, numPts);
+  str.Points = &points[0];
+  str.CellIds = &cellIds[0];
+  str.NumberOfCellPoints = &numCellPts[0];
+  str.CellPointIds = &cellPtIds[0];
+  str.Weights = &weights[0];
+  this->Threader->SetNumberOfThreads(numThreads);
+  this->Threader->SetSingleMethod(vtkProbeFilterFindCells, &str);
+
+  int abort = 0;
+  for (vtkIdType begin = 0; begin < numPts && !abort; begin += batchSize)
+    {
+    this->UpdateProgress(static_cast<double>(begin)/numPts);
+    abort = this->GetAbortExecute();
+
+    // The coordinates are copied here, vtkDataSet::GetPoint() is not
+    // thread safe for all datasets.
+    vtkIdType n = numPts - begin < batchSize ? numPts - begin : batchSize;
+    for (vtkIdType i = 0; i < n; i++)
+      {
+      input->GetPoint(begin + i, &points[3*i]);
+      }
+    str.NumberOfPoints = n;
+    str.Mask = maskArray + begin;
+    this->Threader->SingleMethodExecute();
+
+    // Interpolate the source data at the points found, in order.
+    for (vtkIdType i = 0; i < n; i++)
+      {
+      vtkIdType ptId = begin + i;
+      if (maskArray[ptId] == static_cast<char>(1))
+        {
+        continue;
+        }
+      vtkIdType cellId = cellIds[i];
+      if (cellId == -2)
+        {
+        // Search the cells of folded or overlapping surfaces as
+        // ProbeEmptyPoints() does, vtkDataSet::FindCell() is not thread
+        // safe.
+        cellId = source->FindCell(&points[3*i], NULL, -1, str.Tolerance2,
+                                  subId, pcoords, &weights[i*mcs]);
+        if (cellId >= 0)
+          {
+          ptIds->DeepCopy(source->GetCell(cellId)->PointIds);
+          }
+        }
+      else if (cellId >= 0)
+        {
+        ptIds->SetNumberOfIds(numCellPts[i]);
+        for (int j = 0; j < numCellPts[i]; j++)
+          {
+          ptIds->SetId(j, cellPtIds[i*mcs + j]);
+          }
+        }
+      if (cellId < 0)
+        {
+        if (this->UseNullPoint)
+          {
+          outPD->NullPoint(ptId);
+          }
+        continue;
+        }
+      outPD->InterpolatePoint((*this->PointList), pd, srcIdx, ptId,
+        ptIds, &weights[i*mcs]);
+      this->ValidPoints->InsertNextValue(ptId);
+      this->NumberOfValidPoints++;
+      vtkVectorOfArrays::iterator iter;
+      for (iter = this->CellArrays->begin(); iter != this->CellArrays->end();
+        ++iter)
+        {
+        vtkDataArray* inArray = cd->GetArray((*iter)->GetName());
+        if (inArray)
+          {
+          outPD->CopyTuple(inArray, *iter, cellId, ptId);
+          }
+        }
+      maskArray[ptId] = static_cast<char>(1);
+      }
+    }
+
+  ptIds->Delete();
+  for (int i = 0; i < numThreads; i++)
+    {
+    cells[i]->Delete();
+    }
+}
+
 //----------------------------------------------------------------------------
 int vtkProbeFilter::RequestInformation(
   vtkInformation *vtkNotUsed(request),
@@ -511,4 +793,7 @@ void vtkProbeFilter::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "ValidPointMaskArrayName: " << (this->ValidPointMaskArrayName?
     this->ValidPointMaskArrayName : "vtkValidPointMask") << "\n";
   os << indent << "ValidPoints: " << this->ValidPoints << "\n";
+  os << indent << "CellLocatorPrototype: " << this->CellLocatorPrototype
+     << "\n";
+  os << indent << "NumberOfThreads: " << this->NumberOfThreads << "\n";
 }
@@ -31,6 +31,11 @@
 // rendering techniques can be used to visualize the results. Another example:
 // a line or curve can be used to probe data to produce x-y plots along
 // that line or curve.
+//
+// By default the cells of the source containing the points are found with
+// vtkDataSet::FindCell(). When a cell locator prototype is set, a locator
+// of the same type is built for the source instead, and kept until the
+// source is modified, and the points are probed by several threads.
 
 #ifndef __vtkProbeFilter_h
 #define __vtkProbeFilter_h
@@ -38,9 +43,11 @@
 #include "vtkDataSetAlgorithm.h"
 #include "vtkDataSetAttributes.h" // needed for vtkDataSetAttributes::FieldList
 
+class vtkAbstractCellLocator;
 class vtkIdTypeArray;
 class vtkCharArray;
 class vtkMaskPoints;
+class vtkMultiThreader;
 
 class VTK_GRAPHICS_EXPORT vtkProbeFilter : public vtkDataSetAlgorithm
 {
@@ -85,6 +92,27 @@ public:
   vtkSetStringMacro(ValidPointMaskArrayName)
   vtkGetStringMacro(ValidPointMaskArrayName)
 
+  // Description:
+  // Set/Get the prototype of the cell locator used to find the cells of
+  // the source containing the points, e.g. a vtkModifiedBSPTree. Its
+  // FindCell() is called by several threads at once, so it must be thread
+  // safe. A new instance of it is built for every source dataset other
+  // than vtkImageData and vtkRectilinearGrid, whose cells are found
+  // directly, and reused until that dataset is modified. The points
+  // farther from the cell found than the tolerance of
+  // vtkDataSet::FindCell() are looked up again with vtkDataSet::FindCell().
+  // NULL by default, in which case vtkDataSet::FindCell() is used.
+  virtual void SetCellLocatorPrototype(vtkAbstractCellLocator*);
+  vtkGetObjectMacro(CellLocatorPrototype, vtkAbstractCellLocator);
+
+  // Description:
+  // Get/Set the number of threads probing the points with the cell
+  // locators.  Defaults to 1.  No more threads run than
+  // vtkMultiThreader::GetGlobalMaximumNumberOfThreads() allows, which
+  // ParaView sets to 1.
+  vtkSetClampMacro(NumberOfThreads,int,1,VTK_MAX_THREADS);
+  vtkGetMacro(NumberOfThreads,int);
+
 //BTX 
 protected:
   vtkProbeFilter();
@@ -119,6 +147,12 @@ protected:
   void ProbeEmptyPoints(vtkDataSet *input, int srcIdx, vtkDataSet *source, 
     vtkDataSet *output);
 
+  // Description:
+  // Same as ProbeEmptyPoints() with the cell locator of the source, in
+  // batches of points probed by NumberOfThreads threads.
+  void ProbeEmptyPointsWithLocator(vtkDataSet *input, int srcIdx,
+    vtkDataSet *source, vtkDataSet *output);
+
   char* ValidPointMaskArrayName;
   vtkIdTypeArray *ValidPoints;
   vtkCharArray* MaskPoints;
@@ -132,12 +166,20 @@ protected:
 
   vtkDataSetAttributes::FieldList* CellList;
   vtkDataSetAttributes::FieldList* PointList;
+
+  vtkAbstractCellLocator* CellLocatorPrototype;
+  vtkMultiThreader* Threader;
+  int NumberOfThreads;
 private:
   vtkProbeFilter(const vtkProbeFilter&);  // Not implemented.
   void operator=(const vtkProbeFilter&);  // Not implemented.
 
   class vtkVectorOfArrays;
   vtkVectorOfArrays* CellArrays;
+
+  // The cell locators of the sources, by source index.
+  class vtkVectorOfLocators;
+  vtkVectorOfLocators* CellLocators;
 //ETX
 };
 
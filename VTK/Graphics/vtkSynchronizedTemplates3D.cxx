@@ -25,6 +25,7 @@
 #include "vtkIntArray.h"
 #include "vtkLongArray.h"
 #include "vtkMath.h"
+#include "vtkMultiThreader.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
 #include "vtkPolyData.h"
@@ -37,6 +38,7 @@
 #include "vtkUnsignedShortArray.h"
 
 #include <math.h>
+#include <vtkstd/vector>
 
 vtkCxxRevisionMacro(vtkSynchronizedTemplates3D, "$Revision$");
 vtkStandardNewMacro(vtkSynchronizedTemplates3D);
@@ -58,6 +60,9 @@ vtkSynchronizedTemplates3D::vtkSynchronizedTemplates3D()
 
   this->ArrayComponent = 0;
 
+  this->Threader = vtkMultiThreader::New();
+  this->NumberOfThreads = this->Threader->GetNumberOfThreads();
+
   // by default process active point scalars
   this->SetInputArrayToProcess(0,0,0,vtkDataObject::FIELD_ASSOCIATION_POINTS,
                                vtkDataSetAttributes::SCALARS);
@@ -67,6 +72,7 @@ vtkSynchronizedTemplates3D::vtkSynchronizedTemplates3D()
 vtkSynchronizedTemplates3D::~vtkSynchronizedTemplates3D()
 {
   this->ContourValues->Delete();
+  this->Threader->Delete();
 }
 
 //----------------------------------------------------------------------------
@@ -251,11 +257,17 @@ if (ComputeScalars) \
 //
 // Contouring filter specialized for images
 //
+//
+// When firstPlaneIds/lastPlaneIds are given, the ids of the points on the
+// edges of the first/last z plane of the extent are stored in them, one
+// plane of xdim*ydim*3 edges per contour value.
+//
 template <class T>
 void ContourImage(vtkSynchronizedTemplates3D *self, int *exExt,
                   vtkInformation *inInfo,
                   vtkImageData *data, vtkPolyData *output, T *ptr, 
-                  vtkDataArray *inScalars)
+                  vtkDataArray *inScalars, int *firstPlaneIds,
+                  int *lastPlaneIds, int reportProgress)
 {
   int *inExt = data->GetExtent();
   int xdim = exExt[1] - exExt[0] + 1;
@@ -375,8 +387,11 @@ void ContourImage(vtkSynchronizedTemplates3D *self, int *exExt,
     //==================================================================
     for (k = zMin; k <= zMax; k++)
       {
-      self->UpdateProgress((double)vidx/numContours + 
-                           (k-zMin)/((zMax - zMin+1.0)*numContours));
+      if (reportProgress)
+        {
+        self->UpdateProgress((double)vidx/numContours + 
+                             (k-zMin)/((zMax - zMin+1.0)*numContours));
+        }
       z = origin[2] + spacing[2]*k;
       x[2] = z;
 
@@ -602,6 +617,18 @@ void ContourImage(vtkSynchronizedTemplates3D *self, int *exExt,
           }
         inPtrY += yInc;
         }
+      // Keep the ids of the points on the faces of the extent so that the
+      // slabs contoured by different threads can be stitched together.
+      if (k == zMin && firstPlaneIds)
+        {
+        memcpy(firstPlaneIds + vidx*zstep*3, isect2Ptr - zstep*3,
+               zstep*3*sizeof(int));
+        }
+      if (k == zMax && lastPlaneIds)
+        {
+        memcpy(lastPlaneIds + vidx*zstep*3, isect2Ptr - zstep*3,
+               zstep*3*sizeof(int));
+        }
       inPtrZ += zInc;
       }
     }
@@ -659,6 +686,149 @@ unsigned long vtkSynchronizedTemplates3D::GetInputMemoryLimit()
 
 
 
+//----------------------------------------------------------------------------
+// Everything the threads need to contour their slab of the execute extent.
+struct vtkSynchronizedTemplates3DThreadStruct
+{
+  vtkSynchronizedTemplates3D *Filter;
+  vtkImageData *Input;
+  vtkInformation *InInfo;
+  vtkDataArray *InScalars;
+  // Extent, output and ids of the points on the first and last plane of
+  // each slab.
+  vtkstd::vector<int> Extents;
+  vtkstd::vector<vtkPolyData *> Outputs;
+  vtkstd::vector<vtkstd::vector<int> > FirstPlaneIds;
+  vtkstd::vector<vtkstd::vector<int> > LastPlaneIds;
+};
+
+//----------------------------------------------------------------------------
+static VTK_THREAD_RETURN_TYPE vtkSynchronizedTemplates3DThreadedExecute(
+  void *arg)
+{
+  vtkMultiThreader::ThreadInfo *info =
+    static_cast<vtkMultiThreader::ThreadInfo *>(arg);
+  vtkSynchronizedTemplates3DThreadStruct *str =
+    static_cast<vtkSynchronizedTemplates3DThreadStruct *>(info->UserData);
+  int slab = info->ThreadID;
+  int *exExt = &str->Extents[6*slab];
+  int *firstPlaneIds = 0;
+  int *lastPlaneIds = 0;
+  if (slab > 0)
+    {
+    firstPlaneIds = &str->FirstPlaneIds[slab][0];
+    }
+  if (slab < info->NumberOfThreads - 1)
+    {
+    lastPlaneIds = &str->LastPlaneIds[slab][0];
+    }
+
+  // Only the first slab reports progress; the slabs are about the same
+  // size.
+  void *ptr = str->Input->GetArrayPointerForExtent(str->InScalars, exExt);
+  switch (str->InScalars->GetDataType())
+    {
+    vtkTemplateMacro(
+      ContourImage(str->Filter, exExt, str->InInfo, str->Input,
+                   str->Outputs[slab], (VTK_TT *)ptr, str->InScalars,
+                   firstPlaneIds, lastPlaneIds, slab == 0));
+    }
+  return VTK_THREAD_RETURN_VALUE;
+}
+
+//----------------------------------------------------------------------------
+// Append the slabs to output.  The points a slab generates on the edges of
+// its first plane were also generated by the previous slab on its last
+// plane; they are replaced by the points of the previous slab.
+static void vtkSynchronizedTemplates3DMergeSlabs(
+  vtkSynchronizedTemplates3DThreadStruct *str, int numContours,
+  vtkPolyData *output)
+{
+  int numSlabs = static_cast<int>(str->Outputs.size());
+  int *exExt = &str->Extents[0];
+  vtkIdType planeSize =
+    static_cast<vtkIdType>(exExt[1]-exExt[0]+1)*(exExt[3]-exExt[2]+1)*3;
+  vtkIdType numPts = 0;
+  vtkIdType numPolys = 0;
+  int slab;
+  for (slab = 0; slab < numSlabs; ++slab)
+    {
+    numPts += str->Outputs[slab]->GetNumberOfPoints();
+    numPolys += str->Outputs[slab]->GetNumberOfPolys();
+    }
+
+  vtkPoints *newPts = vtkPoints::New();
+  newPts->Allocate(numPts);
+  vtkCellArray *newPolys = vtkCellArray::New();
+  newPolys->Allocate(newPolys->EstimateSize(numPolys,3));
+  vtkPointData *outPD = output->GetPointData();
+  vtkCellData *outCD = output->GetCellData();
+  outPD->CopyAllOn();
+  outPD->CopyAllocate(str->Outputs[0]->GetPointData(), numPts);
+  outCD->CopyAllOn();
+  outCD->CopyAllocate(str->Outputs[0]->GetCellData(), numPolys);
+
+  // Maps the point ids of the current and previous slab to output ids.
+  vtkstd::vector<vtkIdType> pointMap;
+  vtkstd::vector<vtkIdType> previousPointMap;
+  vtkIdType ptId, cellId, newCellId, npts, *pts;
+  vtkIdType ptIds[3];
+  for (slab = 0; slab < numSlabs; ++slab)
+    {
+    vtkPolyData *input = str->Outputs[slab];
+    vtkPointData *inPD = input->GetPointData();
+    vtkCellData *inCD = input->GetCellData();
+    pointMap.assign(input->GetNumberOfPoints(), -1);
+
+    if (slab > 0)
+      {
+      int *first = &str->FirstPlaneIds[slab][0];
+      int *last = &str->LastPlaneIds[slab-1][0];
+      vtkIdType edge, numEdges = planeSize*numContours;
+      for (edge = 0; edge < numEdges; ++edge)
+        {
+        // The slabs share the x and y edges of the seam plane, not the z
+        // edges.
+        if (edge%3 != 2 && first[edge] > -1 && last[edge] > -1)
+          {
+          pointMap[first[edge]] = previousPointMap[last[edge]];
+          }
+        }
+      }
+
+    for (ptId = 0; ptId < input->GetNumberOfPoints(); ++ptId)
+      {
+      if (pointMap[ptId] == -1)
+        {
+        pointMap[ptId] = newPts->InsertNextPoint(input->GetPoint(ptId));
+        outPD->CopyData(inPD, ptId, pointMap[ptId]);
+        }
+      }
+
+    vtkCellArray *polys = input->GetPolys();
+    for (cellId = 0, polys->InitTraversal();
+         polys->GetNextCell(npts, pts); ++cellId)
+      {
+      ptIds[0] = pointMap[pts[0]];
+      ptIds[1] = pointMap[pts[1]];
+      ptIds[2] = pointMap[pts[2]];
+      if (ptIds[0] != ptIds[1] &&
+          ptIds[0] != ptIds[2] &&
+          ptIds[1] != ptIds[2])
+        {
+        newCellId = newPolys->InsertNextCell(3,ptIds);
+        outCD->CopyData(inCD, cellId, newCellId);
+        }
+      }
+    previousPointMap.swap(pointMap);
+    }
+
+  output->SetPoints(newPts);
+  newPts->Delete();
+  output->SetPolys(newPolys);
+  newPolys->Delete();
+}
+
 //----------------------------------------------------------------------------
 //
 // Contouring filter specialized for images (or slices from images)
@@ -697,13 +867,70 @@ void vtkSynchronizedTemplates3D::ThreadedExecute(vtkImageData *data,
                   "ArrayComponent must be smaller than " << numComps);
     return;
     }
+
+  // Split the extent into slabs of at least one layer of cells.
+  int numSlabs = this->NumberOfThreads;
+  if (numSlabs > exExt[5] - exExt[4])
+    {
+    numSlabs = exExt[5] - exExt[4];
+    }
   
-  ptr = data->GetArrayPointerForExtent(inScalars, exExt);
-  switch (inScalars->GetDataType())
+  if (numSlabs <= 1)
     {
-    vtkTemplateMacro(
-      ContourImage(this, exExt, inInfo, data, output, 
-                   (VTK_TT *)ptr, inScalars));
+    ptr = data->GetArrayPointerForExtent(inScalars, exExt);
+    switch (inScalars->GetDataType())
+      {
+      vtkTemplateMacro(
+        ContourImage(this, exExt, inInfo, data, output, 
+                     (VTK_TT *)ptr, inScalars, 0, 0, 1));
+      }
+    return;
+    }
+
+  vtkSynchronizedTemplates3DThreadStruct str;
+  str.Filter = this;
+  str.Input = data;
+  str.InInfo = inInfo;
+  str.InScalars = inScalars;
+  str.Extents.resize(6*numSlabs);
+  str.Outputs.resize(numSlabs);
+  str.FirstPlaneIds.resize(numSlabs);
+  str.LastPlaneIds.resize(numSlabs);
+  size_t planeSize = static_cast<size_t>(exExt[1]-exExt[0]+1)*
+    (exExt[3]-exExt[2]+1)*3*this->GetNumberOfContours();
+  int numCells = exExt[5] - exExt[4];
+  int slab;
+  for (slab = 0; slab < numSlabs; ++slab)
+    {
+    int *slabExt = &str.Extents[6*slab];
+    slabExt[0] = exExt[0];
+    slabExt[1] = exExt[1];
+    slabExt[2] = exExt[2];
+    slabExt[3] = exExt[3];
+    // Neighboring slabs share their seam plane.
+    slabExt[4] = exExt[4] + numCells*slab/numSlabs;
+    slabExt[5] = exExt[4] + numCells*(slab+1)/numSlabs;
+    str.Outputs[slab] = vtkPolyData::New();
+    if (slab > 0)
+      {
+      str.FirstPlaneIds[slab].resize(planeSize);
+      }
+    if (slab < numSlabs - 1)
+      {
+      str.LastPlaneIds[slab].resize(planeSize);
+      }
+    }
+
+  this->Threader->SetNumberOfThreads(numSlabs);
+  this->Threader->SetSingleMethod(vtkSynchronizedTemplates3DThreadedExecute,
+                                  &str);
+  this->Threader->SingleMethodExecute();
+
+  vtkSynchronizedTemplates3DMergeSlabs(&str, this->GetNumberOfContours(),
+                                       output);
+  for (slab = 0; slab < numSlabs; ++slab)
+    {
+    str.Outputs[slab]->Delete();
     }
 }
 
@@ -857,6 +1084,7 @@ void vtkSynchronizedTemplates3D::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "Compute Gradients: " << (this->ComputeGradients ? "On\n" : "Off\n");
   os << indent << "Compute Scalars: " << (this->ComputeScalars ? "On\n" : "Off\n");
   os << indent << "ArrayComponent: " << this->ArrayComponent << endl;
+  os << indent << "NumberOfThreads: " << this->NumberOfThreads << endl;
 }
 
 
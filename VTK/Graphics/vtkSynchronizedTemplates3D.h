@@ -18,6 +18,11 @@
 // vtkSynchronizedTemplates3D is a 3D implementation of the synchronized 
 // template algorithm. Note that vtkContourFilter will automatically
 // use this class when appropriate.
+//
+// The execute extent is split into slabs along the z axis which are
+// contoured by NumberOfThreads threads.  The points the slabs share at
+// their seams are merged so the output is the same as a single threaded
+// execution, up to the order of the points and cells.
 
 // .SECTION Caveats
 // This filter is specialized to 3D images (aka volumes).
@@ -32,6 +37,7 @@
 #include "vtkContourValues.h" // Passes calls through
 
 class vtkImageData;
+class vtkMultiThreader;
 
 class VTK_GRAPHICS_EXPORT vtkSynchronizedTemplates3D : public vtkPolyDataAlgorithm
 {
@@ -135,6 +141,12 @@ public:
   vtkSetMacro(ArrayComponent, int);
   vtkGetMacro(ArrayComponent, int);
 
+  // Description:
+  // Get/Set the number of threads to create when contouring.  Defaults to
+  // the number of threads of vtkMultiThreader.
+  vtkSetClampMacro( NumberOfThreads, int, 1, VTK_MAX_THREADS );
+  vtkGetMacro( NumberOfThreads, int );
+
 protected:
   vtkSynchronizedTemplates3D();
   ~vtkSynchronizedTemplates3D();
@@ -152,6 +164,9 @@ protected:
 
   int ArrayComponent;
 
+  vtkMultiThreader *Threader;
+  int NumberOfThreads;
+
 private:
   vtkSynchronizedTemplates3D(const vtkSynchronizedTemplates3D&);  // Not implemented.
   void operator=(const vtkSynchronizedTemplates3D&);  // Not implemented.
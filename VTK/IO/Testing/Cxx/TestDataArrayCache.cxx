@@ -0,0 +1,238 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    $RCSfile$
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Check that vtkDataArrayCache drops the least recently used arrays and
+// counts its hits and misses, and that the XML readers find the arrays of
+// a file they read before in the shared cache, but not those of a file
+// rewritten since.
+
+#include "vtkDataArrayCache.h"
+#include "vtkDoubleArray.h"
+#include "vtkImageData.h"
+#include "vtkPointData.h"
+#include "vtkSmartPointer.h"
+#include "vtkTestUtilities.h"
+#include "vtkXMLImageDataReader.h"
+#include "vtkXMLImageDataWriter.h"
+
+static const int Size = 40;
+
+// An array of 1 MiB.
+static vtkSmartPointer<vtkDoubleArray> MakeArray()
+{
+  vtkSmartPointer<vtkDoubleArray> array =
+    vtkSmartPointer<vtkDoubleArray>::New();
+  array->SetNumberOfTuples(131072);
+  return array;
+}
+
+static int TestLeastRecentlyUsed()
+{
+  vtkSmartPointer<vtkDataArrayCache> cache =
+    vtkSmartPointer<vtkDataArrayCache>::New();
+  cache->SetCapacity(2.5);
+
+  vtkDataArrayCacheKey keys[3];
+  vtkSmartPointer<vtkDoubleArray> arrays[3];
+  for (int i = 0; i < 3; i++)
+    {
+    keys[i] = vtkDataArrayCacheKey("Source", 0.0, "Array");
+    keys[i].AddId(i);
+    arrays[i] = MakeArray();
+    }
+
+  // The second array is the least recently used when the third one is
+  // inserted.
+  cache->Insert(keys[0], arrays[0]);
+  cache->Insert(keys[1], arrays[1]);
+  if (cache->Find(keys[0]) != arrays[0])
+    {
+    cerr << "The first array is not in the cache." << endl;
+    return 1;
+    }
+  cache->Insert(keys[2], arrays[2]);
+  if (cache->Find(keys[1]) || cache->Find(keys[0]) != arrays[0] ||
+      cache->Find(keys[2]) != arrays[2])
+    {
+    cerr << "The wrong array was dropped from the cache." << endl;
+    return 1;
+    }
+  if (cache->GetNumberOfEntries() != 2 || cache->GetSize() != 2.0 ||
+      cache->GetNumberOfHits() != 3 || cache->GetNumberOfMisses() != 1 ||
+      cache->GetNumberOfEvictions() != 1)
+    {
+    cerr << "Wrong cache statistics:" << endl;
+    cache->Print(cerr);
+    return 1;
+    }
+
+  // Inserting an array again replaces it.
+  cache->Insert(keys[0], arrays[0]);
+  if (cache->GetNumberOfEntries() != 2 || cache->GetSize() != 2.0 ||
+      arrays[0]->GetReferenceCount() != 2)
+    {
+    cerr << "Wrong cache size after inserting an array again." << endl;
+    return 1;
+    }
+
+  // An array found stays alive when it is dropped from the cache.
+  vtkSmartPointer<vtkDataArray> found = cache->Find(keys[0]);
+  if (arrays[0]->GetReferenceCount() != 3)
+    {
+    cerr << "The array found was not registered." << endl;
+    return 1;
+    }
+  cache->Invalidate(keys[0]);
+  if (arrays[0]->GetReferenceCount() != 2)
+    {
+    cerr << "The array found was not kept alive." << endl;
+    return 1;
+    }
+  found = 0;
+
+  cache->SetCapacity(0.0);
+  if (cache->GetNumberOfEntries() != 0 || cache->GetSize() != 0.0 ||
+      arrays[0]->GetReferenceCount() != 1 ||
+      arrays[2]->GetReferenceCount() != 1)
+    {
+    cerr << "The cache still holds arrays." << endl;
+    return 1;
+    }
+  cache->Insert(keys[0], arrays[0]);
+  if (cache->GetNumberOfEntries() != 0)
+    {
+    cerr << "An array was inserted in a disabled cache." << endl;
+    return 1;
+    }
+  return 0;
+}
+
+static vtkSmartPointer<vtkImageData> ReadImage(const char* fileName)
+{
+  vtkSmartPointer<vtkXMLImageDataReader> reader =
+    vtkSmartPointer<vtkXMLImageDataReader>::New();
+  reader->SetFileName(fileName);
+  reader->Update();
+  return reader->GetOutput();
+}
+
+// Write an uncompressed image whose scalars are all the given value, so
+// that the size of the file does not depend on it.
+static int WriteImage(const char* fileName, double value)
+{
+  vtkSmartPointer<vtkImageData> image = vtkSmartPointer<vtkImageData>::New();
+  image->SetExtent(0, Size-1, 0, Size-1, 0, Size-1);
+  vtkSmartPointer<vtkDoubleArray> scalars =
+    vtkSmartPointer<vtkDoubleArray>::New();
+  scalars->SetName("Scalars");
+  scalars->SetNumberOfTuples(image->GetNumberOfPoints());
+  for (vtkIdType i = 0; i < image->GetNumberOfPoints(); i++)
+    {
+    scalars->SetValue(i, value);
+    }
+  image->GetPointData()->SetScalars(scalars);
+
+  vtkSmartPointer<vtkXMLImageDataWriter> writer =
+    vtkSmartPointer<vtkXMLImageDataWriter>::New();
+  writer->SetInput(image);
+  writer->SetFileName(fileName);
+  writer->SetCompressorTypeToNone();
+  if (!writer->Write())
+    {
+    cerr << "Cannot write " << fileName << "." << endl;
+    return 0;
+    }
+  return 1;
+}
+
+// Read the image written by WriteImage() and check its scalars.
+static int CheckImage(const char* fileName, double value, int pass)
+{
+  vtkSmartPointer<vtkImageData> read = ReadImage(fileName);
+  vtkDataArray* output = read->GetPointData()->GetArray("Scalars");
+  if (!output || output->GetNumberOfTuples() != Size*Size*Size)
+    {
+    cerr << "Missing array at pass " << pass << "." << endl;
+    return 0;
+    }
+  for (vtkIdType i = 0; i < output->GetNumberOfTuples(); i++)
+    {
+    if (output->GetTuple1(i) != value)
+      {
+      cerr << "Array differs at " << i << " at pass " << pass << "."
+           << endl;
+      return 0;
+      }
+    }
+  return 1;
+}
+
+static int TestXMLReader(const char* fileName)
+{
+  if (!WriteImage(fileName, 1.0))
+    {
+    return 1;
+    }
+
+  vtkDataArrayCache* cache = vtkDataArrayCache::GetInstance();
+  cache->Clear();
+  cache->ResetStatistics();
+
+  // The second reader finds the array read by the first one.
+  for (int pass = 0; pass < 2; pass++)
+    {
+    if (!CheckImage(fileName, 1.0, pass))
+      {
+      return 1;
+      }
+    if (cache->GetNumberOfHits() != pass ||
+        cache->GetNumberOfEntries() != 1)
+      {
+      cerr << "Wrong cache statistics at pass " << pass << ":" << endl;
+      cache->Print(cerr);
+      return 1;
+      }
+    }
+
+  // The arrays of the file are not found once it is rewritten with other
+  // values, to a file of the same size and most likely within the same
+  // second.
+  if (!WriteImage(fileName, 2.0) || !CheckImage(fileName, 2.0, 2))
+    {
+    return 1;
+    }
+  if (cache->GetNumberOfHits() != 1)
+    {
+    cerr << "The array of the rewritten file was found in the cache." << endl;
+    return 1;
+    }
+  cache->Clear();
+  return 0;
+}
+
+int TestDataArrayCache(int argc, char *argv[])
+{
+  char* fileName = vtkTestUtilities::ExpandFileNameWithArgOrEnvOrDefault(
+    "-T", argc, argv, "VTK_TEMP_DIR", "Testing/Temporary",
+    "TestDataArrayCache.vti");
+
+  int failed = TestLeastRecentlyUsed();
+  if (!failed)
+    {
+    failed = TestXMLReader(fileName);
+    }
+
+  delete [] fileName;
+  return failed;
+}
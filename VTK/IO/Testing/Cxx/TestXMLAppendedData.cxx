@@ -0,0 +1,163 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    $RCSfile$
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Write an image with raw and encoded, compressed and uncompressed
+// appended data, and check that it is read back, whole and in part, when
+// the compressed blocks are decompressed by several threads and the raw
+// data are read from the memory mapped file.
+
+#include "vtkDoubleArray.h"
+#include "vtkFloatArray.h"
+#include "vtkImageData.h"
+#include "vtkPointData.h"
+#include "vtkSmartPointer.h"
+#include "vtkTestUtilities.h"
+#include "vtkXMLImageDataReader.h"
+#include "vtkXMLImageDataWriter.h"
+
+static const int Size = 40;
+
+static vtkSmartPointer<vtkImageData> MakeImage()
+{
+  vtkSmartPointer<vtkImageData> image = vtkSmartPointer<vtkImageData>::New();
+  image->SetExtent(0, Size-1, 0, Size-1, 0, Size-1);
+  vtkSmartPointer<vtkFloatArray> vectors =
+    vtkSmartPointer<vtkFloatArray>::New();
+  vectors->SetName("Vectors");
+  vectors->SetNumberOfComponents(3);
+  vectors->SetNumberOfTuples(image->GetNumberOfPoints());
+  vtkSmartPointer<vtkDoubleArray> scalars =
+    vtkSmartPointer<vtkDoubleArray>::New();
+  scalars->SetName("Scalars");
+  scalars->SetNumberOfTuples(image->GetNumberOfPoints());
+  for (vtkIdType i = 0; i < image->GetNumberOfPoints(); i++)
+    {
+    vectors->SetTuple3(i, i, 0.5*i, -i);
+    scalars->SetValue(i, 1.0/(i + 1));
+    }
+  image->GetPointData()->AddArray(vectors);
+  image->GetPointData()->AddArray(scalars);
+  return image;
+}
+
+// Check the arrays of the output against those of the image over the
+// extent of the output.
+static bool SameImages(vtkImageData* image, vtkImageData* output)
+{
+  int extent[6];
+  output->GetExtent(extent);
+  const char* names[2] = { "Vectors", "Scalars" };
+  for (int a = 0; a < 2; a++)
+    {
+    vtkDataArray* in = image->GetPointData()->GetArray(names[a]);
+    vtkDataArray* out = output->GetPointData()->GetArray(names[a]);
+    if (!out || out->GetNumberOfTuples() != output->GetNumberOfPoints() ||
+        out->GetNumberOfComponents() != in->GetNumberOfComponents())
+      {
+      cerr << "Missing array " << names[a] << "." << endl;
+      return false;
+      }
+    vtkIdType outId = 0;
+    for (int k = extent[4]; k <= extent[5]; k++)
+      {
+      for (int j = extent[2]; j <= extent[3]; j++)
+        {
+        for (int i = extent[0]; i <= extent[1]; i++, outId++)
+          {
+          vtkIdType inId = i + Size*(j + Size*k);
+          for (int c = 0; c < in->GetNumberOfComponents(); c++)
+            {
+            if (in->GetComponent(inId, c) != out->GetComponent(outId, c))
+              {
+              cerr << "Array " << names[a] << " differs at point ("
+                   << i << ", " << j << ", " << k << ")." << endl;
+              return false;
+              }
+            }
+          }
+        }
+      }
+    }
+  return true;
+}
+
+int TestXMLAppendedData(int argc, char *argv[])
+{
+  char* fileName = vtkTestUtilities::ExpandFileNameWithArgOrEnvOrDefault(
+    "-T", argc, argv, "VTK_TEMP_DIR", "Testing/Temporary",
+    "TestXMLAppendedData.vti");
+
+  vtkSmartPointer<vtkImageData> image = MakeImage();
+  int failed = 0;
+  for (int mode = 0; mode < 4 && !failed; mode++)
+    {
+    int compressed = mode & 1;
+    int encoded = mode & 2;
+
+    // Small blocks in the byte order of the other machines, so that many
+    // blocks are decompressed and swapped by each thread.
+    vtkSmartPointer<vtkXMLImageDataWriter> writer =
+      vtkSmartPointer<vtkXMLImageDataWriter>::New();
+    writer->SetInput(image);
+    writer->SetFileName(fileName);
+    writer->SetDataModeToAppended();
+    writer->SetEncodeAppendedData(encoded);
+#ifdef VTK_WORDS_BIGENDIAN
+    writer->SetByteOrderToLittleEndian();
+#else
+    writer->SetByteOrderToBigEndian();
+#endif
+    if (compressed)
+      {
+      writer->SetCompressorTypeToZLib();
+      writer->SetBlockSize(1000);
+      }
+    else
+      {
+      writer->SetCompressorTypeToNone();
+      }
+    if (!writer->Write())
+      {
+      cerr << "Cannot write " << fileName << "." << endl;
+      failed = 1;
+      break;
+      }
+
+    // Read the whole image, then a part starting and ending within
+    // blocks.
+    vtkSmartPointer<vtkXMLImageDataReader> reader =
+      vtkSmartPointer<vtkXMLImageDataReader>::New();
+    reader->SetFileName(fileName);
+    reader->SetNumberOfThreads(4);
+    reader->Update();
+    if (!SameImages(image, reader->GetOutput()))
+      {
+      failed = 1;
+      }
+    reader->GetOutput()->SetUpdateExtent(3, Size-5, 1, Size-2, 7, Size-9);
+    reader->Update();
+    if (!SameImages(image, reader->GetOutput()))
+      {
+      failed = 1;
+      }
+    if (failed)
+      {
+      cerr << "Failed with " << (compressed? "compressed" : "uncompressed")
+           << (encoded? " encoded" : " raw") << " appended data." << endl;
+      }
+    }
+
+  delete [] fileName;
+  return failed;
+}
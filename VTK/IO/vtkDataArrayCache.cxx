@@ -0,0 +1,376 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    $RCSfile$
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkDataArrayCache.h"
+
+#include "vtkCriticalSection.h"
+#include "vtkDataArray.h"
+#include "vtkObjectFactory.h"
+
+#include <vtkstd/list>
+#include <vtkstd/map>
+#include <vtksys/ios/sstream>
+
+#include <sys/stat.h>
+
+// The nanoseconds of the times of a struct stat, where the platform has
+// them.
+#if defined(__APPLE__)
+# define VTK_DATA_ARRAY_CACHE_MTIME_NSEC(fs) ((fs).st_mtimespec.tv_nsec)
+# define VTK_DATA_ARRAY_CACHE_CTIME_NSEC(fs) ((fs).st_ctimespec.tv_nsec)
+#elif defined(_STATBUF_ST_NSEC)
+# define VTK_DATA_ARRAY_CACHE_MTIME_NSEC(fs) ((fs).st_mtim.tv_nsec)
+# define VTK_DATA_ARRAY_CACHE_CTIME_NSEC(fs) ((fs).st_ctim.tv_nsec)
+#else
+# define VTK_DATA_ARRAY_CACHE_MTIME_NSEC(fs) 0
+# define VTK_DATA_ARRAY_CACHE_CTIME_NSEC(fs) 0
+#endif
+
+vtkCxxRevisionMacro(vtkDataArrayCache, "$Revision$");
+vtkStandardNewMacro(vtkDataArrayCache);
+
+vtkDataArrayCache* vtkDataArrayCache::Instance = 0;
+vtkDataArrayCacheCleanup vtkDataArrayCache::Cleanup;
+
+//----------------------------------------------------------------------------
+vtkDataArrayCacheKey::vtkDataArrayCacheKey()
+{
+  this->Time = 0.0;
+}
+
+//----------------------------------------------------------------------------
+vtkDataArrayCacheKey::vtkDataArrayCacheKey(const char* source, double time,
+                                           const char* name)
+{
+  this->Source = source? source : "";
+  this->Time = time;
+  this->Name = name? name : "";
+}
+
+//----------------------------------------------------------------------------
+void vtkDataArrayCacheKey::SetSourceToFile(const char* fileName)
+{
+  vtksys_ios::ostringstream source;
+  source << (fileName? fileName : "");
+  struct stat fs;
+  if(fileName && stat(fileName, &fs) == 0)
+    {
+    // Print the size and serial number without rounding them.
+    source.precision(20);
+    source << " " << static_cast<double>(fs.st_size)
+           << " " << static_cast<double>(fs.st_ino)
+           << " " << static_cast<long>(fs.st_mtime)
+           << "." << static_cast<long>(VTK_DATA_ARRAY_CACHE_MTIME_NSEC(fs))
+           << " " << static_cast<long>(fs.st_ctime)
+           << "." << static_cast<long>(VTK_DATA_ARRAY_CACHE_CTIME_NSEC(fs));
+    }
+  this->Source = source.str();
+}
+
+//----------------------------------------------------------------------------
+bool vtkDataArrayCacheKey::operator<(const vtkDataArrayCacheKey& other) const
+{
+  if(this->Time != other.Time)
+    {
+    return this->Time < other.Time;
+    }
+  int c = this->Source.compare(other.Source);
+  if(c != 0)
+    {
+    return c < 0;
+    }
+  c = this->Name.compare(other.Name);
+  if(c != 0)
+    {
+    return c < 0;
+    }
+  return this->Ids < other.Ids;
+}
+
+//----------------------------------------------------------------------------
+struct vtkDataArrayCacheEntry;
+typedef vtkstd::map<vtkDataArrayCacheKey, vtkDataArrayCacheEntry>
+  vtkDataArrayCacheMap;
+typedef vtkstd::list<vtkDataArrayCacheMap::iterator> vtkDataArrayCacheLRU;
+
+struct vtkDataArrayCacheEntry
+{
+  vtkDataArray* Array;
+  // The size of the array when it was inserted, in MiB.
+  double Size;
+  // The position of the entry in the LRU list.
+  vtkDataArrayCacheLRU::iterator LRUEntry;
+};
+
+//----------------------------------------------------------------------------
+class vtkDataArrayCacheInternals
+{
+public:
+  // Drop an entry from the cache and return its size.
+  double Erase(vtkDataArrayCacheMap::iterator it)
+    {
+    double size = it->second.Size;
+    it->second.Array->UnRegister(0);
+    this->LRU.erase(it->second.LRUEntry);
+    this->Entries.erase(it);
+    return size;
+    }
+
+  vtkDataArrayCacheMap Entries;
+
+  // The entries from the most to the least recently used.
+  vtkDataArrayCacheLRU LRU;
+};
+
+//----------------------------------------------------------------------------
+vtkDataArrayCacheCleanup::vtkDataArrayCacheCleanup()
+{
+}
+
+//----------------------------------------------------------------------------
+vtkDataArrayCacheCleanup::~vtkDataArrayCacheCleanup()
+{
+  // Destroy the shared cache and the arrays it still holds.
+  vtkDataArrayCache::SetInstance(0);
+}
+
+//----------------------------------------------------------------------------
+vtkDataArrayCache::vtkDataArrayCache()
+{
+  this->Capacity = 128.0;
+  this->Size = 0.0;
+  this->NumberOfHits = 0;
+  this->NumberOfMisses = 0;
+  this->NumberOfEvictions = 0;
+  this->Lock = vtkSimpleCriticalSection::New();
+  this->Internals = new vtkDataArrayCacheInternals;
+}
+
+//----------------------------------------------------------------------------
+vtkDataArrayCache::~vtkDataArrayCache()
+{
+  this->Clear();
+  delete this->Internals;
+  this->Lock->Delete();
+}
+
+//----------------------------------------------------------------------------
+vtkDataArrayCache* vtkDataArrayCache::GetInstance()
+{
+  if(!vtkDataArrayCache::Instance)
+    {
+    vtkDataArrayCache::Instance = vtkDataArrayCache::New();
+    }
+  return vtkDataArrayCache::Instance;
+}
+
+//----------------------------------------------------------------------------
+void vtkDataArrayCache::SetInstance(vtkDataArrayCache* instance)
+{
+  if(vtkDataArrayCache::Instance == instance)
+    {
+    return;
+    }
+  if(vtkDataArrayCache::Instance)
+    {
+    vtkDataArrayCache::Instance->Delete();
+    }
+  vtkDataArrayCache::Instance = instance;
+  if(instance)
+    {
+    instance->Register(0);
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkDataArrayCache::SetCapacity(double sizeInMiB)
+{
+  if(sizeInMiB < 0.0)
+    {
+    sizeInMiB = 0.0;
+    }
+  if(sizeInMiB == this->Capacity)
+    {
+    return;
+    }
+  this->Lock->Lock();
+  this->Capacity = sizeInMiB;
+  this->ReduceToSize(sizeInMiB);
+  this->Lock->Unlock();
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+int vtkDataArrayCache::GetNumberOfEntries()
+{
+  this->Lock->Lock();
+  int n = static_cast<int>(this->Internals->Entries.size());
+  this->Lock->Unlock();
+  return n;
+}
+
+//----------------------------------------------------------------------------
+void vtkDataArrayCache::Insert(const vtkDataArrayCacheKey& key,
+                               vtkDataArray* array)
+{
+  if(!array)
+    {
+    return;
+    }
+  double size = array->GetActualMemorySize()/1024.0;
+  if(!this->CanInsert(size))
+    {
+    return;
+    }
+
+  // Register the array before dropping the entry it may replace, which may
+  // hold the only other reference to it.
+  array->Register(0);
+  this->Lock->Lock();
+  vtkDataArrayCacheMap::iterator it = this->Internals->Entries.find(key);
+  if(it != this->Internals->Entries.end())
+    {
+    this->Size -= this->Internals->Erase(it);
+    }
+  this->ReduceToSize(this->Capacity - size);
+
+  vtkDataArrayCacheEntry entry;
+  entry.Array = array;
+  entry.Size = size;
+  it = this->Internals->Entries.insert(
+    vtkDataArrayCacheMap::value_type(key, entry)).first;
+  this->Internals->LRU.push_front(it);
+  it->second.LRUEntry = this->Internals->LRU.begin();
+  this->Size += size;
+  this->Lock->Unlock();
+}
+
+//----------------------------------------------------------------------------
+vtkSmartPointer<vtkDataArray>
+vtkDataArrayCache::Find(const vtkDataArrayCacheKey& key)
+{
+  // Take the reference to the array with the lock held, before another
+  // thread can drop it.
+  this->Lock->Lock();
+  vtkSmartPointer<vtkDataArray> array;
+  vtkDataArrayCacheMap::iterator it = this->Internals->Entries.find(key);
+  if(it != this->Internals->Entries.end())
+    {
+    // Move the entry to the front of the LRU list.
+    this->Internals->LRU.splice(this->Internals->LRU.begin(),
+                                this->Internals->LRU, it->second.LRUEntry);
+    array = it->second.Array;
+    ++this->NumberOfHits;
+    }
+  else
+    {
+    ++this->NumberOfMisses;
+    }
+  this->Lock->Unlock();
+  return array;
+}
+
+//----------------------------------------------------------------------------
+int vtkDataArrayCache::Invalidate(const vtkDataArrayCacheKey& key)
+{
+  this->Lock->Lock();
+  int found = 0;
+  vtkDataArrayCacheMap::iterator it = this->Internals->Entries.find(key);
+  if(it != this->Internals->Entries.end())
+    {
+    this->Size -= this->Internals->Erase(it);
+    found = 1;
+    }
+  if(this->Internals->Entries.empty())
+    {
+    this->Size = 0.0;
+    }
+  this->Lock->Unlock();
+  return found;
+}
+
+//----------------------------------------------------------------------------
+int vtkDataArrayCache::InvalidateSource(const char* source)
+{
+  vtkstd::string s = source? source : "";
+  this->Lock->Lock();
+  int dropped = 0;
+  vtkDataArrayCacheMap::iterator it = this->Internals->Entries.begin();
+  while(it != this->Internals->Entries.end())
+    {
+    vtkDataArrayCacheMap::iterator next = it;
+    ++next;
+    if(it->first.Source == s)
+      {
+      this->Size -= this->Internals->Erase(it);
+      ++dropped;
+      }
+    it = next;
+    }
+  if(this->Internals->Entries.empty())
+    {
+    this->Size = 0.0;
+    }
+  this->Lock->Unlock();
+  return dropped;
+}
+
+//----------------------------------------------------------------------------
+void vtkDataArrayCache::Clear()
+{
+  this->Lock->Lock();
+  while(!this->Internals->Entries.empty())
+    {
+    this->Internals->Erase(this->Internals->Entries.begin());
+    }
+  this->Size = 0.0;
+  this->Lock->Unlock();
+}
+
+//----------------------------------------------------------------------------
+void vtkDataArrayCache::ResetStatistics()
+{
+  this->Lock->Lock();
+  this->NumberOfHits = 0;
+  this->NumberOfMisses = 0;
+  this->NumberOfEvictions = 0;
+  this->Lock->Unlock();
+}
+
+//----------------------------------------------------------------------------
+void vtkDataArrayCache::ReduceToSize(double sizeInMiB)
+{
+  while(this->Size > sizeInMiB && !this->Internals->LRU.empty())
+    {
+    this->Size -= this->Internals->Erase(this->Internals->LRU.back());
+    ++this->NumberOfEvictions;
+    }
+  if(this->Internals->Entries.empty())
+    {
+    // Avoid any accumulated roundoff.
+    this->Size = 0.0;
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkDataArrayCache::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "Capacity: " << this->Capacity << " MiB\n";
+  os << indent << "Size: " << this->Size << " MiB\n";
+  os << indent << "NumberOfEntries: " << this->GetNumberOfEntries() << "\n";
+  os << indent << "NumberOfHits: " << this->NumberOfHits << "\n";
+  os << indent << "NumberOfMisses: " << this->NumberOfMisses << "\n";
+  os << indent << "NumberOfEvictions: " << this->NumberOfEvictions << "\n";
+}
@@ -0,0 +1,195 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    $RCSfile$
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkDataArrayCache - Process wide LRU cache of the arrays read by readers
+// .SECTION Description
+// vtkDataArrayCache keeps the data arrays readers have read from disk, so
+// that they are not read again when the array selection or the time step
+// changes back.  It generalizes vtkExodusIICache to all the readers of the
+// process, which share a single instance and a single memory budget
+// (GetInstance()).
+//
+// The arrays are indexed by a vtkDataArrayCacheKey made of the source of
+// the arrays (usually a file, see SetSourceToFile()), a time, a name and
+// any number of ids the reader chooses (a block, a piece, a range of
+// values...).  When an array is inserted and the cache would grow over its
+// capacity, the least recently used arrays are dropped.
+//
+// The cache holds a reference to the arrays it contains, and Find() returns
+// another one, so that an array found by a thread is not deleted when
+// another thread drops it.  A reader must not modify an array it found in
+// the cache, unless it invalidates the entry first.  The cache counts
+// its hits, misses and evictions.
+// .SECTION See Also
+// vtkExodusIICache
+
+#ifndef __vtkDataArrayCache_h
+#define __vtkDataArrayCache_h
+
+#include "vtkObject.h"
+
+//BTX
+#include "vtkSmartPointer.h" // used for the arrays found
+#include <vtkstd/string> // used for the keys
+#include <vtkstd/vector> // used for the keys
+//ETX
+
+class vtkDataArray;
+class vtkDataArrayCacheInternals;
+class vtkSimpleCriticalSection;
+
+//BTX
+class VTK_IO_EXPORT vtkDataArrayCacheKey
+{
+public:
+  vtkDataArrayCacheKey();
+  vtkDataArrayCacheKey(const char* source, double time, const char* name);
+
+  // Description:
+  // Set the source to the given file.  The size, the file serial number and
+  // the times of the last modification and status change of the file, to
+  // the nanosecond where the platform has them, are part of the source, so
+  // that the arrays of a file rewritten since they were cached are not
+  // found, even when it was rewritten within the same second.
+  void SetSourceToFile(const char* fileName);
+
+  // Description:
+  // Append an id telling apart the arrays of the same source, time and
+  // name.
+  vtkDataArrayCacheKey& AddId(vtkIdType id)
+    {
+    this->Ids.push_back(id);
+    return *this;
+    }
+
+  bool operator<(const vtkDataArrayCacheKey& other) const;
+
+  vtkstd::string Source;
+  double Time;
+  vtkstd::string Name;
+  vtkstd::vector<vtkIdType> Ids;
+};
+
+class VTK_IO_EXPORT vtkDataArrayCacheCleanup
+{
+public:
+  vtkDataArrayCacheCleanup();
+  ~vtkDataArrayCacheCleanup();
+};
+//ETX
+
+class VTK_IO_EXPORT vtkDataArrayCache : public vtkObject
+{
+public:
+  static vtkDataArrayCache* New();
+  vtkTypeRevisionMacro(vtkDataArrayCache,vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  // Description:
+  // Return the cache shared by all the readers of the process.
+  static vtkDataArrayCache* GetInstance();
+
+  // Description:
+  // Replace the cache shared by all the readers.  Call Delete() on the
+  // supplied instance after setting it.
+  static void SetInstance(vtkDataArrayCache* instance);
+
+  // Description:
+  // Set/Get the maximum size of all the arrays in the cache, in MiB.
+  // Reducing it drops the least recently used arrays.  It defaults to 128
+  // MiB.  A capacity of 0 disables the cache.
+  void SetCapacity(double sizeInMiB);
+  vtkGetMacro(Capacity, double);
+
+  // Description:
+  // Get the size of all the arrays in the cache, in MiB.
+  vtkGetMacro(Size, double);
+
+  // Description:
+  // Get the number of arrays in the cache.
+  int GetNumberOfEntries();
+
+  // Description:
+  // Return 1 if an array of the given size, in MiB, fits in the cache.
+  int CanInsert(double sizeInMiB)
+    { return sizeInMiB <= this->Capacity; }
+
+  //BTX
+  // Description:
+  // Insert an array in the cache, dropping the least recently used arrays
+  // to make room for it.  Arrays larger than the capacity are not
+  // inserted.
+  void Insert(const vtkDataArrayCacheKey& key, vtkDataArray* array);
+
+  // Description:
+  // Return the array of the given key and mark it as the most recently
+  // used, or return 0 if the cache does not have it.  The array stays
+  // alive as long as the returned pointer, even if it is dropped from the
+  // cache meanwhile.
+  vtkSmartPointer<vtkDataArray> Find(const vtkDataArrayCacheKey& key);
+
+  // Description:
+  // Drop the array of the given key from the cache.  Returns 1 if it was
+  // in the cache, 0 otherwise.
+  int Invalidate(const vtkDataArrayCacheKey& key);
+  //ETX
+
+  // Description:
+  // Drop all the arrays of the given source from the cache.  Returns the
+  // number of arrays dropped.
+  int InvalidateSource(const char* source);
+
+  // Description:
+  // Drop all the arrays from the cache.
+  void Clear();
+
+  // Description:
+  // Get the number of arrays found, not found and dropped to make room for
+  // others since the statistics were last reset.
+  vtkGetMacro(NumberOfHits, vtkIdType);
+  vtkGetMacro(NumberOfMisses, vtkIdType);
+  vtkGetMacro(NumberOfEvictions, vtkIdType);
+  void ResetStatistics();
+
+//BTX
+  // Deletes the shared instance when the program exits.
+  static vtkDataArrayCacheCleanup Cleanup;
+//ETX
+
+protected:
+  vtkDataArrayCache();
+  ~vtkDataArrayCache();
+
+  // Drop the least recently used arrays until the size of the cache is at
+  // most the given size.  The lock must be held.
+  void ReduceToSize(double sizeInMiB);
+
+  double Capacity;
+  double Size;
+  vtkIdType NumberOfHits;
+  vtkIdType NumberOfMisses;
+  vtkIdType NumberOfEvictions;
+
+  vtkSimpleCriticalSection* Lock;
+
+private:
+  vtkDataArrayCacheInternals* Internals;
+
+  static vtkDataArrayCache* Instance;
+
+  vtkDataArrayCache(const vtkDataArrayCache&);  // Not implemented.
+  void operator=(const vtkDataArrayCache&);  // Not implemented.
+};
+
+#endif
@@ -700,6 +700,124 @@ VTK_TEMPLATE_SPECIALIZE inline double vtkFoamToken::To<double>() const
   return this->Type == LABEL ? this->Int : this->Double;
 }
 
+//-----------------------------------------------------------------------------
+// number parsers of the bulk scanners of vtkFoamFile. a number is parsed
+// in place from a buffer where a whitespace follows it. returns false,
+// leaving ptr as is, if there is no number at ptr. the arithmetic is that
+// of vtkFoamFile::ReadIntValue() / ReadFloatValue().
+static inline bool vtkFoamFileScanInt(unsigned char *&ptr, int &value)
+{
+  unsigned char *p = ptr;
+  const bool negative = (*p == '-');
+  if (negative || *p == '+')
+    {
+    ++p;
+    }
+  if (!isdigit(*p))
+    {
+    return false;
+    }
+  int num = *p++ - '0';
+  while (isdigit(*p))
+    {
+    num = 10 * num + *p++ - '0';
+    }
+  value = negative ? -num : num;
+  ptr = p;
+  return true;
+}
+
+static inline bool vtkFoamFileScanFloat(unsigned char *&ptr, float &value)
+{
+  unsigned char *p = ptr;
+  const bool negative = (*p == '-');
+  if (negative || *p == '+')
+    {
+    ++p;
+    }
+  if (!isdigit(*p) && *p != '.')
+    {
+    return false;
+    }
+
+  // read integer part
+  double num = 0.0;
+  while (isdigit(*p))
+    {
+    num = num * 10.0 + (*p++ - '0');
+    }
+
+  // read decimal part
+  if (*p == '.')
+    {
+    double divisor = 1.0;
+    ++p;
+    while (isdigit(*p))
+      {
+      num = num * 10.0 + (*p++ - '0');
+      divisor *= 10.0;
+      }
+    num /= divisor;
+    }
+
+  // read exponent part
+  if (*p == 'E' || *p == 'e')
+    {
+    int esign = 1;
+    int eval = 0;
+    double scale = 1.0;
+
+    ++p;
+    if (*p == '-')
+      {
+      esign = -1;
+      ++p;
+      }
+    else if (*p == '+')
+      {
+      ++p;
+      }
+    while (isdigit(*p))
+      {
+      eval = eval * 10 + (*p++ - '0');
+      }
+
+    while (eval >= 64)
+      {
+      scale *= 1.0e+64;
+      eval -= 64;
+      }
+    while (eval >= 16)
+      {
+      scale *= 1.0e+16;
+      eval -= 16;
+      }
+    while (eval >= 4)
+      {
+      scale *= 1.0e+4;
+      eval -= 4;
+      }
+    while (eval >= 1)
+      {
+      scale *= 1.0e+1;
+      eval -= 1;
+      }
+
+    if (esign < 0)
+      {
+      num /= scale;
+      }
+    else
+      {
+      num *= scale;
+      }
+    }
+
+  value = static_cast<float>(negative ? -num : num);
+  ptr = p;
+  return true;
+}
+
 //-----------------------------------------------------------------------------
 // class vtkFoamFileStack
 // list of variables that have to be saved when a file is included.
@@ -815,6 +933,45 @@ private:
         : *this->Superclass::BufPtr++;
   }
 
+  // the end of the part of the buffer the bulk scanners may read: past
+  // the last whitespace so that no number is cut by the end of the buffer
+  unsigned char *ScanEnd() const
+  {
+    unsigned char *end = this->Superclass::BufEndPtr;
+    while (end > this->Superclass::BufPtr && !isspace(end[-1]))
+      {
+      --end;
+      }
+    return end;
+  }
+
+  // skip whitespaces within the scanned part of the buffer
+  static unsigned char *SkipSpaces(unsigned char *ptr,
+      const unsigned char *end, int &nLines)
+  {
+    while (ptr < end && isspace(*ptr))
+      {
+      if (*ptr++ == '\n')
+        {
+        ++nLines;
+        }
+      }
+    return ptr;
+  }
+
+  // consume the scanned part of the buffer up to ptr
+  void EndScan(unsigned char *ptr, const int nLines)
+  {
+    this->Superclass::BufPtr = ptr;
+    this->Superclass::LineNumber += nLines;
+#if VTK_FOAMFILE_RECOGNIZE_LINEHEAD
+    if (nLines > 0)
+      {
+      this->Superclass::WasNewline = true;
+      }
+#endif
+  }
+
   vtkFoamError StackString()
   {
     vtksys_ios::ostringstream os;
@@ -1456,6 +1613,14 @@ public:
 
   int ReadIntValue();
   float ReadFloatValue();
+
+  // bulk scanners for large ASCII lists. they parse the numbers directly
+  // in the buffer and fall back to ReadIntValue() / ReadFloatValue() for
+  // a number cut by the end of the buffer, comments, or errors.
+  void ReadIntValues(int *values, const int n);
+  void ReadFloatValues(float *values, const int n);
+  void ReadFloatTuples(float *values, const int nTuples,
+      const int nComponents);
 };
 
 int vtkFoamFile::ReadNext()
@@ -1658,6 +1823,110 @@ float vtkFoamFile::ReadFloatValue()
   return static_cast<float>(nonNegative ? num : -num);
 }
 
+void vtkFoamFile::ReadIntValues(int *values, const int n)
+{
+  int i = 0;
+  while (i < n)
+    {
+    unsigned char *ptr = this->Superclass::BufPtr;
+    const unsigned char *end = this->ScanEnd();
+    int nLines = 0;
+    for (; i < n; i++)
+      {
+      ptr = this->SkipSpaces(ptr, end, nLines);
+      if (ptr == end || !vtkFoamFileScanInt(ptr, values[i]))
+        {
+        break;
+        }
+      }
+    this->EndScan(ptr, nLines);
+    if (i < n)
+      {
+      values[i++] = this->ReadIntValue();
+      }
+    }
+}
+
+void vtkFoamFile::ReadFloatValues(float *values, const int n)
+{
+  int i = 0;
+  while (i < n)
+    {
+    unsigned char *ptr = this->Superclass::BufPtr;
+    const unsigned char *end = this->ScanEnd();
+    int nLines = 0;
+    for (; i < n; i++)
+      {
+      ptr = this->SkipSpaces(ptr, end, nLines);
+      if (ptr == end || !vtkFoamFileScanFloat(ptr, values[i]))
+        {
+        break;
+        }
+      }
+    this->EndScan(ptr, nLines);
+    if (i < n)
+      {
+      values[i++] = this->ReadFloatValue();
+      }
+    }
+}
+
+// reads tuples of the form (x y z)
+void vtkFoamFile::ReadFloatTuples(float *values, const int nTuples,
+    const int nComponents)
+{
+  int i = 0;
+  while (i < nTuples)
+    {
+    unsigned char *ptr = this->Superclass::BufPtr;
+    const unsigned char *end = this->ScanEnd();
+    int nLines = 0;
+    for (; i < nTuples; i++)
+      {
+      // a tuple is consumed only when it is entirely in the buffer
+      int nTupleLines = 0;
+      unsigned char *p = this->SkipSpaces(ptr, end, nTupleLines);
+      if (p == end || *p != '(')
+        {
+        break;
+        }
+      float *tuple = values + nComponents * i;
+      int j;
+      for (j = 0, ++p; j < nComponents; j++)
+        {
+        p = this->SkipSpaces(p, end, nTupleLines);
+        if (p == end || !vtkFoamFileScanFloat(p, tuple[j]))
+          {
+          break;
+          }
+        }
+      if (j < nComponents)
+        {
+        break;
+        }
+      p = this->SkipSpaces(p, end, nTupleLines);
+      if (p == end || *p != ')')
+        {
+        break;
+        }
+      ptr = p + 1;
+      nLines += nTupleLines;
+      }
+    this->EndScan(ptr, nLines);
+    if (i < nTuples)
+      {
+      this->ReadExpecting('(');
+      float *tuple = values + nComponents * i;
+      for (int j = 0; j < nComponents; j++)
+        {
+        tuple[j] = this->ReadFloatValue();
+        }
+      this->ReadExpecting(')');
+      i++;
+      }
+    }
+}
+
 // hacks to keep exception throwing code out-of-line to make
 // putBack() and readExpecting() inline expandable
 void vtkFoamFile::ThrowUnexpectedEOFException()
@@ -1917,6 +2186,7 @@ template <typename T> struct vtkFoamReadValue
 {
 public:
   static T ReadValue(vtkFoamIOobject &io);
+  static void ReadValues(vtkFoamIOobject &io, T *values, const int n);
 };
 
 VTK_TEMPLATE_SPECIALIZE inline int vtkFoamReadValue<int>::ReadValue(vtkFoamIOobject& io)
@@ -1929,6 +2199,18 @@ VTK_TEMPLATE_SPECIALIZE inline float vtkFoamReadValue<float>::ReadValue(vtkFoamI
   return io.ReadFloatValue();
 }
 
+VTK_TEMPLATE_SPECIALIZE inline void vtkFoamReadValue<int>::ReadValues(
+    vtkFoamIOobject& io, int *values, const int n)
+{
+  io.ReadIntValues(values, n);
+}
+
+VTK_TEMPLATE_SPECIALIZE inline void vtkFoamReadValue<float>::ReadValues(
+    vtkFoamIOobject& io, float *values, const int n)
+{
+  io.ReadFloatValues(values, n);
+}
+
 //-----------------------------------------------------------------------------
 // class vtkFoamEntryValue
 // a class that represents a value of a dictionary entry that corresponds to
@@ -1975,10 +2257,8 @@ public:
     }
     void ReadAsciiList(vtkFoamIOobject& io, const int size)
     {
-      for (int i = 0; i < size; i++)
-        {
-        this->Ptr->SetValue(i, vtkFoamReadValue<primitiveT>::ReadValue(io));
-        }
+      vtkFoamReadValue<primitiveT>::ReadValues(io, this->Ptr->GetPointer(0),
+          size);
     }
     void ReadBinaryList(vtkFoamIOobject& io, const int size)
     {
@@ -2036,6 +2316,11 @@ public:
     }
     void ReadAsciiList(vtkFoamIOobject& io, const int size)
     {
+      if (!isPositions)
+        {
+        io.ReadFloatTuples(this->Ptr->GetPointer(0), size, nComponents);
+        return;
+        }
       for (int i = 0; i < size; i++)
         {
         io.ReadExpecting('(');
@@ -2272,10 +2557,7 @@ public:
           if (io.GetFormat() == vtkFoamIOobject::ASCII)
             {
             io.ReadExpecting('(');
-            for (int j = 0; j < sizeJ; j++)
-              {
-              listI[j] = vtkFoamReadValue<int>::ReadValue(io);
-              }
+            io.ReadIntValues(listI, sizeJ);
             io.ReadExpecting(')');
             }
           else
@@ -8196,7 +8478,7 @@ int vtkOpenFOAMReader::RequestData(vtkInformation *vtkNotUsed(request), vtkInfor
     {
     ret = reader->RequestData(output, recreateInternalMesh,
         recreateBoundaryMesh, updateVariables);
-    this->Parent->CurrentReaderIndex++;
+    this->Parent->IncrementCurrentReaderIndex();
     }
   else
     {
@@ -8223,7 +8505,7 @@ int vtkOpenFOAMReader::RequestData(vtkInformation *vtkNotUsed(request), vtkInfor
         ret = 0;
         }
       subOutput->Delete();
-      this->Parent->CurrentReaderIndex++;
+      this->Parent->IncrementCurrentReaderIndex();
       }
     }
 
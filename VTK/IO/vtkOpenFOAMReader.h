@@ -301,7 +301,8 @@ protected:
   void SetTimeInformation(vtkInformationVector *, vtkDoubleArray *);
   void CreateCharArrayFromString(vtkCharArray *, const char *, vtkStdString &);
   void UpdateStatus();
-  void UpdateProgress(double);
+  virtual void UpdateProgress(double);
+  virtual void IncrementCurrentReaderIndex() { this->CurrentReaderIndex++; }
 
 private:
   vtkOpenFOAMReader *Parent;
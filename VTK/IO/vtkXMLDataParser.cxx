@@ -19,13 +19,156 @@
 #include "vtkCommand.h"
 #include "vtkDataCompressor.h"
 #include "vtkInputStream.h"
+#include "vtkMultiThreader.h"
 #include "vtkObjectFactory.h"
 #include "vtkXMLDataElement.h"
 
 #include <vtksys/ios/sstream>
+#include <vtkstd/string>
+#include <vtkstd/vector>
 
 #include "vtkXMLUtilities.h"
 
+#if defined(_WIN32)
+# include "vtkWindows.h"
+#else
+# include <fcntl.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <unistd.h>
+#endif
+
+// The number of complete blocks decompressed by each thread between two
+// progress updates.
+#define VTK_XML_DATA_PARSER_BLOCKS_PER_THREAD 8
+
+//----------------------------------------------------------------------------
+// A read-only mapping of a whole file in memory.
+class vtkXMLDataParser::vtkFileMapping
+{
+public:
+  vtkFileMapping()
+    {
+    this->Data = 0;
+    this->Length = 0;
+#if defined(_WIN32)
+    this->File = INVALID_HANDLE_VALUE;
+    this->Mapping = 0;
+#endif
+    }
+  ~vtkFileMapping() { this->Unmap(); }
+
+  // Map the given file unless it is already mapped.  Returns 0 if it
+  // cannot be mapped, in which case mapping it is not tried again.
+  int Map(const char* fileName)
+    {
+    if(this->FileName == fileName)
+      {
+      return this->Data != 0;
+      }
+    this->Unmap();
+    this->FileName = fileName;
+#if defined(_WIN32)
+    this->File = CreateFileA(fileName, GENERIC_READ, FILE_SHARE_READ, 0,
+                            OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, 0);
+    if(this->File == INVALID_HANDLE_VALUE)
+      {
+      return 0;
+      }
+    LARGE_INTEGER size;
+    if(!GetFileSizeEx(this->File, &size) || size.QuadPart <= 0 ||
+       static_cast<unsigned __int64>(size.QuadPart) !=
+       static_cast<size_t>(size.QuadPart))
+      {
+      this->Unmap();
+      return 0;
+      }
+    this->Mapping = CreateFileMappingA(this->File, 0, PAGE_READONLY,
+                                      0, 0, 0);
+    if(!this->Mapping)
+      {
+      this->Unmap();
+      return 0;
+      }
+    void* data = MapViewOfFile(this->Mapping, FILE_MAP_READ, 0, 0, 0);
+    if(!data)
+      {
+      this->Unmap();
+      return 0;
+      }
+    this->Length = static_cast<OffsetType>(size.QuadPart);
+#else
+    int fd = open(fileName, O_RDONLY);
+    if(fd < 0)
+      {
+      return 0;
+      }
+    struct stat st;
+    if(fstat(fd, &st) != 0 || st.st_size <= 0 ||
+       static_cast<OffsetType>(st.st_size) !=
+       static_cast<OffsetType>(static_cast<size_t>(st.st_size)))
+      {
+      close(fd);
+      return 0;
+      }
+    void* data = mmap(0, static_cast<size_t>(st.st_size), PROT_READ,
+                      MAP_SHARED, fd, 0);
+    close(fd);
+    if(data == MAP_FAILED)
+      {
+      return 0;
+      }
+    this->Length = static_cast<OffsetType>(st.st_size);
+#endif
+    this->Data = static_cast<const unsigned char*>(data);
+    return 1;
+    }
+
+  void Unmap()
+    {
+#if defined(_WIN32)
+    if(this->Data)
+      {
+      UnmapViewOfFile(this->Data);
+      }
+    if(this->Mapping)
+      {
+      CloseHandle(this->Mapping);
+      this->Mapping = 0;
+      }
+    if(this->File != INVALID_HANDLE_VALUE)
+      {
+      CloseHandle(this->File);
+      this->File = INVALID_HANDLE_VALUE;
+      }
+#else
+    if(this->Data)
+      {
+      munmap(const_cast<unsigned char*>(this->Data),
+             static_cast<size_t>(this->Length));
+      }
+#endif
+    this->Data = 0;
+    this->Length = 0;
+    }
+
+  // Unmap the file and forget it, so that it is mapped again if it is
+  // given to Map.
+  void Reset()
+    {
+    this->Unmap();
+    this->FileName = "";
+    }
+
+  vtkstd::string FileName;
+  const unsigned char* Data;
+  OffsetType Length;
+#if defined(_WIN32)
+  HANDLE File;
+  HANDLE Mapping;
+#endif
+};
+
 
 vtkCxxRevisionMacro(vtkXMLDataParser, "$Revision$");
 vtkStandardNewMacro(vtkXMLDataParser);
@@ -48,6 +191,14 @@ vtkXMLDataParser::vtkXMLDataParser()
   this->BlockStartOffsets = 0;
   this->Compressor = 0;
 
+  this->Threader = vtkMultiThreader::New();
+  this->NumberOfThreads = 1;
+
+  this->MappedFileName = 0;
+  this->MappedDataPosition = 0;
+  this->MappedDataLeft = 0;
+  this->FileMapping = new vtkFileMapping;
+
   this->AsciiDataBuffer = 0;
   this->AsciiDataBufferLength = 0;
   this->AsciiDataPosition = 0;
@@ -81,6 +232,34 @@ vtkXMLDataParser::~vtkXMLDataParser()
   if(this->BlockStartOffsets) { delete [] this->BlockStartOffsets; }
   this->SetCompressor(0);
   if(this->AsciiDataBuffer) { this->FreeAsciiBuffer(); }
+  this->Threader->Delete();
+  delete this->FileMapping;
+  this->FileMapping = 0;
+  this->SetMappedFileName(0);
+}
+
+//----------------------------------------------------------------------------
+void vtkXMLDataParser::SetMappedFileName(const char* name)
+{
+  // The file may have changed since it was mapped, even if its name has
+  // not.  Map it again when it is next read.
+  if(this->FileMapping)
+    {
+    this->FileMapping->Reset();
+    }
+  if(this->MappedFileName == name ||
+     (this->MappedFileName && name && strcmp(this->MappedFileName, name) == 0))
+    {
+    return;
+    }
+  delete [] this->MappedFileName;
+  this->MappedFileName = 0;
+  if(name)
+    {
+    this->MappedFileName = new char[strlen(name)+1];
+    strcpy(this->MappedFileName, name);
+    }
+  this->Modified();
 }
 
 //----------------------------------------------------------------------------
@@ -104,6 +283,9 @@ void vtkXMLDataParser::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "Progress: " << this->Progress << "\n";
   os << indent << "Abort: " << this->Abort << "\n";
   os << indent << "AttributesEncoding: " << this->AttributesEncoding << "\n";
+  os << indent << "NumberOfThreads: " << this->NumberOfThreads << "\n";
+  os << indent << "MappedFileName: "
+     << (this->MappedFileName? this->MappedFileName : "(none)") << "\n";
 }
 
 //----------------------------------------------------------------------------
@@ -437,11 +619,13 @@ unsigned long vtkXMLDataParser::GetWordTypeSize(int wordType)
 }
 
 //----------------------------------------------------------------------------
-void vtkXMLDataParser::PerformByteSwap(void* data, OffsetType numWords,
-                                       int wordSize)
+// Swap the bytes of the given words to the order of this machine.
+// Returns 0 if the word size is not supported.
+static int vtkXMLDataParserByteSwap(int bigEndian, void* data,
+                                    vtkIdType numWords, int wordSize)
 {
   char* ptr = static_cast<char*>(data);
-  if(this->ByteOrder == vtkXMLDataParser::BigEndian)
+  if(bigEndian)
     {
     switch (wordSize)
       {
@@ -449,8 +633,7 @@ void vtkXMLDataParser::PerformByteSwap(void* data, OffsetType numWords,
       case 2: vtkByteSwap::Swap2BERange(ptr, numWords); break;
       case 4: vtkByteSwap::Swap4BERange(ptr, numWords); break;
       case 8: vtkByteSwap::Swap8BERange(ptr, numWords); break;
-      default:
-        vtkErrorMacro("Unsupported data type size " << wordSize);
+      default: return 0;
       }
     }
   else
@@ -461,10 +644,22 @@ void vtkXMLDataParser::PerformByteSwap(void* data, OffsetType numWords,
       case 2: vtkByteSwap::Swap2LERange(ptr, numWords); break;
       case 4: vtkByteSwap::Swap4LERange(ptr, numWords); break;
       case 8: vtkByteSwap::Swap8LERange(ptr, numWords); break;
-      default:
-        vtkErrorMacro("Unsupported data type size " << wordSize);
+      default: return 0;
       }
     }
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+void vtkXMLDataParser::PerformByteSwap(void* data, OffsetType numWords,
+                                       int wordSize)
+{
+  if(!vtkXMLDataParserByteSwap(
+       this->ByteOrder == vtkXMLDataParser::BigEndian, data, numWords,
+       wordSize))
+    {
+    vtkErrorMacro("Unsupported data type size " << wordSize);
+    }
 }
 
 //----------------------------------------------------------------------------
@@ -477,7 +672,7 @@ void vtkXMLDataParser::ReadCompressionHeader()
   this->DataStream->StartReading();
 
   // Read the standard part of the header.
-  int r = this->DataStream->Read(buffer, headerSize);
+  int r = this->ReadHeaderData(buffer, headerSize);
   if(r < headerSize)
     {
     vtkErrorMacro("Error reading beginning of compression header.  Read "
@@ -513,7 +708,7 @@ void vtkXMLDataParser::ReadCompressionHeader()
 
     // Read the compressed block sizes.
     unsigned long len = this->NumberOfBlocks*sizeof(HeaderType);
-    if(this->DataStream->Read(buffer, len) < len)
+    if(this->ReadHeaderData(buffer, len) < len)
       {
       vtkErrorMacro("Error reading compression header.");
       return;
@@ -555,6 +750,18 @@ int vtkXMLDataParser::ReadBlock(unsigned int block, unsigned char* buffer)
   OffsetType uncompressedSize = this->FindBlockSize(block);
   unsigned int compressedSize = this->BlockCompressedSizes[block];
 
+  // Decompress directly from the memory mapped file.
+  if(this->MappedDataPosition)
+    {
+    if(this->BlockStartOffsets[block]+compressedSize > this->MappedDataLeft)
+      {
+      return 0;
+      }
+    return this->Compressor->Uncompress(
+      this->MappedDataPosition+this->BlockStartOffsets[block],
+      compressedSize, buffer, uncompressedSize) > 0;
+    }
+
   if(!this->DataStream->Seek(this->BlockStartOffsets[block]))
     {
     return 0;
@@ -589,6 +796,165 @@ unsigned char* vtkXMLDataParser::ReadBlock(unsigned int block)
   return decompressBuffer;
 }
 
+//----------------------------------------------------------------------------
+struct vtkXMLDataParserThreadStruct
+{
+  vtkDataCompressor* Compressor;
+  const unsigned char** CompressedBlocks;
+  unsigned long* CompressedSizes;
+  unsigned int NumberOfBlocks;
+  unsigned long BlockSize;
+  unsigned char* Output;
+  int BigEndian;
+  int WordSize;
+  int* Failed;
+};
+
+//----------------------------------------------------------------------------
+// Decompress a range of the complete blocks into their place in the output
+// and swap their bytes.
+static VTK_THREAD_RETURN_TYPE vtkXMLDataParserDecompressBlocks(void* arg)
+{
+  vtkMultiThreader::ThreadInfo* info =
+    static_cast<vtkMultiThreader::ThreadInfo*>(arg);
+  vtkXMLDataParserThreadStruct* str =
+    static_cast<vtkXMLDataParserThreadStruct*>(info->UserData);
+  unsigned int begin = str->NumberOfBlocks*info->ThreadID/
+    info->NumberOfThreads;
+  unsigned int end = str->NumberOfBlocks*(info->ThreadID+1)/
+    info->NumberOfThreads;
+  for(unsigned int i=begin; i < end; ++i)
+    {
+    unsigned char* output = str->Output +
+      static_cast<vtkIdType>(i)*str->BlockSize;
+    if(str->Compressor->Uncompress(str->CompressedBlocks[i],
+                                   str->CompressedSizes[i],
+                                   output, str->BlockSize) == 0)
+      {
+      str->Failed[info->ThreadID] = 1;
+      break;
+      }
+    vtkXMLDataParserByteSwap(str->BigEndian, output,
+                             str->BlockSize/str->WordSize, str->WordSize);
+    }
+  return VTK_THREAD_RETURN_VALUE;
+}
+
+//----------------------------------------------------------------------------
+int vtkXMLDataParser::ReadBlocks(unsigned int firstBlock,
+                                 unsigned int numBlocks,
+                                 unsigned char* buffer, int wordSize)
+{
+  // The blocks are contiguous in the data.  Find them in the memory
+  // mapped file or read them all at once from the stream.
+  OffsetType start = this->BlockStartOffsets[firstBlock];
+  OffsetType compressedSize = 0;
+  vtkstd::vector<unsigned long> compressedSizes(numBlocks);
+  unsigned int i;
+  for(i=0; i < numBlocks; ++i)
+    {
+    compressedSizes[i] = this->BlockCompressedSizes[firstBlock+i];
+    compressedSize += compressedSizes[i];
+    }
+  const unsigned char* compressed;
+  vtkstd::vector<unsigned char> readBuffer;
+  if(this->MappedDataPosition)
+    {
+    if(start+compressedSize > this->MappedDataLeft)
+      {
+      return 0;
+      }
+    compressed = this->MappedDataPosition+start;
+    }
+  else
+    {
+    if(compressedSize == 0 || !this->DataStream->Seek(start))
+      {
+      return 0;
+      }
+    readBuffer.resize(compressedSize);
+    unsigned long n = static_cast<unsigned long>(compressedSize);
+    if(this->DataStream->Read(&readBuffer[0], n) < n)
+      {
+      return 0;
+      }
+    compressed = &readBuffer[0];
+    }
+  vtkstd::vector<const unsigned char*> compressedBlocks(numBlocks);
+  for(i=0; i < numBlocks; ++i)
+    {
+    compressedBlocks[i] = compressed +
+      (this->BlockStartOffsets[firstBlock+i]-start);
+    }
+
+  // Decompress the blocks concurrently.
+  int numThreads = this->NumberOfThreads;
+  if(static_cast<unsigned int>(numThreads) > numBlocks)
+    {
+    numThreads = static_cast<int>(numBlocks);
+    }
+  vtkstd::vector<int> failed(numThreads, 0);
+  vtkXMLDataParserThreadStruct str;
+  str.Compressor = this->Compressor;
+  str.CompressedBlocks = &compressedBlocks[0];
+  str.CompressedSizes = &compressedSizes[0];
+  str.NumberOfBlocks = numBlocks;
+  str.BlockSize = this->BlockUncompressedSize;
+  str.Output = buffer;
+  str.BigEndian = this->ByteOrder == vtkXMLDataParser::BigEndian;
+  str.WordSize = wordSize;
+  str.Failed = &failed[0];
+  this->Threader->SetNumberOfThreads(numThreads);
+  this->Threader->SetSingleMethod(vtkXMLDataParserDecompressBlocks, &str);
+  this->Threader->SingleMethodExecute();
+
+  for(i=0; i < static_cast<unsigned int>(numThreads); ++i)
+    {
+    if(failed[i])
+      {
+      return 0;
+      }
+    }
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+unsigned long vtkXMLDataParser::ReadHeaderData(unsigned char* data,
+                                               unsigned long length)
+{
+  if(!this->MappedDataPosition)
+    {
+    return this->DataStream->Read(data, length);
+    }
+
+  // Read from the memory mapped file and advance past the data read, as
+  // the stream would.
+  if(static_cast<OffsetType>(length) > this->MappedDataLeft)
+    {
+    length = static_cast<unsigned long>(this->MappedDataLeft);
+    }
+  memcpy(data, this->MappedDataPosition, length);
+  this->MappedDataPosition += length;
+  this->MappedDataLeft -= length;
+  return length;
+}
+
+//----------------------------------------------------------------------------
+int vtkXMLDataParser::MapDataPosition(OffsetType position)
+{
+  this->MappedDataPosition = 0;
+  this->MappedDataLeft = 0;
+  if(!this->MappedFileName ||
+     !this->FileMapping->Map(this->MappedFileName) ||
+     position < 0 || position >= this->FileMapping->Length)
+    {
+    return 0;
+    }
+  this->MappedDataPosition = this->FileMapping->Data+position;
+  this->MappedDataLeft = this->FileMapping->Length-position;
+  return 1;
+}
+
 //----------------------------------------------------------------------------
 vtkXMLDataParser::OffsetType
 vtkXMLDataParser::ReadUncompressedData(unsigned char* data,
@@ -600,7 +966,7 @@ vtkXMLDataParser::ReadUncompressedData(unsigned char* data,
   HeaderType rsize;
   const unsigned long len = sizeof(HeaderType);
   unsigned char* p = reinterpret_cast<unsigned char*>(&rsize);
-  if(this->DataStream->Read(p, len) < len) { return 0; }
+  if(this->ReadHeaderData(p, len) < len) { return 0; }
   this->PerformByteSwap(&rsize, 1, len);
 
   // Adjust the size to be a multiple of the wordSize by taking
@@ -625,7 +991,16 @@ vtkXMLDataParser::ReadUncompressedData(unsigned char* data,
   length = end-offset;
 
   // Read the data.
-  if(!this->DataStream->Seek(offset+len))
+  const unsigned char* mapped = 0;
+  if(this->MappedDataPosition)
+    {
+    if(end > this->MappedDataLeft)
+      {
+      return 0;
+      }
+    mapped = this->MappedDataPosition+offset;
+    }
+  else if(!this->DataStream->Seek(offset+len))
     {
     return 0;
     }
@@ -639,7 +1014,11 @@ vtkXMLDataParser::ReadUncompressedData(unsigned char* data,
     {
     // Read this block.
     long n = (blockSize < left)? blockSize:left;
-    if(!this->DataStream->Read(p, n))
+    if(mapped)
+      {
+      memcpy(p, mapped+(p-data), n);
+      }
+    else if(!this->DataStream->Read(p, n))
       {
       return 0;
       }
@@ -752,18 +1131,30 @@ vtkXMLDataParser::ReadCompressedData(unsigned char* data,
     // Report progress.
     this->UpdateProgress(float(outputPointer-data)/length);
 
+    // The blocks between the first and the last are complete.  Read them
+    // in groups whose blocks are decompressed concurrently.
+    const unsigned int groupSize =
+      VTK_XML_DATA_PARSER_BLOCKS_PER_THREAD*this->NumberOfThreads;
     unsigned int currentBlock = firstBlock+1;
-    for(;currentBlock != lastBlock && !this->Abort; ++currentBlock)
+    while(currentBlock < lastBlock && !this->Abort)
       {
-      // Read this block.
-      if(!this->ReadBlock(currentBlock, outputPointer)) { return 0; }
+      unsigned int numBlocks = lastBlock-currentBlock;
+      if(numBlocks > groupSize)
+        {
+        numBlocks = groupSize;
+        }
 
-      // Byte swap this block.  Note that blockSize will always be an
+      // Read these blocks.  Note that the block size will always be an
       // integer multiple of the word size.
-      this->PerformByteSwap(outputPointer, blockSize / wordSize, wordSize);
+      if(!this->ReadBlocks(currentBlock, numBlocks, outputPointer, wordSize))
+        {
+        return 0;
+        }
 
       // Advance the pointer to the beginning of the next block.
-      outputPointer += this->FindBlockSize(currentBlock);
+      outputPointer +=
+        static_cast<OffsetType>(numBlocks)*this->BlockUncompressedSize;
+      currentBlock += numBlocks;
 
       // Report progress.
       this->UpdateProgress(float(outputPointer-data)/length);
@@ -888,6 +1279,7 @@ vtkXMLDataParser::ReadInlineData(vtkXMLDataElement* element,
                                  int wordType)
 {
   this->DataStream = this->InlineDataStream;
+  this->MappedDataPosition = 0;
   this->SeekInlineDataPosition(element);
   if(isAscii)
     {
@@ -909,6 +1301,16 @@ vtkXMLDataParser::ReadAppendedData(OffsetType offset,
 {
   this->DataStream = this->AppendedDataStream;
   this->SeekG(this->AppendedDataPosition+offset);
+
+  // Raw appended data are read from the memory mapped file if possible.
+  if(this->AppendedDataStream->IsA("vtkBase64InputStream"))
+    {
+    this->MappedDataPosition = 0;
+    }
+  else
+    {
+    this->MapDataPosition(this->AppendedDataPosition+offset);
+    }
   return this->ReadBinaryData(buffer, startWord, numWords, wordType);
 }
 
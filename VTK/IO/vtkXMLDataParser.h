@@ -31,6 +31,7 @@
 
 class vtkInputStream;
 class vtkDataCompressor;
+class vtkMultiThreader;
 
 class VTK_IO_EXPORT vtkXMLDataParser : public vtkXMLParser
 {
@@ -98,6 +99,21 @@ public:
   virtual void SetCompressor(vtkDataCompressor*);
   vtkGetObjectMacro(Compressor, vtkDataCompressor);
 
+  // Description:
+  // Get/Set the number of threads decompressing the blocks of compressed
+  // data concurrently.  The Uncompress method of the compressor must then
+  // be thread-safe, as that of vtkZLibDataCompressor is.  Defaults to 1.
+  vtkSetClampMacro(NumberOfThreads,int,1,VTK_MAX_THREADS);
+  vtkGetMacro(NumberOfThreads,int);
+
+  // Description:
+  // Get/Set the name of the file read by the stream of the parser, if any.
+  // Raw appended data are then read from a memory mapping of the file
+  // instead of through the stream.  The file is mapped again after every
+  // call to SetMappedFileName.
+  virtual void SetMappedFileName(const char*);
+  vtkGetStringMacro(MappedFileName);
+
   // Description:
   // Get the size of a word of the given type.
   unsigned long GetWordTypeSize(int wordType);
@@ -165,6 +181,10 @@ protected:
   unsigned int FindBlockSize(unsigned int block);
   int ReadBlock(unsigned int block, unsigned char* buffer);
   unsigned char* ReadBlock(unsigned int block);
+  int ReadBlocks(unsigned int firstBlock, unsigned int numBlocks,
+                 unsigned char* buffer, int wordSize);
+  unsigned long ReadHeaderData(unsigned char* data, unsigned long length);
+  int MapDataPosition(OffsetType position);
   OffsetType ReadUncompressedData(unsigned char* data,
                                   OffsetType startWord,
                                   OffsetType numWords,
@@ -234,6 +254,17 @@ protected:
   HeaderType* BlockCompressedSizes;
   OffsetType* BlockStartOffsets;
 
+  // Threads decompressing the complete blocks.
+  vtkMultiThreader* Threader;
+  int NumberOfThreads;
+
+  // The file mapped in memory, the position of the data being read in the
+  // mapping and the number of bytes from there to the end of the file.  The
+  // position is 0 when the data are read through the stream.
+  char* MappedFileName;
+  const unsigned char* MappedDataPosition;
+  OffsetType MappedDataLeft;
+
   // Ascii data parsing.
   unsigned char* AsciiDataBuffer;
   OffsetType AsciiDataBufferLength;
@@ -249,6 +280,11 @@ protected:
   int AttributesEncoding;
 
 private:
+  //BTX
+  class vtkFileMapping;
+  //ETX
+  vtkFileMapping* FileMapping;
+
   vtkXMLDataParser(const vtkXMLDataParser&);  // Not implemented.
   void operator=(const vtkXMLDataParser&);  // Not implemented.
 };
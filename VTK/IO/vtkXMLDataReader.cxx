@@ -18,6 +18,7 @@
 #include "vtkCallbackCommand.h"
 #include "vtkCellData.h"
 #include "vtkDataArray.h"
+#include "vtkDataArrayCache.h"
 #include "vtkDataArraySelection.h"
 #include "vtkDataSet.h"
 #include "vtkPointData.h"
@@ -29,6 +30,9 @@
 
 #include "assert.h"
 
+// The size in bytes of the smallest reads kept in vtkDataArrayCache.
+#define VTK_XML_DATA_READER_MIN_CACHED_SIZE 65536
+
 vtkCxxRevisionMacro(vtkXMLDataReader, "$Revision$");
 
 //----------------------------------------------------------------------------
@@ -757,6 +761,31 @@ int vtkXMLDataReader::ReadArrayValues(vtkXMLDataElement* da, vtkIdType arrayInde
     {
     return 0;
     }
+  // Copy the values from the array cache if they were read before.  Small
+  // reads, such as the rows of a structured sub-extent, are not cached.
+  vtkDataArray* dataArray = vtkDataArray::SafeDownCast(array);
+  vtkDataArrayCache* cache = vtkDataArrayCache::GetInstance();
+  vtkDataArrayCacheKey key;
+  double size = dataArray? numValues*dataArray->GetDataTypeSize() : 0.0;
+  int useCache = (dataArray && dataArray->GetDataType() != VTK_BIT &&
+                  this->FileName &&
+                  size >= VTK_XML_DATA_READER_MIN_CACHED_SIZE &&
+                  cache->CanInsert(size/1048576.0));
+  if(useCache)
+    {
+    key.SetSourceToFile(this->FileName);
+    key.Name = da->GetAttribute("Name")? da->GetAttribute("Name") : "";
+    key.AddId(da->GetXMLByteIndex()).AddId(startIndex).AddId(numValues);
+    vtkSmartPointer<vtkDataArray> cached = cache->Find(key);
+    if(cached && cached->GetDataType() == dataArray->GetDataType())
+      {
+      memcpy(dataArray->GetVoidPointer(arrayIndex),
+             cached->GetVoidPointer(0),
+             numValues*dataArray->GetDataTypeSize());
+      return 1;
+      }
+    }
+
   this->InReadData = 1;
   int result;
   // All arrays types except vtkBitArray.
@@ -774,6 +803,17 @@ int vtkXMLDataReader::ReadArrayValues(vtkXMLDataElement* da, vtkIdType arrayInde
     iter->Delete();
     }
   this->InReadData = 0;
+
+  // Keep a copy of the values read in the array cache.
+  if(useCache && result)
+    {
+    vtkDataArray* copy = dataArray->NewInstance();
+    copy->SetNumberOfTuples(numValues);
+    memcpy(copy->GetVoidPointer(0), dataArray->GetVoidPointer(arrayIndex),
+           numValues*dataArray->GetDataTypeSize());
+    cache->Insert(key, copy);
+    copy->Delete();
+    }
   return result;
 }
 
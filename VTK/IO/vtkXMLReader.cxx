@@ -82,6 +82,7 @@ static void ReadStringVersion(const char* version, int& major, int& minor)
 vtkXMLReader::vtkXMLReader()
 {
   this->FileName = 0;
+  this->NumberOfThreads = 1;
   this->Stream = 0;
   this->FileStream = 0;
   this->XMLParser = 0;
@@ -164,6 +165,7 @@ void vtkXMLReader::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "NumberOfTimeSteps:" << this->NumberOfTimeSteps << "\n";
   os << indent << "TimeStepRange:(" << this->TimeStepRange[0] << "," 
                                     << this->TimeStepRange[1] << ")\n";
+  os << indent << "NumberOfThreads: " << this->NumberOfThreads << "\n";
 }
 
 //----------------------------------------------------------------------------
@@ -506,6 +508,11 @@ int vtkXMLReader::RequestData(vtkInformation *vtkNotUsed(request),
   
   (*this->Stream).imbue(vtkstd::locale::classic());
   this->XMLParser->SetStream(this->Stream);
+
+  // Let the parser map the file in memory to read raw appended data.
+  this->XMLParser->SetMappedFileName(
+    this->Stream == this->FileStream? this->FileName : 0);
+  this->XMLParser->SetNumberOfThreads(this->NumberOfThreads);
   
   // We are just starting to read.  Do not call UpdateProgressDiscrete
   // because we want a 0 progress callback the first time.
@@ -95,6 +95,13 @@ public:
   vtkGetVector2Macro(TimeStepRange, int);
   vtkSetVector2Macro(TimeStepRange, int);
 
+  // Description:
+  // Get/Set the number of threads decompressing the compressed data
+  // concurrently (see vtkXMLDataParser::SetNumberOfThreads).  Defaults to
+  // 1, as readers often run on every core already, one per process.
+  vtkSetClampMacro(NumberOfThreads, int, 1, VTK_MAX_THREADS);
+  vtkGetMacro(NumberOfThreads, int);
+
 protected:
   vtkXMLReader();
   ~vtkXMLReader();
@@ -194,6 +201,9 @@ protected:
 
   // The input file's name.
   char* FileName;
+
+  // The number of threads decompressing the data.
+  int NumberOfThreads;
   
   // The stream used to read the input.
   istream* Stream;
@@ -0,0 +1,45 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    $RCSfile$
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Run TestPOpenFOAMReader on all the MPI processes, so that the processor
+// subdirectories are assigned to several processes.
+
+#include <mpi.h>
+
+#include "vtkMPIController.h"
+#include "vtkSmartPointer.h"
+
+int TestPOpenFOAMReader(int argc, char *argv[]);
+
+int main(int argc, char *argv[])
+{
+  // This is here to avoid false leak messages from vtkDebugLeaks when
+  // using mpich. It appears that the root process which spawns all the
+  // main processes waits in MPI_Init() and calls exit() when
+  // the others are done, causing apparent memory leaks for any objects
+  // created before MPI_Init().
+  MPI_Init(&argc, &argv);
+
+  vtkSmartPointer<vtkMPIController> controller =
+    vtkSmartPointer<vtkMPIController>::New();
+  controller->Initialize(&argc, &argv, 1);
+  vtkMultiProcessController::SetGlobalController(controller);
+
+  int retVal = TestPOpenFOAMReader(argc, argv);
+
+  vtkMultiProcessController::SetGlobalController(NULL);
+  controller->Finalize();
+
+  return retVal;
+}
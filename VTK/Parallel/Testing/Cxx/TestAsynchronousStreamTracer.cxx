@@ -0,0 +1,214 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    $RCSfile$
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Integrate streamlines crossing the pieces of an image distributed on all
+// the processes with vtkDistributedStreamTracer and with
+// vtkAsynchronousStreamTracer, check that the streamlines are the same and
+// report the time both take. Then check that vtkAsynchronousStreamTracer
+// integrates on the other processes when one piece has no cells.
+
+#include <mpi.h>
+
+#include "vtkAsynchronousStreamTracer.h"
+#include "vtkDistributedStreamTracer.h"
+#include "vtkFloatArray.h"
+#include "vtkImageData.h"
+#include "vtkMath.h"
+#include "vtkMPIController.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkSmartPointer.h"
+#include "vtkTimerLog.h"
+
+static const int PieceSize = 16;
+static const double Spacing = 0.25;
+
+// The piece of the image of the process, along x, of size cells in each
+// direction, or empty if size is negative.  The vectors go along x and
+// swirl around it.
+static vtkSmartPointer<vtkImageData> MakePiece(int myId, int size)
+{
+  vtkSmartPointer<vtkImageData> image = vtkSmartPointer<vtkImageData>::New();
+  image->SetExtent(myId*PieceSize, myId*PieceSize + size,
+                   0, size, 0, size);
+  image->SetSpacing(Spacing, Spacing, Spacing);
+  vtkSmartPointer<vtkFloatArray> vectors =
+    vtkSmartPointer<vtkFloatArray>::New();
+  vectors->SetName("Vectors");
+  vectors->SetNumberOfComponents(3);
+  vectors->SetNumberOfTuples(image->GetNumberOfPoints());
+  double center = 0.5*PieceSize*Spacing;
+  for (vtkIdType i = 0; i < image->GetNumberOfPoints(); i++)
+    {
+    double x[3];
+    image->GetPoint(i, x);
+    vectors->SetTuple3(i, 1.0 + 0.5*sin(x[0]),
+                       -(x[2] - center), x[1] - center);
+    }
+  image->GetPointData()->SetVectors(vectors);
+  return image;
+}
+
+// Seeds spread over the whole domain, the same on all the processes.
+// They are away from the boundaries of the pieces, where the process
+// integrating them would depend on the order of the integration.
+static vtkSmartPointer<vtkPolyData> MakeSeeds(int numProcs)
+{
+  vtkSmartPointer<vtkPoints> points = vtkSmartPointer<vtkPoints>::New();
+  vtkMath::RandomSeed(1234);
+  double length = PieceSize*Spacing;
+  for (int i = 0; i < 200; i++)
+    {
+    double x = (i % numProcs + vtkMath::Random(0.2, 0.8))*length;
+    points->InsertNextPoint(x,
+                            vtkMath::Random(0.2*length, 0.8*length),
+                            vtkMath::Random(0.2*length, 0.8*length));
+    }
+  vtkSmartPointer<vtkPolyData> seeds = vtkSmartPointer<vtkPolyData>::New();
+  seeds->SetPoints(points);
+  return seeds;
+}
+
+// Number of points of the streamlines and sum of their coordinates, which
+// do not depend on the order of the streamlines.
+static void Summarize(vtkPolyData* output, double summary[4])
+{
+  summary[0] = output->GetNumberOfPoints();
+  summary[1] = summary[2] = summary[3] = 0.0;
+  for (vtkIdType i = 0; i < output->GetNumberOfPoints(); i++)
+    {
+    double* x = output->GetPoint(i);
+    summary[1] += x[0];
+    summary[2] += x[1];
+    summary[3] += x[2];
+    }
+}
+
+struct AsynchronousStreamTracerArgs
+{
+  int* retVal;
+};
+
+// This will be called by all processes
+void MyMain(vtkMultiProcessController *controller, void *arg)
+{
+  AsynchronousStreamTracerArgs* args =
+    reinterpret_cast<AsynchronousStreamTracerArgs*>(arg);
+
+  int myId = controller->GetLocalProcessId();
+  int numProcs = controller->GetNumberOfProcesses();
+
+  vtkSmartPointer<vtkImageData> piece = MakePiece(myId, PieceSize);
+  vtkSmartPointer<vtkPolyData> seeds = MakeSeeds(numProcs);
+
+  vtkSmartPointer<vtkDistributedStreamTracer> distributed =
+    vtkSmartPointer<vtkDistributedStreamTracer>::New();
+  vtkSmartPointer<vtkAsynchronousStreamTracer> asynchronous =
+    vtkSmartPointer<vtkAsynchronousStreamTracer>::New();
+  vtkDistributedStreamTracer* tracers[2] = { distributed, asynchronous };
+  double summaries[2][4];
+  vtkSmartPointer<vtkTimerLog> timer = vtkSmartPointer<vtkTimerLog>::New();
+  for (int i = 0; i < 2; i++)
+    {
+    vtkDistributedStreamTracer* tracer = tracers[i];
+    tracer->SetController(controller);
+    tracer->SetInput(piece);
+    tracer->SetSource(seeds);
+    tracer->SetIntegrationDirectionToBoth();
+    tracer->SetIntegratorTypeToRungeKutta45();
+    tracer->SetMaximumPropagation(100.0);
+    tracer->SetMaximumNumberOfSteps(2000);
+
+    controller->Barrier();
+    timer->StartTimer();
+    tracer->Update();
+    controller->Barrier();
+    timer->StopTimer();
+    if (myId == 0)
+      {
+      cout << tracer->GetClassName() << ": " << timer->GetElapsedTime()
+           << "s" << endl;
+      }
+    Summarize(tracer->GetOutput(), summaries[i]);
+    }
+
+  int failed = 0;
+  if (summaries[0][0] == 0 || summaries[0][0] != summaries[1][0])
+    {
+    cerr << "Process " << myId << " has " << summaries[1][0]
+         << " streamline points instead of " << summaries[0][0] << endl;
+    failed = 1;
+    }
+  for (int j = 1; j < 4; j++)
+    {
+    if (fabs(summaries[0][j] - summaries[1][j]) >
+        1e-6*(1.0 + fabs(summaries[0][j])))
+      {
+      cerr << "Process " << myId << " has different streamline points."
+           << endl;
+      failed = 1;
+      }
+    }
+
+  // The piece of the last process is empty, the streamlines of the
+  // seeds in the other pieces stop at its boundary.
+  if (numProcs > 1)
+    {
+    int last = (myId == numProcs - 1);
+    vtkSmartPointer<vtkAsynchronousStreamTracer> tracer =
+      vtkSmartPointer<vtkAsynchronousStreamTracer>::New();
+    tracer->SetController(controller);
+    tracer->SetInput(last ? MakePiece(myId, -1) : piece);
+    tracer->SetSource(MakeSeeds(numProcs - 1));
+    tracer->SetIntegrationDirectionToBoth();
+    tracer->SetIntegratorTypeToRungeKutta45();
+    tracer->SetMaximumPropagation(100.0);
+    tracer->SetMaximumNumberOfSteps(2000);
+    tracer->Update();
+    vtkIdType numPoints = tracer->GetOutput()->GetNumberOfPoints();
+    if (last ? numPoints != 0 : numPoints == 0)
+      {
+      cerr << "Process " << myId << " has " << numPoints
+           << " streamline points with an empty last piece." << endl;
+      failed = 1;
+      }
+    }
+  controller->AllReduce(&failed, args->retVal, 1, vtkCommunicator::MAX_OP);
+}
+
+int main(int argc, char **argv)
+{
+  // This is here to avoid false leak messages from vtkDebugLeaks when
+  // using mpich. It appears that the root process which spawns all the
+  // main processes waits in MPI_Init() and calls exit() when
+  // the others are done, causing apparent memory leaks for any objects
+  // created before MPI_Init().
+  MPI_Init(&argc, &argv);
+
+  vtkMPIController* controller = vtkMPIController::New();
+  controller->Initialize(&argc, &argv, 1);
+
+  int retVal = 1;
+  AsynchronousStreamTracerArgs args;
+  args.retVal = &retVal;
+
+  controller->SetSingleMethod(MyMain, &args);
+  controller->SingleMethodExecute();
+
+  controller->Finalize();
+  controller->Delete();
+
+  return retVal;
+}
@@ -0,0 +1,225 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    $RCSfile$
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Round trips data sets through vtkCommunicator::MarshalDataObject and
+// vtkCommunicator::UnMarshalDataObject and checks that the binary format
+// reproduces the structure and the arrays.
+
+#include "vtkCellArray.h"
+#include "vtkCellData.h"
+#include "vtkCharArray.h"
+#include "vtkCommunicator.h"
+#include "vtkDataObjectMarshaller.h"
+#include "vtkDoubleArray.h"
+#include "vtkFloatArray.h"
+#include "vtkIdTypeArray.h"
+#include "vtkImageData.h"
+#include "vtkIntArray.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkRectilinearGrid.h"
+#include "vtkSmartPointer.h"
+#include "vtkSphereSource.h"
+#include "vtkUnsignedCharArray.h"
+#include "vtkUnstructuredGrid.h"
+
+#define VTK_CREATE(type, name) \
+  vtkSmartPointer<type> name = vtkSmartPointer<type>::New()
+
+static int CompareArrays(vtkDataArray* a, vtkDataArray* b)
+{
+  if (!a || !b)
+    {
+    return (a == b);
+    }
+  if (a->GetDataType() != b->GetDataType() ||
+    a->GetNumberOfComponents() != b->GetNumberOfComponents() ||
+    a->GetNumberOfTuples() != b->GetNumberOfTuples())
+    {
+    cerr << "Array layout mismatch." << endl;
+    return 0;
+    }
+  if ((a->GetName() == 0) != (b->GetName() == 0) ||
+    (a->GetName() && strcmp(a->GetName(), b->GetName()) != 0))
+    {
+    cerr << "Array name mismatch." << endl;
+    return 0;
+    }
+  vtkIdType numBytes = a->GetNumberOfTuples() * a->GetNumberOfComponents() *
+    a->GetDataTypeSize();
+  if (numBytes > 0 &&
+    memcmp(a->GetVoidPointer(0), b->GetVoidPointer(0), numBytes) != 0)
+    {
+    cerr << "Array values mismatch." << endl;
+    return 0;
+    }
+  return 1;
+}
+
+static int CompareAttributes(vtkDataSetAttributes* a, vtkDataSetAttributes* b)
+{
+  if (a->GetNumberOfArrays() != b->GetNumberOfArrays())
+    {
+    cerr << "Number of arrays mismatch." << endl;
+    return 0;
+    }
+  for (int cc = 0; cc < a->GetNumberOfArrays(); cc++)
+    {
+    if (!CompareArrays(a->GetArray(cc), b->GetArray(cc)))
+      {
+      return 0;
+      }
+    }
+  return CompareArrays(a->GetScalars(), b->GetScalars()) &&
+    CompareArrays(a->GetNormals(), b->GetNormals());
+}
+
+static int RoundTrip(vtkDataSet* source, vtkDataSet* result)
+{
+  if (!vtkDataObjectMarshaller::CanMarshal(source))
+    {
+    cerr << source->GetClassName() << " should use the binary format." << endl;
+    return 0;
+    }
+
+  VTK_CREATE(vtkCharArray, buffer);
+  if (!vtkCommunicator::MarshalDataObject(source, buffer) ||
+    !vtkDataObjectMarshaller::IsMarshaledBuffer(buffer->GetPointer(0),
+      buffer->GetNumberOfTuples()) ||
+    !vtkCommunicator::UnMarshalDataObject(buffer, result))
+    {
+    cerr << "Failed to marshal " << source->GetClassName() << endl;
+    return 0;
+    }
+
+  if (source->GetNumberOfPoints() != result->GetNumberOfPoints() ||
+    source->GetNumberOfCells() != result->GetNumberOfCells())
+    {
+    cerr << "Point or cell counts of " << source->GetClassName()
+         << " do not agree." << endl;
+    return 0;
+    }
+  for (vtkIdType cellId = 0; cellId < source->GetNumberOfCells(); cellId++)
+    {
+    if (source->GetCellType(cellId) != result->GetCellType(cellId))
+      {
+      cerr << "Cell types do not agree." << endl;
+      return 0;
+      }
+    }
+  double b1[6], b2[6];
+  source->GetBounds(b1);
+  result->GetBounds(b2);
+  for (int i = 0; i < 6; i++)
+    {
+    if (b1[i] != b2[i])
+      {
+      cerr << "Bounds do not agree." << endl;
+      return 0;
+      }
+    }
+  return CompareAttributes(source->GetPointData(), result->GetPointData()) &&
+    CompareAttributes(source->GetCellData(), result->GetCellData()) &&
+    CompareArrays(source->GetFieldData()->GetArray(0),
+      result->GetFieldData()->GetArray(0));
+}
+
+int TestDataObjectMarshaller(int, char*[])
+{
+  int retVal = 1;
+
+  VTK_CREATE(vtkIntArray, fieldArray);
+  fieldArray->SetName("FieldValues");
+  fieldArray->InsertNextValue(42);
+  fieldArray->InsertNextValue(-7);
+
+  // vtkPolyData with normals and field data.
+  VTK_CREATE(vtkSphereSource, sphere);
+  sphere->SetThetaResolution(16);
+  sphere->SetPhiResolution(16);
+  sphere->Update();
+  VTK_CREATE(vtkPolyData, sphereCopy);
+  sphereCopy->ShallowCopy(sphere->GetOutput());
+  sphereCopy->GetFieldData()->AddArray(fieldArray);
+  VTK_CREATE(vtkPolyData, polyResult);
+  retVal &= RoundTrip(sphereCopy, polyResult);
+
+  // vtkUnstructuredGrid with mixed cells and cell data.
+  VTK_CREATE(vtkUnstructuredGrid, ug);
+  VTK_CREATE(vtkPoints, points);
+  points->InsertNextPoint(0, 0, 0);
+  points->InsertNextPoint(1, 0, 0);
+  points->InsertNextPoint(0, 1, 0);
+  points->InsertNextPoint(0, 0, 1);
+  points->InsertNextPoint(1, 1, 1);
+  ug->SetPoints(points);
+  ug->Allocate(2);
+  vtkIdType tet[4] = {0, 1, 2, 3};
+  vtkIdType tri[3] = {1, 2, 4};
+  ug->InsertNextCell(VTK_TETRA, 4, tet);
+  ug->InsertNextCell(VTK_TRIANGLE, 3, tri);
+  VTK_CREATE(vtkDoubleArray, cellScalars);
+  cellScalars->SetName("CellScalars");
+  cellScalars->InsertNextValue(1.5);
+  cellScalars->InsertNextValue(2.5);
+  ug->GetCellData()->SetScalars(cellScalars);
+  ug->GetFieldData()->AddArray(fieldArray);
+  VTK_CREATE(vtkUnstructuredGrid, ugResult);
+  retVal &= RoundTrip(ug, ugResult);
+
+  // vtkImageData with a non trivial extent, origin and spacing.
+  VTK_CREATE(vtkImageData, image);
+  image->SetExtent(-2, 5, 1, 4, 0, 3);
+  image->SetOrigin(0.5, -1.0, 2.0);
+  image->SetSpacing(0.25, 0.5, 2.0);
+  VTK_CREATE(vtkFloatArray, imageScalars);
+  imageScalars->SetName("ImageScalars");
+  imageScalars->SetNumberOfTuples(image->GetNumberOfPoints());
+  for (vtkIdType i = 0; i < image->GetNumberOfPoints(); i++)
+    {
+    imageScalars->SetValue(i, static_cast<float>(i) * 0.5f);
+    }
+  image->GetPointData()->SetScalars(imageScalars);
+  image->GetFieldData()->AddArray(fieldArray);
+  VTK_CREATE(vtkImageData, imageResult);
+  retVal &= RoundTrip(image, imageResult);
+  int* ext = imageResult->GetExtent();
+  if (ext[0] != -2 || ext[1] != 5 || ext[2] != 1 || ext[5] != 3)
+    {
+    cerr << "Image extent was not transmitted." << endl;
+    retVal = 0;
+    }
+
+  // vtkRectilinearGrid.
+  VTK_CREATE(vtkRectilinearGrid, rg);
+  rg->SetExtent(0, 2, 0, 1, 0, 0);
+  VTK_CREATE(vtkDoubleArray, xCoords);
+  xCoords->InsertNextValue(0.0);
+  xCoords->InsertNextValue(1.0);
+  xCoords->InsertNextValue(3.0);
+  VTK_CREATE(vtkDoubleArray, yCoords);
+  yCoords->InsertNextValue(0.0);
+  yCoords->InsertNextValue(2.0);
+  VTK_CREATE(vtkDoubleArray, zCoords);
+  zCoords->InsertNextValue(0.0);
+  rg->SetXCoordinates(xCoords);
+  rg->SetYCoordinates(yCoords);
+  rg->SetZCoordinates(zCoords);
+  rg->GetFieldData()->AddArray(fieldArray);
+  VTK_CREATE(vtkRectilinearGrid, rgResult);
+  retVal &= RoundTrip(rg, rgResult);
+
+  return !retVal;
+}
@@ -0,0 +1,522 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    $RCSfile$
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Write a decomposed OpenFOAM case of boxes of hexahedra in ASCII, read it
+// with one and with several threads, and check the points and the cell
+// fields against the values written.  On several processes, also check
+// that the processor subdirectories are balanced among the processes.
+
+#include "vtkCell.h"
+#include "vtkCellData.h"
+#include "vtkCellType.h"
+#include "vtkDataArray.h"
+#include "vtkMultiBlockDataSet.h"
+#include "vtkMultiProcessController.h"
+#include "vtkPOpenFOAMReader.h"
+#include "vtkSmartPointer.h"
+#include "vtkTestUtilities.h"
+#include "vtkUnstructuredGrid.h"
+
+#include <vtksys/SystemTools.hxx>
+#include <vtkstd/algorithm>
+#include <vtkstd/string>
+#include <vtkstd/vector>
+
+#include <math.h>
+#include <stdio.h>
+
+static const int NumberOfProcessors = 5;
+static const int NY = 12;
+static const int NZ = 12;
+
+// The processors have boxes of increasing lengths, side by side along x.
+static int GetNX(int proc)
+{
+  return 4 + 6 * proc;
+}
+
+static int GetX0(int proc)
+{
+  int x0 = 0;
+  for (int p = 0; p < proc; p++)
+    {
+    x0 += GetNX(p);
+    }
+  return x0;
+}
+
+static double PointX(int i)
+{
+  return 0.37 * i - 1.5;
+}
+
+static double CellT(int i, int j, int k)
+{
+  return 1.0e-3 * (i + 1) - 0.5 * j + 2.25 * k;
+}
+
+static void WriteHeader(FILE *f, const char *className, const char *object)
+{
+  fprintf(f, "FoamFile\n{\n    version 2.0;\n    format ascii;\n"
+          "    class %s;\n    object %s;\n}\n\n", className, object);
+}
+
+static void WriteFace(FILE *f, int a, int b, int c, int d)
+{
+  fprintf(f, "4(%d %d %d %d)\n", a, b, c, d);
+}
+
+static bool WriteProcessor(const vtkstd::string &casePath, int proc)
+{
+  const int nx = GetNX(proc);
+  const int x0 = GetX0(proc);
+  char procName[32];
+  sprintf(procName, "/processor%d", proc);
+  const vtkstd::string procPath = casePath + procName;
+  const vtkstd::string meshPath = procPath + "/constant/polyMesh";
+  if (!vtksys::SystemTools::MakeDirectory(meshPath.c_str()) ||
+      !vtksys::SystemTools::MakeDirectory((procPath + "/0").c_str()))
+    {
+    return false;
+    }
+
+#define PID(i, j, k) ((i) + (nx + 1) * ((j) + (NY + 1) * (k)))
+#define CID(i, j, k) ((i) + nx * ((j) + NY * (k)))
+  FILE *f = fopen((meshPath + "/points").c_str(), "w");
+  if (!f)
+    {
+    return false;
+    }
+  WriteHeader(f, "vectorField", "points");
+  fprintf(f, "%d\n(\n", (nx + 1) * (NY + 1) * (NZ + 1));
+  for (int k = 0; k <= NZ; k++)
+    {
+    for (int j = 0; j <= NY; j++)
+      {
+      for (int i = 0; i <= nx; i++)
+        {
+        fprintf(f, "(%.9g %d %+.3e)\n", PointX(x0 + i), j, 1.0 * k);
+        }
+      }
+    }
+  fprintf(f, ")\n");
+  fclose(f);
+
+  // The internal faces in upper triangular order, then the boundary
+  // faces, all with the normals pointing out of their owners.
+  FILE *faces = fopen((meshPath + "/faces").c_str(), "w");
+  FILE *owner = fopen((meshPath + "/owner").c_str(), "w");
+  FILE *neighbour = fopen((meshPath + "/neighbour").c_str(), "w");
+  if (!faces || !owner || !neighbour)
+    {
+    return false;
+    }
+  const int nInternal = (nx - 1) * NY * NZ + nx * (NY - 1) * NZ +
+    nx * NY * (NZ - 1);
+  const int nBoundary = 2 * (NY * NZ + nx * NZ + nx * NY);
+  WriteHeader(faces, "faceList", "faces");
+  WriteHeader(owner, "labelList", "owner");
+  WriteHeader(neighbour, "labelList", "neighbour");
+  fprintf(faces, "%d\n(\n", nInternal + nBoundary);
+  fprintf(owner, "%d\n(\n", nInternal + nBoundary);
+  fprintf(neighbour, "%d\n(\n", nInternal);
+  for (int k = 0; k < NZ; k++)
+    {
+    for (int j = 0; j < NY; j++)
+      {
+      for (int i = 0; i < nx; i++)
+        {
+        if (i + 1 < nx)
+          {
+          WriteFace(faces, PID(i+1, j, k), PID(i+1, j+1, k),
+                    PID(i+1, j+1, k+1), PID(i+1, j, k+1));
+          fprintf(owner, "%d\n", CID(i, j, k));
+          fprintf(neighbour, "%d\n", CID(i+1, j, k));
+          }
+        if (j + 1 < NY)
+          {
+          WriteFace(faces, PID(i, j+1, k), PID(i, j+1, k+1),
+                    PID(i+1, j+1, k+1), PID(i+1, j+1, k));
+          fprintf(owner, "%d\n", CID(i, j, k));
+          fprintf(neighbour, "%d\n", CID(i, j+1, k));
+          }
+        if (k + 1 < NZ)
+          {
+          WriteFace(faces, PID(i, j, k+1), PID(i+1, j, k+1),
+                    PID(i+1, j+1, k+1), PID(i, j+1, k+1));
+          fprintf(owner, "%d\n", CID(i, j, k));
+          fprintf(neighbour, "%d\n", CID(i, j, k+1));
+          }
+        }
+      }
+    }
+  for (int k = 0; k < NZ; k++)
+    {
+    for (int j = 0; j < NY; j++)
+      {
+      WriteFace(faces, PID(0, j, k), PID(0, j, k+1), PID(0, j+1, k+1),
+                PID(0, j+1, k));
+      WriteFace(faces, PID(nx, j, k), PID(nx, j+1, k), PID(nx, j+1, k+1),
+                PID(nx, j, k+1));
+      fprintf(owner, "%d\n%d\n", CID(0, j, k), CID(nx-1, j, k));
+      }
+    }
+  for (int k = 0; k < NZ; k++)
+    {
+    for (int i = 0; i < nx; i++)
+      {
+      WriteFace(faces, PID(i, 0, k), PID(i+1, 0, k), PID(i+1, 0, k+1),
+                PID(i, 0, k+1));
+      WriteFace(faces, PID(i, NY, k), PID(i, NY, k+1), PID(i+1, NY, k+1),
+                PID(i+1, NY, k));
+      fprintf(owner, "%d\n%d\n", CID(i, 0, k), CID(i, NY-1, k));
+      }
+    }
+  for (int j = 0; j < NY; j++)
+    {
+    for (int i = 0; i < nx; i++)
+      {
+      WriteFace(faces, PID(i, j, 0), PID(i, j+1, 0), PID(i+1, j+1, 0),
+                PID(i+1, j, 0));
+      WriteFace(faces, PID(i, j, NZ), PID(i+1, j, NZ), PID(i+1, j+1, NZ),
+                PID(i, j+1, NZ));
+      fprintf(owner, "%d\n%d\n", CID(i, j, 0), CID(i, j, NZ-1));
+      }
+    }
+  fprintf(faces, ")\n");
+  fprintf(owner, ")\n");
+  fprintf(neighbour, ")\n");
+  fclose(faces);
+  fclose(owner);
+  fclose(neighbour);
+
+  f = fopen((meshPath + "/boundary").c_str(), "w");
+  if (!f)
+    {
+    return false;
+    }
+  WriteHeader(f, "polyBoundaryMesh", "boundary");
+  fprintf(f, "1\n(\n    walls\n    {\n        type wall;\n"
+          "        nFaces %d;\n        startFace %d;\n    }\n)\n",
+          nBoundary, nInternal);
+  fclose(f);
+
+  // A scalar field with a comment within the list, and a vector field.
+  f = fopen((procPath + "/0/T").c_str(), "w");
+  if (!f)
+    {
+    return false;
+    }
+  WriteHeader(f, "volScalarField", "T");
+  fprintf(f, "dimensions [0 0 0 1 0 0 0];\n\n"
+          "internalField nonuniform List<scalar>\n%d\n(\n", nx * NY * NZ);
+  for (int k = 0; k < NZ; k++)
+    {
+    for (int j = 0; j < NY; j++)
+      {
+      for (int i = 0; i < nx; i++)
+        {
+        fprintf(f, "%.9g\n", CellT(x0 + i, j, k));
+        }
+      }
+    if (k == NZ / 2)
+      {
+      fprintf(f, "// half way\n");
+      }
+    }
+  fprintf(f, ");\n\nboundaryField\n{\n    walls\n    {\n"
+          "        type zeroGradient;\n    }\n}\n");
+  fclose(f);
+
+  f = fopen((procPath + "/0/U").c_str(), "w");
+  if (!f)
+    {
+    return false;
+    }
+  WriteHeader(f, "volVectorField", "U");
+  fprintf(f, "dimensions [0 1 -1 0 0 0 0];\n\n"
+          "internalField nonuniform List<vector>\n%d\n(\n", nx * NY * NZ);
+  for (int k = 0; k < NZ; k++)
+    {
+    for (int j = 0; j < NY; j++)
+      {
+      for (int i = 0; i < nx; i++)
+        {
+        fprintf(f, "(%d %.9g /* z */ %d)\n", x0 + i,
+                CellT(x0 + i, j, k), -k);
+        }
+      }
+    }
+  fprintf(f, ");\n\nboundaryField\n{\n    walls\n    {\n"
+          "        type zeroGradient;\n    }\n}\n");
+  fclose(f);
+#undef PID
+#undef CID
+  return true;
+}
+
+static bool WriteCase(const vtkstd::string &casePath)
+{
+  vtksys::SystemTools::RemoveADirectory(casePath.c_str());
+  if (!vtksys::SystemTools::MakeDirectory((casePath + "/system").c_str()))
+    {
+    return false;
+    }
+  FILE *f = fopen((casePath + "/system/controlDict").c_str(), "w");
+  if (!f)
+    {
+    return false;
+    }
+  WriteHeader(f, "dictionary", "controlDict");
+  fprintf(f, "application icoFoam;\nstartTime 0;\nendTime 1;\n"
+          "deltaT 1;\nwriteControl timeStep;\nwriteInterval 1;\n");
+  fclose(f);
+  for (int proc = 0; proc < NumberOfProcessors; proc++)
+    {
+    if (!WriteProcessor(casePath, proc))
+      {
+      return false;
+      }
+    }
+  return true;
+}
+
+// Check the internal mesh against the values written. The processors
+// assigned to this process are appended in order; mark them in found.
+static bool CheckInternalMesh(vtkUnstructuredGrid *mesh, int *found)
+{
+  for (int proc = 0; proc < NumberOfProcessors; proc++)
+    {
+    found[proc] = 0;
+    }
+  vtkDataArray *t = mesh ? mesh->GetCellData()->GetArray("T") : 0;
+  vtkDataArray *u = mesh ? mesh->GetCellData()->GetArray("U") : 0;
+  if (!t || !u || mesh->GetNumberOfCells() == 0)
+    {
+    cerr << "Missing cells or cell fields." << endl;
+    return false;
+    }
+  vtkIdType cellId = 0;
+  int lastProc = -1;
+  while (cellId < mesh->GetNumberOfCells())
+    {
+    // the first cell of a processor is at its smallest x
+    int proc = lastProc + 1;
+    while (proc < NumberOfProcessors &&
+           GetX0(proc) != u->GetComponent(cellId, 0))
+      {
+      proc++;
+      }
+    if (proc == NumberOfProcessors || cellId + GetNX(proc) * NY * NZ >
+        mesh->GetNumberOfCells())
+      {
+      cerr << "Unexpected processor at cell " << cellId << "." << endl;
+      return false;
+      }
+    found[proc] = 1;
+    lastProc = proc;
+    const int x0 = GetX0(proc);
+    for (int k = 0; k < NZ; k++)
+      {
+      for (int j = 0; j < NY; j++)
+        {
+        for (int i = x0; i < x0 + GetNX(proc); i++, cellId++)
+          {
+          const double expected = CellT(i, j, k);
+          double *v = u->GetTuple3(cellId);
+          if (fabs(t->GetTuple1(cellId) - expected) > 1e-5 ||
+              v[0] != i || fabs(v[1] - expected) > 1e-5 || v[2] != -k)
+            {
+            cerr << "Wrong fields at cell " << cellId << "." << endl;
+            return false;
+            }
+          if (mesh->GetCellType(cellId) != VTK_HEXAHEDRON)
+            {
+            cerr << "Cell " << cellId << " is not a hexahedron." << endl;
+            return false;
+            }
+          double bounds[6];
+          mesh->GetCell(cellId)->GetBounds(bounds);
+          if (fabs(bounds[0] - PointX(i)) > 1e-5 ||
+              fabs(bounds[1] - PointX(i + 1)) > 1e-5 ||
+              bounds[2] != j || bounds[4] != k)
+            {
+            cerr << "Wrong points of cell " << cellId << "." << endl;
+            return false;
+            }
+          }
+        }
+      }
+    }
+  return true;
+}
+
+static int GetNumberOfCells(int proc)
+{
+  return GetNX(proc) * NY * NZ;
+}
+
+// Check that every processor is read by exactly one process, and that the
+// processes got meshes of about the same size: moving or swapping one
+// processor other than processor0 between two processes must not lower
+// the larger of their loads, as it would after a round robin or a
+// contiguous assignment.
+static bool CheckAssignment(vtkMultiProcessController *controller,
+                            const int *found)
+{
+  const int numProcs = controller ? controller->GetNumberOfProcesses() : 1;
+  vtkstd::vector<int> allFound(numProcs * NumberOfProcessors);
+  if (controller)
+    {
+    controller->AllGather(found, &allFound[0], NumberOfProcessors);
+    }
+  else
+    {
+    vtkstd::copy(found, found + NumberOfProcessors, allFound.begin());
+    }
+
+  vtkstd::vector<int> ranks(NumberOfProcessors, -1);
+  vtkstd::vector<int> loads(numProcs, 0);
+  for (int rank = 0; rank < numProcs; rank++)
+    {
+    for (int proc = 0; proc < NumberOfProcessors; proc++)
+      {
+      if (allFound[rank * NumberOfProcessors + proc])
+        {
+        if (ranks[proc] != -1)
+          {
+          cerr << "Processor " << proc << " was read twice." << endl;
+          return false;
+          }
+        ranks[proc] = rank;
+        loads[rank] += GetNumberOfCells(proc);
+        }
+      }
+    }
+  for (int proc = 0; proc < NumberOfProcessors; proc++)
+    {
+    if (ranks[proc] == -1)
+      {
+      cerr << "Processor " << proc << " was not read." << endl;
+      return false;
+      }
+    }
+
+  for (int p = 1; p < NumberOfProcessors; p++)
+    {
+    const int a = ranks[p];
+    for (int b = 0; b < numProcs; b++)
+      {
+      if (loads[b] >= loads[a])
+        {
+        continue;
+        }
+      // move p from a to b, or swap it with a processor q of b
+      for (int q = -1; q < NumberOfProcessors; q++)
+        {
+        if (q == 0 || (q > 0 && ranks[q] != b))
+          {
+          continue;
+          }
+        const int delta = GetNumberOfCells(p) -
+          (q == -1 ? 0 : GetNumberOfCells(q));
+        if (delta > 0 && loads[b] + delta < loads[a])
+          {
+          cerr << "Unbalanced loads: process " << a << " reads "
+               << loads[a] << " cells and process " << b << " "
+               << loads[b] << "." << endl;
+          return false;
+          }
+        }
+      }
+    }
+  return true;
+}
+
+// Runs on one process in the test driver, and on several processes under
+// MPI through POpenFOAMReaderMPI.cxx.
+int TestPOpenFOAMReader(int argc, char *argv[])
+{
+  vtkMultiProcessController *controller =
+    vtkMultiProcessController::GetGlobalController();
+  if (controller && controller->GetNumberOfProcesses() < 2)
+    {
+    controller = 0;
+    }
+  const int myId = controller ? controller->GetLocalProcessId() : 0;
+
+  char *tempDir = vtkTestUtilities::GetArgOrEnvOrDefault(
+    "-T", argc, argv, "VTK_TEMP_DIR", "Testing/Temporary");
+  const vtkstd::string casePath =
+    vtkstd::string(tempDir) + "/TestPOpenFOAMReader";
+  delete [] tempDir;
+
+  int written = 1;
+  if (myId == 0 && !WriteCase(casePath))
+    {
+    cerr << "Cannot write the case in " << casePath << "." << endl;
+    written = 0;
+    }
+  if (controller)
+    {
+    controller->Broadcast(&written, 1, 0);
+    }
+  if (!written)
+    {
+    return 1;
+    }
+
+  int failed = 0;
+  for (int numThreads = 1; numThreads <= 4 && !failed; numThreads += 3)
+    {
+    vtkSmartPointer<vtkPOpenFOAMReader> reader =
+      vtkSmartPointer<vtkPOpenFOAMReader>::New();
+    reader->SetFileName((casePath + "/system/controlDict").c_str());
+    reader->SetCaseType(vtkPOpenFOAMReader::DECOMPOSED_CASE);
+    reader->SetNumberOfThreads(numThreads);
+    reader->CreateCellToPointOff();
+    reader->Update();
+    vtkMultiBlockDataSet *output = reader->GetOutput();
+    int found[NumberOfProcessors];
+    vtkUnstructuredGrid *mesh = output && output->GetNumberOfBlocks() > 0 ?
+      vtkUnstructuredGrid::SafeDownCast(output->GetBlock(0)) : 0;
+    int ok = 1;
+    if (mesh || !controller)
+      {
+      ok = CheckInternalMesh(mesh, found);
+      }
+    else
+      {
+      // more processes than processors
+      for (int proc = 0; proc < NumberOfProcessors; proc++)
+        {
+        found[proc] = 0;
+        }
+      }
+    if (controller)
+      {
+      int allOk;
+      controller->AllReduce(&ok, &allOk, 1, vtkCommunicator::MIN_OP);
+      ok = allOk;
+      }
+    if (!ok || !CheckAssignment(controller, found))
+      {
+      cerr << "Failed with " << numThreads << " threads on process "
+           << myId << "." << endl;
+      failed = 1;
+      }
+    }
+
+  return failed;
+}
@@ -0,0 +1,716 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    $RCSfile$
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkAsynchronousStreamTracer.h"
+
+#include "vtkAbstractInterpolatedVelocityField.h"
+#include "vtkBoundingBox.h"
+#include "vtkCellData.h"
+#include "vtkCompositeDataIterator.h"
+#include "vtkCompositeDataSet.h"
+#include "vtkFloatArray.h"
+#include "vtkIdList.h"
+#include "vtkIntArray.h"
+#include "vtkMultiProcessController.h"
+#include "vtkObjectFactory.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkRungeKutta2.h"
+#include "vtkSmartPointer.h"
+#include "vtkToolkits.h"
+
+#ifdef VTK_USE_MPI
+#include "vtkMPI.h"
+#include "vtkMPICommunicator.h"
+#endif
+
+#include <vtkstd/list>
+#include <vtkstd/vector>
+
+vtkCxxRevisionMacro(vtkAsynchronousStreamTracer, "$Revision$");
+vtkStandardNewMacro(vtkAsynchronousStreamTracer);
+
+// A particle is the start of a streamline piece to integrate on some
+// process.  Particles are exchanged as arrays of doubles.
+enum
+{
+  PARTICLE_POSITION = 0,
+  PARTICLE_DIRECTION = 3,
+  PARTICLE_HAS_NORMAL = 4,
+  PARTICLE_NORMAL = 5,
+  PARTICLE_PROPAGATION = 8,
+  PARTICLE_NUMBER_OF_STEPS = 9,
+  // Process and "Streamline Ids" of the previous piece of the streamline.
+  PARTICLE_LAST_ID = 10,
+  PARTICLE_LAST_CELL_ID = 11,
+  // Rank of the process the particle was sent to among the processes
+  // whose bounds contain its position.
+  PARTICLE_CANDIDATE = 12,
+  PARTICLE_SIZE = 13
+};
+
+// Largest number of particles sent in one message.
+#define VTK_ASYNCHRONOUS_STREAM_TRACER_BATCH_SIZE 64
+
+#ifdef VTK_USE_MPI
+//----------------------------------------------------------------------------
+// The non-blocking messages of the integration.  Particles are sent in
+// batches to the processes that may continue their streamline.  Every
+// process counts the streamlines finished in its domain and reports them
+// to process 0, which knows how many streamlines are started and tells the
+// others to stop when all of them are finished.  A particle in flight is an
+// unfinished streamline, so no message is left when the count drops to 0.
+class vtkAsynchronousStreamTracerExchange
+{
+public:
+  vtkAsynchronousStreamTracerExchange(vtkMPICommunicator* com,
+                                      const vtkstd::vector<double>& bounds,
+                                      vtkIdType numberOfLines);
+  ~vtkAsynchronousStreamTracerExchange();
+
+  // Send the particle to the next process whose bounds contain its
+  // position, or finish its streamline if there is none.
+  void Forward(double* particle);
+
+  void Finish()
+    {
+    this->NumberOfFinishedLines++;
+    }
+
+  // Send the partial batches and the number of finished streamlines.
+  void Flush();
+
+  // Append the particles that arrived to particles.
+  void Receive(vtkstd::vector<double>& particles);
+
+  // Block until particles or a control message arrive.
+  void WaitForMessage();
+
+  int IsDone();
+
+  double GetProgress()
+    {
+    return 1.0 - static_cast<double>(this->NumberOfUnfinishedLines) /
+      this->NumberOfLines;
+    }
+
+private:
+  enum
+  {
+    PARTICLES_TAG = 381,
+    FINISHED_TAG = 382,
+    STOP_TAG = 383
+  };
+
+  struct PendingSend
+  {
+    vtkstd::vector<double> Buffer;
+    vtkMPICommunicator::Request Request;
+  };
+
+  void Send(int remoteId, vtkstd::vector<double>& buffer, int tag);
+  void PostReceive(vtkstd::vector<double>& buffer,
+                   vtkMPICommunicator::Request& request, int tag);
+  void CancelReceive(vtkMPICommunicator::Request& request);
+
+  vtkMPICommunicator* Communicator;
+  int LocalProcessId;
+  int NumberOfProcesses;
+  vtkstd::vector<vtkBoundingBox> Bounds;
+
+  // One batch of particles per process, starting with their number.
+  vtkstd::vector< vtkstd::vector<double> > Batches;
+  vtkstd::list<PendingSend> PendingSends;
+
+  vtkstd::vector<double> ParticlesBuffer;
+  vtkMPICommunicator::Request ParticlesRequest;
+  // Finished streamlines on process 0, stop on the others.
+  vtkstd::vector<double> ControlBuffer;
+  vtkMPICommunicator::Request ControlRequest;
+
+  vtkIdType NumberOfLines;
+  vtkIdType NumberOfFinishedLines;
+  vtkIdType NumberOfUnfinishedLines;
+  int Done;
+};
+
+//----------------------------------------------------------------------------
+vtkAsynchronousStreamTracerExchange::vtkAsynchronousStreamTracerExchange(
+  vtkMPICommunicator* com, const vtkstd::vector<double>& bounds,
+  vtkIdType numberOfLines)
+{
+  this->Communicator = com;
+  this->LocalProcessId = com->GetLocalProcessId();
+  this->NumberOfProcesses = com->GetNumberOfProcesses();
+  for (int i = 0; i < this->NumberOfProcesses; i++)
+    {
+    vtkBoundingBox box;
+    box.SetBounds(const_cast<double*>(&bounds[6*i]));
+    this->Bounds.push_back(box);
+    }
+  this->Batches.resize(this->NumberOfProcesses);
+  this->NumberOfLines = numberOfLines;
+  this->NumberOfFinishedLines = 0;
+  this->NumberOfUnfinishedLines = numberOfLines;
+  this->Done = 0;
+
+  this->ParticlesBuffer.resize(
+    1 + PARTICLE_SIZE*VTK_ASYNCHRONOUS_STREAM_TRACER_BATCH_SIZE);
+  this->PostReceive(this->ParticlesBuffer, this->ParticlesRequest,
+                    PARTICLES_TAG);
+  this->ControlBuffer.resize(1);
+  this->PostReceive(this->ControlBuffer, this->ControlRequest,
+                    this->LocalProcessId == 0 ? FINISHED_TAG : STOP_TAG);
+}
+
+//----------------------------------------------------------------------------
+vtkAsynchronousStreamTracerExchange::~vtkAsynchronousStreamTracerExchange()
+{
+  this->CancelReceive(this->ParticlesRequest);
+  if (this->LocalProcessId == 0)
+    {
+    this->CancelReceive(this->ControlRequest);
+    }
+  vtkstd::list<PendingSend>::iterator it;
+  for (it = this->PendingSends.begin(); it != this->PendingSends.end(); ++it)
+    {
+    it->Request.Wait();
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkAsynchronousStreamTracerExchange::PostReceive(
+  vtkstd::vector<double>& buffer, vtkMPICommunicator::Request& request,
+  int tag)
+{
+  this->Communicator->NoBlockReceive(
+    reinterpret_cast<char*>(&buffer[0]),
+    static_cast<int>(buffer.size()*sizeof(double)),
+    vtkMultiProcessController::ANY_SOURCE, tag, request);
+}
+
+//----------------------------------------------------------------------------
+void vtkAsynchronousStreamTracerExchange::CancelReceive(
+  vtkMPICommunicator::Request& request)
+{
+  // Complete the cancelled receive, no request may be left to MPI_Finalize.
+  if (request.Req->Handle != MPI_REQUEST_NULL)
+    {
+    MPI_Status status;
+    MPI_Cancel(&request.Req->Handle);
+    MPI_Wait(&request.Req->Handle, &status);
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkAsynchronousStreamTracerExchange::Send(int remoteId,
+                                               vtkstd::vector<double>& buffer,
+                                               int tag)
+{
+  // The buffer is kept until the message is sent.
+  this->PendingSends.push_back(PendingSend());
+  PendingSend& send = this->PendingSends.back();
+  send.Buffer.swap(buffer);
+  this->Communicator->NoBlockSend(
+    reinterpret_cast<const char*>(&send.Buffer[0]),
+    static_cast<int>(send.Buffer.size()*sizeof(double)),
+    remoteId, tag, send.Request);
+}
+
+//----------------------------------------------------------------------------
+void vtkAsynchronousStreamTracerExchange::Forward(double* particle)
+{
+  // The candidates are the processes whose bounds contain the particle, in
+  // the order of the ids following the process the streamline comes from.
+  // Every process finds the same candidates for the particle.
+  int lastId = static_cast<int>(particle[PARTICLE_LAST_ID]);
+  int candidate = static_cast<int>(particle[PARTICLE_CANDIDATE]) + 1;
+  int remoteId = -1;
+  for (int i = 1, rank = 0; i < this->NumberOfProcesses; i++)
+    {
+    int id = (lastId + i) % this->NumberOfProcesses;
+    if (this->Bounds[id].ContainsPoint(particle + PARTICLE_POSITION) &&
+        rank++ == candidate)
+      {
+      remoteId = id;
+      break;
+      }
+    }
+  // No process has it. It must be out of domain.
+  if (remoteId == -1)
+    {
+    this->Finish();
+    return;
+    }
+  particle[PARTICLE_CANDIDATE] = candidate;
+
+  vtkstd::vector<double>& batch = this->Batches[remoteId];
+  if (batch.empty())
+    {
+    batch.push_back(0);
+    }
+  batch.insert(batch.end(), particle, particle + PARTICLE_SIZE);
+  batch[0]++;
+  if (batch[0] == VTK_ASYNCHRONOUS_STREAM_TRACER_BATCH_SIZE)
+    {
+    this->Send(remoteId, batch, PARTICLES_TAG);
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkAsynchronousStreamTracerExchange::Flush()
+{
+  for (int id = 0; id < this->NumberOfProcesses; id++)
+    {
+    if (!this->Batches[id].empty())
+      {
+      this->Send(id, this->Batches[id], PARTICLES_TAG);
+      }
+    }
+  if (this->NumberOfFinishedLines > 0)
+    {
+    if (this->LocalProcessId == 0)
+      {
+      this->NumberOfUnfinishedLines -= this->NumberOfFinishedLines;
+      }
+    else
+      {
+      vtkstd::vector<double> finished(
+        1, static_cast<double>(this->NumberOfFinishedLines));
+      this->Send(0, finished, FINISHED_TAG);
+      }
+    this->NumberOfFinishedLines = 0;
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkAsynchronousStreamTracerExchange::Receive(
+  vtkstd::vector<double>& particles)
+{
+  while (this->ParticlesRequest.Test())
+    {
+    vtkstd::vector<double>::iterator first = this->ParticlesBuffer.begin() + 1;
+    particles.insert(particles.end(), first,
+                     first + PARTICLE_SIZE*
+                     static_cast<int>(this->ParticlesBuffer[0]));
+    this->PostReceive(this->ParticlesBuffer, this->ParticlesRequest,
+                      PARTICLES_TAG);
+    }
+
+  if (this->LocalProcessId == 0)
+    {
+    while (this->ControlRequest.Test())
+      {
+      this->NumberOfUnfinishedLines -=
+        static_cast<vtkIdType>(this->ControlBuffer[0]);
+      this->PostReceive(this->ControlBuffer, this->ControlRequest,
+                        FINISHED_TAG);
+      }
+    }
+  else if (!this->Done && this->ControlRequest.Test())
+    {
+    this->Done = 1;
+    }
+
+  // Release the buffers of the messages sent.
+  while (!this->PendingSends.empty() &&
+         this->PendingSends.front().Request.Test())
+    {
+    this->PendingSends.pop_front();
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkAsynchronousStreamTracerExchange::WaitForMessage()
+{
+  MPI_Request requests[2];
+  requests[0] = this->ParticlesRequest.Req->Handle;
+  requests[1] = this->ControlRequest.Req->Handle;
+  int index;
+  MPI_Status status;
+  MPI_Waitany(2, requests, &index, &status);
+  // The completed request is now null, which Receive() tests as complete.
+  this->ParticlesRequest.Req->Handle = requests[0];
+  this->ControlRequest.Req->Handle = requests[1];
+}
+
+//----------------------------------------------------------------------------
+int vtkAsynchronousStreamTracerExchange::IsDone()
+{
+  if (this->LocalProcessId == 0 && !this->Done &&
+      this->NumberOfUnfinishedLines == 0)
+    {
+    for (int id = 1; id < this->NumberOfProcesses; id++)
+      {
+      vtkstd::vector<double> stop(1, 0.0);
+      this->Send(id, stop, STOP_TAG);
+      }
+    this->Done = 1;
+    }
+  return this->Done;
+}
+#endif
+
+//----------------------------------------------------------------------------
+vtkAsynchronousStreamTracer::vtkAsynchronousStreamTracer()
+{
+}
+
+//----------------------------------------------------------------------------
+vtkAsynchronousStreamTracer::~vtkAsynchronousStreamTracer()
+{
+}
+
+//----------------------------------------------------------------------------
+int vtkAsynchronousStreamTracer::IntegrateParticle(
+  double* particle,
+  vtkAbstractInterpolatedVelocityField* func,
+  int maxCellSize,
+  vtkDataSet* input,
+  const char* vecName,
+  vtkInitialValueProblemSolver* exitIntegrator)
+{
+  int myid = this->Controller->GetLocalProcessId();
+
+  double lastPoint[3];
+
+  vtkSmartPointer<vtkFloatArray> seeds = vtkSmartPointer<vtkFloatArray>::New();
+  seeds->SetNumberOfComponents(3);
+  seeds->InsertNextTuple(particle + PARTICLE_POSITION);
+
+  vtkSmartPointer<vtkIdList> seedIds = vtkSmartPointer<vtkIdList>::New();
+  seedIds->InsertNextId(0);
+
+  vtkSmartPointer<vtkIntArray> integrationDirections =
+    vtkSmartPointer<vtkIntArray>::New();
+  integrationDirections->InsertNextValue(
+    static_cast<int>(particle[PARTICLE_DIRECTION]));
+
+  // Keep track of all streamlines by adding them to TmpOutputs.
+  // They will be appended together after all the integration is done.
+  vtkSmartPointer<vtkPolyData> tmpOutput = vtkSmartPointer<vtkPolyData>::New();
+  this->TmpOutputs.push_back(tmpOutput);
+
+  double propagation = particle[PARTICLE_PROPAGATION];
+  vtkIdType numSteps =
+    static_cast<vtkIdType>(particle[PARTICLE_NUMBER_OF_STEPS]);
+  this->Integrate(input,
+                  tmpOutput,
+                  seeds,
+                  seedIds,
+                  integrationDirections,
+                  lastPoint,
+                  func,
+                  maxCellSize,
+                  vecName,
+                  propagation,
+                  numSteps);
+  this->GenerateNormals(
+    tmpOutput,
+    particle[PARTICLE_HAS_NORMAL] != 0 ? particle + PARTICLE_NORMAL : 0,
+    vecName);
+
+  // These are used to keep track of where the seed came from
+  // and where it will go. Used later to fill the gaps between
+  // streamlines.
+  vtkIntArray* strOrigin = vtkIntArray::New();
+  strOrigin->SetNumberOfComponents(2);
+  strOrigin->SetNumberOfTuples(1);
+  strOrigin->SetName("Streamline Origin");
+  strOrigin->SetValue(0, static_cast<int>(particle[PARTICLE_LAST_ID]));
+  strOrigin->SetValue(1, static_cast<int>(particle[PARTICLE_LAST_CELL_ID]));
+  tmpOutput->GetCellData()->AddArray(strOrigin);
+  strOrigin->Delete();
+
+  vtkIntArray* streamIds = vtkIntArray::New();
+  streamIds->SetNumberOfTuples(1);
+  streamIds->SetName("Streamline Ids");
+  int lastCellId = static_cast<int>(this->TmpOutputs.size()) - 1;
+  streamIds->SetComponent(0, 0, lastCellId);
+  tmpOutput->GetCellData()->AddArray(streamIds);
+  streamIds->Delete();
+
+  // We have to know why the integration terminated
+  vtkIntArray* resTermArray = vtkIntArray::SafeDownCast(
+    tmpOutput->GetCellData()->GetArray("ReasonForTermination"));
+  int resTerm=vtkStreamTracer::OUT_OF_DOMAIN;
+  if (resTermArray)
+    {
+    resTerm = resTermArray->GetValue(0);
+    }
+
+  int numPoints = tmpOutput->GetNumberOfPoints();
+  if (numPoints == 0 || resTerm != vtkStreamTracer::OUT_OF_DOMAIN)
+    {
+    return 0;
+    }
+
+  // Continue the integration a bit further to obtain a point
+  // outside. The main integration step can not always be used
+  // for this, specially if the integration is not 2nd order.
+  // The integrator is swapped without Modified() since this is
+  // called while the filter executes.
+  tmpOutput->GetPoint(numPoints-1, lastPoint);
+  vtkInitialValueProblemSolver* ivp = this->Integrator;
+  this->Integrator = exitIntegrator;
+  double tmpseed[3];
+  memcpy(tmpseed, lastPoint, 3*sizeof(double));
+  this->SimpleIntegrate(tmpseed, lastPoint, this->LastUsedStepSize, func);
+  this->Integrator = ivp;
+
+  vtkDataArray* normals = tmpOutput->GetPointData()->GetArray("Normals");
+  particle[PARTICLE_HAS_NORMAL] = normals ? 1 : 0;
+  if (normals)
+    {
+    normals->GetTuple(normals->GetNumberOfTuples()-1,
+                      particle + PARTICLE_NORMAL);
+    }
+
+  tmpOutput->GetPoints()->SetPoint(numPoints-1, lastPoint);
+
+  memcpy(particle + PARTICLE_POSITION, lastPoint, 3*sizeof(double));
+  particle[PARTICLE_PROPAGATION] = propagation;
+  particle[PARTICLE_NUMBER_OF_STEPS] = static_cast<double>(numSteps);
+  particle[PARTICLE_LAST_ID] = myid;
+  particle[PARTICLE_LAST_CELL_ID] = lastCellId;
+  particle[PARTICLE_CANDIDATE] = -1;
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+#ifdef VTK_USE_MPI
+void vtkAsynchronousStreamTracer::AsynchronousIntegrate(
+  vtkMPICommunicator* com)
+{
+  int myid = this->Controller->GetLocalProcessId();
+  int numProcs = this->Controller->GetNumberOfProcesses();
+
+  vtkAbstractInterpolatedVelocityField* func = 0;
+  int maxCellSize = 0;
+  vtkDataSet* input0 = 0;
+  const char* vecName = 0;
+  vtkBoundingBox box;
+  int emptyData = this->EmptyData;
+  if (!emptyData)
+    {
+    this->CheckInputs(func, &maxCellSize);
+
+    vtkCompositeDataIterator* iter = this->InputData->NewIterator();
+    for (iter->InitTraversal(); !iter->IsDoneWithTraversal();
+         iter->GoToNextItem())
+      {
+      vtkDataSet* ds = vtkDataSet::SafeDownCast(iter->GetCurrentDataObject());
+      if (ds && ds->GetNumberOfCells() > 0)
+        {
+        if (!input0)
+          {
+          input0 = ds;
+          }
+        box.AddBounds(ds->GetBounds());
+        }
+      }
+    iter->Delete();
+    vtkDataArray *vectors =
+      input0 ? this->GetInputArrayToProcess(0,input0) : 0;
+    if (input0 && vectors)
+      {
+      vecName = vectors->GetName();
+      box.Inflate(1e-6*box.GetDiagonalLength());
+      }
+    else
+      {
+      // No cells or no vectors, no particle is integrated here.
+      emptyData = 1;
+      box.Reset();
+      }
+    }
+
+  // The bounds of the domains of all the processes tell where to send the
+  // particles leaving the local domain.
+  double localBounds[6];
+  box.GetBounds(localBounds);
+  vtkstd::vector<double> bounds(6*numProcs);
+  this->Controller->AllGather(localBounds, &bounds[0], 6);
+
+  // A seed belongs to the first process that has it.
+  vtkIdType numLines = this->SeedIds->GetNumberOfIds();
+  if (numLines == 0)
+    {
+    if (func)
+      {
+      func->Delete();
+      }
+    return;
+    }
+  vtkstd::vector<int> localOwners(numLines, numProcs);
+  vtkstd::vector<int> owners(numLines);
+  vtkIdType line;
+  if (!emptyData)
+    {
+    for (line = 0; line < numLines; line++)
+      {
+      double velocity[3];
+      this->Interpolator->ClearLastCellId();
+      if (this->Interpolator->FunctionValues(
+            this->Seeds->GetTuple(this->SeedIds->GetId(line)), velocity))
+        {
+        localOwners[line] = myid;
+        }
+      }
+    }
+  this->Controller->AllReduce(&localOwners[0], &owners[0], numLines,
+                              vtkCommunicator::MIN_OP);
+
+  // The particles to integrate in the local domain, last first.
+  vtkstd::vector<double> particles;
+  vtkIdType numStarted = 0;
+  for (line = numLines-1; line >= 0; line--)
+    {
+    if (owners[line] == numProcs)
+      {
+      continue;
+      }
+    numStarted++;
+    if (owners[line] == myid)
+      {
+      double particle[PARTICLE_SIZE];
+      memcpy(particle + PARTICLE_POSITION,
+             this->Seeds->GetTuple(this->SeedIds->GetId(line)),
+             3*sizeof(double));
+      particle[PARTICLE_DIRECTION] =
+        this->IntegrationDirections->GetValue(line);
+      particle[PARTICLE_HAS_NORMAL] = 0;
+      particle[PARTICLE_NORMAL] = particle[PARTICLE_NORMAL+1] =
+        particle[PARTICLE_NORMAL+2] = 0.0;
+      particle[PARTICLE_PROPAGATION] = 0.0;
+      particle[PARTICLE_NUMBER_OF_STEPS] = 0;
+      particle[PARTICLE_LAST_ID] = myid;
+      particle[PARTICLE_LAST_CELL_ID] = -1;
+      particle[PARTICLE_CANDIDATE] = -1;
+      particles.insert(particles.end(), particle, particle + PARTICLE_SIZE);
+      }
+    }
+  if (numStarted == 0)
+    {
+    if (func)
+      {
+      func->Delete();
+      }
+    return;
+    }
+
+  vtkRungeKutta2* exitIntegrator = vtkRungeKutta2::New();
+  vtkstd::vector<double> received;
+  int numIntegrated = 0;
+  vtkAsynchronousStreamTracerExchange* exchange =
+    new vtkAsynchronousStreamTracerExchange(com, bounds, numStarted);
+  while (!exchange->IsDone())
+    {
+    if (!particles.empty())
+      {
+      double particle[PARTICLE_SIZE];
+      memcpy(particle, &particles[particles.size() - PARTICLE_SIZE],
+             PARTICLE_SIZE*sizeof(double));
+      particles.resize(particles.size() - PARTICLE_SIZE);
+      if (this->IntegrateParticle(particle, func, maxCellSize, input0,
+                                  vecName, exitIntegrator))
+        {
+        exchange->Forward(particle);
+        }
+      else
+        {
+        exchange->Finish();
+        }
+      // Do not keep the other processes waiting for partial batches.
+      if (++numIntegrated % VTK_ASYNCHRONOUS_STREAM_TRACER_BATCH_SIZE == 0)
+        {
+        exchange->Flush();
+        }
+      }
+    if (particles.empty())
+      {
+      exchange->Flush();
+      }
+
+    received.clear();
+    exchange->Receive(received);
+    for (size_t i = 0; i < received.size(); i += PARTICLE_SIZE)
+      {
+      double* particle = &received[i];
+      int retVal = 0;
+      if (!emptyData)
+        {
+        double velocity[3];
+        this->Interpolator->ClearLastCellId();
+        retVal = this->Interpolator->FunctionValues(
+          particle + PARTICLE_POSITION, velocity);
+        }
+      if (retVal)
+        {
+        particles.insert(particles.end(), particle, particle + PARTICLE_SIZE);
+        }
+      else
+        {
+        // We don't have it, let's forward it to the next candidate.
+        exchange->Forward(particle);
+        }
+      }
+    if (myid == 0)
+      {
+      this->UpdateProgress(exchange->GetProgress());
+      }
+    // Nothing to integrate, sleep until another process sends something
+    // instead of polling.
+    if (particles.empty() && received.empty() && !exchange->IsDone())
+      {
+      exchange->WaitForMessage();
+      }
+    }
+  delete exchange;
+  exitIntegrator->Delete();
+  if (func)
+    {
+    func->Delete();
+    }
+}
+#else
+void vtkAsynchronousStreamTracer::AsynchronousIntegrate(vtkMPICommunicator*)
+{
+}
+#endif
+
+//----------------------------------------------------------------------------
+void vtkAsynchronousStreamTracer::ParallelIntegrate()
+{
+#ifdef VTK_USE_MPI
+  vtkMPICommunicator* com = vtkMPICommunicator::SafeDownCast(
+    this->Controller->GetCommunicator());
+  if (com)
+    {
+    if (this->Seeds)
+      {
+      this->AsynchronousIntegrate(com);
+      }
+    return;
+    }
+#endif
+  this->Superclass::ParallelIntegrate();
+}
+
+//----------------------------------------------------------------------------
+void vtkAsynchronousStreamTracer::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os,indent);
+}
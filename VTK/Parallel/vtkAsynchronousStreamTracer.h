@@ -0,0 +1,77 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    $RCSfile$
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkAsynchronousStreamTracer - Distributed streamline generator integrating all the seeds at once
+// .SECTION Description
+// vtkAsynchronousStreamTracer integrates streamlines on a distributed
+// dataset like vtkDistributedStreamTracer, but all the processes integrate
+// at the same time: every process starts with the seeds in its part of the
+// domain instead of waiting for one streamline to be handed around.  When a
+// streamline leaves the domain of a process, it is continued by the next
+// process whose bounds contain its last point.  Such particles are sent in
+// batches with non-blocking messages while the integration goes on.
+// Process 0 counts the streamlines that are not finished and tells the
+// other processes to stop when none is left.
+//
+// The pieces of a streamline are joined as in vtkPStreamTracer, so the
+// output is the same as that of vtkDistributedStreamTracer.
+// The non-blocking exchange needs a vtkMPIController.  With any other
+// controller, the streamlines are integrated one at a time by
+// vtkDistributedStreamTracer.
+// .SECTION See Also
+// vtkStreamTracer vtkPStreamTracer vtkDistributedStreamTracer
+
+#ifndef __vtkAsynchronousStreamTracer_h
+#define __vtkAsynchronousStreamTracer_h
+
+#include "vtkDistributedStreamTracer.h"
+
+class vtkInitialValueProblemSolver;
+class vtkMPICommunicator;
+
+class VTK_PARALLEL_EXPORT vtkAsynchronousStreamTracer : public vtkDistributedStreamTracer
+{
+public:
+  vtkTypeRevisionMacro(vtkAsynchronousStreamTracer,vtkDistributedStreamTracer);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  static vtkAsynchronousStreamTracer *New();
+
+protected:
+
+  vtkAsynchronousStreamTracer();
+  ~vtkAsynchronousStreamTracer();
+
+  // Integrate the streamline of one particle (see the implementation for
+  // its fields) starting in the local domain.  If the streamline leaves the
+  // domain, the particle is moved to a point just outside it and 1 is
+  // returned, otherwise 0 is returned.
+  int IntegrateParticle(double* particle,
+                        vtkAbstractInterpolatedVelocityField* func,
+                        int maxCellSize,
+                        vtkDataSet* input,
+                        const char* vecName,
+                        vtkInitialValueProblemSolver* exitIntegrator);
+
+  void AsynchronousIntegrate(vtkMPICommunicator* com);
+
+  virtual void ParallelIntegrate();
+
+private:
+  vtkAsynchronousStreamTracer(const vtkAsynchronousStreamTracer&);  // Not implemented.
+  void operator=(const vtkAsynchronousStreamTracer&);  // Not implemented.
+};
+
+
+#endif
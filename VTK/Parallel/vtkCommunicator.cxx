@@ -17,6 +17,7 @@
 #include "vtkBoundingBox.h"
 #include "vtkCharArray.h"
 #include "vtkCompositeDataSet.h"
+#include "vtkDataObjectMarshaller.h"
 #include "vtkDataObjectTypes.h"
 #include "vtkDataSetReader.h"
 #include "vtkDataSetWriter.h"
@@ -638,6 +639,21 @@ int vtkCommunicator::MarshalDataObject(vtkDataObject *object,
     return 1;
     }
 
+  // Data sets made only of vtkDataArrays are shipped in the native binary
+  // format; everything else goes through the legacy writer.
+  if (vtkDataObjectMarshaller::CanMarshal(object))
+    {
+    VTK_CREATE(vtkDataObjectMarshaller, marshaller);
+    if (!marshaller->Marshal(object))
+      {
+      vtkGenericWarningMacro("Error detected while marshaling data object.");
+      return 0;
+      }
+    buffer->SetNumberOfTuples(marshaller->GetMarshaledLength());
+    marshaller->CopyToBuffer(buffer->GetPointer(0));
+    return 1;
+    }
+
   VTK_CREATE(vtkGenericDataObjectWriter, writer);
 
   vtkSmartPointer<vtkDataObject> copy;
@@ -714,6 +730,13 @@ int vtkCommunicator::UnMarshalDataObject(vtkCharArray *buffer,
     return 1;
     }
 
+  if (vtkDataObjectMarshaller::IsMarshaledBuffer(buffer->GetPointer(0),
+                                                 bufferSize))
+    {
+    VTK_CREATE(vtkDataObjectMarshaller, marshaller);
+    return marshaller->UnMarshal(buffer->GetPointer(0), bufferSize, object);
+    }
+
   // You would think that the extent information would be properly saved, but
   // no, it is not.
   int extent[6] = {0,0,0,0,0,0};
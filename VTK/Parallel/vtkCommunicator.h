@@ -816,6 +816,8 @@ public:
   // Description:
   // Convert a data object into a string that can be transmitted and vice versa.
   // Returns 1 for success and 0 for failure.
+  // Data sets supported by vtkDataObjectMarshaller are encoded in its native
+  // binary format; other types fall back to the legacy VTK writer/reader.
   // WARNING: This will only work for types that have a vtkDataWriter class.
   static int MarshalDataObject(vtkDataObject *object, vtkCharArray *buffer);
   static int UnMarshalDataObject(vtkCharArray *buffer, vtkDataObject *object);
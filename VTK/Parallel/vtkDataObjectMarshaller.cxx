@@ -0,0 +1,750 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    $RCSfile$
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkDataObjectMarshaller.h"
+
+#include "vtkBitArray.h"
+#include "vtkByteSwap.h"
+#include "vtkCellArray.h"
+#include "vtkCellData.h"
+#include "vtkDataArray.h"
+#include "vtkDataObject.h"
+#include "vtkIdTypeArray.h"
+#include "vtkImageData.h"
+#include "vtkObjectFactory.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkRectilinearGrid.h"
+#include "vtkSmartPointer.h"
+#include "vtkStructuredGrid.h"
+#include "vtkUnsignedCharArray.h"
+#include "vtkUnstructuredGrid.h"
+
+#include <vtkstd/string>
+#include <vtkstd/vector>
+
+vtkCxxRevisionMacro(vtkDataObjectMarshaller, "$Revision$");
+vtkStandardNewMacro(vtkDataObjectMarshaller);
+
+namespace
+{
+  const char vtkDataObjectMarshallerMagic[4] = { 'V', 'T', 'K', 'B' };
+  const int vtkDataObjectMarshallerVersion = 1;
+
+  // What each array of the message is used for in the decoded object.
+  enum ArrayRole
+    {
+    FIELD_DATA = 0,
+    POINT_DATA,
+    CELL_DATA,
+    POINTS,
+    X_COORDINATES,
+    Y_COORDINATES,
+    Z_COORDINATES,
+    VERTS,
+    LINES,
+    POLYS,
+    STRIPS,
+    CELL_TYPES,
+    CELL_LOCATIONS,
+    CELLS,
+    NUMBER_OF_ROLES
+    };
+
+  //---------------------------------------------------------------------------
+  vtkIdType vtkGetArrayByteLength(vtkDataArray* array)
+    {
+    vtkIdType numValues =
+      array->GetNumberOfTuples() * array->GetNumberOfComponents();
+    if (array->GetDataType() == VTK_BIT)
+      {
+      return (numValues + 7) / 8;
+      }
+    return numValues * array->GetDataTypeSize();
+    }
+
+  //---------------------------------------------------------------------------
+  bool vtkAllDataArrays(vtkFieldData* fd)
+    {
+    if (!fd)
+      {
+      return true;
+      }
+    for (int cc = 0; cc < fd->GetNumberOfArrays(); cc++)
+      {
+      if (!vtkDataArray::SafeDownCast(fd->GetAbstractArray(cc)))
+        {
+        return false;
+        }
+      }
+    return true;
+    }
+
+  //---------------------------------------------------------------------------
+  // Swap the values of a decoded array when the sender had the other byte
+  // order. vtkByteSwap takes an int count, hence the chunking.
+  void vtkSwapArray(vtkDataArray* array)
+    {
+    int wordSize = array->GetDataTypeSize();
+    if (array->GetDataType() == VTK_BIT || wordSize <= 1)
+      {
+      return;
+      }
+    char* ptr = static_cast<char*>(array->GetVoidPointer(0));
+    vtkIdType numValues =
+      array->GetNumberOfTuples() * array->GetNumberOfComponents();
+    const vtkIdType chunk = 1 << 28;
+    while (numValues > 0)
+      {
+      int count = static_cast<int>(numValues < chunk ? numValues : chunk);
+      vtkByteSwap::SwapVoidRange(ptr, count, wordSize);
+      ptr += static_cast<vtkIdType>(count) * wordSize;
+      numValues -= count;
+      }
+    }
+
+  //---------------------------------------------------------------------------
+  class vtkMarshalReader
+    {
+  public:
+    vtkMarshalReader(const char* buffer, vtkIdType length)
+      : Current(buffer), End(buffer + length), Swap(false), Valid(true) { }
+
+    void Read(void* dest, size_t size, bool swap)
+      {
+      if (!this->Valid || this->End - this->Current < static_cast<vtkIdType>(size))
+        {
+        this->Valid = false;
+        memset(dest, 0, size);
+        return;
+        }
+      memcpy(dest, this->Current, size);
+      this->Current += size;
+      if (swap && this->Swap && size > 1)
+        {
+        vtkByteSwap::SwapVoidRange(dest, 1, static_cast<int>(size));
+        }
+      }
+    int ReadInt()
+      {
+      vtkTypeInt32 value;
+      this->Read(&value, sizeof(value), true);
+      return static_cast<int>(value);
+      }
+    vtkTypeInt64 ReadInt64()
+      {
+      vtkTypeInt64 value;
+      this->Read(&value, sizeof(value), true);
+      return value;
+      }
+    double ReadDouble()
+      {
+      double value;
+      this->Read(&value, sizeof(value), true);
+      return value;
+      }
+
+    const char* Current;
+    const char* End;
+    bool Swap;
+    bool Valid;
+    };
+}
+
+//----------------------------------------------------------------------------
+class vtkDataObjectMarshaller::vtkInternals
+{
+public:
+  struct Segment
+    {
+    const char* Pointer;
+    vtkIdType Length;
+    };
+
+  vtkstd::vector<char> Header;
+  vtkstd::vector<Segment> Segments;
+  vtkSmartPointer<vtkDataObject> Object;
+  vtkIdType Length;
+  int NumberOfArrays;
+
+  void Write(const void* src, size_t size)
+    {
+    const char* ptr = static_cast<const char*>(src);
+    this->Header.insert(this->Header.end(), ptr, ptr + size);
+    }
+  void WriteInt(int value)
+    {
+    vtkTypeInt32 v = static_cast<vtkTypeInt32>(value);
+    this->Write(&v, sizeof(v));
+    }
+  void WriteInt64(vtkTypeInt64 value)
+    {
+    this->Write(&value, sizeof(value));
+    }
+  void WriteDouble(double value)
+    {
+    this->Write(&value, sizeof(value));
+    }
+  void Patch(size_t offset, const void* src, size_t size)
+    {
+    memcpy(&this->Header[offset], src, size);
+    }
+
+  // Append the descriptor of an array to the header and its memory as a
+  // new segment.
+  void AddArray(vtkDataArray* array, int role, int attribute,
+    vtkIdType numberOfCells)
+    {
+    vtkIdType length = vtkGetArrayByteLength(array);
+    const char* name = array->GetName();
+    int nameLength = name? static_cast<int>(strlen(name)) : 0;
+
+    this->WriteInt(role);
+    this->WriteInt(attribute);
+    this->WriteInt(array->GetDataType());
+    this->WriteInt(array->GetNumberOfComponents());
+    this->WriteInt64(array->GetNumberOfTuples());
+    this->WriteInt64(numberOfCells);
+    this->WriteInt64(length);
+    this->WriteInt(nameLength);
+    if (nameLength > 0)
+      {
+      this->Write(name, nameLength);
+      }
+
+    if (length > 0)
+      {
+      Segment segment;
+      segment.Pointer = static_cast<const char*>(array->GetVoidPointer(0));
+      segment.Length = length;
+      this->Segments.push_back(segment);
+      }
+    this->Length += length;
+    this->NumberOfArrays++;
+    }
+
+  void AddFieldData(vtkFieldData* fd, int role)
+    {
+    vtkDataSetAttributes* dsa = vtkDataSetAttributes::SafeDownCast(fd);
+    for (int cc = 0; cc < fd->GetNumberOfArrays(); cc++)
+      {
+      vtkDataArray* array = fd->GetArray(cc);
+      int attribute = dsa? dsa->IsArrayAnAttribute(cc) : -1;
+      this->AddArray(array, role, attribute, 0);
+      }
+    }
+
+  void AddCellArray(vtkCellArray* cells, int role)
+    {
+    if (cells && cells->GetNumberOfCells() > 0)
+      {
+      this->AddArray(cells->GetData(), role, -1, cells->GetNumberOfCells());
+      }
+    }
+};
+
+//----------------------------------------------------------------------------
+vtkDataObjectMarshaller::vtkDataObjectMarshaller()
+{
+  this->Internals = new vtkInternals();
+  this->Internals->Length = 0;
+  this->Internals->NumberOfArrays = 0;
+}
+
+//----------------------------------------------------------------------------
+vtkDataObjectMarshaller::~vtkDataObjectMarshaller()
+{
+  delete this->Internals;
+}
+
+//----------------------------------------------------------------------------
+bool vtkDataObjectMarshaller::CanMarshal(vtkDataObject* object)
+{
+  if (!object)
+    {
+    return false;
+    }
+  switch (object->GetDataObjectType())
+    {
+  case VTK_POLY_DATA:
+  case VTK_UNSTRUCTURED_GRID:
+  case VTK_IMAGE_DATA:
+  case VTK_STRUCTURED_POINTS:
+  case VTK_RECTILINEAR_GRID:
+  case VTK_STRUCTURED_GRID:
+    break;
+
+  default:
+    return false;
+    }
+
+  vtkDataSet* ds = vtkDataSet::SafeDownCast(object);
+  return (vtkAllDataArrays(object->GetFieldData()) &&
+    vtkAllDataArrays(ds->GetPointData()) &&
+    vtkAllDataArrays(ds->GetCellData()));
+}
+
+//----------------------------------------------------------------------------
+bool vtkDataObjectMarshaller::IsMarshaledBuffer(const char* buffer,
+  vtkIdType length)
+{
+  return (buffer && length >= 4 &&
+    memcmp(buffer, vtkDataObjectMarshallerMagic, 4) == 0);
+}
+
+//----------------------------------------------------------------------------
+void vtkDataObjectMarshaller::Reset()
+{
+  this->Internals->Header.clear();
+  this->Internals->Segments.clear();
+  this->Internals->Object = 0;
+  this->Internals->Length = 0;
+  this->Internals->NumberOfArrays = 0;
+}
+
+//----------------------------------------------------------------------------
+int vtkDataObjectMarshaller::Marshal(vtkDataObject* object)
+{
+  this->Reset();
+  if (!vtkDataObjectMarshaller::CanMarshal(object))
+    {
+    vtkErrorMacro("Cannot marshal "
+      << (object? object->GetClassName() : "(none)"));
+    return 0;
+    }
+
+  vtkInternals* internals = this->Internals;
+
+  // Keep a shallow copy so that the arrays we point at stay alive even if the
+  // caller modifies the object before the message has been sent.
+  internals->Object.TakeReference(object->NewInstance());
+  internals->Object->ShallowCopy(object);
+  vtkDataObject* copy = internals->Object;
+
+  int extent[6] = {0, 0, 0, 0, 0, 0};
+  double origin[3] = {0.0, 0.0, 0.0};
+  double spacing[3] = {1.0, 1.0, 1.0};
+  if (vtkImageData* id = vtkImageData::SafeDownCast(copy))
+    {
+    id->GetExtent(extent);
+    id->GetOrigin(origin);
+    id->GetSpacing(spacing);
+    }
+  else if (vtkRectilinearGrid* rg = vtkRectilinearGrid::SafeDownCast(copy))
+    {
+    rg->GetExtent(extent);
+    }
+  else if (vtkStructuredGrid* sg = vtkStructuredGrid::SafeDownCast(copy))
+    {
+    sg->GetExtent(extent);
+    }
+
+  internals->Write(vtkDataObjectMarshallerMagic, 4);
+  internals->WriteInt(1); // byte order mark
+  internals->WriteInt(vtkDataObjectMarshallerVersion);
+  internals->WriteInt(static_cast<int>(sizeof(vtkIdType)));
+  internals->WriteInt(copy->GetDataObjectType());
+  int cc;
+  for (cc = 0; cc < 6; cc++)
+    {
+    internals->WriteInt(extent[cc]);
+    }
+  for (cc = 0; cc < 3; cc++)
+    {
+    internals->WriteDouble(origin[cc]);
+    }
+  for (cc = 0; cc < 3; cc++)
+    {
+    internals->WriteDouble(spacing[cc]);
+    }
+  // Placeholders for the number of arrays and the header length.
+  size_t numArraysOffset = internals->Header.size();
+  internals->WriteInt(0);
+  size_t headerLengthOffset = internals->Header.size();
+  internals->WriteInt64(0);
+
+  internals->AddFieldData(copy->GetFieldData(), FIELD_DATA);
+
+  vtkDataSet* ds = vtkDataSet::SafeDownCast(copy);
+  internals->AddFieldData(ds->GetPointData(), POINT_DATA);
+  internals->AddFieldData(ds->GetCellData(), CELL_DATA);
+
+  vtkPointSet* ps = vtkPointSet::SafeDownCast(copy);
+  if (ps && ps->GetPoints())
+    {
+    internals->AddArray(ps->GetPoints()->GetData(), POINTS, -1, 0);
+    }
+
+  if (vtkPolyData* pd = vtkPolyData::SafeDownCast(copy))
+    {
+    internals->AddCellArray(pd->GetVerts(), VERTS);
+    internals->AddCellArray(pd->GetLines(), LINES);
+    internals->AddCellArray(pd->GetPolys(), POLYS);
+    internals->AddCellArray(pd->GetStrips(), STRIPS);
+    }
+  else if (vtkUnstructuredGrid* ug = vtkUnstructuredGrid::SafeDownCast(copy))
+    {
+    if (ug->GetCells() && ug->GetCellTypesArray() &&
+      ug->GetCellLocationsArray())
+      {
+      internals->AddArray(ug->GetCellTypesArray(), CELL_TYPES, -1, 0);
+      internals->AddArray(ug->GetCellLocationsArray(), CELL_LOCATIONS, -1, 0);
+      internals->AddArray(ug->GetCells()->GetData(), CELLS, -1,
+        ug->GetCells()->GetNumberOfCells());
+      }
+    }
+  else if (vtkRectilinearGrid* rg = vtkRectilinearGrid::SafeDownCast(copy))
+    {
+    if (rg->GetXCoordinates())
+      {
+      internals->AddArray(rg->GetXCoordinates(), X_COORDINATES, -1, 0);
+      }
+    if (rg->GetYCoordinates())
+      {
+      internals->AddArray(rg->GetYCoordinates(), Y_COORDINATES, -1, 0);
+      }
+    if (rg->GetZCoordinates())
+      {
+      internals->AddArray(rg->GetZCoordinates(), Z_COORDINATES, -1, 0);
+      }
+    }
+
+  vtkTypeInt32 numArrays = internals->NumberOfArrays;
+  vtkTypeInt64 headerLength = static_cast<vtkTypeInt64>(internals->Header.size());
+  internals->Patch(numArraysOffset, &numArrays, sizeof(numArrays));
+  internals->Patch(headerLengthOffset, &headerLength, sizeof(headerLength));
+  internals->Length += headerLength;
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkDataObjectMarshaller::GetMarshaledLength()
+{
+  return this->Internals->Length;
+}
+
+//----------------------------------------------------------------------------
+int vtkDataObjectMarshaller::GetNumberOfSegments()
+{
+  if (this->Internals->Header.empty())
+    {
+    return 0;
+    }
+  return static_cast<int>(this->Internals->Segments.size()) + 1;
+}
+
+//----------------------------------------------------------------------------
+const char* vtkDataObjectMarshaller::GetSegmentPointer(int idx)
+{
+  if (idx < 0 || idx >= this->GetNumberOfSegments())
+    {
+    return 0;
+    }
+  if (idx == 0)
+    {
+    return &this->Internals->Header[0];
+    }
+  return this->Internals->Segments[idx-1].Pointer;
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkDataObjectMarshaller::GetSegmentLength(int idx)
+{
+  if (idx < 0 || idx >= this->GetNumberOfSegments())
+    {
+    return 0;
+    }
+  if (idx == 0)
+    {
+    return static_cast<vtkIdType>(this->Internals->Header.size());
+    }
+  return this->Internals->Segments[idx-1].Length;
+}
+
+//----------------------------------------------------------------------------
+void vtkDataObjectMarshaller::CopyToBuffer(char* buffer)
+{
+  int numSegments = this->GetNumberOfSegments();
+  for (int cc = 0; cc < numSegments; cc++)
+    {
+    vtkIdType length = this->GetSegmentLength(cc);
+    memcpy(buffer, this->GetSegmentPointer(cc), length);
+    buffer += length;
+    }
+}
+
+//----------------------------------------------------------------------------
+int vtkDataObjectMarshaller::UnMarshal(const char* buffer, vtkIdType length,
+  vtkDataObject* object)
+{
+  if (!object)
+    {
+    vtkErrorMacro("No data object to unmarshal into.");
+    return 0;
+    }
+  if (!vtkDataObjectMarshaller::IsMarshaledBuffer(buffer, length))
+    {
+    vtkErrorMacro("Buffer does not contain a marshaled data object.");
+    return 0;
+    }
+
+  vtkMarshalReader reader(buffer, length);
+  char magic[4];
+  reader.Read(magic, 4, false);
+  vtkTypeInt32 byteOrder;
+  reader.Read(&byteOrder, sizeof(byteOrder), false);
+  if (byteOrder != 1)
+    {
+    vtkByteSwap::SwapVoidRange(&byteOrder, 1, sizeof(byteOrder));
+    if (byteOrder != 1)
+      {
+      vtkErrorMacro("Corrupt marshaled data object header.");
+      return 0;
+      }
+    reader.Swap = true;
+    }
+
+  int version = reader.ReadInt();
+  int idTypeSize = reader.ReadInt();
+  int dataType = reader.ReadInt();
+  if (version != vtkDataObjectMarshallerVersion)
+    {
+    vtkErrorMacro("Unsupported marshaled data object version " << version);
+    return 0;
+    }
+  if (idTypeSize != static_cast<int>(sizeof(vtkIdType)))
+    {
+    vtkErrorMacro("Sender and receiver have different vtkIdType sizes.");
+    return 0;
+    }
+  if (dataType != object->GetDataObjectType() &&
+    !(dataType == VTK_STRUCTURED_POINTS && object->IsA("vtkImageData")))
+    {
+    vtkWarningMacro("Type mismatch while unmarshalling data.");
+    }
+
+  int extent[6];
+  double origin[3], spacing[3];
+  int cc;
+  for (cc = 0; cc < 6; cc++)
+    {
+    extent[cc] = reader.ReadInt();
+    }
+  for (cc = 0; cc < 3; cc++)
+    {
+    origin[cc] = reader.ReadDouble();
+    }
+  for (cc = 0; cc < 3; cc++)
+    {
+    spacing[cc] = reader.ReadDouble();
+    }
+  int numArrays = reader.ReadInt();
+  vtkTypeInt64 headerLength = reader.ReadInt64();
+  if (!reader.Valid || headerLength > length)
+    {
+    vtkErrorMacro("Truncated marshaled data object.");
+    return 0;
+    }
+
+  object->Initialize();
+  vtkDataSet* ds = vtkDataSet::SafeDownCast(object);
+  vtkPointSet* ps = vtkPointSet::SafeDownCast(object);
+  vtkPolyData* pd = vtkPolyData::SafeDownCast(object);
+  vtkUnstructuredGrid* ug = vtkUnstructuredGrid::SafeDownCast(object);
+  vtkRectilinearGrid* rg = vtkRectilinearGrid::SafeDownCast(object);
+  vtkStructuredGrid* sg = vtkStructuredGrid::SafeDownCast(object);
+  vtkImageData* id = vtkImageData::SafeDownCast(object);
+
+  vtkSmartPointer<vtkUnsignedCharArray> cellTypes;
+  vtkSmartPointer<vtkIdTypeArray> cellLocations;
+  vtkSmartPointer<vtkCellArray> cells;
+
+  const char* data = buffer + headerLength;
+  const char* dataEnd = buffer + length;
+  for (int arrayIdx = 0; arrayIdx < numArrays; arrayIdx++)
+    {
+    int role = reader.ReadInt();
+    int attribute = reader.ReadInt();
+    int arrayType = reader.ReadInt();
+    int numComponents = reader.ReadInt();
+    vtkTypeInt64 numTuples = reader.ReadInt64();
+    vtkTypeInt64 numCells = reader.ReadInt64();
+    vtkTypeInt64 numBytes = reader.ReadInt64();
+    int nameLength = reader.ReadInt();
+    vtkstd::string name;
+    if (nameLength > 0 && reader.End - reader.Current >= nameLength)
+      {
+      name.assign(reader.Current, nameLength);
+      reader.Current += nameLength;
+      }
+    if (!reader.Valid || role < 0 || role >= NUMBER_OF_ROLES ||
+      numBytes > dataEnd - data)
+      {
+      vtkErrorMacro("Truncated marshaled data object.");
+      return 0;
+      }
+
+    vtkSmartPointer<vtkDataArray> array;
+    array.TakeReference(vtkDataArray::CreateDataArray(arrayType));
+    if (!array)
+      {
+      vtkErrorMacro("Unknown array type " << arrayType);
+      return 0;
+      }
+    array->SetNumberOfComponents(numComponents);
+    array->SetNumberOfTuples(static_cast<vtkIdType>(numTuples));
+    if (vtkGetArrayByteLength(array) != numBytes)
+      {
+      vtkErrorMacro("Array size mismatch while unmarshalling data.");
+      return 0;
+      }
+    if (numBytes > 0)
+      {
+      memcpy(array->GetVoidPointer(0), data, static_cast<size_t>(numBytes));
+      data += numBytes;
+      if (reader.Swap)
+        {
+        vtkSwapArray(array);
+        }
+      }
+    array->SetName(name.empty()? 0 : name.c_str());
+
+    switch (role)
+      {
+    case FIELD_DATA:
+      object->GetFieldData()->AddArray(array);
+      break;
+
+    case POINT_DATA:
+    case CELL_DATA:
+      if (ds)
+        {
+        vtkDataSetAttributes* dsa = (role == POINT_DATA)?
+          static_cast<vtkDataSetAttributes*>(ds->GetPointData()) :
+          static_cast<vtkDataSetAttributes*>(ds->GetCellData());
+        int index = dsa->AddArray(array);
+        if (attribute >= 0)
+          {
+          dsa->SetActiveAttribute(index, attribute);
+          }
+        }
+      break;
+
+    case POINTS:
+      if (ps)
+        {
+        vtkPoints* points = vtkPoints::New();
+        points->SetData(array);
+        ps->SetPoints(points);
+        points->Delete();
+        }
+      break;
+
+    case X_COORDINATES:
+      if (rg)
+        {
+        rg->SetXCoordinates(array);
+        }
+      break;
+
+    case Y_COORDINATES:
+      if (rg)
+        {
+        rg->SetYCoordinates(array);
+        }
+      break;
+
+    case Z_COORDINATES:
+      if (rg)
+        {
+        rg->SetZCoordinates(array);
+        }
+      break;
+
+    case VERTS:
+    case LINES:
+    case POLYS:
+    case STRIPS:
+    case CELLS:
+      {
+      vtkIdTypeArray* ids = vtkIdTypeArray::SafeDownCast(array);
+      if (!ids)
+        {
+        vtkErrorMacro("Cell connectivity must be a vtkIdTypeArray.");
+        return 0;
+        }
+      vtkSmartPointer<vtkCellArray> ca = vtkSmartPointer<vtkCellArray>::New();
+      ca->SetCells(static_cast<vtkIdType>(numCells), ids);
+      if (role == CELLS)
+        {
+        cells = ca;
+        }
+      else if (pd && role == VERTS)
+        {
+        pd->SetVerts(ca);
+        }
+      else if (pd && role == LINES)
+        {
+        pd->SetLines(ca);
+        }
+      else if (pd && role == POLYS)
+        {
+        pd->SetPolys(ca);
+        }
+      else if (pd && role == STRIPS)
+        {
+        pd->SetStrips(ca);
+        }
+      }
+      break;
+
+    case CELL_TYPES:
+      cellTypes = vtkUnsignedCharArray::SafeDownCast(array);
+      break;
+
+    case CELL_LOCATIONS:
+      cellLocations = vtkIdTypeArray::SafeDownCast(array);
+      break;
+      }
+    }
+
+  if (ug && cells && cellTypes && cellLocations)
+    {
+    ug->SetCells(cellTypes, cellLocations, cells);
+    }
+  if (id)
+    {
+    id->SetExtent(extent);
+    id->SetOrigin(origin);
+    id->SetSpacing(spacing);
+    }
+  else if (rg)
+    {
+    rg->SetExtent(extent);
+    }
+  else if (sg)
+    {
+    sg->SetExtent(extent);
+    }
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+void vtkDataObjectMarshaller::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "MarshaledLength: " << this->Internals->Length << endl;
+  os << indent << "NumberOfSegments: " << this->GetNumberOfSegments() << endl;
+}
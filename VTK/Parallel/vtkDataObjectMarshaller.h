@@ -0,0 +1,112 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    $RCSfile$
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkDataObjectMarshaller - binary wire format for data objects.
+// .SECTION Description
+// vtkDataObjectMarshaller encodes a vtkDataObject into a compact native
+// binary message: a small header describing the object and its arrays,
+// followed by the raw contents of every vtkDataArray (points, cell
+// connectivity, point/cell/field data). Nothing is formatted or parsed as
+// text, so encoding costs at most one memcpy per array and decoding is a
+// memcpy into freshly allocated arrays.
+//
+// The encoded message is exposed as a list of segments. Segment 0 is the
+// header owned by the marshaller; every other segment points directly at
+// the memory of an array of the marshalled object. Callers that want to
+// stream the message (see vtkMPIMoveData) can send the segments one by one
+// without first assembling a contiguous copy. The marshaller keeps a
+// shallow copy of the object so the segment pointers remain valid until the
+// next call to Marshal() or Reset().
+//
+// The header records the byte order of the sender; the receiver swaps the
+// arrays when needed. Both ends must use the same size of vtkIdType.
+//
+// Decoded arrays do not adopt the memory of the received buffer. A
+// vtkDataArray cannot keep the vtkCharArray it would point into alive, nor
+// free only a part of it, and the array contents follow a header of
+// arbitrary length so they are not aligned for their type. Decoding copies
+// every array once instead, which replaces the parsing of the legacy text
+// format.
+//
+// Only vtkPolyData, vtkUnstructuredGrid, vtkImageData (and
+// vtkStructuredPoints), vtkRectilinearGrid and vtkStructuredGrid whose
+// attributes are all vtkDataArrays are supported. Use CanMarshal() to check;
+// vtkCommunicator falls back to the legacy writer for anything else.
+// .SECTION See Also
+// vtkCommunicator
+
+#ifndef __vtkDataObjectMarshaller_h
+#define __vtkDataObjectMarshaller_h
+
+#include "vtkObject.h"
+
+class vtkDataObject;
+
+class VTK_PARALLEL_EXPORT vtkDataObjectMarshaller : public vtkObject
+{
+public:
+  static vtkDataObjectMarshaller* New();
+  vtkTypeRevisionMacro(vtkDataObjectMarshaller, vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  // Description:
+  // Returns true if the object can be encoded in the binary format.
+  static bool CanMarshal(vtkDataObject* object);
+
+  // Description:
+  // Returns true if the buffer begins with a binary marshal header.
+  static bool IsMarshaledBuffer(const char* buffer, vtkIdType length);
+
+  // Description:
+  // Encode the object. Returns 1 on success, 0 on failure.
+  int Marshal(vtkDataObject* object);
+
+  // Description:
+  // Release the header and the reference held on the marshalled object.
+  void Reset();
+
+  // Description:
+  // Total length in bytes of the message produced by the last Marshal().
+  vtkIdType GetMarshaledLength();
+
+  // Description:
+  // Access to the message as a list of contiguous memory segments.
+  int GetNumberOfSegments();
+  const char* GetSegmentPointer(int idx);
+  vtkIdType GetSegmentLength(int idx);
+
+  // Description:
+  // Copy the complete message into a buffer that must hold at least
+  // GetMarshaledLength() bytes.
+  void CopyToBuffer(char* buffer);
+
+  // Description:
+  // Decode a message into the object. The object must be of the type that
+  // was marshalled (a warning is emitted otherwise). Returns 1 on success,
+  // 0 on failure.
+  int UnMarshal(const char* buffer, vtkIdType length, vtkDataObject* object);
+
+protected:
+  vtkDataObjectMarshaller();
+  ~vtkDataObjectMarshaller();
+
+private:
+  vtkDataObjectMarshaller(const vtkDataObjectMarshaller&); // Not implemented.
+  void operator=(const vtkDataObjectMarshaller&); // Not implemented.
+
+  class vtkInternals;
+  vtkInternals* Internals;
+};
+
+#endif
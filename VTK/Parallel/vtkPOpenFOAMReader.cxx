@@ -20,6 +20,7 @@
 #include "vtkAppendCompositeDataLeaves.h"
 #include "vtkCharArray.h"
 #include "vtkCollection.h"
+#include "vtkCriticalSection.h"
 #include "vtkDataArraySelection.h"
 #include "vtkDirectory.h"
 #include "vtkDoubleArray.h"
@@ -29,12 +30,17 @@
 #include "vtkIntArray.h"
 #include "vtkMultiBlockDataSet.h"
 #include "vtkMultiProcessController.h"
+#include "vtkMultiThreader.h"
 #include "vtkObjectFactory.h"
 #include "vtkSortDataArray.h"
 #include "vtkStdString.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkStringArray.h"
 
+#include <vtkstd/algorithm>
+#include <vtkstd/vector>
+#include <sys/stat.h>
+
 vtkCxxRevisionMacro(vtkPOpenFOAMReader, "$Revision$");
 vtkStandardNewMacro(vtkPOpenFOAMReader);
 vtkCxxSetObjectMacro(vtkPOpenFOAMReader, Controller, vtkMultiProcessController);
@@ -57,12 +63,16 @@ vtkPOpenFOAMReader::vtkPOpenFOAMReader()
   this->CaseType = RECONSTRUCTED_CASE;
   this->MTimeOld = 0;
   this->MaximumNumberOfPieces = 1;
+  this->Threader = vtkMultiThreader::New();
+  this->NumberOfThreads = 1;
+  this->ThreadedUpdate = 0;
 }
 
 //-----------------------------------------------------------------------------
 vtkPOpenFOAMReader::~vtkPOpenFOAMReader()
 {
   this->SetController(NULL);
+  this->Threader->Delete();
 }
 
 //-----------------------------------------------------------------------------
@@ -76,6 +86,7 @@ void vtkPOpenFOAMReader::PrintSelf(ostream &os, vtkIndent indent)
   os << indent << "Number of Processes: " << this->NumProcesses << endl;
   os << indent << "Process Id: " << this->ProcessId << endl;
   os << indent << "Controller: " << this->Controller << endl;
+  os << indent << "Number of Threads: " << this->NumberOfThreads << endl;
 }
 
 //-----------------------------------------------------------------------------
@@ -159,6 +170,7 @@ int vtkPOpenFOAMReader::RequestInformation(vtkInformation *request,
     this->Superclass::NumberOfReaders = 0;
 
     vtkStringArray *procNames = vtkStringArray::New();
+    vtkIntArray *procRanks = vtkIntArray::New();
     vtkDoubleArray *timeValues;
 
     // recreate case information
@@ -177,6 +189,8 @@ int vtkPOpenFOAMReader::RequestInformation(vtkInformation *request,
         {
         vtkErrorMacro(<< "Can't open " << masterCasePath.c_str());
         dir->Delete();
+        procNames->Delete();
+        procRanks->Delete();
         this->BroadcastStatus(ret = 0);
         return 0;
         }
@@ -205,6 +219,8 @@ int vtkPOpenFOAMReader::RequestInformation(vtkInformation *request,
       vtkSortDataArray::Sort(procNos, procNames);
       procNos->Delete();
 
+      this->AssignProcessorDirectories(masterCasePath, procNames, procRanks);
+
       // get time directories from the first processor subdirectory
       if (procNames->GetNumberOfTuples() > 0)
         {
@@ -215,6 +231,7 @@ int vtkPOpenFOAMReader::RequestInformation(vtkInformation *request,
         ->GetValue(0)) || !masterReader->MakeMetaDataAtTimeStep(true))
           {
           procNames->Delete();
+          procRanks->Delete();
           masterReader->Delete();
           this->BroadcastStatus(ret = 0);
           return 0;
@@ -242,10 +259,13 @@ int vtkPOpenFOAMReader::RequestInformation(vtkInformation *request,
         {
         vtkErrorMacro(<< "The master process returned an error.");
         timeValues->Delete(); // don't have to care about process 0
+        procNames->Delete();
+        procRanks->Delete();
         return 0;
         }
 
       this->Broadcast(procNames);
+      this->Controller->Broadcast(procRanks, 0);
       this->Controller->Broadcast(timeValues, 0);
       if (this->ProcessId != 0)
         {
@@ -261,11 +281,14 @@ int vtkPOpenFOAMReader::RequestInformation(vtkInformation *request,
 
     this->MaximumNumberOfPieces = procNames->GetNumberOfTuples();
 
-    // create reader instances for other processor subdirectories
-    // skip processor0 since it's already created
-    for (int procI = (this->ProcessId ? this->ProcessId : this->NumProcesses); procI
-        < procNames->GetNumberOfTuples(); procI += this->NumProcesses)
+    // create reader instances for the processor subdirectories assigned
+    // to this process. skip processor0 since it's already created
+    for (int procI = 1; procI < procNames->GetNumberOfTuples(); procI++)
       {
+      if (procRanks->GetValue(procI) != this->ProcessId)
+        {
+        continue;
+        }
       vtkOpenFOAMReader *subReader = vtkOpenFOAMReader::New();
       subReader->SetFileName(this->FileName);
       subReader->SetParent(this);
@@ -284,6 +307,7 @@ int vtkPOpenFOAMReader::RequestInformation(vtkInformation *request,
       }
 
     procNames->Delete();
+    procRanks->Delete();
 
     this->GatherMetaData();
     this->Superclass::Refresh = false;
@@ -336,6 +360,7 @@ int vtkPOpenFOAMReader::RequestData(vtkInformation *request,
 
     vtkAppendCompositeDataLeaves *append = vtkAppendCompositeDataLeaves::New();
     // append->AppendFieldDataOn();
+    vtkCollection *readers = vtkCollection::New();
 
     vtkOpenFOAMReader *reader;
     this->Superclass::CurrentReaderIndex = 0;
@@ -355,10 +380,13 @@ int vtkPOpenFOAMReader::RequestData(vtkInformation *request,
       if (reader->MakeMetaDataAtTimeStep(false))
         {
         append->AddInputConnection(reader->GetOutputPort());
+        readers->AddItem(reader);
         }
       }
 
     this->GatherMetaData();
+    this->UpdateReaders(readers);
+    readers->Delete();
 
     if (append->GetInput() == NULL)
       {
@@ -390,6 +418,162 @@ int vtkPOpenFOAMReader::RequestData(vtkInformation *request,
   return ret;
 }
 
+//-----------------------------------------------------------------------------
+void vtkPOpenFOAMReader::UpdateProgress(double amount)
+{
+  if (!this->ThreadedUpdate)
+    {
+    this->Superclass::UpdateProgress(amount);
+    }
+}
+
+//-----------------------------------------------------------------------------
+void vtkPOpenFOAMReader::IncrementCurrentReaderIndex()
+{
+  if (!this->ThreadedUpdate)
+    {
+    this->Superclass::IncrementCurrentReaderIndex();
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Assign the processor subdirectories to the processes, the largest
+// first, each to the process with the least to read so far.  The size of
+// a subdirectory is estimated by the size of its owner file, which grows
+// with the number of faces of the mesh.  processor0 is assigned to process
+// 0, which reads the metadata from it.
+void vtkPOpenFOAMReader::AssignProcessorDirectories(
+  const vtkStdString &casePath, vtkStringArray *procNames,
+  vtkIntArray *procRanks)
+{
+  const int nProcs = procNames->GetNumberOfTuples();
+  vtkstd::vector<vtkstd::pair<double, int> > sizes(nProcs);
+  double knownSize = 0.0;
+  int nKnown = 0;
+  for (int procI = 0; procI < nProcs; procI++)
+    {
+    const vtkStdString ownerPath(casePath + procNames->GetValue(procI)
+      + "/constant/polyMesh/owner");
+    struct stat fs;
+    double size = -1.0;
+    if (stat(ownerPath.c_str(), &fs) == 0
+      || stat((ownerPath + ".gz").c_str(), &fs) == 0)
+      {
+      size = static_cast<double>(fs.st_size);
+      knownSize += size;
+      nKnown++;
+      }
+    // sort by decreasing sizes, then by processor numbers
+    sizes[procI] = vtkstd::pair<double, int>(-size, procI);
+    }
+  // the meshes of the subdirectories without an owner file (moving
+  // meshes) are assumed to be of the average size
+  for (int procI = 0; procI < nProcs; procI++)
+    {
+    if (sizes[procI].first > 0.0)
+      {
+      sizes[procI].first = nKnown ? -knownSize / nKnown : -1.0;
+      }
+    }
+  if (nProcs > 0)
+    {
+    vtkstd::sort(sizes.begin() + 1, sizes.end());
+    }
+
+  procRanks->Initialize();
+  procRanks->SetNumberOfTuples(nProcs);
+  vtkstd::vector<double> loads(this->NumProcesses, 0.0);
+  for (int i = 0; i < nProcs; i++)
+    {
+    const int rank = (i == 0 ? 0 : static_cast<int>(vtkstd::min_element(
+      loads.begin(), loads.end()) - loads.begin()));
+    loads[rank] -= sizes[i].first;
+    procRanks->SetValue(sizes[i].second, rank);
+    }
+}
+
+//-----------------------------------------------------------------------------
+struct vtkPOpenFOAMReaderThreadStruct
+{
+  vtkPOpenFOAMReader *Reader;
+  vtkstd::vector<vtkOpenFOAMReader *> Readers;
+  size_t NextReader;
+  size_t NumberOfReadersDone;
+  vtkSimpleCriticalSection Lock;
+};
+
+//-----------------------------------------------------------------------------
+// Update the readers, one at a time, until there are none left.
+static VTK_THREAD_RETURN_TYPE vtkPOpenFOAMReaderUpdateReaders(void *arg)
+{
+  vtkMultiThreader::ThreadInfo *info =
+    static_cast<vtkMultiThreader::ThreadInfo *>(arg);
+  vtkPOpenFOAMReaderThreadStruct *str =
+    static_cast<vtkPOpenFOAMReaderThreadStruct *>(info->UserData);
+
+  for (;;)
+    {
+    str->Lock.Lock();
+    const size_t readerI = str->NextReader++;
+    str->Lock.Unlock();
+    if (readerI >= str->Readers.size())
+      {
+      break;
+      }
+
+    str->Readers[readerI]->Update();
+
+    str->Lock.Lock();
+    const size_t nDone = ++str->NumberOfReadersDone;
+    str->Lock.Unlock();
+    // only the calling thread reports the progress
+    if (info->ThreadID == 0)
+      {
+      str->Reader->vtkAlgorithm::UpdateProgress(
+        static_cast<double>(nDone) / str->Readers.size());
+      }
+    }
+
+  return VTK_THREAD_RETURN_VALUE;
+}
+
+//-----------------------------------------------------------------------------
+// Update the readers of the processor subdirectories assigned to this
+// process with several threads. The append filter then finds them up to
+// date.
+void vtkPOpenFOAMReader::UpdateReaders(vtkCollection *readers)
+{
+  int numThreads = this->NumberOfThreads;
+  if (numThreads > readers->GetNumberOfItems())
+    {
+    numThreads = readers->GetNumberOfItems();
+    }
+  if (numThreads <= 1)
+    {
+    return;
+    }
+
+  vtkPOpenFOAMReaderThreadStruct str;
+  str.Reader = this;
+  str.NextReader = 0;
+  str.NumberOfReadersDone = 0;
+  vtkOpenFOAMReader *reader;
+  readers->InitTraversal();
+  while ((reader
+      = vtkOpenFOAMReader::SafeDownCast(readers->GetNextItemAsObject()))
+      != NULL)
+    {
+    str.Readers.push_back(reader);
+    }
+
+  this->ThreadedUpdate = 1;
+  this->Threader->SetNumberOfThreads(numThreads);
+  this->Threader->SetSingleMethod(vtkPOpenFOAMReaderUpdateReaders, &str);
+  this->Threader->SingleMethodExecute();
+  this->ThreadedUpdate = 0;
+  this->Superclass::CurrentReaderIndex = this->Superclass::NumberOfReaders;
+}
+
 //-----------------------------------------------------------------------------
 void vtkPOpenFOAMReader::BroadcastStatus(int &status)
 {
@@ -19,6 +19,11 @@
 // polyMesh folders contain mesh information. The time folders contain
 // transient data for the cells. Each folder can contain any number of
 // data files.
+//
+// The processor subdirectories of a decomposed case are assigned to the
+// processes so as to balance the sizes of their meshes, estimated from the
+// sizes of their owner files.  Each process reads its subdirectories with
+// NumberOfThreads threads.
 
 // .SECTION Thanks
 // This class was developed by Takuya Oshima at Niigata University,
@@ -30,7 +35,9 @@
 #include "vtkOpenFOAMReader.h"
 
 class vtkDataArraySelection;
+class vtkIntArray;
 class vtkMultiProcessController;
+class vtkMultiThreader;
 
 class VTK_PARALLEL_EXPORT vtkPOpenFOAMReader : public vtkOpenFOAMReader
 {
@@ -52,6 +59,16 @@ public:
   virtual void SetController(vtkMultiProcessController *);
   vtkGetObjectMacro(Controller, vtkMultiProcessController);
 
+  // Description:
+  // Set/Get the number of threads the processor subdirectories of a
+  // decomposed case assigned to this process are read with.  It defaults
+  // to 1 so that the processes of a parallel run do not oversubscribe the
+  // cores.  No more threads than the global maximum of vtkMultiThreader
+  // run; ParaView's vtkProcessModule sets it to 1, so the subdirectories
+  // are read one at a time there unless the global maximum is raised.
+  vtkSetClampMacro(NumberOfThreads, int, 1, VTK_MAX_THREADS);
+  vtkGetMacro(NumberOfThreads, int);
+
 protected:
   vtkPOpenFOAMReader();
   ~vtkPOpenFOAMReader();
@@ -61,6 +78,14 @@ protected:
   int RequestData(vtkInformation *, vtkInformationVector **,
     vtkInformationVector *);
 
+  // The progress of the readers of the subdirectories is ignored while
+  // they are updated by several threads.
+  virtual void UpdateProgress(double);
+  virtual void IncrementCurrentReaderIndex();
+
+  vtkMultiThreader *Threader;
+  int NumberOfThreads;
+
 private:
   vtkMultiProcessController *Controller;
   caseType CaseType;
@@ -68,11 +93,15 @@ private:
   int MaximumNumberOfPieces;
   int NumProcesses;
   int ProcessId;
+  int ThreadedUpdate;
 
   vtkPOpenFOAMReader(const vtkPOpenFOAMReader &); // Not implemented.
   void operator=(const vtkPOpenFOAMReader &); // Not implemented.
 
   void GatherMetaData();
+  void AssignProcessorDirectories(const vtkStdString &, vtkStringArray *,
+    vtkIntArray *);
+  void UpdateReaders(vtkCollection *);
   void BroadcastStatus(int &);
   void Broadcast(vtkStringArray *);
   void AllGather(vtkStringArray *);
@@ -18,6 +18,7 @@
 #include "vtkCharArray.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
+#include "vtkModifiedBSPTree.h"
 #include "vtkMultiProcessController.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
@@ -36,6 +37,10 @@ vtkPProbeFilter::vtkPProbeFilter()
 {
   this->Controller = 0;
   this->SetController(vtkMultiProcessController::GetGlobalController());
+
+  vtkModifiedBSPTree *locator = vtkModifiedBSPTree::New();
+  this->SetCellLocatorPrototype(locator);
+  locator->Delete();
 }
 
 //----------------------------------------------------------------------------
@@ -14,6 +14,9 @@
 =========================================================================*/
 // .NAME vtkPProbeFilter - probe dataset in parallel
 // .SECTION Description
+// The cells of the source are found with a vtkModifiedBSPTree cell
+// locator by default (see vtkProbeFilter::SetCellLocatorPrototype()), on
+// one thread unless vtkProbeFilter::SetNumberOfThreads() asks for more.
 
 #ifndef __vtkPProbeFilter_h
 #define __vtkPProbeFilter_h
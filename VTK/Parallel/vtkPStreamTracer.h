@@ -19,7 +19,7 @@
 // access to the WHOLE seed source, i.e. the source must be identical
 // on all processes.
 // .SECTION See Also
-// vtkStreamTracer vtkDistributedStreamTracer vtkMPIStreamTracer
+// vtkStreamTracer vtkDistributedStreamTracer vtkAsynchronousStreamTracer
 
 #ifndef __vtkPStreamTracer_h
 #define __vtkPStreamTracer_h
@@ -0,0 +1,219 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    $RCSfile$
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+
+// .NAME Test vtkThreadedCellCenterDepthSort.
+// .SECTION Description
+// Sorts a mesh of tetrahedra and a few hexahedra from several views, with
+// small rotations that take the incremental path, and checks that every
+// cell is returned once in the order of the depths of the cell centers.
+
+#include "vtkCamera.h"
+#include "vtkCell.h"
+#include "vtkCellType.h"
+#include "vtkIdTypeArray.h"
+#include "vtkMath.h"
+#include "vtkMultiThreader.h"
+#include "vtkPoints.h"
+#include "vtkSmartPointer.h"
+#include "vtkThreadedCellCenterDepthSort.h"
+#include "vtkUnstructuredGrid.h"
+
+#include <vtkstd/vector>
+
+static int CheckOrder(vtkThreadedCellCenterDepthSort *sort,
+                      vtkUnstructuredGrid *grid, vtkCamera *camera,
+                      const char *name)
+{
+  double position[3], focalPoint[3], vector[3];
+  camera->GetPosition(position);
+  camera->GetFocalPoint(focalPoint);
+  for (int i = 0; i < 3; i++)
+    {
+    vector[i] = position[i] - focalPoint[i];
+    if (sort->GetDirection() == vtkVisibilitySort::FRONT_TO_BACK)
+      {
+      vector[i] = -vector[i];
+      }
+    }
+
+  vtkIdType numCells = grid->GetNumberOfCells();
+  vtkstd::vector<int> seen(numCells, 0);
+  vtkIdType count = 0;
+  double lastDepth = -VTK_DOUBLE_MAX;
+  double tolerance = 1.0e-5*vtkMath::Norm(vector);
+  double weights[8];
+
+  sort->InitTraversal();
+  for (vtkIdTypeArray *cells = sort->GetNextCells(); cells != NULL;
+       cells = sort->GetNextCells())
+    {
+    if (cells->GetNumberOfTuples() > sort->GetMaxCellsReturned())
+      {
+      cerr << name << ": got " << cells->GetNumberOfTuples()
+           << " cells at once." << endl;
+      return 0;
+      }
+    for (vtkIdType i = 0; i < cells->GetNumberOfTuples(); i++)
+      {
+      vtkIdType cellId = cells->GetValue(i);
+      if (cellId < 0 || cellId >= numCells || seen[cellId])
+        {
+        cerr << name << ": bad or repeated cell " << cellId << endl;
+        return 0;
+        }
+      seen[cellId] = 1;
+      count++;
+
+      vtkCell *cell = grid->GetCell(cellId);
+      double pcenter[3], center[3];
+      int subId = cell->GetParametricCenter(pcenter);
+      cell->EvaluateLocation(subId, pcenter, center, weights);
+      double depth = vtkMath::Dot(center, vector);
+      if (depth < lastDepth - tolerance)
+        {
+        cerr << name << ": cell " << cellId << " at depth " << depth
+             << " comes after depth " << lastDepth << endl;
+        return 0;
+        }
+      lastDepth = depth;
+      }
+    }
+
+  if (count != numCells)
+    {
+    cerr << name << ": got " << count << " of " << numCells << " cells."
+         << endl;
+    return 0;
+    }
+  return 1;
+}
+
+int TestThreadedCellCenterDepthSort(int, char *[])
+{
+  // Enough cells for several threads to take part.
+  const int numTetras = 200000;
+  const int numHexahedra = 100;
+
+  vtkMath::RandomSeed(1234);
+  vtkSmartPointer<vtkPoints> points = vtkSmartPointer<vtkPoints>::New();
+  vtkSmartPointer<vtkUnstructuredGrid> grid =
+    vtkSmartPointer<vtkUnstructuredGrid>::New();
+  grid->Allocate(numTetras + numHexahedra);
+  vtkIdType ptIds[8];
+  int i, j;
+  for (i = 0; i < numTetras + numHexahedra; i++)
+    {
+    double x = vtkMath::Random(-10.0, 10.0);
+    double y = vtkMath::Random(-10.0, 10.0);
+    double z = vtkMath::Random(-10.0, 10.0);
+    int numPts = i % 2001 == 0 && i > 0 ? 8 : 4;
+    for (j = 0; j < numPts; j++)
+      {
+      ptIds[j] = points->InsertNextPoint(x + vtkMath::Random(0.0, 0.5),
+                                         y + vtkMath::Random(0.0, 0.5),
+                                         z + vtkMath::Random(0.0, 0.5));
+      }
+    grid->InsertNextCell(numPts == 8 ? VTK_HEXAHEDRON : VTK_TETRA,
+                         numPts, ptIds);
+    }
+  grid->SetPoints(points);
+
+  vtkSmartPointer<vtkCamera> camera = vtkSmartPointer<vtkCamera>::New();
+  camera->SetPosition(0.0, 0.0, 50.0);
+  camera->SetFocalPoint(0.0, 0.0, 0.0);
+
+  vtkSmartPointer<vtkThreadedCellCenterDepthSort> sort =
+    vtkSmartPointer<vtkThreadedCellCenterDepthSort>::New();
+  sort->SetInput(grid);
+  sort->SetCamera(camera);
+  sort->SetNumberOfThreads(4);
+  sort->SetMaxCellsReturned(1000);
+
+  if (!CheckOrder(sort, grid, camera, "first view"))
+    {
+    return 1;
+    }
+
+  if (!CheckOrder(sort, grid, camera, "same view"))
+    {
+    return 1;
+    }
+
+  // Small rotations sort the previous order again, until too many cells
+  // move for the insertion sort.
+  double angle = 0.001;
+  for (i = 0; i < 5; i++, angle *= 10.0)
+    {
+    camera->Azimuth(angle);
+    camera->Elevation(angle/2.0);
+    if (!CheckOrder(sort, grid, camera, "small rotation"))
+      {
+      return 1;
+      }
+    }
+
+  camera->Azimuth(90.0);
+  if (!CheckOrder(sort, grid, camera, "large rotation"))
+    {
+    return 1;
+    }
+
+  sort->SetDirectionToFrontToBack();
+  if (!CheckOrder(sort, grid, camera, "front to back"))
+    {
+    return 1;
+    }
+
+  // Moving the points recomputes the cell centers.
+  for (i = 0; i < points->GetNumberOfPoints(); i += 3)
+    {
+    double x[3];
+    points->GetPoint(i, x);
+    x[2] += 5.0;
+    points->SetPoint(i, x);
+    }
+  points->Modified();
+  if (!CheckOrder(sort, grid, camera, "modified points"))
+    {
+    return 1;
+    }
+
+  sort->SetNumberOfThreads(1);
+  sort->SetIncrementalSortAngle(0.0);
+  camera->Azimuth(0.5);
+  if (!CheckOrder(sort, grid, camera, "one thread"))
+    {
+    return 1;
+    }
+
+  // A global limit set after sorting with 4 threads leaves the results of
+  // the threads that no longer run in place.
+  sort->SetNumberOfThreads(4);
+  camera->Azimuth(0.5);
+  if (!CheckOrder(sort, grid, camera, "four threads again"))
+    {
+    return 1;
+    }
+  vtkMultiThreader::SetGlobalMaximumNumberOfThreads(2);
+  camera->Azimuth(0.5);
+  int limited = CheckOrder(sort, grid, camera, "global limit");
+  vtkMultiThreader::SetGlobalMaximumNumberOfThreads(0);
+  if (!limited)
+    {
+    return 1;
+    }
+
+  return 0;
+}
@@ -0,0 +1,349 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    $RCSfile$
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+
+// .NAME Test vtkVertexBufferPainter.
+// .SECTION Description
+// Renders polydata with point colors, cell colors, cell normals, no normals
+// on polys and strips, non-triangle polys in wireframe and with edges and
+// texture coordinates, first without and then from vertex buffers, and
+// checks that both images are the same. Immediate mode rendering is on, and
+// must not keep the vertex buffer painter out of the chain of
+// vtkDefaultPainter. Rendering again must upload nothing, and modifying the
+// points of one input must upload them and nothing else.
+
+#include "vtkActor.h"
+#include "vtkCellData.h"
+#include "vtkDefaultPainter.h"
+#include "vtkElevationFilter.h"
+#include "vtkFloatArray.h"
+#include "vtkImageData.h"
+#include "vtkImageDifference.h"
+#include "vtkPainterPolyDataMapper.h"
+#include "vtkPlaneSource.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkPolyDataNormals.h"
+#include "vtkProperty.h"
+#include "vtkRenderWindow.h"
+#include "vtkRenderer.h"
+#include "vtkSmartPointer.h"
+#include "vtkSphereSource.h"
+#include "vtkStripper.h"
+#include "vtkTexture.h"
+#include "vtkUnsignedCharArray.h"
+#include "vtkVertexBufferPainter.h"
+#include "vtkWindowToImageFilter.h"
+
+#include <vtkstd/vector>
+
+// Adds an actor rendering the polydata at the given position of a 3x3 grid
+// and returns it.
+static vtkActor* AddActor(vtkRenderer* renderer, vtkPolyData* input,
+                          int position)
+{
+  vtkSmartPointer<vtkPainterPolyDataMapper> mapper =
+    vtkSmartPointer<vtkPainterPolyDataMapper>::New();
+  mapper->SetInput(input);
+  vtkSmartPointer<vtkActor> actor = vtkSmartPointer<vtkActor>::New();
+  actor->SetMapper(mapper);
+  actor->SetPosition(1.5*(position%3), 1.5*(position/3), 0.0);
+  renderer->AddActor(actor);
+  return actor;
+}
+
+static vtkDefaultPainter* GetDefaultPainter(vtkActor* actor)
+{
+  return vtkDefaultPainter::SafeDownCast(
+    vtkPainterPolyDataMapper::SafeDownCast(actor->GetMapper())->GetPainter());
+}
+
+// Returns 1 if the vertex buffer painter is in the chain of the default
+// painter of the actor.
+static int UsesVertexBuffers(vtkActor* actor)
+{
+  vtkDefaultPainter* painter = GetDefaultPainter(actor);
+  if (!painter || !painter->GetVertexBufferPainter())
+    {
+    return 0;
+    }
+  for (vtkPainter* p = painter->GetDelegatePainter(); p;
+       p = p->GetDelegatePainter())
+    {
+    if (p == painter->GetVertexBufferPainter())
+      {
+      return 1;
+      }
+    }
+  return 0;
+}
+
+// Takes the vertex buffer painters out of the chains of the actors, or puts
+// them back.
+static void SetVertexBufferPainters(
+  const vtkstd::vector<vtkActor*>& actors,
+  const vtkstd::vector<vtkSmartPointer<vtkVertexBufferPainter> >& painters,
+  bool on)
+{
+  for (size_t i = 0; i < actors.size(); i++)
+    {
+    GetDefaultPainter(actors[i])->SetVertexBufferPainter(
+      on? painters[i].GetPointer() : 0);
+    }
+}
+
+// Returns the number of buffers the actors uploaded so far.
+static unsigned long CountUploads(
+  const vtkstd::vector<vtkSmartPointer<vtkVertexBufferPainter> >& painters)
+{
+  unsigned long count = 0;
+  for (size_t i = 0; i < painters.size(); i++)
+    {
+    count += painters[i]? painters[i]->GetNumberOfUploads() : 0;
+    }
+  return count;
+}
+
+// Returns the error between the images, above 10 when they differ.
+static double Compare(vtkImageData* image, vtkImageData* baseline)
+{
+  vtkSmartPointer<vtkImageDifference> difference =
+    vtkSmartPointer<vtkImageDifference>::New();
+  difference->SetInput(image);
+  difference->SetImage(baseline);
+  difference->Update();
+  return difference->GetThresholdedError();
+}
+
+static vtkSmartPointer<vtkImageData> Capture(vtkRenderWindow* renWin)
+{
+  vtkSmartPointer<vtkWindowToImageFilter> grabber =
+    vtkSmartPointer<vtkWindowToImageFilter>::New();
+  grabber->SetInput(renWin);
+  grabber->Update();
+  vtkSmartPointer<vtkImageData> image = vtkSmartPointer<vtkImageData>::New();
+  image->DeepCopy(grabber->GetOutput());
+  return image;
+}
+
+int TestVertexBufferPainter(int, char*[])
+{
+  vtkSmartPointer<vtkRenderWindow> renWin =
+    vtkSmartPointer<vtkRenderWindow>::New();
+  renWin->SetMultiSamples(0);
+  renWin->SetSize(300, 300);
+  vtkSmartPointer<vtkRenderer> renderer = vtkSmartPointer<vtkRenderer>::New();
+  renWin->AddRenderer(renderer);
+  vtkstd::vector<vtkActor*> actors;
+
+  vtkSmartPointer<vtkSphereSource> sphere =
+    vtkSmartPointer<vtkSphereSource>::New();
+  sphere->SetThetaResolution(16);
+  sphere->SetPhiResolution(16);
+  sphere->Update();
+
+  // Point colors.
+  vtkSmartPointer<vtkElevationFilter> elevation =
+    vtkSmartPointer<vtkElevationFilter>::New();
+  elevation->SetInputConnection(sphere->GetOutputPort());
+  elevation->SetLowPoint(0.0, -0.5, 0.0);
+  elevation->SetHighPoint(0.0, 0.5, 0.0);
+  elevation->Update();
+  actors.push_back(AddActor(renderer, elevation->GetPolyDataOutput(), 0));
+
+  // Cell colors.
+  vtkSmartPointer<vtkPolyData> cellColors =
+    vtkSmartPointer<vtkPolyData>::New();
+  cellColors->ShallowCopy(sphere->GetOutput());
+  vtkSmartPointer<vtkFloatArray> cellIds =
+    vtkSmartPointer<vtkFloatArray>::New();
+  for (vtkIdType i = 0; i < cellColors->GetNumberOfCells(); i++)
+    {
+    cellIds->InsertNextValue(i);
+    }
+  cellColors->GetCellData()->SetScalars(cellIds);
+  actors.push_back(AddActor(renderer, cellColors, 1));
+  actors.back()->GetMapper()->SetScalarModeToUseCellData();
+  actors.back()->GetMapper()->SetScalarRange(0, cellIds->GetMaxId());
+
+  // Cell normals.
+  vtkSmartPointer<vtkPolyDataNormals> normals =
+    vtkSmartPointer<vtkPolyDataNormals>::New();
+  normals->SetInputConnection(sphere->GetOutputPort());
+  normals->ComputePointNormalsOff();
+  normals->ComputeCellNormalsOn();
+  normals->Update();
+  actors.push_back(AddActor(renderer, normals->GetOutput(), 2));
+
+  // Normals built for polys and for strips.
+  vtkSmartPointer<vtkPolyData> noNormals =
+    vtkSmartPointer<vtkPolyData>::New();
+  noNormals->ShallowCopy(sphere->GetOutput());
+  noNormals->GetPointData()->SetNormals(0);
+  actors.push_back(AddActor(renderer, noNormals, 3));
+  vtkSmartPointer<vtkStripper> stripper = vtkSmartPointer<vtkStripper>::New();
+  stripper->SetInput(noNormals);
+  stripper->Update();
+  if (stripper->GetOutput()->GetNumberOfStrips() == 0)
+    {
+    cerr << "The sphere was not stripped." << endl;
+    return 1;
+    }
+  actors.push_back(AddActor(renderer, stripper->GetOutput(), 4));
+
+  // Quads in wireframe.
+  vtkSmartPointer<vtkPlaneSource> plane =
+    vtkSmartPointer<vtkPlaneSource>::New();
+  plane->SetResolution(4, 4);
+  plane->Update();
+  actors.push_back(AddActor(renderer, plane->GetOutput(), 5));
+  actors.back()->GetProperty()->SetRepresentationToWireframe();
+
+  // Texture coordinates, with a checkerboard texture.
+  vtkSmartPointer<vtkImageData> checkers =
+    vtkSmartPointer<vtkImageData>::New();
+  checkers->SetDimensions(8, 8, 1);
+  checkers->SetScalarTypeToUnsignedChar();
+  checkers->SetNumberOfScalarComponents(3);
+  vtkSmartPointer<vtkUnsignedCharArray> texels =
+    vtkSmartPointer<vtkUnsignedCharArray>::New();
+  texels->SetNumberOfComponents(3);
+  for (int j = 0; j < 8; j++)
+    {
+    for (int i = 0; i < 8; i++)
+      {
+      unsigned char value = ((i + j)%2)? 255 : 64;
+      texels->InsertNextTuple3(value, 255 - value, 128);
+      }
+    }
+  checkers->GetPointData()->SetScalars(texels);
+  vtkSmartPointer<vtkTexture> texture = vtkSmartPointer<vtkTexture>::New();
+  texture->SetInput(checkers);
+  texture->InterpolateOff();
+  actors.push_back(AddActor(renderer, plane->GetOutput(), 6));
+  actors.back()->SetTexture(texture);
+
+  // Quads with cell colors and edges.
+  vtkSmartPointer<vtkPolyData> edges = vtkSmartPointer<vtkPolyData>::New();
+  edges->ShallowCopy(plane->GetOutput());
+  vtkSmartPointer<vtkFloatArray> quadIds =
+    vtkSmartPointer<vtkFloatArray>::New();
+  for (vtkIdType i = 0; i < edges->GetNumberOfCells(); i++)
+    {
+    quadIds->InsertNextValue(i);
+    }
+  edges->GetCellData()->SetScalars(quadIds);
+  actors.push_back(AddActor(renderer, edges, 7));
+  actors.back()->GetMapper()->SetScalarModeToUseCellData();
+  actors.back()->GetMapper()->SetScalarRange(0, quadIds->GetMaxId());
+  actors.back()->GetProperty()->EdgeVisibilityOn();
+  actors.back()->GetProperty()->SetEdgeColor(1.0, 1.0, 0.0);
+
+  // A sphere of its own, whose points are modified later.
+  vtkSmartPointer<vtkPolyData> moved = vtkSmartPointer<vtkPolyData>::New();
+  moved->DeepCopy(sphere->GetOutput());
+  actors.push_back(AddActor(renderer, moved, 8));
+
+  renderer->ResetCamera();
+
+  vtkstd::vector<vtkSmartPointer<vtkVertexBufferPainter> > painters;
+  size_t i;
+  for (i = 0; i < actors.size(); i++)
+    {
+    actors[i]->GetMapper()->ImmediateModeRenderingOn();
+    painters.push_back(GetDefaultPainter(actors[i])->GetVertexBufferPainter());
+    }
+
+  // The baseline, without vertex buffers.
+  SetVertexBufferPainters(actors, painters, false);
+  renWin->Render();
+  vtkSmartPointer<vtkImageData> baseline = Capture(renWin);
+
+  // Render twice from the vertex buffers, the second time from the buffers
+  // uploaded the first time.
+  SetVertexBufferPainters(actors, painters, true);
+  renWin->Render();
+  unsigned long uploads = CountUploads(painters);
+  renWin->Render();
+  renWin->MakeCurrent();
+  int supported = painters[0] && painters[0]->IsSupported(renWin);
+  if (!supported)
+    {
+    cout << "Vertex buffers are not supported, the images of immediate mode "
+         << "are compared." << endl;
+    }
+  else
+    {
+    for (i = 0; i < actors.size(); i++)
+      {
+      if (!UsesVertexBuffers(actors[i]))
+        {
+        cerr << "Actor " << i << " does not render from vertex buffers."
+             << endl;
+        return 1;
+        }
+      }
+    if (CountUploads(painters) != uploads)
+      {
+      cerr << "Rendering again uploaded " << CountUploads(painters) - uploads
+           << " buffers." << endl;
+      return 1;
+      }
+    }
+
+  vtkSmartPointer<vtkImageData> image = Capture(renWin);
+  double error = Compare(image, baseline);
+  if (error > 10.0)
+    {
+    cerr << "The image rendered from vertex buffers differs from the one "
+         << "without by " << error << "." << endl;
+    return 1;
+    }
+
+  // Shrink the sphere of its own: only its points are uploaded again.
+  vtkPoints* points = moved->GetPoints();
+  for (vtkIdType j = 0; j < points->GetNumberOfPoints(); j++)
+    {
+    double x[3];
+    points->GetPoint(j, x);
+    points->SetPoint(j, 0.5*x[0], 0.5*x[1], 0.5*x[2]);
+    }
+  points->Modified();
+  uploads = CountUploads(painters);
+  renWin->Render();
+  if (supported && CountUploads(painters) != uploads + 1)
+    {
+    cerr << "Modifying the points uploaded " << CountUploads(painters) - uploads
+         << " buffers instead of 1." << endl;
+    return 1;
+    }
+  vtkSmartPointer<vtkImageData> modified = Capture(renWin);
+  if (Compare(modified, image) <= 10.0)
+    {
+    cerr << "The image was not updated after modifying the points." << endl;
+    return 1;
+    }
+
+  SetVertexBufferPainters(actors, painters, false);
+  renWin->Render();
+  error = Compare(modified, Capture(renWin));
+  if (error > 10.0)
+    {
+    cerr << "After modifying the points, the image rendered from vertex "
+         << "buffers differs from the one without by " << error << "." << endl;
+    return 1;
+    }
+  return 0;
+}
@@ -25,7 +25,9 @@
 #include "vtkPolyData.h"
 #include "vtkProperty.h"
 #include "vtkRepresentationPainter.h"
+#include "vtkRenderer.h"
 #include "vtkScalarsToColorsPainter.h"
+#include "vtkVertexBufferPainter.h"
 
 vtkStandardNewMacro(vtkDefaultPainter);
 vtkCxxRevisionMacro(vtkDefaultPainter, "$Revision$");
@@ -41,6 +43,8 @@ vtkCxxSetObjectMacro(vtkDefaultPainter, CoincidentTopologyResolutionPainter,
   vtkCoincidentTopologyResolutionPainter);
 vtkCxxSetObjectMacro(vtkDefaultPainter, LightingPainter, vtkLightingPainter);
 vtkCxxSetObjectMacro(vtkDefaultPainter, RepresentationPainter, vtkRepresentationPainter);
+vtkCxxSetObjectMacro(vtkDefaultPainter, VertexBufferPainter,
+  vtkVertexBufferPainter);
 //-----------------------------------------------------------------------------
 vtkDefaultPainter::vtkDefaultPainter()
 {
@@ -51,7 +55,9 @@ vtkDefaultPainter::vtkDefaultPainter()
   this->CoincidentTopologyResolutionPainter = 0;
   this->LightingPainter = 0;
   this->RepresentationPainter = 0;
+  this->VertexBufferPainter = 0;
   this->DefaultPainterDelegate = 0;
+  this->UseVertexBuffers = 0;
 
   vtkScalarsToColorsPainter* scp = vtkScalarsToColorsPainter::New();
   this->SetScalarsToColorsPainter(scp);
@@ -81,6 +87,14 @@ vtkDefaultPainter::vtkDefaultPainter()
   vtkRepresentationPainter* vp = vtkRepresentationPainter::New();
   this->SetRepresentationPainter(vp);
   vp->Delete();
+
+  // There is no vertex buffer painter for some graphics libraries.
+  vtkVertexBufferPainter* vbp = vtkVertexBufferPainter::New();
+  if (vbp)
+    {
+    this->SetVertexBufferPainter(vbp);
+    vbp->Delete();
+    }
 }
 
 //-----------------------------------------------------------------------------
@@ -93,6 +107,7 @@ vtkDefaultPainter::~vtkDefaultPainter()
   this->SetCoincidentTopologyResolutionPainter(0);
   this->SetLightingPainter(0);
   this->SetRepresentationPainter(0);
+  this->SetVertexBufferPainter(0);
   this->SetDefaultPainterDelegate(0);
 }
 
@@ -125,7 +140,9 @@ void vtkDefaultPainter::BuildPainterChain()
     headPainter = (headPainter)? headPainter : painter;
     }
 
-  painter = this->GetDisplayListPainter();
+  // Vertex buffers already keep the geometry on the graphics card, there is
+  // no need for display lists.
+  painter = this->UseVertexBuffers? 0 : this->GetDisplayListPainter();
   if (painter)
     {
     if (prevPainter)
@@ -182,6 +199,17 @@ void vtkDefaultPainter::BuildPainterChain()
     headPainter = (headPainter)? headPainter : painter;
     }  
 
+  painter = this->UseVertexBuffers? this->GetVertexBufferPainter() : 0;
+  if (painter)
+    {
+    if (prevPainter)
+      {
+      prevPainter->SetDelegatePainter(painter);
+      }
+    prevPainter = painter;
+    headPainter = (headPainter)? headPainter : painter;
+    }
+
   // this will set in internal delegate painter.
   this->Superclass::SetDelegatePainter(headPainter);
   if (prevPainter)
@@ -193,8 +221,16 @@ void vtkDefaultPainter::BuildPainterChain()
 void vtkDefaultPainter::Render(vtkRenderer* renderer, vtkActor* actor, 
                                unsigned long typeflags, bool forceCompileOnly)
 {
-  if (this->ChainBuildTime < this->MTime)
+  // Immediate mode rendering, asked for by the mapper or globally, only
+  // keeps the display lists out: the vertex buffers hold no more than the
+  // arrays, and only the modified ones are uploaded again.
+  int useVertexBuffers = (this->VertexBufferPainter &&
+    this->VertexBufferPainter->IsSupported(renderer->GetRenderWindow()))?
+    1 : 0;
+  if (this->ChainBuildTime < this->MTime ||
+    this->UseVertexBuffers != useVertexBuffers)
     {
+    this->UseVertexBuffers = useVertexBuffers;
     this->BuildPainterChain();
     this->ChainBuildTime.Modified();
     }
@@ -212,6 +248,11 @@ void vtkDefaultPainter::ReleaseGraphicsResources(vtkWindow *window)
     {
     this->ScalarsToColorsPainter->ReleaseGraphicsResources(window);
     }
+  // It may have rendered before being left out of the chain.
+  if (this->VertexBufferPainter)
+    {
+    this->VertexBufferPainter->ReleaseGraphicsResources(window);
+    }
   this->Superclass::ReleaseGraphicsResources(window);
 }
 
@@ -240,6 +281,8 @@ void vtkDefaultPainter::ReportReferences(vtkGarbageCollector* collector)
     "Lighting Painter");
   vtkGarbageCollectorReport(collector, this->RepresentationPainter,
     "Wireframe Painter");
+  vtkGarbageCollectorReport(collector, this->VertexBufferPainter,
+    "VertexBuffer Painter");
   vtkGarbageCollectorReport(collector, this->DefaultPainterDelegate,
     "DefaultPainter Delegate");
 }
@@ -359,4 +402,15 @@ void vtkDefaultPainter::PrintSelf(ostream& os, vtkIndent indent)
     {
     os << "(none)" << endl;
     }
+
+  os << indent << "VertexBufferPainter: " ;
+  if (this->VertexBufferPainter)
+    {
+    os << endl ;
+    this->VertexBufferPainter->PrintSelf(os, indent.GetNextIndent());
+    }
+  else
+    {
+    os << "(none)" << endl;
+    }
 }
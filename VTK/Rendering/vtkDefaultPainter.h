@@ -23,6 +23,11 @@
 // vtkCoincidentTopologyResolutionPainter -->
 // vtkLightingPainter --> vtkRepresentationPainter --> 
 // \<Delegate of vtkDefaultPainter\>.
+// When the render window supports vertex buffers, the vtkDisplayListPainter
+// is left out and a vtkVertexBufferPainter is put in front of the delegate,
+// whether immediate mode rendering is on or not (see
+// vtkMapper::SetImmediateModeRendering()). Set the vertex buffer painter to
+// NULL to send every vertex on every render.
 // Typically, the delegate of the default painter be one that is capable of r
 // rendering graphics primitives or a vtkChooserPainter which can select appropriate
 // painters to do the rendering.
@@ -39,6 +44,7 @@ class vtkDisplayListPainter;
 class vtkLightingPainter;
 class vtkRepresentationPainter;
 class vtkScalarsToColorsPainter;
+class vtkVertexBufferPainter;
 
 class VTK_RENDERING_EXPORT vtkDefaultPainter : public vtkPainter
 {
@@ -84,6 +90,13 @@ public:
   void SetRepresentationPainter(vtkRepresentationPainter*);
   vtkGetObjectMacro(RepresentationPainter, vtkRepresentationPainter);
 
+  // Description:
+  // Get/Set the painter that renders from vertex buffers. It replaces the
+  // display list painter in the chain when it supports the render window.
+  // Set it to NULL to always use display lists.
+  void SetVertexBufferPainter(vtkVertexBufferPainter*);
+  vtkGetObjectMacro(VertexBufferPainter, vtkVertexBufferPainter);
+
   // Description:
   // Set/Get the painter to which this painter should propagare its draw calls.
   // These methods are overridden so that the delegate is set
@@ -98,6 +111,8 @@ public:
   // since last BuildPainterChain();
   // Building of the chain does not depend on input polydata,
   // hence it does not check if the input has changed at all.
+  // It is also rebuilt when the vertex buffer painter starts or stops
+  // supporting the render window.
   virtual void Render(vtkRenderer* renderer, vtkActor* actor, 
                       unsigned long typeflags, bool forceCompileOnly);
 
@@ -133,8 +148,13 @@ protected:
   vtkCoincidentTopologyResolutionPainter* CoincidentTopologyResolutionPainter;
   vtkLightingPainter* LightingPainter;
   vtkRepresentationPainter* RepresentationPainter;
+  vtkVertexBufferPainter* VertexBufferPainter;
   vtkTimeStamp ChainBuildTime;
 
+  // Whether the chain renders with the VertexBufferPainter instead of the
+  // DisplayListPainter.
+  int UseVertexBuffers;
+
   vtkPainter* DefaultPainterDelegate;
   void  SetDefaultPainterDelegate(vtkPainter*);
 
@@ -36,6 +36,7 @@
 #include "vtkOpenGLRepresentationPainter.h"
 #include "vtkOpenGLScalarsToColorsPainter.h"
 #include "vtkOpenGLTexture.h"
+#include "vtkOpenGLVertexBufferPainter.h"
 #endif
 
 // Win32 specific stuff
@@ -397,6 +398,18 @@ vtkObject* vtkGraphicsFactory::CreateInstance(const char* vtkclassname )
 #endif
       return vtkOpenGLTexture::New();
       }
+    if (strcmp(vtkclassname, "vtkVertexBufferPainter") == 0)
+      {
+#if defined(VTK_USE_MANGLED_MESA)
+      // The vertex buffer painter calls the OpenGL library, not the
+      // mangled Mesa one. Render without vertex buffers.
+      if ( vtkGraphicsFactory::UseMesaClasses )
+        {
+        return 0;
+        }
+#endif
+      return vtkOpenGLVertexBufferPainter::New();
+      }
     }
 #endif
         
@@ -0,0 +1,1125 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    $RCSfile$
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkOpenGLVertexBufferPainter.h"
+
+#include "vtkCellArray.h"
+#include "vtkDataArray.h"
+#include "vtkObjectFactory.h"
+#include "vtkOpenGLExtensionManager.h"
+#include "vtkOpenGLRenderWindow.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkPolygon.h"
+#include "vtkRenderer.h"
+#include "vtkTriangle.h"
+#include "vtkUnsignedCharArray.h"
+#include "vtkWeakPointer.h"
+
+#include "vtkgl.h"
+#include "vtkOpenGL.h"
+
+#include <vtkstd/map>
+#include <vtkstd/vector>
+
+vtkStandardNewMacro(vtkOpenGLVertexBufferPainter);
+vtkCxxRevisionMacro(vtkOpenGLVertexBufferPainter, "$Revision$");
+
+// The primitive types, in the order they are drawn and numbered, and the
+// OpenGL primitive each one is drawn with.
+static const unsigned long vtkOpenGLVertexBufferPainterTypes[4] =
+{
+  vtkPainter::VERTS, vtkPainter::LINES, vtkPainter::POLYS, vtkPainter::STRIPS
+};
+static const GLenum vtkOpenGLVertexBufferPainterModes[4] =
+{
+  GL_POINTS, GL_LINES, GL_TRIANGLES, GL_TRIANGLES
+};
+
+//-----------------------------------------------------------------------------
+// Copies a float or double tuple to floats.
+static inline void vtkOpenGLVertexBufferPainterCopyTuple(const void* data,
+  int type, int comps, vtkIdType id, float* to)
+{
+  if (type == VTK_FLOAT)
+    {
+    const float* from = static_cast<const float*>(data) + comps*id;
+    for (int i = 0; i < comps; ++i)
+      {
+      to[i] = from[i];
+      }
+    }
+  else
+    {
+    const double* from = static_cast<const double*>(data) + comps*id;
+    for (int i = 0; i < comps; ++i)
+      {
+      to[i] = static_cast<float>(from[i]);
+      }
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Walks the cells of ca as primitives of the given type (index in
+// vtkOpenGLVertexBufferPainterTypes, or 4 for the edges of polygons) and
+// gives the vertices of the OpenGL primitives drawing them to the visitor.
+// Polygons are split in triangle fans, or in segments for their edges.
+// Every other triangle of a strip is turned over so that all of them keep
+// the orientation of the strip. The visitor gets Polygon() and Triangle()
+// calls before the vertices of each polygon and strip triangle, to build
+// normals.
+template <class TVisitor>
+static void vtkOpenGLVertexBufferPainterVisit(vtkCellArray* ca, int type,
+  vtkIdType cellId, TVisitor& visitor)
+{
+  vtkIdType *ptIds = ca->GetPointer();
+  vtkIdType *endPtIds = ptIds + ca->GetNumberOfConnectivityEntries();
+  vtkIdType tri[3];
+  vtkIdType nPts;
+  vtkIdType i;
+
+  for (; ptIds < endPtIds; ptIds += nPts, ++cellId)
+    {
+    nPts = *ptIds;
+    ++ptIds;
+    switch (type)
+      {
+      case 0:
+        for (i = 0; i < nPts; ++i)
+          {
+          visitor.Vertex(ptIds[i], cellId);
+          }
+        break;
+      case 1:
+        for (i = 1; i < nPts; ++i)
+          {
+          visitor.Vertex(ptIds[i-1], cellId);
+          visitor.Vertex(ptIds[i], cellId);
+          }
+        break;
+      case 2:
+        if (nPts >= 3)
+          {
+          visitor.Polygon(nPts, ptIds);
+          }
+        for (i = 2; i < nPts; ++i)
+          {
+          visitor.Vertex(ptIds[0], cellId);
+          visitor.Vertex(ptIds[i-1], cellId);
+          visitor.Vertex(ptIds[i], cellId);
+          }
+        break;
+      case 4:
+        if (nPts >= 3)
+          {
+          visitor.Polygon(nPts, ptIds);
+          }
+        for (i = 0; i < nPts; ++i)
+          {
+          visitor.Vertex(ptIds[i], cellId);
+          visitor.Vertex(ptIds[(i+1) % nPts], cellId);
+          }
+        break;
+      case 3:
+        for (i = 2; i < nPts; ++i)
+          {
+          tri[0] = ptIds[(i % 2)? i-1 : i-2];
+          tri[1] = ptIds[(i % 2)? i-2 : i-1];
+          tri[2] = ptIds[i];
+          visitor.Triangle(tri);
+          visitor.Vertex(tri[0], cellId);
+          visitor.Vertex(tri[1], cellId);
+          visitor.Vertex(tri[2], cellId);
+          }
+        break;
+      }
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Counts the vertices of the primitives.
+class vtkOpenGLVertexBufferPainterCounter
+{
+public:
+  vtkOpenGLVertexBufferPainterCounter() : Count(0) {}
+  void Polygon(vtkIdType, vtkIdType*) {}
+  void Triangle(vtkIdType*) {}
+  void Vertex(vtkIdType, vtkIdType) { ++this->Count; }
+
+  vtkIdType Count;
+};
+
+//-----------------------------------------------------------------------------
+// Writes the point ids of the vertices of the primitives.
+class vtkOpenGLVertexBufferPainterIndexWriter
+{
+public:
+  void Polygon(vtkIdType, vtkIdType*) {}
+  void Triangle(vtkIdType*) {}
+  void Vertex(vtkIdType ptId, vtkIdType)
+    {
+    *this->Indices = static_cast<GLuint>(ptId);
+    ++this->Indices;
+    }
+
+  GLuint* Indices;
+};
+
+//-----------------------------------------------------------------------------
+// Writes the vertices of the primitives with their point or cell
+// attributes, and the normals of polygons and strip triangles when they are
+// built.
+class vtkOpenGLVertexBufferPainterVertexWriter
+{
+public:
+  void Polygon(vtkIdType nPts, vtkIdType* ptIds)
+    {
+    if (this->NormalMode == BUILT_NORMALS)
+      {
+      vtkPolygon::ComputeNormal(this->Points, static_cast<int>(nPts), ptIds,
+        this->BuiltNormal);
+      }
+    }
+  void Triangle(vtkIdType* ptIds)
+    {
+    if (this->NormalMode == BUILT_NORMALS)
+      {
+      vtkTriangle::ComputeNormal(this->Points, 3, ptIds, this->BuiltNormal);
+      }
+    }
+  void Vertex(vtkIdType ptId, vtkIdType cellId)
+    {
+    vtkOpenGLVertexBufferPainterCopyTuple(this->PointData, this->PointType,
+      3, ptId, this->OutPoints);
+    this->OutPoints += 3;
+    if (this->OutNormals)
+      {
+      switch (this->NormalMode)
+        {
+        case POINT_NORMALS:
+        case CELL_NORMALS:
+          vtkOpenGLVertexBufferPainterCopyTuple(this->NormalData,
+            this->NormalType, 3,
+            (this->NormalMode == CELL_NORMALS)? cellId : ptId,
+            this->OutNormals);
+          break;
+        case BUILT_NORMALS:
+          this->OutNormals[0] = static_cast<float>(this->BuiltNormal[0]);
+          this->OutNormals[1] = static_cast<float>(this->BuiltNormal[1]);
+          this->OutNormals[2] = static_cast<float>(this->BuiltNormal[2]);
+          break;
+        default:
+          this->OutNormals[0] = this->OutNormals[1] = this->OutNormals[2] = 0;
+          break;
+        }
+      this->OutNormals += 3;
+      }
+    if (this->OutColors)
+      {
+      const unsigned char* rgba =
+        this->ColorData + 4*(this->CellColors? cellId : ptId);
+      this->OutColors[0] = rgba[0];
+      this->OutColors[1] = rgba[1];
+      this->OutColors[2] = rgba[2];
+      this->OutColors[3] = rgba[3];
+      this->OutColors += 4;
+      }
+    if (this->OutTCoords)
+      {
+      vtkOpenGLVertexBufferPainterCopyTuple(this->TCoordData,
+        this->TCoordType, this->TCoordComponents, ptId, this->OutTCoords);
+      this->OutTCoords += this->TCoordComponents;
+      }
+    }
+
+  enum
+  {
+    NO_NORMALS,
+    POINT_NORMALS,
+    CELL_NORMALS,
+    BUILT_NORMALS
+  };
+
+  vtkPoints* Points;
+  const void* PointData;
+  int PointType;
+  int NormalMode;
+  const void* NormalData;
+  int NormalType;
+  const unsigned char* ColorData;
+  int CellColors;
+  const void* TCoordData;
+  int TCoordType;
+  int TCoordComponents;
+
+  float* OutPoints;
+  float* OutNormals;
+  unsigned char* OutColors;
+  float* OutTCoords;
+  double BuiltNormal[3];
+};
+
+//-----------------------------------------------------------------------------
+class vtkOpenGLVertexBufferPainter::vtkInternals
+{
+public:
+  typedef vtkstd::vector<void*> SourcesType;
+
+  // An OpenGL buffer object and what it was last filled from: the arrays,
+  // their modification time and the layout of the data.
+  class Buffer
+  {
+  public:
+    Buffer() : Handle(0), MTime(0), Layout(0), Uploads(0) {}
+
+    bool IsStale(const SourcesType& sources, unsigned long mtime,
+                 unsigned long layout) const
+      {
+      return this->Handle == 0 || this->MTime != mtime ||
+        this->Layout != layout || this->Sources != sources;
+      }
+
+    void SetKey(const SourcesType& sources, unsigned long mtime,
+                unsigned long layout)
+      {
+      this->Sources = sources;
+      this->MTime = mtime;
+      this->Layout = layout;
+      }
+
+    // Fills the buffer with size bytes from data, or allocates them when
+    // data is null. Returns false when the memory could not be allocated.
+    bool Upload(GLenum target, const void* data, vtkIdType size)
+      {
+      if (!this->Handle)
+        {
+        vtkgl::GenBuffers(1, &this->Handle);
+        }
+      if (this->Uploads)
+        {
+        ++*this->Uploads;
+        }
+      this->Sources.clear();
+      vtkgl::BindBuffer(target, this->Handle);
+      vtkgl::BufferData(target, static_cast<vtkgl::GLsizeiptr>(size), data,
+        vtkgl::STATIC_DRAW);
+      vtkgl::BindBuffer(target, 0);
+      if (glGetError() == GL_OUT_OF_MEMORY)
+        {
+        this->Release();
+        return false;
+        }
+      return true;
+      }
+
+    // Allocates size bytes and maps them for writing. Returns null when the
+    // memory could not be allocated or mapped.
+    void* Map(GLenum target, vtkIdType size)
+      {
+      if (!this->Upload(target, 0, size))
+        {
+        return 0;
+        }
+      vtkgl::BindBuffer(target, this->Handle);
+      void* data = vtkgl::MapBuffer(target, vtkgl::WRITE_ONLY);
+      if (!data)
+        {
+        vtkgl::BindBuffer(target, 0);
+        this->Release();
+        }
+      return data;
+      }
+
+    // Unmaps a buffer filled after Map(). Returns false when the data was
+    // lost meanwhile.
+    bool Unmap(GLenum target)
+      {
+      GLboolean valid = vtkgl::UnmapBuffer(target);
+      vtkgl::BindBuffer(target, 0);
+      if (valid != GL_TRUE)
+        {
+        this->Release();
+        return false;
+        }
+      return true;
+      }
+
+    void Release()
+      {
+      if (this->Handle)
+        {
+        vtkgl::DeleteBuffers(1, &this->Handle);
+        }
+      this->Handle = 0;
+      this->Sources.clear();
+      this->MTime = 0;
+      this->Layout = 0;
+      }
+
+    GLuint Handle;
+    SourcesType Sources;
+    unsigned long MTime;
+    unsigned long Layout;
+
+    // Counts the uploads of the painter, when set.
+    unsigned long* Uploads;
+  };
+
+  // The vertices of the primitives drawn with attributes per cell, as
+  // floats. Normals, colors and texture coordinates follow the points at
+  // the given byte offsets.
+  class VertexBuffer
+  {
+  public:
+    VertexBuffer() : NormalsOffset(0), ColorsOffset(0), TCoordsOffset(0)
+      {
+      for (int i = 0; i < 4; ++i)
+        {
+        this->Offsets[i] = this->Counts[i] = 0;
+        this->Normals[i] = 0;
+        }
+      }
+
+    Buffer Data;
+    vtkIdType Offsets[4];
+    vtkIdType Counts[4];
+    int Normals[4];
+    size_t NormalsOffset;
+    size_t ColorsOffset;
+    size_t TCoordsOffset;
+  };
+
+  // The buffers of one input.
+  class BufferSet
+  {
+  public:
+    BufferSet(unsigned long* uploads)
+      {
+      this->PolysAreTriangles = 1;
+      this->PolysChecked = 0;
+      this->PolysMTime = 0;
+      this->FailedMTime = 0;
+      this->EdgeCount = 0;
+      for (int i = 0; i < 4; ++i)
+        {
+        this->ElementOffsets[i] = this->ElementCounts[i] = 0;
+        }
+      this->Points.Uploads = this->Normals.Uploads = uploads;
+      this->Colors.Uploads = this->TCoords.Uploads = uploads;
+      this->Elements.Uploads = this->Edges.Uploads = uploads;
+      this->Vertices.Data.Uploads = this->EdgeVertices.Data.Uploads = uploads;
+      }
+
+    void Release()
+      {
+      this->Points.Release();
+      this->Normals.Release();
+      this->Colors.Release();
+      this->TCoords.Release();
+      this->Elements.Release();
+      this->Edges.Release();
+      this->Vertices.Data.Release();
+      this->EdgeVertices.Data.Release();
+      }
+
+    vtkWeakPointer<vtkPolyData> Input;
+
+    // The points and point attributes as they are, and the point ids of
+    // the vertices of the primitives of each type.
+    Buffer Points;
+    Buffer Normals;
+    Buffer Colors;
+    Buffer TCoords;
+    Buffer Elements;
+    vtkIdType ElementOffsets[4];
+    vtkIdType ElementCounts[4];
+
+    // The point ids of the edges of the polygons, for polygons other than
+    // triangles drawn as lines.
+    Buffer Edges;
+    vtkIdType EdgeCount;
+
+    // The vertices of the primitives drawn with attributes per cell, and
+    // of the edges of their polygons.
+    VertexBuffer Vertices;
+    VertexBuffer EdgeVertices;
+
+    // Whether all the polygons are triangles, for the polys last checked.
+    int PolysAreTriangles;
+    void* PolysChecked;
+    unsigned long PolysMTime;
+
+    // Modification time of the input when uploading its buffers failed.
+    unsigned long FailedMTime;
+  };
+
+  typedef vtkstd::map<vtkPolyData*, BufferSet*> BufferSetMapType;
+  BufferSetMapType BufferSets;
+
+  // Window IsSupported() was last called for, and its answer.
+  vtkWeakPointer<vtkRenderWindow> SupportWindow;
+  int Supported;
+
+  // Number of buffers filled since the painter was created.
+  unsigned long* Uploads;
+
+  vtkInternals() : Supported(0), Uploads(0) {}
+  ~vtkInternals()
+    {
+    this->Clear();
+    }
+
+  // Returns the buffers of input. Buffers of inputs that were deleted are
+  // released when a new input comes.
+  BufferSet* GetBufferSet(vtkPolyData* input)
+    {
+    BufferSetMapType::iterator iter = this->BufferSets.find(input);
+    if (iter != this->BufferSets.end() && iter->second->Input == input)
+      {
+      return iter->second;
+      }
+    iter = this->BufferSets.begin();
+    while (iter != this->BufferSets.end())
+      {
+      if (!iter->second->Input)
+        {
+        iter->second->Release();
+        delete iter->second;
+        this->BufferSets.erase(iter++);
+        }
+      else
+        {
+        ++iter;
+        }
+      }
+    BufferSet* set = new BufferSet(this->Uploads);
+    set->Input = input;
+    this->BufferSets[input] = set;
+    return set;
+    }
+
+  // Deletes the buffer objects. The context must be current.
+  void ReleaseAll()
+    {
+    BufferSetMapType::iterator iter;
+    for (iter = this->BufferSets.begin(); iter != this->BufferSets.end();
+      ++iter)
+      {
+      iter->second->Release();
+      }
+    }
+
+  // Forgets the buffers, whether they were deleted or not.
+  void Clear()
+    {
+    BufferSetMapType::iterator iter;
+    for (iter = this->BufferSets.begin(); iter != this->BufferSets.end();
+      ++iter)
+      {
+      delete iter->second;
+      }
+    this->BufferSets.clear();
+    }
+
+  static void GetCells(vtkPolyData* input, vtkCellArray* cells[4],
+                       SourcesType& sources, unsigned long& mtime)
+    {
+    cells[0] = input->GetVerts();
+    cells[1] = input->GetLines();
+    cells[2] = input->GetPolys();
+    cells[3] = input->GetStrips();
+    for (int i = 0; i < 4; ++i)
+      {
+      sources.push_back(cells[i]);
+      if (cells[i]->GetMTime() > mtime)
+        {
+        mtime = cells[i]->GetMTime();
+        }
+      }
+    }
+
+  // Updates set->PolysAreTriangles if the polys changed.
+  static void CheckPolys(BufferSet* set, vtkCellArray* polys)
+    {
+    if (set->PolysChecked == polys && set->PolysMTime == polys->GetMTime())
+      {
+      return;
+      }
+    vtkIdType *ptIds = polys->GetPointer();
+    vtkIdType *endPtIds = ptIds + polys->GetNumberOfConnectivityEntries();
+    set->PolysAreTriangles = 1;
+    for (; ptIds < endPtIds; ptIds += *ptIds + 1)
+      {
+      if (*ptIds > 3)
+        {
+        set->PolysAreTriangles = 0;
+        break;
+        }
+      }
+    set->PolysChecked = polys;
+    set->PolysMTime = polys->GetMTime();
+    }
+
+  // Uploads array into buffer if it changed. mtime may account for more
+  // than the array (e.g. the vtkPoints holding it).
+  static bool UpdateArray(Buffer& buffer, vtkDataArray* array,
+                          vtkIdType numTuples, unsigned long mtime)
+    {
+    SourcesType sources(1, array);
+    if (!buffer.IsStale(sources, mtime, 0))
+      {
+      return true;
+      }
+    if (!buffer.Upload(vtkgl::ARRAY_BUFFER, array->GetVoidPointer(0),
+        numTuples*array->GetNumberOfComponents()*array->GetDataTypeSize()))
+      {
+      return false;
+      }
+    buffer.SetKey(sources, mtime, 0);
+    return true;
+    }
+
+  // Uploads the point ids of the primitives of all types if the cells
+  // changed.
+  static bool UpdateElements(BufferSet* set, vtkPolyData* input)
+    {
+    vtkCellArray* cells[4];
+    SourcesType sources;
+    unsigned long mtime = 0;
+    vtkInternals::GetCells(input, cells, sources, mtime);
+    if (!set->Elements.IsStale(sources, mtime, 0))
+      {
+      return true;
+      }
+
+    vtkIdType total = 0;
+    int i;
+    for (i = 0; i < 4; ++i)
+      {
+      vtkOpenGLVertexBufferPainterCounter counter;
+      vtkOpenGLVertexBufferPainterVisit(cells[i], i, 0, counter);
+      set->ElementOffsets[i] = total;
+      set->ElementCounts[i] = counter.Count;
+      total += counter.Count;
+      }
+
+    GLenum target = vtkgl::ELEMENT_ARRAY_BUFFER;
+    if (total == 0)
+      {
+      if (!set->Elements.Upload(target, 0, 0))
+        {
+        return false;
+        }
+      }
+    else
+      {
+      vtkOpenGLVertexBufferPainterIndexWriter writer;
+      writer.Indices = static_cast<GLuint*>(
+        set->Elements.Map(target, total*sizeof(GLuint)));
+      if (!writer.Indices)
+        {
+        return false;
+        }
+      for (i = 0; i < 4; ++i)
+        {
+        vtkOpenGLVertexBufferPainterVisit(cells[i], i, 0, writer);
+        }
+      if (!set->Elements.Unmap(target))
+        {
+        return false;
+        }
+      }
+    set->Elements.SetKey(sources, mtime, 0);
+    return true;
+    }
+
+  // Uploads the point ids of the edges of the polygons if they changed.
+  static bool UpdateEdges(BufferSet* set, vtkCellArray* polys)
+    {
+    SourcesType sources(1, polys);
+    unsigned long mtime = polys->GetMTime();
+    if (!set->Edges.IsStale(sources, mtime, 0))
+      {
+      return true;
+      }
+
+    vtkOpenGLVertexBufferPainterCounter counter;
+    vtkOpenGLVertexBufferPainterVisit(polys, 4, 0, counter);
+    set->EdgeCount = counter.Count;
+    GLenum target = vtkgl::ELEMENT_ARRAY_BUFFER;
+    if (counter.Count == 0)
+      {
+      if (!set->Edges.Upload(target, 0, 0))
+        {
+        return false;
+        }
+      }
+    else
+      {
+      vtkOpenGLVertexBufferPainterIndexWriter writer;
+      writer.Indices = static_cast<GLuint*>(
+        set->Edges.Map(target, counter.Count*sizeof(GLuint)));
+      if (!writer.Indices)
+        {
+        return false;
+        }
+      vtkOpenGLVertexBufferPainterVisit(polys, 4, 0, writer);
+      if (!set->Edges.Unmap(target))
+        {
+        return false;
+        }
+      }
+    set->Edges.SetKey(sources, mtime, 0);
+    return true;
+    }
+
+  // Uploads the vertices of the primitives of the types in expand with
+  // their attributes into vb if anything they are built from changed. n
+  // and c are point or cell attributes, as cellNormals and cellColors say,
+  // and normals are built for polys and strips when buildNormals is set.
+  // Polys are written as their edges when polyEdges is set.
+  static bool UpdateVertices(VertexBuffer& vb, vtkPolyData* input,
+    unsigned long expand, vtkDataArray* n, int cellNormals,
+    vtkUnsignedCharArray* c, int cellColors, vtkDataArray* t,
+    int buildNormals, int polyEdges)
+    {
+    vtkPoints* p = input->GetPoints();
+    vtkCellArray* cells[4];
+    SourcesType sources;
+    unsigned long mtime = p->GetMTime();
+    sources.push_back(p->GetData());
+    sources.push_back(n);
+    sources.push_back(c);
+    sources.push_back(t);
+    vtkInternals::GetCells(input, cells, sources, mtime);
+    if (n && n->GetMTime() > mtime)
+      {
+      mtime = n->GetMTime();
+      }
+    if (c && c->GetMTime() > mtime)
+      {
+      mtime = c->GetMTime();
+      }
+    if (t && t->GetMTime() > mtime)
+      {
+      mtime = t->GetMTime();
+      }
+    unsigned long layout = expand | (cellNormals? 0x10 : 0) |
+      (cellColors? 0x20 : 0) | (buildNormals? 0x40 : 0);
+    if (!vb.Data.IsStale(sources, mtime, layout))
+      {
+      return true;
+      }
+
+    vtkOpenGLVertexBufferPainterVertexWriter writer;
+    int normalModes[4];
+    int hasNormals = 0;
+    vtkIdType total = 0;
+    int i;
+    for (i = 0; i < 4; ++i)
+      {
+      normalModes[i] = writer.NO_NORMALS;
+      if (n)
+        {
+        normalModes[i] = cellNormals? writer.CELL_NORMALS :
+          writer.POINT_NORMALS;
+        }
+      else if (buildNormals && i >= 2)
+        {
+        normalModes[i] = writer.BUILT_NORMALS;
+        }
+
+      vb.Offsets[i] = total;
+      vb.Counts[i] = 0;
+      vb.Normals[i] = 0;
+      if (expand & vtkOpenGLVertexBufferPainterTypes[i])
+        {
+        vtkOpenGLVertexBufferPainterCounter counter;
+        vtkOpenGLVertexBufferPainterVisit(cells[i],
+          (i == 2 && polyEdges)? 4 : i, 0, counter);
+        vb.Counts[i] = counter.Count;
+        vb.Normals[i] = (normalModes[i] != writer.NO_NORMALS);
+        hasNormals |= vb.Normals[i];
+        total += counter.Count;
+        }
+      }
+
+    int tcomps = t? t->GetNumberOfComponents() : 0;
+    size_t size = 3*sizeof(float)*total;
+    vb.NormalsOffset = size;
+    size += hasNormals? 3*sizeof(float)*total : 0;
+    vb.ColorsOffset = size;
+    size += c? 4*total : 0;
+    vb.TCoordsOffset = size;
+    size += tcomps*sizeof(float)*total;
+
+    GLenum target = vtkgl::ARRAY_BUFFER;
+    if (total == 0)
+      {
+      if (!vb.Data.Upload(target, 0, 0))
+        {
+        return false;
+        }
+      vb.Data.SetKey(sources, mtime, layout);
+      return true;
+      }
+
+    char* data = static_cast<char*>(vb.Data.Map(target, size));
+    if (!data)
+      {
+      return false;
+      }
+    writer.Points = p;
+    writer.PointData = p->GetVoidPointer(0);
+    writer.PointType = p->GetDataType();
+    writer.NormalData = n? n->GetVoidPointer(0) : 0;
+    writer.NormalType = n? n->GetDataType() : 0;
+    writer.ColorData = c? c->GetPointer(0) : 0;
+    writer.CellColors = cellColors;
+    writer.TCoordData = t? t->GetVoidPointer(0) : 0;
+    writer.TCoordType = t? t->GetDataType() : 0;
+    writer.TCoordComponents = tcomps;
+    writer.OutPoints = reinterpret_cast<float*>(data);
+    writer.OutNormals = hasNormals?
+      reinterpret_cast<float*>(data + vb.NormalsOffset) : 0;
+    writer.OutColors = c?
+      reinterpret_cast<unsigned char*>(data + vb.ColorsOffset) : 0;
+    writer.OutTCoords = t?
+      reinterpret_cast<float*>(data + vb.TCoordsOffset) : 0;
+
+    // Cell attributes are numbered over verts, lines, polys and strips.
+    vtkIdType cellId = 0;
+    for (i = 0; i < 4; ++i)
+      {
+      if (expand & vtkOpenGLVertexBufferPainterTypes[i])
+        {
+        writer.NormalMode = normalModes[i];
+        vtkOpenGLVertexBufferPainterVisit(cells[i],
+          (i == 2 && polyEdges)? 4 : i, cellId, writer);
+        }
+      cellId += cells[i]->GetNumberOfCells();
+      }
+
+    if (!vb.Data.Unmap(target))
+      {
+      return false;
+      }
+    vb.Data.SetKey(sources, mtime, layout);
+    return true;
+    }
+};
+
+//-----------------------------------------------------------------------------
+vtkOpenGLVertexBufferPainter::vtkOpenGLVertexBufferPainter()
+{
+  this->Internals = new vtkInternals;
+  this->Internals->Uploads = &this->NumberOfUploads;
+}
+
+//-----------------------------------------------------------------------------
+vtkOpenGLVertexBufferPainter::~vtkOpenGLVertexBufferPainter()
+{
+  if (this->LastWindow)
+    {
+    this->ReleaseGraphicsResources(this->LastWindow);
+    }
+  delete this->Internals;
+  this->Internals = 0;
+}
+
+//-----------------------------------------------------------------------------
+void vtkOpenGLVertexBufferPainter::ReleaseGraphicsResources(vtkWindow* win)
+{
+  if (win && win->GetMapped())
+    {
+    win->MakeCurrent();
+    this->Internals->ReleaseAll();
+    }
+  this->Internals->Clear();
+  this->Internals->SupportWindow = 0;
+  this->Superclass::ReleaseGraphicsResources(win);
+  this->LastWindow = NULL;
+}
+
+//-----------------------------------------------------------------------------
+int vtkOpenGLVertexBufferPainter::IsSupported(vtkRenderWindow* renWin)
+{
+  if (renWin && renWin == this->Internals->SupportWindow.GetPointer())
+    {
+    return this->Internals->Supported;
+    }
+
+  this->Internals->SupportWindow = renWin;
+  this->Internals->Supported = 0;
+  vtkOpenGLRenderWindow* glRenWin = vtkOpenGLRenderWindow::SafeDownCast(renWin);
+  if (glRenWin)
+    {
+    vtkOpenGLExtensionManager* mgr = glRenWin->GetExtensionManager();
+    if (mgr->ExtensionSupported("GL_VERSION_1_5"))
+      {
+      mgr->LoadExtension("GL_VERSION_1_5");
+      this->Internals->Supported = 1;
+      }
+    else if (mgr->ExtensionSupported("GL_ARB_vertex_buffer_object"))
+      {
+      mgr->LoadCorePromotedExtension("GL_ARB_vertex_buffer_object");
+      this->Internals->Supported = 1;
+      }
+    }
+  return this->Internals->Supported;
+}
+
+//-----------------------------------------------------------------------------
+int vtkOpenGLVertexBufferPainter::RenderPrimitive(unsigned long idx,
+  vtkDataArray* n, vtkUnsignedCharArray* c, vtkDataArray* t, vtkRenderer* ren)
+{
+  vtkRenderWindow* renWin = ren->GetRenderWindow();
+  vtkPolyData* input = this->GetInputAsPolyData();
+  vtkPoints* p = input->GetPoints();
+
+  if (!this->IsSupported(renWin) || !p ||
+    (idx & (VTK_PDM_GENERIC_VERTEX_ATTRIBUTES | VTK_PDM_FIELD_COLORS)))
+    {
+    return 0;
+    }
+
+  // Only float and double arrays can be given to OpenGL (and copied) as
+  // they are, and indices are 32 bits.
+  vtkIdType numPts = p->GetNumberOfPoints();
+  vtkIdType numCells = input->GetNumberOfCells();
+  int cellNormals = (idx & VTK_PDM_CELL_NORMALS)? 1 : 0;
+  int cellColors = (idx & VTK_PDM_CELL_COLORS)? 1 : 0;
+  if ((p->GetDataType() != VTK_FLOAT && p->GetDataType() != VTK_DOUBLE) ||
+    static_cast<double>(numPts) > VTK_UNSIGNED_INT_MAX)
+    {
+    return 0;
+    }
+  if (n && ((n->GetDataType() != VTK_FLOAT && n->GetDataType() != VTK_DOUBLE)
+      || n->GetNumberOfComponents() != 3 ||
+      n->GetNumberOfTuples() < (cellNormals? numCells : numPts)))
+    {
+    return 0;
+    }
+  if (c && (c->GetNumberOfComponents() != 4 ||
+      c->GetNumberOfTuples() < (cellColors? numCells : numPts)))
+    {
+    return 0;
+    }
+  if (t && ((t->GetDataType() != VTK_FLOAT && t->GetDataType() != VTK_DOUBLE)
+      || t->GetNumberOfTuples() < numPts))
+    {
+    return 0;
+    }
+
+  if (this->LastWindow && renWin != this->LastWindow.GetPointer())
+    {
+    // The buffers belong to the context of the other window, which
+    // releasing them makes current.
+    this->ReleaseGraphicsResources(this->LastWindow);
+    renWin->MakeCurrent();
+    }
+  this->LastWindow = renWin;
+
+  // Polygons are split in triangles, which shows when they are drawn as
+  // lines, so they are drawn as their edges instead. When only one face is
+  // drawn as lines, the edges of the culled faces would show, and the
+  // delegate draws them.
+  vtkInternals::BufferSet* set = this->Internals->GetBufferSet(input);
+  int polyEdges = 0;
+  if (this->RequestedPrimitives & vtkPainter::POLYS)
+    {
+    vtkInternals::CheckPolys(set, input->GetPolys());
+    if (!set->PolysAreTriangles)
+      {
+      GLint modes[2];
+      glGetIntegerv(GL_POLYGON_MODE, modes);
+      if (modes[0] == GL_LINE && modes[1] == GL_LINE)
+        {
+        polyEdges = 1;
+        }
+      else if (modes[0] == GL_LINE || modes[1] == GL_LINE)
+        {
+        return 0;
+        }
+      }
+    }
+
+  if (set->FailedMTime == input->GetMTime())
+    {
+    return 0;
+    }
+
+  // Primitives with attributes per cell, or polys and strips that need
+  // normals built, are drawn from vertices of their own. The others share
+  // the points.
+  unsigned long expand = 0;
+  if (cellNormals || cellColors)
+    {
+    expand = this->RequestedPrimitives;
+    }
+  else if (!n && this->BuildNormals)
+    {
+    expand = this->RequestedPrimitives &
+      (vtkPainter::POLYS | vtkPainter::STRIPS);
+    }
+  unsigned long shared = this->RequestedPrimitives & ~expand;
+  int pointNormals = (n && !cellNormals)? 1 : 0;
+  int pointColors = (c && !cellColors)? 1 : 0;
+
+  bool updated = true;
+  if (shared)
+    {
+    updated =
+      vtkInternals::UpdateArray(set->Points, p->GetData(), numPts,
+        p->GetMTime()) &&
+      (!pointNormals ||
+       vtkInternals::UpdateArray(set->Normals, n, numPts, n->GetMTime())) &&
+      (!pointColors ||
+       vtkInternals::UpdateArray(set->Colors, c, numPts, c->GetMTime())) &&
+      (!t ||
+       vtkInternals::UpdateArray(set->TCoords, t, numPts, t->GetMTime())) &&
+      vtkInternals::UpdateElements(set, input) &&
+      (!polyEdges || !(shared & vtkPainter::POLYS) ||
+       vtkInternals::UpdateEdges(set, input->GetPolys()));
+    }
+  // The triangles of the polys are kept with their edges, for surfaces
+  // drawn with edges.
+  if (updated && expand)
+    {
+    updated = vtkInternals::UpdateVertices(set->Vertices, input, expand, n,
+      cellNormals, c, cellColors, t, this->BuildNormals, 0) &&
+      (!polyEdges || !(expand & vtkPainter::POLYS) ||
+       vtkInternals::UpdateVertices(set->EdgeVertices, input,
+         vtkPainter::POLYS, n, cellNormals, c, cellColors, t,
+         this->BuildNormals, 1));
+    }
+  if (!updated)
+    {
+    vtkDebugMacro("Could not allocate vertex buffers, rendering without.");
+    set->Release();
+    set->FailedMTime = input->GetMTime();
+    return 0;
+    }
+
+  if (this->CompileOnly)
+    {
+    return 1;
+    }
+
+  // Opaque colors are sent as RGB, skipping the alpha.
+  GLint colorComps = (idx & VTK_PDM_OPAQUE_COLORS)? 3 : 4;
+  GLint tcomps = t? t->GetNumberOfComponents() : 0;
+
+  glPushClientAttrib(GL_CLIENT_VERTEX_ARRAY_BIT);
+  glEnableClientState(GL_VERTEX_ARRAY);
+  for (int i = 0; i < 4; ++i)
+    {
+    unsigned long type = vtkOpenGLVertexBufferPainterTypes[i];
+    int edges = (polyEdges && type == vtkPainter::POLYS);
+    GLenum mode = edges? GL_LINES : vtkOpenGLVertexBufferPainterModes[i];
+    vtkIdType count = edges? set->EdgeCount : set->ElementCounts[i];
+    vtkInternals::VertexBuffer& vb = edges? set->EdgeVertices : set->Vertices;
+    if ((shared & type) && count > 0)
+      {
+      vtkgl::BindBuffer(vtkgl::ARRAY_BUFFER, set->Points.Handle);
+      glVertexPointer(3, (p->GetDataType() == VTK_DOUBLE)? GL_DOUBLE :
+        GL_FLOAT, 0, 0);
+      if (pointNormals)
+        {
+        vtkgl::BindBuffer(vtkgl::ARRAY_BUFFER, set->Normals.Handle);
+        glNormalPointer((n->GetDataType() == VTK_DOUBLE)? GL_DOUBLE :
+          GL_FLOAT, 0, 0);
+        glEnableClientState(GL_NORMAL_ARRAY);
+        }
+      else
+        {
+        glDisableClientState(GL_NORMAL_ARRAY);
+        }
+      if (pointColors)
+        {
+        vtkgl::BindBuffer(vtkgl::ARRAY_BUFFER, set->Colors.Handle);
+        glColorPointer(colorComps, GL_UNSIGNED_BYTE, 4, 0);
+        glEnableClientState(GL_COLOR_ARRAY);
+        }
+      else
+        {
+        glDisableClientState(GL_COLOR_ARRAY);
+        }
+      if (t)
+        {
+        vtkgl::BindBuffer(vtkgl::ARRAY_BUFFER, set->TCoords.Handle);
+        glTexCoordPointer(tcomps, (t->GetDataType() == VTK_DOUBLE)?
+          GL_DOUBLE : GL_FLOAT, 0, 0);
+        glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+        }
+      else
+        {
+        glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+        }
+      vtkgl::BindBuffer(vtkgl::ELEMENT_ARRAY_BUFFER,
+        edges? set->Edges.Handle : set->Elements.Handle);
+      glDrawElements(mode, static_cast<GLsizei>(count), GL_UNSIGNED_INT,
+        reinterpret_cast<const GLvoid*>(
+          edges? 0 : set->ElementOffsets[i]*sizeof(GLuint)));
+      vtkgl::BindBuffer(vtkgl::ELEMENT_ARRAY_BUFFER, 0);
+      }
+    else if ((expand & type) && vb.Counts[i] > 0)
+      {
+      vtkgl::BindBuffer(vtkgl::ARRAY_BUFFER, vb.Data.Handle);
+      glVertexPointer(3, GL_FLOAT, 0, 0);
+      if (vb.Normals[i])
+        {
+        glNormalPointer(GL_FLOAT, 0,
+          reinterpret_cast<const GLvoid*>(vb.NormalsOffset));
+        glEnableClientState(GL_NORMAL_ARRAY);
+        }
+      else
+        {
+        glDisableClientState(GL_NORMAL_ARRAY);
+        }
+      if (c)
+        {
+        glColorPointer(colorComps, GL_UNSIGNED_BYTE, 4,
+          reinterpret_cast<const GLvoid*>(vb.ColorsOffset));
+        glEnableClientState(GL_COLOR_ARRAY);
+        }
+      else
+        {
+        glDisableClientState(GL_COLOR_ARRAY);
+        }
+      if (t)
+        {
+        glTexCoordPointer(tcomps, GL_FLOAT, 0,
+          reinterpret_cast<const GLvoid*>(vb.TCoordsOffset));
+        glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+        }
+      else
+        {
+        glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+        }
+      glDrawArrays(mode, static_cast<GLint>(vb.Offsets[i]),
+        static_cast<GLsizei>(vb.Counts[i]));
+      }
+    }
+  vtkgl::BindBuffer(vtkgl::ARRAY_BUFFER, 0);
+  glPopClientAttrib();
+
+  return 1;
+}
+
+//-----------------------------------------------------------------------------
+void vtkOpenGLVertexBufferPainter::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+}
@@ -0,0 +1,82 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    $RCSfile$
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkOpenGLVertexBufferPainter - vertex buffer painter using OpenGL.
+// .SECTION Description
+// vtkOpenGLVertexBufferPainter keeps the geometry of its input in OpenGL
+// buffer objects (OpenGL 1.5 or GL_ARB_vertex_buffer_object) and draws it
+// with glDrawElements and glDrawArrays. Verts are drawn as points, lines as
+// segments, polygons as triangle fans and strips as triangles.
+// The points and the point normals, colors and texture coordinates are
+// uploaded as they are, with the connectivity of all the primitives in one
+// index buffer. Each of these buffers is uploaded again only when its array
+// is modified. Primitives that need an attribute per cell (cell normals,
+// cell colors, or normals built for polys and strips that have none) are
+// drawn from a second buffer holding every vertex of every primitive with
+// its attributes, which is about what a display list holds.
+// Every input gets its own buffers, so that rendering the blocks of a
+// composite dataset does not upload them over and over.
+// Polygons other than triangles drawn in GL_LINE polygon mode are drawn as
+// their edges, from an index buffer (or a vertex buffer) of their own, so
+// that surfaces with edges switch between both without uploading again.
+// Generic vertex attributes, field colors, arrays of other types than float
+// and double, and polygons other than triangles when only one face is
+// drawn as lines are left to the delegate painter.
+
+#ifndef __vtkOpenGLVertexBufferPainter_h
+#define __vtkOpenGLVertexBufferPainter_h
+
+#include "vtkVertexBufferPainter.h"
+
+class VTK_RENDERING_EXPORT vtkOpenGLVertexBufferPainter :
+  public vtkVertexBufferPainter
+{
+public:
+  static vtkOpenGLVertexBufferPainter* New();
+  vtkTypeRevisionMacro(vtkOpenGLVertexBufferPainter, vtkVertexBufferPainter);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  // Description:
+  // Returns if the OpenGL context of the window has vertex buffer objects,
+  // and loads the extension if it does. The context must be current.
+  virtual int IsSupported(vtkRenderWindow*);
+
+  // Description:
+  // Release any graphics resources that are being consumed by this painter.
+  // The parameter window could be used to determine which graphic
+  // resources to release. In this case, releases the buffer objects.
+  virtual void ReleaseGraphicsResources(vtkWindow *);
+
+//BTX
+protected:
+  vtkOpenGLVertexBufferPainter();
+  ~vtkOpenGLVertexBufferPainter();
+
+  // Description:
+  // Uploads the arrays that changed since the last render and draws the
+  // requested primitives from the buffers. Returns 0 when the input has
+  // attributes that cannot be drawn from the buffers.
+  virtual int RenderPrimitive(unsigned long flags, vtkDataArray* n,
+    vtkUnsignedCharArray* c, vtkDataArray* t, vtkRenderer* ren);
+
+private:
+  vtkOpenGLVertexBufferPainter(const vtkOpenGLVertexBufferPainter&); // Not implemented.
+  void operator=(const vtkOpenGLVertexBufferPainter&); // Not implemented.
+
+  class vtkInternals;
+  vtkInternals* Internals;
+//ETX
+};
+
+#endif
@@ -0,0 +1,549 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    $RCSfile$
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkThreadedCellCenterDepthSort.h"
+
+#include "vtkCell.h"
+#include "vtkCellArray.h"
+#include "vtkCellType.h"
+#include "vtkFloatArray.h"
+#include "vtkIdTypeArray.h"
+#include "vtkMath.h"
+#include "vtkMultiThreader.h"
+#include "vtkObjectFactory.h"
+#include "vtkPoints.h"
+#include "vtkUnsignedCharArray.h"
+#include "vtkUnstructuredGrid.h"
+
+#include <vtkstd/algorithm>
+#include <vtkstd/vector>
+
+// Number of bits of the keys sorted by each radix sort pass.
+#define VTK_DEPTH_SORT_RADIX_BITS 11
+#define VTK_DEPTH_SORT_RADIX_SIZE (1 << VTK_DEPTH_SORT_RADIX_BITS)
+
+// Below this number of items per thread, fewer threads are used.
+static const vtkIdType vtkThreadedCellCenterDepthSortMinItems = 32768;
+
+//-----------------------------------------------------------------------------
+class vtkThreadedCellCenterDepthSortInternals
+{
+public:
+  enum
+  {
+    CENTERS,
+    KEYS,
+    HISTOGRAM,
+    SCATTER
+  };
+
+  // Sort keys of the cells of SortedCells, and the scratch copy used by the
+  // radix sort.
+  vtkstd::vector<vtkTypeUInt32> Keys;
+  vtkstd::vector<vtkTypeUInt32> KeysBuffer;
+
+  // Digit counts, then first destination of each digit, of each thread for
+  // the current radix sort pass.
+  vtkstd::vector<vtkIdType> Offsets;
+
+  // Set by the threads that found cells other than tetrahedra.
+  int OtherCells[VTK_MAX_THREADS];
+
+  // When set, the keys are computed for the cells in their own order
+  // instead of the order of SortedCells, which is reset.
+  int ResetOrder;
+
+  // Smallest rotation, in degrees, for which the insertion sort gave up
+  // since the cell centers were computed.
+  double FailedAngle;
+
+  int Task;
+  vtkIdType NumberOfItems;
+  int NumberOfThreads;
+  int Shift;
+  float Vector[3];
+};
+
+//-----------------------------------------------------------------------------
+// Maps the depth to an unsigned integer with the same order, so that depths
+// can be radix sorted. Negative depths have all their bits flipped, positive
+// ones only their sign bit.
+static inline vtkTypeUInt32 vtkThreadedCellCenterDepthSortKey(float depth)
+{
+  union
+  {
+    float Depth;
+    vtkTypeUInt32 Key;
+  } value;
+  value.Depth = depth;
+  if (value.Key & 0x80000000)
+    {
+    return ~value.Key;
+    }
+  return value.Key | 0x80000000;
+}
+
+//-----------------------------------------------------------------------------
+template <class T>
+static void vtkThreadedCellCenterDepthSortTetraCenters(
+  const T *points, const vtkIdType *connectivity, const vtkIdType *locations,
+  const unsigned char *types, float *centers, vtkIdType begin, vtkIdType end,
+  int &otherCells)
+{
+  for (vtkIdType i = begin; i < end; i++)
+    {
+    if (types[i] != VTK_TETRA)
+      {
+      otherCells = 1;
+      continue;
+      }
+    // Same arithmetic as vtkTetra::EvaluateLocation at the parametric center.
+    const vtkIdType *ptIds = connectivity + locations[i] + 1;
+    double center[3] = { 0.0, 0.0, 0.0 };
+    for (int j = 0; j < 4; j++)
+      {
+      const T *x = points + 3*ptIds[j];
+      center[0] += x[0]*0.25;
+      center[1] += x[1]*0.25;
+      center[2] += x[2]*0.25;
+      }
+    float *c = centers + 3*i;
+    c[0] = static_cast<float>(center[0]);
+    c[1] = static_cast<float>(center[1]);
+    c[2] = static_cast<float>(center[2]);
+    }
+}
+
+//-----------------------------------------------------------------------------
+static VTK_THREAD_RETURN_TYPE vtkThreadedCellCenterDepthSortThread(void *arg)
+{
+  vtkMultiThreader::ThreadInfo *info =
+    static_cast<vtkMultiThreader::ThreadInfo *>(arg);
+  vtkThreadedCellCenterDepthSort *self =
+    static_cast<vtkThreadedCellCenterDepthSort *>(info->UserData);
+  self->ThreadedExecute(info->ThreadID, info->NumberOfThreads);
+  return VTK_THREAD_RETURN_VALUE;
+}
+
+//-----------------------------------------------------------------------------
+
+vtkCxxRevisionMacro(vtkThreadedCellCenterDepthSort, "$Revision$");
+vtkStandardNewMacro(vtkThreadedCellCenterDepthSort);
+
+vtkThreadedCellCenterDepthSort::vtkThreadedCellCenterDepthSort()
+{
+  this->Threader = vtkMultiThreader::New();
+  this->NumberOfThreads = this->Threader->GetNumberOfThreads();
+
+  this->IncrementalSortAngle = 5.0;
+
+  this->SortedCellsBuffer = vtkIdTypeArray::New();
+  this->SortedCellsBuffer->SetNumberOfComponents(1);
+
+  this->LastVector[0] = this->LastVector[1] = this->LastVector[2] = 0.0;
+  this->LastVectorValid = 0;
+  this->NextCell = 0;
+
+  this->Internals = new vtkThreadedCellCenterDepthSortInternals;
+  this->Internals->ResetOrder = 1;
+  this->Internals->FailedAngle = VTK_DOUBLE_MAX;
+}
+
+vtkThreadedCellCenterDepthSort::~vtkThreadedCellCenterDepthSort()
+{
+  this->Threader->Delete();
+  this->SortedCellsBuffer->Delete();
+  delete this->Internals;
+}
+
+void vtkThreadedCellCenterDepthSort::PrintSelf(ostream &os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+
+  os << indent << "NumberOfThreads: " << this->NumberOfThreads << endl;
+  os << indent << "IncrementalSortAngle: " << this->IncrementalSortAngle
+     << endl;
+}
+
+void vtkThreadedCellCenterDepthSort::Execute(int task, vtkIdType numItems)
+{
+  int numThreads = this->NumberOfThreads;
+  vtkIdType maxThreads = numItems / vtkThreadedCellCenterDepthSortMinItems;
+  if (maxThreads < numThreads)
+    {
+    numThreads = maxThreads > 1 ? static_cast<int>(maxThreads) : 1;
+    }
+
+  // vtkMultiThreader::SetGlobalMaximumNumberOfThreads() may limit the
+  // threads that actually run.  The merges must only read the results of
+  // those, the other slots may hold those of an earlier sort.
+  this->Threader->SetNumberOfThreads(numThreads);
+  numThreads = this->Threader->GetNumberOfThreads();
+
+  this->Internals->Task = task;
+  this->Internals->NumberOfItems = numItems;
+  this->Internals->NumberOfThreads = numThreads;
+
+  this->Threader->SetSingleMethod(vtkThreadedCellCenterDepthSortThread, this);
+  this->Threader->SingleMethodExecute();
+}
+
+void vtkThreadedCellCenterDepthSort::ThreadedExecute(int threadId,
+                                                     int numThreads)
+{
+  vtkThreadedCellCenterDepthSortInternals *internals = this->Internals;
+
+  // Split the items in numThreads contiguous ranges, the first ones getting
+  // one item more when they do not divide evenly.
+  vtkIdType numItems = internals->NumberOfItems;
+  vtkIdType quotient = numItems / numThreads;
+  vtkIdType remainder = numItems % numThreads;
+  vtkIdType begin = quotient*threadId
+    + (threadId < remainder ? threadId : remainder);
+  vtkIdType end = begin + quotient + (threadId < remainder ? 1 : 0);
+
+  switch (internals->Task)
+    {
+    case vtkThreadedCellCenterDepthSortInternals::CENTERS:
+      {
+      vtkUnstructuredGrid *grid = static_cast<vtkUnstructuredGrid *>(
+        this->Input);
+      vtkDataArray *points = grid->GetPoints()->GetData();
+      const vtkIdType *connectivity = grid->GetCells()->GetPointer();
+      const vtkIdType *locations = grid->GetCellLocationsArray()->GetPointer(0);
+      const unsigned char *types = grid->GetCellTypesArray()->GetPointer(0);
+      float *centers = this->CellCenters->GetPointer(0);
+      internals->OtherCells[threadId] = 0;
+      if (points->GetDataType() == VTK_FLOAT)
+        {
+        vtkThreadedCellCenterDepthSortTetraCenters(
+          static_cast<float *>(points->GetVoidPointer(0)), connectivity,
+          locations, types, centers, begin, end,
+          internals->OtherCells[threadId]);
+        }
+      else
+        {
+        vtkThreadedCellCenterDepthSortTetraCenters(
+          static_cast<double *>(points->GetVoidPointer(0)), connectivity,
+          locations, types, centers, begin, end,
+          internals->OtherCells[threadId]);
+        }
+      }
+      break;
+
+    case vtkThreadedCellCenterDepthSortInternals::KEYS:
+      {
+      const float *vector = internals->Vector;
+      const float *centers = this->CellCenters->GetPointer(0);
+      vtkIdType *cellIds = this->SortedCells->GetPointer(0);
+      vtkTypeUInt32 *keys = &internals->Keys[0];
+      if (internals->ResetOrder)
+        {
+        // Reading the centers in order is much faster than gathering them.
+        for (vtkIdType i = begin; i < end; i++)
+          {
+          const float *center = centers + 3*i;
+          cellIds[i] = i;
+          keys[i] = vtkThreadedCellCenterDepthSortKey(
+            center[0]*vector[0] + center[1]*vector[1] + center[2]*vector[2]);
+          }
+        }
+      else
+        {
+        for (vtkIdType i = begin; i < end; i++)
+          {
+          const float *center = centers + 3*cellIds[i];
+          keys[i] = vtkThreadedCellCenterDepthSortKey(
+            center[0]*vector[0] + center[1]*vector[1] + center[2]*vector[2]);
+          }
+        }
+      }
+      break;
+
+    case vtkThreadedCellCenterDepthSortInternals::HISTOGRAM:
+      {
+      const vtkTypeUInt32 *keys = &internals->Keys[0];
+      int shift = internals->Shift;
+      vtkIdType *counts =
+        &internals->Offsets[threadId*VTK_DEPTH_SORT_RADIX_SIZE];
+      vtkstd::fill(counts, counts + VTK_DEPTH_SORT_RADIX_SIZE, 0);
+      for (vtkIdType i = begin; i < end; i++)
+        {
+        counts[(keys[i] >> shift) & (VTK_DEPTH_SORT_RADIX_SIZE - 1)]++;
+        }
+      }
+      break;
+
+    case vtkThreadedCellCenterDepthSortInternals::SCATTER:
+      {
+      const vtkTypeUInt32 *keys = &internals->Keys[0];
+      const vtkIdType *cellIds = this->SortedCells->GetPointer(0);
+      vtkTypeUInt32 *sortedKeys = &internals->KeysBuffer[0];
+      vtkIdType *sortedIds = this->SortedCellsBuffer->GetPointer(0);
+      int shift = internals->Shift;
+      vtkIdType *offsets =
+        &internals->Offsets[threadId*VTK_DEPTH_SORT_RADIX_SIZE];
+      for (vtkIdType i = begin; i < end; i++)
+        {
+        vtkIdType j =
+          offsets[(keys[i] >> shift) & (VTK_DEPTH_SORT_RADIX_SIZE - 1)]++;
+        sortedKeys[j] = keys[i];
+        sortedIds[j] = cellIds[i];
+        }
+      }
+      break;
+    }
+}
+
+void vtkThreadedCellCenterDepthSort::ComputeCellCenters()
+{
+  vtkUnstructuredGrid *grid = vtkUnstructuredGrid::SafeDownCast(this->Input);
+  if (   !grid || !grid->GetPoints() || !grid->GetCells()
+      || !grid->GetCellTypesArray() || !grid->GetCellLocationsArray()
+      || (   grid->GetPoints()->GetDataType() != VTK_FLOAT
+          && grid->GetPoints()->GetDataType() != VTK_DOUBLE) )
+    {
+    this->Superclass::ComputeCellCenters();
+    return;
+    }
+
+  vtkIdType numcells = grid->GetNumberOfCells();
+  this->CellCenters->SetNumberOfTuples(numcells);
+  this->Execute(vtkThreadedCellCenterDepthSortInternals::CENTERS, numcells);
+
+  int otherCells = 0;
+  for (int i = 0; i < this->Internals->NumberOfThreads; i++)
+    {
+    otherCells |= this->Internals->OtherCells[i];
+    }
+  if (!otherCells)
+    {
+    return;
+    }
+
+  // GetCell is not thread safe, so the cells other than tetrahedra are done
+  // here as the superclass does.
+  float *centers = this->CellCenters->GetPointer(0);
+  const unsigned char *types = grid->GetCellTypesArray()->GetPointer(0);
+  double dcenter[3];
+  double *weights = new double[grid->GetMaxCellSize()];  //Dummy array.
+  for (vtkIdType i = 0; i < numcells; i++)
+    {
+    if (types[i] == VTK_TETRA)
+      {
+      continue;
+      }
+    vtkCell *cell = grid->GetCell(i);
+    double pcenter[3];
+    int subId = cell->GetParametricCenter(pcenter);
+    cell->EvaluateLocation(subId, pcenter, dcenter, weights);
+    float *center = centers + 3*i;
+    center[0] = dcenter[0]; center[1] = dcenter[1]; center[2] = dcenter[2];
+    }
+  delete[] weights;
+}
+
+void vtkThreadedCellCenterDepthSort::ComputeDepths()
+{
+  vtkIdType numcells = this->SortedCells->GetNumberOfTuples();
+  this->Internals->Keys.resize(numcells);
+  if (numcells > 0)
+    {
+    this->Execute(vtkThreadedCellCenterDepthSortInternals::KEYS, numcells);
+    }
+}
+
+int vtkThreadedCellCenterDepthSort::InsertionSort()
+{
+  vtkIdType numcells = this->SortedCells->GetNumberOfTuples();
+  if (numcells < 2)
+    {
+    return 1;
+    }
+  vtkTypeUInt32 *keys = &this->Internals->Keys[0];
+  vtkIdType *cellIds = this->SortedCells->GetPointer(0);
+
+  // A small rotation only moves cells by a few places. Past this many moves
+  // the order changed too much and the radix sort is faster.
+  vtkIdType movesLeft = numcells;
+  for (vtkIdType i = 1; i < numcells; i++)
+    {
+    vtkTypeUInt32 key = keys[i];
+    if (keys[i-1] <= key)
+      {
+      continue;
+      }
+    vtkIdType cellId = cellIds[i];
+    vtkIdType j = i;
+    do
+      {
+      keys[j] = keys[j-1];
+      cellIds[j] = cellIds[j-1];
+      j--;
+      movesLeft--;
+      }
+    while (j > 0 && keys[j-1] > key && movesLeft > 0);
+    keys[j] = key;
+    cellIds[j] = cellId;
+    if (movesLeft <= 0)
+      {
+      vtkDebugMacro("Too many cells moved, giving up the insertion sort.");
+      return 0;
+      }
+    }
+  return 1;
+}
+
+void vtkThreadedCellCenterDepthSort::RadixSort()
+{
+  vtkThreadedCellCenterDepthSortInternals *internals = this->Internals;
+  vtkIdType numcells = this->SortedCells->GetNumberOfTuples();
+  if (numcells < 2)
+    {
+    return;
+    }
+  internals->KeysBuffer.resize(numcells);
+  this->SortedCellsBuffer->SetNumberOfTuples(numcells);
+  internals->Offsets.resize(VTK_MAX_THREADS*VTK_DEPTH_SORT_RADIX_SIZE);
+
+  for (int shift = 0; shift < 32; shift += VTK_DEPTH_SORT_RADIX_BITS)
+    {
+    internals->Shift = shift;
+    this->Execute(vtkThreadedCellCenterDepthSortInternals::HISTOGRAM,
+                  numcells);
+
+    // Each thread writes the cells with a given digit after those of the
+    // same digit of the threads before it, so that every pass is stable.
+    int numThreads = internals->NumberOfThreads;
+    vtkIdType *offsets = &internals->Offsets[0];
+    vtkIdType offset = 0;
+    int skip = 0;
+    for (int digit = 0; digit < VTK_DEPTH_SORT_RADIX_SIZE; digit++)
+      {
+      vtkIdType first = offset;
+      for (int t = 0; t < numThreads; t++)
+        {
+        vtkIdType count = offsets[t*VTK_DEPTH_SORT_RADIX_SIZE + digit];
+        offsets[t*VTK_DEPTH_SORT_RADIX_SIZE + digit] = offset;
+        offset += count;
+        }
+      if (offset - first == numcells)
+        {
+        // All the keys have this digit, the pass would not change anything.
+        skip = 1;
+        break;
+        }
+      }
+    if (skip)
+      {
+      continue;
+      }
+
+    this->Execute(vtkThreadedCellCenterDepthSortInternals::SCATTER, numcells);
+    internals->Keys.swap(internals->KeysBuffer);
+    vtkstd::swap(this->SortedCells, this->SortedCellsBuffer);
+    }
+}
+
+void vtkThreadedCellCenterDepthSort::InitTraversal()
+{
+  vtkDebugMacro("InitTraversal");
+
+  vtkIdType numcells = this->Input->GetNumberOfCells();
+
+  if (   (this->LastSortTime < this->Input->GetMTime())
+      || (this->LastSortTime < this->MTime)
+      || (this->SortedCells->GetNumberOfTuples() != numcells) )
+    {
+    vtkDebugMacro("Building cell centers array.");
+
+    // Data may have changed.  Recompute cell centers.
+    this->ComputeCellCenters();
+    this->SortedCells->SetNumberOfTuples(numcells);
+    this->LastVectorValid = 0;
+    this->Internals->FailedAngle = VTK_DOUBLE_MAX;
+    }
+
+  float *vector = this->ComputeProjectionVector();
+  double dvector[3] = { vector[0], vector[1], vector[2] };
+  this->Internals->Vector[0] = vector[0];
+  this->Internals->Vector[1] = vector[1];
+  this->Internals->Vector[2] = vector[2];
+
+  // Sort the previous order again when the view turned by a small angle,
+  // unless the insertion sort already gave up for a smaller one.
+  double angle = 180.0;
+  if (this->LastVectorValid)
+    {
+    double norms = vtkMath::Norm(dvector)*vtkMath::Norm(this->LastVector);
+    if (norms > 0.0)
+      {
+      double cosAngle = vtkMath::Dot(dvector, this->LastVector)/norms;
+      cosAngle = cosAngle > 1.0 ? 1.0 : (cosAngle < -1.0 ? -1.0 : cosAngle);
+      angle = vtkMath::DegreesFromRadians(acos(cosAngle));
+      }
+    }
+  int incremental = (   angle < this->IncrementalSortAngle
+                     && angle < this->Internals->FailedAngle );
+  this->Internals->ResetOrder = !incremental;
+
+  vtkDebugMacro("Calculating depths.");
+  this->ComputeDepths();
+
+  if (incremental)
+    {
+    vtkDebugMacro("Sorting previous order.");
+    if (!this->InsertionSort())
+      {
+      this->Internals->FailedAngle = angle;
+      incremental = 0;
+      }
+    }
+  if (!incremental)
+    {
+    vtkDebugMacro("Radix sorting.");
+    this->RadixSort();
+    }
+
+  this->LastVector[0] = dvector[0];
+  this->LastVector[1] = dvector[1];
+  this->LastVector[2] = dvector[2];
+  this->LastVectorValid = 1;
+  this->NextCell = 0;
+
+  this->LastSortTime.Modified();
+}
+
+vtkIdTypeArray *vtkThreadedCellCenterDepthSort::GetNextCells()
+{
+  vtkIdType numcells = this->SortedCells->GetNumberOfTuples();
+  if (this->NextCell >= numcells)
+    {
+    // Already returned everything.
+    return NULL;
+    }
+
+  vtkIdType count = numcells - this->NextCell;
+  if (count > this->MaxCellsReturned)
+    {
+    count = this->MaxCellsReturned;
+    }
+
+  this->SortedCellPartition->SetArray(
+    this->SortedCells->GetPointer(this->NextCell), count, 1);
+  this->SortedCellPartition->SetNumberOfTuples(count);
+  this->NextCell += count;
+
+  return this->SortedCellPartition;
+}
@@ -0,0 +1,128 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    $RCSfile$
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkThreadedCellCenterDepthSort - a multithreaded cell center depth
+// sort for large meshes.
+//
+// .SECTION Description
+// vtkThreadedCellCenterDepthSort orders the cells by the depth of their
+// centroids like vtkCellCenterDepthSort, but is meant for meshes of
+// millions of cells rendered interactively. The cell centers are computed
+// once per change of the input, directly from the connectivity for
+// tetrahedra. On every traversal the depths are turned into integer keys
+// and the whole order is computed up front with a radix sort whose
+// histogram and scatter passes run on several threads.
+//
+// When the view direction turned by less than IncrementalSortAngle since
+// the previous traversal, the previous order is nearly sorted already and is
+// fixed with an insertion sort instead. The insertion sort gives up and the
+// radix sort takes over when too many cells move, and is not tried again for
+// rotations as large until the input changes. On fine meshes only tiny
+// rotations and redraws from the same view take the incremental path.
+//
+// GetNextCells() returns consecutive pieces of at most MaxCellsReturned
+// cells of the sorted order.
+//
+// .SECTION See Also
+// vtkCellCenterDepthSort vtkProjectedTetrahedraMapper
+
+#ifndef __vtkThreadedCellCenterDepthSort_h
+#define __vtkThreadedCellCenterDepthSort_h
+
+#include "vtkCellCenterDepthSort.h"
+
+class vtkMultiThreader;
+class vtkThreadedCellCenterDepthSortInternals;
+
+class VTK_RENDERING_EXPORT vtkThreadedCellCenterDepthSort :
+  public vtkCellCenterDepthSort
+{
+public:
+  vtkTypeRevisionMacro(vtkThreadedCellCenterDepthSort, vtkCellCenterDepthSort);
+  virtual void PrintSelf(ostream &os, vtkIndent indent);
+  static vtkThreadedCellCenterDepthSort *New();
+
+  virtual void InitTraversal();
+  virtual vtkIdTypeArray *GetNextCells();
+
+  // Description:
+  // Set/Get the number of threads used to compute the cell centers and to
+  // sort them. Defaults to the number of processors.
+  vtkSetClampMacro(NumberOfThreads, int, 1, VTK_MAX_THREADS);
+  vtkGetMacro(NumberOfThreads, int);
+
+  // Description:
+  // Set/Get the angle, in degrees, by which the view direction may turn
+  // between two traversals for the previous order to be sorted again
+  // incrementally. Set to 0 to always sort from scratch. Defaults to 5.
+  vtkSetClampMacro(IncrementalSortAngle, double, 0.0, 180.0);
+  vtkGetMacro(IncrementalSortAngle, double);
+
+//BTX
+  // Description:
+  // Used by the threads. Do not call.
+  void ThreadedExecute(int threadId, int numThreads);
+//ETX
+
+protected:
+  vtkThreadedCellCenterDepthSort();
+  virtual ~vtkThreadedCellCenterDepthSort();
+
+  // Description:
+  // Computes the centroids of tetrahedra of unstructured grids on the
+  // threads, and of any other cell as the superclass does.
+  virtual void ComputeCellCenters();
+
+  // Description:
+  // Computes the sort keys of the cells in the order of SortedCells, or
+  // resets SortedCells to the order of the cells when sorting from scratch.
+  virtual void ComputeDepths();
+
+  // Description:
+  // Sorts the keys and SortedCells with an insertion sort. Returns 0,
+  // leaving them partially sorted, when more cells than the number of cells
+  // had to be moved.
+  int InsertionSort();
+
+  // Description:
+  // Sorts the keys and SortedCells with a radix sort.
+  void RadixSort();
+
+  // Description:
+  // Runs Task on the threads, splitting numItems items over them.
+  void Execute(int task, vtkIdType numItems);
+
+  vtkMultiThreader *Threader;
+  int NumberOfThreads;
+
+  double IncrementalSortAngle;
+
+  // Scratch copy of SortedCells used by the radix sort.
+  vtkIdTypeArray *SortedCellsBuffer;
+
+  // Direction of the previous sort, valid when LastVectorValid is set.
+  double LastVector[3];
+  int LastVectorValid;
+
+  // Next cell of SortedCells returned by GetNextCells().
+  vtkIdType NextCell;
+
+private:
+  vtkThreadedCellCenterDepthSortInternals *Internals;
+
+  vtkThreadedCellCenterDepthSort(const vtkThreadedCellCenterDepthSort &);  // Not implemented.
+  void operator=(const vtkThreadedCellCenterDepthSort &);  // Not implemented.
+};
+
+#endif //__vtkThreadedCellCenterDepthSort_h
@@ -0,0 +1,70 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    $RCSfile$
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkVertexBufferPainter.h"
+
+#include "vtkGraphicsFactory.h"
+#include "vtkObjectFactory.h"
+
+// Needed when we don't use the vtkStandardNewMacro.
+vtkInstantiatorNewMacro(vtkVertexBufferPainter);
+vtkCxxRevisionMacro(vtkVertexBufferPainter, "$Revision$");
+
+//----------------------------------------------------------------------------
+vtkVertexBufferPainter::vtkVertexBufferPainter()
+{
+  this->SetSupportedPrimitive(vtkPainter::VERTS | vtkPainter::LINES |
+    vtkPainter::POLYS | vtkPainter::STRIPS);
+  this->RequestedPrimitives = 0;
+  this->CompileOnly = 0;
+  this->NumberOfUploads = 0;
+}
+
+//----------------------------------------------------------------------------
+vtkVertexBufferPainter::~vtkVertexBufferPainter()
+{
+}
+
+//----------------------------------------------------------------------------
+vtkVertexBufferPainter* vtkVertexBufferPainter::New()
+{
+  vtkObject* o = vtkGraphicsFactory::CreateInstance("vtkVertexBufferPainter");
+  return static_cast<vtkVertexBufferPainter *>(o);
+}
+
+//----------------------------------------------------------------------------
+void vtkVertexBufferPainter::RenderInternal(vtkRenderer* renderer,
+                                            vtkActor* actor,
+                                            unsigned long typeflags,
+                                            bool forceCompileOnly)
+{
+  this->RequestedPrimitives = typeflags & this->SupportedPrimitive;
+  this->CompileOnly = forceCompileOnly? 1 : 0;
+  this->Superclass::RenderInternal(renderer, actor, typeflags,
+                                   forceCompileOnly);
+}
+
+//----------------------------------------------------------------------------
+int vtkVertexBufferPainter::RenderPrimitive(unsigned long, vtkDataArray*,
+  vtkUnsignedCharArray*, vtkDataArray*, vtkRenderer*)
+{
+  return 0;
+}
+
+//----------------------------------------------------------------------------
+void vtkVertexBufferPainter::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "NumberOfUploads: " << this->NumberOfUploads << endl;
+}
@@ -0,0 +1,88 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    $RCSfile$
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkVertexBufferPainter - abstract superclass for painters that
+// render primitives from vertex buffers.
+// .SECTION Description
+// vtkVertexBufferPainter renders verts, lines, polys and strips from
+// points, normals, colors, texture coordinates and connectivity kept on the
+// graphics card, instead of sending each vertex through the
+// vtkPainterDeviceAdapter. The buffers are uploaded when the data is first
+// rendered and only the arrays that were modified since are uploaded again.
+// Concrete subclasses return the primitives they cannot render from buffers
+// (generic vertex attributes, field colors...) to the delegate painter.
+// When IsSupported() is true for the render window, vtkDefaultPainter puts
+// this painter at the end of its chain and leaves out the
+// vtkDisplayListPainter, since the buffers already hold the geometry. This
+// is also done in immediate mode rendering, which only keeps the display
+// lists out.
+// .SECTION See Also
+// vtkDefaultPainter vtkDisplayListPainter
+
+#ifndef __vtkVertexBufferPainter_h
+#define __vtkVertexBufferPainter_h
+
+#include "vtkPrimitivePainter.h"
+
+class vtkRenderWindow;
+
+class VTK_RENDERING_EXPORT vtkVertexBufferPainter : public vtkPrimitivePainter
+{
+public:
+  static vtkVertexBufferPainter* New();
+  vtkTypeRevisionMacro(vtkVertexBufferPainter, vtkPrimitivePainter);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  // Description:
+  // Returns if the render window can render from vertex buffers. The
+  // context of the window must be current. Concrete subclasses override
+  // this; this class supports no window.
+  virtual int IsSupported(vtkRenderWindow*) { return 0; }
+
+  // Description:
+  // Returns the number of times a buffer was filled since the painter was
+  // created, to check that only the modified arrays are uploaded again.
+  vtkGetMacro(NumberOfUploads, unsigned long);
+
+protected:
+  vtkVertexBufferPainter();
+  ~vtkVertexBufferPainter();
+
+  // Description:
+  // Overridden to keep the primitives requested in typeflags and the
+  // forceCompileOnly flag for RenderPrimitive(), which does not get them.
+  virtual void RenderInternal(vtkRenderer* renderer, vtkActor* actor,
+                              unsigned long typeflags,
+                              bool forceCompileOnly);
+
+  // Description:
+  // Renders nothing, so that the delegate renders all the primitives.
+  virtual int RenderPrimitive(unsigned long flags, vtkDataArray* n,
+    vtkUnsignedCharArray* c, vtkDataArray* t, vtkRenderer* ren);
+
+  // Primitives of SupportedPrimitive requested in the current render.
+  unsigned long RequestedPrimitives;
+
+  // When set, the buffers are updated but nothing is drawn.
+  int CompileOnly;
+
+  // Incremented by subclasses on every upload.
+  unsigned long NumberOfUploads;
+
+private:
+  vtkVertexBufferPainter(const vtkVertexBufferPainter&); // Not implemented.
+  void operator=(const vtkVertexBufferPainter&); // Not implemented.
+};
+
+#endif
@@ -25,7 +25,6 @@
 #include "vtkProjectedTetrahedraMapper.h"
 
 #include "vtkCellArray.h"
-#include "vtkCellCenterDepthSort.h"
 #include "vtkCellData.h"
 #include "vtkColorTransferFunction.h"
 #include "vtkDoubleArray.h"
@@ -35,6 +34,7 @@
 #include "vtkObjectFactory.h"
 #include "vtkPiecewiseFunction.h"
 #include "vtkPointData.h"
+#include "vtkThreadedCellCenterDepthSort.h"
 #include "vtkTimerLog.h"
 #include "vtkUnsignedCharArray.h"
 #include "vtkUnstructuredGrid.h"
@@ -69,7 +69,7 @@ vtkProjectedTetrahedraMapper *vtkProjectedTetrahedraMapper::New()
 
 vtkProjectedTetrahedraMapper::vtkProjectedTetrahedraMapper()
 {
-  this->VisibilitySort = vtkCellCenterDepthSort::New();
+  this->VisibilitySort = vtkThreadedCellCenterDepthSort::New();
 }
 
 vtkProjectedTetrahedraMapper::~vtkProjectedTetrahedraMapper()